@@ -0,0 +1,197 @@
+// ===================== PvBatt.h =====================
+// Batterie-Schätzer im Poller: aus jedem Frame (battW, socx10) laufend die Zeit bis 20 %, bis
+// voll und bis leer, mit Konfidenz. O(1) je Sample, kein Verlauf.
+//
+// Modell: dSoC = k * Energie in die Batterie (k in 0.1 %-SoC je Wh, getrennt für Laden und
+// Entladen, enthält Kapazität und Wirkungsgrad). k kommt als Vorwissen aus der Kapazität der
+// Geräte (PvDeviceCfg::battWh) und wird an den Sprüngen der SoC-Anzeige nachgeschärft: von
+// einem Sprung zum nächsten ist die SoC-Differenz bis auf die Rundung der Anzeige genau, die
+// Energie bis auf den Sample-Abstand (skalares Kalman-Update je Sprung). Die Rate ist k mal
+// geglättete Leistung (EWMA), ETA = Abstand / Rate. Konfidenz aus der Unsicherheit von k
+// und der Schwankung der Leistung.
+// Ohne Arduino-Abhängigkeiten: tools/pvbatt.cpp spielt SoC-Verläufe ab (Simulation,
+// sun2000sim --truth, pvrec-Aufzeichnungen).
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "PvFrame.h"
+
+#define PV_BATT_TAU_S       120      // Leistung geglättet (Zeitkonstante)
+#define PV_BATT_DEAD_W      30       // darunter: Ruhe, keine ETA
+#define PV_BATT_GAP_S       600      // längere Pause zwischen Samples: neu ansetzen
+#define PV_BATT_CAP_WH      10000    // Kapazität unbekannt: angenommen ...
+#define PV_BATT_FREE_REL    1.0f     // ... auf ±100 %
+#define PV_BATT_PRIOR_REL   0.2f     // bekannt: ±20 % (nutzbar, Wirkungsgrad)
+#define PV_BATT_DRIFT_REL   0.02f    // je Richtungswechsel darf k so weit wandern
+#define PV_BATT_SOC_SD      0.35f    // Rundung/Hysterese der SoC-Anzeige je Sprung (0.1 %)
+#define PV_BATT_ETA_MAX_S   (48L*3600)
+#define PV_BATT_CONF_MIN    20       // darunter keine ETA im Frame (eta20s = -1)
+#define PV_BATT_CONF_SURE   50       // darunter in der Kopfzeile mit "~"
+#define PV_BATT_LOW_X10     200      // 20 %
+#define PV_BATT_FULL_X10    1000
+#define PV_BATT_EMPTY_X10   50       // Entladeende der Batterie (Einstellung am Wechselrichter)
+
+enum : uint8_t { PVB_CHG = 0, PVB_DIS = 1, PVB_IDLE = 2 };
+
+struct PvBattEst {
+  float    k[2] = {}, P[2] = {};      // Schätzung und Varianz je Richtung (aktuell)
+  float    kB[2] = {}, PB[2] = {};    // ... zu Beginn des Abschnitts (Basis für das Update)
+  // Abschnitt: gleiche Richtung seit dem letzten Anker
+  uint8_t  dir = PVB_IDLE;
+  bool     edge = false;              // Anker auf einem Sprung der Anzeige
+  uint16_t soc0 = 0;                  // SoC am Anker
+  float    e = 0;                     // Wh seit dem Anker
+  float    eVar = 0;                  // Unsicherheit von e am Anker (Wh²): Sprung irgendwo im Abstand
+  // Leistung
+  float    pw = 0, pvar = 0;          // geglättet, Varianz
+  bool     have = false;
+  uint32_t lastMs = 0;
+  int32_t  lastW = 0;
+  uint16_t soc = 0;                   // zuletzt angezeigt
+  // Messung
+  uint32_t samples = 0, steps = 0, resets = 0;
+};
+
+struct PvBattEta {
+  int32_t  eta20s = -1, fullS = -1, emptyS = -1;   // Sekunden, -1 = nicht in dieser Richtung
+  int16_t  ratex10 = 0;                            // %/h x10 (+ laden)
+  uint8_t  conf = 0;                               // 0..100
+  uint8_t  dir = PVB_IDLE;
+};
+
+// Vorwissen: capWh = Summe der Batterien (0 = unbekannt)
+static inline void pvBattInit(PvBattEst& b, uint32_t capWh){
+  const float cap = capWh ? (float)capWh : (float)PV_BATT_CAP_WH;
+  const float rel = capWh ? PV_BATT_PRIOR_REL : PV_BATT_FREE_REL;
+  b = PvBattEst();
+  for (uint8_t d = 0; d < 2; ++d){
+    b.k[d] = b.kB[d] = 1000.0f / cap;
+    b.P[d] = b.PB[d] = (rel * b.k[d]) * (rel * b.k[d]);
+  }
+}
+
+// Abschnitt beenden: Ergebnis wird Basis, etwas Drift zulassen
+static inline void pvBattCommit(PvBattEst& b){
+  if (b.dir < 2){
+    const float q = PV_BATT_DRIFT_REL * b.k[b.dir];
+    b.kB[b.dir] = b.k[b.dir]; b.PB[b.dir] = b.P[b.dir] + q * q;
+  }
+}
+
+static inline void pvBattAnchor(PvBattEst& b, uint8_t dir, bool edge){
+  if (dir != b.dir) pvBattCommit(b);
+  b.dir = dir; b.edge = edge; b.soc0 = b.soc; b.e = 0; b.eVar = 0;
+}
+
+// Sample aus dem Frame (nowMs = millis() beim Poll, battW + laden)
+static inline void pvBattUpdate(PvBattEst& b, uint32_t nowMs, int32_t battW, uint16_t socx10){
+  b.samples++;
+  const uint8_t dir = battW > PV_BATT_DEAD_W ? PVB_CHG : battW < -PV_BATT_DEAD_W ? PVB_DIS : PVB_IDLE;
+  const float dt = b.have ? (float)(uint32_t)(nowMs - b.lastMs) / 1000.0f : 0;
+  if (!b.have || dt > PV_BATT_GAP_S){
+    b.soc = socx10; pvBattAnchor(b, dir, false);
+    b.pw = (float)battW; b.pvar = 0.09f * b.pw * b.pw;
+    b.have = true; b.lastMs = nowMs; b.lastW = battW; b.resets++;
+    return;
+  }
+  // Energie seit dem letzten Sample (Trapez); wann genau dazwischen die Anzeige sprang, ist offen
+  const float de = (float)(b.lastW + battW) * 0.5f * dt / 3600.0f;
+  b.lastMs = nowMs; b.lastW = battW;
+  const int32_t ds = (int32_t)socx10 - (int32_t)b.soc;
+  b.soc = socx10;
+
+  // Leistung: bei Richtungswechsel neu, sonst EWMA mit Varianz
+  if (dir != b.dir){
+    pvBattAnchor(b, dir, false);
+    b.pw = (float)battW; b.pvar = 0.09f * b.pw * b.pw;
+    return;
+  }
+  const float a = dt / (PV_BATT_TAU_S + dt), r = (float)battW - b.pw;
+  b.pw += a * r;
+  b.pvar = (1 - a) * (b.pvar + a * r * r);
+  if (dir == PVB_IDLE) return;
+
+  b.e += de;
+  if (!ds) return;
+  // Sprung gegen die Richtung (Korrektur im BMS) oder erster Sprung: hier ansetzen
+  // Sprung irgendwo im letzten Abstand (gleichverteilt): Varianz de²/12, am Anker ebenso
+  const float v = de * de / 12.0f;
+  if ((dir == PVB_CHG) != (ds > 0) || !b.edge){
+    pvBattAnchor(b, dir, (dir == PVB_CHG) == (ds > 0));
+    b.eVar = v;
+    return;
+  }
+  // Update: k aus dem ganzen Abschnitt gegen die Basis (nicht kumulativ, sonst zählt er mehrfach)
+  const float y = (float)((int32_t)b.soc - (int32_t)b.soc0), x = b.e;
+  if (fabsf(x) < 1e-3f) return;
+  const uint8_t d = dir;
+  const float kx = y / x;
+  const float R = (2.0f * PV_BATT_SOC_SD * PV_BATT_SOC_SD + kx * kx * (b.eVar + v)) / (x * x);
+  const float g = b.PB[d] / (b.PB[d] + R);
+  b.k[d] = b.kB[d] + g * (kx - b.kB[d]);
+  b.P[d] = (1 - g) * b.PB[d];
+  if (b.k[d] < 0.05f * b.kB[d]) b.k[d] = 0.05f * b.kB[d];   // nie Richtung umkehren
+  b.steps++;
+}
+
+// ETAs zum aktuellen Stand
+static inline void pvBattEtas(const PvBattEst& b, PvBattEta& o){
+  o = PvBattEta();
+  o.dir = b.dir;
+  if (!b.have || b.dir == PVB_IDLE) return;
+  const uint8_t d = b.dir;
+  const float rate = b.k[d] * b.pw / 3600.0f;   // 0.1 % je s
+  if ((d == PVB_CHG) != (rate > 0)) return;      // geglättet noch auf der anderen Seite
+  o.ratex10 = (int16_t)lroundf(fmaxf(-32000.0f, fminf(32000.0f, rate * 3600.0f)));
+  // zwischen den Sprüngen aus dem Modell, höchstens eine Stufe neben der Anzeige
+  float s = b.soc;
+  if (b.edge){
+    s = (float)b.soc0 + b.k[d] * b.e;
+    s = fminf(fmaxf(s, (float)b.soc - 1), (float)b.soc + 1);
+  }
+  const float rel = sqrtf(b.P[d] / (b.k[d] * b.k[d]) + b.pvar / (b.pw * b.pw));
+  const float c = 100.0f * (1.0f - rel);
+  o.conf = (uint8_t)(c < 0 ? 0 : c > 100 ? 100 : lroundf(c));
+  auto eta = [&](float target)->int32_t{
+    const float t = (target - s) / rate;
+    return t < 0 || t > PV_BATT_ETA_MAX_S ? -1 : (int32_t)lroundf(t);
+  };
+  o.eta20s = eta(PV_BATT_LOW_X10);
+  o.fullS  = d == PVB_CHG ? eta(PV_BATT_FULL_X10) : -1;
+  o.emptyS = d == PVB_DIS ? eta(PV_BATT_EMPTY_X10) : -1;
+}
+
+// ---- Anhang am Frame ----
+// Hinter Zeit- und Energie-Anhang (PvClock.h, PvFill.h). eta20s steht außerdem im Frame selbst
+// (ältere Clients), dort nur ab PV_BATT_CONF_MIN.
+#define PV_BATT_MAGIC 0x4142   // "BA"
+#define PV_FRAME_BATT_FIELDS(F, A) \
+  F(uint16_t, magic)    /* PV_BATT_MAGIC */ \
+  F(int32_t,  eta20s)   /* Sekunden bis 20 % (beide Richtungen), -1 = nicht */ \
+  F(int32_t,  fullS)    /* Sekunden bis voll, -1 = nicht beim Laden */ \
+  F(int32_t,  emptyS)   /* Sekunden bis Entladeende, -1 = nicht beim Entladen */ \
+  F(int16_t,  ratex10)  /* %/h x10, + laden */ \
+  F(uint8_t,  conf)     /* 0..100 */ \
+  F(uint8_t,  dir)      /* PVB_* */ \
+  F(uint16_t, crc)      /* CRC-16 (Modbus) über den Anhang bis vor 'crc' */
+PV_WIRE_MESSAGE(PvFrameBatt, PV_FRAME_BATT_FIELDS)
+static const size_t PV_BATT_WIRE = PvWire<PvFrameBatt>::size;
+static_assert(PV_BATT_WIRE == 20, "Batterie-Anhang: Drahtformat");
+
+static inline size_t pvBattSeal(uint8_t* p, const PvBattEta& e){
+  PvFrameBatt t{ PV_BATT_MAGIC, e.eta20s, e.fullS, e.emptyS, e.ratex10, e.conf, e.dir, 0 };
+  pvWireEncode(t, p);
+  t.crc = crc16_modbus(p, PV_BATT_WIRE - 2);
+  p[PV_BATT_WIRE - 2] = (uint8_t)t.crc; p[PV_BATT_WIRE - 1] = (uint8_t)(t.crc >> 8);
+  return PV_BATT_WIRE;
+}
+
+// Anhang ab 'at' prüfen
+static inline bool pvBattGet(const uint8_t* data, size_t len, size_t at, PvBattEta& e){
+  PvFrameBatt t;
+  if (!pvWireDecode(data + at, len < at ? 0 : len - at, t)) return false;
+  if (t.magic != PV_BATT_MAGIC || t.crc != crc16_modbus(data + at, PV_BATT_WIRE - 2) || t.dir > PVB_IDLE) return false;
+  e.eta20s = t.eta20s; e.fullS = t.fullS; e.emptyS = t.emptyS; e.ratex10 = t.ratex10; e.conf = t.conf; e.dir = t.dir;
+  return true;
+}
@@ -0,0 +1,185 @@
+// ===================== PvBoot.h =====================
+// Schnellstart: der zuletzt angezeigte Frame und die Tages-/Monatsakkus liegen als Boot-Cache
+// im RTC-Speicher (übersteht Software-Reset/Watchdog) und im NVS (übersteht Stromausfall).
+// setup() zeichnet daraus sofort die letzte Seite, als "alt" markiert, und wartet nicht mehr
+// auf WLAN/NTP. WLAN, NTP, Empfang und Stats-Sync laufen danach nebeneinander über
+// pvBootStep() aus loop(); jede Phase wird mit millis() protokolliert (Serial 'b').
+// Clients stellen die Uhr nach dem Poller (PvClock.h), NTP nur als Ersatz ohne Poller.
+// Ohne Arduino-Abhängigkeiten: tools/pvboot.cpp simuliert den Start damit.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "PvFrame.h"
+#include "PvEnergy.h"
+
+#ifndef PV_STALE_MS
+  #define PV_STALE_MS        30000    // länger ohne frische Daten -> Anzeige "alt"
+#endif
+#ifndef PV_BOOT_SAVE_MS
+  #define PV_BOOT_SAVE_MS    600000   // Boot-Cache höchstens alle 10 min ins NVS (RTC bei jedem Frame)
+#endif
+#define PV_WIFI_RETRY_MS     10000    // WLAN hängt: neu anstoßen, Pause verdoppelt sich bis
+#define PV_WIFI_RETRY_MAX    60000
+#define PV_DISCOVER_MS       2000     // Stats-Discover wiederholen, bis ein Server antwortet; Pause bis
+#define PV_DISCOVER_MAX      30000
+#define PV_SYNC_TIMEOUT_MS   120000   // Offer erhalten, aber kein STATS_DONE -> neu suchen
+#define PV_CLK_NTP_MS        45000    // Client: so lange nach Netzstart ohne Poller-Zeit -> NTP
+
+// ---------- Boot-Cache ----------
+#define PV_BOOT_MAGIC   0x4342   // "BC"
+#define PV_BOOT_VERSION 3        // 2: PvFrameV4 im Speicher ausgerichtet (PvWire.h), 3: Akkus mit Spitzen
+
+typedef struct __attribute__((packed)) {
+  uint16_t  magic;        // PV_BOOT_MAGIC
+  uint8_t   version;      // PV_BOOT_VERSION
+  uint8_t   page;         // zuletzt angezeigte Seite
+  uint32_t  ymd;          // Tag der Akkus (JJJJMMTT)
+  uint32_t  savedTs;      // Unix-Zeit beim Sichern
+  PvFrameV4 f;            // letzter frischer Frame
+  PvEnergy  day, month;   // Tages-/Monatsakkus zum Zeitpunkt savedTs
+  PvPeaks   dayPk, monthPk;   // ... deren Spitzen (PvAgg::pk)
+  uint16_t  crc;          // CRC-16 (Modbus) über alles davor
+} PvBootCache;
+
+static inline void pvBootCacheSeal(PvBootCache& c){
+  c.magic = PV_BOOT_MAGIC; c.version = PV_BOOT_VERSION;
+  c.crc = crc16_modbus((const uint8_t*)&c, offsetof(PvBootCache, crc));
+}
+
+// RTC-Speicher ist nach dem Einschalten zufällig, NVS evtl. von einer älteren Version
+static inline bool pvBootCacheValid(const PvBootCache& c){
+  return c.magic == PV_BOOT_MAGIC && c.version == PV_BOOT_VERSION && c.f.magic == PV_MAGIC &&
+         c.crc == crc16_modbus((const uint8_t*)&c, offsetof(PvBootCache, crc));
+}
+
+// Was mit den Akkus aus dem Cache geschieht, sobald das heutige Datum bekannt ist.
+// Im NVS stehen Tag/Monat erst nach dem Wechsel, der Cache ist also neuer.
+enum : uint8_t {
+  PVBR_DAY        = 1,   // Tagesakku übernehmen (gleicher Tag)
+  PVBR_MONTH      = 2,   // Monatsakku übernehmen (gleicher Monat)
+  PVBR_SAVE_DAY   = 4,   // Tag im Cache ist vorbei: als Tagesrecord sichern, falls keiner da ist
+  PVBR_SAVE_MONTH = 8,   // Monat im Cache ist vorbei: ebenso
+};
+static inline uint8_t pvBootRestorePlan(uint32_t cacheYmd, uint32_t todayYmd){
+  if (!cacheYmd || cacheYmd > todayYmd) return 0;          // Uhr damals/heute falsch: verwerfen
+  if (cacheYmd == todayYmd) return PVBR_DAY | PVBR_MONTH;
+  if (cacheYmd / 100 == todayYmd / 100) return PVBR_SAVE_DAY | PVBR_MONTH;
+  return PVBR_SAVE_DAY | PVBR_SAVE_MONTH;
+}
+
+// ---------- Phasen ----------
+enum : uint8_t {
+  PVB_CACHE = 0,   // Boot-Cache gelesen (gültig oder nicht)
+  PVB_PIXEL,       // erstes Bild sichtbar (Cache-Seite bzw. Wartetext), Backlight an
+  PVB_WIFI,        // WLAN verbunden
+  PVB_NET,         // Empfang/Server gestartet
+  PVB_TIME,        // Uhr gültig (Poller-Zeit, NTP oder RTC nach Software-Reset)
+  PVB_OFFER,       // Stats-Server gefunden (Client)
+  PVB_LIVE,        // erste frische Daten
+  PVB_SYNC,        // Stats-Sync fertig (Client)
+  PVB_COUNT
+};
+
+static inline const char* pvBootPhaseName(uint8_t p){
+  switch (p){
+    case PVB_CACHE: return "cache";
+    case PVB_PIXEL: return "erstes Bild";
+    case PVB_WIFI:  return "wlan";
+    case PVB_NET:   return "netz";
+    case PVB_TIME:  return "uhr";
+    case PVB_OFFER: return "offer";
+    case PVB_LIVE:  return "live";
+    case PVB_SYNC:  return "sync";
+    default:        return "?";
+  }
+}
+
+struct PvBootLog {
+  uint32_t ms[PVB_COUNT] = {};   // Zeitpunkt je Phase (millis), 0 = noch nicht erreicht
+  bool mark(uint8_t p, uint32_t now){
+    if (ms[p]) return false;
+    ms[p] = now ? now : 1;
+    return true;
+  }
+  bool reached(uint8_t p) const { return ms[p] != 0; }
+};
+
+// ---------- Zustandsautomat ----------
+struct PvBootIn {
+  bool     wifiUp;    // WiFi.status() == WL_CONNECTED
+  bool     timeOk;    // pvTimeValid(time())
+  uint32_t offerMs;   // letzter STATS_OFFER (0 = keiner)
+  bool     synced;    // STATS_DONE erhalten
+  uint32_t liveMs;    // letzter frischer Frame (0 = keiner seit Start)
+  bool     pollerClock;  // Client: Poller-Zeit frisch (pvClockFresh)
+};
+
+// Aktionen für den Sketch (Bitmaske)
+enum : uint16_t {
+  PVBA_WIFI_RETRY = 0x01,   // WLAN trennen und neu verbinden
+  PVBA_NET_UP     = 0x02,   // erstmals verbunden: Empfang bzw. Server starten
+  PVBA_TIME_OK    = 0x04,   // Uhr gültig: Tagesanker setzen, Akkus aus NVS/Boot-Cache übernehmen
+  PVBA_DISCOVER   = 0x08,   // Stats-Discover senden
+  PVBA_LIVE       = 0x10,   // erste frische Daten
+  PVBA_REDRAW     = 0x20,   // Markierung "alt" hat gewechselt
+  PVBA_NTP_START  = 0x40,   // Client: keine Poller-Zeit -> SNTP starten
+  PVBA_NTP_STOP   = 0x80,   // Client: Poller-Zeit wieder da -> SNTP beenden
+};
+
+struct PvBoot {
+  PvBootLog log;
+  bool     discover = false;       // Rolle mit Stats-Client (setzt der Sketch)
+  bool     ntpFallback = false;    // Uhr vom Poller, NTP nur ersatzweise (Client, setzt der Sketch)
+  bool     ntpOn = false;
+  uint32_t clkSeen = 0;            // zuletzt Poller-Zeit gehabt (bzw. Netzstart)
+  bool     wifiUp = false, netStarted = false, timeOk = false, live = false, stale = true;
+  uint32_t wifiT0 = 0, wifiGap = PV_WIFI_RETRY_MS;
+  uint32_t discAt = 0, discGap = PV_DISCOVER_MS;
+  uint16_t wifiRetries = 0, discovers = 0, ntpStarts = 0;
+};
+
+static inline uint16_t pvBootStep(PvBoot& b, uint32_t now, const PvBootIn& in){
+  uint16_t a = 0;
+
+  // WLAN: WiFi.begin() läuft im Hintergrund; hängt es, nach wachsender Pause neu anstoßen
+  if (in.wifiUp){
+    if (!b.wifiUp){ b.wifiUp = true; b.wifiGap = PV_WIFI_RETRY_MS; b.log.mark(PVB_WIFI, now); }
+    if (!b.netStarted){ b.netStarted = true; b.discAt = b.clkSeen = now; a |= PVBA_NET_UP; b.log.mark(PVB_NET, now); }
+  } else {
+    if (b.wifiUp){ b.wifiUp = false; b.wifiT0 = now; }
+    if (now - b.wifiT0 >= b.wifiGap){
+      a |= PVBA_WIFI_RETRY; b.wifiT0 = now; b.wifiRetries++;
+      b.wifiGap = b.wifiGap * 2 > PV_WIFI_RETRY_MAX ? PV_WIFI_RETRY_MAX : b.wifiGap * 2;
+    }
+  }
+
+  // Uhr: Client nach dem Poller (Frames/Offer), NTP erst, wenn eine Weile keine Poller-Zeit kommt;
+  // der Poller selbst (und Clients ohne ntpFallback) fragt NTP parallel zum Verbinden
+  if (b.ntpFallback && b.netStarted){
+    if (in.pollerClock){
+      b.clkSeen = now;
+      if (b.ntpOn){ b.ntpOn = false; a |= PVBA_NTP_STOP; }
+    } else if (!b.ntpOn && (int32_t)(now - b.clkSeen) >= PV_CLK_NTP_MS){
+      b.ntpOn = true; a |= PVBA_NTP_START; b.ntpStarts++;
+    }
+  }
+  if (in.timeOk && !b.timeOk){ b.timeOk = true; a |= PVBA_TIME_OK; b.log.mark(PVB_TIME, now); }
+
+  // Stats: Discover wiederholen, bis ein Server antwortet (Poller startet evtl. später);
+  // kommt nach dem Offer kein Abschluss, wieder suchen
+  if (in.offerMs) b.log.mark(PVB_OFFER, in.offerMs);
+  if (in.synced)  b.log.mark(PVB_SYNC, now);
+  bool waiting = in.offerMs && (int32_t)(now - in.offerMs) < PV_SYNC_TIMEOUT_MS;
+  if (b.discover && b.netStarted && b.wifiUp && !in.synced && !waiting && (int32_t)(now - b.discAt) >= 0){
+    a |= PVBA_DISCOVER; b.discovers++;
+    b.discAt = now + b.discGap;
+    b.discGap = b.discGap * 2 > PV_DISCOVER_MAX ? PV_DISCOVER_MAX : b.discGap * 2;
+  }
+
+  // frisch / alt
+  // vorzeichenbehaftet: liveMs/offerMs setzt ein anderer Task, sie können minimal neuer als now sein
+  bool fresh = in.liveMs && (int32_t)(now - in.liveMs) < PV_STALE_MS;
+  if (fresh && !b.live){ b.live = true; a |= PVBA_LIVE; b.log.mark(PVB_LIVE, now); }
+  if (fresh == b.stale){ b.stale = !fresh; a |= PVBA_REDRAW; }
+  return a;
+}
@@ -0,0 +1,200 @@
+// ===================== PvCalendar.h =====================
+// Kalender-/Tarif-Cache: nächste Mitternacht, Monatswechsel, Sommerzeit-Umstellung und
+// Tarifgrenze werden einmal berechnet und als Epoch-Zeit gehalten. Pro Tick reicht dann
+// ein Vergleich "now < nextBoundary"; localtime_r()/mktime() nur beim Überschreiten.
+// Ohne Arduino-Abhängigkeiten: wird auch von tools/pvcal.cpp benutzt (Zeitzone über TZ).
+#pragma once
+#include <stdint.h>
+#include <time.h>
+
+// ---- Tarife ----
+enum : uint8_t { PV_T1 = 1, PV_T2 = 2 };
+
+// Wochentags-Maske (Bit0 = So .. Bit6 = Sa, wie tm_wday), PV_FEIERTAG = gilt an Feiertagen
+#define PV_SO 0x01
+#define PV_MO 0x02
+#define PV_DI 0x04
+#define PV_MI 0x08
+#define PV_DO 0x10
+#define PV_FR 0x20
+#define PV_SA 0x40
+#define PV_FEIERTAG 0x80
+#define PV_MO_FR (PV_MO|PV_DI|PV_MI|PV_DO|PV_FR)
+
+struct PvTariffPeriod {
+  uint8_t  days;          // Wochentags-Maske
+  uint16_t fromMin;       // Beginn, Minuten ab 00:00 (lokal)
+  uint16_t toMin;         // Ende (exklusiv), 1440 = Mitternacht
+  uint8_t  tariff;        // PV_T1 / PV_T2
+};
+
+struct PvPrices {
+  uint32_t fromYmd;       // gültig ab YYYYMMDD
+  float    t1, t2, exp;   // CHF/kWh
+};
+
+// ================= Konfiguration (hier anpassen) =================
+// Eigene Tabellen in separater Datei: #define PV_TARIFF_CUSTOM "datei.h" vor dem Include,
+// die Datei legt PV_TARIFF_PERIODS, PV_TARIFF_DEFAULT, PV_HOLIDAYS und PV_PRICES an und liegt
+// neben dem Sketch (Beispiel: tools/pvcal_tarif.h, zum Verwenden nach SolarDisplay/ kopieren).
+#ifdef PV_TARIFF_CUSTOM
+  #include PV_TARIFF_CUSTOM
+#else
+// Perioden: erste passende gewinnt; nicht abgedeckte Zeit = PV_TARIFF_DEFAULT
+static const PvTariffPeriod PV_TARIFF_PERIODS[] = {
+  { PV_MO_FR, 7*60, 18*60, PV_T1 },        // Mo-Fr 07-18 Hochtarif
+};
+#define PV_TARIFF_DEFAULT PV_T2
+
+// Feiertage: YYYYMMDD (einmalig) oder MMDD (jedes Jahr); an Feiertagen gelten nur
+// Perioden mit PV_FEIERTAG. Liste mit 0 abschliessen.
+static const uint32_t PV_HOLIDAYS[] = {
+  // 101, 801, 1225, 1226,                  // Beispiel: Neujahr, 1. August, Weihnachten
+  0
+};
+
+// Preise nach Datum (aufsteigend); der letzte Eintrag mit fromYmd <= Tag gilt
+static const PvPrices PV_PRICES[] = {
+  { 0, 0.344f, 0.2597f, 0.138f },
+};
+#endif
+// =================================================================
+
+static inline uint32_t pvYmd(int y, int m, int d){ return (uint32_t)(y*10000 + m*100 + d); }
+
+static inline bool pvIsHoliday(uint32_t ymd){
+  for (const uint32_t* h = PV_HOLIDAYS; *h; ++h)
+    if (*h == ymd || (*h < 10000 && *h == ymd % 10000)) return true;
+  return false;
+}
+
+static inline const PvPrices& pvPricesFor(uint32_t ymd){
+  const PvPrices* p = &PV_PRICES[0];
+  for (const PvPrices& c : PV_PRICES) if (c.fromYmd <= ymd) p = &c;
+  return *p;
+}
+
+// Tarif zu Tagesmaske (Wochentag-Bit oder PV_FEIERTAG) und Minute; nextMin = nächste Grenze (<=1440)
+static inline uint8_t pvTariffAt(uint8_t dayBit, uint16_t minute, uint16_t& nextMin){
+  uint8_t t = 0;
+  nextMin = 1440;
+  for (const PvTariffPeriod& p : PV_TARIFF_PERIODS){
+    if (!(p.days & dayBit)) continue;
+    if (!t && p.fromMin <= minute && minute < p.toMin) t = p.tariff;
+    if (p.fromMin > minute && p.fromMin < nextMin) nextMin = p.fromMin;
+    if (p.toMin   > minute && p.toMin   < nextMin) nextMin = p.toMin;
+  }
+  return t ? t : PV_TARIFF_DEFAULT;
+}
+
+// ---- Cache ----
+struct PvCalendar {
+  time_t   validFrom = 0;     // Zeitpunkt der letzten Berechnung (Rücksprung -> neu berechnen)
+  time_t   dayStart = 0;      // lokale Mitternacht heute
+  time_t   nextDay  = 0;      // nächste lokale Mitternacht
+  time_t   nextMonth = 0;     // 1. des nächsten Monats 00:00
+  time_t   dstChange = 0;     // Umstellung heute (0 = keine)
+  time_t   nextBoundary = 0;  // min(nextDay, Tarifgrenze, dstChange) -> Neuberechnung
+  int32_t  utcOff = 0;        // lokal - UTC (s), gültig in [offFrom, offTo)
+  time_t   offFrom = 0, offTo = 0;
+  int      y = 0, m = 0, d = 0, wday = 0;
+  uint32_t ymd = 0;
+  bool     holiday = false;
+  uint8_t  tariff = PV_TARIFF_DEFAULT;
+  PvPrices price = {0, 0, 0, 0};
+  uint32_t recalcs = 0;       // Anzahl Neuberechnungen (Messung)
+};
+
+static inline time_t pvLocalMktime(int y, int m, int d, int hh, int mm){
+  struct tm t = {};
+  t.tm_year = y - 1900; t.tm_mon = m - 1; t.tm_mday = d; t.tm_hour = hh; t.tm_min = mm; t.tm_isdst = -1;
+  return mktime(&t);
+}
+
+// lokale Zeit - UTC in Sekunden (aus tm, ohne tm_gmtoff)
+static inline int32_t pvUtcOffset(time_t now, const struct tm& lt){
+  struct tm g; gmtime_r(&now, &g);
+  int32_t dd = (lt.tm_yday - g.tm_yday);
+  if (dd > 1) dd = -1; else if (dd < -1) dd = 1;   // Jahreswechsel
+  return dd*86400 + (lt.tm_hour - g.tm_hour)*3600 + (lt.tm_min - g.tm_min)*60 + (lt.tm_sec - g.tm_sec);
+}
+
+static void pvCalRecompute(PvCalendar& c, time_t now){
+  struct tm lt; localtime_r(&now, &lt);
+  c.y = lt.tm_year + 1900; c.m = lt.tm_mon + 1; c.d = lt.tm_mday; c.wday = lt.tm_wday;
+  c.ymd = pvYmd(c.y, c.m, c.d);
+  c.dayStart  = pvLocalMktime(c.y, c.m, c.d, 0, 0);
+  c.nextDay   = pvLocalMktime(c.y, c.m, c.d + 1, 0, 0);   // mktime normalisiert Monats-/Jahresende
+  c.nextMonth = pvLocalMktime(c.y, c.m + 1, 1, 0, 0);
+  c.utcOff    = pvUtcOffset(now, lt);
+
+  // Sommerzeit-Umstellung heute? (Tag hat dann 23 bzw. 25 h) -> Zeitpunkt binär suchen
+  c.dstChange = 0;
+  if (c.nextDay - c.dayStart != 86400){
+    struct tm a; localtime_r(&c.dayStart, &a);
+    time_t lo = c.dayStart, hi = c.nextDay - 1;
+    while (hi - lo > 1){
+      time_t mid = lo + (hi - lo) / 2;
+      struct tm b; localtime_r(&mid, &b);
+      if (b.tm_isdst == a.tm_isdst) lo = mid; else hi = mid;
+    }
+    c.dstChange = hi;
+  }
+  c.offFrom = c.dayStart; c.offTo = c.nextDay;
+  if (c.dstChange){ if (now < c.dstChange) c.offTo = c.dstChange; else c.offFrom = c.dstChange; }
+
+  c.holiday = pvIsHoliday(c.ymd);
+  uint8_t dayBit = c.holiday ? PV_FEIERTAG : (uint8_t)(1u << c.wday);
+  uint16_t nextMin;
+  c.tariff = pvTariffAt(dayBit, (uint16_t)(lt.tm_hour*60 + lt.tm_min), nextMin);
+  time_t nb = nextMin >= 1440 ? c.nextDay : pvLocalMktime(c.y, c.m, c.d, nextMin / 60, nextMin % 60);
+  if (nb <= now) nb = now + 1;                               // Grenze in der Umstellungs-Lücke
+  if (nb > c.nextDay) nb = c.nextDay;
+  if (c.dstChange > now && c.dstChange < nb) nb = c.dstChange;
+  c.nextBoundary = nb;
+  c.price = pvPricesFor(c.ymd);
+  c.validFrom = now;
+  c.recalcs++;
+}
+
+// Pro Tick: true, wenn neu berechnet wurde (Tarif-/Tages-/DST-Grenze überschritten oder Zeitsprung)
+static inline bool pvCalTick(PvCalendar& c, time_t now){
+  if (now < c.nextBoundary && now >= c.validFrom) return false;
+  pvCalRecompute(c, now);
+  return true;
+}
+
+// Lokale Wanduhr aus dem Cache (Fallback localtime_r ausserhalb des gültigen Fensters)
+static inline void pvCalWall(const PvCalendar& c, time_t t, int& hh, int& mm){
+  if (t >= c.offFrom && t < c.offTo){
+    int32_t s = (int32_t)((t + c.utcOff) % 86400); if (s < 0) s += 86400;
+    hh = s / 3600; mm = (s / 60) % 60;
+    return;
+  }
+  struct tm lt; localtime_r(&t, &lt); hh = lt.tm_hour; mm = lt.tm_min;
+}
+
+// Uhr gestellt? Vor NTP (ohne RTC-Zeit nach Software-Reset) steht time() bei 1970
+static const time_t PV_TIME_MIN = 1600000000;   // 13.09.2020
+static inline bool pvTimeValid(time_t t){ return t >= PV_TIME_MIN; }
+
+#ifdef ARDUINO
+// Gemeinsamer Cache für Sketch und Anzeige. Gelesen aus loop() (Anzeige, Backlight, Verlauf) und
+// dem UDP-Task (Integration, Tageswechsel): Rückgabe als Kopie, Kopieren und Veröffentlichen unter
+// pvCalMux. Neu gerechnet wird außerhalb (localtime_r()/mktime() gehören nicht in eine kritische
+// Sektion); rechnen beide Tasks an einer Grenze, gilt jede Fassung für ihr now.
+static PvCalendar pvCal;
+static portMUX_TYPE pvCalMux = portMUX_INITIALIZER_UNLOCKED;
+static inline PvCalendar pvCalNow(){
+  time_t n; time(&n);
+  portENTER_CRITICAL(&pvCalMux);
+  PvCalendar c = pvCal;
+  portEXIT_CRITICAL(&pvCalMux);
+  if (pvCalTick(c, n)){
+    portENTER_CRITICAL(&pvCalMux);
+    pvCal = c;
+    portEXIT_CRITICAL(&pvCalMux);
+  }
+  return c;
+}
+#endif
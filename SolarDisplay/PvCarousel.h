@@ -0,0 +1,255 @@
+// ===================== PvCarousel.h =====================
+// Verlauf an alle Clients auf einmal. Statt je STATS_REQ_RANGE einen eigenen Unicast-Strom
+// schickt der Poller die Tagesrecords als Karussell von Blöcken (PV_CAR_DAYS Tage je Block)
+// auf STATS_MCAST_GRP:
+//  - STATS_CAR_REQ macht alle Blöcke fällig, STATS_CAR_NACK nur die genannten;
+//  - der Poller sendet reihum ab der aktuellen Position jeden fälligen Block einmal, gleich
+//    wie viele Clients gleichzeitig fragen; ist nichts mehr fällig, folgt STATS_CAR_IDLE;
+//  - wer später dazukommt, sammelt ab dem gerade gesendeten Block, den Anfang bekommt er
+//    in der nächsten Runde;
+//  - Lücken meldet ein Client nach STATS_CAR_IDLE bzw. wenn eine Weile nichts Neues kam,
+//    zufällig verzögert; hört er vorher den NACK eines anderen, wartet er weiter
+//    (die Wiederholung geht an alle).
+// Wochen/Monate/Jahre entstehen auf dem Client aus den Tagen (PvRollup.h).
+// Ohne Arduino-Abhängigkeiten: tools/pvcarousel.cpp simuliert viele Clients mit Verlust.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PvStats.h"
+#include "PvEnergy.h"
+#include "PvRollup.h"
+
+#define PV_CAR_DAYS        8      // Tage je Block (Maske 8 Bit)
+#define PV_CAR_MAX_BLOCKS  (((PV_ROLLUP_YEARS + 1) * 366) / PV_CAR_DAYS + 1)
+#define PV_CAR_GAP_MS      20     // Poller: höchstens ein Block je Abstand (50/s)
+#define PV_CAR_IDLE_MS     2000   // Client: so lange nichts Neues -> Lücken melden bzw. neu anfragen
+#define PV_CAR_BACKOFF_MS  300    // Client: NACK zufällig bis so weit verzögern
+#define PV_CAR_LISTEN_MS   200    // Client: erst zuhören, läuft schon eine Runde, keine Anfrage
+#define PV_CAR_SPANS       24     // Lücken je NACK
+#define PV_CAR_TAIL_MS     5000   // Client: nach Mitternacht so lange (bis doppelt) warten
+#define PV_CAR_BLOCK_MAX   (PvWire<PayloadCarBlock>::size + PV_CAR_DAYS * PvWire<PayloadCarDay>::size)
+static_assert(PV_CAR_BLOCK_MAX <= STATS_MAX_PAYLOAD, "Block passt nicht in den Sendepuffer");
+
+static inline bool pvCarBit(const uint8_t* b, uint16_t i){ return b[i >> 3] & (1u << (i & 7)); }
+static inline void pvCarSet(uint8_t* b, uint16_t i){ b[i >> 3] |= (uint8_t)(1u << (i & 7)); }
+static inline void pvCarClr(uint8_t* b, uint16_t i){ b[i >> 3] &= (uint8_t)~(1u << (i & 7)); }
+
+static inline PayloadCarDay pvCarDay(const PvEnergy& a){
+  return { a.e[PVE_GEN], a.e[PVE_LOAD], a.e[PVE_IMP_T1], a.e[PVE_IMP_T2], a.e[PVE_EXP] };
+}
+static inline PvEnergy pvCarEnergy(const PayloadCarDay& d){
+  PvEnergy a;
+  a.e[PVE_GEN] = d.gen; a.e[PVE_LOAD] = d.load; a.e[PVE_IMP_T1] = d.impT1; a.e[PVE_IMP_T2] = d.impT2; a.e[PVE_EXP] = d.exp;
+  return a;
+}
+
+// Erster Tag mit Record: erst Jahre, dann Monate, dann Tage (gut 50 Lesezugriffe statt
+// 10 Jahre Tage). Ohne Stufen (Neuaufbau läuft) bzw. ohne Record: ganze PV_ROLLUP_YEARS.
+template<class S>
+static inline int32_t pvCarFirstDay(S& s, int32_t today, bool rollupsReady){
+  int y, m, d; pvDayCivil(today, y, m, d);
+  const int32_t lo = pvDayNum(y - PV_ROLLUP_YEARS, 1, 1);
+  if (!rollupsReady) return lo;
+  PvEnergy a; char key[12];
+  for (int yy = y - PV_ROLLUP_YEARS; yy <= y; ++yy){
+    pvRollupKey(PVL_YEAR, (uint32_t)yy, key, sizeof(key));
+    if (!s.load(key, a)) continue;
+    for (int mm = 1; mm <= 12; ++mm){
+      pvRollupKey(PVL_MONTH, (uint32_t)(yy * 100 + mm), key, sizeof(key));
+      if (!s.load(key, a)) continue;
+      const int32_t end = pvRollupStep(PVL_MONTH, (uint32_t)(yy * 100 + mm), 1);
+      for (int32_t n = pvDayNum(yy, mm, 1); n < pvRollupStart(PVL_MONTH, end) && n <= today; ++n){
+        pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key));
+        if (s.load(key, a)) return n;
+      }
+    }
+  }
+  return lo;
+}
+
+// ---------- Poller ----------
+struct PvCarSender {
+  int32_t  first = 0;
+  uint16_t blocks = 0;        // 0 = Bereich noch nicht bestimmt
+  uint16_t next = 0;          // Umlaufposition
+  uint16_t pending = 0;       // fällige Blöcke
+  bool     idle = true;       // nichts fällig und STATS_CAR_IDLE gesendet
+  uint32_t lastMs = 0;
+  uint8_t  want[(PV_CAR_MAX_BLOCKS + 7) / 8] = {};
+  // Messung
+  uint32_t reqs = 0, nacks = 0, sent = 0, rounds = 0;
+};
+
+// Bereich first..today. Gleicher Anfang: es kommen nur Blöcke hinzu (fällig, falls eine Runde
+// läuft); sonst neu (alles fällig, falls eine Runde läuft).
+static inline void pvCarRange(PvCarSender& c, int32_t first, int32_t today){
+  if (today - first >= (int32_t)PV_CAR_MAX_BLOCKS * PV_CAR_DAYS) first = today - (PV_CAR_MAX_BLOCKS * PV_CAR_DAYS - 1);
+  const uint16_t n = today < first ? 0 : (uint16_t)((today - first) / PV_CAR_DAYS + 1);
+  if (first == c.first && n == c.blocks) return;
+  const bool run = c.pending > 0;
+  uint16_t from = c.blocks;
+  if (first != c.first || n < c.blocks){ memset(c.want, 0, sizeof(c.want)); c.pending = 0; c.next = 0; from = 0; }
+  for (uint16_t i = from; i < n; ++i) if (run){ pvCarSet(c.want, i); c.pending++; }
+  c.first = first; c.blocks = n;
+  if (c.next >= n) c.next = 0;
+}
+
+static inline void pvCarRequest(PvCarSender& c){
+  c.reqs++;
+  for (uint16_t i = 0; i < c.blocks; ++i) pvCarSet(c.want, i);
+  c.pending = c.blocks;
+  c.idle = !c.blocks;
+}
+
+// Lücken eines Clients; anderer Bereich (z.B. vor Mitternacht angefragt): alles
+static inline void pvCarNack(PvCarSender& c, const PayloadCarNack& h, const PayloadCarSpan* s){
+  c.nacks++;
+  if (h.first != c.first){ pvCarRequest(c); return; }
+  for (uint8_t k = 0; k < h.n; ++k)
+    for (uint32_t i = s[k].idx; i < (uint32_t)s[k].idx + s[k].count && i < c.blocks; ++i)
+      if (!pvCarBit(c.want, (uint16_t)i)){ pvCarSet(c.want, (uint16_t)i); c.pending++; }
+  if (c.pending) c.idle = false;
+}
+
+enum : int32_t { PVCAR_WAIT = -1, PVCAR_SEND_IDLE = -2 };
+
+// Nächster Block zum Senden, PVCAR_WAIT (nichts bzw. noch nicht dran) oder PVCAR_SEND_IDLE
+static inline int32_t pvCarNext(PvCarSender& c, uint32_t now){
+  if (c.sent && (int32_t)(now - c.lastMs) < PV_CAR_GAP_MS) return PVCAR_WAIT;
+  if (!c.pending){
+    if (c.idle) return PVCAR_WAIT;
+    c.idle = true; c.lastMs = now; c.rounds++;
+    return PVCAR_SEND_IDLE;
+  }
+  for (uint16_t k = 0; k < c.blocks; ++k){
+    uint16_t i = (uint16_t)((c.next + k) % c.blocks);
+    if (!pvCarBit(c.want, i)) continue;
+    pvCarClr(c.want, i); c.pending--;
+    c.next = (uint16_t)((i + 1) % c.blocks);
+    c.lastMs = now; c.sent++;
+    return i;
+  }
+  c.pending = 0;
+  return PVCAR_WAIT;
+}
+
+// Block kodieren (Kopf + vorhandene Tage), Länge zurück. get(n, a): Tag n, false = kein Record.
+template<class G>
+static inline size_t pvCarBuild(const PvCarSender& c, uint16_t idx, int32_t today, G get, uint8_t* out){
+  PayloadCarBlock b{ c.first, c.blocks, idx, 0, 0 };
+  uint8_t* p = out + PvWire<PayloadCarBlock>::size;
+  for (uint8_t i = 0; i < PV_CAR_DAYS; ++i){
+    const int32_t n = c.first + (int32_t)idx * PV_CAR_DAYS + i;
+    PvEnergy a;
+    if (n > today || !get(n, a)) continue;
+    b.mask |= (uint8_t)(1u << i);
+    p += pvWireEncode(pvCarDay(a), p);
+  }
+  pvWireEncode(b, out);
+  return (size_t)(p - out);
+}
+
+static inline size_t pvCarBuildIdle(const PvCarSender& c, uint8_t* out){
+  PayloadCarBlock b{ c.first, c.blocks, c.blocks, 0, 0 };
+  return pvWireEncode(b, out);
+}
+
+// ---------- Client ----------
+enum : uint8_t { PVCAR_NONE = 0, PVCAR_REQ, PVCAR_NACK };
+
+struct PvCarReceiver {
+  bool     active = false, done = false;
+  int32_t  first = 0;
+  uint16_t blocks = 0;        // 0 = Bereich noch unbekannt
+  uint16_t have = 0;
+  uint32_t reqMs = 0, newMs = 0, nackAt = 0;
+  bool     nackDue = false;
+  uint8_t  got[(PV_CAR_MAX_BLOCKS + 7) / 8] = {};
+  // Messung
+  uint32_t rx = 0, dup = 0, reqs = 0, nacks = 0, held = 0, startMs = 0, doneMs = 0;
+};
+
+static inline void pvCarStart(PvCarReceiver& r, uint32_t now){
+  r = PvCarReceiver();
+  r.active = true; r.startMs = now;
+  r.reqMs = now - PV_CAR_IDLE_MS + PV_CAR_LISTEN_MS;   // erste Anfrage nach kurzem Zuhören
+}
+
+// Bereich des Pollers übernehmen; gleicher Anfang: Vorhandenes bleibt
+static inline void pvCarAdopt(PvCarReceiver& r, int32_t first, uint16_t blocks){
+  if (blocks > PV_CAR_MAX_BLOCKS) blocks = PV_CAR_MAX_BLOCKS;
+  if (first == r.first && blocks >= r.blocks){ r.blocks = blocks; return; }
+  memset(r.got, 0, sizeof(r.got));
+  r.first = first; r.blocks = blocks; r.have = 0;
+}
+
+// Block empfangen: true = neu (Tage speichern), danach ggf. r.done
+static inline bool pvCarOnBlock(PvCarReceiver& r, const PayloadCarBlock& b, uint32_t now){
+  if (!r.active || r.done) return false;
+  pvCarAdopt(r, b.first, b.blocks);
+  if (b.idx >= r.blocks) return false;
+  if (pvCarBit(r.got, b.idx)){ r.dup++; return false; }
+  pvCarSet(r.got, b.idx); r.have++; r.rx++;
+  r.newMs = now;
+  if (r.have == r.blocks){ r.done = true; r.doneMs = now; }
+  return true;
+}
+
+// Runde des Pollers fertig: fehlt noch etwas, NACK nach zufälliger Pause
+static inline void pvCarOnIdle(PvCarReceiver& r, const PayloadCarBlock& b, uint32_t now, uint32_t rnd){
+  if (!r.active || r.done) return;
+  pvCarAdopt(r, b.first, b.blocks);
+  if (!r.blocks){ r.done = true; r.doneMs = now; return; }   // Poller hat keinen Verlauf
+  if (!r.nackDue){ r.nackDue = true; r.nackAt = now + rnd % PV_CAR_BACKOFF_MS; }
+}
+
+// NACK eines anderen Clients gehört: die Wiederholung kommt auch hier an, eigenen verwerfen;
+// was danach noch fehlt, meldet der nächste STATS_CAR_IDLE bzw. die nächste Pause
+static inline void pvCarOnNack(PvCarReceiver& r, uint32_t now){
+  if (!r.active || r.done) return;
+  r.newMs = now;
+  if (r.nackDue){ r.nackDue = false; r.held++; }
+}
+
+// Nach Mitternacht: die letzten Blöcke noch einmal (gestern beim Poller geschlossen, hier
+// selbst gerechnet), NACK erst nach der Pause, damit der Poller den Tag schon gesichert hat
+static inline void pvCarTail(PvCarReceiver& r, uint32_t now, uint32_t rnd){
+  if (!r.active || !r.done || !r.blocks) return;
+  for (uint16_t i = r.blocks > 2 ? r.blocks - 2 : 0; i < r.blocks; ++i)
+    if (pvCarBit(r.got, i)){ pvCarClr(r.got, i); r.have--; }
+  r.done = false; r.newMs = now;
+  r.nackDue = true; r.nackAt = now + PV_CAR_TAIL_MS + rnd % PV_CAR_TAIL_MS;
+}
+
+// Aus loop(): was senden?
+static inline uint8_t pvCarTick(PvCarReceiver& r, uint32_t now, uint32_t rnd){
+  if (!r.active || r.done) return PVCAR_NONE;
+  if (!r.blocks){
+    if ((uint32_t)(now - r.reqMs) < PV_CAR_IDLE_MS) return PVCAR_NONE;
+    r.reqMs = now; r.reqs++;
+    return PVCAR_REQ;
+  }
+  if (r.nackDue && (int32_t)(now - r.nackAt) >= 0){
+    r.nackDue = false; r.newMs = now; r.nacks++;
+    return PVCAR_NACK;
+  }
+  if (!r.nackDue && (uint32_t)(now - r.newMs) >= PV_CAR_IDLE_MS){ r.nackDue = true; r.nackAt = now + rnd % PV_CAR_BACKOFF_MS; }
+  return PVCAR_NONE;
+}
+
+// NACK an Quelle src (PvPeer.h) kodieren: die ersten PV_CAR_SPANS Lücken
+static inline size_t pvCarBuildNack(const PvCarReceiver& r, uint32_t src, uint8_t* out){
+  PayloadCarNack h{ r.first, r.blocks, 0, 0, src };
+  uint8_t* p = out + PvWire<PayloadCarNack>::size;
+  for (uint16_t i = 0; i < r.blocks && h.n < PV_CAR_SPANS; ++i){
+    if (pvCarBit(r.got, i)) continue;
+    PayloadCarSpan s{ i, 0 };
+    while (i < r.blocks && !pvCarBit(r.got, i)){ s.count++; i++; }
+    p += pvWireEncode(s, p); h.n++;
+  }
+  pvWireEncode(h, out);
+  return (size_t)(p - out);
+}
+#define PV_CAR_NACK_MAX (PvWire<PayloadCarNack>::size + PV_CAR_SPANS * PvWire<PayloadCarSpan>::size)
+static_assert(PV_CAR_NACK_MAX <= STATS_MAX_PAYLOAD, "NACK passt nicht in den Sendepuffer");
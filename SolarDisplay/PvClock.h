@@ -0,0 +1,172 @@
+// ===================== PvClock.h =====================
+// Uhrverteilung Poller -> Clients: der Poller hängt an jeden Frame (und an STATS_OFFER) einen
+// Zeitstempel in ms, gesetzt direkt vor dem Senden. Clients führen daraus Offset und Drift
+// ihrer millis() gegenüber der Poller-Uhr nach und stellen damit ihre Systemuhr; NTP nur,
+// wenn kein Poller da ist (PvBoot.h, PVBA_NTP_START/STOP).
+//
+// Laufzeit verzögert nur: Poller-Zeit beim Senden - millis() beim Empfang ist eine untere
+// Schranke des wahren Offsets. Deshalb zählt die obere Hülle der Samples: liegt ein Sample
+// über der Schätzung, wird sofort angehoben (die Client-Uhr ist nie hinter einem schon
+// empfangenen Stempel, der Tageswechsel kommt also nie nach dem des Pollers); je Fenster
+// wird auf die Samples mit der kleinsten Laufzeit nachgeführt, die Drift aus deren
+// Steigung über ~45 min geglättet.
+// Ohne Arduino-Abhängigkeiten: tools/pvclock.cpp simuliert Empfang mit Jitter und Drift.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PvFrame.h"
+
+#define PV_CLK_WIN        4          // Samples je Fenster (Frames alle 30 s -> 2 min)
+#define PV_CLK_HIST       24         // Fensterbeste für die Drift (48 min)
+#define PV_CLK_ANCHOR     4          // davon die jüngsten für den Offset (8 min)
+#define PV_CLK_STEP_MS    2000       // Sample so weit unter/über der Schätzung: neu ansetzen
+#define PV_CLK_DRIFT_MAX  0.0005f    // ±500 ppm, mehr ist kein Quarz
+#define PV_CLK_BASE_MS    600000     // Drift erst ab so viel Abstand der beiden Stützpunkte
+#define PV_CLK_HOLD_MS    600000     // ohne Sample so lange weiterlaufen, danach gilt "kein Poller"
+#define PV_CLK_SLEW_MS    500        // Uhr voraus bis hier: langsam nachführen (adjtime), sonst stellen
+
+// ---- Zeit-Anhang ----
+// Hinter dem Frame (gleiches Paket, ab PV_FRAME_WIRE) bzw. hinter PayloadOffer. Ältere Clients
+// lesen nur den Frame bzw. das Offer und übergehen den Anhang.
+#define PV_TIME_MAGIC 0x4D54   // "TM"
+enum : uint8_t { PVTM_SYNCED = 0x01 };   // Uhr des Pollers gestellt (NTP)
+
+#define PV_FRAME_TIME_FIELDS(F, A) \
+  F(uint16_t, magic)    /* PV_TIME_MAGIC */ \
+  F(uint8_t,  flags)    /* PVTM_* */ \
+  F(uint8_t,  rsv) \
+  F(uint32_t, ts)       /* UNIX-Zeit (s) beim Senden */ \
+  F(uint16_t, ms)       /* Millisekunden dazu */ \
+  F(uint16_t, crc)      /* CRC-16 (Modbus) über den Anhang bis vor 'crc' */
+PV_WIRE_MESSAGE(PvFrameTime, PV_FRAME_TIME_FIELDS)
+static const size_t PV_TIME_WIRE = PvWire<PvFrameTime>::size;
+static_assert(PV_TIME_WIRE == 12, "Zeit-Anhang: Drahtformat");
+
+// Anhang kodiert nach 'p' schreiben (PV_TIME_WIRE Bytes)
+static inline size_t pvFrameTimeSeal(uint8_t* p, uint64_t unixMs, bool synced){
+  PvFrameTime t;
+  t.magic = PV_TIME_MAGIC; t.flags = synced ? PVTM_SYNCED : 0; t.rsv = 0;
+  t.ts = (uint32_t)(unixMs / 1000); t.ms = (uint16_t)(unixMs % 1000); t.crc = 0;
+  PvWire<PvFrameTime>::put(t, p);
+  t.crc = crc16_modbus(p, PV_TIME_WIRE - 2);
+  p[PV_TIME_WIRE - 2] = (uint8_t)t.crc; p[PV_TIME_WIRE - 1] = (uint8_t)(t.crc >> 8);
+  return PV_TIME_WIRE;
+}
+
+// Anhang ab Offset 'at' im Paket prüfen; true nur mit gestellter Poller-Uhr
+static inline bool pvFrameTimeGet(const uint8_t* data, size_t len, size_t at, uint64_t& unixMs){
+  PvFrameTime t;
+  if (!pvWireDecode(data + at, len < at ? 0 : len - at, t)) return false;
+  if (t.magic != PV_TIME_MAGIC || t.crc != crc16_modbus(data + at, PV_TIME_WIRE - 2)) return false;
+  if (!(t.flags & PVTM_SYNCED) || t.ms >= 1000) return false;
+  unixMs = (uint64_t)t.ts * 1000 + t.ms;
+  return true;
+}
+
+// ---- Schätzer ----
+struct PvClock {
+  bool     valid = false;
+  int64_t  offMs = 0;        // Poller-Zeit - millis() am Anker
+  uint32_t refMs = 0;        // Anker (millis)
+  float    drift = 0;        // ms je ms (Poller schneller > 0)
+  bool     haveDrift = false;
+  uint32_t lastMs = 0;       // letztes Sample (millis)
+  uint8_t  low = 0;          // Samples weit unter der Schätzung in Folge
+  // Fenster: Sample mit der kleinsten Laufzeit (grösstes Residuum)
+  uint8_t  winN = 0;
+  int32_t  winRes = 0;
+  int64_t  winOff = 0; uint32_t winMs = 0;
+  // Fensterbeste der letzten PV_CLK_HIST Fenster (Ring)
+  int64_t  histOff[PV_CLK_HIST] = {};
+  uint32_t histMs[PV_CLK_HIST] = {};
+  uint8_t  histN = 0, histAt = 0;
+  // Messung
+  uint32_t samples = 0, steps = 0, raises = 0;
+};
+
+static inline int64_t pvClockOffset(const PvClock& c, uint32_t nowMs){
+  return c.offMs + (int64_t)(c.drift * (float)(int32_t)(nowMs - c.refMs));
+}
+
+// Poller-Zeit (Unix-ms) zu millis()
+static inline uint64_t pvClockNowMs(const PvClock& c, uint32_t nowMs){
+  return (uint64_t)((int64_t)nowMs + pvClockOffset(c, nowMs));
+}
+
+// Drift aus dem Ring: bestes Sample im ersten und im letzten Drittel (je ~16 Samples, die
+// kleinste Laufzeit darunter ist ein paar ms), Steigung dazwischen, geglättet
+static inline bool pvClockRingSlope(const PvClock& c, float& slope){
+  const uint8_t n = c.histN, third = (uint8_t)(n / 3);
+  const uint8_t i0 = (uint8_t)((c.histAt + PV_CLK_HIST - n) % PV_CLK_HIST);
+  int8_t a = -1, b = -1;
+  for (uint8_t k = 0; k < third; ++k){
+    uint8_t ha = (uint8_t)((i0 + k) % PV_CLK_HIST), hb = (uint8_t)((i0 + n - 1 - k) % PV_CLK_HIST);
+    if (a < 0 || c.histOff[ha] > c.histOff[a]) a = (int8_t)ha;
+    if (b < 0 || c.histOff[hb] > c.histOff[b]) b = (int8_t)hb;
+  }
+  if (a < 0 || (int32_t)(c.histMs[b] - c.histMs[a]) < PV_CLK_BASE_MS) return false;
+  slope = (float)(c.histOff[b] - c.histOff[a]) / (float)(int32_t)(c.histMs[b] - c.histMs[a]);
+  return true;
+}
+
+// Empfangenes Sample verbuchen (rxMs = millis() beim Empfang). true = neu angesetzt.
+static inline bool pvClockSample(PvClock& c, uint32_t rxMs, uint64_t remoteMs){
+  int64_t o = (int64_t)remoteMs - (int64_t)rxMs;
+  c.samples++; c.lastMs = rxMs;
+  int64_t r = c.valid ? o - pvClockOffset(c, rxMs) : 0;
+  // weit darunter: einzeln nur ein stark verspätetes Paket, erst das zweite in Folge zählt
+  if (c.valid && r < -PV_CLK_STEP_MS && ++c.low < 2) return false;
+  if (!c.valid || r > PV_CLK_STEP_MS || r < -PV_CLK_STEP_MS){
+    // erster Wert oder Poller-Uhr gesprungen: Drift behalten (Eigenschaft der Quarze)
+    c.valid = true; c.low = 0; c.offMs = o; c.refMs = rxMs;
+    c.winN = 0; c.histN = 0;
+    c.steps++;
+    return true;
+  }
+  c.low = 0;
+  if (r > 0){ c.offMs = o; c.refMs = rxMs; c.raises++; }   // obere Hülle: sofort anheben
+
+  if (!c.winN || r > c.winRes){ c.winRes = (int32_t)r; c.winOff = o; c.winMs = rxMs; }
+  if (++c.winN < PV_CLK_WIN) return false;
+  c.winN = 0;
+
+  // Fenster voll: Bestes in den Ring, Drift aus der Hülle, Anker auf die Hülle
+  c.histOff[c.histAt] = c.winOff; c.histMs[c.histAt] = c.winMs;
+  c.histAt = (uint8_t)((c.histAt + 1) % PV_CLK_HIST);
+  if (c.histN < PV_CLK_HIST) c.histN++;
+  float s = 0;
+  if (c.histN >= 6 && pvClockRingSlope(c, s)){
+    c.drift = c.haveDrift ? c.drift + (s - c.drift) * 0.3f : s;
+    c.haveDrift = true;
+    if (c.drift >  PV_CLK_DRIFT_MAX) c.drift =  PV_CLK_DRIFT_MAX;
+    if (c.drift < -PV_CLK_DRIFT_MAX) c.drift = -PV_CLK_DRIFT_MAX;
+  }
+  // Anker: höchster Punkt der letzten Fenster, mit der Drift auf jetzt fortgeschrieben
+  // (nur die jüngsten: ein Driftfehler wächst mit dem Alter des Punkts; ohne Drift nur die letzten zwei)
+  int64_t off = o;
+  const uint8_t na = c.haveDrift ? PV_CLK_ANCHOR : 2;
+  for (uint8_t k = 1; k <= c.histN && k <= na; ++k){
+    uint8_t h = (uint8_t)((c.histAt + PV_CLK_HIST - k) % PV_CLK_HIST);
+    int64_t v = c.histOff[h] + (int64_t)(c.drift * (float)(int32_t)(rxMs - c.histMs[h]));
+    if (v > off) off = v;
+  }
+  c.offMs = off; c.refMs = rxMs;
+  return false;
+}
+
+// Poller-Zeit noch brauchbar? (sonst NTP)
+static inline bool pvClockFresh(const PvClock& c, uint32_t nowMs){
+  return c.valid && (uint32_t)(nowMs - c.lastMs) < PV_CLK_HOLD_MS;
+}
+
+// Systemuhr nachführen: vor der Schätzung -> stellen (nur vorwärts, Stempel sind Schranke),
+// wenig dahinter -> adjtime, weit dahinter -> stellen
+enum : uint8_t { PVCK_NONE = 0, PVCK_SLEW, PVCK_STEP };
+static inline uint8_t pvClockCorrection(int64_t estMs, int64_t sysMs, int32_t& deltaMs){
+  int64_t d = estMs - sysMs;
+  deltaMs = (int32_t)(d > 0x7FFFFFFF ? 0x7FFFFFFF : d < -0x7FFFFFFF ? -0x7FFFFFFF : d);
+  if (d > 0 || d < -PV_CLK_SLEW_MS) return PVCK_STEP;
+  if (d < -1) return PVCK_SLEW;
+  return PVCK_NONE;
+}
@@ -1,74 +1,30 @@
 #pragma once
-#include <Arduino.h>
-#include <TFT_eSPI.h>
+#ifdef ARDUINO
+  #include <Arduino.h>
+  #include <Preferences.h>
+  #ifndef PV_GFX_LGFX
+    #include <TFT_eSPI.h>  // LovyanGFX bindet der Sketch selbst ein (PV_GFX_LGFX)
+  #endif
+#endif
 #include <time.h>
+#include "PvGfx.h"     // Zeichen-Backend: Seiten als Templates, PvGfxOps je Bibliothek
+#include "PvTrace.h"
+#include "PvFrame.h"   // Frame v4, crc16_modbus, MCAST_PORT
+#include "PvEnergy.h"  // Festkomma-Energie, NVS-Record (Seite 6)
+#include "PvRollup.h"  // Verlauf Tag/Woche/Monat/Jahr (Seite 6)
+#include "PvCalendar.h" // Kalender-/Tarif-Cache, Tarifplan und Preise
+#include "PvStats.h"   // PvDevInfo (Seite Anlage)
+#include "PvPoll.h"    // PVD_* Geräte-Flags
+#include "PvBatt.h"    // ETA 20 %/voll/leer mit Konfidenz (Kopfzeile)
 
 // ------------------------- Anzeige-Konstanten -------------------------
 #define tagesAnzeige  1
 #define monatsAnzeige 2
-#define expPreis 0.138
-#define t1Preis 0.344
-#define t2Preis 0.2597
 
 // ================= Multicast (UDP) =================
+#ifdef ARDUINO
 static const IPAddress MCAST_GRP(239, 12, 12, 12);
-static const uint16_t  MCAST_PORT = 55221;
-
-// ================= CRC16 (Modbus) =================
-static inline uint16_t crc16_modbus(const uint8_t* data, size_t len) {
-  uint16_t crc = 0xFFFF;
-  for (size_t i = 0; i < len; i++) {
-    crc ^= data[i];
-    for (int j = 0; j < 8; j++) {
-      if (crc & 1) crc = (crc >> 1) ^ 0xA001;
-      else         crc >>= 1;
-    }
-  }
-  return crc;
-}
-
-// ------------------------- Frame V4 -------------------------
-#define PV_MAGIC   0xBEEF
-#define PV_VERSION 4
-
-typedef struct __attribute__((packed)) {
-  uint16_t magic;         // PV_MAGIC
-  uint8_t  version;       // PV_VERSION (=4)
-  uint32_t seq;           // laufende Nummer
-  uint32_t ts;            // UNIX time (s)
-
-  // Hauptwerte
-  int32_t  pvW;
-  int32_t  gridW;
-  int32_t  battW;
-  int32_t  loadW;
-
-  int16_t  temp10;        // 0.1°C
-  uint16_t socx10;        // 0.1%
-
-  float    pvTodayKWh;
-  float    gridExpToday;
-  float    gridImpToday;
-  float    loadTodayKWh;
-
-  int32_t  eta20s;        // Sekunden bis 20% (oder -1 wenn unbekannt)
-
-  // Zusatz (Skalen s. Namen)
-  int16_t  pv1Voltage_x10_V;
-  int16_t  pv1Current_x10_A;
-  int16_t  pv2Voltage_x10_V;
-  int16_t  pv2Current_x10_A;
-
-  int32_t  gridVoltageA_x10_V;
-  int32_t  gridVoltageB_x10_V;
-  int32_t  gridVoltageC_x10_V;
-
-  int32_t  gridCurrentA_x100_A;
-  int32_t  gridCurrentB_x100_A;
-  int32_t  gridCurrentC_x100_A;
-
-  uint16_t crc;           // CRC-16 (Modbus) über alles bis vor 'crc'
-} PvFrameV4;
+#endif
 
 // ------------------------- Layout (CYD 320x240 landscape) -------------------------
 static constexpr int W=320, H=240;
@@ -77,39 +33,76 @@ static constexpr int STATUS_H=32;
 static constexpr int headerLineY=STATUS_H+2;
 static constexpr int startY = headerLineY + 6;
 
+// ---- Band-Rendering (PvFlush.h): Zeilenbereich pvBandY0/pvBandY1 s. PvGfx.h ----
+// Direkt aufs Display: ein Durchgang über alles. Mit Bändern läuft jede Seite pro Band, zeichnet
+// aber nur die Teile, deren Zeilen das Band schneiden (pvBandVisible). Daten und Texte, die sich
+// zwischen zwei Bändern ändern könnten (Hooks, Uhrzeit, NVS), holt nur das erste Band (pvBandFirst).
+static inline bool pvBandFirst(){ return pvBandY0 == 0; }
+// Textzeile mit mittigem Datum (ML/MC/MR) bei yMid, Schrifthöhe h
+static inline bool pvBandLine(int yMid, int h){ return pvBandVisible(yMid - h/2, h); }
+// Ring-Ausschnitt a0..a1 (Grad wie PvGfx.h, y nach oben) um cy: Zeilen aus Endpunkten und
+// Scheiteln (90°/270°), großzügig mit rOuter und 1 px für Rundung/Glättung
+static inline bool pvBandArc(int cy, int rOuter, float a0, float a1){
+  float lo = a0 < a1 ? a0 : a1, hi = a0 < a1 ? a1 : a0;
+  const float k = 3.14159265358979323846f / 180.0f;
+  float sMax = fmaxf(sinf(lo * k), sinf(hi * k)), sMin = fminf(sinf(lo * k), sinf(hi * k));
+  for (int j = -2; j <= 2; ++j){
+    float up = 90.0f + 360.0f * j, dn = up - 180.0f;   // oberer / unterer Scheitel
+    if (up >= lo && up <= hi) sMax = 1.0f;
+    if (dn >= lo && dn <= hi) sMin = -1.0f;
+  }
+  int top = cy - (int)ceilf(rOuter * fmaxf(sMax, 0.0f)) - 1;
+  int bot = cy - (int)floorf(rOuter * fminf(sMin, 0.0f)) + 1;
+  return pvBandVisible(top, bot - top + 1);
+}
+
+// ---- Daten "alt" (Boot-Cache oder länger nichts empfangen, s. PvBoot.h) ----
+// Kopf grau, rechts der Datenstand statt ETA
+static bool pvStale = false;
+
 // ------------------------- Optionale Provider-Hooks (weak) -------------------------
 #if defined(__GNUC__)
 extern bool pvGetTodaySplits(float& t1_kWh, float& t2_kWh) __attribute__((weak));
 extern bool pvGetTodayExport(float& exp_kWh) __attribute__((weak));
 extern bool pvGetTodayPV(float& pv_kWh)      __attribute__((weak));
 extern bool pvGetTodayLoad(float& load_kWh)  __attribute__((weak));
+extern bool pvGetDevices(const PvDevInfo*& d, uint8_t& n) __attribute__((weak));
+extern bool pvGetBattEta(PvBattEta& e) __attribute__((weak));
 #else
 extern bool pvGetTodaySplits(float& t1_kWh, float& t2_kWh);
 extern bool pvGetTodayExport(float& exp_kWh);
 extern bool pvGetTodayPV(float& pv_kWh);
 extern bool pvGetTodayLoad(float& load_kWh);
+extern bool pvGetDevices(const PvDevInfo*& d, uint8_t& n);
+extern bool pvGetBattEta(PvBattEta& e);
 #endif
+// Hook vorhanden? Über einen Parameter geprüft: die Seiten-Templates werden erst nach den
+// Definitionen im Sketch instanziiert, ein direktes &hook wäre dort "nie NULL" (-Waddress)
+template<class F> static inline bool pvHook(F* f){ return f != nullptr; }
 
 // ================= Sichtbare Anzeige-Funktionen ===================
+// Alle Seiten sind Templates über das Zeichenziel G (Display, Band-Sprite, Host-Framebuffer),
+// s. PvGfx.h
 
 // Header
-static inline void drawStatusHeader(TFT_eSPI& tft, const PvFrameV4& f){
+template<class G>
+static inline void drawStatusHeader(G& tft, const PvFrameV4& f){
   // lokale Lambdas
-  auto nowHHMM = []() -> String {
-    time_t n; struct tm ti; time(&n); localtime_r(&n,&ti);
-    char b[6]; snprintf(b,sizeof(b),"%02d:%02d",ti.tm_hour,ti.tm_min);
+  auto fmtHHMM = [](time_t t)->String{
+    if (!pvTimeValid(t)) return "--:--";   // Uhr noch nicht gestellt
+    int hh, mm; pvCalWall(pvCalNow(), t, hh, mm);
+    char b[6]; snprintf(b,sizeof(b),"%02d:%02d",hh,mm);
     return String(b);
   };
-  auto fmtETA = [](int32_t s)->String{
+  auto nowHHMM = [&]() -> String { time_t n; time(&n); return fmtHHMM(n); };
+  auto fmtETA = [&](int32_t s)->String{
     if(s<=0) return "--:--";
-    time_t now; time(&now); time_t eta = now + s;
-    struct tm ti; localtime_r(&eta,&ti);
-    char b[6]; snprintf(b,sizeof(b),"%02d:%02d",ti.tm_hour,ti.tm_min);
-    return String(b);
+    time_t now; time(&now);
+    return pvTimeValid(now) ? fmtHHMM(now + s) : String("--:--");
   };
 
   bool ok20 = (f.socx10>=200);
-  uint16_t bg = ok20? TFT_DARKGREEN : TFT_MAROON;
+  uint16_t bg = pvStale ? 0x39E7 : ok20? TFT_DARKGREEN : TFT_MAROON;   // 0x39E7 = Dunkelgrau
   uint16_t fg = 0xA554; // MidGrey
 
   tft.fillRect(0,0,W,STATUS_H,bg);
@@ -128,16 +121,26 @@ static inline void drawStatusHeader(TFT_eSPI& tft, const PvFrameV4& f){
   tft.setTextDatum(MC_DATUM); tft.setTextFont(1); tft.setTextSize(2); tft.setTextColor(TFT_GREEN);
   tft.drawString(String(soc)+"%", iconX+iconW/2, iconY+iconH/2);
 
-  // ETA rechts
+  // ETA rechts: mit Schätzer (PvBatt.h) das nächste Ziel in Lade-/Entladerichtung, "~" bei
+  // wenig Konfidenz; ältere Poller: eta20s aus dem Frame; alte Daten: Zeitpunkt des Frames
   tft.setTextDatum(MR_DATUM); tft.setTextFont(1); tft.setTextSize(2); tft.setTextColor(fg,bg);
-  tft.drawString(String("ETA: ")+fmtETA(f.eta20s), W-PAD_X, STATUS_H/2);
+  PvBattEta be;
+  if (pvStale) tft.drawString(String("Stand ")+fmtHHMM(f.ts), W-PAD_X, STATUS_H/2);
+  else if (pvHook(pvGetBattEta) && pvGetBattEta(be) && be.dir != PVB_IDLE && be.conf >= PV_BATT_CONF_MIN){
+    const bool chg = be.dir == PVB_CHG, to20 = be.eta20s > 0 && (chg ? f.socx10 < PV_BATT_LOW_X10 : f.socx10 > PV_BATT_LOW_X10);
+    const char* what = to20 ? "20% " : chg ? "Voll " : "Leer ";
+    const int32_t s = to20 ? be.eta20s : chg ? be.fullS : be.emptyS;
+    tft.drawString(String(be.conf < PV_BATT_CONF_SURE ? "~" : "")+what+fmtETA(s), W-PAD_X, STATUS_H/2);
+  }
+  else tft.drawString(String("ETA: ")+fmtETA(f.eta20s), W-PAD_X, STATUS_H/2);
 
   // Linie
   tft.drawLine(PAD_X, headerLineY, W-PAD_X, headerLineY, TFT_DARKGREY);
 }
 
 // Seite 2 – String-Leistungen (PV1/PV2) als Balken + V/A-Anzeige
-static inline void drawPage2Content(TFT_eSPI& tft, const PvFrameV4& f){
+template<class G>
+static inline void drawPage2Content(G& tft, const PvFrameV4& f){
   // --- lokale Helfer ---
   auto drawHBar = [&](int x, int y, int w, int h, int32_t valueW, int32_t maxW, uint16_t colFill){
     if (maxW <= 0) maxW = 1;
@@ -177,92 +180,183 @@ static inline void drawPage2Content(TFT_eSPI& tft, const PvFrameV4& f){
   const int32_t MAX_W_STR  = 6000; // 6 kW für PV1/PV2
   const int32_t MAX_W_TOT  = 9000; // 9 kW für Gesamt
 
-  // Titel + Hinweis für String-Balken
-  tft.setTextDatum(ML_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
-  tft.drawString("PV-String Leistung", PAD_X, yTitle);
+  // Zeilen je Balkengruppe: Label (Font 2) über dem Balken bis Unterzeile V/A
+  tft.setTextFont(2); tft.setTextSize(1);
+  const int FONT2_H = tft.fontHeight();
+  auto groupVisible = [&](int y){
+    const int top = y - 4 - FONT2_H/2, bot = y + barHeight + 12 + FONT2_H/2;
+    return pvBandVisible(top, bot - top);
+  };
 
-  tft.setTextDatum(MR_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
-  tft.drawString("PV1/PV2 max 6.0 kW", W-PAD_X, yTitle);
+  // Titel + Hinweis für String-Balken
+  if (pvBandLine(yTitle, FONT2_H)) {
+    tft.setTextDatum(ML_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.drawString("PV-String Leistung", PAD_X, yTitle);
+
+    tft.setTextDatum(MR_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+    tft.drawString("PV1/PV2 max 6.0 kW", W-PAD_X, yTitle);
+  }
 
   // ---- PV1 ----
-  drawHBar(barMarginX, y1, barWidth, barHeight, pv1W, MAX_W_STR, TFT_YELLOW);
-  // Label links
-  tft.setTextDatum(ML_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
-  tft.drawString("PV1", barMarginX, y1 - 4);
-  // Wert rechts
-  tft.setTextDatum(MR_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
-  tft.drawString(fmtWatt(pv1W), barMarginX + barWidth, y1 + barHeight/2);
-  // Unterzeile V/A
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_CYAN, TFT_BLACK);
-  tft.drawString(String(pv1V,1)+" V  ·  "+String(pv1A,2)+" A", barMarginX + barWidth, y1 + barHeight + 12);
+  if (groupVisible(y1)) {
+    drawHBar(barMarginX, y1, barWidth, barHeight, pv1W, MAX_W_STR, TFT_YELLOW);
+    // Label links
+    tft.setTextDatum(ML_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+    tft.drawString("PV1", barMarginX, y1 - 4);
+    // Wert rechts
+    tft.setTextDatum(MR_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.drawString(fmtWatt(pv1W), barMarginX + barWidth, y1 + barHeight/2);
+    // Unterzeile V/A
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_CYAN, TFT_BLACK);
+    tft.drawString(String(pv1V,1)+" V  ·  "+String(pv1A,2)+" A", barMarginX + barWidth, y1 + barHeight + 12);
+  }
 
   // ---- PV2 ----
-  drawHBar(barMarginX, y2, barWidth, barHeight, pv2W, MAX_W_STR, TFT_CYAN);
-  // Label links
-  tft.setTextDatum(ML_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
-  tft.drawString("PV2", barMarginX, y2 - 4);
-  // Wert rechts
-  tft.setTextDatum(MR_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
-  tft.drawString(fmtWatt(pv2W), barMarginX + barWidth, y2 + barHeight/2);
-  // Unterzeile V/A
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_CYAN, TFT_BLACK);
-  tft.drawString(String(pv2V,1)+" V  ·  "+String(pv2A,2)+" A", barMarginX + barWidth, y2 + barHeight + 12);
+  if (groupVisible(y2)) {
+    drawHBar(barMarginX, y2, barWidth, barHeight, pv2W, MAX_W_STR, TFT_CYAN);
+    // Label links
+    tft.setTextDatum(ML_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+    tft.drawString("PV2", barMarginX, y2 - 4);
+    // Wert rechts
+    tft.setTextDatum(MR_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.drawString(fmtWatt(pv2W), barMarginX + barWidth, y2 + barHeight/2);
+    // Unterzeile V/A
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_CYAN, TFT_BLACK);
+    tft.drawString(String(pv2V,1)+" V  ·  "+String(pv2A,2)+" A", barMarginX + barWidth, y2 + barHeight + 12);
+  }
 
   // ---- Gesamt (Reg 32064) ----
-  drawHBar(barMarginX, y3, barWidth, barHeight, pvTotalW, MAX_W_TOT, TFT_ORANGE);
-  // Label links
-  tft.setTextDatum(ML_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
-  tft.drawString("Total", barMarginX, y3 - 4);
-  // Wert rechts
-  tft.setTextDatum(MR_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
-  tft.drawString(fmtWatt(pvTotalW), barMarginX + barWidth, y3 + barHeight/2);
-  // kleine Skalen-Notiz für Total rechts oben vom Balken
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
-  tft.drawString("max 9.0 kW", barMarginX + barWidth, y3 - 4);
+  if (groupVisible(y3)) {
+    drawHBar(barMarginX, y3, barWidth, barHeight, pvTotalW, MAX_W_TOT, TFT_ORANGE);
+    // Label links
+    tft.setTextDatum(ML_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+    tft.drawString("Total", barMarginX, y3 - 4);
+    // Wert rechts
+    tft.setTextDatum(MR_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.drawString(fmtWatt(pvTotalW), barMarginX + barWidth, y3 + barHeight/2);
+    // kleine Skalen-Notiz für Total rechts oben vom Balken
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+    tft.drawString("max 9.0 kW", barMarginX + barWidth, y3 - 4);
+  }
+}
+
+// Seite Anlage – je Wechselrichter/Unit: PV, Batterie, Temperatur, Ertrag, Abfragezeit
+template<class G>
+static inline void drawPageDevicesContent(G& tft, const PvFrameV4& f){
+  auto fmtWatt = [](int32_t w)->String{
+    return (abs(w)>=1000) ? String(w/1000.0,2)+" kW" : String(w)+" W";
+  };
+  // Kopie im ersten Band: der UDP-Task kann die Geräte zwischen zwei Bändern aktualisieren
+  static PvDevInfo d[PV_MAX_DEVICES];
+  static uint8_t n = 0;
+  static bool have = false;
+  if (pvBandFirst()) {
+    const PvDevInfo* src = nullptr; n = 0;
+    have = pvHook(pvGetDevices) && pvGetDevices(src, n);
+    if (n > PV_MAX_DEVICES) n = PV_MAX_DEVICES;
+    if (have) memcpy(d, src, n * sizeof(PvDevInfo));
+  }
+
+  tft.setTextFont(2); tft.setTextSize(1);
+  const int FONT2_H = tft.fontHeight();
+  const int yTitle = startY + 10;
+  if (pvBandLine(yTitle, FONT2_H)) {
+    tft.setTextDatum(ML_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.drawString("Anlage: " + String(have ? n : 0) + (n==1 ? " Gerät" : " Geräte"), PAD_X, yTitle);
+    tft.setTextDatum(MR_DATUM);
+    tft.setTextColor(TFT_ORANGE, TFT_BLACK);
+    tft.drawString("PV " + fmtWatt(f.pvW), W-PAD_X, yTitle);
+  }
+
+  if (!have){
+    const int yMid = headerLineY + (H - headerLineY)/2;
+    if (!pvBandLine(yMid, FONT2_H)) return;
+    tft.setTextDatum(MC_DATUM); tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+    tft.drawString("keine Gerätedaten", W/2, yMid);
+    return;
+  }
+
+  const int rowH = 46;
+  for (uint8_t i = 0; i < n; ++i){
+    const int y = yTitle + 16 + i*rowH;
+    if (!pvBandVisible(y, rowH)) continue;
+    const PvDevInfo& v = d[i];
+    uint16_t col = v.state==PVDEV_OK ? TFT_GREEN : v.state==PVDEV_OLD ? TFT_ORANGE : TFT_RED;
+    tft.fillCircle(PAD_X+5, y+10, 5, col);
+
+    char name[sizeof(v.name)+1]; memcpy(name, v.name, sizeof(v.name)); name[sizeof(v.name)] = 0;
+    tft.setTextDatum(ML_DATUM); tft.setTextFont(2); tft.setTextSize(1);
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.drawString(String(name) + " #" + String(v.unit), PAD_X+16, y+10);
+    tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+    tft.drawString(v.state==PVDEV_NONE ? String("--") : fmtWatt(v.pvW), 120, y+10);
+    tft.setTextDatum(MR_DATUM); tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.drawString(String(v.genTodayWh/1000.0f,1) + " / " + String(v.genMonthWh/1000.0f,0) + " kWh", W-PAD_X, y+10);
+
+    String sub;
+    if (v.flags & PVD_BATT) sub += "Batt " + fmtWatt(v.battW) + " " + String(v.socx10/10.0f,0) + "%  ";
+    sub += String(v.temp10/10.0f,1) + " C  ";
+    sub += (v.state==PVDEV_OLD) ? "vor " + String(v.ageS) + " s" : "Abfrage " + String(v.cycleMs) + " ms";
+    tft.setTextDatum(ML_DATUM); tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+    tft.drawString(sub, PAD_X+16, y+28);
+  }
 }
 
 // Seite 3 – Uhrzeit + Datum
-static inline void drawPage3Content(TFT_eSPI& tft, const PvFrameV4&){
+template<class G>
+static inline void drawPage3Content(G& tft, const PvFrameV4&){
   // lokale Lambdas
   auto nowHHMM = []() -> String {
-    time_t n; struct tm ti; time(&n); localtime_r(&n,&ti);
-    char b[6]; snprintf(b,sizeof(b),"%02d:%02d",ti.tm_hour,ti.tm_min);
+    time_t n; time(&n); int hh, mm; pvCalWall(pvCalNow(), n, hh, mm);
+    char b[6]; snprintf(b,sizeof(b),"%02d:%02d",hh,mm);
     return String(b);
   };
   auto fmtDateDDMMYYYY = []() -> String {
-    time_t n; struct tm ti; time(&n); localtime_r(&n,&ti);
+    const PvCalendar c = pvCalNow();
     static const char* wd[7] = {"So","Mo","Di","Mi","Do","Fr","Sa"};
     char b[24];
     snprintf(b, sizeof(b), "%s %02d.%02d.%04d",
-            wd[ti.tm_wday], ti.tm_mday, ti.tm_mon+1, ti.tm_year+1900);
+            wd[c.wday], c.d, c.m, c.y);
     return String(b);
   };
 
+  // im ersten Band festhalten: sonst zeigen die Bänder beim Minutenwechsel zwei Uhrzeiten
+  static String hhmm, date;
+  if (pvBandFirst()) { hhmm = nowHHMM(); date = fmtDateDDMMYYYY(); }
+
+  const int yTime = headerLineY + (H - headerLineY)/2 - 16;
+  const int yDate = headerLineY + (H - headerLineY)/2 + 16;
   tft.setTextDatum(MC_DATUM);
 
   // Zeit groß
   tft.setTextFont(4);
   tft.setTextSize(2);
-  tft.setTextColor(TFT_WHITE, TFT_BLACK);
-  tft.drawString(nowHHMM(), W/2, headerLineY + (H - headerLineY)/2 - 16);
+  if (pvBandLine(yTime, tft.fontHeight())) {
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.drawString(hhmm, W/2, yTime);
+  }
 
   // Datum darunter
   tft.setTextFont(2);
   tft.setTextSize(1);
-  tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
-  tft.drawString(fmtDateDDMMYYYY(), W/2, headerLineY + (H - headerLineY)/2 + 16);
+  if (pvBandLine(yDate, tft.fontHeight())) {
+    tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+    tft.drawString(date, W/2, yDate);
+  }
 }
 
 // Seite 5 – Drei Zeiger-Gauges: PV (Reg 32064), Batterie (±), Grid (±)
-static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
+template<class G>
+static void drawPage5Content(G& tft, const PvFrameV4& f){
   // ---------- Geometrie ----------
   const int gaugesY = 42;               // Oberkante der 3 Meter
   const int gW = 100, gH = 160;         // Größe pro Meter
@@ -275,14 +369,24 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
   const float battW = (float)f.battW; // +C/-D
   const float gridW = (float)f.gridW; // +Export/-Import (laut Kommentar)
   const float loadW = (float)((int32_t)f.pvW - (int32_t)f.gridW - (int32_t)f.battW);
-  float pvToday = f.pvTodayKWh;        // Fallback, falls Hook nicht da
   const float tempC   = (f.temp10 != INT16_MIN) ? (f.temp10 / 10.0f) : NAN;
 
-  // integrierte Last (heute) via Hook (Fallback: "--")
-  float loadToday = NAN;
-  if (&pvGetTodayLoad) { float v; if (pvGetTodayLoad(v)) loadToday = v; }
-  // integrierte PV (heute) via Hook (Fallback: Frame)
-  if (&pvGetTodayPV) { float v; if (pvGetTodayPV(v)) pvToday = v; }
+  // Tageswerte der Hooks nur im ersten Band holen (loop()/UDP-Task zählen weiter,
+  // die Bänder eines Frames sollen dieselben Zahlen zeigen)
+  static float pvToday, loadToday, t1, t2, expK;
+  if (pvBandFirst()) {
+    pvToday = f.pvTodayKWh;            // Fallback, falls Hook nicht da
+    // integrierte Last (heute) via Hook (Fallback: "--")
+    loadToday = NAN;
+    if (pvHook(pvGetTodayLoad)) { float v; if (pvGetTodayLoad(v)) loadToday = v; }
+    // integrierte PV (heute) via Hook (Fallback: Frame)
+    if (pvHook(pvGetTodayPV)) { float v; if (pvGetTodayPV(v)) pvToday = v; }
+    // Grid: T1, T2, Export
+    t1 = -1.f; t2 = -1.f; expK = -1.f;
+    if (pvHook(pvGetTodaySplits)){ float a,b; if (pvGetTodaySplits(a,b)) { t1=a; t2=b; } }
+    if (pvHook(pvGetTodayExport)){ float e;   if (pvGetTodayExport(e))   { expK=e; } }
+    if (expK<0.f) expK = f.gridExpToday; // Fallback: Export-Tag aus Frame
+  }
 
   // ---------- Ranges für Gauges ----------
   const float pvMin=0,      pvMax=9000;   // PV 0..9 kW
@@ -343,11 +447,11 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
     if (h < 80) h = 80;
     if (vMax == vMin) vMax = vMin + 1.0f;
 
-    // Sprite pro Gauge – simpel & flackerfrei (wird jedes Mal erstellt)
-    TFT_eSprite spr(&tft);
-    spr.setColorDepth(16);
-    spr.createSprite(w, h);
-    spr.fillSprite(TFT_BLACK);
+    // Direkt ins Ziel (Band-Puffer bzw. Display) in Bildschirmkoordinaten;
+    // flackerfrei, weil die Bänder erst fertig gezeichnet zum Display gehen
+    if (!pvBandVisible(y, h)) return;
+    G& spr = tft;
+    spr.fillRect(x, y, w, h, TFT_BLACK);
 
     // Farben
     const uint16_t COL_GRAY     = TFT_DARKGREY;
@@ -362,8 +466,8 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
 
     // Geometrie
     const int pad = 4;
-    const int cx = w / 2;
-    const int cy = (int)(h * 0.44f);            // etwas höher -> unten mehr Platz
+    const int cx = x + w / 2;
+    const int cy = y + (int)(h * 0.44f);        // etwas höher -> unten mehr Platz
     int rOuter = (min(w, h) / 2) - pad; if (rOuter < 22) rOuter = 22;
     const int arcThick  = max(8, min(14, h / 12));
     const int rTickBase = rOuter;
@@ -374,34 +478,11 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
     const float aMax  = -45.0f;  // vMax
     const float aZero = 90.0f;   // 12 Uhr
 
-    // dicker Bogen (unten offen)
+    // dicker Bogen (unten offen); schnellste Variante je Bibliothek über PvGfxOps (PvGfx.h)
     auto sprDrawThickArc = [&](float aStartDeg, float aEndDeg, uint16_t color){
-      int thickness = arcThick;
-      int rInner = rOuter - thickness; if (rInner < 1) rInner = 1;
-      const float step = 3.0f;
-      const int dir = (aEndDeg < aStartDeg) ? -1 : +1;
-      float a = aStartDeg;
-      while (true) {
-        float aNext = a + dir * step;
-        bool last = (dir < 0) ? (aNext <= aEndDeg) : (aNext >= aEndDeg);
-        if (last) aNext = aEndDeg;
-
-        float r0 = deg2rad(a), r1 = deg2rad(aNext);
-        int x0o = (int)(cx + cosf(r0) * rOuter);
-        int y0o = (int)(cy - sinf(r0) * rOuter);
-        int x1o = (int)(cx + cosf(r1) * rOuter);
-        int y1o = (int)(cy - sinf(r1) * rOuter);
-        int x0i = (int)(cx + cosf(r0) * (rOuter - thickness));
-        int y0i = (int)(cy - sinf(r0) * (rOuter - thickness));
-        int x1i = (int)(cx + cosf(r1) * (rOuter - thickness));
-        int y1i = (int)(cy - sinf(r1) * (rOuter - thickness));
-
-        spr.fillTriangle(x0o, y0o, x1o, y1o, x0i, y0i, color);
-        spr.fillTriangle(x1o, y1o, x1i, y1i, x0i, y0i, color);
-
-        if (last) break;
-        a = aNext;
-      }
+      if (!pvBandArc(cy, rOuter, aStartDeg, aEndDeg)) return;
+      int rInner = rOuter - arcThick; if (rInner < 1) rInner = 1;
+      pvFillArc(spr, cx, cy, rInner, rOuter, aStartDeg, aEndDeg, color);
     };
     auto sprTick = [&](float angDeg, int len, uint16_t col){
       float r = deg2rad(angDeg);
@@ -409,6 +490,7 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
       int y0 = (int)(cy - sinf(r) * (rTickBase - len));
       int x1 = (int)(cx + cosf(r) * rTickBase);
       int y1 = (int)(cy - sinf(r) * rTickBase);
+      if (!pvBandVisible(min(y0, y1), abs(y1 - y0) + 1)) return;
       spr.drawLine(x0, y0, x1, y1, col);
     };
 
@@ -451,8 +533,10 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
     spr.setTextDatum(TC_DATUM);
     spr.setTextColor(COL_LABEL);
     int fh = spr.fontHeight();
-    spr.fillRect(0, 0, w, fh + 2, TFT_BLACK);
-    spr.drawString(String(name), cx, 1);
+    if (pvBandVisible(y, fh + 2)) {
+      spr.fillRect(x, y, w, fh + 2, TFT_BLACK);
+      spr.drawString(String(name), cx, y + 1);
+    }
 
     // Wert groß, ~50 px über Unterkante
     auto formatWithK = [](float v)->String{
@@ -473,7 +557,6 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
         return s;
       }
     };
-    String vStr = formatWithK(value);
     spr.setTextFont(4);
     spr.setTextSize(1);
     spr.setTextDatum(MC_DATUM);
@@ -481,7 +564,7 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
     const int valueYOffset = 50;
     int yVal = h - valueYOffset;
     if (yVal < fh + 16) yVal = fh + 16;
-    spr.drawString(vStr, cx, yVal);
+    if (pvBandLine(y + yVal, spr.fontHeight())) spr.drawString(formatWithK(value), cx, y + yVal);
 
     // Zeigerwinkel
     if (value < vMin) value = vMin;
@@ -518,11 +601,10 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
     int xB2 = (int)(xBaseC - cosf(apr) * halfW);
     int yB2 = (int)(yBaseC + sinf(apr) * halfW);
 
-    spr.fillTriangle(xTip, yTip, xB1, yB1, xB2, yB2, COL_NEEDLE);
-    spr.fillCircle(cx, cy, max(arcThick / 3, 5), COL_HUB);
-
-    spr.pushSprite(x, y);
-    spr.deleteSprite();
+    const int nTop = min(yTip, min(yB1, yB2)), nBot = max(yTip, max(yB1, yB2));
+    if (pvBandVisible(nTop, nBot - nTop + 1)) spr.fillTriangle(xTip, yTip, xB1, yB1, xB2, yB2, COL_NEEDLE);
+    const int rHub = max(arcThick / 3, 5);
+    if (pvBandVisible(cy - rHub, 2 * rHub + 1)) spr.fillCircle(cx, cy, rHub, COL_HUB);
   };
 
   // ---------- 3 Meter ----------
@@ -534,6 +616,10 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
   drawGauge(xGRID, gaugesY, gW, gH, gridW, gridMin, gridMax,"Grid", /*bipolar=*/true,  GRID_DB, /*positiveIsGreen=*/true);
 
   // ---------- Untertexte ----------
+  // drei Zeilen Font 2 ab gaugesY + gH - 28 (Zeilenabstand 14, letzte mit MC-Datum +10)
+  const int subY = gaugesY + gH + 2 - 30;
+  if (!pvBandVisible(subY, 2*14 + 18)) return;
+
   // PV heute (integriert) – zentriert unter dem PV-Zeiger
   drawCentered(xPV + gW/2, gaugesY + gH + 2 - 30, fmtKWh(pvToday), TFT_YELLOW);
 
@@ -544,12 +630,7 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
   drawCentered(xBATT + gW/2, gaugesY + gH, fmtKWh(loadToday), TFT_CYAN);
 
   // Grid: T1 (rot), T2 (blau), Export (grün)
-  float t1=-1.f, t2=-1.f, expK=-1.f;
-  if (&pvGetTodaySplits){ float a,b; if (pvGetTodaySplits(a,b)) { t1=a; t2=b; } }
-  if (&pvGetTodayExport){ float e;   if (pvGetTodayExport(e))   { expK=e; } }
-  if (expK<0.f) expK = f.gridExpToday; // Fallback: Export-Tag aus Frame
-
-  int gy = gaugesY + gH + 2 - 30;
+  int gy = subY;
   tft.setTextDatum(TL_DATUM);
   tft.setTextFont(2); tft.setTextSize(1);
 
@@ -571,7 +652,8 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
   // PV: Tages-Verlust/Gewinn in CHF (Gewinn = negativ) – zentriert, gleiche Linie wie Load Σ & Exp
   bool chfValid = (t1>=0.f && t2>=0.f && !isnan(expK));
   if (chfValid){
-    float chf = t1*t1Preis + t2*t2Preis - expK*expPreis; // Gewinn < 0
+    const PvPrices pr = pvCalNow().price;                  // Preise gültig für heute
+    float chf = t1*pr.t1 + t2*pr.t2 - expK*pr.exp;          // Gewinn < 0
     uint16_t col = (chf < 0.f) ? TFT_GREEN : TFT_RED;
     drawCentered(xPV + gW/2, gaugesY + gH, fmtCHF(chf), col);
   } else {
@@ -580,43 +662,50 @@ static void drawPage5Content(TFT_eSPI& tft, const PvFrameV4& f){
 }
 
 // ------------------- Seite 6 --------------------------------------------------------------
-// === Seite 6: 30-Tage- oder Monats-Balken (Export oben grün; Bezug unten T1 rot + T2 blau) ===
-// NVS: Namespace "pvstats", Keys je Tag: DYYYYMMDD  (DayAgg-Blob)
-//      bzw. je Monat: MYYYYMM    (DayAgg-Blob als Monatsaggregation)
-static void drawPage6Content(TFT_eSPI& tft, const PvFrameV4& , int kind) {
-  #include <Preferences.h>
-  #include <time.h>
-
-  auto ymdFromTime = [](time_t tt)->uint32_t {
-    struct tm tmv; localtime_r(&tt, &tmv);
-    return (uint32_t)((tmv.tm_year+1900)*10000 + (tmv.tm_mon+1)*100 + tmv.tm_mday);
-  };
-  auto prevDay = [](time_t tt)->time_t { return tt - 86400; };
-
-  struct DayAgg { // Tageswerte
-    float gen_kWh;
-    float load_kWh;
-    float impT1_kWh;
-    float impT2_kWh;
-    float exp_kWh;
-  };
-
-  auto decMonth = [&](int &y, int &m){
-    m--; if (m < 1) { m = 12; y--; }
-  };
-
-  auto keyDay = [](int y,int m,int d)->String {
-    char b[16];
-    snprintf(b,sizeof(b),"D%04d%02d%02d", y,m,d);
-    return String(b);
-  };
+// === Seite 6: Verlauf als Balken (Export oben grün; Bezug unten T1 rot + T2 blau) ===
+// Stufen aus PvRollup.h: 30 Tage, 26 Wochen, 12 Monate oder 10 Jahre; gelesen wird nur die
+// gezeigte Stufe. Seite 3 beginnt bei Tagen, Seite 4 bei Monaten; Zoom/Verschieben je Seite
+// mit pvChartZoom()/pvChartPan() (Gesten im Sketch).
+// NVS: Namespace "pvstats", Keys DJJJJMMTT / WJJJJWW / MJJJJMM / YJJJJ, Blob = PvEnergyRec + Spitzen (v3), v2
+//      oder alter float-Blob (v1), s. PvEnergy.h
+struct PvChartView {
+  uint8_t lvl;        // PVL_*
+  int32_t endDay;     // letzter sichtbarer Tag (pvDayNum), 0 = bis heute
+};
+static PvChartView pvChartViews[2] = { { PVL_DAY, 0 }, { PVL_MONTH, 0 } };
+static const uint8_t PV_CHART_BARS[PVL_COUNT] = { 30, 26, 12, 10 };
+#define PV_CHART_MAX 30
+
+static inline PvChartView* pvChartFor(int page){
+  return page == 3 ? &pvChartViews[0] : page == 4 ? &pvChartViews[1] : nullptr;
+}
+static inline int32_t pvChartToday(){ const PvCalendar c = pvCalNow(); return pvDayNum(c.y, c.m, c.d); }
+
+// dir > 0: gröbere Stufe (Tage -> Wochen -> Monate -> Jahre), < 0: feinere; der letzte Tag bleibt
+static inline bool pvChartZoom(int page, int dir){
+  PvChartView* v = pvChartFor(page);
+  if (!v) return false;
+  int l = v->lvl + (dir > 0 ? 1 : -1);
+  if (l < PVL_DAY || l >= PVL_COUNT) return false;
+  v->lvl = (uint8_t)l;
+  return true;
+}
 
-  auto keyMon =  [](int y,int m)->String { 
-    char b[16]; 
-    snprintf(b,sizeof(b),"M%04d%02d",y,m); 
-    return String(b); 
-  };
+// dir < 0: halben Ausschnitt älter, > 0: neuer (höchstens bis heute), 0: zurück auf heute
+static inline bool pvChartPan(int page, int dir){
+  PvChartView* v = pvChartFor(page);
+  if (!v || (dir >= 0 && !v->endDay)) return false;
+  if (dir == 0){ v->endDay = 0; return true; }
+  const int32_t today = pvChartToday();
+  const uint32_t id = pvRollupStep(v->lvl, pvRollupId(v->lvl, v->endDay ? v->endDay : today),
+                                   (dir < 0 ? -1 : 1) * (PV_CHART_BARS[v->lvl] / 2));
+  const int32_t end = pvRollupStart(v->lvl, pvRollupStep(v->lvl, id, 1)) - 1;   // letzter Tag der Periode
+  v->endDay = end >= today ? 0 : end;
+  return true;
+}
 
+template<class G>
+static void drawPage6Content(G& tft, const PvFrameV4& , int kind) {
   // ---- Geometrie / Layout ----
   const int W = 320, H = 240;
   const int PAD_X = 6;
@@ -633,93 +722,78 @@ static void drawPage6Content(TFT_eSPI& tft, const PvFrameV4& , int kind) {
   tft.fillRect(0, top, W, bottom - top, TFT_BLACK);
   tft.drawRect(left-1, top-1, plotW+2, plotH+2, TFT_DARKGREY);
 
-  // ---- Datencontainer ----
-  float t1v[30], t2v[30], expv[30];
-  for (int i=0;i<30;++i){ t1v[i]=t2v[i]=expv[i]=0.f; }
-  int n = 0;
-  int idxToday = -1;
-  float kosten;
-
-  // ---- NVS lesen: 30 Tage bzw. 12 Monate rückwärts, dann alt->neu sortieren ----
-  bool have = false;
-  {
+  // ---- Datencontainer (static: beim Band-Rendering nur im ersten Band aus NVS laden) ----
+  static float t1v[PV_CHART_MAX], t2v[PV_CHART_MAX], expv[PV_CHART_MAX];
+  static int n = 0;
+  static int idxToday = -1;
+  static float kosten;
+  static bool have = false;
+  static char label[16];
+  static bool panned = false;
+
+  // ---- NVS lesen: n Perioden der gezeigten Stufe, alt -> neu ----
+  if (pvBandFirst()) {
+    const PvChartView& v = pvChartViews[kind==monatsAnzeige ? 1 : 0];
+    const uint8_t lvl = v.lvl;
+    const int32_t today = pvChartToday();
+    const uint32_t lastId = pvRollupId(lvl, v.endDay ? v.endDay : today);
+    PvEnergy e[PV_CHART_MAX]; uint32_t ids[PV_CHART_MAX] = {};
+    n = PV_CHART_BARS[lvl]; idxToday = -1; have = false; kosten = 0; panned = v.endDay != 0;
     Preferences prefs;
     if (prefs.begin("pvstats", true)) {
-      struct DayRec { float t1,t2,exp; bool ok; } tmp[30];
-      for (int i=0;i<30;++i){ tmp[i]={0,0,0,false}; }
-
-      time_t nowT; time(&nowT);
-      time_t cur = nowT;
-      int got = 0;
-      // --- Zeit / aktueller Monat ---
-      time_t nowTs; time(&nowTs);
-      struct tm lt; localtime_r(&nowTs, &lt);
-      int cy = lt.tm_year + 1900;
-      int cm = lt.tm_mon + 1;              // 1..12
-
-      for (int i=0;i<30; ++i) {
-        uint32_t ymd = ymdFromTime(cur);
-        int y = ymd / 10000;
-        int m = (ymd / 100) % 100;
-        int d = ymd % 100;
-        
-        String key;
-        // === Schlüssel wie beim Schreiben verwenden ===
-        if (kind==tagesAnzeige) key = keyDay(y, m, d);   // gleicher Key wie in saveDayToNVS()
-        if (kind==monatsAnzeige) key = keyMon(cy, cm);   // gleicher Key wie in saveMonToNVS()
-
-        DayAgg a{}; 
-        bool ok = false;
-        // ganzen DayAgg-Blob lesen und Felder übernehmen
-        if (prefs.getBytesLength(key.c_str()) == sizeof(DayAgg) &&
-            prefs.getBytes(key.c_str(), &a, sizeof(DayAgg)) == sizeof(DayAgg)) {
-          tmp[i].t1  = a.impT1_kWh;
-          tmp[i].t2  = a.impT2_kWh;
-          tmp[i].exp = a.exp_kWh;
-          ok = true;
-        }
-        tmp[i].ok = ok;
-        ++got; // gezählt, auch wenn nicht ok (Platzhalter)
-
-        if (kind==tagesAnzeige) cur = prevDay(cur);
-        if (kind==monatsAnzeige) decMonth(cy,cm);
+      PvRollupPrefs<Preferences> st{prefs};
+      have = pvRollupRange(st, lvl, lastId, (uint16_t)n, e, ids) > 0;
+      // laufende Periode: heutigen Tagesrecord (fehlt meist, nach Sync Stand des Pollers)
+      // herausrechnen, die Live-Werte kommen unten dazu
+      if (ids[n-1] == pvRollupId(lvl, today)) {
+        idxToday = n-1; have = true;
+        PvEnergy td; char key[12];
+        pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, today), key, sizeof(key));
+        if (st.load(key, td)) for (uint8_t c=0;c<PVE_COUNT;++c) e[n-1].e[c] -= td.e[c];
       }
       prefs.end();
-
-      if (got>0) {
-        int k=0;
-        int ruz;
-        if (kind==tagesAnzeige) ruz = 29;
-        if (kind==monatsAnzeige) ruz = 11;
-        kosten = 0;
-        for (int i=ruz;i>=0;--i) {
-          if(true) {
-            t1v[k]=tmp[i].t1; t2v[k]=tmp[i].t2; expv[k]=tmp[i].exp; 
-            kosten = kosten + t1v[k]*t1Preis + t2v[k]*t2Preis - expv[k]*expPreis;
-            ++k;
-          }
-        }
-        n = k;
-        if (n>0) { if (n>30) n=30; idxToday = n-1; have = true; }
+    }
+    for (int i=0;i<n;++i) {
+      t1v[i]=pvKWh(e[i].e[PVE_IMP_T1]); t2v[i]=pvKWh(e[i].e[PVE_IMP_T2]); expv[i]=pvKWh(e[i].e[PVE_EXP]);
+      if (i == idxToday) {
+        float a, b;
+        if (pvHook(pvGetTodaySplits) && pvGetTodaySplits(a, b)) { t1v[i] += a; t2v[i] += b; }
+        if (pvHook(pvGetTodayExport) && pvGetTodayExport(a)) expv[i] += a;
       }
+      // Preis am ersten Tag der Periode (ändert er sich mittendrin, ist die Summe genähert)
+      const PvPrices& pr = pvPricesFor(pvRollupId(PVL_DAY, pvRollupStart(lvl, ids[i])));
+      kosten = kosten + t1v[i]*pr.t1 + t2v[i]*pr.t2 - expv[i]*pr.exp;
+    }
+    // letzte Periode als Beschriftung
+    const uint32_t id = ids[n-1];
+    switch (lvl) {
+      case PVL_DAY:   snprintf(label, sizeof(label), "bis %02u.%02u.", (unsigned)(id%100), (unsigned)(id/100%100)); break;
+      case PVL_WEEK:  snprintf(label, sizeof(label), "bis KW%02u", (unsigned)(id%100)); break;
+      case PVL_MONTH: snprintf(label, sizeof(label), "bis %02u/%02u", (unsigned)(id%100), (unsigned)(id/100%100)); break;
+      default:        snprintf(label, sizeof(label), "bis %04u", (unsigned)id); break;
     }
   }
-  if (kind==tagesAnzeige) n=30;
-  if (kind==monatsAnzeige) n=12; 
+
+  // Legende unter dem Plot (Font 2, TL-Datum)
+  const int legY = bottom + 6;
+  tft.setTextFont(2); tft.setTextSize(1);
+  const bool legVisible = pvBandVisible(legY, tft.fontHeight());
 
   if (!have || n<=0) {
     // Platzhalter
     tft.setTextDatum(MC_DATUM);
     tft.setTextFont(2); tft.setTextSize(1);
     tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
-    tft.drawString("Keine 30-Tage-Historie vorhanden", W/2, (top+bottom)/2);
+    if (pvBandLine((top+bottom)/2, tft.fontHeight())) tft.drawString("Keine Historie vorhanden", W/2, (top+bottom)/2);
 
-    int legY = bottom + 6;
+    if (!legVisible) return;
     tft.setTextDatum(TL_DATUM);
     tft.setTextFont(2); tft.setTextSize(1);
     tft.setTextColor(TFT_RED,   TFT_BLACK); tft.drawString("T1",  left,      legY);
     tft.setTextColor(TFT_BLUE,  TFT_BLACK); tft.drawString("T2",  left+34,   legY);
     tft.setTextColor(TFT_GREEN, TFT_BLACK); tft.drawString("Exp", left+68,   legY);
+    tft.setTextDatum(TR_DATUM);
+    tft.setTextColor(panned ? TFT_CYAN : TFT_LIGHTGREY, TFT_BLACK); tft.drawString(label, right, legY);
     return;
   }
 
@@ -808,50 +882,79 @@ static void drawPage6Content(TFT_eSPI& tft, const PvFrameV4& , int kind) {
 
   // ---- Y-Labels (größer) ----
   tft.setTextDatum(MR_DATUM);
-  tft.setTextFont(2); tft.setTextSize(2);                 // größer als zuvor
+  tft.setTextFont(1); tft.setTextSize(2);                 // Font 1 in doppelter Größe
   tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
-  { char b[20]; dtostrf(maxExp,0,(maxExp<10.f?1:0),b); tft.drawString(String(b), left-AXIS_W/2 +15, top,    1); }
-  tft.drawString("kWh", left-AXIS_W/2+15, zeroY, 1);
-  { char b[20]; dtostrf(maxImp,0,(maxImp<10.f?1:0),b); tft.drawString(String(b), left-AXIS_W/2 +15, bottom, 1); }
+  const int fhY = tft.fontHeight();
+  if (pvBandLine(top, fhY)) { char b[20]; dtostrf(maxExp,0,(maxExp<10.f?1:0),b); tft.drawString(String(b), left-AXIS_W/2 +15, top); }
+  if (pvBandLine(zeroY, fhY)) tft.drawString("kWh", left-AXIS_W/2+15, zeroY);
+  if (pvBandLine(bottom, fhY)) { char b[20]; dtostrf(maxImp,0,(maxImp<10.f?1:0),b); tft.drawString(String(b), left-AXIS_W/2 +15, bottom); }
 
   // ---- X-Marks alle 5 Balken ----
-  for (int i=0, xx=left; i<n; ++i, xx += (barW+gap)) {
-    if (i % 5 == 0) tft.drawLine(xx, bottom+1, xx, bottom+5, TFT_DARKGREY);
+  if (pvBandVisible(bottom+1, 5)) {
+    for (int i=0, xx=left; i<n; ++i, xx += (barW+gap)) {
+      if (i % 5 == 0) tft.drawLine(xx, bottom+1, xx, bottom+5, TFT_DARKGREY);
+    }
   }
 
   // ---- Legende ----
-  int legY = bottom + 6;
+  if (!legVisible) return;
   tft.setTextDatum(TL_DATUM);
   tft.setTextFont(2); tft.setTextSize(1);
   tft.setTextColor(TFT_RED,   TFT_BLACK); tft.drawString("T1",  left,      legY);
   tft.setTextColor(TFT_BLUE,  TFT_BLACK); tft.drawString("T2",  left+34,   legY);
   tft.setTextColor(TFT_GREEN, TFT_BLACK); tft.drawString("Exp", left+68,   legY);
   tft.setTextColor(TFT_YELLOW,TFT_BLACK); tft.drawString(String(kosten), left+130,   legY);
+  tft.setTextDatum(TR_DATUM);
+  tft.setTextColor(panned ? TFT_CYAN : TFT_LIGHTGREY, TFT_BLACK); tft.drawString(label, right, legY);   // cyan: nicht bis heute
 }
 
 // ------------------------- Seitensteuerung -------------------------
-static constexpr int PV_MAX_PAGES = 5; // 0..4 sichtbar
+static constexpr int PV_MAX_PAGES = 6; // 0..5 sichtbar
 static inline int pvMaxPages(){ return PV_MAX_PAGES; }
 
 // Öffentliche API: rendert Header, löscht Inhalt, rendert Seite
-static inline void drawPvPage(TFT_eSPI& tft, const PvFrameV4& f, int page){
-  // lokales clearContent (gekapselt)
-  auto clearContentArea = [&](TFT_eSPI& t){
-    const int y = headerLineY + 1;
-    t.fillRect(0, y, W, H - y, TFT_BLACK);
+template<class G>
+static inline void drawPvPage(G& tft, const PvFrameV4& f, int page){
+  // lokales clearContent (gekapselt), nur die Zeilen des Bands
+  auto clearContentArea = [&](G& t){
+    const int y = max(headerLineY + 1, pvBandY0);
+    if (y < pvBandY1) t.fillRect(0, y, W, pvBandY1 - y, TFT_BLACK);
   };
 
+  PV_TRACE_SCOPE(PVT_DRAW, page);
   // 1) Header
-  drawStatusHeader(tft, f);
+  PV_TRACE_BEGIN(PVT_DRAW_HEADER, 0);
+  if (pvBandVisible(0, headerLineY + 1)) drawStatusHeader(tft, f);
+  PV_TRACE_END(PVT_DRAW_HEADER, 0);
   // 2) Inhaltsbereich freiräumen
+  PV_TRACE_BEGIN(PVT_DRAW_CLEAR, 0);
   clearContentArea(tft);
+  PV_TRACE_END(PVT_DRAW_CLEAR, 0);
   // 3) Seite rendern (nur Inhalt)
+  PV_TRACE_SCOPE(PVT_DRAW_CONTENT, page);
   switch(page){
     default:
     case 0: drawPage5Content(tft,f); break; 
     case 1: drawPage2Content(tft,f); break; 
-    case 2: drawPage6Content(tft,f,tagesAnzeige); break; 
-    case 3: drawPage6Content(tft,f,monatsAnzeige); break; 
-    case 4: drawPage3Content(tft,f); break; 
+    case 2: drawPageDevicesContent(tft,f); break; 
+    case 3: drawPage6Content(tft,f,tagesAnzeige); break; 
+    case 4: drawPage6Content(tft,f,monatsAnzeige); break; 
+    case 5: drawPage3Content(tft,f); break; 
   }
 }
+
+#if defined(ARDUINO) && !defined(PV_GFX_LGFX)
+// Ein Band [y0, y0+rows) der Seite in einen Band-Puffer (Sprite W x PV_BAND_H) zeichnen.
+// Viewport-Datum (0,-y0): die Seiten zeichnen mit Bildschirmkoordinaten und lassen aus, was
+// das Band nicht schneidet (pvBandVisible); der Sprite clippt den Rest.
+// Nur TFT_eSprite: LovyanGFX-Sprites haben kein verschiebbares Datum, dort direkt zeichnen.
+static inline void drawPvPageBand(TFT_eSprite& spr, int y0, int rows, const PvFrameV4& f, int page){
+  pvBandY0 = y0; pvBandY1 = y0 + rows;
+  spr.resetViewport();
+  spr.fillSprite(TFT_BLACK);
+  spr.setViewport(0, -y0, W, H, true);
+  drawPvPage(spr, f, page);
+  spr.resetViewport();
+  pvBandY0 = 0; pvBandY1 = H;
+}
+#endif
@@ -0,0 +1,278 @@
+// ===================== PvElect.h =====================
+// Poller zur Laufzeit wählen (#define PV_ELECT im Poller-Build): mehrere Displays mit ROLE_POLLER,
+// genau eines fragt Modbus ab (aktiv). Die anderen folgen seinen Frames wie ein Client (Anzeige,
+// Energie-Teile, Verlauf); das ranghöchste davon ist Standby und übernimmt, wenn der Aktive ausfällt.
+//
+// Heartbeats (STATS_ELECT, alle PV_ELECT_HB_MS) gehen an die Stats-Gruppe und zusätzlich per
+// Unicast an jeden bekannten Knoten (Multicast geht im WLAN eher verloren). Rang: Amtszeit (term),
+// dann PV_ELECT_PRIO, dann Knoten-ID.
+//  - Start: PV_ELECT_DEAD_MS nur zuhören, einen laufenden Aktiven nie verdrängen
+//  - Standby hört PV_ELECT_DEAD_MS keinen Aktiven: bewirbt sich mit term+1 und wird nach
+//    PV_ELECT_CLAIM_MS aktiv, wenn sich bis dahin kein ranghöherer Aktiver/Bewerber meldet
+//  - Aktiver oder Bewerber hört einen ranghöheren: gibt sofort ab, offene Runde abbrechen. Die
+//    Folgenden melden den ranghöchsten Aktiven/Bewerber, den sie hören, weiter: zwei Bewerber,
+//    die einander nicht hören, erfahren so voneinander
+//  - wer niemanden hört, aber außer dem Aktiven noch andere Knoten kennt, bewirbt sich nicht
+//    (eher das eigene WLAN als alle anderen); WLAN getrennt: abgeben, danach erst zuhören
+//  - Lease: der Aktive stellt nur Anfragen, solange er jeden bekannten Knoten innerhalb
+//    PV_ELECT_LEASE_MS gehört hat. Ein Bewerber war beim Aktiven bekannt; kommt seine Bewerbung
+//    dort nicht an, kommt von ihm gar nichts mehr an, und der Aktive hält spätestens
+//    PV_ELECT_LEASE_MS nach dem letzten Heartbeat an, bevor der Bewerber beginnt.
+// Zwei Anfragende gibt es damit nur, wenn zwei Knoten einander in beide Richtungen länger als
+// PV_ELECT_DEAD_MS nicht hören (weder Multicast noch Unicast), ohne dass das WLAN trennt, und
+// beide den Wechselrichter erreichen. Mit nur zwei Knoten gehört dazu auch ein Standby, der so
+// lange nichts hört: er kann nicht unterscheiden, ob der Aktive ausgefallen ist.
+//
+// Frames tragen Amtszeit und Knoten (PvFrameElect hinter dem Plan-Anhang, PvSleep.h): Clients
+// nehmen den Nachfolger damit sofort als Quelle an (pvRxTakeover, PvRx.h) statt nach
+// PVRX_STALE_MS. Die seq läuft beim Nachfolger weiter; nur wenn er die letzten Frames verpasst
+// hat, springt sie zurück und der Client nimmt ihn als Neustart an (Lücken-Ring neu).
+// Ohne Arduino-Abhängigkeiten: tools/pvelect.cpp simuliert mehrere Knoten mit Verlust,
+// Ausfällen und Neustarts, auch als echte Prozesse über UDP auf localhost.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "PvWire.h"
+#include "PvFrame.h"
+#include "PvStats.h"
+#include "PvClock.h"
+#include "PvFill.h"
+#include "PvBatt.h"
+#include "PvSleep.h"
+
+#define PV_ELECT_HB_MS     400      // Heartbeat
+#define PV_ELECT_LEASE_MS  1200     // Aktiver: jeden bekannten Knoten so oft gehört, sonst keine Anfragen
+#define PV_ELECT_DEAD_MS   3000     // so lange nichts gehört: Aktiver ausgefallen bzw. Knoten vergessen
+#define PV_ELECT_CLAIM_MS  2000     // Bewerbung, bis der Bewerber abfragt
+#define PV_ELECT_SYNC_MS   60000    // Folgender: Verlauf weicht ab -> so oft Karussell anstoßen
+#define PV_ELECT_FORGET_MS 600000   // so lange still: Knoten zählt für die Bewerbung nicht mehr
+#define PV_ELECT_PEERS     6
+// Laufzeit und loop()-Verzug des Aktiven müssen in den Abstand passen
+static_assert(PV_ELECT_CLAIM_MS >= PV_ELECT_LEASE_MS + 2 * PV_ELECT_HB_MS, "PvElect: Lease läuft nicht vor der Bewerbung ab");
+
+enum : uint8_t { PVEL_LISTEN = 0, PVEL_FOLLOW, PVEL_CLAIM, PVEL_ACTIVE, PVEL_COUNT };
+static inline const char* pvElectStateName(uint8_t s){
+  static const char* n[PVEL_COUNT] = {"hört zu", "folgt", "bewirbt sich", "aktiv"};
+  return s < PVEL_COUNT ? n[s] : "?";
+}
+enum : uint8_t { PVEF_HIST = 0x01 };   // PayloadElect: hw/days/dig gültig
+
+// Ergebnis von pvElectTick()/pvElectRx()
+enum : uint8_t {
+  PVEA_HB     = 0x01,   // Heartbeat senden
+  PVEA_CLAIM  = 0x02,   // Bewerbung begonnen
+  PVEA_ACTIVE = 0x04,   // jetzt aktiv: Modbus verbinden, Runden starten
+  PVEA_YIELD  = 0x08,   // abgegeben: Runde abbrechen, Verbindungen schließen
+  PVEA_FOLLOW = 0x10    // neuer Aktiver (anderer Knoten)
+};
+
+static inline bool pvElectAbove(uint32_t ta, uint8_t pa, uint32_t ia, uint32_t tb, uint8_t pb, uint32_t ib){
+  if (ta != tb) return ta > tb;
+  if (pa != pb) return pa > pb;
+  return ia > ib;
+}
+
+struct PvElectPeer {
+  uint32_t id, ip, term, active, seq, ms;
+  uint8_t  prio, state;
+};
+
+struct PvElect {
+  uint32_t id = 0;
+  uint8_t  prio = 0;
+  uint8_t  state = PVEL_LISTEN;
+  uint32_t term = 0;              // aktiv/Bewerbung: eigene, sonst die des gefolgten Aktiven
+  uint32_t maxTerm = 0;           // höchste gesehene
+  uint32_t startMs = 0, claimMs = 0, hbMs = 0;
+  uint32_t activeId = 0, activeIp = 0, activeSeq = 0;   // gefolgter Aktiver
+  uint8_t  activePrio = 0;
+  uint32_t activeMs = 0;          // letztes Lebenszeichen eines Aktiven oder Bewerbers (0 = keins)
+  uint32_t candId = 0, candTerm = 0, candMs = 0;   // ranghöchster gehörter Aktiver/Bewerber (im Heartbeat)
+  uint8_t  candPrio = 0;
+  PvElectPeer peer[PV_ELECT_PEERS];
+  uint8_t  n = 0;
+  bool     fenced = false;        // aktiv, aber Lease abgelaufen
+  // Messung
+  uint32_t hbTx = 0, hbRx = 0, claims = 0, takeovers = 0, yields = 0, fences = 0, fenceAt = 0;
+  uint64_t fencedMs = 0;
+};
+
+static inline void pvElectBegin(PvElect& e, uint32_t id, uint8_t prio, uint32_t now){
+  e = PvElect{};
+  e.id = id; e.prio = prio; e.startMs = now;
+}
+
+static inline void pvElectFollow(PvElect& e, const PayloadElect& h, uint32_t ip, uint32_t now){
+  if (h.seq > e.activeSeq || h.term != e.term) e.activeSeq = h.seq;
+  e.activeId = h.id; e.activeIp = ip; e.activePrio = h.prio; e.term = h.term;
+  e.activeMs = now ? now : 1;
+}
+
+static inline bool pvElectFresh(uint32_t ms, uint32_t now){ return ms && now - ms < PV_ELECT_DEAD_MS; }
+
+// Heartbeat eines anderen Knotens (ip: Absender)
+static inline uint8_t pvElectRx(PvElect& e, const PayloadElect& h, uint32_t ip, uint32_t now){
+  if (h.id == e.id) return 0;   // eigener (Multicast-Schleife)
+  e.hbRx++;
+  uint8_t k = 0;
+  while (k < e.n && e.peer[k].id != h.id) k++;
+  if (k == e.n){
+    if (e.n < PV_ELECT_PEERS) e.n++;
+    else { k = 0; for (uint8_t i = 1; i < e.n; ++i) if (now - e.peer[i].ms > now - e.peer[k].ms) k = i; }   // ältesten ersetzen
+  }
+  e.peer[k] = PvElectPeer{ h.id, ip, h.term, h.active, h.seq, now, h.prio, h.state };
+  if (h.term > e.maxTerm) e.maxTerm = h.term;
+
+  const bool lead = h.state == PVEL_ACTIVE || h.state == PVEL_CLAIM;
+  if (lead && (!pvElectFresh(e.candMs, now) || h.id == e.candId || pvElectAbove(h.term, h.prio, h.id, e.candTerm, e.candPrio, e.candId))){
+    e.candId = h.id; e.candTerm = h.term; e.candPrio = h.prio; e.candMs = now ? now : 1;
+  }
+  const bool mine = e.state == PVEL_ACTIVE || e.state == PVEL_CLAIM;
+  if (mine){
+    // ranghöher: selbst aktiv bzw. Bewerber, oder von einem Folgenden gemeldet
+    const bool above = lead ? pvElectAbove(h.term, h.prio, h.id, e.term, e.prio, e.id)
+                            : h.active && h.active != e.id && pvElectAbove(h.term, h.aprio, h.active, e.term, e.prio, e.id);
+    if (!above) return 0;
+    const bool was = e.state == PVEL_ACTIVE;
+    e.state = PVEL_FOLLOW; e.yields++;
+    if (e.fenced){ e.fenced = false; e.fencedMs += now - e.fenceAt; }
+    e.activeId = 0; e.activeMs = now ? now : 1;   // der andere übernimmt: nicht gleich wieder bewerben
+    if (h.state == PVEL_ACTIVE){ pvElectFollow(e, h, ip, now); return PVEA_YIELD | PVEA_FOLLOW; }
+    return was ? PVEA_YIELD : 0;
+  }
+  if (h.state == PVEL_ACTIVE){
+    // dem ranghöchsten Aktiven folgen (zwei gleichzeitig nur, bis einer abgibt)
+    const bool cur = e.activeId && e.activeMs && now - e.activeMs < PV_ELECT_DEAD_MS;
+    if (h.id == e.activeId || !cur || pvElectAbove(h.term, h.prio, h.id, e.term, e.activePrio, e.activeId)){
+      const bool neu = h.id != e.activeId;
+      pvElectFollow(e, h, ip, now);
+      return neu ? PVEA_FOLLOW : 0;
+    }
+  } else if (h.state == PVEL_CLAIM && h.term > e.term) e.activeMs = now ? now : 1;   // Bewerbung läuft
+  return 0;
+}
+
+// ranghöchster der übrigen (ohne den Aktiven), die in PV_ELECT_DEAD_MS zu hören waren? Und
+// überhaupt jemanden gehört, sofern es außer Aktiven/Bewerbern noch andere Knoten gibt
+static inline bool pvElectStandby(const PvElect& e, uint32_t now){
+  bool heard = false, others = false;
+  for (uint8_t i = 0; i < e.n; ++i){
+    const PvElectPeer& p = e.peer[i];
+    const uint32_t age = now - p.ms;
+    if (p.state != PVEL_ACTIVE && p.state != PVEL_CLAIM && age < PV_ELECT_FORGET_MS) others = true;
+    if (age >= PV_ELECT_DEAD_MS || p.state == PVEL_ACTIVE) continue;
+    heard = true;
+    if (p.prio > e.prio || (p.prio == e.prio && p.id > e.id)) return false;
+  }
+  return heard || !others;
+}
+
+// Je loop()
+static inline uint8_t pvElectTick(PvElect& e, uint32_t now){
+  uint8_t a = 0;
+  if (!e.hbMs || now - e.hbMs >= PV_ELECT_HB_MS) a |= PVEA_HB;
+  switch (e.state){
+    case PVEL_LISTEN:
+      if (now - e.startMs >= PV_ELECT_DEAD_MS) e.state = PVEL_FOLLOW;
+      break;
+    case PVEL_FOLLOW:
+      if ((!e.activeMs || now - e.activeMs >= PV_ELECT_DEAD_MS) && pvElectStandby(e, now)){
+        e.state = PVEL_CLAIM; e.term = e.maxTerm = e.maxTerm + 1; e.claimMs = now; e.claims++;
+        e.activeId = 0;
+        a |= PVEA_CLAIM | PVEA_HB;
+      }
+      break;
+    case PVEL_CLAIM:
+      if (now - e.claimMs >= PV_ELECT_CLAIM_MS){
+        e.state = PVEL_ACTIVE; e.takeovers++;
+        e.activeId = e.id; e.activeIp = 0; e.activePrio = e.prio; e.activeMs = now ? now : 1;
+        a |= PVEA_ACTIVE | PVEA_HB;
+      }
+      break;
+    default: break;
+  }
+  if (a & PVEA_HB){ e.hbMs = now ? now : 1; e.hbTx++; }
+  return a;
+}
+
+// WLAN getrennt (statt pvElectTick()): abgeben, danach wie beim Start erst zuhören
+static inline uint8_t pvElectLinkDown(PvElect& e, uint32_t now){
+  const bool was = e.state == PVEL_ACTIVE;
+  if (e.state == PVEL_ACTIVE || e.state == PVEL_CLAIM) e.yields++;
+  if (e.fenced){ e.fenced = false; e.fencedMs += now - e.fenceAt; }
+  e.state = PVEL_LISTEN; e.startMs = now;
+  e.activeId = 0; e.activeMs = 0;
+  return was ? PVEA_YIELD : 0;
+}
+
+// Darf dieser Knoten jetzt Anfragen stellen? Aktiv und jeden bekannten Knoten (in
+// PV_ELECT_DEAD_MS gehört) innerhalb PV_ELECT_LEASE_MS gehört
+static inline bool pvElectMayPoll(PvElect& e, uint32_t now){
+  if (e.state != PVEL_ACTIVE) return false;
+  bool lease = true;
+  for (uint8_t i = 0; i < e.n; ++i){
+    const uint32_t age = now - e.peer[i].ms;
+    if (age >= PV_ELECT_LEASE_MS && age < PV_ELECT_DEAD_MS) lease = false;
+  }
+  if (lease == e.fenced){
+    e.fenced = !lease;
+    if (e.fenced){ e.fences++; e.fenceAt = now; }
+    else e.fencedMs += now - e.fenceAt;
+  }
+  return lease;
+}
+
+// Heartbeat (Stand des Verlaufs setzt der Aufrufer: hw/days/dig, PVEF_HIST)
+static inline PayloadElect pvElectHb(const PvElect& e, uint32_t seq, uint32_t now){
+  PayloadElect h{};
+  h.id = e.id; h.term = e.term; h.prio = e.prio; h.state = e.state; h.seq = seq;
+  if (e.state == PVEL_ACTIVE || e.state == PVEL_CLAIM){ h.active = e.id; h.aprio = e.prio; }
+  else if (pvElectFresh(e.candMs, now)){ h.active = e.candId; h.term = e.candTerm; h.aprio = e.candPrio; }
+  return h;
+}
+
+// ---- Anhang am Frame ----
+// Hinter dem Plan-Anhang (PvSleep.h): wer den Frame gesendet hat und in welcher Amtszeit
+#define PV_ELECT_MAGIC 0x4C45   // "EL"
+#define PV_FRAME_ELECT_FIELDS(F, A) \
+  F(uint16_t, magic)     /* PV_ELECT_MAGIC */ \
+  F(uint32_t, term) \
+  F(uint32_t, id) \
+  F(uint8_t,  prio) \
+  F(uint8_t,  rsv) \
+  F(uint16_t, crc)       /* CRC-16 (Modbus) über den Anhang bis vor 'crc' */
+PV_WIRE_MESSAGE(PvFrameElect, PV_FRAME_ELECT_FIELDS)
+static const size_t PV_ELECT_WIRE = PvWire<PvFrameElect>::size;
+static_assert(PV_ELECT_WIRE == 14, "Wahl-Anhang: Drahtformat");
+
+struct PvElectTag { uint32_t term, id; uint8_t prio; };
+
+static inline size_t pvElectSeal(uint8_t* p, const PvElect& e){
+  PvFrameElect t{ PV_ELECT_MAGIC, e.term, e.id, e.prio, 0, 0 };
+  pvWireEncode(t, p);
+  t.crc = crc16_modbus(p, PV_ELECT_WIRE - 2);
+  p[PV_ELECT_WIRE - 2] = (uint8_t)t.crc; p[PV_ELECT_WIRE - 1] = (uint8_t)(t.crc >> 8);
+  return PV_ELECT_WIRE;
+}
+
+// Anhang ab 'at' prüfen
+static inline bool pvElectGet(const uint8_t* data, size_t len, size_t at, PvElectTag& g){
+  PvFrameElect t;
+  if (!pvWireDecode(data + at, len < at ? 0 : len - at, t)) return false;
+  if (t.magic != PV_ELECT_MAGIC || t.crc != crc16_modbus(data + at, PV_ELECT_WIRE - 2) || !t.term) return false;
+  g.term = t.term; g.id = t.id; g.prio = t.prio;
+  return true;
+}
+
+// Anhänge eines ganzen Frames bis zum Wahl-Anhang durchgehen (Zeit, Teile, Batterie, Plan)
+static inline bool pvElectFrameGet(const uint8_t* data, size_t len, PvElectTag& g){
+  size_t at = PV_FRAME_WIRE + PV_TIME_WIRE;
+  PayloadFillPart parts[PV_FILL_PARTS];
+  const uint8_t np = pvFillGet(data, len, at, parts);
+  if (np) at += pvFillWire(np);
+  PvBattEta b; PvSched s;
+  if (!pvBattGet(data, len, at, b)) return false;
+  at += PV_BATT_WIRE;
+  if (!pvSchedGet(data, len, at, s)) return false;
+  return pvElectGet(data, len, at + PV_SCHED_WIRE, g);
+}
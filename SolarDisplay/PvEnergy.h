@@ -0,0 +1,151 @@
+// ===================== PvEnergy.h =====================
+// Energie-Integration in Festkomma (int64) statt double/float.
+// Ohne Arduino-Abhängigkeiten: wird auch von tools/pvenergy.cpp benutzt.
+//
+// Einheit: 1/2 mWs (= 1/2 mJ). Das Trapez (P0+P1)/2 * dt mit P in W und dt in ms
+// ist damit immer ganzzahlig: (P0+P1)*dt -> exakt, ohne Rundung, ohne FPU.
+// 1 kWh = 3.6e6 Ws = 7.2e9 Einheiten; int64 reicht für > 10^9 kWh.
+// float nur an den Rändern (Anzeige, Frame, Stats-Payload).
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PvPeak.h"
+
+#define PV_E_PER_KWH 7200000000LL   // Einheiten je kWh
+#define PV_E_PER_MWH 7200LL         // Einheiten je mWh
+
+// Kanäle (Reihenfolge = alte float-Struktur DayAgg/MonthAgg)
+enum : uint8_t { PVE_GEN = 0, PVE_LOAD, PVE_IMP_T1, PVE_IMP_T2, PVE_EXP, PVE_COUNT };
+
+struct PvEnergy {
+  int64_t e[PVE_COUNT];
+};
+
+// Integrations-Zwischenwerte (letzter Punkt des Trapezes)
+struct PvEnergyIntegrator {
+  uint32_t lastMs = 0;
+  int32_t  pv = 0, grid = 0, batt = 0;
+  bool     have = false;
+};
+
+static inline void pvEnergyClear(PvEnergy& a){ memset(&a, 0, sizeof(a)); }
+
+static inline void pvEnergyAdd(PvEnergy& a, const PvEnergy& d){
+  for (uint8_t i = 0; i < PVE_COUNT; ++i) a.e[i] += d.e[i];
+}
+
+// Ein Integrationsschritt. Liefert false beim ersten Punkt bzw. dt==0 (d bleibt 0).
+// t1: Bezug zählt zu Tarif T1 (sonst T2).
+static inline bool pvEnergyStep(PvEnergyIntegrator& s, int32_t pvW, int32_t gridW, int32_t battW,
+                                uint32_t nowMs, bool t1, PvEnergy& d){
+  pvEnergyClear(d);
+  uint32_t dt = nowMs - s.lastMs;
+  bool ok = s.have && dt != 0;
+  if (ok){
+    // PV >= 0
+    int64_t pv0 = s.pv > 0 ? s.pv : 0, pv1 = pvW > 0 ? pvW : 0;
+    // Grid: Export>0, Import<0
+    int64_t g0 = s.grid, g1 = gridW;
+    int64_t exp0 = g0 > 0 ? g0 : 0, exp1 = g1 > 0 ? g1 : 0;
+    int64_t imp0 = g0 < 0 ? -g0 : 0, imp1 = g1 < 0 ? -g1 : 0;
+    // Load = PV - Grid - Batt (nur >=0 integrieren)
+    int64_t l0 = (int64_t)s.pv - s.grid - s.batt; if (l0 < 0) l0 = 0;
+    int64_t l1 = (int64_t)pvW  - gridW  - battW;  if (l1 < 0) l1 = 0;
+
+    d.e[PVE_GEN]  = (pv0 + pv1) * dt;
+    d.e[PVE_EXP]  = (exp0 + exp1) * dt;
+    d.e[PVE_LOAD] = (l0 + l1) * dt;
+    d.e[t1 ? PVE_IMP_T1 : PVE_IMP_T2] = (imp0 + imp1) * dt;
+  }
+  if (ok || !s.have){ s.lastMs = nowMs; s.have = true; }
+  s.pv = pvW; s.grid = gridW; s.batt = battW;
+  return ok;
+}
+
+// ---- Ränder: Umrechnung nach/von float kWh ----
+// Erst ganzzahlig auf mWh, dann float: keine double-Arithmetik
+static inline float pvKWh(int64_t e){ return (float)(e / PV_E_PER_MWH) * 1e-6f; }
+static inline int64_t pvFromKWh(float kWh){ return (int64_t)(kWh * 1e6f + (kWh >= 0 ? 0.5f : -0.5f)) * PV_E_PER_MWH; }
+
+struct PvEnergyKWh { float gen_kWh, load_kWh, impT1_kWh, impT2_kWh, exp_kWh; };   // = alte DayAgg/MonthAgg
+
+static inline PvEnergyKWh pvEnergyToKWh(const PvEnergy& a){
+  return { pvKWh(a.e[PVE_GEN]), pvKWh(a.e[PVE_LOAD]), pvKWh(a.e[PVE_IMP_T1]), pvKWh(a.e[PVE_IMP_T2]), pvKWh(a.e[PVE_EXP]) };
+}
+static inline PvEnergy pvEnergyFromKWh(float gen, float load, float t1, float t2, float exp){
+  PvEnergy a;
+  a.e[PVE_GEN] = pvFromKWh(gen); a.e[PVE_LOAD] = pvFromKWh(load);
+  a.e[PVE_IMP_T1] = pvFromKWh(t1); a.e[PVE_IMP_T2] = pvFromKWh(t2); a.e[PVE_EXP] = pvFromKWh(exp);
+  return a;
+}
+
+// Tages-/Monatswerte: Energie und Spitzen (PvPeak.h)
+struct PvAgg : PvEnergy {
+  PvPeaks pk;
+};
+
+static inline void pvAggClear(PvAgg& a){ pvEnergyClear(a); pvPeakClear(a.pk); }
+
+// Zeiträume zusammenfassen: Energie addieren, Spitzen zusammenführen
+static inline void pvAggAdd(PvAgg& a, const PvAgg& d){ pvEnergyAdd(a, d); pvPeakMerge(a.pk, d.pk); }
+
+// ---- Flash-Record (NVS-Blob unter DYYYYMMDD / MYYYYMM) ----
+// v1 = alter Blob: 5 x float kWh (20 Byte, ohne Kopf) -> wird beim Lesen umgerechnet
+// v2 = exakte int64-Werte (Geräte-Keys weiterhin)
+// v3 = v2 + PvPeaks (Drahtformat) hinter den Kanälen: Tage, Wochen, Monate, Jahre.
+//      v2-Leser übernehmen davon die Kanäle.
+#define PV_EREC_MAGIC   0x4552   // "RE"
+#define PV_EREC_VERSION 2
+#define PV_EREC_PEAKS   3
+
+typedef struct __attribute__((packed)) {
+  uint16_t magic;
+  uint8_t  version;
+  uint8_t  count;          // Anzahl Kanäle (PVE_COUNT), für spätere Erweiterung
+  int64_t  e[PVE_COUNT];
+} PvEnergyRec;
+
+static_assert(sizeof(PvEnergyKWh) == 20, "alter float-Blob");
+static_assert(sizeof(PvEnergyRec) == 4 + 8 * PVE_COUNT, "PvEnergyRec Layout");
+#define PV_EREC_MAX (sizeof(PvEnergyRec) + PV_PEAKS_WIRE)   // größter Blob (Lesepuffer)
+
+static inline void pvEnergyEncode(const PvEnergy& a, PvEnergyRec& r){
+  r.magic = PV_EREC_MAGIC; r.version = PV_EREC_VERSION; r.count = PVE_COUNT;
+  memcpy(r.e, a.e, sizeof(r.e));
+}
+
+// Blob dekodieren (neu oder alt). false bei unbekanntem Format.
+static inline bool pvEnergyDecode(const uint8_t* b, size_t len, PvEnergy& a){
+  pvEnergyClear(a);
+  if (len == sizeof(PvEnergyKWh)){
+    PvEnergyKWh f; memcpy(&f, b, sizeof(f));
+    a = pvEnergyFromKWh(f.gen_kWh, f.load_kWh, f.impT1_kWh, f.impT2_kWh, f.exp_kWh);
+    return true;
+  }
+  if (len < 4) return false;
+  uint16_t magic; memcpy(&magic, b, 2);
+  if (magic != PV_EREC_MAGIC || b[2] < PV_EREC_VERSION || len < 4 + 8u * b[3]) return false;
+  uint8_t n = b[3] < PVE_COUNT ? b[3] : PVE_COUNT;   // neuere Versionen: bekannte Kanäle übernehmen
+  memcpy(a.e, b + 4, 8u * n);
+  return true;
+}
+
+// v3 schreiben (PV_EREC_MAX Bytes)
+static inline size_t pvAggEncode(const PvAgg& a, uint8_t* b){
+  PvEnergyRec r; pvEnergyEncode(a, r);
+  r.version = PV_EREC_PEAKS;
+  memcpy(b, &r, sizeof(r));
+  return sizeof(r) + pvWireEncode(a.pk, b + sizeof(r));
+}
+
+// alle Versionen; ohne Spitzen (v1, v2) sind sie leer
+static inline bool pvAggDecode(const uint8_t* b, size_t len, PvAgg& a){
+  pvPeakClear(a.pk);
+  if (!pvEnergyDecode(b, len, a)) return false;
+  if (len > sizeof(PvEnergyKWh) && b[2] >= PV_EREC_PEAKS){
+    const size_t at = 4 + 8u * b[3];
+    if (!pvWireDecode(b + at, len - at, a.pk)) pvPeakClear(a.pk);
+  }
+  return true;
+}
@@ -0,0 +1,399 @@
+// ===================== PvExport.h =====================
+// Den ganzen Verlauf über TCP (PV_EXPORT_PORT) holen bzw. zurückschreiben: Tage, ISO-Wochen,
+// Monate, Jahre und die Energie je Gerät, für Sicherungen und um ein Ersatzgerät zu bestücken.
+// Bisher ging das nur als ein UDP-Paket je Tag (STATS_REQ_RANGE), ein neuer Poller begann leer.
+//
+// Ablauf: der Host verbindet sich und sendet "PVXE" (Export) oder "PVXI" + Strom (Import, Antwort
+// PvImportRes). Der Strom besteht aus Kopf, Blöcken und Ende:
+//  Kopf   PvExportHdr  magic "PVX1", Version, Geräte, Flags (noch keine), erster/letzter Tag
+//  Block  PvExportBlk  Länge komprimiert/roh, Records, CRC32 der rohen Bytes; dann die Daten
+//  Ende   PvExportBlk mit lauter Nullen, dann PvExportEnd: Records und CRC32 über Kopf und alle Records
+// Record (roh): Art, Gerät, Länge, id (u32), Blob genau wie im NVS (v1 float, v2, v3 mit
+// Spitzen). Damit ist ein Import bitgleich, auch für Records älterer Firmware. Komprimiert wird
+// blockweise: id und Blob XOR dem vorigen Record derselben Art (gleiche Länge), dann Null-Läufe.
+// Aufeinanderfolgende Tage unterscheiden sich nur in den unteren Bytes. Jeder Block lässt sich
+// für sich dekodieren.
+//
+// Export: Schlüssel für Schlüssel über den Bereich, stückweise aus loop() (PV_EXPORT_STEP_KEYS
+// je Aufruf). Den laufenden Tag gibt es erst nach Mitternacht im NVS.
+// Import: jeder Block wird ganz geprüft (CRC, Codec, jeder Record dekodierbar), dann auf einmal
+// geschrieben, mit einem commit() je geändertem Block. Unveränderte Records werden nicht neu geschrieben.
+// Den laufenden Tag und den Gerätemonat führt der RAM, die Records dazu überspringt der Import.
+// Bricht der Strom ab, bleiben die schon geschriebenen Blöcke, das Ergebnis meldet den Fehler.
+// Stufen und Digest baut danach der Sketch aus den Tagen neu auf (PvRollup.h, PvPeer.h).
+// Speicher wie PvRollupPrefs: getBytesLength/getBytes/putBytes, dazu commit().
+// Ohne Arduino-Abhängigkeiten: tools/pvexport.cpp (Rundreise, Fehler, Bench, CSV/Spalten).
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include "PvWire.h"
+#include "PvEnergy.h"
+#include "PvRollup.h"
+
+#ifndef PV_EXPORT_PORT
+  #define PV_EXPORT_PORT 43212        // TCP: Verlauf holen/schreiben
+#endif
+#define PV_EXPORT_MAGIC      0x31585650u   // "PVX1"
+#define PV_EXPORT_RES_MAGIC  0x52585650u   // "PVXR"
+#define PV_EXPORT_VERSION    1
+#define PV_EXPORT_BLOCK      4096     // rohe Bytes je Block (= Records je commit() beim Import)
+#define PV_EXPORT_STEP_KEYS  64       // Export: Schlüssel je Aufruf aus loop()
+#define PV_EXPORT_IDLE_MS    10000    // Verbindung ohne Fortschritt: abbrechen
+#define PV_EXPORT_YEARS      PV_ROLLUP_YEARS   // Export ab dem 1.1. so viele Jahre zurück
+
+// Arten: Stufen wie PvRollup.h, dann je Gerät Tag/Monat (Schlüssel g<i>JJJJMMTT / h<i>JJJJMM)
+enum : uint8_t { PVX_DAY = PVL_DAY, PVX_WEEK = PVL_WEEK, PVX_MONTH = PVL_MONTH, PVX_YEAR = PVL_YEAR,
+                 PVX_DEV_DAY, PVX_DEV_MON, PVX_KINDS };
+
+enum : uint8_t { PVXE_OK = 0, PVXE_MAGIC, PVXE_VERSION, PVXE_LEN, PVXE_CODEC, PVXE_CRC, PVXE_RECORD,
+                 PVXE_SUM, PVXE_TRUNC, PVXE_STORE, PVXE_IO, PVXE_COUNT };
+static inline const char* pvExportErrName(uint8_t e){
+  static const char* n[PVXE_COUNT] = { "ok", "magic", "Version", "Länge", "Codec", "CRC", "Record",
+                                       "Summe", "abgebrochen", "NVS voll", "Verbindung" };
+  return e < PVXE_COUNT ? n[e] : "?";
+}
+
+#define PV_EXPORT_HDR_FIELDS(F, A) \
+  F(uint32_t, magic) F(uint8_t, version) F(uint8_t, devs) F(uint16_t, flags) \
+  F(int32_t,  first) F(int32_t, last)        /* Tagesnummern (PvRollup.h) */
+PV_WIRE_MESSAGE(PvExportHdr, PV_EXPORT_HDR_FIELDS)
+static_assert(PvWire<PvExportHdr>::size == 16, "PvExportHdr: Drahtformat");
+
+#define PV_EXPORT_BLK_FIELDS(F, A) \
+  F(uint16_t, clen) F(uint16_t, rlen)        /* komprimiert / roh, clen = 0: Ende */ \
+  F(uint16_t, recs) F(uint16_t, rsv) \
+  F(uint32_t, crc)                           /* CRC32 der rohen Bytes */
+PV_WIRE_MESSAGE(PvExportBlk, PV_EXPORT_BLK_FIELDS)
+static_assert(PvWire<PvExportBlk>::size == 12, "PvExportBlk: Drahtformat");
+
+#define PV_EXPORT_END_FIELDS(F, A) \
+  F(uint32_t, recs) F(uint32_t, crc)         /* CRC32 über alle Records unverändert */
+PV_WIRE_MESSAGE(PvExportEnd, PV_EXPORT_END_FIELDS)
+
+#define PV_IMPORT_RES_FIELDS(F, A) \
+  F(uint32_t, magic) F(uint8_t, err) F(uint8_t, rsv) F(uint16_t, blocks) \
+  F(uint32_t, recs) F(uint32_t, written) F(uint32_t, same) F(uint32_t, skipped) F(uint32_t, commits)
+PV_WIRE_MESSAGE(PvImportRes, PV_IMPORT_RES_FIELDS)
+static_assert(PvWire<PvImportRes>::size == 28, "PvImportRes: Drahtformat");
+
+#define PVX_REC_HDR 7   // Art, Gerät, Länge, id
+static const size_t PV_EXPORT_OUT = PvWire<PvExportBlk>::size + PV_EXPORT_BLOCK + PV_EXPORT_BLOCK / 128 + 1;
+
+// ---- CRC32 (IEEE, wie zlib), Halbbyte-Tabelle ----
+static inline uint32_t pvCrc32(uint32_t c, const uint8_t* p, size_t n){
+  static const uint32_t t[16] = { 0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+                                  0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+                                  0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C };
+  c = ~c;
+  while (n--){ c ^= *p++; c = (c >> 4) ^ t[c & 15]; c = (c >> 4) ^ t[c & 15]; }
+  return ~c;
+}
+
+// ---- Null-Läufe: Steuerbyte c < 0x80: c+1 Bytes folgen unverändert, sonst c-0x7F Nullen ----
+// Läufe ab drei Nullen lohnen, kürzere bleiben im Literal. out: n + n/128 + 1 Bytes
+static inline size_t pvZrlLiteral(const uint8_t* p, size_t n, uint8_t* out){
+  size_t o = 0;
+  while (n){
+    const size_t k = n < 128 ? n : 128;
+    out[o++] = (uint8_t)(k - 1); memcpy(out + o, p, k);
+    o += k; p += k; n -= k;
+  }
+  return o;
+}
+static inline size_t pvZrlEncode(const uint8_t* in, size_t n, uint8_t* out){
+  size_t o = 0, i = 0, lit = 0;
+  while (i < n){
+    size_t z = 0;
+    while (i + z < n && z < 128 && !in[i + z]) z++;
+    if (z >= 3 || (z && i + z == n)){
+      o += pvZrlLiteral(in + lit, i - lit, out + o);
+      out[o++] = (uint8_t)(0x7F + z);
+      i += z; lit = i;
+    } else i += z ? z : 1;
+  }
+  return o + pvZrlLiteral(in + lit, n - lit, out + o);
+}
+static inline bool pvZrlDecode(const uint8_t* in, size_t n, uint8_t* out, size_t cap, size_t& len){
+  size_t i = 0, o = 0;
+  while (i < n){
+    const uint8_t c = in[i++];
+    const size_t k = c < 0x80 ? c + 1u : c - 0x7Fu;
+    if (o + k > cap || (c < 0x80 && i + k > n)) return false;
+    if (c < 0x80){ memcpy(out + o, in + i, k); i += k; }
+    else memset(out + o, 0, k);
+    o += k;
+  }
+  len = o;
+  return true;
+}
+
+// ---- Schlüssel ----
+static inline uint8_t pvExportLvl(uint8_t kind){ return kind == PVX_DEV_DAY ? PVL_DAY : kind == PVX_DEV_MON ? PVL_MONTH : kind; }
+static inline void pvExportKey(uint8_t kind, uint8_t dev, uint32_t id, char* out, size_t len){
+  if (kind < PVX_DEV_DAY) pvRollupKey(kind, id, out, len);
+  else snprintf(out, len, kind == PVX_DEV_DAY ? "g%u%08lu" : "h%u%06lu", (unsigned)dev, (unsigned long)id);
+}
+static inline bool pvExportIdOk(uint8_t kind, uint32_t id){
+  const uint8_t lvl = pvExportLvl(kind);
+  return id && pvRollupId(lvl, pvRollupStart(lvl, id)) == id;
+}
+
+// Record-Kopf; die Summe im Ende läuft über Kopf und Blob unverändert
+static inline void pvExportRecHdr(uint8_t* p, uint8_t kind, uint8_t dev, uint8_t len, uint32_t id){
+  p[0] = kind; p[1] = dev; p[2] = len;
+  for (uint8_t i = 0; i < 4; ++i) p[3 + i] = (uint8_t)(id >> (8 * i));
+}
+
+// XOR-Vorgänger je Art, am Blockanfang leer
+struct PvExportPrev {
+  uint32_t id[PVX_KINDS];
+  uint8_t  len[PVX_KINDS];
+  uint8_t  blob[PVX_KINDS][PV_EREC_MAX];
+};
+static inline void pvExportPrevClear(PvExportPrev& v){ memset(v.id, 0, sizeof(v.id)); memset(v.len, 0, sizeof(v.len)); }
+
+// ======================= Export =======================
+struct PvExport {
+  int32_t  first = 0, last = 0;
+  uint16_t flags = 0;
+  uint8_t  devs = 0, kind = PVX_DAY, dev = 0;
+  uint32_t id = 0;                     // nächster Schlüssel der Art
+  bool     started = false, done = false;
+  uint8_t  err = PVXE_OK;
+  uint16_t rlen = 0, brecs = 0;        // laufender Block
+  PvExportPrev prev;
+  uint8_t  raw[PV_EXPORT_BLOCK];
+  uint8_t  out[PV_EXPORT_OUT];
+  // Messung
+  uint32_t keys = 0, recs = 0, crc = 0, blocks = 0, rawBytes = 0, outBytes = 0;
+};
+
+// Tage [first, last], dazu die Wochen/Monate/Jahre, die sie berühren; devs Geräte (Poller)
+static inline void pvExportBegin(PvExport& x, int32_t first, int32_t last, uint8_t devs){
+  x.first = first; x.last = last; x.devs = devs; x.flags = 0;
+  x.kind = PVX_DAY; x.dev = 0; x.id = pvRollupId(PVL_DAY, first);
+  x.started = x.done = false; x.err = PVXE_OK;
+  x.rlen = x.brecs = 0; pvExportPrevClear(x.prev);
+  x.keys = x.recs = x.crc = x.blocks = x.rawBytes = x.outBytes = 0;
+}
+
+// nächste Art (Geräte: g, h je Gerät); false = alle durch
+static inline bool pvExportNextKind(PvExport& x){
+  if (x.kind < PVX_YEAR) x.kind++;
+  else if (x.kind == PVX_YEAR){ if (!x.devs) return false; x.kind = PVX_DEV_DAY; x.dev = 0; }
+  else if (x.kind == PVX_DEV_DAY) x.kind = PVX_DEV_MON;
+  else { if (++x.dev >= x.devs) return false; x.kind = PVX_DEV_DAY; }
+  x.id = pvRollupId(pvExportLvl(x.kind), x.first);
+  return true;
+}
+
+static inline void pvExportRec(PvExport& x, uint32_t id, const uint8_t* blob, uint8_t n){
+  uint8_t* p = x.raw + x.rlen;
+  pvExportRecHdr(p, x.kind, x.dev, n, id);
+  x.crc = pvCrc32(x.crc, p, PVX_REC_HDR);
+  x.crc = pvCrc32(x.crc, blob, n);
+  PvExportPrev& v = x.prev;
+  const uint32_t d = id ^ v.id[x.kind];
+  for (uint8_t i = 0; i < 4; ++i) p[3 + i] = (uint8_t)(d >> (8 * i));
+  const bool same = v.len[x.kind] == n;
+  for (uint8_t i = 0; i < n; ++i) p[PVX_REC_HDR + i] = same ? (uint8_t)(blob[i] ^ v.blob[x.kind][i]) : blob[i];
+  memcpy(v.blob[x.kind], blob, n); v.len[x.kind] = n; v.id[x.kind] = id;
+  x.rlen += PVX_REC_HDR + n; x.brecs++; x.recs++;
+}
+
+template<class W>
+static inline bool pvExportOut(PvExport& x, const uint8_t* p, size_t n, W& write){
+  if (!write(p, n)){ x.err = PVXE_IO; x.done = true; return false; }
+  x.outBytes += n;
+  return true;
+}
+
+template<class W>
+static inline bool pvExportFlush(PvExport& x, W& write){
+  if (!x.brecs) return true;
+  const size_t h = PvWire<PvExportBlk>::size;
+  PvExportBlk b{};
+  b.rlen = x.rlen; b.recs = x.brecs; b.crc = pvCrc32(0, x.raw, x.rlen);
+  b.clen = (uint16_t)pvZrlEncode(x.raw, x.rlen, x.out + h);
+  pvWireEncode(b, x.out);
+  x.blocks++; x.rawBytes += x.rlen;
+  x.rlen = x.brecs = 0; pvExportPrevClear(x.prev);
+  return pvExportOut(x, x.out, h + b.clen, write);
+}
+
+// bis zu maxKeys Schlüssel lesen; write(p, n) -> false bricht ab (x.err). true = fertig
+template<class S, class W>
+static inline bool pvExportStep(PvExport& x, S& st, uint16_t maxKeys, W&& write){
+  if (x.done) return true;
+  if (!x.started){
+    x.started = true;
+    const PvExportHdr h{ PV_EXPORT_MAGIC, PV_EXPORT_VERSION, x.devs, x.flags, x.first, x.last };
+    uint8_t b[PvWire<PvExportHdr>::size];
+    x.crc = pvCrc32(0, b, pvWireEncode(h, b));
+    if (!pvExportOut(x, b, sizeof(b), write)) return true;
+  }
+  char key[16];
+  uint8_t blob[PV_EREC_MAX];
+  for (uint16_t k = 0; k < maxKeys; ++k){
+    const uint8_t lvl = pvExportLvl(x.kind);
+    if (pvRollupStart(lvl, x.id) > x.last){
+      if (pvExportNextKind(x)) continue;
+      if (!pvExportFlush(x, write)) return true;
+      const PvExportBlk e{};
+      const PvExportEnd t{ x.recs, x.crc };
+      uint8_t b[PvWire<PvExportBlk>::size + PvWire<PvExportEnd>::size];
+      pvWireEncode(t, b + pvWireEncode(e, b));
+      if (pvExportOut(x, b, sizeof(b), write)) x.done = true;
+      return true;
+    }
+    const uint32_t id = x.id;
+    pvExportKey(x.kind, x.dev, id, key, sizeof(key));
+    x.id = pvRollupStep(lvl, id, 1);
+    x.keys++;
+    const size_t n = st.getBytesLength(key);
+    if (!n || n > sizeof(blob) || st.getBytes(key, blob, n) != n) continue;
+    if (x.rlen + PVX_REC_HDR + n > PV_EXPORT_BLOCK && !pvExportFlush(x, write)) return true;
+    pvExportRec(x, id, blob, (uint8_t)n);
+  }
+  return false;
+}
+
+// ======================= Import =======================
+enum : uint8_t { PVXI_HDR = 0, PVXI_BLK, PVXI_DATA, PVXI_END, PVXI_DONE };
+
+struct PvImport {
+  int32_t  today = 0;                  // Ziel: laufender Tag (0 = keiner, alles schreiben)
+  uint8_t  devs = 0;                   // Ziel: eigene Geräte, Records weiterer werden übersprungen
+  uint8_t  state = PVXI_HDR, err = PVXE_OK;
+  PvExportHdr hdr{};
+  PvExportBlk blk{};
+  uint16_t have = 0;
+  PvExportPrev prev;
+  uint8_t  in[PV_EXPORT_OUT];
+  uint8_t  raw[PV_EXPORT_BLOCK];
+  // Messung
+  uint32_t recs = 0, crc = 0, blocks = 0, written = 0, same = 0, skipped = 0, commits = 0, days = 0;
+};
+
+static inline void pvImportBegin(PvImport& m, int32_t today, uint8_t devs){
+  m.today = today; m.devs = devs;
+  m.state = PVXI_HDR; m.err = PVXE_OK; m.have = 0;
+  m.recs = m.crc = m.blocks = m.written = m.same = m.skipped = m.commits = m.days = 0;
+}
+static inline bool pvImportDone(const PvImport& m){ return m.state == PVXI_DONE || m.err; }
+
+// Verbindung zu, bevor das Ende da war
+static inline void pvImportClose(PvImport& m){ if (!pvImportDone(m)) m.err = PVXE_TRUNC; }
+
+static inline PvImportRes pvImportResult(const PvImport& m){
+  return PvImportRes{ PV_EXPORT_RES_MAGIC, m.err, 0, (uint16_t)m.blocks, m.recs, m.written, m.same, m.skipped, m.commits };
+}
+
+// Block zurückverwandeln und ganz prüfen; danach stehen die Records unverändert in m.raw
+static inline uint8_t pvImportCheck(PvImport& m, uint16_t rlen){
+  size_t at = 0;
+  uint16_t recs = 0;
+  pvExportPrevClear(m.prev);
+  PvExportPrev& v = m.prev;
+  while (at < rlen){
+    if (at + PVX_REC_HDR > rlen) return PVXE_RECORD;
+    uint8_t* p = m.raw + at;
+    const uint8_t kind = p[0], dev = p[1], n = p[2];
+    if (kind >= PVX_KINDS || !n || n > PV_EREC_MAX || at + PVX_REC_HDR + n > rlen) return PVXE_RECORD;
+    if (kind < PVX_DEV_DAY ? dev != 0 : dev >= m.hdr.devs) return PVXE_RECORD;
+    uint32_t id = 0;
+    for (uint8_t i = 0; i < 4; ++i) id |= (uint32_t)p[3 + i] << (8 * i);
+    id ^= v.id[kind];
+    for (uint8_t i = 0; i < 4; ++i) p[3 + i] = (uint8_t)(id >> (8 * i));
+    uint8_t* b = p + PVX_REC_HDR;
+    if (v.len[kind] == n) for (uint8_t i = 0; i < n; ++i) b[i] ^= v.blob[kind][i];
+    memcpy(v.blob[kind], b, n); v.len[kind] = n; v.id[kind] = id;
+    PvAgg a;
+    if (!pvExportIdOk(kind, id) || !pvAggDecode(b, n, a)) return PVXE_RECORD;
+    at += PVX_REC_HDR + n; recs++;
+  }
+  return recs == m.blk.recs ? PVXE_OK : PVXE_RECORD;
+}
+
+// geprüften Block schreiben, ein commit() (nur wenn sich etwas geändert hat)
+template<class S>
+static inline void pvImportApply(PvImport& m, S& st, uint16_t rlen){
+  char key[16];
+  uint8_t old[PV_EREC_MAX];
+  const uint32_t today = m.today ? pvRollupId(PVL_DAY, m.today) : 0, month = m.today ? pvRollupId(PVL_MONTH, m.today) : 0;
+  const uint32_t before = m.written;
+  for (size_t at = 0; at < rlen; ){
+    const uint8_t* p = m.raw + at;
+    const uint8_t kind = p[0], dev = p[1], n = p[2];
+    uint32_t id = 0;
+    for (uint8_t i = 0; i < 4; ++i) id |= (uint32_t)p[3 + i] << (8 * i);
+    const uint8_t* b = p + PVX_REC_HDR;
+    at += PVX_REC_HDR + n;
+    m.crc = pvCrc32(m.crc, p, PVX_REC_HDR + n);
+    m.recs++;
+    // laufender Tag / Gerätemonat gehören dem RAM
+    if ((kind >= PVX_DEV_DAY && dev >= m.devs) || ((kind == PVX_DAY || kind == PVX_DEV_DAY) && id == today)
+        || (kind == PVX_DEV_MON && id == month)){ m.skipped++; continue; }
+    pvExportKey(kind, dev, id, key, sizeof(key));
+    if (st.getBytesLength(key) == n && st.getBytes(key, old, n) == n && !memcmp(old, b, n)){ m.same++; continue; }
+    if (st.putBytes(key, b, n) != n){ m.err = PVXE_STORE; break; }
+    m.written++;
+    m.days += kind == PVX_DAY;
+  }
+  if (m.written == before) return;        // nichts geändert: kein commit()
+  st.commit();
+  m.commits++;
+}
+
+template<class S>
+static inline void pvImportUnit(PvImport& m, S& st){
+  switch (m.state){
+    case PVXI_HDR:
+      pvWireDecode(m.in, PvWire<PvExportHdr>::size, m.hdr);
+      m.crc = pvCrc32(0, m.in, PvWire<PvExportHdr>::size);
+      if (m.hdr.magic != PV_EXPORT_MAGIC) m.err = PVXE_MAGIC;
+      else if (m.hdr.version != PV_EXPORT_VERSION || m.hdr.flags) m.err = PVXE_VERSION;
+      m.state = PVXI_BLK;
+      break;
+    case PVXI_BLK:
+      pvWireDecode(m.in, PvWire<PvExportBlk>::size, m.blk);
+      if (!m.blk.clen && !m.blk.rlen && !m.blk.recs && !m.blk.rsv && !m.blk.crc) m.state = PVXI_END;
+      else if (!m.blk.clen || m.blk.rlen > PV_EXPORT_BLOCK || m.blk.clen > PV_EXPORT_OUT - PvWire<PvExportBlk>::size || m.blk.rsv) m.err = PVXE_LEN;
+      else m.state = PVXI_DATA;
+      break;
+    case PVXI_DATA:{
+      size_t n = 0;
+      if (!pvZrlDecode(m.in, m.blk.clen, m.raw, sizeof(m.raw), n) || n != m.blk.rlen){ m.err = PVXE_CODEC; break; }
+      if (pvCrc32(0, m.raw, n) != m.blk.crc){ m.err = PVXE_CRC; break; }
+      if ((m.err = pvImportCheck(m, m.blk.rlen))) break;
+      pvImportApply(m, st, m.blk.rlen);
+      m.blocks++;
+      m.state = PVXI_BLK;
+    }break;
+    case PVXI_END:{
+      PvExportEnd e;
+      pvWireDecode(m.in, PvWire<PvExportEnd>::size, e);
+      if (e.recs != m.recs || e.crc != m.crc) m.err = PVXE_SUM;
+      m.state = PVXI_DONE;
+    }break;
+  }
+}
+
+// Bytes aus der Verbindung; liefert die verbrauchten (weniger nur, wenn fertig oder Fehler)
+template<class S>
+static inline size_t pvImportFeed(PvImport& m, S& st, const uint8_t* p, size_t n){
+  size_t used = 0;
+  while (used < n && !pvImportDone(m)){
+    const size_t need = m.state == PVXI_HDR ? PvWire<PvExportHdr>::size : m.state == PVXI_BLK ? PvWire<PvExportBlk>::size
+                      : m.state == PVXI_DATA ? m.blk.clen : PvWire<PvExportEnd>::size;
+    const size_t k = need - m.have < n - used ? need - m.have : n - used;
+    memcpy(m.in + m.have, p + used, k);
+    m.have += k; used += k;
+    if (m.have < need) break;
+    m.have = 0;
+    pvImportUnit(m, st);
+  }
+  return used;
+}
@@ -0,0 +1,228 @@
+// ===================== PvFill.h =====================
+// Energie je Frame statt eigener Integration auf den Clients. Der Poller hängt an jeden Frame,
+// was seit dem vorigen in seine Tagesakkus geflossen ist (ein Teil je Tag, um Mitternacht zwei);
+// Clients addieren genau diese Teile und zählen damit bitgleich wie der Poller.
+// Die letzten PV_FILL_RING Teile hält der Poller im RAM. Springt f->seq beim Client über
+// lastSeq+1 hinaus (WLAN weg), fragt er die fehlenden Frames mit STATS_FILL_REQ nach und
+// addiert deren Teile, sobald sie kommen; Teile von Tagen vor heute gehen in den Record im NVS.
+// Ohne Arduino-Abhängigkeiten: tools/pvfill.cpp simuliert Poller und Clients mit Verlust.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PvFrame.h"
+#include "PvStats.h"
+#include "PvEnergy.h"
+
+#define PV_FILL_RING      72       // Teile im Poller (Frames alle 30 s: gut 35 min)
+#define PV_FILL_WIN       64       // fehlende Frames, die ein Client nachfragt (Bits in uint64)
+#define PV_FILL_PER_PKT   6        // Teile je STATS_FILL (passt in STATS_MAX_PAYLOAD)
+#define PV_FILL_PARTS     2        // Teile je Frame höchstens (Mitternacht)
+#define PV_FILL_RETRY_MS  3000     // keine Antwort: noch einmal fragen
+#define PV_FILL_BACKOFF   3        // ... jedes Mal doppelt so lange, höchstens 2^3 mal
+static_assert(PV_FILL_WIN == 64, "PvFillClient::miss");
+static_assert(PvWire<PayloadFill>::size + PV_FILL_PER_PKT * PvWire<PayloadFillPart>::size <= STATS_MAX_PAYLOAD, "STATS_FILL");
+
+static inline PvEnergy pvFillEnergy(const PayloadFillPart& p){
+  PvEnergy a;
+  a.e[PVE_GEN] = p.gen; a.e[PVE_LOAD] = p.load; a.e[PVE_IMP_T1] = p.impT1; a.e[PVE_IMP_T2] = p.impT2; a.e[PVE_EXP] = p.exp;
+  return a;
+}
+
+// ---- Anhang am Frame ----
+// Hinter dem Zeit-Anhang (PvClock.h): Kopf, n Teile, CRC-16 (Modbus) über Kopf und Teile.
+// Ältere Clients lesen ihn nicht und integrieren weiter selbst.
+#define PV_FILL_MAGIC 0x4645   // "EF"
+#define PV_FRAME_FILL_FIELDS(F, A) \
+  F(uint16_t, magic)    /* PV_FILL_MAGIC */ \
+  F(uint8_t,  n)        /* Teile dahinter (1..PV_FILL_PARTS) */ \
+  F(uint8_t,  rsv)
+PV_WIRE_MESSAGE(PvFrameFill, PV_FRAME_FILL_FIELDS)
+static inline size_t pvFillWire(uint8_t n){ return PvWire<PvFrameFill>::size + n * PvWire<PayloadFillPart>::size + 2; }   // mit CRC
+static const size_t PV_FILL_WIRE_MAX = PvWire<PvFrameFill>::size + PV_FILL_PARTS * PvWire<PayloadFillPart>::size + 2;
+
+static inline size_t pvFillSeal(uint8_t* p, const PayloadFillPart* parts, uint8_t n){
+  PvFrameFill h{ PV_FILL_MAGIC, n, 0 };
+  uint8_t* q = p + pvWireEncode(h, p);
+  for (uint8_t i = 0; i < n; ++i) q += pvWireEncode(parts[i], q);
+  const uint16_t crc = crc16_modbus(p, (size_t)(q - p));
+  q[0] = (uint8_t)crc; q[1] = (uint8_t)(crc >> 8);
+  return (size_t)(q - p) + 2;
+}
+
+// Anhang ab Offset 'at' prüfen; liefert die Anzahl Teile (0 = keiner bzw. kaputt)
+static inline uint8_t pvFillGet(const uint8_t* data, size_t len, size_t at, PayloadFillPart* parts){
+  PvFrameFill h;
+  if (!pvWireDecode(data + at, len < at ? 0 : len - at, h)) return 0;
+  if (h.magic != PV_FILL_MAGIC || !h.n || h.n > PV_FILL_PARTS) return 0;
+  const size_t body = PvWire<PvFrameFill>::size + h.n * PvWire<PayloadFillPart>::size;
+  if (len - at < body + 2 || crc16_modbus(data + at, body) != pvWireU16(data + at + body)) return 0;
+  for (uint8_t i = 0; i < h.n; ++i)
+    PvWire<PayloadFillPart>::get(parts[i], data + at + PvWire<PvFrameFill>::size + i * PvWire<PayloadFillPart>::size);
+  return h.n;
+}
+
+// ---------- Poller: Ring ----------
+struct PvFillRing {
+  PayloadFillPart p[PV_FILL_RING];
+  uint16_t head = 0, n = 0;   // ältester Teil, Anzahl
+  PvEnergy acc = {};          // seit dem letzten Teil integriert
+  // Messung
+  uint32_t parts = 0, reqs = 0, sent = 0;
+};
+
+// aus der Integration (gleiches d wie in dayAgg)
+static inline void pvFillAdd(PvFillRing& r, const PvEnergy& d){ pvEnergyAdd(r.acc, d); }
+
+// Teil abschließen: mit jedem Frame (seq = dessen seq, day = heute) und um Mitternacht für
+// gestern (seq = nächster Frame); der Ring überschreibt den ältesten
+static inline void pvFillClose(PvFillRing& r, uint32_t seq, int32_t day){
+  PayloadFillPart& x = r.p[(r.head + r.n) % PV_FILL_RING];
+  x.seq = seq; x.day = day;
+  x.gen = r.acc.e[PVE_GEN]; x.load = r.acc.e[PVE_LOAD]; x.impT1 = r.acc.e[PVE_IMP_T1];
+  x.impT2 = r.acc.e[PVE_IMP_T2]; x.exp = r.acc.e[PVE_EXP];
+  if (r.n < PV_FILL_RING) r.n++; else r.head = (uint16_t)((r.head + 1) % PV_FILL_RING);
+  pvEnergyClear(r.acc);
+  r.parts++;
+}
+
+static inline uint32_t pvFillOldest(const PvFillRing& r){ return r.n ? r.p[r.head].seq : 0; }
+
+// Teil eines anderen Pollers übernehmen (Standby, PvElect.h): nach seq einsortiert, doppelte
+// verworfen; nach einer Übernahme dient der Ring weiter für Nachfragen
+static inline void pvFillPut(PvFillRing& r, const PayloadFillPart& x){
+  uint16_t i = r.n;
+  while (i > 0 && r.p[(r.head + i - 1) % PV_FILL_RING].seq > x.seq) i--;
+  for (uint16_t k = i; k > 0; --k){
+    const PayloadFillPart& o = r.p[(r.head + k - 1) % PV_FILL_RING];
+    if (o.seq != x.seq) break;
+    if (o.day == x.day) return;
+  }
+  if (r.n == PV_FILL_RING){
+    if (!i) return;   // älter als alles im vollen Ring
+    r.head = (uint16_t)((r.head + 1) % PV_FILL_RING); r.n--; i--;
+  }
+  for (uint16_t k = r.n; k > i; --k) r.p[(r.head + k) % PV_FILL_RING] = r.p[(r.head + k - 1) % PV_FILL_RING];
+  r.p[(r.head + i) % PV_FILL_RING] = x;
+  r.n++;
+}
+
+// Teile des Frames seq (für den Anhang)
+static inline uint8_t pvFillParts(const PvFillRing& r, uint32_t seq, PayloadFillPart* out){
+  uint8_t k = 0;
+  for (uint16_t i = 0; i < r.n && k < PV_FILL_PARTS; ++i){
+    const PayloadFillPart& x = r.p[(r.head + i) % PV_FILL_RING];
+    if (x.seq == seq) out[k++] = x;
+  }
+  return k;
+}
+
+// Teile der Frames from..to, zusammen mit den Teilen eines Frames immer im selben Paket;
+// send(pl, len) bekommt PayloadFill + Teile. Liefert die Anzahl Pakete.
+template<class F>
+static inline uint16_t pvFillServe(PvFillRing& r, uint32_t from, uint32_t to, F send){
+  uint8_t pl[PvWire<PayloadFill>::size + PV_FILL_PER_PKT * PvWire<PayloadFillPart>::size];
+  PayloadFill h{ pvFillOldest(r), 0, 0, 0 };
+  uint16_t pkts = 0;
+  r.reqs++;
+  uint16_t i = 0;
+  while (i < r.n){
+    const uint32_t seq = r.p[(r.head + i) % PV_FILL_RING].seq;
+    uint16_t j = i;
+    while (j < r.n && r.p[(r.head + j) % PV_FILL_RING].seq == seq) j++;
+    if (seq >= from && seq <= to){
+      if (h.n + (j - i) > PV_FILL_PER_PKT){
+        pvWireEncode(h, pl); send(pl, PvWire<PayloadFill>::size + h.n * PvWire<PayloadFillPart>::size);
+        h.n = 0; pkts++;
+      }
+      for (uint16_t k = i; k < j; ++k)
+        pvWireEncode(r.p[(r.head + k) % PV_FILL_RING], pl + PvWire<PayloadFill>::size + (h.n++) * PvWire<PayloadFillPart>::size);
+    }
+    i = j;
+  }
+  // auch ohne Teile antworten: oldest sagt dem Client, was verloren ist
+  pvWireEncode(h, pl); send(pl, PvWire<PayloadFill>::size + h.n * PvWire<PayloadFillPart>::size);
+  pkts++;
+  r.sent += pkts;
+  return pkts;
+}
+
+// ---------- Client ----------
+struct PvFillClient {
+  bool     have = false;
+  uint32_t top = 0;           // jüngster Frame
+  uint64_t miss = 0;          // Bit i: Frame top-1-i fehlt
+  bool     due = false;       // Anfrage fällig
+  uint32_t reqMs = 0;
+  uint8_t  tries = 0;
+  // Messung
+  uint32_t gaps = 0, missed = 0, filled = 0, lost = 0, reqs = 0;
+};
+
+static inline void pvFillReset(PvFillClient& c){ c.have = false; c.miss = 0; c.due = false; c.tries = 0; }
+
+static inline uint8_t pvFillBits(uint64_t m){ uint8_t n = 0; for (; m; m &= m - 1) n++; return n; }
+
+// Frame angenommen (pvRxFrame): Lücke davor merken. Nicht neuer als der jüngste heißt hier
+// Neustart des Pollers (ältere verwirft pvRxFrame), dann ohne Lücke neu ansetzen.
+static inline void pvFillOnFrame(PvFillClient& c, uint32_t seq){
+  if (!c.have || seq <= c.top){ pvFillReset(c); c.have = true; c.top = seq; return; }
+  const uint32_t d = seq - c.top;
+  if (d > 1){
+    c.gaps++; c.missed += d - 1;
+    c.due = true; c.tries = 0;
+  }
+  // fällt aus dem Fenster: verloren
+  uint32_t drop = 0;
+  if (d >= PV_FILL_WIN){ drop = pvFillBits(c.miss); c.miss = 0; }
+  else { drop = pvFillBits(c.miss >> (PV_FILL_WIN - d)); c.miss <<= d; }
+  if (d - 1 > PV_FILL_WIN) drop += d - 1 - PV_FILL_WIN;
+  const uint32_t gap = d - 1 < PV_FILL_WIN ? d - 1 : PV_FILL_WIN;
+  if (gap) c.miss |= gap >= 64 ? ~0ULL : ((1ULL << gap) - 1);
+  c.lost += drop;
+  c.top = seq;
+}
+
+// Teil eines nachgefragten Frames noch offen?
+static inline bool pvFillWanted(const PvFillClient& c, uint32_t seq){
+  if (!c.have || seq >= c.top || c.top - 1 - seq >= PV_FILL_WIN) return false;
+  return (c.miss >> (c.top - 1 - seq)) & 1;
+}
+
+// Frame seq erledigt (alle seine Teile addiert)
+static inline void pvFillDone(PvFillClient& c, uint32_t seq){
+  if (!pvFillWanted(c, seq)) return;
+  c.miss &= ~(1ULL << (c.top - 1 - seq));
+  c.filled++; c.tries = 0;
+}
+
+// Antwort: was älter als der Ring des Pollers ist, kommt nicht mehr
+static inline void pvFillOnReply(PvFillClient& c, uint32_t oldest){
+  if (!c.have || !oldest) return;
+  for (uint8_t i = 0; i < PV_FILL_WIN; ++i){
+    if (!((c.miss >> i) & 1)) continue;
+    if (c.top - 1 - i < oldest){ c.miss &= ~(1ULL << i); c.lost++; }
+  }
+}
+
+// Aus loop(): Anfrage fällig? Bereich vom ältesten bis zum jüngsten fehlenden Frame
+static inline bool pvFillTick(PvFillClient& c, uint32_t now, PayloadFillReq& q){
+  if (!c.miss){ c.due = false; return false; }
+  // nie aufgeben: verloren ist ein Frame erst, wenn er aus dem Fenster oder dem Ring fällt
+  const uint8_t sh = c.tries ? (c.tries - 1 < PV_FILL_BACKOFF ? c.tries - 1 : PV_FILL_BACKOFF) : 0;
+  if (!c.due && (uint32_t)(now - c.reqMs) < ((uint32_t)PV_FILL_RETRY_MS << sh)) return false;
+  uint8_t hi = 63, lo = 0;
+  while (!((c.miss >> hi) & 1)) hi--;
+  while (!((c.miss >> lo) & 1)) lo++;
+  q.from = c.top - 1 - hi; q.to = c.top - 1 - lo;
+  c.due = false; c.reqMs = now; if (c.tries < 255) c.tries++; c.reqs++;
+  return true;
+}
+
+// Wohin mit einem Teil? today = eigener Tag; final = bis hier hat der Client die Records des
+// Pollers schon (Abgleich, Reparatur nach Mitternacht), dort ist der Teil bereits enthalten
+enum : uint8_t { PVFILL_SKIP = 0, PVFILL_TODAY, PVFILL_PAST };
+static inline uint8_t pvFillTarget(int32_t day, int32_t today, int32_t final){
+  if (!day || day <= final) return PVFILL_SKIP;
+  return day >= today ? PVFILL_TODAY : PVFILL_PAST;
+}
@@ -0,0 +1,82 @@
+// ===================== PvFlush.h =====================
+// Asynchrone Bildschirm-Ausgabe in Bändern (Zeilenstreifen) mit zwei Puffern:
+// Band k wird in Puffer k&1 gezeichnet, während Band k-1 per DMA zum Display läuft.
+// Der Aufrufer gibt den Frame nach dem letzten Band frei und wartet nicht auf den Bus;
+// poll() meldet den Abschluss (Callback), fence() wartet explizit (z.B. vor Seitenwechsel).
+//
+// Ohne Arduino-Abhängigkeiten, der Bus ist ein Template-Parameter:
+//   void     begin();                                  Bus belegen (CS halten)
+//   void     push(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* px);   asynchron starten
+//   bool     busy();                                   Übertragung läuft
+//   void     wait();                                   auf Ende der laufenden Übertragung warten
+//   void     end();                                    Bus freigeben
+//   uint32_t nowUs();
+// Sketch: TFT_eSPI + DMA (SolarDisplay.ino), Host: simulierte Bandbreite (tools/pvflush.cpp).
+#pragma once
+#include <stdint.h>
+#include "PvTrace.h"
+
+#ifndef PV_BAND_H
+  #define PV_BAND_H 40     // Zeilen je Band (320 x 40 x 2 Byte = 25.6 kB je Puffer)
+#endif
+
+template<class Bus>
+struct PvFlush {
+  Bus*      bus = nullptr;
+  uint16_t* buf[2] = {nullptr, nullptr};
+  int16_t   w = 0, h = 0, bandH = PV_BAND_H;
+  bool      inFlight = false;
+
+  // Messung des letzten Frames (µs)
+  uint32_t  frames = 0;
+  uint32_t  t0 = 0, frameUs = 0, composeUs = 0, waitUs = 0;
+  void    (*onDone)(const PvFlush& f) = nullptr;   // Abschluss-Callback (aus poll()/fence())
+
+  bool ready() const { return bus && buf[0] && buf[1]; }
+
+  // Ganzen Frame ausgeben. compose(idx, y0, rows) zeichnet die Zeilen [y0, y0+rows)
+  // in buf[idx]. Kehrt nach dem Start des letzten Bands zurück.
+  template<class F> void frame(F&& compose){
+    fence();   // vorheriger Frame muss fertig sein (Bus/CS frei)
+    t0 = bus->nowUs(); composeUs = waitUs = 0;
+    bus->begin();
+    uint8_t idx = 0;
+    for (int16_t y = 0; y < h; y += bandH, idx ^= 1){
+      int16_t rows = (h - y < bandH) ? (int16_t)(h - y) : bandH;
+      uint32_t a = bus->nowUs();
+      { PV_TRACE_SCOPE(PVT_FLUSH_BAND, y); compose(idx, y, rows); }
+      uint32_t b = bus->nowUs();
+      // buf[idx] war zuletzt Band k-2, das ist fertig, seit Band k-1 gestartet wurde.
+      // Warten nur auf Band k-1, weil der Bus eine Übertragung gleichzeitig kann.
+      if (bus->busy()){ PV_TRACE_SCOPE(PVT_FLUSH_WAIT, y); bus->wait(); }
+      uint32_t c = bus->nowUs();
+      bus->push(0, y, w, rows, buf[idx]);
+      composeUs += b - a; waitUs += c - b;
+    }
+    inFlight = true;
+  }
+
+  // Aus loop(): Abschluss erkennen, ohne zu blockieren
+  bool poll(){
+    if (!inFlight || bus->busy()) return false;
+    finish();
+    return true;
+  }
+
+  // Frame-Fence: warten, bis alles beim Display ist
+  void fence(){
+    if (!inFlight) return;
+    bus->wait();
+    finish();
+  }
+
+private:
+  void finish(){
+    bus->end();
+    inFlight = false;
+    frameUs = bus->nowUs() - t0;
+    frames++;
+    PV_TRACE_INSTANT(PVT_FLUSH_DONE, frameUs);
+    if (onDone) onDone(*this);
+  }
+};
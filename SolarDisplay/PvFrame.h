@@ -0,0 +1,73 @@
+// ===================== PvFrame.h =====================
+// Frame-Format Poller -> Clients (Multicast). Ohne Arduino-Abhängigkeiten,
+// damit die Host-Tools (tools/*.cpp) dieselbe Definition verwenden.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "PvWire.h"
+
+// ================= Multicast (UDP) =================
+#define PV_MCAST_GRP_STR "239.12.12.12"   // = MCAST_GRP (PvCommon.h)
+static const uint16_t  MCAST_PORT = 55221;
+
+// ================= CRC16 (Modbus) =================
+static inline uint16_t crc16_modbus(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int j = 0; j < 8; j++) {
+      if (crc & 1) crc = (crc >> 1) ^ 0xA001;
+      else         crc >>= 1;
+    }
+  }
+  return crc;
+}
+
+// ------------------------- Frame V4 -------------------------
+#define PV_MAGIC   0xBEEF
+#define PV_VERSION 4
+
+// Feldliste = Drahtformat (Little Endian, ohne Lücken, PV_FRAME_WIRE Bytes); im Speicher ist
+// PvFrameV4 normal ausgerichtet. Senden: pvFrameEncode(), Empfang: pvRxFrame() (PvRx.h).
+#define PV_FRAME_V4_FIELDS(F, A) \
+  F(uint16_t, magic)               /* PV_MAGIC */ \
+  F(uint8_t,  version)             /* PV_VERSION (=4) */ \
+  F(uint32_t, seq)                 /* laufende Nummer */ \
+  F(uint32_t, ts)                  /* UNIX time (s) */ \
+  /* Hauptwerte */ \
+  F(int32_t,  pvW) \
+  F(int32_t,  gridW) \
+  F(int32_t,  battW) \
+  F(int32_t,  loadW) \
+  F(int16_t,  temp10)              /* 0.1°C */ \
+  F(uint16_t, socx10)              /* 0.1% */ \
+  F(float,    pvTodayKWh) \
+  F(float,    gridExpToday) \
+  F(float,    gridImpToday) \
+  F(float,    loadTodayKWh) \
+  F(int32_t,  eta20s)              /* Sekunden bis 20% (oder -1 wenn unbekannt) */ \
+  /* Zusatz (Skalen s. Namen) */ \
+  F(int16_t,  pv1Voltage_x10_V) \
+  F(int16_t,  pv1Current_x10_A) \
+  F(int16_t,  pv2Voltage_x10_V) \
+  F(int16_t,  pv2Current_x10_A) \
+  F(int32_t,  gridVoltageA_x10_V) \
+  F(int32_t,  gridVoltageB_x10_V) \
+  F(int32_t,  gridVoltageC_x10_V) \
+  F(int32_t,  gridCurrentA_x100_A) \
+  F(int32_t,  gridCurrentB_x100_A) \
+  F(int32_t,  gridCurrentC_x100_A) \
+  F(uint16_t, crc)                 /* CRC-16 (Modbus) über alles bis vor 'crc' */
+
+PV_WIRE_MESSAGE(PvFrameV4, PV_FRAME_V4_FIELDS)
+static const size_t PV_FRAME_WIRE = PvWire<PvFrameV4>::size;
+static_assert(PV_FRAME_WIRE == 85, "Frame v4: Drahtformat darf sich nicht ändern");
+
+// Frame in 'p' (PV_FRAME_WIRE Bytes) schreiben, CRC über die kodierten Bytes setzen (auch in f)
+static inline size_t pvFrameEncode(PvFrameV4& f, uint8_t* p){
+  f.magic = PV_MAGIC; f.version = PV_VERSION;
+  PvWire<PvFrameV4>::put(f, p);
+  f.crc = crc16_modbus(p, PV_FRAME_WIRE - 2);
+  p[PV_FRAME_WIRE - 2] = (uint8_t)f.crc; p[PV_FRAME_WIRE - 1] = (uint8_t)(f.crc >> 8);
+  return PV_FRAME_WIRE;
+}
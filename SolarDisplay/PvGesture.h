@@ -0,0 +1,160 @@
+// ===================== PvGesture.h =====================
+// Touch: Zeitgestempelter Ringpuffer (Touch-Task -> loop), Filter (Median-3 + IIR) und
+// Gesten-Automat für Tap / Long-Press / Swipe. Die Erkennung arbeitet nur mit den
+// Zeitstempeln der Samples, das Ergebnis hängt also nicht davon ab, wann loop() sie abholt.
+// Ohne Arduino-Abhängigkeiten: wird auch von tools/pvgesture.cpp benutzt (aufgezeichnete Spuren).
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+
+// ---- Parameter (Pixel / ms) ----
+#ifndef PVG_SWIPE_MIN_DIST
+  #define PVG_SWIPE_MIN_DIST 60     // min. 60 px in Wischrichtung
+#endif
+#ifndef PVG_SWIPE_MAX_TIME
+  #define PVG_SWIPE_MAX_TIME 1000   // max. 1 s
+#endif
+#ifndef PVG_TAP_MAX_DIST
+  #define PVG_TAP_MAX_DIST   15     // kleiner Versatz -> Tap / Long-Press
+#endif
+#ifndef PVG_LONG_MS
+  #define PVG_LONG_MS        800    // gehalten ohne Bewegung -> Long-Press
+#endif
+#ifndef PVG_RELEASE_MS
+  #define PVG_RELEASE_MS     150    // kein Sample so lange -> als losgelassen werten
+#endif
+#ifndef PV_TOUCH_RING
+  #define PV_TOUCH_RING      64     // Samples (Zweierpotenz), bei 100 Hz 640 ms Puffer
+#endif
+static_assert((PV_TOUCH_RING & (PV_TOUCH_RING-1)) == 0, "PV_TOUCH_RING muss Zweierpotenz sein");
+
+// ---- Sample ----
+struct PvTouchSample {
+  uint32_t tMs;     // millis() der Messung
+  int16_t  x, y;    // Bildschirmkoordinaten, ungefiltert (bei down=0 ohne Bedeutung)
+  uint8_t  down;    // 1 = berührt, 0 = losgelassen
+};
+
+// ---- Ringpuffer: ein Schreiber (Touch-Task), ein Leser (loop) ----
+struct PvTouchRing {
+  PvTouchSample s[PV_TOUCH_RING];
+  std::atomic<uint32_t> head{0}, tail{0};
+  uint32_t dropped = 0;   // voll -> neues Sample verworfen (Release fängt PVG_RELEASE_MS ab)
+
+  bool push(const PvTouchSample& v){
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= PV_TOUCH_RING){ dropped++; return false; }
+    s[h & (PV_TOUCH_RING-1)] = v;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+  bool pop(PvTouchSample& v){
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    v = s[t & (PV_TOUCH_RING-1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+// ---- Filter: Median der letzten 3 Rohwerte (Ausreisser), dann IIR 1/2 (Rauschen) ----
+struct PvTouchFilter {
+  int16_t hx[3], hy[3];
+  uint8_t i = 0;            // nächste Schreibposition
+  bool    primed = false;
+  int32_t fx = 0, fy = 0;   // IIR-Zustand, Festkomma x16
+};
+
+static inline int16_t pvMedian3(int16_t a, int16_t b, int16_t c){
+  if (a > b){ int16_t t = a; a = b; b = t; }
+  if (b > c) b = c;
+  return a > b ? a : b;
+}
+
+static inline void pvTouchFilterReset(PvTouchFilter& f){ f.primed = false; }
+
+static inline void pvTouchFilterAdd(PvTouchFilter& f, int16_t x, int16_t y, int16_t& ox, int16_t& oy){
+  if (!f.primed){ for (uint8_t k = 0; k < 3; ++k){ f.hx[k] = x; f.hy[k] = y; } f.fx = x * 16; f.fy = y * 16; f.primed = true; }
+  f.hx[f.i] = x; f.hy[f.i] = y; f.i = (uint8_t)(f.i == 2 ? 0 : f.i + 1);
+  int16_t mx = pvMedian3(f.hx[0], f.hx[1], f.hx[2]);
+  int16_t my = pvMedian3(f.hy[0], f.hy[1], f.hy[2]);
+  f.fx += (mx * 16 - f.fx) / 2;
+  f.fy += (my * 16 - f.fy) / 2;
+  ox = (int16_t)((f.fx + 8) / 16); oy = (int16_t)((f.fy + 8) / 16);
+}
+
+// ---- Gesten ----
+enum : uint8_t {
+  PVG_NONE = 0,
+  PVG_TAP,
+  PVG_LONG,          // einmal pro Berührung, sobald PVG_LONG_MS erreicht
+  PVG_SWIPE_LEFT,    // rechts -> links
+  PVG_SWIPE_RIGHT,
+  PVG_SWIPE_UP,
+  PVG_SWIPE_DOWN,
+  PVG_COUNT
+};
+
+static inline const char* pvGestureName(uint8_t g){
+  static const char* n[PVG_COUNT] = {"none","tap","long","swipe_left","swipe_right","swipe_up","swipe_down"};
+  return g < PVG_COUNT ? n[g] : "?";
+}
+
+struct PvGesture {
+  bool     down = false, longSent = false;
+  uint32_t t0 = 0, tLast = 0;
+  int16_t  x0 = 0, y0 = 0, x = 0, y = 0;
+};
+
+static inline uint8_t pvGestureRelease(PvGesture& g, uint32_t tUp){
+  g.down = false;
+  if (g.longSent) return PVG_NONE;
+  int dx = g.x - g.x0, dy = g.y - g.y0;
+  int ax = abs(dx), ay = abs(dy);
+  uint32_t dt = tUp - g.t0;
+  if (ax <= PVG_TAP_MAX_DIST && ay <= PVG_TAP_MAX_DIST) return PVG_TAP;
+  if (dt > PVG_SWIPE_MAX_TIME) return PVG_NONE;
+  if (ax >= PVG_SWIPE_MIN_DIST && ax * 5 > ay * 6) return dx < 0 ? PVG_SWIPE_LEFT : PVG_SWIPE_RIGHT;   // |dx| > 1.2 |dy|
+  if (ay >= PVG_SWIPE_MIN_DIST && ay * 5 > ax * 6) return dy < 0 ? PVG_SWIPE_UP : PVG_SWIPE_DOWN;
+  return PVG_NONE;
+}
+
+// Sample verarbeiten -> Geste oder PVG_NONE
+static inline uint8_t pvGestureFeed(PvGesture& g, const PvTouchSample& s){
+  if (!s.down) return g.down ? pvGestureRelease(g, s.tMs) : PVG_NONE;
+  // Lücke > PVG_RELEASE_MS: Loslassen ging verloren, das Sample gehört zu einer neuen Berührung
+  uint8_t ended = (g.down && s.tMs - g.tLast > PVG_RELEASE_MS) ? pvGestureRelease(g, g.tLast) : PVG_NONE;
+  if (!g.down){
+    g.down = true; g.longSent = false;
+    g.t0 = g.tLast = s.tMs; g.x0 = g.x = s.x; g.y0 = g.y = s.y;
+    return ended;
+  }
+  g.tLast = s.tMs; g.x = s.x; g.y = s.y;
+  if (!g.longSent && s.tMs - g.t0 >= PVG_LONG_MS &&
+      abs(g.x - g.x0) <= PVG_TAP_MAX_DIST && abs(g.y - g.y0) <= PVG_TAP_MAX_DIST){
+    g.longSent = true;
+    return PVG_LONG;
+  }
+  return PVG_NONE;
+}
+
+// Ohne neue Samples: verlorenes Loslassen (Ring voll, Task hängt) nach PVG_RELEASE_MS abschließen
+static inline uint8_t pvGestureTick(PvGesture& g, uint32_t nowMs){
+  if (g.down && nowMs - g.tLast > PVG_RELEASE_MS) return pvGestureRelease(g, g.tLast);
+  return PVG_NONE;
+}
+
+// ---- Filter + Automat: so läuft es im Sketch und in tools/pvgesture.cpp ----
+struct PvTouchInput {
+  PvTouchFilter f;
+  PvGesture     g;
+};
+
+static inline uint8_t pvTouchInput(PvTouchInput& in, PvTouchSample s){
+  if (s.down){
+    if (!in.g.down || s.tMs - in.g.tLast > PVG_RELEASE_MS) pvTouchFilterReset(in.f);   // neue Berührung
+    pvTouchFilterAdd(in.f, s.x, s.y, s.x, s.y);
+  }
+  return pvGestureFeed(in.g, s);
+}
@@ -0,0 +1,114 @@
+// ===================== PvGfx.h =====================
+// Zeichen-Backend der Seiten (PvCommon.h). Die Seiten sind Templates über das Zeichenziel G
+// und werden beim Kompilieren aufgelöst (keine virtuellen Aufrufe, kein Adapter dazwischen).
+// G braucht die TFT_eSPI-Untermenge, die die Seiten benutzen:
+//   fillRect, drawRect, drawLine, fillTriangle, fillCircle,
+//   setTextDatum, setTextFont, setTextSize, setTextColor(fg[, bg]),
+//   drawString(String | const char*, x, y), textWidth(String | const char*), fontHeight()
+// Das können TFT_eSPI/TFT_eSprite (Standard), LovyanGFX (LGFX/LGFX_Sprite, #define PV_GFX_LGFX
+// im Sketch) und der Host-Framebuffer in tools/pvgfx.cpp.
+//
+// Primitive, die eine Bibliothek schneller kann als die allgemeine Fassung, laufen über
+// PvGfxOps<G>: allgemein unten (nur mit der Untermenge), Spezialisierungen je Bibliothek.
+// Winkel wie in den Seiten: Grad, 0 = 3 Uhr, gegen den Uhrzeigersinn (y nach oben).
+#pragma once
+#include <stdint.h>
+#include <math.h>
+#include <type_traits>
+
+// ---- Host: Farben/Datum wie TFT_eSPI (im Sketch kommen sie aus der Bibliothek) ----
+#ifndef ARDUINO
+  #define TFT_BLACK     0x0000
+  #define TFT_NAVY      0x000F
+  #define TFT_DARKGREEN 0x03E0
+  #define TFT_MAROON    0x7800
+  #define TFT_DARKGREY  0x7BEF
+  #define TFT_LIGHTGREY 0xD69A
+  #define TFT_BLUE      0x001F
+  #define TFT_GREEN     0x07E0
+  #define TFT_CYAN      0x07FF
+  #define TFT_RED       0xF800
+  #define TFT_MAGENTA   0xF81F
+  #define TFT_YELLOW    0xFFE0
+  #define TFT_WHITE     0xFFFF
+  #define TFT_ORANGE    0xFDA0
+  enum { TL_DATUM = 0, TC_DATUM, TR_DATUM, ML_DATUM, MC_DATUM, MR_DATUM, BL_DATUM, BC_DATUM, BR_DATUM };
+#endif
+
+// ---- Band-Rendering (PvFlush.h): Zeilen [pvBandY0, pvBandY1) des aktuellen Durchgangs ----
+// Direkt aufs Display 0..240 (H in PvCommon.h); Seiten und Primitive lassen aus, was außerhalb liegt
+static int pvBandY0 = 0, pvBandY1 = 240;
+static inline bool pvBandVisible(int y, int h){ return y + h > pvBandY0 && y < pvBandY1; }
+
+// ---- allgemeine Fassung ----
+template<class G, class = void>
+struct PvGfxOps {
+  // Ring-Ausschnitt zwischen rInner und rOuter von a0 nach a1 als Dreiecksstreifen (3°-Schritte)
+  static void fillArc(G& g, int cx, int cy, int rInner, int rOuter, float a0, float a1, uint16_t col){
+    const float k = 3.14159265358979323846f / 180.0f;
+    const float step = 3.0f;
+    const int dir = (a1 < a0) ? -1 : +1;
+    float a = a0;
+    while (true){
+      float aNext = a + dir * step;
+      bool last = (dir < 0) ? (aNext <= a1) : (aNext >= a1);
+      if (last) aNext = a1;
+
+      float r0 = a * k, r1 = aNext * k;
+      int x0o = (int)(cx + cosf(r0) * rOuter), y0o = (int)(cy - sinf(r0) * rOuter);
+      int x1o = (int)(cx + cosf(r1) * rOuter), y1o = (int)(cy - sinf(r1) * rOuter);
+      int x0i = (int)(cx + cosf(r0) * rInner), y0i = (int)(cy - sinf(r0) * rInner);
+      int x1i = (int)(cx + cosf(r1) * rInner), y1i = (int)(cy - sinf(r1) * rInner);
+      const int ys[3] = { y1o, y0i, y1i };
+      int yLo = y0o, yHi = y0o;
+      for (int yy : ys){ if (yy < yLo) yLo = yy; if (yy > yHi) yHi = yy; }
+      if (pvBandVisible(yLo, yHi - yLo + 1)){   // Segment im Band
+        g.fillTriangle(x0o, y0o, x1o, y1o, x0i, y0i, col);
+        g.fillTriangle(x1o, y1o, x1i, y1i, x0i, y0i, col);
+      }
+
+      if (last) break;
+      a = aNext;
+    }
+  }
+};
+
+// Winkelbereich [a0, a1] (beliebige Reihenfolge) in Bibliotheks-Grad: Start s, Ende e >= s,
+// im Uhrzeigersinn ab Nullrichtung zero (Grad in Seiten-Winkeln)
+static inline void pvGfxArcCw(float a0, float a1, float zero, float& s, float& e){
+  float lo = a0 < a1 ? a0 : a1, hi = a0 < a1 ? a1 : a0;
+  s = zero - hi;
+  while (s < 0.0f) s += 360.0f;
+  while (s >= 360.0f) s -= 360.0f;
+  e = s + (hi - lo);
+}
+
+#if defined(ARDUINO) && !defined(PV_GFX_LGFX)
+// ---- TFT_eSPI / TFT_eSprite: drawArc (Spans statt Dreiecke, geglättete Kanten) ----
+// Winkel der Bibliothek: 0 = 6 Uhr, im Uhrzeigersinn, ganze Grad; Kanten gegen Schwarz geglättet
+template<class G>
+struct PvGfxOps<G, typename std::enable_if<std::is_base_of<TFT_eSPI, G>::value>::type> {
+  static void fillArc(G& g, int cx, int cy, int rInner, int rOuter, float a0, float a1, uint16_t col){
+    float s, e; pvGfxArcCw(a0, a1, 270.0f, s, e);
+    uint32_t is = (uint32_t)lroundf(s), ie = (uint32_t)lroundf(e);
+    if (ie > 360) ie -= 360;   // drawArc läuft über 360 -> 0 selbst weiter
+    g.drawArc(cx, cy, rOuter, rInner, is, ie, col, TFT_BLACK, false);
+  }
+};
+#endif
+
+#if defined(ARDUINO) && defined(PV_GFX_LGFX)
+// ---- LovyanGFX: fillArc der Bibliothek (0 = 3 Uhr, im Uhrzeigersinn, float-Grad) ----
+template<class G>
+struct PvGfxOps<G, typename std::enable_if<std::is_base_of<lgfx::LGFXBase, G>::value>::type> {
+  static void fillArc(G& g, int cx, int cy, int rInner, int rOuter, float a0, float a1, uint16_t col){
+    float s, e; pvGfxArcCw(a0, a1, 0.0f, s, e);
+    g.fillArc(cx, cy, rInner, rOuter - 1, s, e, col);
+  }
+};
+#endif
+
+template<class G>
+static inline void pvFillArc(G& g, int cx, int cy, int rInner, int rOuter, float a0, float a1, uint16_t col){
+  PvGfxOps<G>::fillArc(g, cx, cy, rInner, rOuter, a0, a1, col);
+}
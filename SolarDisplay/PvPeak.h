@@ -0,0 +1,183 @@
+// ===================== PvPeak.h =====================
+// Spitzen und Leistungsmittel je Tag/Monat aus jedem Frame: höchster Bezug, höchste Einspeisung,
+// PV, Verbrauch, Laden/Entladen, SoC min/max, jeweils mit Zeitpunkt, und das höchste
+// 15-Minuten-Mittel des Bezugs (Leistungspreis des Netzbetreibers), gesamt und je Tarif.
+// O(1) je Sample, fester Speicher: das Mittel läuft über einen Ring aus Minuten-Fächern
+// (Energie und abgedeckte Zeit je Fach), beim Weiterrücken fällt das älteste Fach heraus.
+// Die Spitzen stehen im Tages-/Monatsrecord (PvEnergy.h, v3) und gehen als STATS_PEAKS
+// an die Clients (PvStats.h).
+// Ohne Arduino-Abhängigkeiten: tools/pvpeak.cpp prüft gegen Nachrechnen über alle Samples.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PvWire.h"
+
+#define PV_PEAK_WIN_SLOTS  15          // Fenster des Mittels in Fächern ...
+#define PV_PEAK_SLOT_S     60          // ... zu je 60 s: 15 Minuten
+#define PV_PEAK_GAP_S      300         // längere Pause zwischen Samples: Intervall nicht zählen
+#define PV_PEAK_COVER_PCT  80          // Mittel erst ab so viel abgedeckter Fensterzeit
+#define PV_PEAK_TS_MIN     1577836800u // 2020-01-01: Frames ohne gestellte Uhr zählen nicht
+#define PV_PEAK_OWN_MS     90000       // Client: so lange ohne STATS_PEAKS -> eigene Spitzen aus den Frames
+
+// Je Größe Wert und Zeitpunkt (Unix-Zeit des Frames, 0 = noch kein Sample). Gleichstand:
+// der frühere Zeitpunkt bleibt. Leistungen in W, SoC in 0.1 %.
+#define PV_PEAKS_FIELDS(F, A) \
+  F(uint32_t, n)                               /* Samples */ \
+  F(int32_t,  impW)   F(uint32_t, impTs)       /* höchster Bezug */ \
+  F(int32_t,  expW)   F(uint32_t, expTs)       /* höchste Einspeisung */ \
+  F(int32_t,  pvW)    F(uint32_t, pvTs) \
+  F(int32_t,  loadW)  F(uint32_t, loadTs) \
+  F(int32_t,  chgW)   F(uint32_t, chgTs)       /* Batterie laden */ \
+  F(int32_t,  disW)   F(uint32_t, disTs)       /* Batterie entladen */ \
+  F(int32_t,  socLo)  F(uint32_t, socLoTs)     /* nur mit Batterie */ \
+  F(int32_t,  socHi)  F(uint32_t, socHiTs) \
+  F(int32_t,  demW)   F(uint32_t, demTs)       /* höchstes 15-min-Mittel Bezug, Ende des Fensters */ \
+  F(int32_t,  demT1W) F(uint32_t, demT1Ts)     /* ... Fensterende in T1 */ \
+  F(int32_t,  demT2W) F(uint32_t, demT2Ts)     /* ... Fensterende in T2 */
+PV_WIRE_MESSAGE(PvPeaks, PV_PEAKS_FIELDS)
+static const size_t PV_PEAKS_WIRE = PvWire<PvPeaks>::size;
+static_assert(PV_PEAKS_WIRE == 92, "PvPeaks: Drahtformat");
+
+static inline void pvPeakClear(PvPeaks& p){ memset(&p, 0, sizeof(p)); }
+
+static inline void pvPeakHi(int32_t& v, uint32_t& t, int32_t x, uint32_t ts){
+  if (ts && (!t || x > v || (x == v && ts < t))){ v = x; t = ts; }
+}
+static inline void pvPeakLo(int32_t& v, uint32_t& t, int32_t x, uint32_t ts){
+  if (ts && (!t || x < v || (x == v && ts < t))){ v = x; t = ts; }
+}
+
+// Ein Frame, aufbereitet (pvPeakStep): Leistungen >= 0, soc < 0 = keine Batterie, dem < 0 = Mittel offen
+struct PvPeakSample {
+  uint32_t ts;
+  int32_t  imp, exp, pv, load, chg, dis, soc, dem;
+  bool     t1;
+};
+
+static inline void pvPeakAdd(PvPeaks& p, const PvPeakSample& s){
+  p.n++;
+  pvPeakHi(p.impW, p.impTs, s.imp, s.ts);
+  pvPeakHi(p.expW, p.expTs, s.exp, s.ts);
+  pvPeakHi(p.pvW, p.pvTs, s.pv, s.ts);
+  pvPeakHi(p.loadW, p.loadTs, s.load, s.ts);
+  pvPeakHi(p.chgW, p.chgTs, s.chg, s.ts);
+  pvPeakHi(p.disW, p.disTs, s.dis, s.ts);
+  if (s.soc >= 0){
+    pvPeakLo(p.socLo, p.socLoTs, s.soc, s.ts);
+    pvPeakHi(p.socHi, p.socHiTs, s.soc, s.ts);
+  }
+  if (s.dem >= 0){
+    pvPeakHi(p.demW, p.demTs, s.dem, s.ts);
+    if (s.t1) pvPeakHi(p.demT1W, p.demT1Ts, s.dem, s.ts);
+    else      pvPeakHi(p.demT2W, p.demT2Ts, s.dem, s.ts);
+  }
+}
+
+// Tage zum Monat (Woche, Jahr, Zeitraum). Spitzen gehen nur nach oben: wird ein Tag mit
+// kleineren Spitzen neu geschrieben, bleibt der Monat beim alten Wert.
+static inline void pvPeakMerge(PvPeaks& a, const PvPeaks& b){
+  a.n += b.n;
+  pvPeakHi(a.impW, a.impTs, b.impW, b.impTs);
+  pvPeakHi(a.expW, a.expTs, b.expW, b.expTs);
+  pvPeakHi(a.pvW, a.pvTs, b.pvW, b.pvTs);
+  pvPeakHi(a.loadW, a.loadTs, b.loadW, b.loadTs);
+  pvPeakHi(a.chgW, a.chgTs, b.chgW, b.chgTs);
+  pvPeakHi(a.disW, a.disTs, b.disW, b.disTs);
+  pvPeakLo(a.socLo, a.socLoTs, b.socLo, b.socLoTs);
+  pvPeakHi(a.socHi, a.socHiTs, b.socHi, b.socHiTs);
+  pvPeakHi(a.demW, a.demTs, b.demW, b.demTs);
+  pvPeakHi(a.demT1W, a.demT1Ts, b.demT1W, b.demT1Ts);
+  pvPeakHi(a.demT2W, a.demT2Ts, b.demT2W, b.demT2Ts);
+}
+
+// Stand einer anderen Quelle für denselben Zeitraum (Client <- Poller): Spitzen zusammenführen,
+// Samples nicht addieren
+static inline void pvPeakTake(PvPeaks& a, const PvPeaks& b){
+  const uint32_t n = a.n > b.n ? a.n : b.n;
+  pvPeakMerge(a, b);
+  a.n = n;
+}
+
+// gleiche Spitzen (n zählt nicht: Poller und Client sehen verschieden viele Frames)
+static inline bool pvPeakSame(const PvPeaks& a, const PvPeaks& b){
+  PvPeaks x = a, y = b; x.n = y.n = 0;
+  return !memcmp(&x, &y, sizeof(x));
+}
+
+// ---- Fenster für das Mittel ----
+// Das Trapez eines Intervalls (t0, t1] zählt ganz zum Fach von t1. Energie in halben W·s
+// (ganzzahlig wie PvEnergy.h), Mittel = Energie / abgedeckte Zeit der letzten 15 Fächer.
+struct PvPeakWin {
+  int32_t  e[PV_PEAK_WIN_SLOTS];     // Bezug, halbe W·s je Fach
+  uint16_t cov[PV_PEAK_WIN_SLOTS];   // abgedeckte Sekunden je Fach
+  int64_t  eSum;
+  uint32_t covSum;
+  uint32_t slot;                     // laufendes Fach (ts / PV_PEAK_SLOT_S)
+  uint32_t lastTs;
+  int32_t  lastImp;
+  bool     have;
+  uint32_t samples, gaps, resets;    // Messung
+};
+
+static inline void pvPeakWinReset(PvPeakWin& w){
+  const uint32_t s = w.samples, g = w.gaps, r = w.resets;
+  memset(&w, 0, sizeof(w));
+  w.samples = s; w.gaps = g; w.resets = r;
+}
+
+// Frame aufbereiten und das Fenster nachführen. false: ohne gestellte Uhr, nichts zu zählen.
+static inline bool pvPeakStep(PvPeakWin& w, uint32_t ts, int32_t pvW, int32_t gridW, int32_t battW,
+                              uint16_t socx10, bool t1, PvPeakSample& s){
+  if (ts < PV_PEAK_TS_MIN) return false;
+  w.samples++;
+  s.ts   = ts;
+  s.imp  = gridW < 0 ? -gridW : 0;
+  s.exp  = gridW > 0 ? gridW : 0;
+  s.pv   = pvW > 0 ? pvW : 0;
+  const int64_t l = (int64_t)pvW - gridW - battW;
+  s.load = l > 0 ? (int32_t)l : 0;
+  s.chg  = battW > 0 ? battW : 0;
+  s.dis  = battW < 0 ? -battW : 0;
+  s.soc  = socx10 || battW ? (int32_t)socx10 : -1;
+  s.t1   = t1;
+
+  const uint32_t slot = ts / PV_PEAK_SLOT_S;
+  if (w.have && ts < w.lastTs){ pvPeakWinReset(w); w.resets++; }   // Uhr zurückgestellt
+  if (w.have){
+    // Fächer bis zum laufenden leeren (höchstens einmal rundum)
+    uint32_t k = slot - w.slot;
+    if (k > PV_PEAK_WIN_SLOTS) k = PV_PEAK_WIN_SLOTS;
+    for (uint32_t i = 1; i <= k; ++i){
+      const uint32_t j = (w.slot + i) % PV_PEAK_WIN_SLOTS;
+      w.eSum -= w.e[j]; w.covSum -= w.cov[j];
+      w.e[j] = 0; w.cov[j] = 0;
+    }
+    const uint32_t dt = ts - w.lastTs;
+    if (dt <= PV_PEAK_GAP_S){
+      const uint32_t j = slot % PV_PEAK_WIN_SLOTS;
+      const int32_t de = (w.lastImp + s.imp) * (int32_t)dt;
+      w.e[j] += de; w.eSum += de;
+      w.cov[j] = (uint16_t)(w.cov[j] + dt); w.covSum += dt;
+    } else w.gaps++;
+  }
+  w.slot = slot; w.lastTs = ts; w.lastImp = s.imp; w.have = true;
+
+  s.dem = -1;
+  if (w.covSum * 100 >= (uint32_t)PV_PEAK_WIN_SLOTS * PV_PEAK_SLOT_S * PV_PEAK_COVER_PCT)
+    s.dem = (int32_t)((w.eSum + w.covSum) / (2 * (int64_t)w.covSum));   // gerundet
+  return true;
+}
+
+// ---- STATS_PEAKS (PvStats.h): Kopf + PvPeaks ----
+#include "PvStats.h"
+static const size_t PV_PEAKS_MSG = PvWire<PayloadPeaks>::size + PV_PEAKS_WIRE;
+
+static inline size_t pvPeakMsg(uint8_t* p, int32_t day, uint8_t lvl, const PvPeaks& pk){
+  PayloadPeaks h{ day, lvl, 0, 0 };
+  const size_t n = pvWireEncode(h, p);
+  return n + pvWireEncode(pk, p + n);
+}
+static inline bool pvPeakMsgGet(const uint8_t* p, size_t len, PayloadPeaks& h, PvPeaks& pk){
+  return len >= PV_PEAKS_MSG && pvWireDecode(p, len, h) && pvWireDecode(p + PvWire<PayloadPeaks>::size, len - PvWire<PayloadPeaks>::size, pk);
+}
@@ -0,0 +1,166 @@
+// ===================== PvPeer.h =====================
+// Verlauf auch von anderen Clients. Jeder Knoten führt einen Digest über seine Tagesrecords
+// (XOR von Hashes je Tag, bei jedem Schreiben nachgeführt wie die Stufen in PvRollup.h).
+// Der Poller hängt ihn (ohne den laufenden Tag) an sein Offer; fertig abgeglichene Clients
+// antworten auf STATS_DISCOVER ebenfalls mit einem Offer (STATS_OFFER_PEER) und senden auf
+// Anfrage das Karussell (PvCarousel.h) wie der Poller.
+// Der Anfragende wählt unter den Quellen mit dem Digest des Pollers die mit der kleinsten Last
+// (bei Gleichstand Client vor Poller, dann die kleinste Adresse: gleichzeitig startende
+// Displays landen bei derselben Quelle, eine Runde reicht für alle). Antwortet der Poller
+// nicht, geht es auch ohne seinen Digest; geprüft wird dann, sobald sein Offer kommt.
+// Ohne Arduino-Abhängigkeiten: tools/pvpeer.cpp simuliert Poller und Clients.
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "PvStats.h"
+#include "PvEnergy.h"
+#include "PvRollup.h"
+
+#define PV_DIGEST_VERSION    1
+#define PV_PEER_MAX          6        // gemerkte Quellen (Poller + Clients)
+#define PV_PEER_TTL_MS       60000    // Offer so lange gültig
+#define PV_PEER_POLLER_BIAS  8        // Poller: Last-Zuschlag während einer Modbus-Runde
+
+// ---------- Digest ----------
+static inline uint64_t pvMix64(uint64_t x){
+  x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+// Hash eines Tages; leerer Record = kein Record (0), sonst ginge "fehlt" != "0 kWh"
+static inline uint64_t pvDigestDay(int32_t n, const PvEnergy& a){
+  if (pvEnergyZero(a)) return 0;
+  uint64_t h = pvMix64((uint64_t)(uint32_t)n ^ 0x9e3779b97f4a7c15ULL);
+  for (uint8_t i = 0; i < PVE_COUNT; ++i) h = pvMix64(h ^ (uint64_t)a.e[i]);
+  return h;
+}
+
+// im NVS als Blob (Key "dig")
+struct PvDigest {
+  uint8_t  ver = PV_DIGEST_VERSION;
+  uint8_t  rsv[3] = {};
+  uint32_t days = 0;      // Tage mit Record
+  int32_t  hw = 0;        // jüngster Tag mit Record
+  uint32_t rsv2 = 0;
+  uint64_t dig = 0;
+};
+
+static inline void pvDigestAdd(PvDigest& d, int32_t n, const PvEnergy& old, const PvEnergy& neu){
+  d.dig ^= pvDigestDay(n, old) ^ pvDigestDay(n, neu);
+  d.days += (uint32_t)!pvEnergyZero(neu) - (uint32_t)!pvEnergyZero(old);
+  if (!pvEnergyZero(neu) && n > d.hw) d.hw = n;
+}
+
+// Neuaufbau aus den Tagen [cur, end] (Firmware ohne Digest), stückweise aus loop()
+struct PvDigestRebuild {
+  bool     active = false;
+  int32_t  cur = 0, end = 0;
+  PvDigest acc;
+};
+
+// Tag n geschrieben: laufender Digest bzw. beim Neuaufbau dessen Summe, sofern der Tag
+// schon gelesen ist oder außerhalb liegt (den Rest liest der Neuaufbau ohnehin neu)
+static inline void pvDigestOnSave(PvDigest& d, PvDigestRebuild& rb, int32_t n, const PvEnergy& old, const PvEnergy& neu){
+  if (!rb.active){ pvDigestAdd(d, n, old, neu); return; }
+  if (n < rb.cur || n > rb.end) pvDigestAdd(rb.acc, n, old, neu);
+}
+
+static inline void pvDigestRebuildStart(PvDigestRebuild& rb, int32_t from, int32_t to){
+  rb.active = from <= to; rb.cur = from; rb.end = to; rb.acc = PvDigest();
+}
+
+// bis zu maxDays Tage; true = fertig, d = Ergebnis
+template<class S>
+static inline bool pvDigestRebuildStep(PvDigestRebuild& rb, S& s, uint16_t maxDays, PvDigest& d){
+  if (!rb.active) return true;
+  PvEnergy zero; pvEnergyClear(zero);
+  char key[12];
+  for (uint16_t k = 0; k < maxDays && rb.cur <= rb.end; ++k, ++rb.cur){
+    PvEnergy a;
+    pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, rb.cur), key, sizeof(key));
+    if (s.load(key, a)) pvDigestAdd(rb.acc, rb.cur, zero, a);
+  }
+  if (rb.cur <= rb.end) return false;
+  rb.active = false; d = rb.acc;
+  return true;
+}
+
+// Angebot: Digest ohne den laufenden Tag (der ändert sich auf jedem Gerät anders)
+static inline PayloadOfferHist pvDigestOffer(const PvDigest& d, int32_t today, const PvEnergy& todayRec, uint16_t load){
+  PvDigest x = d;
+  PvEnergy zero; pvEnergyClear(zero);
+  pvDigestAdd(x, today, todayRec, zero);
+  return { x.hw < today ? x.hw : today - 1, x.days, x.dig, load, 0 };
+}
+
+// ---------- Quellen (Client) ----------
+struct PvPeerSrc {
+  uint32_t ip = 0;
+  uint32_t seenMs = 0;
+  bool     poller = false, dead = false;
+  PayloadOfferHist h{};
+};
+
+struct PvPeerTable {
+  PvPeerSrc s[PV_PEER_MAX];
+  uint8_t   n = 0;
+  bool      pollerSeen = false, pollerHist = false;   // Offer des Pollers, mit Digest
+  PayloadOfferHist poller{};
+  bool      pollerOnly = false;                       // nach falschem Digest: nur noch vom Poller
+  // Messung
+  uint32_t  offers = 0, picks = 0, fails = 0;
+};
+
+// Offer merken (ohne Digest: älterer Poller, dann nur er)
+static inline void pvPeerOffer(PvPeerTable& t, uint32_t ip, bool poller, const PayloadOfferHist* h, uint32_t now){
+  t.offers++;
+  if (poller){ t.pollerSeen = true; t.pollerHist = h != nullptr; if (h) t.poller = *h; }
+  uint8_t k = 0;
+  while (k < t.n && t.s[k].ip != ip) k++;
+  if (k == t.n && t.n < PV_PEER_MAX) t.n++;
+  else if (k == t.n){   // voll: den ältesten Client ersetzen
+    k = 0;
+    for (uint8_t i = 0; i < t.n; ++i)
+      if (t.s[k].poller || (!t.s[i].poller && (int32_t)(t.s[i].seenMs - t.s[k].seenMs) < 0)) k = i;
+  }
+  PvPeerSrc& e = t.s[k];
+  e.ip = ip; e.seenMs = now; e.poller = poller; e.dead = false;
+  if (h) e.h = *h; else e.h = PayloadOfferHist{};
+}
+
+static inline bool pvPeerUsable(const PvPeerTable& t, const PvPeerSrc& e, uint32_t now){
+  if (e.dead || (uint32_t)(now - e.seenMs) >= PV_PEER_TTL_MS) return false;
+  if (e.poller) return true;
+  if (t.pollerOnly || (t.pollerSeen && !t.pollerHist)) return false;
+  return !t.pollerHist || (e.h.dig == t.poller.dig && e.h.days == t.poller.days);
+}
+
+// Quelle für Anfrage/NACK; 0 = keine bekannt (an alle, der Poller antwortet)
+static inline uint32_t pvPeerPick(PvPeerTable& t, uint32_t now){
+  int8_t best = -1;
+  for (uint8_t i = 0; i < t.n; ++i){
+    const PvPeerSrc& e = t.s[i];
+    if (!pvPeerUsable(t, e, now)) continue;
+    if (best >= 0){
+      const PvPeerSrc& b = t.s[best];
+      if (e.h.load != b.h.load ? e.h.load > b.h.load : e.poller != b.poller ? e.poller : e.ip > b.ip) continue;
+    }
+    best = (int8_t)i;
+  }
+  t.picks++;
+  return best < 0 ? 0 : t.s[best].ip;
+}
+
+// Quelle hat nicht geliefert; den Poller nie aufgeben
+static inline void pvPeerFail(PvPeerTable& t, uint32_t ip){
+  for (uint8_t i = 0; i < t.n; ++i) if (t.s[i].ip == ip && !t.s[i].poller){ t.s[i].dead = true; t.fails++; }
+}
+
+enum : uint8_t { PVPEER_OK = 0, PVPEER_WAIT, PVPEER_BAD };
+
+// Eigener Stand gegen den Poller: ohne sein Offer warten, ohne Digest (ältere Firmware) glauben
+static inline uint8_t pvPeerVerify(const PvPeerTable& t, const PayloadOfferHist& mine){
+  if (!t.pollerSeen) return PVPEER_WAIT;
+  if (!t.pollerHist) return PVPEER_OK;
+  return mine.dig == t.poller.dig && mine.days == t.poller.days ? PVPEER_OK : PVPEER_BAD;
+}
@@ -0,0 +1,328 @@
+// ===================== PvPoll.h =====================
+// Mehrere Wechselrichter / Units: Registertabelle, Snapshot je Gerät, Poll-Pipelines und
+// Zusammenfassung aller Geräte zum Frame.
+//
+// Eine Pipeline je Endpunkt (IP:Port = eine Modbus-TCP-Verbindung). Je Pipeline ist immer
+// höchstens eine Anfrage offen (ein Requester je Wechselrichter / SDongle); Units hinter
+// demselben SDongle teilen sich die Pipeline und werden nacheinander abgefragt.
+// Verschiedene Endpunkte laufen gleichzeitig: die Runde dauert so lange wie der langsamste
+// Endpunkt statt der Summe aller Geräte.
+//
+// Ohne Arduino-Abhängigkeiten, der Transport ist ein Template-Parameter:
+//   void request(uint8_t pipe, uint16_t tag, const PvDeviceCfg& d, uint16_t addr, uint8_t words, uint16_t* buf);
+//       Antwort (auch Fehler/Timeout) später mit poller.done(pipe, tag, ok, nowMs) melden;
+//       buf gehört bis dahin dem Transport
+// Sketch: ModbusIP (SolarDisplay.ino), Host: simulierte Latenzen (tools/pvmulti.cpp).
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "PvFrame.h"
+
+#ifndef PV_MAX_DEVICES
+  #define PV_MAX_DEVICES 4
+#endif
+
+// ---- Geräte ----
+enum : uint8_t {
+  PVD_METER = 1,   // Smart-Meter hängt an diesem Gerät: Netzleistung, Zähler, Phasen
+  PVD_BATT  = 2,   // Batterie an diesem Gerät: Leistung, SoC
+};
+
+struct PvDeviceCfg {
+  uint8_t     ip[4];
+  uint16_t    port;
+  uint8_t     unit;     // Modbus Unit-ID
+  uint8_t     flags;    // PVD_*
+  uint16_t    battWh;   // Batteriekapazität für gemittelten SoC (0 = alle gleich gewichtet)
+  const char* name;     // kurz, für Seite und Stats (max. 7 Zeichen werden übertragen)
+};
+
+// Anlage: eigene Tabelle per #define PV_DEVICES_CUSTOM "datei.h" (z.B. in Credentials.h),
+// Beispiel: tools/pvmulti_anlage.h. Sonst ein Gerät aus INVERTER_IP / MODBUS_PORT / MODBUS_UNIT.
+#ifdef PV_DEVICES_CUSTOM
+  #include PV_DEVICES_CUSTOM
+#else
+  #ifndef INVERTER_IP
+    #define INVERTER_IP 192,168,0,10
+  #endif
+  #ifndef MODBUS_PORT
+    #define MODBUS_PORT 502
+  #endif
+  #ifndef MODBUS_UNIT
+    #define MODBUS_UNIT 2
+  #endif
+  static const PvDeviceCfg PV_DEVICES[] = {
+    { {INVERTER_IP}, MODBUS_PORT, MODBUS_UNIT, PVD_METER | PVD_BATT, 0, "WR" },
+  };
+#endif
+static const uint8_t PV_DEVICE_COUNT = (uint8_t)(sizeof(PV_DEVICES) / sizeof(PV_DEVICES[0]));
+static_assert(sizeof(PV_DEVICES) / sizeof(PV_DEVICES[0]) <= PV_MAX_DEVICES, "mehr Geräte als PV_MAX_DEVICES");
+
+// ---- Register (Sun2000) ----
+enum : uint8_t {
+  PVR_PV, PVR_GRID, PVR_BATT, PVR_TEMP, PVR_PVTODAY, PVR_EXP, PVR_IMP, PVR_SOC,
+  PVR_PV1V, PVR_PV1A, PVR_PV2V, PVR_PV2A,
+  PVR_VA, PVR_VB, PVR_VC, PVR_IA, PVR_IB, PVR_IC,
+  PVR_COUNT
+};
+
+struct PvReg { uint16_t addr; uint8_t words; uint8_t need; };   // need: PVD_* des Geräts (0 = jedes)
+
+static const PvReg PV_REGS[PVR_COUNT] = {
+  { 32064, 2, 0 },           // PV AC, int32 W
+  { 37113, 2, PVD_METER },   // Netz, int32 W, +Export/-Import
+  { 37001, 2, PVD_BATT },    // Batterie, int32 W, +Laden/-Entladen
+  { 32087, 1, 0 },           // WR-Temperatur, int16 x10 °C
+  { 32114, 2, 0 },           // PV heute, uint32 kWh/100
+  { 37119, 2, PVD_METER },   // Export gesamt, uint32 kWh/100
+  { 37121, 2, PVD_METER },   // Import gesamt, uint32 kWh/100
+  { 37004, 1, PVD_BATT },    // SoC, uint16 x10
+  { 32016, 1, 0 },           // PV1 V x10
+  { 32017, 1, 0 },           // PV1 A x100
+  { 32018, 1, 0 },           // PV2 V x10
+  { 32019, 1, 0 },           // PV2 A x100
+  { 37101, 2, PVD_METER },   // Phase A V x10
+  { 37103, 2, PVD_METER },   // Phase B V x10
+  { 37105, 2, PVD_METER },   // Phase C V x10
+  { 37107, 2, PVD_METER },   // Phase A A x100 (signed)
+  { 37109, 2, PVD_METER },   // Phase B A x100
+  { 37111, 2, PVD_METER },   // Phase C A x100
+};
+
+// readyMask-Bits = Registerindex
+enum : uint32_t {
+  RM_PV = 1u << PVR_PV, RM_GRID = 1u << PVR_GRID, RM_BATT = 1u << PVR_BATT, RM_TEMP = 1u << PVR_TEMP,
+  RM_SOC = 1u << PVR_SOC,
+};
+
+static inline bool pvRegWanted(const PvDeviceCfg& d, uint8_t r){ return (PV_REGS[r].need & ~d.flags) == 0; }
+
+// Für eine gültige Runde nötig (konsistente Integration)
+static inline uint32_t pvRequiredMask(const PvDeviceCfg& d){
+  return RM_PV | ((d.flags & PVD_METER) ? RM_GRID : 0) | ((d.flags & PVD_BATT) ? RM_BATT : 0);
+}
+
+// ---- Snapshot eines Geräts (atomar übernommen, wenn vollständig) ----
+struct PvSnapshot {
+  int32_t  pvW = 0, gridW = 0, battW = 0;
+  int16_t  temp10 = 0;
+  float    pvTodayKWh = 0.0f;
+  uint16_t socx10 = 0;
+  // Strings
+  int16_t  pv1Voltage_x10_V = 0, pv1Current_x10_A = 0;
+  int16_t  pv2Voltage_x10_V = 0, pv2Current_x10_A = 0;
+  // Netz V/I
+  int32_t  gridVoltageA_x10_V = 0, gridVoltageB_x10_V = 0, gridVoltageC_x10_V = 0;
+  int32_t  gridCurrentA_x100_A = 0, gridCurrentB_x100_A = 0, gridCurrentC_x100_A = 0;
+  uint32_t expTot = 0, impTot = 0;   // Zählerstände (optional)
+  uint32_t readyMask = 0;
+};
+
+static inline int32_t  pvMk32BE(const uint16_t* w){ return (int32_t)(((uint32_t)w[0] << 16) | w[1]); }
+static inline uint32_t pvMkU32BE(const uint16_t* w){ return ((uint32_t)w[0] << 16) | w[1]; }
+
+static inline void pvDecodeReg(PvSnapshot& s, uint8_t r, const uint16_t* w){
+  switch (r){
+    case PVR_PV:      s.pvW = pvMk32BE(w); break;
+    case PVR_GRID:    s.gridW = pvMk32BE(w); break;
+    case PVR_BATT:    s.battW = pvMk32BE(w); break;
+    case PVR_TEMP:    s.temp10 = (int16_t)w[0]; break;
+    case PVR_PVTODAY: s.pvTodayKWh = pvMkU32BE(w) / 100.0f; break;
+    case PVR_EXP:     s.expTot = pvMkU32BE(w); break;
+    case PVR_IMP:     s.impTot = pvMkU32BE(w); break;
+    case PVR_SOC:     s.socx10 = w[0]; break;
+    case PVR_PV1V:    s.pv1Voltage_x10_V = (int16_t)w[0]; break;
+    case PVR_PV1A:    s.pv1Current_x10_A = (int16_t)w[0]; break;
+    case PVR_PV2V:    s.pv2Voltage_x10_V = (int16_t)w[0]; break;
+    case PVR_PV2A:    s.pv2Current_x10_A = (int16_t)w[0]; break;
+    case PVR_VA:      s.gridVoltageA_x10_V = pvMk32BE(w); break;
+    case PVR_VB:      s.gridVoltageB_x10_V = pvMk32BE(w); break;
+    case PVR_VC:      s.gridVoltageC_x10_V = pvMk32BE(w); break;
+    case PVR_IA:      s.gridCurrentA_x100_A = pvMk32BE(w); break;
+    case PVR_IB:      s.gridCurrentB_x100_A = pvMk32BE(w); break;
+    case PVR_IC:      s.gridCurrentC_x100_A = pvMk32BE(w); break;
+    default: return;
+  }
+  s.readyMask |= 1u << r;
+}
+
+// ---- Zustand je Gerät ----
+struct PvDevState {
+  PvSnapshot stage, live;
+  bool       valid = false;     // live enthält einen vollständigen Snapshot
+  uint32_t   liveMs = 0;        // Zeitpunkt von live
+  uint32_t   t0 = 0, cycleMs = 0;                 // Dauer der letzten Abfrage dieses Geräts
+  uint32_t   ok = 0, fails = 0, errors = 0, timeouts = 0;   // Runden ok/unvollständig, Fehlantworten, Rundenabbrüche
+};
+
+// ---- Pipeline je Endpunkt ----
+struct PvPipe {
+  uint8_t  dev[PV_MAX_DEVICES];   // Geräte an diesem Endpunkt (Index in PV_DEVICES)
+  uint8_t  n = 0;
+  uint8_t  cur = 0, reg = 0;      // Position in der laufenden Runde
+  bool     busy = false;          // Anfrage offen (auch über einen Rundenabbruch hinaus)
+  bool     orphan = false;        // offene Anfrage gehört zu einer abgebrochenen Runde
+  bool     done = true;           // Runde für diese Pipeline abgeschlossen
+  uint16_t tag = 0;               // Kennung der offenen Anfrage
+  uint32_t reqMs = 0;
+  uint16_t buf[2];
+};
+
+template<class Tx>
+struct PvPoller {
+  Tx*                tx = nullptr;
+  const PvDeviceCfg* cfg = nullptr;
+  uint8_t            nDev = 0, nPipe = 0;
+  PvDevState         dev[PV_MAX_DEVICES];
+  PvPipe             pipe[PV_MAX_DEVICES];
+  bool               active = false;
+  uint32_t           roundT0 = 0, roundMs = 0, rounds = 0;
+  uint32_t           timeoutMs = 8000;   // ganze Runde
+
+  // Geräte nach Endpunkt gruppieren
+  void begin(Tx* t, const PvDeviceCfg* c, uint8_t n){
+    tx = t; cfg = c; nDev = n; nPipe = 0;
+    for (uint8_t i = 0; i < n; ++i){
+      uint8_t p = 0;
+      for (; p < nPipe; ++p){
+        const PvDeviceCfg& o = c[pipe[p].dev[0]];
+        if (!memcmp(o.ip, c[i].ip, 4) && o.port == c[i].port) break;
+      }
+      if (p == nPipe){ pipe[p] = PvPipe{}; nPipe++; }
+      pipe[p].dev[pipe[p].n++] = i;
+    }
+  }
+
+  // Neue Runde; false, solange die vorige läuft
+  bool start(uint32_t now){
+    if (active) return false;
+    active = true; roundT0 = now;
+    for (uint8_t p = 0; p < nPipe; ++p){
+      PvPipe& q = pipe[p];
+      q.cur = 0; q.reg = 0; q.done = false;
+      for (uint8_t k = 0; k < q.n; ++k) dev[q.dev[k]].stage = PvSnapshot{};
+      dev[q.dev[0]].t0 = now;
+    }
+    return true;
+  }
+
+  // Aus loop(): nächste Anfragen stellen, Runden-Timeout. Nie aus einem Transport-Callback.
+  void tick(uint32_t now){
+    for (uint8_t p = 0; p < nPipe; ++p){
+      PvPipe& q = pipe[p];
+      // Transport meldet sich nie (sollte nicht vorkommen): Pipeline wieder freigeben
+      if (q.busy && now - q.reqMs >= 2 * timeoutMs){ q.busy = false; q.orphan = false; q.tag++; }
+    }
+    if (!active) return;
+    if (now - roundT0 >= timeoutMs){
+      for (uint8_t p = 0; p < nPipe; ++p){
+        PvPipe& q = pipe[p];
+        if (q.done) continue;
+        for (uint8_t k = q.cur; k < q.n; ++k){ dev[q.dev[k]].timeouts++; dev[q.dev[k]].fails++; }
+        q.done = true;
+        if (q.busy) q.orphan = true;   // Antwort abwarten, aber verwerfen (nie zwei Anfragen offen)
+      }
+    }
+    for (uint8_t p = 0; p < nPipe; ++p) issue(p, now);
+  }
+
+  // Antwort des Transports (ok = Daten in pipe[p].buf)
+  void done(uint8_t p, uint16_t tag, bool ok, uint32_t now){
+    if (p >= nPipe) return;
+    PvPipe& q = pipe[p];
+    if (!q.busy || tag != q.tag) return;
+    q.busy = false;
+    if (q.orphan){ q.orphan = false; return; }   // gehört zur abgebrochenen Runde
+    if (q.done) return;
+    PvDevState& s = dev[q.dev[q.cur]];
+    if (ok) pvDecodeReg(s.stage, q.reg, q.buf);
+    else    s.errors++;
+    q.reg++;
+    (void)now;
+  }
+
+  // true genau einmal je Runde, wenn alle Pipelines fertig sind
+  bool finished(uint32_t now){
+    if (!active) return false;
+    for (uint8_t p = 0; p < nPipe; ++p) if (!pipe[p].done) return false;
+    active = false; rounds++; roundMs = now - roundT0;
+    return true;
+  }
+
+  // Runde abbrechen (Rolle abgegeben, PvElect.h): keine weiteren Anfragen, offene Antworten
+  // verwerfen; zählt nicht als Runde
+  void abort(){
+    if (!active) return;
+    for (uint8_t p = 0; p < nPipe; ++p){
+      PvPipe& q = pipe[p];
+      q.done = true;
+      if (q.busy) q.orphan = true;
+    }
+    active = false;
+  }
+
+  bool fresh(uint8_t i, uint32_t now, uint32_t maxAgeMs) const {
+    return dev[i].valid && now - dev[i].liveMs <= maxAgeMs;
+  }
+
+private:
+  void issue(uint8_t p, uint32_t now){
+    PvPipe& q = pipe[p];
+    if (q.busy || q.done) return;
+    while (q.cur < q.n){
+      uint8_t i = q.dev[q.cur];
+      while (q.reg < PVR_COUNT && !pvRegWanted(cfg[i], q.reg)) q.reg++;
+      if (q.reg < PVR_COUNT){
+        q.busy = true; q.tag++; q.reqMs = now;
+        tx->request(p, q.tag, cfg[i], PV_REGS[q.reg].addr, PV_REGS[q.reg].words, q.buf);
+        return;
+      }
+      // Gerät fertig: vollständig -> atomar übernehmen
+      PvDevState& s = dev[i];
+      uint32_t need = pvRequiredMask(cfg[i]);
+      if ((s.stage.readyMask & need) == need){ s.live = s.stage; s.valid = true; s.liveMs = now; s.ok++; }
+      else s.fails++;
+      s.cycleMs = now - s.t0;
+      q.cur++; q.reg = 0;
+      if (q.cur < q.n) dev[q.dev[q.cur]].t0 = now;
+    }
+    q.done = true;
+  }
+};
+
+// ---- Zusammenfassung zum Frame ----
+// PV, Batterie: Summe; Netz, Zähler, Phasen: vom Meter-Gerät; SoC: nach Kapazität gemittelt;
+// Temperatur: Maximum; Strings PV1/PV2: erstes Gerät (alle Strings auf der Anlagen-Seite).
+// Geräte ohne frischen Snapshot (älter als maxAgeMs) zählen nicht. Liefert false ohne
+// frische Daten vom Meter-Gerät (sonst wäre die Lastberechnung falsch).
+template<class Tx>
+static inline bool pvAggregate(const PvPoller<Tx>& pl, uint32_t now, uint32_t maxAgeMs, PvFrameV4& f){
+  int8_t meter = -1;
+  for (uint8_t i = 0; i < pl.nDev; ++i) if (pl.cfg[i].flags & PVD_METER){ meter = (int8_t)i; break; }
+  if (meter < 0 || !pl.fresh((uint8_t)meter, now, maxAgeMs)) return false;
+
+  int32_t pvW = 0, battW = 0; int16_t temp = INT16_MIN;
+  uint64_t socSum = 0, socW = 0; bool strings = false;
+  for (uint8_t i = 0; i < pl.nDev; ++i){
+    if (!pl.fresh(i, now, maxAgeMs)) continue;
+    const PvSnapshot& s = pl.dev[i].live;
+    pvW += s.pvW;
+    if (s.readyMask & RM_TEMP && s.temp10 > temp) temp = s.temp10;
+    if (pl.cfg[i].flags & PVD_BATT){
+      battW += s.battW;
+      if (s.readyMask & RM_SOC){ uint32_t w = pl.cfg[i].battWh ? pl.cfg[i].battWh : 1; socSum += (uint64_t)s.socx10 * w; socW += w; }
+    }
+    if (!strings){
+      strings = true;
+      f.pv1Voltage_x10_V = s.pv1Voltage_x10_V; f.pv1Current_x10_A = s.pv1Current_x10_A;
+      f.pv2Voltage_x10_V = s.pv2Voltage_x10_V; f.pv2Current_x10_A = s.pv2Current_x10_A;
+    }
+  }
+  const PvSnapshot& m = pl.dev[meter].live;
+  f.pvW = pvW; f.battW = battW; f.gridW = m.gridW;
+  f.temp10 = temp == INT16_MIN ? 0 : temp;
+  f.socx10 = socW ? (uint16_t)((socSum + socW / 2) / socW) : 0;
+  f.gridVoltageA_x10_V = m.gridVoltageA_x10_V; f.gridVoltageB_x10_V = m.gridVoltageB_x10_V; f.gridVoltageC_x10_V = m.gridVoltageC_x10_V;
+  f.gridCurrentA_x100_A = m.gridCurrentA_x100_A; f.gridCurrentB_x100_A = m.gridCurrentB_x100_A; f.gridCurrentC_x100_A = m.gridCurrentC_x100_A;
+  return true;
+}
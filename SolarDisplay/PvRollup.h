@@ -0,0 +1,257 @@
+// ===================== PvRollup.h =====================
+// Verlauf in Stufen: Tag -> ISO-Woche -> Monat -> Jahr. Jede Stufe ist ein eigener
+// NVS-Record (PvEnergy.h, v3 wie die Tage): DJJJJMMTT, WJJJJWW (ISO-Jahr/-Woche), MJJJJMM, YJJJJ.
+// Wird ein Tag geschrieben (Tageswechsel, Sync vom Poller, Boot-Cache), geht die Differenz
+// zum bisherigen Tagesrecord in Woche, Monat und Jahr: O(1) je Tag, auch beim Überschreiben,
+// und jede Stufe bleibt die Summe der gespeicherten Tage. Die Seiten lesen nur die Stufe,
+// die sie zeigen (30 Tage, 26 Wochen, 12 Monate, 10 Jahre), nie hunderte Tages-Keys.
+// Die Spitzen (PvPeak.h) gehen mit: jede Stufe hält die größten ihrer Tage.
+// Ältere Firmware hat nur D/M-Keys: einmaliger Neuaufbau aus den Tagen, stückweise aus loop().
+// Ohne Arduino-Abhängigkeiten: tools/pvrollup.cpp prüft und misst damit.
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include "PvEnergy.h"
+
+#ifndef PV_ROLLUP_YEARS
+  #define PV_ROLLUP_YEARS   10    // Neuaufbau: so viele Jahre vor dem laufenden aus den Tagen
+#endif
+#define PV_ROLLUP_VERSION   1     // NVS "rollup": Stufen aufgebaut (sonst Neuaufbau)
+#define PV_ROLLUP_STEP_DAYS 8     // Neuaufbau: Tage je Aufruf
+
+enum : uint8_t { PVL_DAY = 0, PVL_WEEK, PVL_MONTH, PVL_YEAR, PVL_COUNT };
+
+// ---- Kalender über Tagesnummern (Tage seit 1970-01-01, proleptisch gregorianisch) ----
+static inline int32_t pvDayNum(int y, int m, int d){
+  y -= m <= 2;
+  const int32_t era = (y >= 0 ? y : y - 399) / 400;
+  const int32_t yoe = y - era * 400;
+  const int32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
+static inline void pvDayCivil(int32_t n, int& y, int& m, int& d){
+  n += 719468;
+  const int32_t era = (n >= 0 ? n : n - 146096) / 146097;
+  const int32_t doe = n - era * 146097;
+  const int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int32_t mp = (5 * doy + 2) / 153;
+  d = (int)(doy - (153 * mp + 2) / 5 + 1);
+  m = (int)(mp < 10 ? mp + 3 : mp - 9);
+  y = (int)(yoe + era * 400 + (m <= 2));
+}
+
+static inline uint8_t pvDayIsoWd(int32_t n){ return (uint8_t)(((n + 3) % 7 + 7) % 7); }   // 0 = Mo (1970-01-01 war Do)
+
+// Montag der ISO-Woche 1 (enthält den 4. Januar)
+static inline int32_t pvIsoWeek1(int isoY){
+  const int32_t j4 = pvDayNum(isoY, 1, 4);
+  return j4 - pvDayIsoWd(j4);
+}
+
+static inline void pvIsoWeek(int32_t n, int& isoY, int& wk){
+  int y, m, d;
+  pvDayCivil(n - pvDayIsoWd(n) + 3, y, m, d);   // Donnerstag derselben Woche bestimmt das Jahr
+  isoY = y;
+  wk = (int)((n - pvIsoWeek1(y)) / 7 + 1);
+}
+
+// ---- Perioden-IDs je Stufe: Tag JJJJMMTT, Woche JJJJWW, Monat JJJJMM, Jahr JJJJ ----
+static inline uint32_t pvRollupId(uint8_t lvl, int32_t n){
+  int y, m, d;
+  if (lvl == PVL_WEEK){ pvIsoWeek(n, y, m); return (uint32_t)(y * 100 + m); }
+  pvDayCivil(n, y, m, d);
+  switch (lvl){
+    case PVL_DAY:   return (uint32_t)(y * 10000 + m * 100 + d);
+    case PVL_MONTH: return (uint32_t)(y * 100 + m);
+    default:        return (uint32_t)y;
+  }
+}
+
+// erster Tag der Periode
+static inline int32_t pvRollupStart(uint8_t lvl, uint32_t id){
+  switch (lvl){
+    case PVL_DAY:   return pvDayNum((int)(id / 10000), (int)(id / 100 % 100), (int)(id % 100));
+    case PVL_WEEK:  return pvIsoWeek1((int)(id / 100)) + (int32_t)(id % 100 - 1) * 7;
+    case PVL_MONTH: return pvDayNum((int)(id / 100), (int)(id % 100), 1);
+    default:        return pvDayNum((int)id, 1, 1);
+  }
+}
+
+// k Perioden weiter (k < 0: zurück)
+static inline uint32_t pvRollupStep(uint8_t lvl, uint32_t id, int32_t k){
+  switch (lvl){
+    case PVL_DAY:  return pvRollupId(lvl, pvRollupStart(lvl, id) + k);
+    case PVL_WEEK: return pvRollupId(lvl, pvRollupStart(lvl, id) + 7 * k);
+    case PVL_MONTH:{
+      int32_t mm = (int32_t)(id / 100) * 12 + (int32_t)(id % 100 - 1) + k;
+      return (uint32_t)((mm / 12) * 100 + mm % 12 + 1);
+    }
+    default: return (uint32_t)((int32_t)id + k);
+  }
+}
+
+static inline void pvRollupKey(uint8_t lvl, uint32_t id, char* out, size_t len){
+  static const char pre[PVL_COUNT] = { 'D', 'W', 'M', 'Y' };
+  snprintf(out, len, lvl == PVL_DAY ? "%c%08lu" : lvl == PVL_YEAR ? "%c%04lu" : "%c%06lu",
+           pre[lvl < PVL_COUNT ? lvl : PVL_YEAR], (unsigned long)id);
+}
+
+static inline bool pvEnergyZero(const PvEnergy& a){
+  for (uint8_t i = 0; i < PVE_COUNT; ++i) if (a.e[i]) return false;
+  return true;
+}
+
+// ---- Speicher: load(key, a) (fehlt -> a = 0, false), save(key, a) ----
+// Über Preferences (NVS im Sketch, Speicher-Map in tools/pvhost.h). PvEnergy: nur die Kanäle,
+// PvAgg: mit Spitzen. Speicher nur mit PvEnergy (Zähler in den Tools) lassen die Spitzen leer.
+template<class P>
+struct PvRollupPrefs {
+  P& p;
+  bool load(const char* key, PvAgg& a){
+    uint8_t b[PV_EREC_MAX]; size_t n = p.getBytesLength(key);
+    if (n == 0 || n > sizeof(b) || p.getBytes(key, b, n) != n){ pvAggClear(a); return false; }
+    return pvAggDecode(b, n, a);
+  }
+  bool load(const char* key, PvEnergy& a){
+    PvAgg t; const bool ok = load(key, t);
+    a = t;
+    return ok;
+  }
+  void save(const char* key, const PvAgg& a){
+    uint8_t b[PV_EREC_MAX];
+    p.putBytes(key, b, pvAggEncode(a, b));
+  }
+  void save(const char* key, const PvEnergy& a){
+    PvEnergyRec r; pvEnergyEncode(a, r);
+    p.putBytes(key, &r, sizeof(r));
+  }
+};
+
+// ---- Stufen nachführen ----
+struct PvRollup {
+  // Neuaufbau aus den Tagen [cur, end]: je Stufe die laufende Periode im RAM, geschrieben
+  // wird sie beim Periodenwechsel (nur wenn ab ihrem ersten Tag gezählt, sonst wäre sie unvollständig)
+  bool     rebuilding = false;
+  int32_t  cur = 0, end = 0;
+  uint32_t id[PVL_COUNT] = {};
+  bool     full[PVL_COUNT] = {};
+  PvAgg    acc[PVL_COUNT] = {};
+  // Messung
+  uint32_t days = 0, writes = 0, rebuilt = 0;
+};
+
+// Tagesrecord n hat von 'old' auf 'neu' gewechselt (fehlte er, ist old = 0)
+template<class S>
+static inline void pvRollupDay(PvRollup& r, S& s, int32_t n, const PvAgg& old, const PvAgg& neu){
+  PvAgg dlt;
+  for (uint8_t i = 0; i < PVE_COUNT; ++i) dlt.e[i] = neu.e[i] - old.e[i];
+  dlt.pk = neu.pk; dlt.pk.n = neu.pk.n - old.pk.n;   // Samples wie die Energie als Differenz (modulo 2^32)
+  r.days++;
+  if (pvEnergyZero(dlt) && pvPeakSame(old.pk, neu.pk)) return;
+  char key[12];
+  for (uint8_t lvl = PVL_WEEK; lvl < PVL_COUNT; ++lvl){
+    const uint32_t id = pvRollupId(lvl, n);
+    // Neuaufbau hat den Tag schon gelesen und die Periode noch im RAM: dort nachtragen
+    // (spätere Tage liest er ohnehin neu, fertige Perioden stehen schon im NVS)
+    if (r.rebuilding && n < r.cur && id == r.id[lvl]){ pvAggAdd(r.acc[lvl], dlt); continue; }
+    PvAgg a; pvAggClear(a);
+    pvRollupKey(lvl, id, key, sizeof(key));
+    s.load(key, a);
+    pvAggAdd(a, dlt);
+    s.save(key, a);
+    r.writes++;
+  }
+}
+
+// nur Energie (Geräte ohne Spitzen, Tools)
+template<class S>
+static inline void pvRollupDay(PvRollup& r, S& s, int32_t n, const PvEnergy& old, const PvEnergy& neu){
+  PvAgg o, x; pvAggClear(o); pvAggClear(x);
+  static_cast<PvEnergy&>(o) = old; static_cast<PvEnergy&>(x) = neu;
+  pvRollupDay(r, s, n, o, x);
+}
+
+static inline void pvRollupRebuildStart(PvRollup& r, int32_t from, int32_t to){
+  r.rebuilding = from <= to; r.cur = from; r.end = to; r.rebuilt = 0;
+  for (uint8_t lvl = PVL_WEEK; lvl < PVL_COUNT; ++lvl){
+    r.id[lvl] = pvRollupId(lvl, from);
+    r.full[lvl] = pvRollupStart(lvl, r.id[lvl]) == from;
+    pvAggClear(r.acc[lvl]);
+  }
+}
+
+template<class S>
+static inline void pvRollupFlush(PvRollup& r, S& s, uint8_t lvl){
+  if (!r.full[lvl]) return;
+  char key[12]; pvRollupKey(lvl, r.id[lvl], key, sizeof(key));
+  s.save(key, r.acc[lvl]);
+  r.writes++;
+}
+
+// bis zu maxDays Tage verarbeiten; true = fertig
+template<class S>
+static inline bool pvRollupRebuildStep(PvRollup& r, S& s, uint16_t maxDays){
+  if (!r.rebuilding) return true;
+  char key[12];
+  for (uint16_t k = 0; k < maxDays && r.cur <= r.end; ++k, ++r.cur){
+    PvAgg a; pvAggClear(a);
+    pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, r.cur), key, sizeof(key));
+    bool have = s.load(key, a);
+    for (uint8_t lvl = PVL_WEEK; lvl < PVL_COUNT; ++lvl){
+      const uint32_t id = pvRollupId(lvl, r.cur);
+      if (id != r.id[lvl]){
+        pvRollupFlush(r, s, lvl);
+        r.id[lvl] = id; r.full[lvl] = true; pvAggClear(r.acc[lvl]);
+      }
+      if (have) pvAggAdd(r.acc[lvl], a);
+    }
+    r.rebuilt++;
+  }
+  if (r.cur <= r.end) return false;
+  for (uint8_t lvl = PVL_WEEK; lvl < PVL_COUNT; ++lvl) pvRollupFlush(r, s, lvl);   // laufende Perioden bis heute
+  r.rebuilding = false;
+  return true;
+}
+
+// ---- Abfragen ----
+// n Perioden der Stufe, die letzte ist lastId; out/ids alt -> neu. Liefert die Anzahl vorhandener Records.
+template<class S>
+static inline uint16_t pvRollupRange(S& s, uint8_t lvl, uint32_t lastId, uint16_t n, PvEnergy* out, uint32_t* ids){
+  uint16_t got = 0;
+  char key[12];
+  uint32_t id = pvRollupStep(lvl, lastId, -(int32_t)n + 1);
+  for (uint16_t i = 0; i < n; ++i, id = pvRollupStep(lvl, id, 1)){
+    if (ids) ids[i] = id;
+    pvRollupKey(lvl, id, key, sizeof(key));
+    if (s.load(key, out[i])) got++;
+  }
+  return got;
+}
+
+// Summe über die Tage [from, to]: Ränder in Tagen, dazwischen ganze Monate und Jahre
+// (Wochen liegen quer zu den Monaten). Liefert die Anzahl gelesener Records.
+template<class S>
+static inline uint32_t pvRollupSum(S& s, int32_t from, int32_t to, PvEnergy& sum){
+  pvEnergyClear(sum);
+  uint32_t reads = 0;
+  char key[12];
+  auto add = [&](uint8_t lvl, uint32_t id){
+    PvEnergy a; pvRollupKey(lvl, id, key, sizeof(key));
+    if (s.load(key, a)) pvEnergyAdd(sum, a);
+    reads++;
+  };
+  int32_t n = from;
+  while (n <= to){
+    const uint32_t y = pvRollupId(PVL_YEAR, n), mo = pvRollupId(PVL_MONTH, n);
+    if (n == pvRollupStart(PVL_YEAR, y) && pvRollupStart(PVL_YEAR, y + 1) - 1 <= to){
+      add(PVL_YEAR, y); n = pvRollupStart(PVL_YEAR, y + 1);
+    } else if (n == pvRollupStart(PVL_MONTH, mo) && pvRollupStart(PVL_MONTH, pvRollupStep(PVL_MONTH, mo, 1)) - 1 <= to){
+      add(PVL_MONTH, mo); n = pvRollupStart(PVL_MONTH, pvRollupStep(PVL_MONTH, mo, 1));
+    } else {
+      add(PVL_DAY, pvRollupId(PVL_DAY, n)); n++;
+    }
+  }
+  return reads;
+}
@@ -0,0 +1,101 @@
+// ===================== PvRx.h =====================
+// Empfangsprüfung für Frames und Stats-Pakete (Client-Kern).
+// Ohne Arduino-Abhängigkeiten: wird auch von tools/pvgen.cpp und tools/pvrec.cpp benutzt.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PvFrame.h"
+#include "PvStats.h"
+
+// ---- Parameter ----
+#ifndef PVRX_REORDER_WINDOW
+  #define PVRX_REORDER_WINDOW 16      // kleinerer Rücksprung = Duplikat/Umordnung
+#endif
+#ifndef PVRX_STALE_MS
+  #define PVRX_STALE_MS 90000         // ohne gültigen Frame (3 Poll-Intervalle) -> jede Quelle annehmen
+#endif
+
+// ---- Gründe ----
+enum : uint8_t {
+  PVRX_OK = 0,      // angenommen
+  PVRX_RESTART,     // angenommen: Poller-Neustart (seq neu ab 1) erkannt
+  PVRX_SHORT,       // Paket zu kurz
+  PVRX_MAGIC,       // Magic/Version falsch
+  PVRX_CRC,         // CRC falsch
+  PVRX_DUP,         // gleiche seq wie zuletzt
+  PVRX_OLD,         // kleinere seq (Umordnung / verspätet)
+  PVRX_FOREIGN,     // anderer Poller, während die aktuelle Quelle lebt
+  PVRX_COUNT
+};
+
+static inline const char* pvRxReasonName(uint8_t r){
+  static const char* n[PVRX_COUNT] = {"ok","restart","short","magic","crc","dup","old","foreign"};
+  return r < PVRX_COUNT ? n[r] : "?";
+}
+static inline bool pvRxAccepted(uint8_t r){ return r == PVRX_OK || r == PVRX_RESTART; }
+
+struct PvRxState {
+  uint32_t lastSeq  = 0;
+  uint32_t lastTs   = 0;      // Frame-ts (s) des letzten angenommenen Frames
+  uint32_t lastRxMs = 0;      // lokale Zeit der letzten Annahme
+  uint32_t src      = 0;      // Quelladresse der aktuellen Quelle (0 = keine)
+  uint32_t term     = 0;      // Amtszeit der aktuellen Quelle (PvElect.h, 0 = ohne)
+  bool     have     = false;
+  // Messung
+  uint32_t cnt[PVRX_COUNT] = {0};
+  uint32_t usSum = 0, usMax = 0, pkts = 0, takeovers = 0;
+};
+
+// Frame prüfen; bei Annahme nach 'out' kopieren und Zustand fortschreiben.
+// src: Absenderadresse (z.B. IPAddress als uint32), nowMs: millis()
+// Magic/Version/CRC werden direkt auf den Paketbytes geprüft, erst ein gültiges Paket wird
+// (einmal, Feld für Feld) in die ausgerichtete Struktur dekodiert.
+static inline uint8_t pvRxFrame(PvRxState& s, const uint8_t* data, size_t len, uint32_t src, uint32_t nowMs, PvFrameV4& out){
+  uint8_t r;
+  PvFrameV4 f;
+  bool stale = !s.have || (uint32_t)(nowMs - s.lastRxMs) > PVRX_STALE_MS;
+  if (len < PV_FRAME_WIRE) r = PVRX_SHORT;
+  else if (pvWireU16(data) != PV_MAGIC || data[2] != PV_VERSION)     r = PVRX_MAGIC;
+  else if (crc16_modbus(data, PV_FRAME_WIRE-2) != pvWireU16(data + PV_FRAME_WIRE-2)) r = PVRX_CRC;
+  else {
+    PvWire<PvFrameV4>::get(f, data);
+    if (!stale && src != s.src)                                        r = PVRX_FOREIGN;
+    // weit voraus, aber zeitlich älter: verspäteter Frame von vor einem Poller-Neustart
+    else if (!stale && f.seq - s.lastSeq > PVRX_REORDER_WINDOW && f.seq > s.lastSeq && f.ts < s.lastTs) r = PVRX_OLD;
+    else if (stale || f.seq > s.lastSeq)                               r = (stale && s.have && f.seq <= s.lastSeq) ? PVRX_RESTART : PVRX_OK;
+    else if (f.seq == s.lastSeq)                                       r = PVRX_DUP;
+    // Rücksprung: weit zurück oder zeitlich neuer -> Neustart des Pollers, sonst Umordnung
+    else if (s.lastSeq - f.seq > PVRX_REORDER_WINDOW || f.ts > s.lastTs) r = PVRX_RESTART;
+    else                                                               r = PVRX_OLD;
+  }
+  s.cnt[r]++;
+  if (pvRxAccepted(r)){
+    s.lastSeq = f.seq; s.lastTs = f.ts; s.lastRxMs = nowMs; s.src = src; s.have = true;
+    out = f;
+  }
+  return r;
+}
+
+// Frame einer anderen Quelle (PVRX_FOREIGN) mit höherer Amtszeit (PvElect.h): Nachfolger nach
+// einer Wahl, ab sofort die Quelle; danach pvRxFrame() noch einmal
+static inline bool pvRxTakeover(PvRxState& s, uint32_t src, uint32_t term){
+  if (!s.have || term <= s.term) return false;
+  s.cnt[PVRX_FOREIGN]--; s.takeovers++;
+  s.src = src; s.term = term;
+  return true;
+}
+
+// Stats-Paket prüfen (Kopf, Länge, CRC). Liefert PVRX_OK / SHORT / MAGIC / CRC.
+static inline uint8_t pvRxStats(const uint8_t* data, size_t len, StatsHdr& h){
+  if (!pvWireDecode(data, len, h)) return PVRX_SHORT;
+  if (h.magic != 0xCAFE || h.version != 1) return PVRX_MAGIC;
+  if (STATS_HDR_WIRE + h.len > len) return PVRX_SHORT;
+  if (pvstats_crc(h, data + STATS_HDR_WIRE) != h.crc) return PVRX_CRC;
+  return PVRX_OK;
+}
+
+// Verarbeitungszeit eines Pakets verbuchen
+static inline void pvRxTime(PvRxState& s, uint32_t us){
+  s.pkts++; s.usSum += us; if (us > s.usMax) s.usMax = us;
+}
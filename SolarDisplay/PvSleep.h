@@ -0,0 +1,215 @@
+// ===================== PvSleep.h =====================
+// Strom sparen auf den Clients: Funk nach dem Frame-Plan des Pollers und gedimmtes Backlight.
+//
+// Frames kommen im Takt der Poll-Runden. Der Poller hängt an jeden Frame, wann frühestens der
+// nächste kommt (Start der nächsten Runde + kürzeste Rundendauer zuletzt) und wie viel später
+// er kommen kann (Timeout bzw. längste Runde zuletzt + Raster des Starts). Der Client hält das
+// WLAN bis kurz vor dem frühesten Zeitpunkt im Modem-Sleep (WIFI_PS_MAX_MODEM), dazu die CPU
+// langsamer, und ist dann wach bis kurz nach dem Frame (STATS_DEVICES/PEAKS folgen direkt).
+// Bleibt ein Frame bis zum spätesten Zeitpunkt aus (verloren, Runde ohne Daten), gilt der Plan
+// einen Takt später weiter; bleibt auch der aus (Poller weg oder neu gestartet), ist der Funk
+// an bis zum nächsten Frame. Eine Lücke in f->seq (Frame verschlafen) zieht das Fenster früher
+// auf, das baut sich je sauberem Frame langsam wieder ab. Solange Start, Abgleich, Karussell
+// oder Nachfragen laufen, ist der Funk immer an.
+// Verschlafene Frames holt PvFill.h nach (Energie bitgleich), nur die Anzeige ist eine Runde alt.
+//
+// Backlight per PWM: nach Tageszeit (Nacht gedimmt, Rampen morgens/abends) bzw. nach
+// Umgebungslicht (LDR, optional), nach Berührung für eine Weile voll.
+// Ohne Arduino-Abhängigkeiten: tools/pvsleep.cpp simuliert Poller und Client mit eigener Uhr
+// (Funk-Anteil, verschlafene Frames).
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "PvWire.h"
+#include "PvFrame.h"
+
+#define PV_SLEEP_GUARD_MS     300     // vor dem frühesten Zeitpunkt wach
+#define PV_SLEEP_TAIL_MS      400     // nach einem Frame wach (Stats-Nachrichten der Runde)
+#define PV_SLEEP_LATE_MS      1000    // nach dem spätesten Zeitpunkt noch warten, dann: Frame fehlt
+#define PV_SLEEP_MISSES       2       // so viele Fenster ohne Frame nacheinander: Funk an
+#define PV_SLEEP_MIN_MS       500     // kürzere Pausen: Funk an lassen
+#define PV_SLEEP_EXTRA_MAX_MS 5000    // Fenster höchstens so weit vorgezogen (Lücken in seq)
+#define PV_SLEEP_EXTRA_DECAY  20      // ... je sauberem Frame ms weniger
+#define PV_SLEEP_LOOP_MS      20      // loop()-Pause bei schlafendem Funk (sonst 5 ms)
+#define PV_SLEEP_TOUCH_MS     15000   // nach Berührung volle CPU (Seitenwechsel zeichnen)
+
+// ---- Anhang am Frame ----
+// Hinter dem Batterie-Anhang (PvBatt.h). Zeiten relativ zum Senden: keine gemeinsame Uhr nötig.
+#define PV_SCHED_MAGIC 0x4353   // "SC"
+#define PV_FRAME_SCHED_FIELDS(F, A) \
+  F(uint16_t, magic)     /* PV_SCHED_MAGIC */ \
+  F(uint32_t, nextMs)    /* ms ab diesem Frame bis frühestens zum nächsten */ \
+  F(uint16_t, spreadMs)  /* so viel später kann er kommen */ \
+  F(uint32_t, periodMs)  /* Takt der Runden */ \
+  F(uint16_t, crc)       /* CRC-16 (Modbus) über den Anhang bis vor 'crc' */
+PV_WIRE_MESSAGE(PvFrameSched, PV_FRAME_SCHED_FIELDS)
+static const size_t PV_SCHED_WIRE = PvWire<PvFrameSched>::size;
+static_assert(PV_SCHED_WIRE == 14, "Plan-Anhang: Drahtformat");
+
+struct PvSched { uint32_t nextMs, spreadMs, periodMs; };
+
+static inline size_t pvSchedSeal(uint8_t* p, const PvSched& s){
+  PvFrameSched t{ PV_SCHED_MAGIC, s.nextMs, (uint16_t)(s.spreadMs > 0xFFFF ? 0xFFFF : s.spreadMs), s.periodMs, 0 };
+  pvWireEncode(t, p);
+  t.crc = crc16_modbus(p, PV_SCHED_WIRE - 2);
+  p[PV_SCHED_WIRE - 2] = (uint8_t)t.crc; p[PV_SCHED_WIRE - 1] = (uint8_t)(t.crc >> 8);
+  return PV_SCHED_WIRE;
+}
+
+// Anhang ab 'at' prüfen
+static inline bool pvSchedGet(const uint8_t* data, size_t len, size_t at, PvSched& s){
+  PvFrameSched t;
+  if (!pvWireDecode(data + at, len < at ? 0 : len - at, t)) return false;
+  if (t.magic != PV_SCHED_MAGIC || t.crc != crc16_modbus(data + at, PV_SCHED_WIRE - 2) || !t.periodMs) return false;
+  s.nextMs = t.nextMs; s.spreadMs = t.spreadMs; s.periodMs = t.periodMs;
+  return true;
+}
+
+// ---- Poller: Dauer der letzten Runden -> Plan ----
+#define PV_SCHED_ROUNDS 16
+
+struct PvSchedTx {
+  uint32_t dur[PV_SCHED_ROUNDS];
+  uint8_t  n = 0, i = 0;
+};
+
+// Runde fertig (auch ohne gültige Daten): Dauer ab Start
+static inline void pvSchedRound(PvSchedTx& t, uint32_t durMs){
+  t.dur[t.i] = durMs; t.i = (uint8_t)((t.i + 1) % PV_SCHED_ROUNDS);
+  if (t.n < PV_SCHED_ROUNDS) t.n++;
+}
+
+// Plan für einen Frame, gesendet um nowMs in der Runde ab startMs; der nächste Start kommt
+// periodMs nach startMs, bis zu tickMs später (Raster der loop()-Abfrage). Spätestens: die
+// Runde läuft höchstens bis zu ihrem Timeout (maxMs) bzw. so lange wie die längste zuletzt
+static inline PvSched pvSchedNext(const PvSchedTx& t, uint32_t startMs, uint32_t periodMs, uint32_t tickMs,
+                                  uint32_t maxMs, uint32_t nowMs){
+  uint32_t lo = 0, hi = maxMs;
+  for (uint8_t k = 0; k < t.n; ++k){
+    if (!k || t.dur[k] < lo) lo = t.dur[k];
+    if (t.dur[k] > hi) hi = t.dur[k];
+  }
+  if (lo > hi) lo = hi;
+  const int32_t next = (int32_t)(startMs + periodMs + lo - nowMs);
+  return PvSched{ next > 0 ? (uint32_t)next : 0, hi - lo + tickMs, periodMs };
+}
+
+// ---- Client: Funk nach Plan ----
+struct PvSleep {
+  bool     have = false;        // Plan gilt (sonst Funk an)
+  uint32_t nextAt = 0;          // frühester nächster Frame (eigene millis())
+  uint32_t spread = 0, period = 0;
+  uint32_t rxMs = 0;            // letzter Frame
+  uint32_t extra = 0;           // Fenster so viel früher (Lücken in seq)
+  uint8_t  missRun = 0;         // Fenster ohne Frame nacheinander
+  bool     radio = true;        // letzter Plan
+  uint32_t lastMs = 0;
+  // Messung
+  uint32_t frames = 0, gaps = 0, misses = 0, wakes = 0;
+  uint64_t onMs = 0, offMs = 0;
+};
+
+struct PvSleepPlan {
+  bool     radio;               // Funk an (WIFI_PS_NONE) bzw. Modem-Sleep
+  uint32_t idleMs;              // so lange bis zum nächsten Wecken (0 = Funk an)
+};
+
+// Frame empfangen. gap: seq sprang über lastSeq+1 (mindestens ein Frame fehlt); sc = nullptr:
+// Frame ohne Plan (älterer Poller) -> Funk bleibt an
+static inline void pvSleepFrame(PvSleep& s, uint32_t rxMs, bool gap, const PvSched* sc){
+  s.frames++; s.rxMs = rxMs; s.missRun = 0;
+  if (gap){
+    s.gaps++;
+    if (s.period){ s.extra += PV_SLEEP_GUARD_MS; if (s.extra > PV_SLEEP_EXTRA_MAX_MS) s.extra = PV_SLEEP_EXTRA_MAX_MS; }
+  } else s.extra = s.extra > PV_SLEEP_EXTRA_DECAY ? s.extra - PV_SLEEP_EXTRA_DECAY : 0;
+  s.have = sc != nullptr;
+  if (!sc) return;
+  s.nextAt = rxMs + sc->nextMs; s.spread = sc->spreadMs; s.period = sc->periodMs;
+}
+
+// Je loop(): busy = Start/Abgleich/Karussell/Nachfragen laufen (Funk an)
+static inline PvSleepPlan pvSleepPlan(PvSleep& s, uint32_t now, bool busy){
+  if (s.lastMs) (s.radio ? s.onMs : s.offMs) += now - s.lastMs;
+  s.lastMs = now ? now : 1;
+
+  PvSleepPlan p{ true, 0 };
+  if (s.have && (int32_t)(now - (s.nextAt + s.spread + PV_SLEEP_LATE_MS)) >= 0){
+    s.misses++;
+    if (++s.missRun >= PV_SLEEP_MISSES) s.have = false;   // Poller weg bzw. neuer Takt: wach bis zum nächsten
+    else s.nextAt += s.period;                            // einzelner Verlust: einen Takt später
+  }
+  if (!busy && s.have && (int32_t)(now - s.rxMs) >= PV_SLEEP_TAIL_MS){
+    const int32_t idle = (int32_t)(s.nextAt - PV_SLEEP_GUARD_MS - s.extra - now);
+    if (idle >= PV_SLEEP_MIN_MS || (!s.radio && idle > 0)) p = PvSleepPlan{ false, (uint32_t)idle };
+  }
+  if (p.radio && !s.radio) s.wakes++;
+  s.radio = p.radio;
+  return p;
+}
+
+static inline uint32_t pvSleepDutyPermille(const PvSleep& s){
+  const uint64_t t = s.onMs + s.offMs;
+  return t ? (uint32_t)(s.onMs * 1000 / t) : 1000;
+}
+
+// ---- Backlight ----
+#define PV_BL_DAY        255      // Helligkeit tagsüber (0..255, wahrgenommen)
+#define PV_BL_NIGHT      40       // ... nachts (0 = aus bis zur Berührung)
+#define PV_BL_NIGHT_FROM (22*60)  // Nacht ab (Minute des Tages, Ortszeit) ...
+#define PV_BL_NIGHT_TO   (6*60)   // ... bis
+#define PV_BL_RAMP_MIN   45       // Übergang in Minuten (vor NIGHT_FROM, nach NIGHT_TO)
+#define PV_BL_TOUCH_MS   30000    // nach Berührung voll
+#define PV_BL_FALL_STEP  4        // dunkler höchstens so viel je PV_BL_TICK_MS (heller sofort)
+#define PV_BL_TICK_MS    100
+#ifndef PV_LDR_DARK
+  #define PV_LDR_DARK    3000     // Rohwert ADC bei Dunkelheit (CYD: LDR an GPIO34, dunkel = hoch)
+#endif
+#ifndef PV_LDR_BRIGHT
+  #define PV_LDR_BRIGHT  200      // ... bei hellem Raum
+#endif
+#define PV_LDR_HYST      8        // Stufe (0..255) ändert sich erst bei so viel Abstand
+
+// Umgebungslicht, geglättet (EWMA 1/8 je Messung) und mit Hysterese: Rauschen am ADC
+// verstellt das Backlight nicht
+struct PvAmbient { int32_t avg8 = 0; int16_t lvl = -1; };
+
+static inline void pvAmbientAdd(PvAmbient& a, int32_t raw){
+  a.avg8 = a.lvl < 0 ? raw * 8 : a.avg8 + raw - a.avg8 / 8;
+  const int32_t v = a.avg8 / 8, d = PV_LDR_DARK, b = PV_LDR_BRIGHT;   // Kalibrierung in beide Richtungen
+  int32_t l = d == b ? 255 : (v - d) * 255 / (b - d);
+  l = l < 0 ? 0 : l > 255 ? 255 : l;
+  if (a.lvl < 0 || l - a.lvl > PV_LDR_HYST || a.lvl - l > PV_LDR_HYST || ((l == 0 || l == 255) && l != a.lvl)) a.lvl = (int16_t)l;
+}
+
+// 0 (dunkel) .. 255 (hell), -1 = noch keine Messung
+static inline int16_t pvAmbientLevel(const PvAmbient& a){ return a.lvl; }
+
+// Ziel-Helligkeit. minute: Minute des Tages (Ortszeit), < 0 = Uhr nicht gestellt;
+// ambient: pvAmbientLevel(), < 0 = kein Sensor
+static inline uint8_t pvBacklightTarget(int32_t minute, int16_t ambient, uint32_t sinceTouchMs){
+  if (sinceTouchMs < PV_BL_TOUCH_MS) return PV_BL_DAY;
+  if (ambient >= 0) return (uint8_t)(PV_BL_NIGHT + (PV_BL_DAY - PV_BL_NIGHT) * ambient / 255);
+  if (minute < 0) return PV_BL_DAY;
+  // Anteil "Tag" 0..PV_BL_RAMP_MIN: Rampe morgens ab NIGHT_TO, abends bis NIGHT_FROM
+  auto since = [](int32_t from, int32_t m){ return (m - from + 1440) % 1440; };
+  const int32_t day = since(PV_BL_NIGHT_TO, PV_BL_NIGHT_FROM);
+  const int32_t t = since(PV_BL_NIGHT_TO, minute);
+  int32_t f = 0;
+  if (t < day){
+    f = t < PV_BL_RAMP_MIN ? t : day - t < PV_BL_RAMP_MIN ? day - t : PV_BL_RAMP_MIN;
+  }
+  return (uint8_t)(PV_BL_NIGHT + (PV_BL_DAY - PV_BL_NIGHT) * f / PV_BL_RAMP_MIN);
+}
+
+// heller sofort, dunkler in Schritten (kein Springen bei Wolken/Schatten am LDR)
+static inline uint8_t pvBacklightStep(uint8_t cur, uint8_t target){
+  if (target >= cur) return target;
+  return (uint8_t)(cur - target > PV_BL_FALL_STEP ? cur - PV_BL_FALL_STEP : target);
+}
+
+// PWM-Tastgrad (8 bit) zur wahrgenommenen Helligkeit: etwa quadratisch
+static inline uint8_t pvBacklightDuty(uint8_t level){
+  if (!level) return 0;
+  const uint32_t d = (uint32_t)level * level / 255;
+  return (uint8_t)(d ? d : 1);
+}
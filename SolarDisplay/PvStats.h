@@ -1,7 +1,13 @@
 // ===================== PvStats.h =====================
 #pragma once
-#include <Arduino.h>
-#include <IPAddress.h>
+#ifdef ARDUINO
+  #include <Arduino.h>
+  #include <IPAddress.h>
+#else
+  #include <stdint.h>   // Host-Tools (tools/*.cpp) nutzen nur die Nachrichten-Strukturen
+  #include <stddef.h>
+#endif
+#include "PvWire.h"
 
 // ---- Multicast & Ports (kannst du bei Bedarf anpassen) ----
 #ifndef STATS_MCAST_GRP
@@ -22,18 +28,38 @@ enum : uint8_t {
   STATS_DAY      = 4,   // Poller -> Client: Tages-Datensatz
   STATS_MON      = 5,   // Poller -> Client: Monats-Datensatz
   STATS_ACK      = 6,   // Client -> Poller: ACK für Seq (derzeit ungenutzt)
-  STATS_DONE     = 7    // Poller -> Client: Ende des Streams
+  STATS_DONE     = 7,   // Poller -> Client: Ende des Streams
+  STATS_TRACE_REQ= 8,   // Host -> Gerät: Event-Trace anfordern (PV_TRACE)
+  STATS_TRACE    = 9,   // Gerät -> Host: Trace-Stück (PayloadTraceChunk + Daten)
+  STATS_DEVICES  = 10,  // Poller -> Multicast: ein Gerät der Anlage (PvDevInfo), nach jeder Poll-Runde
+  // Verlauf-Karussell (PvCarousel.h), alles auf STATS_MCAST_GRP
+  STATS_CAR_REQ  = 11,  // Client: "Verlauf bitte" (ohne Payload)
+  STATS_CAR_BLOCK= 12,  // Poller: Block mit bis zu PV_CAR_DAYS Tagen (PayloadCarBlock + PayloadCarDay je Maskenbit)
+  STATS_CAR_IDLE = 13,  // Poller: nichts mehr fällig (PayloadCarBlock ohne Tage, idx = blocks)
+  STATS_CAR_NACK = 14,  // Client: fehlende Blöcke (PayloadCarNack + PayloadCarSpan je Lücke)
+  // Energie verpasster Frames (PvFill.h)
+  STATS_FILL_REQ = 15,  // Client -> Poller: Frames from..to fehlen (PayloadFillReq)
+  STATS_FILL     = 16,  // Poller -> Client: PayloadFill + PayloadFillPart je Teil
+  // Spitzen und 15-min-Mittel (PvPeak.h)
+  STATS_PEAKS    = 17,  // Poller -> Multicast/Client: PayloadPeaks + PvPeaks
+  // Poller-Wahl (PvElect.h)
+  STATS_ELECT    = 18   // Poller-Knoten -> Multicast + Unicast an die anderen: Heartbeat (PayloadElect)
 };
+#define STATS_MAX_PAYLOAD 336   // Sendepuffer (größtes Paket: Karussell-Block)
+
+// Alle Nachrichten als Feldliste (PvWire.h): im Speicher ausgerichtet, auf dem Draht
+// Little Endian ohne Lücken. Empfang: pvRxStats() + pvWireDecode(), Senden: pvWireEncode().
 
 // ---- Header ----
-struct StatsHdr {
-  uint16_t magic;    // 0xCAFE
-  uint8_t  version;  // 1
-  uint8_t  type;     // STATS_*
-  uint32_t seq;      // Sequenznummer
-  uint16_t len;      // Payload-Länge
-  uint16_t crc;      // CRC über Header (crc=0) + Payload
-} __attribute__((packed));
+#define STATS_HDR_FIELDS(F, A) \
+  F(uint16_t, magic)     /* 0xCAFE */ \
+  F(uint8_t,  version)   /* 1 */ \
+  F(uint8_t,  type)      /* STATS_* */ \
+  F(uint32_t, seq)       /* Sequenznummer */ \
+  F(uint16_t, len)       /* Payload-Länge */ \
+  F(uint16_t, crc)       /* CRC über Header (crc=0) + Payload */
+PV_WIRE_MESSAGE(StatsHdr, STATS_HDR_FIELDS)
+static const size_t STATS_HDR_WIRE = PvWire<StatsHdr>::size;
 
 // CRC16-CCITT (0x1021, start 0xFFFF)
 inline uint16_t pvstats_crc(const StatsHdr& h, const uint8_t* payload){
@@ -45,46 +71,181 @@ inline uint16_t pvstats_crc(const StatsHdr& h, const uint8_t* payload){
     return c;
   };
   StatsHdr hc = h; hc.crc = 0;
-  uint16_t c = crc16((const uint8_t*)&hc, sizeof(StatsHdr));
+  uint8_t b[STATS_HDR_WIRE];
+  PvWire<StatsHdr>::put(hc, b);
+  uint16_t c = crc16(b, sizeof(b));
   if (h.len && payload) c = crc16(payload, h.len, c);
   return c;
 }
 
 // ---- Discover/Offer ----
-struct PayloadOffer {
-  uint16_t statsPort; // Unicast-Port des Pollers
-  uint16_t rsv;
-} __attribute__((packed));
-
-struct PayloadReqRange {
-  // 0 bedeutet "ab Beginn/alles"
-  uint16_t fromY;    // ab Jahr
-  uint8_t  fromM;    // ab Monat
-  uint8_t  fromD;    // ab Tag
-  uint16_t fromMonY; // ab Monat-Jahr für Monatsblöcke
-  uint8_t  fromMonM; // ab Monat (1..12)
-  uint8_t  rsv;
-} __attribute__((packed));
-
-struct PayloadAck {
-  uint32_t ackSeq;
-} __attribute__((packed));
+enum : uint16_t {
+  STATS_OFFER_CAROUSEL = 0x0001,   // Quelle verteilt den Verlauf per Karussell
+  STATS_OFFER_HIST     = 0x0002,   // PayloadOfferHist folgt nach dem Zeit-Anhang
+  STATS_OFFER_PEER     = 0x0004    // Quelle ist ein Client (PvPeer.h), Zeit-Anhang ohne PVTM_SYNCED
+};
+#define PAYLOAD_OFFER_FIELDS(F, A) \
+  F(uint16_t, statsPort)  /* Unicast-Port des Pollers */ \
+  F(uint16_t, flags)      /* STATS_OFFER_* (ältere Poller: 0) */
+PV_WIRE_MESSAGE(PayloadOffer, PAYLOAD_OFFER_FIELDS)
+
+// Stand des Verlaufs (PvPeer.h): Tage vor dem laufenden
+#define PAYLOAD_OFFER_HIST_FIELDS(F, A) \
+  F(int32_t,  hw)         /* jüngster Tag mit Record (pvDayNum) */ \
+  F(uint32_t, days)       /* Tage mit Record */ \
+  F(uint64_t, dig)        /* XOR der Tages-Hashes */ \
+  F(uint16_t, load)       /* fällige Karussell-Blöcke (+ Zuschlag Poller) */ \
+  F(uint16_t, rsv)
+PV_WIRE_MESSAGE(PayloadOfferHist, PAYLOAD_OFFER_HIST_FIELDS)
+
+// 0 bedeutet "ab Beginn/alles"
+#define PAYLOAD_REQ_RANGE_FIELDS(F, A) \
+  F(uint16_t, fromY)      /* ab Jahr */ \
+  F(uint8_t,  fromM)      /* ab Monat */ \
+  F(uint8_t,  fromD)      /* ab Tag */ \
+  F(uint16_t, fromMonY)   /* ab Monat-Jahr für Monatsblöcke */ \
+  F(uint8_t,  fromMonM)   /* ab Monat (1..12) */ \
+  F(uint8_t,  rsv)
+PV_WIRE_MESSAGE(PayloadReqRange, PAYLOAD_REQ_RANGE_FIELDS)
+
+#define PAYLOAD_ACK_FIELDS(F, A) \
+  F(uint32_t, ackSeq)
+PV_WIRE_MESSAGE(PayloadAck, PAYLOAD_ACK_FIELDS)
 
 // ---- WICHTIG: Payloads enthalten jetzt auch load_kWh ----
-struct PayloadDay {
-  uint16_t y, m, d;
-  float    gen_kWh;     // PV Erzeugung (integriert)
-  float    load_kWh;    // Load/Verbrauch (integriert)
-  float    impT1_kWh;   // Netzbezug T1
-  float    impT2_kWh;   // Netzbezug T2
-  float    exp_kWh;     // Einspeisung
-} __attribute__((packed));
-
-struct PayloadMon {
-  uint16_t y, m;
-  float    gen_kWh;     // PV Erzeugung (Summen aller Tage im Monat)
-  float    load_kWh;    // Verbrauch (Summen)
-  float    impT1_kWh;
-  float    impT2_kWh;
-  float    exp_kWh;
-} __attribute__((packed));
+#define PAYLOAD_DAY_FIELDS(F, A) \
+  F(uint16_t, y) F(uint16_t, m) F(uint16_t, d) \
+  F(float,    gen_kWh)    /* PV Erzeugung (integriert) */ \
+  F(float,    load_kWh)   /* Load/Verbrauch (integriert) */ \
+  F(float,    impT1_kWh)  /* Netzbezug T1 */ \
+  F(float,    impT2_kWh)  /* Netzbezug T2 */ \
+  F(float,    exp_kWh)    /* Einspeisung */
+PV_WIRE_MESSAGE(PayloadDay, PAYLOAD_DAY_FIELDS)
+
+#define PAYLOAD_MON_FIELDS(F, A) \
+  F(uint16_t, y) F(uint16_t, m) \
+  F(float,    gen_kWh)    /* PV Erzeugung (Summen aller Tage im Monat) */ \
+  F(float,    load_kWh)   /* Verbrauch (Summen) */ \
+  F(float,    impT1_kWh) \
+  F(float,    impT2_kWh) \
+  F(float,    exp_kWh)
+PV_WIRE_MESSAGE(PayloadMon, PAYLOAD_MON_FIELDS)
+
+// ---- Event-Trace (PvTrace.h) ----
+#define STATS_TRACE_CHUNK 120   // Datenbytes je Paket (passt in statsSendTo-Puffer)
+// Kopf eines Stücks, danach bis zu STATS_TRACE_CHUNK Datenbytes
+#define PAYLOAD_TRACE_CHUNK_FIELDS(F, A) \
+  F(uint32_t, off)        /* Offset im Dump */ \
+  F(uint32_t, total)      /* Gesamtlänge des Dumps */
+PV_WIRE_MESSAGE(PayloadTraceChunk, PAYLOAD_TRACE_CHUNK_FIELDS)
+
+// ---- Geräte der Anlage (PvPoll.h), je Gerät ein Paket ----
+enum : uint8_t { PVDEV_OK = 0, PVDEV_OLD = 1, PVDEV_NONE = 2 };   // aktuell / letzter Wert (ältere Runde) / keine Daten
+#define PV_DEV_INFO_FIELDS(F, A) \
+  F(uint8_t,  idx) F(uint8_t, count)    /* Index, Anzahl Geräte */ \
+  F(uint8_t,  flags) F(uint8_t, unit)   /* PVD_*, Modbus Unit-ID */ \
+  F(uint8_t,  state)                    /* PVDEV_* */ \
+  F(int32_t,  pvW) F(int32_t, battW) \
+  F(int16_t,  temp10)                   /* 0.1°C */ \
+  F(uint16_t, socx10)                   /* 0.1% */ \
+  F(uint32_t, genTodayWh)               /* PV je Gerät (eigene Integration im Poller) */ \
+  F(uint32_t, genMonthWh) \
+  F(uint16_t, cycleMs)                  /* Dauer der letzten Abfrage des Geräts */ \
+  F(uint16_t, ageS)                     /* Alter des Werts */ \
+  A(char,     name, 8)
+PV_WIRE_MESSAGE(PvDevInfo, PV_DEV_INFO_FIELDS)
+
+// ---- Verlauf-Karussell (PvCarousel.h) ----
+// Anfrage an eine Quelle (PvPeer.h); ohne Payload bzw. src = 0: der Poller
+#define PAYLOAD_CAR_REQ_FIELDS(F, A) \
+  F(uint32_t, src)        /* IPv4 der gewählten Quelle */
+PV_WIRE_MESSAGE(PayloadCarReq, PAYLOAD_CAR_REQ_FIELDS)
+
+#define PAYLOAD_CAR_BLOCK_FIELDS(F, A) \
+  F(int32_t,  first)      /* erster Tag des Verlaufs (Tage seit 1970, pvDayNum) */ \
+  F(uint16_t, blocks)     /* Blöcke gesamt */ \
+  F(uint16_t, idx)        /* dieser Block: Tage first + idx*PV_CAR_DAYS ... */ \
+  F(uint8_t,  mask)       /* Bit i: Tag i des Blocks folgt (fehlt beim Poller sonst) */ \
+  F(uint8_t,  rsv)
+PV_WIRE_MESSAGE(PayloadCarBlock, PAYLOAD_CAR_BLOCK_FIELDS)
+
+// exakte Werte (PvEnergy), damit die Records aller Geräte bitgleich sind
+#define PAYLOAD_CAR_DAY_FIELDS(F, A) \
+  F(int64_t, gen) F(int64_t, load) F(int64_t, impT1) F(int64_t, impT2) F(int64_t, exp)
+PV_WIRE_MESSAGE(PayloadCarDay, PAYLOAD_CAR_DAY_FIELDS)
+
+#define PAYLOAD_CAR_NACK_FIELDS(F, A) \
+  F(int32_t,  first)      /* Bereich, auf den sich die Lücken beziehen */ \
+  F(uint16_t, blocks) \
+  F(uint8_t,  n)          /* Anzahl PayloadCarSpan dahinter */ \
+  F(uint8_t,  rsv) \
+  F(uint32_t, src)        /* Quelle wie PayloadCarReq */
+PV_WIRE_MESSAGE(PayloadCarNack, PAYLOAD_CAR_NACK_FIELDS)
+
+#define PAYLOAD_CAR_SPAN_FIELDS(F, A) \
+  F(uint16_t, idx) F(uint16_t, count)
+PV_WIRE_MESSAGE(PayloadCarSpan, PAYLOAD_CAR_SPAN_FIELDS)
+
+// ---- Energie je Frame (PvFill.h) ----
+#define PAYLOAD_FILL_REQ_FIELDS(F, A) \
+  F(uint32_t, from) F(uint32_t, to)   /* Frame-seq, beide einschließlich */
+PV_WIRE_MESSAGE(PayloadFillReq, PAYLOAD_FILL_REQ_FIELDS)
+
+#define PAYLOAD_FILL_FIELDS(F, A) \
+  F(uint32_t, oldest)     /* ältester Frame im Ring des Pollers (davor: verloren) */ \
+  F(uint8_t,  n)          /* Anzahl PayloadFillPart dahinter */ \
+  F(uint8_t,  rsv) \
+  F(uint16_t, rsv2)
+PV_WIRE_MESSAGE(PayloadFill, PAYLOAD_FILL_FIELDS)
+
+// was zwischen zwei Frames in die Tagesakkus des Pollers geflossen ist (exakt, PvEnergy)
+#define PAYLOAD_FILL_PART_FIELDS(F, A) \
+  F(uint32_t, seq)        /* Frame, mit dem der Teil kam */ \
+  F(int32_t,  day)        /* Tag beim Poller (pvDayNum; 0 = ohne Uhr) */ \
+  F(int64_t, gen) F(int64_t, load) F(int64_t, impT1) F(int64_t, impT2) F(int64_t, exp)
+PV_WIRE_MESSAGE(PayloadFillPart, PAYLOAD_FILL_PART_FIELDS)
+
+// ---- Spitzen (PvPeak.h): nach jeder Runde heute und der Monat per Multicast, im Unicast-Strom
+// hinter jedem STATS_DAY/STATS_MON. PvPeaks (92 Byte) folgt dem Kopf.
+#define PAYLOAD_PEAKS_FIELDS(F, A) \
+  F(int32_t,  day)        /* Tag (pvDayNum), bei Monaten der erste */ \
+  F(uint8_t,  lvl)        /* PVL_DAY oder PVL_MONTH (PvRollup.h) */ \
+  F(uint8_t,  rsv) \
+  F(uint16_t, rsv2)
+PV_WIRE_MESSAGE(PayloadPeaks, PAYLOAD_PEAKS_FIELDS)
+
+// ---- Poller-Wahl (PvElect.h): Heartbeat jedes Knotens mit ROLE_POLLER und PV_ELECT ----
+#define PAYLOAD_ELECT_FIELDS(F, A) \
+  F(uint32_t, id)         /* Knoten (aus der MAC) */ \
+  F(uint32_t, term)       /* Amtszeit: aktiv/Bewerbung die eigene, sonst die von 'active' */ \
+  F(uint32_t, active)     /* aktiv/Bewerbung: der Knoten selbst, sonst der ranghöchste gehörte Aktive oder Bewerber (0 = keiner) */ \
+  F(uint32_t, seq)        /* letzter Frame (gesendet bzw. empfangen) */ \
+  F(uint8_t,  prio)       /* PV_ELECT_PRIO */ \
+  F(uint8_t,  state)      /* PVEL_* */ \
+  F(uint8_t,  flags)      /* PVEF_* */ \
+  F(uint8_t,  aprio)      /* Prio von 'active' */ \
+  F(int32_t,  hw)         /* Stand des Verlaufs wie PayloadOfferHist (PVEF_HIST) */ \
+  F(uint32_t, days) \
+  F(uint64_t, dig)
+PV_WIRE_MESSAGE(PayloadElect, PAYLOAD_ELECT_FIELDS)
+
+// Drahtgrößen festnageln (= frühere gepackte Strukturen)
+static_assert(PvWire<StatsHdr>::size          == 12, "StatsHdr");
+static_assert(PvWire<PayloadOffer>::size      ==  4, "PayloadOffer");
+static_assert(PvWire<PayloadReqRange>::size   ==  8, "PayloadReqRange");
+static_assert(PvWire<PayloadAck>::size        ==  4, "PayloadAck");
+static_assert(PvWire<PayloadDay>::size        == 26, "PayloadDay");
+static_assert(PvWire<PayloadMon>::size        == 24, "PayloadMon");
+static_assert(PvWire<PayloadTraceChunk>::size ==  8, "PayloadTraceChunk");
+static_assert(PvWire<PvDevInfo>::size         == 37, "PvDevInfo");
+static_assert(PvWire<PayloadOfferHist>::size  == 20, "PayloadOfferHist");
+static_assert(PvWire<PayloadCarReq>::size     ==  4, "PayloadCarReq");
+static_assert(PvWire<PayloadCarBlock>::size   == 10, "PayloadCarBlock");
+static_assert(PvWire<PayloadCarDay>::size     == 40, "PayloadCarDay");
+static_assert(PvWire<PayloadCarNack>::size    == 12, "PayloadCarNack");
+static_assert(PvWire<PayloadCarSpan>::size    ==  4, "PayloadCarSpan");
+static_assert(PvWire<PayloadFillReq>::size    ==  8, "PayloadFillReq");
+static_assert(PvWire<PayloadFill>::size       ==  8, "PayloadFill");
+static_assert(PvWire<PayloadFillPart>::size   == 48, "PayloadFillPart");
+static_assert(PvWire<PayloadPeaks>::size      ==  8, "PayloadPeaks");
+static_assert(PvWire<PayloadElect>::size      == 36, "PayloadElect");
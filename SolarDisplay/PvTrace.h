@@ -0,0 +1,162 @@
+// ===================== PvTrace.h =====================
+// Event-Trace: lock-freier Ringpuffer fester Größe mit Begin/End-Ereignissen
+// (µs-Zeitstempel). Dump über Serial ('t') oder UDP (STATS_TRACE_REQ),
+// Umwandlung ins Chrome/Perfetto-JSON mit tools/pvtrace.cpp.
+//
+// Aktivieren: #define PV_TRACE vor #include "PvTrace.h"
+// Ohne PV_TRACE werden alle PV_TRACE_* Makros zu nichts.
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#ifdef ARDUINO
+  #include <Arduino.h>
+#else
+  #include <chrono>
+#endif
+
+#ifndef PV_TRACE_CAP
+  #define PV_TRACE_CAP 1024   // Anzahl Einträge, Zweierpotenz (12 Byte je Eintrag)
+#endif
+static_assert((PV_TRACE_CAP & (PV_TRACE_CAP-1)) == 0, "PV_TRACE_CAP muss Zweierpotenz sein");
+
+// ---- Phasen (wie Chrome-Trace "ph") ----
+enum : uint8_t { PVT_BEGIN='B', PVT_END='E', PVT_INSTANT='i' };
+
+// ---- Ereignis-IDs ----
+enum : uint8_t {
+  PVT_POLL = 1,       // Poll-Runde (startPoll .. maybeFinishPoll)
+  PVT_MB_CB,          // Modbus-Callback (arg = Register)
+  PVT_FRAME_RX,       // Frame-Empfang im AsyncUDP-Callback (arg = Paketlänge)
+  PVT_FRAME_TX,       // Frame-Versand Poller (arg = seq)
+  PVT_DRAW,           // drawPvPage gesamt (arg = Seite)
+  PVT_DRAW_HEADER,    // drawStatusHeader
+  PVT_DRAW_CLEAR,     // Inhaltsbereich löschen
+  PVT_DRAW_CONTENT,   // Seiteninhalt (arg = Seite)
+  PVT_TOUCH_READ,     // Touch-Task: ein Sample lesen
+  PVT_SWIPE,          // erkannter Swipe (arg = neue Seite)
+  PVT_NVS_SAVE,       // NVS schreiben (arg = JJJJMMTT bzw. JJJJMM)
+  PVT_NVS_LOAD,       // NVS lesen
+  PVT_STATS_RX,       // Stats-Paket (arg = Typ)
+  PVT_ROLLOVER,       // Tages-/Monatswechsel
+  PVT_FLUSH_BAND,     // Band zeichnen (arg = erste Zeile)
+  PVT_FLUSH_WAIT,     // auf DMA des vorigen Bands warten (arg = Zeile)
+  PVT_FLUSH_DONE,     // Frame komplett beim Display (arg = Frame-Zeit µs)
+  PVT_BOOT,           // Start-Automat (arg = Aktionen PVBA_*, PvBoot.h)
+  PVT_ID_COUNT
+};
+
+static inline const char* pvTraceName(uint8_t id){
+  switch(id){
+    case PVT_POLL:         return "poll";
+    case PVT_MB_CB:        return "modbus_cb";
+    case PVT_FRAME_RX:     return "frame_rx";
+    case PVT_FRAME_TX:     return "frame_tx";
+    case PVT_DRAW:         return "drawPvPage";
+    case PVT_DRAW_HEADER:  return "draw_header";
+    case PVT_DRAW_CLEAR:   return "draw_clear";
+    case PVT_DRAW_CONTENT: return "draw_content";
+    case PVT_TOUCH_READ:   return "touch_read";
+    case PVT_SWIPE:        return "swipe";
+    case PVT_NVS_SAVE:     return "nvs_save";
+    case PVT_NVS_LOAD:     return "nvs_load";
+    case PVT_STATS_RX:     return "stats_rx";
+    case PVT_ROLLOVER:     return "rollover";
+    case PVT_FLUSH_BAND:   return "flush_band";
+    case PVT_FLUSH_WAIT:   return "flush_wait";
+    case PVT_FLUSH_DONE:   return "flush_done";
+    case PVT_BOOT:         return "boot";
+    default:               return "?";
+  }
+}
+
+// ---- Eintrag (12 Byte, Little Endian wie ESP32 und x86) ----
+struct PvTraceRec {
+  uint32_t tsUs;    // micros()
+  uint32_t arg;     // frei (seq, Register, Seite, ...)
+  uint8_t  id;      // PVT_*
+  uint8_t  ph;      // PVT_BEGIN/END/INSTANT
+  uint8_t  tid;     // CPU-Kern (ESP32), Host: 0
+  uint8_t  rsv;
+} __attribute__((packed));
+static_assert(sizeof(PvTraceRec) == 12, "PvTraceRec muss 12 Byte sein");
+
+// ---- Dump-Kopf (vor den Einträgen, alt -> neu) ----
+#define PV_TRACE_MAGIC 0x52545650u   // "PVTR"
+struct PvTraceDumpHdr {
+  uint32_t magic;     // PV_TRACE_MAGIC
+  uint16_t version;   // 1
+  uint16_t recSize;   // sizeof(PvTraceRec)
+  uint32_t count;     // Anzahl folgender Einträge
+  uint32_t lost;      // überschriebene (verlorene) Einträge
+  uint32_t nowUs;     // micros() beim Dump
+} __attribute__((packed));
+
+// ---- Ringpuffer ----
+struct PvTraceRing {
+  PvTraceRec        rec[PV_TRACE_CAP];
+  std::atomic<uint32_t> head{0};     // nächster Schreibindex (monoton)
+  std::atomic<bool>     paused{false};
+};
+static PvTraceRing pvTraceRing;
+
+static inline uint32_t pvTraceNowUs(){
+#ifdef ARDUINO
+  return (uint32_t)micros();
+#else
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static inline uint8_t pvTraceTid(){
+#if defined(ARDUINO) && defined(ESP32)
+  return (uint8_t)xPortGetCoreID();
+#else
+  return 0;
+#endif
+}
+
+// Ein Eintrag: ein atomares fetch_add reserviert den Slot, kein Lock.
+static inline void pvTraceRecord(uint8_t id, uint8_t ph, uint32_t arg=0){
+  if (pvTraceRing.paused.load(std::memory_order_relaxed)) return;
+  uint32_t i = pvTraceRing.head.fetch_add(1, std::memory_order_relaxed) & (PV_TRACE_CAP-1);
+  PvTraceRec& r = pvTraceRing.rec[i];
+  r.tsUs = pvTraceNowUs(); r.arg = arg; r.id = id; r.ph = ph; r.tid = pvTraceTid(); r.rsv = 0;
+}
+
+// Begin/End als Scope (RAII)
+struct PvTraceScope {
+  uint8_t id; uint32_t arg;
+  PvTraceScope(uint8_t i, uint32_t a=0) : id(i), arg(a) { pvTraceRecord(id, PVT_BEGIN, arg); }
+  ~PvTraceScope(){ pvTraceRecord(id, PVT_END, arg); }
+};
+
+// Dump: Aufzeichnung anhalten, Kopf + Einträge (alt -> neu) an 'out' übergeben.
+// out(const uint8_t* data, size_t len) wird mehrfach aufgerufen.
+template<typename Out>
+static void pvTraceDump(Out out){
+  pvTraceRing.paused.store(true);
+  uint32_t head  = pvTraceRing.head.load();
+  uint32_t count = head < PV_TRACE_CAP ? head : PV_TRACE_CAP;
+  PvTraceDumpHdr h{ PV_TRACE_MAGIC, 1, (uint16_t)sizeof(PvTraceRec), count, head - count, pvTraceNowUs() };
+  out((const uint8_t*)&h, sizeof(h));
+  for (uint32_t k = head - count; k != head; ++k)
+    out((const uint8_t*)&pvTraceRing.rec[k & (PV_TRACE_CAP-1)], sizeof(PvTraceRec));
+  pvTraceRing.paused.store(false);
+}
+
+// ---- Makros ----
+#define PV_TRACE_CAT2(a,b) a##b
+#define PV_TRACE_CAT(a,b)  PV_TRACE_CAT2(a,b)
+#ifdef PV_TRACE
+  #define PV_TRACE_SCOPE(id, arg)   PvTraceScope PV_TRACE_CAT(pvTraceScope_,__LINE__)((id), (uint32_t)(arg))
+  #define PV_TRACE_BEGIN(id, arg)   pvTraceRecord((id), PVT_BEGIN,   (uint32_t)(arg))
+  #define PV_TRACE_END(id, arg)     pvTraceRecord((id), PVT_END,     (uint32_t)(arg))
+  #define PV_TRACE_INSTANT(id, arg) pvTraceRecord((id), PVT_INSTANT, (uint32_t)(arg))
+#else
+  #define PV_TRACE_SCOPE(id, arg)   do{}while(0)
+  #define PV_TRACE_BEGIN(id, arg)   do{}while(0)
+  #define PV_TRACE_END(id, arg)     do{}while(0)
+  #define PV_TRACE_INSTANT(id, arg) do{}while(0)
+#endif
@@ -0,0 +1,100 @@
+// ===================== PvWire.h =====================
+// Drahtformat der Nachrichten (Frames, Stats, Zeit-Anhang). Je Nachricht gibt es genau eine
+// Feldliste (X-Makro); PV_WIRE_MESSAGE erzeugt daraus
+//  - die Struktur im Speicher, natürlich ausgerichtet (kein packed, keine Casts auf Paketpuffer),
+//  - PvWire<T>::size     Länge auf dem Draht (Summe der Feldgrößen, constexpr),
+//  - PvWire<T>::fields() Feldtabelle (Name, Offset im Speicher und auf dem Draht, Größe, Art),
+//  - PvWire<T>::put/get  Kodieren/Dekodieren Feld für Feld, immer Little Endian, byteweise
+//                        (unabhängig von Ausrichtung des Puffers und Byte-Reihenfolge der CPU).
+// Die Drahtgrößen werden bei jeder Nachricht per static_assert festgenagelt: das Format
+// entspricht Byte für Byte den früheren gepackten Strukturen (tools/pvwire.cpp prüft das).
+// Ohne Arduino-Abhängigkeiten.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+enum : uint8_t { PVW_UINT = 0, PVW_INT, PVW_FLOAT, PVW_BYTES };
+
+struct PvWireField {
+  const char* name;
+  uint16_t    mem;     // offsetof in der Struktur
+  uint16_t    wire;    // Offset im Paket
+  uint16_t    size;    // Bytes (Array: gesamt)
+  uint8_t     kind;    // PVW_*
+};
+
+template<class T> struct PvWire;   // je Nachricht von PV_WIRE_MESSAGE spezialisiert
+
+// ---- Grundtypen, Little Endian ----
+template<size_t N> struct PvWireUInt;
+template<> struct PvWireUInt<1> { typedef uint8_t  type; };
+template<> struct PvWireUInt<2> { typedef uint16_t type; };
+template<> struct PvWireUInt<4> { typedef uint32_t type; };
+template<> struct PvWireUInt<8> { typedef uint64_t type; };
+
+template<class T> static inline void pvWirePut(uint8_t*& p, T v){
+  static_assert(std::is_arithmetic<T>::value, "nur Zahlen");
+  typename PvWireUInt<sizeof(T)>::type u;
+  memcpy(&u, &v, sizeof(T));             // float: Bitmuster (IEEE 754 auf ESP32 und Host)
+  for (size_t i = 0; i < sizeof(T); i++) p[i] = (uint8_t)(u >> (8 * i));
+  p += sizeof(T);
+}
+template<class T> static inline void pvWireGet(const uint8_t*& p, T& v){
+  typedef typename PvWireUInt<sizeof(T)>::type U;
+  U u = 0;
+  for (size_t i = 0; i < sizeof(T); i++) u = (U)(u | ((U)p[i] << (8 * i)));
+  memcpy(&v, &u, sizeof(T));
+  p += sizeof(T);
+}
+static inline uint16_t pvWireU16(const uint8_t* p){ return (uint16_t)(p[0] | (p[1] << 8)); }
+
+template<class T> struct PvWireKind {
+  static constexpr uint8_t v = std::is_floating_point<T>::value ? PVW_FLOAT :
+                               std::is_signed<T>::value ? PVW_INT : PVW_UINT;
+};
+
+// ---- Generator ----
+// Feldliste: F(typ, name) für Zahlen, A(typ, name, n) für Byte-Arrays (char/uint8_t)
+#define PVW_MEMBER(T, n)      T n;
+#define PVW_MEMBER_A(T, n, N) T n[N];
+#define PVW_SIZE(T, n)        + sizeof(T)
+#define PVW_SIZE_A(T, n, N)   + (N)
+#define PVW_ONE(T, n)         + 1
+#define PVW_ONE_A(T, n, N)    + 1
+#define PVW_DESC(T, n)        { #n, (uint16_t)offsetof(S, n), (uint16_t)offsetof(W, n), (uint16_t)sizeof(T), PvWireKind<T>::v },
+#define PVW_DESC_A(T, n, N)   { #n, (uint16_t)offsetof(S, n), (uint16_t)offsetof(W, n), (uint16_t)(N), PVW_BYTES },
+#define PVW_PUT(T, n)         pvWirePut<T>(p, v.n);
+#define PVW_PUT_A(T, n, N)    static_assert(sizeof(T) == 1, "Arrays nur byteweise"); memcpy(p, v.n, N); p += (N);
+#define PVW_GET(T, n)         pvWireGet<T>(p, v.n);
+#define PVW_GET_A(T, n, N)    memcpy(v.n, p, N); p += (N);
+
+// Layout: die gepackte Spiegelstruktur dient nur offsetof() für die Drahtoffsets der
+// Feldtabelle, Daten werden nie über sie gelesen oder geschrieben.
+#define PV_WIRE_MESSAGE(NAME, FIELDS)                                                          \
+  struct NAME { FIELDS(PVW_MEMBER, PVW_MEMBER_A) };                                            \
+  template<> struct PvWire<NAME> {                                                             \
+    typedef NAME S;                                                                            \
+    struct __attribute__((packed)) W { FIELDS(PVW_MEMBER, PVW_MEMBER_A) };                     \
+    static constexpr size_t size  = 0 FIELDS(PVW_SIZE, PVW_SIZE_A);                            \
+    static constexpr size_t count = 0 FIELDS(PVW_ONE, PVW_ONE_A);                              \
+    static_assert(sizeof(W) == size, #NAME ": Drahtlayout");                                   \
+    static const PvWireField* fields(){                                                        \
+      static constexpr PvWireField t[] = { FIELDS(PVW_DESC, PVW_DESC_A) };                     \
+      return t;                                                                                \
+    }                                                                                          \
+    static inline uint8_t* put(const S& v, uint8_t* p){ FIELDS(PVW_PUT, PVW_PUT_A) return p; } \
+    static inline const uint8_t* get(S& v, const uint8_t* p){ FIELDS(PVW_GET, PVW_GET_A) return p; } \
+  };
+
+// Dekodieren mit Längenprüfung; Kodieren liefert die geschriebene Länge
+template<class T> static inline bool pvWireDecode(const uint8_t* p, size_t len, T& v){
+  if (len < PvWire<T>::size) return false;
+  PvWire<T>::get(v, p);
+  return true;
+}
+template<class T> static inline size_t pvWireEncode(const T& v, uint8_t* p){
+  PvWire<T>::put(v, p);
+  return PvWire<T>::size;
+}
@@ -1,11 +1,20 @@
 // Patched full sketch: Poller/Client with atomic snapshots to fix integration mismatches
 /************* Rolle auswählen *************/
 //#define ROLE_POLLER    // einkommentieren = Poller; auskommentieren = Client
+//#define PV_TRACE       // einkommentieren = Event-Trace (Dump: Serial 't' oder UDP, s. tools/pvtrace.cpp)
+//#define PV_GFX_LGFX    // einkommentieren = LovyanGFX statt TFT_eSPI (braucht CYD_Display_Config.h wie SolarDisplayClaude)
+//#define PV_ELECT       // mit ROLE_POLLER: Poller zur Laufzeit wählen, mehrere Poller-Builds, einer fragt ab (PvElect.h)
 /*******************************************/
 
-// ---- TFT_eSPI über lokalen User_Setup.h laden ----
-#define USER_SETUP_LOADED
-#include "User_Setup.h"
+#ifdef PV_GFX_LGFX
+  // ---- LovyanGFX: Klasse LGFX mit Bus/Panel für das CYD ----
+  #include <LovyanGFX.hpp>
+  #include "CYD_Display_Config.h"
+#else
+  // ---- TFT_eSPI über lokalen User_Setup.h laden ----
+  #define USER_SETUP_LOADED
+  #include "User_Setup.h"
+#endif
 
 #ifndef TFT_BL
   #define TFT_BL 21
@@ -13,15 +22,39 @@
 #ifndef TFT_ROTATION
   #define TFT_ROTATION 1
 #endif
+#ifndef PV_BL_PWM_HZ
+  #define PV_BL_PWM_HZ  5000   // Backlight-PWM (PvSleep.h)
+#endif
+#ifndef PV_BL_LEDC_CH
+  #define PV_BL_LEDC_CH 0      // LEDC-Kanal (Core 2.x; ab 3.x je Pin)
+#endif
+#ifndef PV_CPU_IDLE_MHZ
+  #define PV_CPU_IDLE_MHZ 80   // Client: CPU-Takt, solange das WLAN nach Plan schläft
+#endif
+#ifndef PV_ELECT_PRIO
+  #define PV_ELECT_PRIO 100    // Rang bei der Poller-Wahl (höher gewinnt; gleich: Knoten-ID)
+#endif
+//#define PV_LDR_PIN 34        // einkommentieren = Backlight nach Umgebungslicht (CYD: LDR an GPIO34)
+//#define PV_LIGHT_SLEEP       // einkommentieren = Light-Sleep in Pausen bei dunklem Display (Client)
 
-#include <TFT_eSPI.h>
+#ifndef PV_GFX_LGFX
+  #include <TFT_eSPI.h>
+#endif
 #include <WiFi.h>
 #include <AsyncUDP.h>
 #include <time.h>
+#include <sys/time.h>
+#include <esp_sntp.h>
 #include <Preferences.h>
+#include <nvs.h>
+#include <new>
 #include <Streaming.h>
 
 #include <Credentials.h>
+#ifdef PV_LIGHT_SLEEP
+  #include <esp_sleep.h>
+  #include <driver/gpio.h>
+#endif
 
 // Touch (XPT2046) – CYD Pins
 #include <SPI.h>
@@ -32,10 +65,26 @@
 #define XPT2046_CLK   25   // T_CLK
 #define XPT2046_CS    33   // T_CS
 SPIClass touchscreenSPI(VSPI);
-XPT2046_Touchscreen touchscreen(XPT2046_CS, XPT2046_IRQ);
+XPT2046_Touchscreen touchscreen(XPT2046_CS);   // T_IRQ nicht an die Lib: eigener Interrupt weckt den Touch-Task
 
 #include "PvCommon.h"  // Frame v4, drawPvPage(...), pvMaxPages(), crc16_modbus, MCAST_GRP, MCAST_PORT
 #include "PvStats.h"   // bereits übernommen (enthält load_kWh in Payloads)
+#include "PvRx.h"      // Empfangsprüfung Frames/Stats inkl. Zähler je Ablehnungsgrund
+#include "PvEnergy.h"  // Energie-Integration in int64 (1/2 mWs), versionierter NVS-Record
+#include "PvFlush.h"   // Bänder + DMA: Zeichnen und SPI-Übertragung überlappen
+#include "PvGesture.h" // Touch-Ring (Task -> loop), Filter, Tap/Long/Swipe nach Zeitstempeln
+#include "PvPoll.h"    // Geräte-Tabelle, Poll-Pipelines je Endpunkt, Zusammenfassung zum Frame
+#include "PvBoot.h"    // Boot-Cache (RTC/NVS), Start-Automat WLAN/NTP/Sync, Markierung "alt"
+#include "PvClock.h"   // Zeit-Anhang an Frame/Offer, Client-Uhr nach dem Poller (Offset/Drift)
+#include "PvRollup.h"  // Verlauf Tag/Woche/Monat/Jahr, je Tag nachgeführt (Seite 6)
+#include "PvCarousel.h" // Verlauf per Multicast an alle Clients zugleich, Lücken per NACK
+#include "PvPeer.h"     // Digest der Tage, abgeglichene Clients als weitere Verlauf-Quellen
+#include "PvFill.h"     // Energie je Frame vom Poller, verpasste Frames nachfragen
+#include "PvBatt.h"     // Batterie-Schätzer: ETA 20 %/voll/leer mit Konfidenz (Frame-Anhang)
+#include "PvPeak.h"     // Spitzen mit Zeitpunkt, 15-min-Mittel je Tarif (Tages-/Monatsrecord v3)
+#include "PvSleep.h"    // Client: WLAN nach Frame-Plan des Pollers schlafen, Backlight dimmen
+#include "PvElect.h"    // Poller-Wahl: Heartbeats, Lease, Übernahme durch den Standby (PV_ELECT)
+#include "PvExport.h"   // ganzer Verlauf über TCP holen/zurückschreiben (Sicherung, Ersatzgerät)
 
 // ---- Zeitzone (Fallback) ----
 #ifndef TZ_EU_ZURICH
@@ -46,7 +95,32 @@ XPT2046_Touchscreen touchscreen(XPT2046_CS, XPT2046_IRQ);
 //Comes from Credentials.h
 
 // ===== Anzeige =====
+// Backend beim Kompilieren gewählt; die Seiten (PvCommon.h) sind Templates über den Typ
+#ifdef PV_GFX_LGFX
+LGFX tft;
+#else
 TFT_eSPI tft;
+#endif
+
+// DMA-Bus für PvFlush: CS bleibt von begin() bis end() aktiv (Voraussetzung für pushImageDMA)
+struct TftDmaBus {
+  void begin(){ tft.startWrite(); tft.setSwapBytes(false); }   // Sprite-Puffer sind schon Display-Byteorder
+  void push(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* px){ tft.pushImageDMA(x, y, w, h, px); }
+  bool busy(){ return tft.dmaBusy(); }
+#ifdef PV_GFX_LGFX
+  void wait(){ tft.waitDMA(); }
+#else
+  void wait(){ tft.dmaWait(); }
+#endif
+  void end(){ tft.endWrite(); }
+  uint32_t nowUs(){ return micros(); }
+};
+static TftDmaBus   tftBus;
+#ifndef PV_GFX_LGFX
+static TFT_eSprite bandSpr[2] = { TFT_eSprite(&tft), TFT_eSprite(&tft) };
+#endif
+static PvFlush<TftDmaBus> flush;
+static volatile bool drawPending = false;   // Client: Frame empfangen, in loop() zeichnen
 
 // ===== UDP =====
 AsyncUDP udpFrame;       // Multicast Frames (v4)
@@ -57,7 +131,69 @@ AsyncUDP udpStatsSrv;    // Unicast Server (Poller) oder leer (Client)
 static PvFrameV4 lastF{};
 static bool      haveFrame=false;
 static uint32_t  lastSeq=0;
-static uint32_t  lastRxMs=0;
+static uint32_t  lastRxMs=0;   // letzter frischer Frame (Client: empfangen, Poller: Runde fertig)
+
+// ===== Start (PvBoot.h) =====
+static PvBoot      boot;
+static PvBootCache bootCache;                  // beim Start gelesen, Akkus gelten erst mit gültiger Uhr
+static bool        bootCacheOk = false;
+RTC_NOINIT_ATTR static PvBootCache rtcCache;   // übersteht Software-Reset/Watchdog, nicht Stromausfall
+static uint32_t    bootCachedRx = 0, bootSavedMs = 0;
+static volatile uint32_t statsOfferMs = 0;     // Client: letzter Offer
+static volatile bool     statsSynced  = false; // Client: Verlauf vollständig (STATS_DONE bzw. Karussell)
+
+// ===== Uhr (PvClock.h): Poller stempelt Frames/Offer, Clients stellen sich danach =====
+static const char* NTP1 = "pool.ntp.org";
+static const char* NTP2 = "time.google.com";
+static const char* NTP3 = "time.cloudflare.com";
+
+#ifdef ROLE_POLLER
+// Zeit-Anhang direkt vor dem Senden (kodiert nach p, PV_TIME_WIRE Bytes)
+static size_t clockStamp(uint8_t* p){
+  struct timeval tv; gettimeofday(&tv, nullptr);
+  return pvFrameTimeSeal(p, (uint64_t)tv.tv_sec*1000 + tv.tv_usec/1000, pvTimeValid(tv.tv_sec));
+}
+#else
+static PvClock clk;   // nur im UDP-Task geschrieben (Frames und Offer)
+
+// Systemuhr auf die Schätzung: vorwärts sofort, zurück per adjtime (time() bleibt monoton)
+static void clockApply(){
+  struct timeval tv; gettimeofday(&tv, nullptr);
+  int64_t est = (int64_t)pvClockNowMs(clk, millis());
+  int32_t d;
+  switch (pvClockCorrection(est, (int64_t)tv.tv_sec*1000 + tv.tv_usec/1000, d)){
+    case PVCK_STEP:{ struct timeval nv{ (time_t)(est/1000), (suseconds_t)(est%1000*1000) }; settimeofday(&nv, nullptr); }break;
+    case PVCK_SLEW:{ struct timeval dv{ d/1000, (suseconds_t)(d%1000*1000) }; adjtime(&dv, nullptr); }break;
+    default: break;
+  }
+}
+
+static void clockSample(uint32_t rxMs, uint64_t pollerMs){
+  if (pvClockSample(clk, rxMs, pollerMs)) Serial.println("[CLK] Uhr nach Poller gestellt");
+  if (!boot.ntpOn) clockApply();   // SNTP beendet bootTick() beim nächsten Durchlauf
+}
+
+static void ntpStop(){
+#if defined(ESP_IDF_VERSION_MAJOR) && ESP_IDF_VERSION_MAJOR >= 5
+  esp_sntp_stop();
+#else
+  sntp_stop();
+#endif
+}
+
+static void printClock(){
+  struct timeval tv; gettimeofday(&tv, nullptr);
+  long long d = clk.valid ? (long long)pvClockNowMs(clk, millis()) - ((long long)tv.tv_sec*1000 + tv.tv_usec/1000) : 0;
+  Serial.printf("[CLK] %s | Drift %+.1f ppm, Samples %u, neu angesetzt %u, angehoben %u | System - Schätzung %lld ms | NTP %s (%u Starts)\n",
+                clk.valid ? "Poller-Zeit" : "keine Poller-Zeit", clk.drift*1e6f, clk.samples, clk.steps, clk.raises,
+                -d, boot.ntpOn ? "an" : "aus", boot.ntpStarts);
+}
+#endif
+
+// ===== Geräte (Seite "Anlage"): Poller füllt nach jeder Runde, Client aus STATS_DEVICES =====
+static PvDevInfo devInfo[PV_MAX_DEVICES];
+static uint8_t   devCount = 0;
+bool pvGetDevices(const PvDevInfo*& d, uint8_t& n){ d = devInfo; n = devCount; return n > 0; }
 
 // ===== Seitensteuerung =====
 static int pageIndex = 0;  // wird durch Swipe geändert
@@ -71,431 +207,702 @@ static const int TOUCH_X_MAX = 3700;
 static const int TOUCH_Y_MIN = 240;
 static const int TOUCH_Y_MAX = 3800;
 
-// Swipe-Erkennung
-static const int SWIPE_MIN_DIST = 60;     // min. 60 px horizontal
-static const int SWIPE_MAX_TIME = 1000;   // max. 1s
-static const int TAP_MAX_DIST   = 15;     // kleiner Versatz -> Tap
-static const int TOUCH_SAMPLES  = 3;      // Mittelung
+// Abtastung (Gesten-Schwellen in PvGesture.h: PVG_SWIPE_MIN_DIST, PVG_SWIPE_MAX_TIME, ...)
+static const uint32_t TOUCH_SAMPLE_MS = 10;    // 100 Hz solange berührt
+static const uint32_t TOUCH_IDLE_MS   = 500;   // Sicherheits-Abfrage, falls eine IRQ-Flanke fehlt
 
-static bool     tsDown     = false;
-static int      tsStartX   = 0;
-static int      tsStartY   = 0;
-static uint32_t tsStartMs  = 0;
-// während Touch letzte valide Pos merken (robust gegen Aussetzer)
-static int      tsLastX    = 0;
-static int      tsLastY    = 0;
+static PvTouchRing   touchRing;                // Touch-Task -> loop (zeitgestempelt, roh)
+static PvTouchInput  touchIn;                  // Filter + Gesten-Automat (loop)
+static TaskHandle_t  touchTask = nullptr;
+static bool          touchRec  = false;        // Serial 'g': Samples für tools/pvgesture.cpp ausgeben
 
 // ===== Integrations-/Speicher-Modelle =====
-struct DayAgg {   // Tageswerte
-  float gen_kWh;
-  float load_kWh;
-  float impT1_kWh;
-  float impT2_kWh;
-  float exp_kWh;
-};
-struct MonthAgg { // Monatswerte
-  float gen_kWh;
-  float load_kWh;
-  float impT1_kWh;
-  float impT2_kWh;
-  float exp_kWh;
-};
+// Exakte Ganzzahl-Akkus (PvEnergy.h), Kanäle PVE_GEN/LOAD/IMP_T1/IMP_T2/EXP, dazu die
+// Spitzen (PvPeak.h) in .pk
+typedef PvAgg DayAgg;     // Tageswerte
+typedef PvAgg MonthAgg;   // Monatswerte
 
-static DayAgg   dayAgg = {0,0,0,0,0};
-static MonthAgg monthAgg = {0,0,0,0,0};
+static DayAgg   dayAgg   = {};
+static MonthAgg monthAgg = {};
 
 Preferences prefs;
 
 // Integrations-Zwischenwerte
-static uint32_t lastIntMs = 0;
-static int32_t  pvPrev=0, gridPrev=0, battPrev=0;
+static PvEnergyIntegrator integ;
+static PvPeakWin          peakWin;   // 15-min-Mittel (PvPeak.h), läuft über Mitternacht weiter
 
 // Tages-/Monatsanker
 static int curY=0, curM=0, curD=0;
 
+// ===== Batterie (PvBatt.h): Poller schätzt je Frame, Clients lesen den Anhang =====
+static PvBattEta battEta;
+static bool      battOk = false;   // Client: letzter Frame mit Anhang (ältere Poller: eta20s im Frame)
+
+// ===== Strom sparen (PvSleep.h): Client-Funk nach Plan des Pollers, Backlight auf beiden Rollen =====
+static uint8_t   blLevel = PV_BL_DAY;   // wahrgenommene Helligkeit (PWM: pvBacklightDuty)
+static PvAmbient ambient;               // LDR geglättet (nur mit PV_LDR_PIN)
+static uint32_t  touchLastMs = 0;       // letzte Berührung (loop)
+#ifndef ROLE_POLLER
+static PvSleep      slp;                // UDP-Task (Frames) und loop()
+static portMUX_TYPE sleepMux = portMUX_INITIALIZER_UNLOCKED;
+static bool         slpRadio = false, slpCpuLow = false;   // zuletzt gesetzt
+#endif
+bool pvGetBattEta(PvBattEta& e){ e = battEta; return battOk; }
+
+// ===== Poller-Wahl (PvElect.h): nur Poller-Build mit PV_ELECT, sonst immer aktiv =====
+#ifdef ROLE_POLLER
+#ifdef PV_ELECT
+static PvElect      elect;                 // loop() und UDP-Task (Heartbeats) unter electMux
+static portMUX_TYPE electMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t      electAct = 0;          // PVEA_* aus dem UDP-Task, erledigt loop()
+static inline bool  electActive(){ return elect.state == PVEL_ACTIVE; }
+#else
+static inline bool  electActive(){ return true; }
+#endif
+#endif
+
 // ===== Hooks für die Anzeigen =====
-bool pvGetTodayPV(float& pv_kWh){ pv_kWh = dayAgg.gen_kWh; return true; }
-bool pvGetTodayLoad(float& load_kWh){ load_kWh = dayAgg.load_kWh; return true; }
-bool pvGetTodayExport(float& exp_kWh){ exp_kWh = dayAgg.exp_kWh; return true; }
-bool pvGetTodaySplits(float& t1_kWh, float& t2_kWh){ t1_kWh = dayAgg.impT1_kWh; t2_kWh = dayAgg.impT2_kWh; return true; }
+bool pvGetTodayPV(float& pv_kWh){ pv_kWh = pvKWh(dayAgg.e[PVE_GEN]); return true; }
+bool pvGetTodayLoad(float& load_kWh){ load_kWh = pvKWh(dayAgg.e[PVE_LOAD]); return true; }
+bool pvGetTodayExport(float& exp_kWh){ exp_kWh = pvKWh(dayAgg.e[PVE_EXP]); return true; }
+bool pvGetTodaySplits(float& t1_kWh, float& t2_kWh){ t1_kWh = pvKWh(dayAgg.e[PVE_IMP_T1]); t2_kWh = pvKWh(dayAgg.e[PVE_IMP_T2]); return true; }
 bool pvGetMonthTotals(float& pv_kWh, float& load_kWh, float& t1_kWh, float& t2_kWh, float& exp_kWh){
-  pv_kWh=monthAgg.gen_kWh; load_kWh=monthAgg.load_kWh; t1_kWh=monthAgg.impT1_kWh; t2_kWh=monthAgg.impT2_kWh; exp_kWh=monthAgg.exp_kWh; return true;
+  PvEnergyKWh k = pvEnergyToKWh(monthAgg);
+  pv_kWh=k.gen_kWh; load_kWh=k.load_kWh; t1_kWh=k.impT1_kWh; t2_kWh=k.impT2_kWh; exp_kWh=k.exp_kWh; return true;
 }
 
 // ===== Zeit/Helfer =====
-static inline void nowLocal(struct tm& ti){ time_t n; time(&n); localtime_r(&n,&ti); }
-static inline void todayYMD(int &y,int &m,int &d){ struct tm ti; nowLocal(ti); y=ti.tm_year+1900; m=ti.tm_mon+1; d=ti.tm_mday; }
+// Datum/Tarif aus dem Kalender-Cache (PvCalendar.h): localtime_r() nur an Grenzen
+static inline void todayYMD(int &y,int &m,int &d){ const PvCalendar c = pvCalNow(); y=c.y; m=c.m; d=c.d; }
 static inline bool isLeap(int y){ return ((y%4==0)&&(y%100!=0)) || (y%400==0); }
 static int daysInMonth(int y,int m){ static const uint8_t dm[12]={31,28,31,30,31,30,31,31,30,31,30,31}; return m==2? dm[m-1]+(isLeap(y)?1:0) : dm[m-1]; }
-static inline bool isT1_now(){ struct tm ti; nowLocal(ti); return (ti.tm_wday>=1 && ti.tm_wday<=5) && (ti.tm_hour>=7 && ti.tm_hour<18); }
+static inline bool isT1_now(){ return pvCalNow().tariff == PV_T1; }
 
 static void nvsBegin(){ static bool b=false; if(!b){ prefs.begin("pvstats", false); b=true; } }
 static String keyDay(int y,int m,int d){ char b[16]; snprintf(b,sizeof(b),"D%04d%02d%02d",y,m,d); return String(b); }
 static String keyMon(int y,int m){ char b[16]; snprintf(b,sizeof(b),"M%04d%02d",y,m); return String(b); }
 
-static void saveDayToNVS(int y,int m,int d,const DayAgg& a){ nvsBegin(); prefs.putBytes(keyDay(y,m,d).c_str(), &a, sizeof(a)); }
-static bool loadDayFromNVS(int y,int m,int d, DayAgg& a){ nvsBegin(); size_t got=prefs.getBytes(keyDay(y,m,d).c_str(), &a, sizeof(a)); return got==sizeof(a); }
-static void saveMonthToNVS(int y,int m,const MonthAgg& a){ nvsBegin(); prefs.putBytes(keyMon(y,m).c_str(), &a, sizeof(a)); }
-static bool loadMonthFromNVS(int y,int m, MonthAgg& a){ nvsBegin(); size_t got=prefs.getBytes(keyMon(y,m).c_str(), &a, sizeof(a)); if (got!=sizeof(a)) a={0,0,0,0,0}; return got==sizeof(a); }
+// Record v2 (int64) schreiben, Tage/Monate v3 mit Spitzen; lesen auch alte float-Blobs (v1)
+static void saveAggToNVS(const String& key, const PvEnergy& a){ nvsBegin(); PvEnergyRec r; pvEnergyEncode(a, r); prefs.putBytes(key.c_str(), &r, sizeof(r)); }
+static void saveAggToNVS(const String& key, const PvAgg& a){ nvsBegin(); uint8_t b[PV_EREC_MAX]; prefs.putBytes(key.c_str(), b, pvAggEncode(a, b)); }
+static bool loadAggFromNVS(const String& key, PvAgg& a){
+  nvsBegin();
+  uint8_t b[PV_EREC_MAX]; size_t n = prefs.getBytesLength(key.c_str());
+  if (n==0 || n>sizeof(b) || prefs.getBytes(key.c_str(), b, n)!=n){ pvAggClear(a); return false; }
+  return pvAggDecode(b, n, a);
+}
+static bool loadAggFromNVS(const String& key, PvEnergy& a){ PvAgg t; const bool ok = loadAggFromNVS(key, t); a = t; return ok; }
+// Woche/Monat/Jahr (PvRollup.h): jeder geschriebene Tag bringt seine Differenz zum alten
+// Record mit, die Monats-Keys sind damit immer die Summe der Tage (kein Sichern am Monatswechsel)
+static PvRollup rollup;
+static PvRollupPrefs<Preferences> rollupStore{prefs};
+
+// Tag schreiben (alter Record, neuer Record, Differenz in die Stufen, Digest) und Tageswechsel
+// laufen im UDP-Task (Teile, Spitzen, Karussell, STATS_DAY) wie in loop(): ein Lock für beide,
+// sonst zählen Woche/Monat/Jahr einen Tag doppelt oder verlieren ihn. Rekursiv, weil der
+// Tageswechsel selbst Tage schreibt. Auch um dayAgg/monthAgg (Integration, Spitzen)
+static SemaphoreHandle_t dayMux = nullptr;   // setup(), vor den UDP-Handlern
+struct DayLock {
+  DayLock(){ xSemaphoreTakeRecursive(dayMux, portMAX_DELAY); }
+  ~DayLock(){ xSemaphoreGiveRecursive(dayMux); }
+};
 
-// ===== Integration (trapez) =====
-static void integrateTick(int32_t pvW, int32_t gridW, int32_t battW){
-  uint32_t nowMs = millis();
-  if (lastIntMs==0){ lastIntMs=nowMs; pvPrev=pvW; gridPrev=gridW; battPrev=battW; return; }
-  uint32_t dt = nowMs - lastIntMs; if (!dt){ pvPrev=pvW; gridPrev=gridW; battPrev=battW; return; }
-  lastIntMs = nowMs;
+// Digest über alle Tage (PvPeer.h), ebenso bei jedem Schreiben nachgeführt; gelesen beim
+// ersten Zugriff, fehlt er (ältere Firmware), baut ihn digestCheck() neu auf
+static PvDigest        dig;
+static PvDigestRebuild digRb;
+static bool            digLoaded = false, digValid = false;
+
+static void digBegin(){
+  if (digLoaded) return;
+  digLoaded = true; nvsBegin();
+  PvDigest d;
+  if (prefs.getBytesLength("dig") == sizeof(d) && prefs.getBytes("dig", &d, sizeof(d)) == sizeof(d) && d.ver == PV_DIGEST_VERSION){ dig = d; digValid = true; }
+}
+
+static void saveDayToNVS(int y,int m,int d,const DayAgg& a){
+  PV_TRACE_SCOPE(PVT_NVS_SAVE, y*10000+m*100+d);
+  DayLock lk;
+  DayAgg old; loadAggFromNVS(keyDay(y,m,d), old);   // fehlt -> 0
+  saveAggToNVS(keyDay(y,m,d), a);
+  pvRollupDay(rollup, rollupStore, pvDayNum(y,m,d), old, a);
+  digBegin();
+  pvDigestOnSave(dig, digRb, pvDayNum(y,m,d), old, a);
+  if (digValid && !digRb.active) prefs.putBytes("dig", &dig, sizeof(dig));
+}
+static bool loadDayFromNVS(int y,int m,int d, DayAgg& a){ PV_TRACE_SCOPE(PVT_NVS_LOAD, y*10000+m*100+d); return loadAggFromNVS(keyDay(y,m,d), a); }
+#ifndef ROLE_POLLER
+static void saveMonthToNVS(int y,int m,const MonthAgg& a){ PV_TRACE_SCOPE(PVT_NVS_SAVE, y*100+m); saveAggToNVS(keyMon(y,m), a); }   // nur Spitzen (peakApply), Energie führt pvRollupDay
+#endif
+static bool loadMonthFromNVS(int y,int m, MonthAgg& a){ PV_TRACE_SCOPE(PVT_NVS_LOAD, y*100+m); return loadAggFromNVS(keyMon(y,m), a); }
+
+// Firmware ohne Stufen (nur D/M-Keys): einmal aus den Tagen aufbauen, stückweise aus loop()
+static void rollupCheck(int y,int m,int d){
+  nvsBegin();
+  digBegin();
+  if (!digValid && !digRb.active){
+    pvDigestRebuildStart(digRb, pvDayNum(y - PV_ROLLUP_YEARS, 1, 1), pvDayNum(y,m,d));
+    Serial.println("[PEER] Digest-Neuaufbau aus den Tagesrecords");
+  }
+  if (prefs.getUChar("rollup", 0) == PV_ROLLUP_VERSION) return;
+  pvRollupRebuildStart(rollup, pvDayNum(y - PV_ROLLUP_YEARS, 1, 1), pvDayNum(y,m,d));
+  Serial.printf("[ROLLUP] Neuaufbau ab %d aus den Tagesrecords\n", y - PV_ROLLUP_YEARS);
+}
+
+static void rollupTick(){
+  if (digRb.active && pvDigestRebuildStep(digRb, rollupStore, PV_ROLLUP_STEP_DAYS, dig)){
+    digValid = true;
+    prefs.putBytes("dig", &dig, sizeof(dig));
+    Serial.printf("[PEER] Digest fertig: %u Tage\n", dig.days);
+  }
+  if (!rollup.rebuilding) return;
+  PV_TRACE_SCOPE(PVT_NVS_LOAD, 0);
+  if (!pvRollupRebuildStep(rollup, rollupStore, PV_ROLLUP_STEP_DAYS)) return;
+  prefs.putUChar("rollup", PV_ROLLUP_VERSION);
+  Serial.printf("[ROLLUP] Neuaufbau fertig: %u Tage\n", rollup.rebuilt);
+}
 
-  // PV >= 0
-  double pv0 = pvPrev>0 ? pvPrev : 0; double pv1 = pvW>0 ? pvW : 0;
-  double ePv_Wh = ((pv0 + pv1) * 0.5) * (dt / 3600000.0);
+static void printRollup(){
+  const PvCalendar c = pvCalNow();
+  const int32_t today = pvDayNum(c.y, c.m, c.d);
+  Serial.printf("[ROLLUP] %u Tage geschrieben, %u Stufen-Records, Neuaufbau %s (%u Tage)\n",
+                rollup.days, rollup.writes, rollup.rebuilding ? "läuft" : "fertig", rollup.rebuilt);
+  static const char* nm[PVL_COUNT] = { "Tag", "Woche", "Monat", "Jahr" };
+  for (uint8_t lvl = PVL_WEEK; lvl < PVL_COUNT; ++lvl){
+    PvEnergy a; uint32_t id = pvRollupId(lvl, today);
+    pvRollupRange(rollupStore, lvl, id, 1, &a, nullptr);
+    PvEnergyKWh k = pvEnergyToKWh(a);
+    Serial.printf("  %-5s %-7u PV %.1f  Last %.1f  T1 %.1f  T2 %.1f  Exp %.1f kWh (ohne heute)\n",
+                  nm[lvl], id, k.gen_kWh, k.load_kWh, k.impT1_kWh, k.impT2_kWh, k.exp_kWh);
+  }
+}
 
-  // Grid: Export>0, Import<0
-  double g0 = gridPrev, g1 = gridW;
-  double exp0 = g0>0 ? g0 : 0, exp1 = g1>0 ? g1 : 0;
-  double imp0 = g0<0 ? -g0: 0, imp1 = g1<0 ? -g1: 0;
-  double eExp_Wh = ((exp0 + exp1) * 0.5) * (dt / 3600000.0);
-  double eImp_Wh = ((imp0 + imp1) * 0.5) * (dt / 3600000.0);
+// ===== Verlauf über TCP (PvExport.h): Sicherung und Ersatzgerät =====
+// Eine Verbindung zur Zeit, stückweise aus loop(). Direkt über nvs.h statt Preferences: dort
+// schreibt jedes putBytes() mit eigenem Commit, hier gibt es einen je Block (und keine
+// Fehlermeldung je fehlendem Tag)
+struct PvNvsBatch {
+  nvs_handle_t h = 0;
+  bool         open = false;
+  bool begin(){ if (!open) open = nvs_open("pvstats", NVS_READWRITE, &h) == ESP_OK; return open; }
+  void end(){ if (open){ nvs_close(h); open = false; } }
+  size_t getBytesLength(const char* k){ size_t n = 0; return nvs_get_blob(h, k, nullptr, &n) == ESP_OK ? n : 0; }
+  size_t getBytes(const char* k, void* b, size_t n){ size_t l = n; return nvs_get_blob(h, k, b, &l) == ESP_OK ? l : 0; }
+  size_t putBytes(const char* k, const void* b, size_t n){ return nvs_set_blob(h, k, b, n) == ESP_OK ? n : 0; }
+  void commit(){ nvs_commit(h); }
+};
 
-  // Load = PV - Grid - Batt (nur >=0 integrieren)
-  double l0 = pvPrev - gridPrev - battPrev; if (l0<0) l0=0;
-  double l1 = pvW    - gridW    - battW;    if (l1<0) l1=0;
-  double eLoad_Wh = ((l0 + l1) * 0.5) * (dt / 3600000.0);
+static WiFiServer  histSrv(PV_EXPORT_PORT);
+static WiFiClient  histCli;
+static PvNvsBatch  histNvs;
+static PvExport*   histEx = nullptr;   // nur während einer Verbindung (je ~9 KB)
+static PvImport*   histIm = nullptr;
+static bool        histListen = false;
+static uint32_t    histLastMs = 0, histStartMs = 0, histSessions = 0;
+#ifdef ROLE_POLLER
+static const uint8_t HIST_DEVS = PV_DEVICE_COUNT;
+#else
+static const uint8_t HIST_DEVS = 0;
+#endif
+static inline bool histBusy(){ return histCli.connected(); }
+
+// nach dem Import: Stufen und Digest aus den Tagen neu, Monat = gesicherte Tage + heute
+static void histImported(){
+  DayLock lk;
+  prefs.putUChar("rollup", 0);
+  digValid = false; digRb.active = false;
+  rollupCheck(curY, curM, curD);
+  MonthAgg t; pvAggClear(t);
+  for (int d = 1; d < curD; ++d){ DayAgg a; if (loadDayFromNVS(curY, curM, d, a)) pvAggAdd(t, a); }
+  pvEnergyAdd(t, dayAgg);
+  pvPeakMerge(t.pk, monthAgg.pk);
+  monthAgg = t;
+}
 
-  // Tagesakkus
-  dayAgg.gen_kWh  += ePv_Wh   / 1000.0;
-  dayAgg.exp_kWh  += eExp_Wh  / 1000.0;
-  dayAgg.load_kWh += eLoad_Wh / 1000.0;
-  if (eImp_Wh>0){
-    if (isT1_now()) dayAgg.impT1_kWh += eImp_Wh/1000.0;
-    else            dayAgg.impT2_kWh += eImp_Wh/1000.0;
+static void histEnd(const char* why){
+  const uint32_t ms = millis() - histStartMs;
+  if (histEx){
+    Serial.printf("[HIST] Export %s: %u Records, %u Blöcke, %u -> %u Bytes in %u ms\n", why,
+                  histEx->recs, histEx->blocks, histEx->rawBytes, histEx->outBytes, ms);
+    delete histEx; histEx = nullptr;
   }
+  if (histIm){
+    pvImportClose(*histIm);             // unvollständig -> PVXE_TRUNC
+    const PvImportRes res = pvImportResult(*histIm);
+    uint8_t b[PvWire<PvImportRes>::size];
+    if (histCli.connected()) histCli.write(b, pvWireEncode(res, b));
+    Serial.printf("[HIST] Import %s (%s): %u Records, %u geschrieben, %u gleich, %u übersprungen, %u Commits in %u ms\n",
+                  why, pvExportErrName(res.err), res.recs, res.written, res.same, res.skipped, res.commits, ms);
+    if (histIm->days) histImported();
+    delete histIm; histIm = nullptr;
+  }
+  histNvs.end();
+  histCli.stop();
+}
 
-  // Monatsakkus
-  monthAgg.gen_kWh  += ePv_Wh   / 1000.0;
-  monthAgg.exp_kWh  += eExp_Wh  / 1000.0;
-  monthAgg.load_kWh += eLoad_Wh / 1000.0;
-  if (eImp_Wh>0){
-    if (isT1_now()) monthAgg.impT1_kWh += eImp_Wh/1000.0;
-    else            monthAgg.impT2_kWh += eImp_Wh/1000.0;
+static void histTick(){
+  if (!boot.wifiUp || curY <= 2000){   // Bereich/heute brauchen das Datum
+    if (histCli) histEnd("abgebrochen (WLAN)");
+    return;
   }
+  if (!histListen){ histSrv.begin(); histListen = true; }
+  const uint32_t now = millis();
+  if (!histCli){
+    histCli = histSrv.accept();
+    if (!histCli) return;
+    histCli.setNoDelay(true);
+    histStartMs = histLastMs = now;
+    histSessions++;
+  }
+  if (!histEx && !histIm){             // Befehl "PVXE" / "PVXI"
+    if (histCli.available() < 4){
+      if (now - histLastMs > PV_EXPORT_IDLE_MS || !histCli.connected()) histCli.stop();
+      return;
+    }
+    char cmd[4]; histCli.read((uint8_t*)cmd, 4);
+    const int32_t today = pvDayNum(curY, curM, curD);
+    if (!memcmp(cmd, "PVXE", 4)) histEx = new (std::nothrow) PvExport;
+    else if (!memcmp(cmd, "PVXI", 4)) histIm = new (std::nothrow) PvImport;
+    if ((!histEx && !histIm) || !histNvs.begin()){ histEnd("abgelehnt"); return; }
+    if (histEx) pvExportBegin(*histEx, pvDayNum(curY - PV_EXPORT_YEARS, 1, 1), today, HIST_DEVS);
+    else pvImportBegin(*histIm, today, HIST_DEVS);
+    histLastMs = now;
+  }
+  if (histEx){
+    if (pvExportStep(*histEx, histNvs, PV_EXPORT_STEP_KEYS,
+                     [](const uint8_t* p, size_t n){ return histCli.write(p, n) == n; }))
+      histEnd(histEx->err ? pvExportErrName(histEx->err) : "fertig");
+    return;
+  }
+  uint8_t b[1024];
+  const int n = histCli.read(b, sizeof(b));
+  if (n > 0){ DayLock lk; pvImportFeed(*histIm, histNvs, b, (size_t)n); histLastMs = now; }
+  if (pvImportDone(*histIm)) histEnd("fertig");
+  else if (!histCli.connected() && !histCli.available()) histEnd("abgebrochen");
+  else if (now - histLastMs > PV_EXPORT_IDLE_MS) histEnd("Zeitüberschreitung");
+}
 
-  pvPrev=pvW; gridPrev=gridW; battPrev=battW;
+static void printHist(){
+  Serial.printf("[HIST] TCP-Port %u %s, %u Verbindungen, %s\n", PV_EXPORT_PORT, histListen ? "offen" : "zu",
+                histSessions, histEx ? "Export läuft" : histIm ? "Import läuft" : "frei");
+}
+
+// ===== Energie je Frame (PvFill.h) =====
+// Poller: was seit dem letzten Frame integriert wurde, geht als Teil an den nächsten Frame und
+// in den Ring. Client: addiert die Teile statt selbst zu integrieren (ältere Poller: wie bisher)
+static portMUX_TYPE fillMux = portMUX_INITIALIZER_UNLOCKED;
+#ifdef ROLE_POLLER
+static PvFillRing   fill;                      // nur loop()
+struct FillAsk { IPAddress ip; uint16_t port; PayloadFillReq q; };
+static FillAsk      fillAsk[4];                // Anfragen aus dem UDP-Task, beantwortet in loop()
+static uint8_t      fillAskN = 0;
+#else
+static PvFillClient  fillRx;                   // UDP-Task (Frames, STATS_FILL) und loop()
+static volatile bool fillOn = false;           // letzter Frame mit Teilen
+static int32_t       fillFinal = 0;            // bis hier Records vom Poller, Teile schon drin
+static uint32_t      fillLostMark = 0;         // fillRx.lost beim letzten Tageswechsel
+static uint32_t      fillPastMark = 0;         // ... bei der letzten Prüfung in fillClientTick()
+static int32_t       fillSeenDay = 0;          // eigener Tag beim letzten Frame
+static int32_t       fillGapDay = 0;           // ... beim Frame vor der ältesten offenen Lücke
+#endif
+
+// ===== Integration (trapez) =====
+// Ganzzahlig (PvEnergy.h): exakt, keine Soft-Float-Aufrufe je Tick
+static void integrateTick(int32_t pvW, int32_t gridW, int32_t battW){
+  DayLock lk;
+  PvEnergy d;
+  if (!pvEnergyStep(integ, pvW, gridW, battW, millis(), isT1_now(), d)) return;
+  pvEnergyAdd(dayAgg, d);     // Tagesakkus
+  pvEnergyAdd(monthAgg, d);   // Monatsakkus
+#ifdef ROLE_POLLER
+  pvFillAdd(fill, d);         // Teil für den nächsten Frame
+#endif
+}
+
+// ===== Spitzen (PvPeak.h) =====
+// Jeder Frame in Tag und Monat. Clients übernehmen die des Pollers (STATS_PEAKS, peakApply) und
+// zählen selbst nur, solange keine kommen (ältere Poller); das Fenster läuft immer mit
+#ifndef ROLE_POLLER
+static volatile uint32_t peakRxMs = 0;   // letztes STATS_PEAKS
+#endif
+static void peakTick(const PvFrameV4& f){
+  DayLock lk;
+  PvPeakSample s;
+  if (curY <= 2000 || !pvPeakStep(peakWin, f.ts, f.pvW, f.gridW, f.battW, f.socx10, isT1_now(), s)) return;
+#ifndef ROLE_POLLER
+  if (peakRxMs && millis() - peakRxMs < PV_PEAK_OWN_MS) return;
+#endif
+  pvPeakAdd(dayAgg.pk, s);
+  pvPeakAdd(monthAgg.pk, s);
+}
+
+static void printPeak(const char* name, int32_t v, uint32_t ts, const char* unit){
+  if (!ts){ Serial.printf("  %-12s -\n", name); return; }
+  time_t t = ts; struct tm tm; localtime_r(&t, &tm);
+  Serial.printf("  %-12s %7ld %-4s %02d.%02d. %02d:%02d\n", name, (long)v, unit, tm.tm_mday, tm.tm_mon+1, tm.tm_hour, tm.tm_min);
+}
+
+static void printPeaks(){
+  for (uint8_t k=0; k<2; ++k){
+    const PvPeaks& p = k ? monthAgg.pk : dayAgg.pk;
+    Serial.printf("[PEAK] %s, %u Samples\n", k ? "Monat" : "Heute", p.n);
+    printPeak("Bezug", p.impW, p.impTs, "W");
+    printPeak("Einspeisung", p.expW, p.expTs, "W");
+    printPeak("PV", p.pvW, p.pvTs, "W");
+    printPeak("Verbrauch", p.loadW, p.loadTs, "W");
+    printPeak("Laden", p.chgW, p.chgTs, "W");
+    printPeak("Entladen", p.disW, p.disTs, "W");
+    printPeak("SoC min", p.socLo, p.socLoTs, "0.1%");
+    printPeak("SoC max", p.socHi, p.socHiTs, "0.1%");
+    printPeak("15 min", p.demW, p.demTs, "W");
+    printPeak("15 min T1", p.demT1W, p.demT1Ts, "W");
+    printPeak("15 min T2", p.demT2W, p.demT2Ts, "W");
+  }
+  Serial.printf("[PEAK] Fenster %u s abgedeckt | Samples %u, Lücken %u, Uhr zurück %u\n",
+                peakWin.covSum, peakWin.samples, peakWin.gaps, peakWin.resets);
 }
 
 // ===== Tages-/Monatswechsel =====
+#ifdef ROLE_POLLER
+static void devEnergySave(int y,int m,int d, bool month);   // PV je Gerät (Poller-Teil unten)
+static void devEnergyLoad(int y,int m,int d);
+static void statsSendPeaks(IPAddress ip, uint16_t port, int32_t day, uint8_t lvl, const PvPeaks& pk);
+#else
+static bool carRolloverTail();   // Verlauf-Karussell (Client-Teil unten)
+
+// Gestern vollständig aus Teilen des Pollers? Sonst (älterer Poller, Frames verloren) die
+// letzten Blöcke noch einmal vom Poller; spätere Teile für gestern sind dann schon drin
+static void fillRollover(int32_t yesterday){
+  const bool lost = fillRx.lost != fillLostMark;
+  fillLostMark = fillRx.lost;
+  if (fillOn && !lost) return;
+  if (carRolloverTail()) fillFinal = yesterday;
+}
+#endif
+
+// Akkus aus dem Boot-Cache, sobald das Datum stimmt: gleicher Tag/Monat -> weiterzählen,
+// vergangener Tag/Monat -> als Record sichern, falls im NVS keiner ist (Ausfall über Mitternacht)
+static void bootRestoreAggs(int y,int m,int d){
+  if (!bootCacheOk) return;
+  bootCacheOk = false;
+  const uint32_t c = bootCache.ymd;
+  const uint8_t plan = pvBootRestorePlan(c, pvYmd(y,m,d));
+  const int cy = c/10000, cm = c/100%100, cd = c%100;
+  DayAgg tmp, day;
+  static_cast<PvEnergy&>(day) = bootCache.day; day.pk = bootCache.dayPk;
+  if (plan & PVBR_DAY)   dayAgg = day;
+  if (plan & PVBR_MONTH){ static_cast<PvEnergy&>(monthAgg) = bootCache.month; monthAgg.pk = bootCache.monthPk; }
+  // vergangener Monat (PVBR_SAVE_MONTH) ergibt sich aus dem gesicherten Tag (PvRollup.h)
+  if ((plan & PVBR_SAVE_DAY)   && !loadDayFromNVS(cy,cm,cd,tmp)) saveDayToNVS(cy,cm,cd, day);
+  Serial.printf("[BOOT] Akkus vom %u: %s\n", c, plan ? ((plan & PVBR_DAY) ? "übernommen" : "gesichert") : "verworfen");
+}
+
+// aus loop() und dem Frame-Handler (Client, folgender Poller): unter dem Lock sieht der zweite
+// den Tag schon gewechselt
 static void handleDayMonthRollover(){
-  int y,m,d; todayYMD(y,m,d);
-  if (curY<=2000){ // init
+  DayLock lk;
+  int y,m,d; todayYMD(y,m,d);   // pro Loop nur ein Vergleich mit nextBoundary
+  rollupTick();
+  if (curY<=2000){ // init (erstmals gültige Uhr, s. bootTick)
     curY=y;curM=m;curD=d;
+    rollupCheck(y,m,d);
     loadMonthFromNVS(y,m, monthAgg);
     DayAgg tmp; if (loadDayFromNVS(y,m,d,tmp)) dayAgg=tmp;
+    bootRestoreAggs(y,m,d);
+#ifdef ROLE_POLLER
+    devEnergyLoad(y,m,d);
+#endif
     return;
   }
   if (d!=curD){
+    PV_TRACE_SCOPE(PVT_ROLLOVER, y*10000+m*100+d);
     // gestern sichern
     saveDayToNVS(curY,curM,curD, dayAgg);
-    // Monatswechsel?
+#ifdef ROLE_POLLER
+    devEnergySave(curY,curM,curD, curM!=m);
+    // letzter Stand der Spitzen von gestern (und vom Monat) an die Clients
+    if (electActive()){
+      statsSendPeaks(STATS_MCAST_GRP, STATS_MCAST_PORT, pvDayNum(curY,curM,curD), PVL_DAY, dayAgg.pk);
+      if (curM!=m) statsSendPeaks(STATS_MCAST_GRP, STATS_MCAST_PORT, pvDayNum(curY,curM,1), PVL_MONTH, monthAgg.pk);
+    }
+    if (!pvEnergyZero(fill.acc)) pvFillClose(fill, lastSeq+1, pvDayNum(curY,curM,curD));   // Rest von gestern: mit dem nächsten Frame
+#else
+    fillRollover(pvDayNum(curY,curM,curD));
+#endif
+    // Monatswechsel? (Monats-Key ist mit dem Tag schon nachgeführt)
     if (curM!=m){
-      saveMonthToNVS(curY,curM, monthAgg);
-      monthAgg={0,0,0,0,0};
+      pvAggClear(monthAgg);
       loadMonthFromNVS(y,m, monthAgg); // evtl. laden (falls existiert)
     }
     // neuer Tag
     curY=y;curM=m;curD=d;
-    dayAgg={0,0,0,0,0};
+    pvAggClear(dayAgg);
     DayAgg tmp; if (loadDayFromNVS(y,m,d,tmp)) dayAgg=tmp;
+#ifdef ROLE_POLLER
+    devEnergyLoad(y,m,d);   // neuer Monat: Schlüssel fehlt -> 0
+#endif
   }
 }
 
-// ===== Touch lesen =====
-static bool readTouchAvg(int &x, int &y) {
-  if (!(touchscreen.tirqTouched() && touchscreen.touched())) return false; // falls T_IRQ nicht angeschlossen -> nur touchscreen.touched()
-
-  long sx = 0, sy = 0; int n = 0;
-  for (int i=0; i<TOUCH_SAMPLES; ++i) {
-    if (!(touchscreen.tirqTouched() && touchscreen.touched())) break;
-    TS_Point p = touchscreen.getPoint(); // roher Wert
-    int rx = map(p.x, TOUCH_X_MIN, TOUCH_X_MAX, 1, SCREEN_W);
-    int ry = map(p.y, TOUCH_Y_MIN, TOUCH_Y_MAX, 1, SCREEN_H);
-    if (rx < 1) rx = 1; if (rx > SCREEN_W) rx = SCREEN_W;
-    if (ry < 1) ry = 1; if (ry > SCREEN_H) ry = SCREEN_H;
-    sx += rx; sy += ry; n++;
-    delay(2);
-  }
-  if (n == 0) return false;
-  x = (int)(sx / n);
-  y = (int)(sy / n);
-  return true;
+// ===== Touch: IRQ -> Task -> Ring =====
+// T_IRQ (PENIRQ) fällt bei Berührung: ISR weckt den Task, der tastet mit 100 Hz ab, bis
+// losgelassen wird, und legt die Samples in touchRing. Kein delay() mehr in loop().
+static void IRAM_ATTR touchIsr(){
+  BaseType_t woken = pdFALSE;
+  if (touchTask) vTaskNotifyGiveFromISR(touchTask, &woken);
+  if (woken) portYIELD_FROM_ISR();
 }
 
-// ===== Swipe / Touch =====
-static void handleTouchSwipe(){
-  if (!haveFrame) return; // erst reagieren, wenn Daten da sind
-
-  int x=0, y=0;
-  bool touching = readTouchAvg(x,y);
-
-  if (!tsDown) {
-    if (touching) {
-      tsDown    = true;
-      tsStartX  = x;
-      tsStartY  = y;
-      tsLastX   = x;
-      tsLastY   = y;
-      tsStartMs = millis();
+static void touchTaskFn(void*){
+  for (;;){
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TOUCH_IDLE_MS));
+    bool down = false;
+    while (touchscreen.touched()){
+      PV_TRACE_SCOPE(PVT_TOUCH_READ, 0);
+      TS_Point p = touchscreen.getPoint(); // roher Wert
+      int rx = map(p.x, TOUCH_X_MIN, TOUCH_X_MAX, 1, SCREEN_W);
+      int ry = map(p.y, TOUCH_Y_MIN, TOUCH_Y_MAX, 1, SCREEN_H);
+      if (rx < 1) rx = 1; if (rx > SCREEN_W) rx = SCREEN_W;
+      if (ry < 1) ry = 1; if (ry > SCREEN_H) ry = SCREEN_H;
+      touchRing.push({ millis(), (int16_t)rx, (int16_t)ry, 1 });
+      down = true;
+      vTaskDelay(pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
     }
-    return;
+    if (down) touchRing.push({ millis(), 0, 0, 0 });
+    ulTaskNotifyTake(pdTRUE, 0);   // Flanken durch die eigenen Wandlungen verwerfen
   }
+}
 
-  if (touching) {
-    tsLastX = x;
-    tsLastY = y;
+static void touchBegin(){
+  pinMode(XPT2046_IRQ, INPUT);
+  xTaskCreatePinnedToCore(touchTaskFn, "touch", 3072, nullptr, 2, &touchTask, 1);   // über loop() (Prio 1)
+  attachInterrupt(digitalPinToInterrupt(XPT2046_IRQ), touchIsr, FALLING);
+}
+
+// ====== Zeichnen ======
+// Bandpuffer + DMA; ohne Speicher/DMA direkt (blockierend) wie bisher
+static void flushBegin(){
+#ifdef PV_GFX_LGFX
+  Serial.println("[TFT] LovyanGFX: direkt zeichnen (keine Bandpuffer)");
+#else
+  bool ok = tft.initDMA();
+  for (TFT_eSprite& s : bandSpr){ s.setColorDepth(16); ok = ok && s.createSprite(W, PV_BAND_H) != nullptr; }
+  if (!ok){
+    for (TFT_eSprite& s : bandSpr) s.deleteSprite();
+    Serial.println("[TFT] DMA/Bandpuffer nicht verfügbar -> direkt zeichnen");
     return;
   }
+  flush.bus = &tftBus;
+  flush.buf[0] = (uint16_t*)bandSpr[0].getPointer();
+  flush.buf[1] = (uint16_t*)bandSpr[1].getPointer();
+  flush.w = W; flush.h = H;
+#endif
+}
 
-  // Finger losgelassen
-  tsDown = false;
-  uint32_t dt = millis() - tsStartMs;
-
-  int dx = tsLastX - tsStartX;
-  int dy = tsLastY - tsStartY;
-
-  if ((abs(dx) <= TAP_MAX_DIST) && (abs(dy) <= TAP_MAX_DIST)) return;
-
-  if (dt <= SWIPE_MAX_TIME && abs(dx) >= SWIPE_MIN_DIST && abs(dx) > (abs(dy) * 1.2f)) {
-    int maxPages = pvMaxPages();   // aus PvCommon.h
-    int oldPage  = pageIndex;
+static void printFlushStats(){
+  Serial.printf("[TFT] %u Frames, letzter %u us (zeichnen %u us, DMA-Wartezeit %u us)\n",
+                flush.frames, flush.frameUs, flush.composeUs, flush.waitUs);
+}
 
-    if (dx < 0) { // rechts -> links
-      if (pageIndex < maxPages - 1) pageIndex++;
-    } else {      // links -> rechts
-      if (pageIndex > 0) pageIndex--;
-    }
+static void drawIfFrame(){
+  if (!haveFrame) return;
+  if (!flush.ready()){ drawPvPage(tft, lastF, pageIndex); return; }
+#ifndef PV_GFX_LGFX
+  flush.frame([](uint8_t idx, int16_t y0, int16_t rows){
+    drawPvPageBand(bandSpr[idx], y0, rows, lastF, pageIndex);
+  });
+#endif
+}
 
-    if (pageIndex != oldPage) drawPvPage(tft, lastF, pageIndex);  // ganze Seite neu zeichnen
+// ===== Gesten / Seitenwechsel =====
+static void applyGesture(uint8_t g){
+  int maxPages = pvMaxPages();   // aus PvCommon.h
+  int oldPage  = pageIndex;
+  bool redraw  = false;
+  const int tx = touchIn.g.x0;
+  switch (g){
+    case PVG_SWIPE_LEFT:  if (pageIndex < maxPages - 1) pageIndex++; break;   // rechts -> links
+    case PVG_SWIPE_RIGHT: if (pageIndex > 0) pageIndex--; break;              // links -> rechts
+    case PVG_LONG:        pageIndex = 0; break;                              // lang drücken: Startseite
+    // Verlauf (Seiten 3/4): hoch = gröbere Stufe, runter = feinere; Tap links/rechts = älter/neuer, Mitte = heute
+    case PVG_SWIPE_UP:    redraw = pvChartZoom(pageIndex, +1); break;
+    case PVG_SWIPE_DOWN:  redraw = pvChartZoom(pageIndex, -1); break;
+    case PVG_TAP:         redraw = pvChartPan(pageIndex, tx < W/3 ? -1 : tx > 2*W/3 ? 1 : 0); break;
+    default: return;
+  }
+  PV_TRACE_INSTANT(PVT_SWIPE, pageIndex);
+  if (pageIndex != oldPage || redraw){
+    flush.fence();       // alte Seite komplett beim Display, bevor die neue beginnt
+    drawIfFrame();       // ganze Seite neu zeichnen
   }
 }
 
-// ====== Zeichnen ======
-static void drawIfFrame(){
-  if (!haveFrame) return;
-  drawPvPage(tft, lastF, pageIndex);
+// Samples aus dem Ring holen; Erkennung über Sample-Zeitstempel, daher unabhängig davon,
+// wie lange das letzte Zeichnen gedauert hat
+static void handleTouch(){
+  PvTouchSample s;
+  while (touchRing.pop(s)){
+    if (touchRec) Serial.printf("T %u %d %d %u\n", s.tMs, s.x, s.y, s.down);
+    touchLastMs = s.tMs;
+    uint8_t g = pvTouchInput(touchIn, s);
+    if (g && haveFrame) applyGesture(g);   // erst reagieren, wenn Daten da sind
+  }
+  uint8_t g = pvGestureTick(touchIn.g, millis());
+  if (g && haveFrame) applyGesture(g);
 }
 
 #ifdef ROLE_POLLER
   #include <ModbusIP_ESP8266.h>
   ModbusIP mb;
-  IPAddress inverterIP(192,168,0,10);
-  const uint16_t modbusPort = 502;
-  const uint8_t  unitId     = 2;
-
-// Register
-const uint16_t REG_PV_AC      = 32064; // int32 (Hi,Lo), W
-const uint16_t REG_GRID_P     = 37113; // int32 (Hi,Lo), W, +E/-I
-const uint16_t REG_BATT_P     = 37001; // int32 (Hi,Lo), W, +C/-D
-const uint16_t REG_WR_TEMP    = 32087; // int16 (x10 °C)
-const uint16_t REG_PV_TODAY   = 32114; // uint32 (kWh/100)
-const uint16_t REG_GRID_EXP_T = 37119; // uint32 (kWh/100)
-const uint16_t REG_GRID_IMP_T = 37121; // uint32 (kWh/100)
-const uint16_t REG_BATT_SOCX  = 37004; // uint16 (x10)
-
-// PV1/PV2 Strings
-const uint16_t REG_PV1_V      = 32016; // int16 Vx10
-const uint16_t REG_PV1_A      = 32017; // int16 Ax100
-const uint16_t REG_PV2_V      = 32018; // int16 Vx10
-const uint16_t REG_PV2_A      = 32019; // int16 Ax100
-
-// Netz V/I Phasen
-const uint16_t REG_VA         = 37101; // int32 Vx10
-const uint16_t REG_VB         = 37103; // int32 Vx10
-const uint16_t REG_VC         = 37105; // int32 Vx10
-const uint16_t REG_IA         = 37107; // int32 Ax100 (signed)
-const uint16_t REG_IB         = 37109; // int32 Ax100 (signed)
-const uint16_t REG_IC         = 37111; // int32 Ax100 (signed)
-
-  static uint32_t lastPollStart=0, lastPollTick=0;
-  const  uint32_t POLL_INTERVAL_MS=30000, TIMEOUT_MS=8000;
-  static volatile int  pending=0;
-  static volatile bool gotAny=false, hadError=false;
-  static bool printedThisRound = true;
-
-  // Puffer
-  static uint16_t bufPv[2], bufGrid[2], bufBatt[2], bufTemp[1], bufSoC[1];
-  static uint16_t bufPvToday[2], bufExpTot[2], bufImpTot[2];
-  static uint16_t bufPV1V[1], bufPV1A[1], bufPV2V[1], bufPV2A[1];
-  static uint16_t bufVA[2], bufVB[2], bufVC[2], bufIA[2], bufIB[2], bufIC[2];
-
-  inline int32_t  mk32_BE(uint16_t hi, uint16_t lo){ return (int32_t)(((uint32_t)hi<<16)|lo); }
-  static inline uint32_t mkU32_BE(uint16_t hi, uint16_t lo){ return (((uint32_t)hi<<16)|lo); }
-  static inline bool cbFinal(bool success){ if(success) gotAny=true; else hadError=true; if(pending>0) pending--; return true; }
-
-  // ==== Snapshot/Staging für atomare Messbilder ====
-  struct Snapshot {
-    int32_t pvW=0, gridW=0, battW=0;
-    int16_t temp10=0;
-    float   pvTodayKWh=0.0f; // (falls genutzt)
-    uint16_t socx10=0;
-    // Strings
-    int16_t pv1Voltage_x10_V=0, pv1Current_x10_A=0;
-    int16_t pv2Voltage_x10_V=0, pv2Current_x10_A=0;
-    // Netz V/I
-    int32_t gridVoltageA_x10_V=0, gridVoltageB_x10_V=0, gridVoltageC_x10_V=0;
-    int32_t gridCurrentA_x100_A=0, gridCurrentB_x100_A=0, gridCurrentC_x100_A=0;
-    uint32_t expTot=0, impTot=0; // total counters (optional)
-    uint32_t readyMask=0;
-  };
-  static Snapshot snapStage, snapLive;
-
-  enum : uint32_t {
-    RM_PV      = 1u<<0,
-    RM_GRID    = 1u<<1,
-    RM_BATT    = 1u<<2,
-    RM_TEMP    = 1u<<3,
-    RM_PVTODAY = 1u<<4,
-    RM_EXP     = 1u<<5,
-    RM_IMP     = 1u<<6,
-    RM_SOC     = 1u<<7,
-    RM_PV1V    = 1u<<8,
-    RM_PV1A    = 1u<<9,
-    RM_PV2V    = 1u<<10,
-    RM_PV2A    = 1u<<11,
-    RM_VA      = 1u<<12,
-    RM_VB      = 1u<<13,
-    RM_VC      = 1u<<14,
-    RM_IA      = 1u<<15,
-    RM_IB      = 1u<<16,
-    RM_IC      = 1u<<17,
+
+  // Geräte (PvPoll.h): PV_DEVICES aus PV_DEVICES_CUSTOM oder ein Wechselrichter aus
+  // INVERTER_IP / MODBUS_PORT / MODBUS_UNIT (in Credentials.h überschreibbar, z.B. für tools/sun2000sim.cpp)
+  static inline IPAddress devIP(const PvDeviceCfg& d){ return IPAddress(d.ip[0], d.ip[1], d.ip[2], d.ip[3]); }
+
+  const uint32_t POLL_INTERVAL_MS=30000, TIMEOUT_MS=8000, POLL_TICK_MS=300;
+  const uint32_t DEV_MAX_AGE_MS = 3*POLL_INTERVAL_MS;   // Gerät ohne Antwort: so lange letzten Wert verwenden
+
+  // Transport: ModbusIP, Antwort kommt aus mb.task()
+  struct MbTx {
+    void request(uint8_t p, uint16_t tag, const PvDeviceCfg& d, uint16_t addr, uint8_t words, uint16_t* buf);
   };
-  static const uint32_t RM_REQUIRED = RM_PV | RM_GRID | RM_BATT; // für konsistente Integration
+  static MbTx mbTx;
+  static PvPoller<MbTx> poller;
+  static uint32_t       pollStartMs = 0;   // Start der laufenden bzw. letzten Runde
+  static PvSchedTx      sched;             // Rundendauern -> Plan-Anhang (PvSleep.h)
+
+  void MbTx::request(uint8_t p, uint16_t tag, const PvDeviceCfg& d, uint16_t addr, uint8_t words, uint16_t* buf){
+    IPAddress ip = devIP(d);
+    uint16_t id = mb.isConnected(ip) ? mb.readHreg(ip, addr, buf, words, [p, tag, addr](Modbus::ResultCode rc, uint16_t, void*)->bool{
+      PV_TRACE_SCOPE(PVT_MB_CB, addr);
+      poller.done(p, tag, rc==Modbus::EX_SUCCESS, millis());
+      return true;
+    }, d.unit) : 0;
+    if (!id) poller.done(p, tag, false, millis());   // nicht verbunden / nicht gesendet: Register überspringen
+  }
 
-  static void startPoll(){
-    if (pending>0 || !mb.isConnected(inverterIP)) return;
-
-    hadError=false; gotAny=false; printedThisRound=false;
-    pending=16; lastPollStart=millis();
-
-    // Snapshot leeren
-    snapStage = Snapshot{};
-
-    mb.readHreg(inverterIP, REG_PV_AC, bufPv, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.pvW=mk32_BE(bufPv[0],bufPv[1]); snapStage.readyMask|=RM_PV; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    mb.readHreg(inverterIP, REG_GRID_P, bufGrid, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.gridW=mk32_BE(bufGrid[0],bufGrid[1]); snapStage.readyMask|=RM_GRID; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    mb.readHreg(inverterIP, REG_BATT_P, bufBatt, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.battW=mk32_BE(bufBatt[0],bufBatt[1]); snapStage.readyMask|=RM_BATT; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    mb.readHreg(inverterIP, REG_WR_TEMP, bufTemp, 1, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.temp10=(int16_t)bufTemp[0]; snapStage.readyMask|=RM_TEMP; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    mb.readHreg(inverterIP, REG_PV_TODAY, bufPvToday, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.pvTodayKWh=mkU32_BE(bufPvToday[0],bufPvToday[1])/100.0f; snapStage.readyMask|=RM_PVTODAY; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    mb.readHreg(inverterIP, REG_GRID_EXP_T, bufExpTot, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.expTot=mkU32_BE(bufExpTot[0],bufExpTot[1]); snapStage.readyMask|=RM_EXP; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    mb.readHreg(inverterIP, REG_GRID_IMP_T, bufImpTot, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.impTot=mkU32_BE(bufImpTot[0],bufImpTot[1]); snapStage.readyMask|=RM_IMP; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    mb.readHreg(inverterIP, REG_BATT_SOCX, bufSoC, 1, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.socx10=bufSoC[0]; snapStage.readyMask|=RM_SOC; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    // Strings
-    mb.readHreg(inverterIP, REG_PV1_V, bufPV1V, 1, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.pv1Voltage_x10_V=(int16_t)bufPV1V[0]; snapStage.readyMask|=RM_PV1V; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-    mb.readHreg(inverterIP, REG_PV1_A, bufPV1A, 1, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.pv1Current_x10_A=(int16_t)bufPV1A[0]; snapStage.readyMask|=RM_PV1A; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-    mb.readHreg(inverterIP, REG_PV2_V, bufPV2V, 1, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.pv2Voltage_x10_V=(int16_t)bufPV2V[0]; snapStage.readyMask|=RM_PV2V; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-    mb.readHreg(inverterIP, REG_PV2_A, bufPV2A, 1, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.pv2Current_x10_A=(int16_t)bufPV2A[0]; snapStage.readyMask|=RM_PV2A; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    // Netz V/I
-    mb.readHreg(inverterIP, REG_VA, bufVA, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.gridVoltageA_x10_V=mk32_BE(bufVA[0],bufVA[1]); snapStage.readyMask|=RM_VA; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-    mb.readHreg(inverterIP, REG_VB, bufVB, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.gridVoltageB_x10_V=mk32_BE(bufVB[0],bufVB[1]); snapStage.readyMask|=RM_VB; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-    mb.readHreg(inverterIP, REG_VC, bufVC, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.gridVoltageC_x10_V=mk32_BE(bufVC[0],bufVC[1]); snapStage.readyMask|=RM_VC; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-
-    mb.readHreg(inverterIP, REG_IA, bufIA, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.gridCurrentA_x100_A=mk32_BE(bufIA[0],bufIA[1]); snapStage.readyMask|=RM_IA; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-    mb.readHreg(inverterIP, REG_IB, bufIB, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.gridCurrentB_x100_A=mk32_BE(bufIB[0],bufIB[1]); snapStage.readyMask|=RM_IB; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
-    mb.readHreg(inverterIP, REG_IC, bufIC, 2, [](Modbus::ResultCode rc, uint16_t, void*)->bool{
-      if(rc==Modbus::EX_SUCCESS){ snapStage.gridCurrentC_x100_A=mk32_BE(bufIC[0],bufIC[1]); snapStage.readyMask|=RM_IC; }
-      return cbFinal(rc==Modbus::EX_SUCCESS);
-    }, unitId);
+  // Energie je Gerät (nur PV): Tag/Monat, Schlüssel g<i>JJJJMMTT / h<i>JJJJMM
+  static PvBattEst batt;   // Batterie-Schätzer, je Frame
 
+  // Vorwissen: Summe der Batterien; eine ohne Angabe -> unbekannt
+  static void battBegin(){
+    uint32_t capWh = 0;
+    for (uint8_t i=0; i<PV_DEVICE_COUNT; ++i){
+      if (!(PV_DEVICES[i].flags & PVD_BATT)) continue;
+      if (!PV_DEVICES[i].battWh){ capWh = 0; break; }
+      capWh += PV_DEVICES[i].battWh;
+    }
+    pvBattInit(batt, capWh);
+  }
+
+  static PvEnergyIntegrator devInteg[PV_MAX_DEVICES];
+  static PvEnergy devDay[PV_MAX_DEVICES], devMon[PV_MAX_DEVICES];
+
+  static String keyDevDay(uint8_t i,int y,int m,int d){ char b[16]; snprintf(b,sizeof(b),"g%u%04d%02d%02d",i,y,m,d); return String(b); }
+  static String keyDevMon(uint8_t i,int y,int m){ char b[16]; snprintf(b,sizeof(b),"h%u%04d%02d",i,y,m); return String(b); }
+
+  static void devEnergyLoad(int y,int m,int d){
+    for (uint8_t i=0; i<PV_DEVICE_COUNT; ++i){
+      loadAggFromNVS(keyDevDay(i,y,m,d), devDay[i]);
+      loadAggFromNVS(keyDevMon(i,y,m), devMon[i]);
+    }
+  }
+  static void devEnergySave(int y,int m,int d, bool month){
+    for (uint8_t i=0; i<PV_DEVICE_COUNT; ++i){
+      saveAggToNVS(keyDevDay(i,y,m,d), devDay[i]);
+      if (month) saveAggToNVS(keyDevMon(i,y,m), devMon[i]);
+    }
+  }
+
+  static void integrateDevices(){
+    uint32_t now = millis();
+    for (uint8_t i=0; i<PV_DEVICE_COUNT; ++i){
+      int32_t pvW = poller.fresh(i, now, DEV_MAX_AGE_MS) ? poller.dev[i].live.pvW : 0;
+      PvEnergy d;
+      if (!pvEnergyStep(devInteg[i], pvW, 0, 0, now, true, d)) continue;
+      devDay[i].e[PVE_GEN] += d.e[PVE_GEN];
+      devMon[i].e[PVE_GEN] += d.e[PVE_GEN];
+    }
+  }
+
+  static void devInfoUpdate(){
+    uint32_t now = millis();
+    for (uint8_t i=0; i<PV_DEVICE_COUNT; ++i){
+      const PvDeviceCfg& c = PV_DEVICES[i];
+      const PvDevState&  s = poller.dev[i];
+      PvDevInfo& o = devInfo[i];
+      o = PvDevInfo{};
+      o.idx = i; o.count = PV_DEVICE_COUNT; o.flags = c.flags; o.unit = c.unit;
+      o.state = !poller.fresh(i, now, DEV_MAX_AGE_MS) ? PVDEV_NONE : now - s.liveMs <= POLL_INTERVAL_MS ? PVDEV_OK : PVDEV_OLD;
+      o.pvW = s.live.pvW; o.battW = s.live.battW; o.temp10 = s.live.temp10; o.socx10 = s.live.socx10;
+      o.genTodayWh = (uint32_t)(devDay[i].e[PVE_GEN] / (PV_E_PER_MWH * 1000));
+      o.genMonthWh = (uint32_t)(devMon[i].e[PVE_GEN] / (PV_E_PER_MWH * 1000));
+      o.cycleMs = (uint16_t)min<uint32_t>(s.cycleMs, 0xFFFF);
+      o.ageS = s.valid ? (uint16_t)min<uint32_t>((now - s.liveMs)/1000, 0xFFFF) : 0xFFFF;
+      strncpy(o.name, c.name ? c.name : "", sizeof(o.name)-1);
+    }
+    devCount = PV_DEVICE_COUNT;
+  }
+
+  static void printPollStats(){
+    Serial.printf("[POLL] %u Runden, letzte %u ms, %u Endpunkte\n", poller.rounds, poller.roundMs, poller.nPipe);
+    for (uint8_t i=0; i<PV_DEVICE_COUNT; ++i){
+      const PvDevState& s = poller.dev[i];
+      Serial.printf("  %-8s %s:%u/%u ok=%u unvollst=%u fehler=%u timeout=%u zyklus=%u ms pv=%d W\n",
+        PV_DEVICES[i].name, devIP(PV_DEVICES[i]).toString().c_str(), PV_DEVICES[i].port, PV_DEVICES[i].unit,
+        s.ok, s.fails, s.errors, s.timeouts, s.cycleMs, s.live.pvW);
+    }
+  }
+
+  static void startPoll(){
+    if (!poller.start(millis())) return;
+    PV_TRACE_BEGIN(PVT_POLL, lastSeq+1);
     Serial.println("[INFO] Poll gestartet");
   }
 
+  static void statsSendDevices();
+  static void statsSendPeaksNow();
+
+  // Anfragen nur als Aktiver mit gültiger Lease (PvElect.h)
+  static bool electMayPoll(){
+  #ifdef PV_ELECT
+    portENTER_CRITICAL(&electMux);
+    const bool ok = pvElectMayPoll(elect, millis());
+    portEXIT_CRITICAL(&electMux);
+    return ok;
+  #else
+    return true;
+  #endif
+  }
+
+  // Multicast senden, Zeit-Anhang erst unmittelbar davor, dahinter die Energie-Teile des Frames,
+  // die Batterie-ETAs, wann der nächste Frame kommt und (PV_ELECT) wer ihn in welcher Amtszeit sendet
+  static void frameSend(){
+    PV_TRACE_SCOPE(PVT_FRAME_TX, lastF.seq);
+    uint8_t pkt[PV_FRAME_WIRE+PV_TIME_WIRE+PV_FILL_WIRE_MAX+PV_BATT_WIRE+PV_SCHED_WIRE+PV_ELECT_WIRE];
+    pvFrameEncode(lastF, pkt);
+    size_t len = PV_FRAME_WIRE + clockStamp(pkt+PV_FRAME_WIRE);
+    PayloadFillPart parts[PV_FILL_PARTS];
+    const uint8_t n = pvFillParts(fill, lastF.seq, parts);
+    if (n) len += pvFillSeal(pkt+len, parts, n);
+    len += pvBattSeal(pkt+len, battEta);
+    len += pvSchedSeal(pkt+len, pvSchedNext(sched, pollStartMs, POLL_INTERVAL_MS, POLL_TICK_MS, TIMEOUT_MS, millis()));
+  #ifdef PV_ELECT
+    len += pvElectSeal(pkt+len, elect);
+  #endif
+    udpFrame.writeTo(pkt, len, MCAST_GRP, MCAST_PORT);
+  }
+
   static void maybeFinishPoll(){
-    if(pending>0 && (millis()-lastPollStart>=TIMEOUT_MS)){ pending=0; Serial.println("[POLL] timeout"); }
-    if(pending>0 || printedThisRound) return;
-    if(!gotAny){ printedThisRound=true; return; }
-
-    // Nur mit konsistentem Kern übernehmen
-    if ( (snapStage.readyMask & RM_REQUIRED) != RM_REQUIRED ) { printedThisRound=true; return; }
-
-    // Atomar übernehmen
-    snapLive = snapStage;
-
-    // Frame aus Snapshot befüllen
-    lastF.pvW   = snapLive.pvW;
-    lastF.gridW = snapLive.gridW;
-    lastF.battW = snapLive.battW;
-    lastF.temp10= snapLive.temp10;
-    lastF.socx10= snapLive.socx10;
-
-    // Strings
-    lastF.pv1Voltage_x10_V = snapLive.pv1Voltage_x10_V;
-    lastF.pv1Current_x10_A = snapLive.pv1Current_x10_A;
-    lastF.pv2Voltage_x10_V = snapLive.pv2Voltage_x10_V;
-    lastF.pv2Current_x10_A = snapLive.pv2Current_x10_A;
-
-    // Netz V/I
-    lastF.gridVoltageA_x10_V = snapLive.gridVoltageA_x10_V;
-    lastF.gridVoltageB_x10_V = snapLive.gridVoltageB_x10_V;
-    lastF.gridVoltageC_x10_V = snapLive.gridVoltageC_x10_V;
-    lastF.gridCurrentA_x100_A = snapLive.gridCurrentA_x100_A;
-    lastF.gridCurrentB_x100_A = snapLive.gridCurrentB_x100_A;
-    lastF.gridCurrentC_x100_A = snapLive.gridCurrentC_x100_A;
+    if (electMayPoll()) poller.tick(millis());   // ohne Lease: keine neuen Anfragen, Runde wartet
+    if (!poller.finished(millis())) return;
+    PV_TRACE_END(PVT_POLL, lastSeq+1);
+    pvSchedRound(sched, millis() - pollStartMs);
+    devInfoUpdate();
+    statsSendDevices();
+
+    // Nur mit konsistentem Kern übernehmen (Meter-Gerät frisch, Geräte je vollständig)
+    if (!pvAggregate(poller, millis(), DEV_MAX_AGE_MS, lastF)){ Serial.println("[POLL] keine gültigen Daten"); return; }
 
     // Meta
     lastF.magic   = PV_MAGIC;
@@ -503,45 +910,148 @@ const uint16_t REG_IC         = 37111; // int32 Ax100 (signed)
     lastF.seq     = ++lastSeq;
     { time_t n; time(&n); lastF.ts=(uint32_t)n; }
 
-    // Heute-Werte ins Frame (aus lokaler Integration)
-    lastF.pvTodayKWh   = dayAgg.gen_kWh;
-    lastF.gridExpToday = dayAgg.exp_kWh;
-    lastF.gridImpToday = dayAgg.impT1_kWh + dayAgg.impT2_kWh;
+    // Batterie: Schätzer je Frame; im Frame selbst (ältere Clients) nur mit genug Konfidenz
+    pvBattUpdate(batt, millis(), lastF.battW, lastF.socx10);
+    pvBattEtas(batt, battEta); battOk = true;
+    lastF.eta20s = battEta.conf >= PV_BATT_CONF_MIN ? battEta.eta20s : -1;
+    peakTick(lastF);
 
-    lastF.crc = 0;
-    lastF.crc = crc16_modbus((const uint8_t*)&lastF, sizeof(PvFrameV4)-2);
+    // Heute-Werte ins Frame (aus lokaler Integration)
+    lastF.pvTodayKWh   = pvKWh(dayAgg.e[PVE_GEN]);
+    lastF.gridExpToday = pvKWh(dayAgg.e[PVE_EXP]);
+    lastF.gridImpToday = pvKWh(dayAgg.e[PVE_IMP_T1] + dayAgg.e[PVE_IMP_T2]);
+    lastF.loadTodayKWh = pvKWh(dayAgg.e[PVE_LOAD]);
+    pvFillClose(fill, lastF.seq, curY>2000 ? pvDayNum(curY,curM,curD) : 0);
 
-    // Multicast senden
-    udpFrame.writeTo((uint8_t*)&lastF, sizeof(PvFrameV4), MCAST_GRP, MCAST_PORT);
+    frameSend();   // kodiert, setzt lastF.crc
+    statsSendPeaksNow();
 
-    haveFrame=true;
+    haveFrame=true; lastRxMs=millis();
+    pvStale=false;
     drawIfFrame();
-    printedThisRound=true;
   }
 #endif // ROLE_POLLER
 
 #ifndef ROLE_POLLER
 // ---- Client: Frames empfangen ----
+static PvRxState rxState;
+static IPAddress statsServerIP;      // Poller (Offer, nach einer Wahl der neue aus den Frames)
+static uint16_t  statsServerPort=0;
+
+// Teil auf den Tag des Pollers buchen: heute in die Akkus, frühere Tage in ihren Record
+static void fillApply(const PayloadFillPart& p){
+  DayLock lk;
+  if (curY <= 2000) return;
+  const PvEnergy e = pvFillEnergy(p);
+  const uint8_t t = pvFillTarget(p.day, pvDayNum(curY,curM,curD), fillFinal);
+  if (t == PVFILL_TODAY){ pvEnergyAdd(dayAgg, e); pvEnergyAdd(monthAgg, e); return; }
+  if (t != PVFILL_PAST || pvEnergyZero(e)) return;
+  int y,m,d; pvDayCivil(p.day, y, m, d);
+  DayAgg a; loadDayFromNVS(y,m,d,a);   // fehlt -> 0
+  pvEnergyAdd(a, e);
+  saveDayToNVS(y,m,d,a);               // Woche/Monat/Jahr über PvRollup.h
+  if (y==curY && m==curM) pvEnergyAdd(monthAgg, e);
+}
+
+// Spitzen vom Poller (STATS_PEAKS): heute und der laufende Monat in die Akkus, sonst in den
+// Record (nur wenn sich etwas ändert). Der laufende Monat auch in seinen Record: Tage vor dem
+// ersten eigenen Frame kennt nur der Poller
+static void peakApply(const PayloadPeaks& h, const PvPeaks& pk){
+  DayLock lk;
+  if (curY <= 2000) return;
+  int y,m,d; pvDayCivil(h.day, y, m, d);
+  if (h.lvl == PVL_DAY){
+    if (h.day == pvDayNum(curY,curM,curD)){ pvPeakTake(dayAgg.pk, pk); return; }
+    DayAgg a; if (!loadDayFromNVS(y,m,d,a)) return;   // ohne Energie kein Record anlegen
+    const PvPeaks old = a.pk;
+    pvPeakTake(a.pk, pk);
+    if (!pvPeakSame(old, a.pk)) saveDayToNVS(y,m,d,a);
+  } else if (h.lvl == PVL_MONTH){
+    if (y==curY && m==curM) pvPeakTake(monthAgg.pk, pk);
+    MonthAgg a; loadMonthFromNVS(y,m,a);
+    const PvPeaks old = a.pk;
+    pvPeakTake(a.pk, pk);
+    if (!pvPeakSame(old, a.pk)) saveMonthToNVS(y,m,a);
+  }
+}
+
+// Frame mit Teilen: Lücke davor merken (fillClientTick() fragt nach), eigene Teile addieren
+static void fillFrame(uint32_t seq, const PayloadFillPart* parts, uint8_t n){
+  const int32_t today = curY > 2000 ? pvDayNum(curY,curM,curD) : 0;
+  portENTER_CRITICAL(&fillMux);
+  const bool open = fillRx.miss != 0;
+  pvFillOnFrame(fillRx, seq);
+  if (!open && fillRx.miss) fillGapDay = fillSeenDay;   // neue Lücke ab hier
+  fillSeenDay = today;
+  portEXIT_CRITICAL(&fillMux);
+  for (uint8_t i=0; i<n; ++i) if (parts[i].seq == seq) fillApply(parts[i]);
+}
+
+static void printRxStats(){
+  Serial.print("[RX]");
+  for (uint8_t i=0; i<PVRX_COUNT; ++i) Serial.printf(" %s=%u", pvRxReasonName(i), rxState.cnt[i]);
+  Serial.printf(" | %u Pakete, avg %u us, max %u us | Poller-Wechsel %u, Amtszeit %u\n",
+                rxState.pkts, rxState.pkts ? rxState.usSum/rxState.pkts : 0, rxState.usMax, rxState.takeovers, rxState.term);
+}
+
 static void beginListenFrames(){
   if (!udpFrame.listenMulticast(MCAST_GRP, MCAST_PORT, 1, TCPIP_ADAPTER_IF_STA)){
     Serial.println("[ERR] listenMulticast failed"); return;
   }
   udpFrame.onPacket([](AsyncUDPPacket p){
-    if (p.length() < sizeof(PvFrameV4)) return;
-    const PvFrameV4* f = (const PvFrameV4*)p.data();
-    if (f->magic!=PV_MAGIC || f->version!=PV_VERSION) return;
-    uint16_t check = crc16_modbus((const uint8_t*)p.data(), sizeof(PvFrameV4)-2);
-    if (check != f->crc) return;
-    if (f->seq <= lastSeq) return;
-
-    lastSeq = f->seq; lastRxMs = millis();
-    lastF = *f; haveFrame=true;
-
-    // Lokal integrieren, damit Anzeige auf Clients Werte hat
-    integrateTick(lastF.pvW, lastF.gridW, lastF.battW);
-    handleDayMonthRollover();
+    PV_TRACE_SCOPE(PVT_FRAME_RX, p.length());
+    // Länge, Magic/Version, CRC, seq (inkl. Poller-Neustart) prüfen
+    uint32_t t0 = micros(), rxMs = millis();
+    PvFrameV4 f;
+    uint8_t r = pvRxFrame(rxState, p.data(), p.length(), (uint32_t)p.remoteIP(), rxMs, f);
+    // anderer Poller mit höherer Amtszeit (PvElect.h): Nachfolger nach einer Wahl, sofort annehmen
+    PvElectTag tag;
+    if (r == PVRX_FOREIGN && pvElectFrameGet(p.data(), p.length(), tag) && pvRxTakeover(rxState, (uint32_t)p.remoteIP(), tag.term)){
+      r = pvRxFrame(rxState, p.data(), p.length(), (uint32_t)p.remoteIP(), rxMs, f);
+      statsServerIP = p.remoteIP();   // Nachfragen und Karussell-Reparatur an ihn
+      Serial.printf("[RX] neuer Poller %s, Amtszeit %u\n", p.remoteIP().toString().c_str(), tag.term);
+    }
+    pvRxTime(rxState, micros() - t0);
+
+    // Uhr vor der Integration nachführen: ein Frame nach Mitternacht des Pollers zählt hier
+    // schon zum neuen Tag. Auch aus Duplikaten (Poller wiederholt den Frame, sobald seine Uhr steht)
+    uint64_t pollerMs;
+    if ((pvRxAccepted(r) || r == PVRX_DUP) && pvFrameTimeGet(p.data(), p.length(), PV_FRAME_WIRE, pollerMs))
+      clockSample(rxMs, pollerMs);
+    if (!pvRxAccepted(r)) return;
+    if (r == PVRX_RESTART) Serial.printf("[RX] Poller-Neustart erkannt (seq %u -> %u)\n", lastSeq, f.seq);
+    const bool gap = r == PVRX_OK && lastSeq && f.seq != lastSeq + 1;
+
+    lastSeq = f.seq; lastRxMs = millis();
+    lastF = f; haveFrame=true;
+
+    // Energie-Teile des Pollers addieren; ältere Poller: lokal integrieren (beides erst mit
+    // gültiger Uhr: Tagesanker)
+    PayloadFillPart parts[PV_FILL_PARTS];
+    const uint8_t np = pvFillGet(p.data(), p.length(), PV_FRAME_WIRE+PV_TIME_WIRE, parts);
+    if ((np > 0) != fillOn){ fillOn = np > 0; integ.have = false; }   // kein Trapez über den Wechsel
+    const size_t atBatt = PV_FRAME_WIRE+PV_TIME_WIRE+(np ? pvFillWire(np) : 0);
+    battOk = pvBattGet(p.data(), p.length(), atBatt, battEta);
+    // Plan für den nächsten Frame (hinter den ETAs); ohne: Funk bleibt an
+    PvSched sc;
+    const bool schedOk = battOk && pvSchedGet(p.data(), p.length(), atBatt+PV_BATT_WIRE, sc);
+    rxState.term = schedOk && pvElectGet(p.data(), p.length(), atBatt+PV_BATT_WIRE+PV_SCHED_WIRE, tag) ? tag.term : 0;
+    portENTER_CRITICAL(&sleepMux);
+    pvSleepFrame(slp, rxMs, gap, schedOk ? &sc : nullptr);
+    portEXIT_CRITICAL(&sleepMux);
+    if (boot.timeOk){
+      if (np){
+        handleDayMonthRollover();
+        if (r == PVRX_RESTART){ portENTER_CRITICAL(&fillMux); pvFillReset(fillRx); portEXIT_CRITICAL(&fillMux); }
+        fillFrame(f.seq, parts, np);
+      } else {
+        integrateTick(lastF.pvW, lastF.gridW, lastF.battW);
+        handleDayMonthRollover();
+      }
+      peakTick(lastF);
+    }
 
-    drawIfFrame();
+    drawPending = true;   // gezeichnet wird in loop() (Display/DMA nur aus einem Task)
   });
 }
 #endif
@@ -552,51 +1062,491 @@ static uint32_t statsSeq=1;
 static void statsSendTo(IPAddress ip, uint16_t port, uint8_t type, uint32_t seq, const void* pl, uint16_t len){
   StatsHdr h{0xCAFE, 1, type, seq, len, 0};
   h.crc = pvstats_crc(h, (const uint8_t*)pl);
-  uint8_t buf[sizeof(StatsHdr)+128];
-  memcpy(buf, &h, sizeof(h));
-  if (pl && len) memcpy(buf+sizeof(h), pl, len);
-  udpStatsCtrl.writeTo(buf, sizeof(h)+len, ip, port);
+  uint8_t buf[STATS_HDR_WIRE+STATS_MAX_PAYLOAD];
+  if (len > STATS_MAX_PAYLOAD) return;
+  pvWireEncode(h, buf);
+  if (pl && len) memcpy(buf+STATS_HDR_WIRE, pl, len);
+  udpStatsCtrl.writeTo(buf, STATS_HDR_WIRE+len, ip, port);
+}
+
+// eine Nachricht (PvStats.h) kodiert senden
+template<class T> static void statsSendMsg(IPAddress ip, uint16_t port, uint8_t type, const T& m){
+  uint8_t pl[PvWire<T>::size];
+  statsSendTo(ip, port, type, ++statsSeq, pl, (uint16_t)pvWireEncode(m, pl));
 }
 
 static void statsSendDiscover(){
   statsSendTo(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_DISCOVER, ++statsSeq, nullptr, 0);
 }
 
+#ifdef ROLE_POLLER
+// Geräteübersicht nach jeder Runde an alle (ein Paket je Gerät)
+static void statsSendDevices(){
+  for (uint8_t i=0; i<devCount; ++i)
+    statsSendMsg(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_DEVICES, devInfo[i]);
+}
+
+// Spitzen (PvPeak.h): heute und der Monat nach jeder Runde an alle, einzelne Tage/Monate im Unicast-Strom
+static void statsSendPeaks(IPAddress ip, uint16_t port, int32_t day, uint8_t lvl, const PvPeaks& pk){
+  uint8_t pl[PV_PEAKS_MSG];
+  statsSendTo(ip, port, STATS_PEAKS, ++statsSeq, pl, (uint16_t)pvPeakMsg(pl, day, lvl, pk));
+}
+static void statsSendPeaksNow(){
+  if (curY <= 2000) return;
+  statsSendPeaks(STATS_MCAST_GRP, STATS_MCAST_PORT, pvDayNum(curY,curM,curD), PVL_DAY, dayAgg.pk);
+  statsSendPeaks(STATS_MCAST_GRP, STATS_MCAST_PORT, pvDayNum(curY,curM,1), PVL_MONTH, monthAgg.pk);
+}
+
+// STATS_FILL_REQ aus dem UDP-Task: Teile der fehlenden Frames an den Fragenden
+static void fillTick(){
+  while (true){
+    portENTER_CRITICAL(&fillMux);
+    const bool any = fillAskN > 0;
+    FillAsk a;
+    if (any) a = fillAsk[--fillAskN];
+    portEXIT_CRITICAL(&fillMux);
+    if (!any) return;
+    pvFillServe(fill, a.q.from, a.q.to, [&](const uint8_t* pl, size_t len){
+      statsSendTo(a.ip, a.port, STATS_FILL, ++statsSeq, pl, (uint16_t)len);
+    });
+  }
+}
+
+static void printFill(){
+  Serial.printf("[FILL] Ring %u/%u Teile ab Frame %u, Teile %u | Anfragen %u, Pakete %u\n",
+                fill.n, PV_FILL_RING, pvFillOldest(fill), fill.parts, fill.reqs, fill.sent);
+}
+
+static void printBatt(){
+  Serial.printf("[BATT] %s, Konfidenz %u%% | 20%% %ld s, voll %ld s, leer %ld s, %.1f %%/h\n",
+                battEta.dir==PVB_CHG ? "lädt" : battEta.dir==PVB_DIS ? "entlädt" : "ruht", battEta.conf,
+                (long)battEta.eta20s, (long)battEta.fullS, (long)battEta.emptyS, battEta.ratex10/10.0f);
+  Serial.printf("[BATT] k %.4f/%.4f %%/Wh (P %.2g/%.2g), Leistung %.0f W | Samples %lu, Stufen %lu, Resets %lu\n",
+                batt.k[0], batt.k[1], batt.P[0], batt.P[1], batt.pw,
+                (unsigned long)batt.samples, (unsigned long)batt.steps, (unsigned long)batt.resets);
+}
+#endif
+
+#ifdef PV_TRACE
+// ======= Event-Trace Dump (PvTrace.h) =======
+static void traceDumpSerial(){
+  pvTraceDump([](const uint8_t* d, size_t n){ Serial.write(d, n); });
+}
+
+// Dump erst in einen Puffer kopieren (Ring ist dabei angehalten), dann in Stücken senden
+static void traceDumpUdp(IPAddress ip, uint16_t port){
+  const size_t cap = sizeof(PvTraceDumpHdr) + PV_TRACE_CAP*sizeof(PvTraceRec);
+  uint8_t* buf = (uint8_t*)malloc(cap);
+  if (!buf){ Serial.println("[TRACE] kein Speicher"); return; }
+  size_t total = 0;
+  pvTraceDump([&](const uint8_t* d, size_t n){ if (total+n<=cap){ memcpy(buf+total, d, n); total+=n; } });
+
+  uint8_t pkt[PvWire<PayloadTraceChunk>::size+STATS_TRACE_CHUNK];
+  for (size_t off=0; off<total; off+=STATS_TRACE_CHUNK){
+    size_t n = min((size_t)STATS_TRACE_CHUNK, total-off);
+    PayloadTraceChunk c{ (uint32_t)off, (uint32_t)total };
+    size_t hl = pvWireEncode(c, pkt);
+    memcpy(pkt+hl, buf+off, n);
+    statsSendTo(ip, port, STATS_TRACE, ++statsSeq, pkt, (uint16_t)(hl+n));
+    delay(2);
+  }
+  free(buf);
+}
+#endif
+
+// ======= Verlauf-Karussell senden (PvCarousel.h): der Poller, als Peer auch ein Client (PvPeer.h) =======
+// Anfragen/NACKs aus dem UDP-Task, Senden aus loop()
+static PvCarSender  car;
+static portMUX_TYPE carMux = portMUX_INITIALIZER_UNLOCKED;   // car und (Client) carRx/peers
+static volatile bool carReq = false;
+#ifdef ROLE_POLLER
+static const bool    carServe = true;
+#else
+static volatile bool carServe = false;   // Client: abgeglichen, Stand wie beim Poller
+#endif
+
+// Anfrage für diesen Knoten? Ohne Quelle ist der Poller gemeint
+static bool carAddressed(uint32_t src){
+#ifdef ROLE_POLLER
+  if (!src) return electActive();   // PV_ELECT: nur der abfragende Knoten
+#endif
+  return carServe && src && src == (uint32_t)WiFi.localIP();
+}
+
+static void carOnReq(const uint8_t* pl, uint16_t len){
+  PayloadCarReq q{0};
+  pvWireDecode(pl, len, q);   // ältere Clients: ohne Payload
+  if (carAddressed(q.src)) carReq = true;   // Bereich bestimmt carTick() in loop() (Lesen im NVS)
+}
+
+static void carOnNack(const uint8_t* pl, uint16_t len){
+  PayloadCarNack n;
+  if (!pvWireDecode(pl, len, n) || n.n > PV_CAR_SPANS || !carAddressed(n.src)) return;
+  if (len < PvWire<PayloadCarNack>::size + n.n*PvWire<PayloadCarSpan>::size) return;
+  PayloadCarSpan s[PV_CAR_SPANS];
+  for (uint8_t k=0; k<n.n; ++k) pvWireDecode(pl + PvWire<PayloadCarNack>::size + k*PvWire<PayloadCarSpan>::size, PvWire<PayloadCarSpan>::size, s[k]);
+  portENTER_CRITICAL(&carMux);
+  if (car.blocks) pvCarNack(car, n, s); else carReq = true;
+  portEXIT_CRITICAL(&carMux);
+}
+
+static void carTick(){
+  if (!carServe || !boot.timeOk || curY <= 2000) return;
+  const int32_t today = pvDayNum(curY, curM, curD);
+  if (carReq){
+    carReq = false;
+    // neue Runde: Anfang suchen, solange keine läuft (sonst bliebe der Umlauf stehen)
+    const int32_t first = car.idle || !car.blocks ? pvCarFirstDay(rollupStore, today, !rollup.rebuilding) : car.first;
+    portENTER_CRITICAL(&carMux);
+    pvCarRange(car, first, today);
+    pvCarRequest(car);
+    portEXIT_CRITICAL(&carMux);
+  }
+  portENTER_CRITICAL(&carMux);
+  if (car.blocks) pvCarRange(car, car.first, today);   // Mitternacht: neuer Block bzw. Tag
+  const int32_t idx = pvCarNext(car, millis());
+  portEXIT_CRITICAL(&carMux);
+  if (idx == PVCAR_WAIT) return;
+
+  uint8_t pl[PV_CAR_BLOCK_MAX];
+  if (idx == PVCAR_SEND_IDLE){
+    statsSendTo(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_CAR_IDLE, ++statsSeq, pl, (uint16_t)pvCarBuildIdle(car, pl));
+    return;
+  }
+  size_t n = pvCarBuild(car, (uint16_t)idx, today, [&](int32_t day, PvEnergy& a){
+#ifdef ROLE_POLLER
+    if (day == today){ a = dayAgg; return true; }          // heute: laufender Stand
+#else
+    if (day == today) return false;                         // Peer: den laufenden Tag hat nur der Poller
+#endif
+    int y, m, d; pvDayCivil(day, y, m, d);
+    DayAgg t; if (!loadDayFromNVS(y, m, d, t)) return false;
+    a = t; return true;
+  }, pl);
+  statsSendTo(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_CAR_BLOCK, ++statsSeq, pl, (uint16_t)n);
+}
+
+// Stand des Verlaufs ohne den laufenden Tag; false = Digest noch nicht fertig bzw. keine Uhr
+static bool carHist(uint16_t load, PayloadOfferHist& h){
+  if (!digValid || digRb.active || curY <= 2000) return false;
+  DayAgg t; loadDayFromNVS(curY, curM, curD, t);   // fehlt -> 0
+  h = pvDigestOffer(dig, pvDayNum(curY, curM, curD), t, load);
+  return true;
+}
+
+// Offer mit Zeit-Anhang (Poller: gestellte Uhr, Peer: ohne PVTM_SYNCED) und Stand des Verlaufs
+static void statsSendOffer(IPAddress ip, uint16_t port){
+  portENTER_CRITICAL(&carMux);
+  uint16_t load = car.pending;
+  portEXIT_CRITICAL(&carMux);
+#ifdef ROLE_POLLER
+  if (poller.active) load += PV_PEER_POLLER_BIAS;   // Modbus-Runde: lieber ein Client
+  const uint16_t role = 0;
+#else
+  const uint16_t role = STATS_OFFER_PEER;
+#endif
+  PayloadOfferHist hist;
+  const bool hasHist = carHist(load, hist);
+  uint8_t pkt[PvWire<PayloadOffer>::size+PV_TIME_WIRE+PvWire<PayloadOfferHist>::size];
+  PayloadOffer off{STATS_SERVER_PORT, (uint16_t)(STATS_OFFER_CAROUSEL | role | (hasHist ? STATS_OFFER_HIST : 0))};
+  uint8_t* p = pkt + pvWireEncode(off, pkt);
+#ifdef ROLE_POLLER
+  p += clockStamp(p);
+#else
+  p += pvFrameTimeSeal(p, 0, false);
+#endif
+  if (hasHist) p += pvWireEncode(hist, p);
+  statsSendTo(ip, port, STATS_OFFER, ++statsSeq, pkt, (uint16_t)(p - pkt));
+}
+
+#if !defined(ROLE_POLLER) || defined(PV_ELECT)
+// Tag aus dem Karussell (Client, folgender Poller-Knoten): unveränderte Records nicht neu schreiben (Flash, Rollup). Fehlt der
+// Tag bei der Quelle (vor heute), eigenen Record leeren: der Stand soll dem Poller gleichen.
+// Das Karussell trägt nur die Energie, die Spitzen des Records bleiben
+static void carStoreDay(int32_t n, const PvEnergy* a){
+  DayLock lk;
+  int y,m,d; pvDayCivil(n, y, m, d);
+  if (!a && n >= pvDayNum(curY, curM, curD)) return;
+  PvEnergy zero; pvEnergyClear(zero);
+  DayAgg old;
+  const bool have = loadDayFromNVS(y,m,d,old);
+  if (!a) a = &zero;
+  if ((have || pvEnergyZero(*a)) && !memcmp(old.e, a->e, sizeof(a->e))) return;
+  DayAgg neu = old; static_cast<PvEnergy&>(neu) = *a;
+  saveDayToNVS(y,m,d,neu);
+}
+#endif
+
 #ifdef ROLE_POLLER
 static inline int daysInMonthInline(int y,int m){ return daysInMonth(y,m); }
 
+static void printCarousel(){
+  Serial.printf("[CAR] Anfragen %u, NACKs %u, Blöcke gesendet %u, Runden %u | fällig %u/%u ab Tag %d\n",
+                car.reqs, car.nacks, car.sent, car.rounds, car.pending, car.blocks, (int)car.first);
+  Serial.printf("[PEER] Digest %s: %u Tage bis Tag %d\n", digValid ? "ok" : "Neuaufbau", dig.days, (int)dig.hw);
+}
+
+#ifdef PV_ELECT
+// ======= Poller-Wahl (PvElect.h) =======
+// Nicht aktiv: Frames des Aktiven wie ein Client übernehmen (Anzeige, Energie-Teile, Spitzen,
+// Batterie), die Teile zusätzlich in den eigenen Ring (nach einer Übernahme beantwortet dieser
+// Knoten die Nachfragen), Verlauf aus den Karussell-Blöcken des Aktiven
+static PvRxState        electRx;                // UDP-Task (Frames)
+static PvFillClient     electFill;              // UDP-Task und loop() unter fillMux
+static PayloadOfferHist electHist;              // Stand des Aktiven aus seinem Heartbeat (electMux)
+static bool             electHistOk = false;
+static PayloadOfferHist electMine;              // eigener Stand, alle 10 s aus loop() (NVS)
+static bool             electMineOk = false;
+static uint32_t         electMineMs = 0, electSyncMs = 0;
+
+// Teil des Aktiven auf seinen Tag buchen: heute in die Akkus, frühere Tage in ihren Record
+static void electFillApply(const PayloadFillPart& p){
+  portENTER_CRITICAL(&fillMux);
+  pvFillPut(fill, p);
+  portEXIT_CRITICAL(&fillMux);
+  DayLock lk;
+  if (curY <= 2000) return;
+  const PvEnergy e = pvFillEnergy(p);
+  const uint8_t t = pvFillTarget(p.day, pvDayNum(curY,curM,curD), 0);
+  if (t == PVFILL_TODAY){ pvEnergyAdd(dayAgg, e); pvEnergyAdd(monthAgg, e); return; }
+  if (t != PVFILL_PAST || pvEnergyZero(e)) return;
+  int y,m,d; pvDayCivil(p.day, y, m, d);
+  DayAgg a; loadDayFromNVS(y,m,d,a);
+  pvEnergyAdd(a, e);
+  saveDayToNVS(y,m,d,a);
+  if (y==curY && m==curM) pvEnergyAdd(monthAgg, e);
+}
+
+static void electListenFrames(){
+  if (!udpFrame.listenMulticast(MCAST_GRP, MCAST_PORT, 1, TCPIP_ADAPTER_IF_STA)){
+    Serial.println("[ELECT] listenMulticast failed"); return;
+  }
+  udpFrame.onPacket([](AsyncUDPPacket p){
+    if (electActive() || p.remoteIP() == WiFi.localIP()) return;   // eigene Frames (Multicast-Schleife)
+    PV_TRACE_SCOPE(PVT_FRAME_RX, p.length());
+    const uint32_t rxMs = millis();
+    PvFrameV4 f;
+    uint8_t r = pvRxFrame(electRx, p.data(), p.length(), (uint32_t)p.remoteIP(), rxMs, f);
+    PvElectTag tag;
+    if (r == PVRX_FOREIGN && pvElectFrameGet(p.data(), p.length(), tag) && pvRxTakeover(electRx, (uint32_t)p.remoteIP(), tag.term))
+      r = pvRxFrame(electRx, p.data(), p.length(), (uint32_t)p.remoteIP(), rxMs, f);
+    if (!pvRxAccepted(r)) return;
+    if (f.seq > lastSeq) lastSeq = f.seq;   // nach einer Übernahme hier weiterzählen
+    lastF = f; haveFrame = true; lastRxMs = rxMs;
+
+    PayloadFillPart parts[PV_FILL_PARTS];
+    const uint8_t np = pvFillGet(p.data(), p.length(), PV_FRAME_WIRE+PV_TIME_WIRE, parts);
+    const size_t atBatt = PV_FRAME_WIRE+PV_TIME_WIRE+(np ? pvFillWire(np) : 0);
+    battOk = pvBattGet(p.data(), p.length(), atBatt, battEta);
+    pvBattUpdate(batt, rxMs, f.battW, f.socx10);   // Schätzer warm halten
+    portENTER_CRITICAL(&fillMux);
+    pvFillOnFrame(electFill, f.seq);
+    portEXIT_CRITICAL(&fillMux);
+    if (boot.timeOk){
+      handleDayMonthRollover();
+      for (uint8_t i=0; i<np; ++i) if (parts[i].seq == f.seq) electFillApply(parts[i]);
+      peakTick(lastF);
+    }
+    drawPending = true;
+  });
+}
+
+// Heartbeat eines anderen Knotens (UDP-Task)
+static void electOnHb(IPAddress ip, const uint8_t* pl, uint16_t len){
+  PayloadElect h;
+  if (!pvWireDecode(pl, len, h)) return;
+  portENTER_CRITICAL(&electMux);
+  electAct |= pvElectRx(elect, h, (uint32_t)ip, millis());
+  if (h.state == PVEL_ACTIVE && h.id == elect.activeId && (h.flags & PVEF_HIST)){
+    electHist = PayloadOfferHist{ h.hw, h.days, h.dig, 0, 0 };
+    electHistOk = true;
+  }
+  portEXIT_CRITICAL(&electMux);
+}
+
+// Stats-Paket, solange dieser Knoten nicht abfragt (UDP-Task): Discover, Nachfragen und
+// Karussell-Anfragen beantwortet der Aktive
+static void electOnStats(const StatsHdr* h, const uint8_t* pl){
+  switch (h->type){
+    case STATS_FILL:{
+      PayloadFill fh;
+      if (!pvWireDecode(pl, h->len, fh) || fh.n > PV_FILL_PER_PKT) return;
+      if (h->len < PvWire<PayloadFill>::size + fh.n*PvWire<PayloadFillPart>::size) return;
+      PayloadFillPart parts[PV_FILL_PER_PKT];
+      bool want[PV_FILL_PER_PKT];
+      portENTER_CRITICAL(&fillMux);
+      for (uint8_t i=0; i<fh.n; ++i){
+        PvWire<PayloadFillPart>::get(parts[i], pl + PvWire<PayloadFill>::size + i*PvWire<PayloadFillPart>::size);
+        want[i] = pvFillWanted(electFill, parts[i].seq);
+      }
+      for (uint8_t i=0; i<fh.n; ++i) pvFillDone(electFill, parts[i].seq);
+      pvFillOnReply(electFill, fh.oldest);
+      portEXIT_CRITICAL(&fillMux);
+      for (uint8_t i=0; i<fh.n; ++i) if (want[i]) electFillApply(parts[i]);
+    }break;
+    case STATS_CAR_BLOCK:{
+      // Blöcke des Aktiven gehen an alle: jeden Tag vor heute übernehmen (heute zählen die Frames)
+      PayloadCarBlock b;
+      if (curY <= 2000 || !pvWireDecode(pl, h->len, b)) return;
+      if (h->len < PvWire<PayloadCarBlock>::size + __builtin_popcount(b.mask)*PvWire<PayloadCarDay>::size) return;
+      const int32_t today = pvDayNum(curY, curM, curD);
+      const uint8_t* q = pl + PvWire<PayloadCarBlock>::size;
+      for (uint8_t i=0; i<PV_CAR_DAYS; ++i){
+        const int32_t n = b.first + (int32_t)b.idx*PV_CAR_DAYS + i;
+        if (!(b.mask & (1u<<i))){ carStoreDay(n, nullptr); continue; }
+        PayloadCarDay cd; PvWire<PayloadCarDay>::get(cd, q); q += PvWire<PayloadCarDay>::size;
+        if (n >= today) continue;
+        const PvEnergy a = pvCarEnergy(cd);
+        carStoreDay(n, &a);
+      }
+    }break;
+    case STATS_DEVICES:{
+      // PV je Gerät heute/Monat (Wh) als Stand, ab dem nach einer Übernahme weiterintegriert wird
+      PvDevInfo d;
+      if (!pvWireDecode(pl, h->len, d) || d.idx >= PV_MAX_DEVICES) return;
+      devInfo[d.idx] = d;
+      devCount = min<uint8_t>(d.count, PV_MAX_DEVICES);
+      pvEnergyClear(devDay[d.idx]); pvEnergyClear(devMon[d.idx]);
+      devDay[d.idx].e[PVE_GEN] = (int64_t)d.genTodayWh * PV_E_PER_MWH * 1000;
+      devMon[d.idx].e[PVE_GEN] = (int64_t)d.genMonthWh * PV_E_PER_MWH * 1000;
+    }break;
+    default: break;
+  }
+}
+
+// Lücke in den Frames des Aktiven: bei ihm nachfragen
+static void electFillTick(){
+  PayloadFillReq q;
+  portENTER_CRITICAL(&fillMux);
+  const bool ask = pvFillTick(electFill, millis(), q);
+  portEXIT_CRITICAL(&fillMux);
+  if (ask && electRx.src) statsSendMsg(IPAddress(electRx.src), STATS_MCAST_PORT, STATS_FILL_REQ, q);
+}
+
+// Verlauf weicht vom Aktiven ab: Karussell anstoßen (die Blöcke gehen an alle)
+static void electSyncTick(){
+  if (!electMineOk || millis() - electSyncMs < PV_ELECT_SYNC_MS) return;
+  portENTER_CRITICAL(&electMux);
+  const bool ok = electHistOk;
+  const PayloadOfferHist a = electHist;
+  portEXIT_CRITICAL(&electMux);
+  if (!ok || (a.hw == electMine.hw && a.days == electMine.days && a.dig == electMine.dig)) return;
+  electSyncMs = millis();
+  PayloadCarReq q{0};
+  statsSendMsg(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_CAR_REQ, q);
+  Serial.printf("[ELECT] Verlauf weicht ab (%u/%u Tage): Karussell angestoßen\n", electMine.days, a.days);
+}
+
+static void electTick(){
+  const uint32_t now = millis();
+  if (!electMineMs || now - electMineMs >= 10000){ electMineMs = now; electMineOk = carHist(0, electMine); }
+  uint32_t to[PV_ELECT_PEERS]; uint8_t nTo = 0;
+  portENTER_CRITICAL(&electMux);
+  const uint8_t a = electAct | (boot.wifiUp ? pvElectTick(elect, now) : pvElectLinkDown(elect, now));
+  electAct = 0;
+  PayloadElect hb = pvElectHb(elect, lastSeq, now);
+  if (a & PVEA_HB) for (uint8_t i=0; i<elect.n; ++i) if (now - elect.peer[i].ms < PV_ELECT_DEAD_MS) to[nTo++] = elect.peer[i].ip;
+  const uint32_t activeIp = elect.activeIp, activeSeq = elect.activeSeq;
+  portEXIT_CRITICAL(&electMux);
+
+  if (a & PVEA_YIELD){
+    poller.abort();
+    for (uint8_t p=0; p<poller.nPipe; ++p) mb.disconnect(devIP(PV_DEVICES[poller.pipe[p].dev[0]]));
+    Serial.printf("[ELECT] abgegeben (Amtszeit %u)\n", hb.term);
+  }
+  if (a & PVEA_FOLLOW) Serial.printf("[ELECT] folge %s, Amtszeit %u\n", IPAddress(activeIp).toString().c_str(), hb.term);
+  if (a & PVEA_CLAIM) Serial.printf("[ELECT] bewerbe mich, Amtszeit %u\n", hb.term);
+  if (a & PVEA_ACTIVE){
+    // Übernahme: seq weiterzählen, Integration frisch ansetzen, nächste Runde sofort
+    if (activeSeq > lastSeq) lastSeq = activeSeq;
+    integ.have = false;
+    for (uint8_t i=0; i<PV_DEVICE_COUNT; ++i) devInteg[i].have = false;
+    pollStartMs = millis() - POLL_INTERVAL_MS;
+    electRx = PvRxState{};
+    portENTER_CRITICAL(&fillMux);
+    pvFillReset(electFill);
+    portEXIT_CRITICAL(&fillMux);
+    Serial.printf("[ELECT] aktiv, Amtszeit %u, weiter ab Frame %u\n", hb.term, lastSeq + 1);
+  }
+  if (a & PVEA_HB){
+    if (electMineOk){ hb.flags |= PVEF_HIST; hb.hw = electMine.hw; hb.days = electMine.days; hb.dig = electMine.dig; }
+    statsSendMsg(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_ELECT, hb);
+    for (uint8_t k=0; k<nTo; ++k) statsSendMsg(IPAddress(to[k]), STATS_MCAST_PORT, STATS_ELECT, hb);
+  }
+  if (hb.state == PVEL_ACTIVE) return;
+  electFillTick();
+  electSyncTick();
+}
+
+static void printElect(){
+  portENTER_CRITICAL(&electMux);
+  const PvElect e = elect;
+  portEXIT_CRITICAL(&electMux);
+  const uint32_t now = millis();
+  const uint64_t fenced = e.fencedMs + (e.fenced ? now - e.fenceAt : 0);
+  Serial.printf("[ELECT] %s, Amtszeit %u (höchste %u), Prio %u, Knoten %08x | Aktiver %08x %s, vor %u ms\n",
+                pvElectStateName(e.state), e.term, e.maxTerm, e.prio, e.id, e.activeId,
+                IPAddress(e.activeIp).toString().c_str(), e.activeMs ? now - e.activeMs : 0);
+  Serial.printf("[ELECT] Heartbeats %u/%u | Bewerbungen %u, Übernahmen %u, abgegeben %u | Lease abgelaufen %u mal, %llu ms\n",
+                e.hbTx, e.hbRx, e.claims, e.takeovers, e.yields, e.fences, (unsigned long long)fenced);
+  for (uint8_t i=0; i<e.n; ++i){
+    const PvElectPeer& p = e.peer[i];
+    Serial.printf("  %08x %-15s %-12s Amtszeit %u, Prio %u, Frame %u, vor %u ms\n", p.id, IPAddress(p.ip).toString().c_str(),
+                  pvElectStateName(p.state), p.term, p.prio, p.seq, now - p.ms);
+  }
+}
+#endif
+
 static void statsPollerStart(){
   // Multicast: Discover empfangen, Offer senden
   if (!udpStatsCtrl.listenMulticast(STATS_MCAST_GRP, STATS_MCAST_PORT)){
     Serial.println("[STATS] mcast listen failed");
   }
   udpStatsCtrl.onPacket([](AsyncUDPPacket p){
-    if (p.length() < sizeof(StatsHdr)) return;
-    const StatsHdr* h = (const StatsHdr*)p.data();
-    if (h->magic!=0xCAFE || h->version!=1) return;
-    const uint8_t* pl = (const uint8_t*)p.data()+sizeof(StatsHdr);
-    if (pvstats_crc(*h, pl)!=h->crc) return;
-
+    StatsHdr hdr;
+    if (pvRxStats(p.data(), p.length(), hdr) != PVRX_OK) return;   // Kopf, Länge, CRC
+    const StatsHdr* h = &hdr;
+    const uint8_t* pl = (const uint8_t*)p.data()+STATS_HDR_WIRE;
+    PV_TRACE_SCOPE(PVT_STATS_RX, h->type);
+
+#ifdef PV_TRACE
+    if (h->type==STATS_TRACE_REQ){ traceDumpUdp(p.remoteIP(), p.remotePort()); return; }
+#endif
+#ifdef PV_ELECT
+    if (h->type==STATS_ELECT){ electOnHb(p.remoteIP(), pl, h->len); return; }
+    if (!electActive()){ electOnStats(h, pl); return; }   // folgt: antwortet der Aktive
+#endif
     if (h->type==STATS_DISCOVER){
-      PayloadOffer off{STATS_SERVER_PORT, 0};
-      statsSendTo(p.remoteIP(), p.remotePort(), STATS_OFFER, ++statsSeq, &off, sizeof(off));
-    } else if (h->type==STATS_REQ_RANGE){
-      if (h->len < sizeof(PayloadReqRange)) return;
+      statsSendOffer(p.remoteIP(), p.remotePort());   // Zeit-Anhang: der Client hat die Uhr vor dem ersten Frame
+    } else if (h->type==STATS_CAR_REQ){
+      carOnReq(pl, h->len);
+    } else if (h->type==STATS_CAR_NACK){
+      carOnNack(pl, h->len);
+    } else if (h->type==STATS_FILL_REQ){
+      PayloadFillReq q;
+      if (!pvWireDecode(pl, h->len, q) || q.to < q.from) return;
+      portENTER_CRITICAL(&fillMux);
+      if (fillAskN < 4) fillAsk[fillAskN++] = FillAsk{p.remoteIP(), p.remotePort(), q};   // voll: fragt nach PV_FILL_RETRY_MS wieder
+      portEXIT_CRITICAL(&fillMux);
+    } else if (h->type==STATS_REQ_RANGE){   // ältere Clients: eigener Unicast-Strom
+      PayloadReqRange r;
+      if (!pvWireDecode(pl, h->len, r)) return;
       // Unicast server
       if (!udpStatsSrv.listen(STATS_SERVER_PORT)){
         Serial.println("[STATS] server listen failed");
         return;
       }
       // Sende alle Tage + Monate
-      PayloadReqRange r = *(const PayloadReqRange*)pl;
 
       // Tage streamen (ab r.from*)
       int y= (r.fromY? r.fromY:1970), m=(r.fromM? r.fromM:1), d=(r.fromD? r.fromD:1);
       int ty,tm,td; todayYMD(ty,tm,td);
       while ( (y<ty) || (y==ty && (m<tm || (m==tm && d<=td))) ){
-        DayAgg a; if (!loadDayFromNVS(y,m,d,a)) a={0,0,0,0,0};
-        PayloadDay pd{ (uint16_t)y,(uint16_t)m,(uint16_t)d, a.gen_kWh, a.load_kWh, a.impT1_kWh, a.impT2_kWh, a.exp_kWh };
-        statsSendTo(p.remoteIP(), STATS_SERVER_PORT, STATS_DAY, ++statsSeq, &pd, sizeof(pd));
+        DayAgg a; loadDayFromNVS(y,m,d,a);
+        PvEnergyKWh k = pvEnergyToKWh(a);
+        PayloadDay pd{ (uint16_t)y,(uint16_t)m,(uint16_t)d, k.gen_kWh, k.load_kWh, k.impT1_kWh, k.impT2_kWh, k.exp_kWh };
+        statsSendMsg(p.remoteIP(), STATS_SERVER_PORT, STATS_DAY, pd);
+        if (a.pk.n) statsSendPeaks(p.remoteIP(), STATS_SERVER_PORT, pvDayNum(y,m,d), PVL_DAY, a.pk);
         // nächster Tag
         int dim=daysInMonthInline(y,m); d++; if (d>dim){ d=1; m++; if (m>12){ m=1; y++; } }
         delay(2);
@@ -606,8 +1556,10 @@ static void statsPollerStart(){
       y=(r.fromMonY? r.fromMonY:1970); m=(r.fromMonM? r.fromMonM:1);
       while ( (y<ty) || (y==ty && m<=tm) ){
         MonthAgg ma; loadMonthFromNVS(y,m,ma);
-        PayloadMon pm{ (uint16_t)y,(uint16_t)m, ma.gen_kWh, ma.load_kWh, ma.impT1_kWh, ma.impT2_kWh, ma.exp_kWh };
-        statsSendTo(p.remoteIP(), STATS_SERVER_PORT, STATS_MON, ++statsSeq, &pm, sizeof(pm));
+        PvEnergyKWh k = pvEnergyToKWh(ma);
+        PayloadMon pm{ (uint16_t)y,(uint16_t)m, k.gen_kWh, k.load_kWh, k.impT1_kWh, k.impT2_kWh, k.exp_kWh };
+        statsSendMsg(p.remoteIP(), STATS_SERVER_PORT, STATS_MON, pm);
+        if (ma.pk.n) statsSendPeaks(p.remoteIP(), STATS_SERVER_PORT, pvDayNum(y,m,1), PVL_MONTH, ma.pk);
         m++; if (m>12){ m=1; y++; }
         delay(2);
       }
@@ -617,143 +1569,563 @@ static void statsPollerStart(){
   });
 }
 #else
-static IPAddress statsServerIP;
-static uint16_t  statsServerPort=0;
+// Karussell (PvCarousel.h): Blöcke im UDP-Task, Anfragen/NACKs aus loop(); Quellen (PvPeer.h)
+// aus den Offers, nach Mitternacht die letzten Blöcke vom Poller
+static PvCarReceiver carRx;
+static PvPeerTable   peers;
+static uint32_t      carAskIp = 0, carAskRx = 0;
+static volatile bool carToPoller = false;
+static bool          carTailServe = false;   // nach der Mitternachts-Reparatur wieder Peer
+
+// aktuellen Tag/Monat in RAM laden (ohne gültige Uhr übernimmt das später die Initialisierung)
+// UDP-Task (STATS_DONE) und loop() (carVerify): dayAgg/monthAgg/fillFinal unter DayLock,
+// damit keine Teile aus fillApply()/integrateTick() zwischen Laden und Ersetzen landen
+static void statsSyncDone(){
+  DayLock lk;
+  statsSynced = true;
+  if (!boot.timeOk) return;
+  int y,m,d; todayYMD(y,m,d);
+  DayAgg td; if (loadDayFromNVS(y,m,d,td)) dayAgg=td;
+  MonthAgg tm; if (loadMonthFromNVS(y,m,tm)) monthAgg=tm;   // fehlt der Monat beim Poller: eigenen behalten
+  fillFinal = pvDayNum(y,m,d) - 1;   // Tage davor sind jetzt die des Pollers
+}
+
+// Abgleich fertig: Stand gegen den Digest des Pollers. Ohne sein Offer weiter warten (Discover
+// läuft nach PV_SYNC_TIMEOUT_MS wieder), falsch: einmal alles nur vom Poller
+static void carVerify(){
+  if (!carRx.done || statsSynced) return;
+  PayloadOfferHist mine;
+  if (!carHist(0, mine)) return;
+  portENTER_CRITICAL(&carMux);
+  const uint8_t v = pvPeerVerify(peers, mine);
+  const bool retry = v == PVPEER_BAD && !peers.pollerOnly;
+  if (retry){ peers.pollerOnly = true; pvCarStart(carRx, millis()); }
+  portEXIT_CRITICAL(&carMux);
+  if (v == PVPEER_WAIT) return;
+  if (retry){ Serial.println("[PEER] Digest weicht vom Poller ab: Verlauf neu vom Poller"); return; }
+  if (v == PVPEER_BAD) Serial.println("[PEER] Digest weicht weiter ab: kein Peer");
+  carServe = v == PVPEER_OK;
+  statsSyncDone();
+}
+
+// Mitternacht: gestern hat der Poller den Tag geschlossen, nicht die Peers. Bis die letzten
+// Blöcke von ihm da sind, nur seine annehmen und selbst nicht als Peer anbieten
+static bool carRolloverTail(){
+  portENTER_CRITICAL(&carMux);
+  pvCarTail(carRx, millis(), esp_random());
+  carToPoller = !carRx.done;
+  portEXIT_CRITICAL(&carMux);
+  if (carToPoller){ carTailServe = carServe; carServe = false; }
+  return carToPoller;
+}
+
+static void carClientTick(){
+  const uint32_t rnd = esp_random(), now = millis();
+  uint8_t pl[PV_CAR_NACK_MAX];
+  size_t n = 0; uint32_t src = 0;
+  portENTER_CRITICAL(&carMux);
+  const uint8_t what = pvCarTick(carRx, now, rnd);
+  const bool tailDone = carRx.done && carToPoller;
+  if (carRx.done) carToPoller = false;
+  if (what){
+    // letzte Quelle hat seit der vorigen Anfrage nichts geliefert: eine andere
+    if (carAskIp && carRx.rx == carAskRx) pvPeerFail(peers, carAskIp);
+    src = carToPoller ? 0 : pvPeerPick(peers, now);
+    carAskIp = src; carAskRx = carRx.rx;
+    if (what == PVCAR_NACK) n = pvCarBuildNack(carRx, src, pl);
+  }
+  portEXIT_CRITICAL(&carMux);
+  if (what == PVCAR_REQ){ PayloadCarReq q{src}; statsSendMsg(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_CAR_REQ, q); }
+  if (what == PVCAR_NACK) statsSendTo(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_CAR_NACK, ++statsSeq, pl, (uint16_t)n);
+  if (tailDone) carServe = carTailServe;
+  carVerify();
+}
+
+// Verpasste Frames beim Poller nachfragen (ohne Offer: an alle, der Poller antwortet)
+static void fillClientTick(){
+  PayloadFillReq q;
+  portENTER_CRITICAL(&fillMux);
+  const bool ask = pvFillTick(fillRx, millis(), q);
+  const uint32_t lost = fillRx.lost;
+  const int32_t gapDay = fillGapDay;
+  portEXIT_CRITICAL(&fillMux);
+  // Ausfall über Mitternacht: erst danach verloren, also auch Frames von gestern -> Reparatur
+  if (lost != fillPastMark && curY > 2000){
+    fillPastMark = lost;
+    const int32_t today = pvDayNum(curY,curM,curD);
+    if (gapDay && gapDay < today && fillFinal < today - 1 && carRolloverTail()) fillFinal = today - 1;
+  }
+  if (!ask) return;
+  if ((uint32_t)statsServerIP) statsSendMsg(statsServerIP, STATS_MCAST_PORT, STATS_FILL_REQ, q);
+  else statsSendMsg(STATS_MCAST_GRP, STATS_MCAST_PORT, STATS_FILL_REQ, q);
+}
+
+static void printFill(){
+  Serial.printf("[FILL] %s | Lücken %u, Frames fehlten %u, nachgeholt %u, verloren %u, offen %u | Anfragen %u\n",
+                fillOn ? "Teile vom Poller" : "eigene Integration", fillRx.gaps, fillRx.missed, fillRx.filled,
+                fillRx.lost, pvFillBits(fillRx.miss), fillRx.reqs);
+}
+
+static void printBatt(){
+  if (!battOk){ Serial.println("[BATT] kein Anhang im Frame (älterer Poller)"); return; }
+  Serial.printf("[BATT] %s, Konfidenz %u%% | 20%% %ld s, voll %ld s, leer %ld s, %.1f %%/h\n",
+                battEta.dir==PVB_CHG ? "lädt" : battEta.dir==PVB_DIS ? "entlädt" : "ruht", battEta.conf,
+                (long)battEta.eta20s, (long)battEta.fullS, (long)battEta.emptyS, battEta.ratex10/10.0f);
+}
+
+static void printCarousel(){
+  const uint32_t t = carRx.done ? carRx.doneMs - carRx.startMs : millis() - carRx.startMs;
+  Serial.printf("[CAR] %s: Blöcke %u/%u, empfangen %u, doppelt %u | Anfragen %u, NACKs %u (zurückgehalten %u) | %u ms\n",
+                !carRx.active ? "aus" : carRx.done ? "fertig" : "läuft", carRx.have, carRx.blocks,
+                carRx.rx, carRx.dup, carRx.reqs, carRx.nacks, carRx.held, t);
+  Serial.printf("[PEER] Digest %s: %u Tage bis Tag %d | Offers %u, Quellen %u, ausgefallen %u | %s",
+                digValid ? "ok" : "Neuaufbau", dig.days, (int)dig.hw, peers.offers, peers.n, peers.fails,
+                carServe ? "Peer" : "kein Peer");
+  if (carServe) Serial.printf(": Anfragen %u, NACKs %u, Blöcke gesendet %u", car.reqs, car.nacks, car.sent);
+  Serial.println();
+}
 
 static void statsClientStart(){
   if (!udpStatsCtrl.listenMulticast(STATS_MCAST_GRP, STATS_MCAST_PORT)){
     Serial.println("[STATS] mcast listen failed");
   }
   udpStatsCtrl.onPacket([](AsyncUDPPacket p){
-    if (p.length() < sizeof(StatsHdr)) return;
-    const StatsHdr* h = (const StatsHdr*)p.data();
-    if (h->magic!=0xCAFE || h->version!=1) return;
-    const uint8_t* pl = (const uint8_t*)p.data()+sizeof(StatsHdr);
-    if (pvstats_crc(*h, pl)!=h->crc) return;
+    StatsHdr hdr;
+    if (pvRxStats(p.data(), p.length(), hdr) != PVRX_OK) return;   // Kopf, Länge, CRC
+    const StatsHdr* h = &hdr;
+    const uint8_t* pl = (const uint8_t*)p.data()+STATS_HDR_WIRE;
+    PV_TRACE_SCOPE(PVT_STATS_RX, h->type);
 
     switch(h->type){
+      case STATS_DISCOVER:
+        if (carServe) statsSendOffer(p.remoteIP(), p.remotePort());   // abgeglichen: als Peer anbieten
+        break;
       case STATS_OFFER:{
-        if (h->len<sizeof(PayloadOffer)) return;
-        const PayloadOffer* off = (const PayloadOffer*)pl;
-        statsServerIP = p.remoteIP(); statsServerPort = off->statsPort;
-        // Alles ab Beginn anfordern
+        PayloadOffer off;
+        if (!pvWireDecode(pl, h->len, off)) return;
+        uint32_t rxMs = millis();
+        uint64_t pollerMs;   // Zeit-Anhang (fehlt bei älteren Pollern, ohne PVTM_SYNCED vom Peer)
+        if (pvFrameTimeGet(pl, h->len, PvWire<PayloadOffer>::size, pollerMs)) clockSample(rxMs, pollerMs);
+        const bool peer = off.flags & STATS_OFFER_PEER;
+        PayloadOfferHist hist;
+        const size_t at = PvWire<PayloadOffer>::size + PV_TIME_WIRE;
+        const bool hasHist = (off.flags & STATS_OFFER_HIST) && pvWireDecode(pl + at, h->len > at ? h->len - at : 0, hist);
+        portENTER_CRITICAL(&carMux);
+        pvPeerOffer(peers, (uint32_t)p.remoteIP(), !peer, hasHist ? &hist : nullptr, millis());
+        portEXIT_CRITICAL(&carMux);
+        // Offer eines Peers: Discover läuft weiter, bis der Poller antwortet (Prüfung in carVerify())
+        if (!peer){ statsServerIP = p.remoteIP(); statsServerPort = off.statsPort; statsOfferMs = millis(); }
+        if (off.flags & STATS_OFFER_CAROUSEL){
+          // Karussell: Anfrage schickt carClientTick(), eine laufende Runde nicht neu beginnen
+          portENTER_CRITICAL(&carMux);
+          if (!carRx.active) pvCarStart(carRx, millis());
+          portEXIT_CRITICAL(&carMux);
+          break;
+        }
+        if (peer) break;
+        // älterer Poller: alles ab Beginn anfordern
         PayloadReqRange r{}; r.fromY=0; r.fromM=0; r.fromD=0; r.fromMonY=0; r.fromMonM=0;
-        statsSendTo(statsServerIP, statsServerPort, STATS_REQ_RANGE, ++statsSeq, &r, sizeof(r));
+        statsSendMsg(statsServerIP, statsServerPort, STATS_REQ_RANGE, r);
+      }break;
+      case STATS_CAR_BLOCK:{
+        PayloadCarBlock b;
+        if (!pvWireDecode(pl, h->len, b)) return;
+        if (h->len < PvWire<PayloadCarBlock>::size + __builtin_popcount(b.mask)*PvWire<PayloadCarDay>::size) return;
+        if (carToPoller && p.remoteIP() != statsServerIP) break;   // Reparatur nach Mitternacht
+        portENTER_CRITICAL(&carMux);
+        const bool fresh = pvCarOnBlock(carRx, b, millis());
+        portEXIT_CRITICAL(&carMux);
+        if (!fresh) break;
+        const uint8_t* q = pl + PvWire<PayloadCarBlock>::size;
+        for (uint8_t i=0; i<PV_CAR_DAYS; ++i){
+          const int32_t n = b.first + (int32_t)b.idx*PV_CAR_DAYS + i;
+          if (!(b.mask & (1u<<i))){ carStoreDay(n, nullptr); continue; }
+          PayloadCarDay cd; PvWire<PayloadCarDay>::get(cd, q); q += PvWire<PayloadCarDay>::size;
+          const PvEnergy a = pvCarEnergy(cd);
+          carStoreDay(n, &a);
+        }
       }break;
+      case STATS_CAR_IDLE:{
+        PayloadCarBlock b;
+        if (!pvWireDecode(pl, h->len, b)) return;
+        if (carToPoller && p.remoteIP() != statsServerIP) break;
+        const uint32_t rnd = esp_random();
+        portENTER_CRITICAL(&carMux);
+        pvCarOnIdle(carRx, b, millis(), rnd);
+        portEXIT_CRITICAL(&carMux);
+      }break;
+      case STATS_CAR_REQ:
+        carOnReq(pl, h->len);   // nur als Peer und an diese Adresse
+        break;
+      case STATS_FILL:{
+        PayloadFill fh;
+        if (!pvWireDecode(pl, h->len, fh) || fh.n > PV_FILL_PER_PKT) return;
+        if (h->len < PvWire<PayloadFill>::size + fh.n*PvWire<PayloadFillPart>::size) return;
+        PayloadFillPart parts[PV_FILL_PER_PKT];
+        bool want[PV_FILL_PER_PKT];
+        portENTER_CRITICAL(&fillMux);
+        for (uint8_t i=0; i<fh.n; ++i){
+          PvWire<PayloadFillPart>::get(parts[i], pl + PvWire<PayloadFill>::size + i*PvWire<PayloadFillPart>::size);
+          want[i] = pvFillWanted(fillRx, parts[i].seq);
+        }
+        for (uint8_t i=0; i<fh.n; ++i) pvFillDone(fillRx, parts[i].seq);   // alle Teile eines Frames im selben Paket
+        pvFillOnReply(fillRx, fh.oldest);
+        portEXIT_CRITICAL(&fillMux);
+        for (uint8_t i=0; i<fh.n; ++i) if (want[i]) fillApply(parts[i]);
+      }break;
+      case STATS_CAR_NACK:
+        carOnNack(pl, h->len);
+        portENTER_CRITICAL(&carMux);
+        pvCarOnNack(carRx, millis());
+        portEXIT_CRITICAL(&carMux);
+        break;
       case STATS_DAY:{
-        if (h->len<sizeof(PayloadDay)) return;
-        const PayloadDay* d = (const PayloadDay*)pl;
-        DayAgg a{ d->gen_kWh, d->load_kWh, d->impT1_kWh, d->impT2_kWh, d->exp_kWh };
-        saveDayToNVS(d->y, d->m, d->d, a);
+        PayloadDay d;
+        if (!pvWireDecode(pl, h->len, d)) return;
+        DayLock lk;
+        DayAgg a; loadDayFromNVS(d.y, d.m, d.d, a);   // Spitzen behalten (STATS_PEAKS folgt)
+        static_cast<PvEnergy&>(a) = pvEnergyFromKWh(d.gen_kWh, d.load_kWh, d.impT1_kWh, d.impT2_kWh, d.exp_kWh);
+        saveDayToNVS(d.y, d.m, d.d, a);
       }break;
-      case STATS_MON:{
-        if (h->len<sizeof(PayloadMon)) return;
-        const PayloadMon* m = (const PayloadMon*)pl;
-        MonthAgg a{ m->gen_kWh, m->load_kWh, m->impT1_kWh, m->impT2_kWh, m->exp_kWh };
-        saveMonthToNVS(m->y, m->m, a);
+      case STATS_MON:
+        // Monats-Key = Summe der Tage (pvRollupDay aus STATS_DAY); die kWh-Summe des Pollers
+        // würde ihn überschreiben und der Tag zählte beim Schließen doppelt. Spitzen: STATS_PEAKS
+        break;
+      case STATS_PEAKS:{
+        PayloadPeaks ph; PvPeaks pk;
+        if (!pvPeakMsgGet(pl, h->len, ph, pk)) return;
+        peakRxMs = millis() ? millis() : 1;
+        peakApply(ph, pk);
       }break;
-      case STATS_DONE:{
-        // aktuellen Tag/Monat in RAM laden
-        int y,m,d; todayYMD(y,m,d);
-        DayAgg td; if (loadDayFromNVS(y,m,d,td)) dayAgg=td;
-        MonthAgg tm; loadMonthFromNVS(y,m,tm); monthAgg=tm;
+      case STATS_DEVICES:{
+        PvDevInfo d;
+        if (!pvWireDecode(pl, h->len, d)) return;
+        if (d.idx >= PV_MAX_DEVICES) return;
+        devInfo[d.idx] = d;
+        devCount = min<uint8_t>(d.count, PV_MAX_DEVICES);
       }break;
+      case STATS_DONE:
+        statsSyncDone();
+        break;
+#ifdef PV_TRACE
+      case STATS_TRACE_REQ:
+        traceDumpUdp(p.remoteIP(), p.remotePort());
+        break;
+#endif
       default: break;
     }
   });
+  // Discover schickt bootTick() (wiederholt, bis ein Server antwortet)
+}
+#endif
+
+// ======= Strom sparen (PvSleep.h) =======
+static void blWrite(uint8_t duty){
+#if defined(ESP_IDF_VERSION_MAJOR) && ESP_IDF_VERSION_MAJOR >= 5
+  ledcWrite(TFT_BL, duty);
+#else
+  ledcWrite(PV_BL_LEDC_CH, duty);
+#endif
+}
+
+static void blBegin(){
+#if defined(ESP_IDF_VERSION_MAJOR) && ESP_IDF_VERSION_MAJOR >= 5
+  ledcAttach(TFT_BL, PV_BL_PWM_HZ, 8);
+#else
+  ledcSetup(PV_BL_LEDC_CH, PV_BL_PWM_HZ, 8); ledcAttachPin(TFT_BL, PV_BL_LEDC_CH);
+#endif
+  blWrite(pvBacklightDuty(blLevel));
+}
+
+// alle PV_BL_TICK_MS: Ziel nach Berührung, Umgebungslicht bzw. Ortszeit, dunkler in Schritten
+static void blTick(){
+  static uint32_t last = 0;
+  const uint32_t now = millis();
+  if (now - last < PV_BL_TICK_MS) return;
+  last = now;
+#ifdef PV_LDR_PIN
+  pvAmbientAdd(ambient, analogRead(PV_LDR_PIN));
+#endif
+  int32_t minute = -1;
+  if (boot.timeOk){ time_t t; time(&t); int hh, mm; pvCalWall(pvCalNow(), t, hh, mm); minute = hh*60 + mm; }
+  const uint8_t l = pvBacklightStep(blLevel, pvBacklightTarget(minute, pvAmbientLevel(ambient), now - touchLastMs));
+  if (l != blLevel){ blLevel = l; blWrite(pvBacklightDuty(l)); }
+}
 
-  // Discover anstoßen
-  statsSendDiscover();
+#ifndef ROLE_POLLER
+// Funk nach Plan: Modem-Sleep bis kurz vor dem nächsten Frame, solange nichts anderes das Netz
+// braucht; dann auch die CPU langsamer und längere Pausen in loop()
+static void sleepTick(){
+  const uint32_t now = millis();
+  portENTER_CRITICAL(&carMux);
+  bool busy = (carRx.active && !carRx.done) || car.blocks;   // Verlauf holen bzw. als Peer senden
+  portEXIT_CRITICAL(&carMux);
+  portENTER_CRITICAL(&fillMux);
+  busy = busy || fillRx.miss || fillRx.due;                   // verpasste Frames nachfragen
+  portEXIT_CRITICAL(&fillMux);
+  busy = busy || !boot.live || !statsSynced || histBusy();   // ... oder Verlauf über TCP
+  portENTER_CRITICAL(&sleepMux);
+  const PvSleepPlan pl = pvSleepPlan(slp, now, busy);
+  portEXIT_CRITICAL(&sleepMux);
+  if (pl.radio != slpRadio){ slpRadio = pl.radio; WiFi.setSleep(pl.radio ? WIFI_PS_NONE : WIFI_PS_MAX_MODEM); }
+  const bool low = !pl.radio && !drawPending && now - touchLastMs >= PV_SLEEP_TOUCH_MS;
+  if (low != slpCpuLow){ slpCpuLow = low; setCpuFrequencyMhz(low ? PV_CPU_IDLE_MHZ : 240); }
+  if (!low){ delay(5); return; }
+  const uint32_t idle = pl.idleMs < PV_SLEEP_LOOP_MS ? pl.idleMs : PV_SLEEP_LOOP_MS;
+#ifdef PV_LIGHT_SLEEP
+  // LEDC läuft im Light-Sleep nicht weiter: nur bei dunklem Display; Berührung weckt (T_IRQ)
+  if (blLevel == 0 && pl.idleMs >= PV_SLEEP_MIN_MS && !flush.inFlight){
+    esp_sleep_enable_timer_wakeup((uint64_t)(pl.idleMs < 1000 ? pl.idleMs : 1000) * 1000);
+    // GPIO-Wecken geht nur mit Pegel-Interrupt: gpio_wakeup_enable() stellt T_IRQ auf LOW_LEVEL
+    // um, das gilt auch für touchIsr. Nach dem Aufwachen deshalb wieder abschalten und die
+    // fallende Flanke aus touchBegin() herstellen, sonst feuert touchIsr, solange der Finger
+    // liegt (Interrupt-Sturm, Watchdog) und der Touch-Task sieht keine Flanken mehr.
+    gpio_wakeup_enable((gpio_num_t)XPT2046_IRQ, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    esp_light_sleep_start();
+    gpio_wakeup_disable((gpio_num_t)XPT2046_IRQ);
+    gpio_set_intr_type((gpio_num_t)XPT2046_IRQ, GPIO_INTR_NEGEDGE);
+    return;
+  }
+#endif
+  delay(idle);
 }
 #endif
 
+static void printSleep(){
+#ifndef ROLE_POLLER
+  portENTER_CRITICAL(&sleepMux);
+  const PvSleep s = slp;
+  portEXIT_CRITICAL(&sleepMux);
+  const uint32_t d = pvSleepDutyPermille(s);
+  Serial.printf("[SLEEP] Funk an %u.%u %% (an %u s, Modem-Sleep %u s), Plan %s, Frames %u, Lücken %u, ausgeblieben %u, Wecken %u, Fenster +%u ms, CPU %u MHz\n",
+                d/10, d%10, (uint32_t)(s.onMs/1000), (uint32_t)(s.offMs/1000), s.have ? "ja" : "nein",
+                s.frames, s.gaps, s.misses, s.wakes, s.extra, getCpuFrequencyMhz());
+#endif
+  Serial.printf("[SLEEP] Backlight %u/255 (PWM %u), Umgebung %d\n", blLevel, pvBacklightDuty(blLevel), pvAmbientLevel(ambient));
+}
+
+// ======= Start: Boot-Cache + Automat (PvBoot.h) =======
+// Cache lesen: RTC (nach Software-Reset neuer) vor NVS (nach Stromausfall)
+static void bootCacheLoad(){
+  const char* src = nullptr;
+  if (pvBootCacheValid(rtcCache)){ bootCache = rtcCache; src = "RTC"; }
+  else {
+    nvsBegin();
+    if (prefs.getBytesLength("boot") == sizeof(bootCache) &&
+        prefs.getBytes("boot", &bootCache, sizeof(bootCache)) == sizeof(bootCache) && pvBootCacheValid(bootCache)) src = "NVS";
+  }
+  boot.log.mark(PVB_CACHE, millis());
+  if (!src){ Serial.println("[BOOT] kein Cache"); return; }
+  bootCacheOk = true;
+  lastF = bootCache.f; haveFrame = true;
+  if (bootCache.page < pvMaxPages()) pageIndex = bootCache.page;
+  Serial.printf("[BOOT] Cache aus %s, Frame seq %u\n", src, bootCache.f.seq);
+}
+
+// Nach jedem frischen Frame in den RTC-Speicher, ins NVS höchstens alle PV_BOOT_SAVE_MS.
+// Erst mit gültiger Uhr: vorher sind die Akkus noch nicht aus dem alten Cache übernommen.
+static void bootCacheStore(){
+  if (!boot.timeOk || !haveFrame || lastRxMs == bootCachedRx || curY <= 2000) return;
+  bootCachedRx = lastRxMs;
+  PvBootCache c;
+  c.page = (uint8_t)pageIndex; c.ymd = pvYmd(curY,curM,curD);
+  time_t n; time(&n); c.savedTs = (uint32_t)n;
+  c.f = lastF; c.day = dayAgg; c.month = monthAgg; c.dayPk = dayAgg.pk; c.monthPk = monthAgg.pk;
+  pvBootCacheSeal(c);
+  rtcCache = c;
+  if (bootSavedMs && millis()-bootSavedMs < PV_BOOT_SAVE_MS) return;
+  bootSavedMs = millis() ? millis() : 1;
+  nvsBegin(); prefs.putBytes("boot", &c, sizeof(c));
+}
+
+static void printBootLog(){
+  Serial.print("[BOOT]");
+  for (uint8_t p=0; p<PVB_COUNT; ++p)
+    if (boot.log.reached(p)) Serial.printf(" %s=%u", pvBootPhaseName(p), boot.log.ms[p]);
+  Serial.printf(" ms | WLAN-Neuversuche %u, Discover %u, NTP-Starts %u\n", boot.wifiRetries, boot.discovers, boot.ntpStarts);
+}
+
+static void bootTick(){
+  time_t t; time(&t);
+#ifdef ROLE_POLLER
+  const bool pollerClock = false;
+#else
+  const bool pollerClock = pvClockFresh(clk, millis());
+#endif
+  PvBootIn in{ WiFi.status()==WL_CONNECTED, pvTimeValid(t), statsOfferMs, statsSynced, lastRxMs, pollerClock };
+  uint16_t a = pvBootStep(boot, millis(), in);
+  if (a) PV_TRACE_INSTANT(PVT_BOOT, a);
+  if (a & PVBA_WIFI_RETRY){ Serial.println("[WiFi] neu verbinden"); WiFi.disconnect(); WiFi.begin(ssid, password); }
+  if (a & PVBA_NET_UP){
+    Serial.println("[WiFi] " + WiFi.localIP().toString());
+#ifdef ROLE_POLLER
+    statsPollerStart();                        // Modbus verbindet loop(), sobald das Netz steht
+  #ifdef PV_ELECT
+    electListenFrames();                       // Frames des Aktiven, solange dieser Knoten folgt
+  #endif
+#else
+    beginListenFrames();
+    statsClientStart();
+#endif
+  }
+  if (a & PVBA_TIME_OK) handleDayMonthRollover();   // Tagesanker + Akkus aus NVS/Boot-Cache
+#ifdef ROLE_POLLER
+  if ((a & PVBA_TIME_OK) && boot.live && electActive()) frameSend();  // Clients bekommen die Zeit nicht erst mit der nächsten Runde
+#endif
+  if (a & PVBA_DISCOVER) statsSendDiscover();
+#ifndef ROLE_POLLER
+  if (a & PVBA_NTP_START){ Serial.println("[CLK] keine Poller-Zeit: NTP"); configTzTime(TZ_EU_ZURICH, NTP1, NTP2, NTP3); }
+  if (a & PVBA_NTP_STOP){ Serial.println("[CLK] Poller-Zeit: NTP aus"); ntpStop(); }
+#endif
+  if (a & PVBA_LIVE) printBootLog();
+  if (a & PVBA_REDRAW){ pvStale = boot.stale; drawPending = true; }
+  bootCacheStore();
+}
+
 // ===== Setup / Loop =====
+// Kein Warten auf WLAN/NTP: erst die letzte Seite aus dem Boot-Cache (als "alt" markiert),
+// dann alles Weitere nebeneinander über bootTick() in loop()
 void setup(){
   Serial.begin(115200);
+  dayMux = xSemaphoreCreateRecursiveMutex();
+  setenv("TZ", TZ_EU_ZURICH, 1); tzset();   // Ortszeit schon vor NTP (RTC-Zeit nach Software-Reset)
   tft.init(); tft.setRotation(TFT_ROTATION);
-  tft.fillScreen(TFT_BLACK);
+  flushBegin();
+
+  bootCacheLoad();
+  if (haveFrame){
+    pvStale = true;
+    drawIfFrame(); flush.fence();
+  } else {
+    tft.fillScreen(TFT_BLACK);
+    tft.setTextDatum(MC_DATUM);
+    tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
+#ifdef ROLE_POLLER
+    tft.drawString("Poller bereit…", 160, 120);
+#else
+    tft.drawString("Warte auf PV-Daten…", 160, 120);
+#endif
+  }
   #ifdef TFT_BL
-    pinMode(TFT_BL, OUTPUT); digitalWrite(TFT_BL, HIGH);
+    blBegin();   // erst jetzt: kein schwarzes/halbes Bild
   #endif
+  boot.log.mark(PVB_PIXEL, millis());
 
   // Touch init
   touchscreenSPI.begin(XPT2046_CLK, XPT2046_MISO, XPT2046_MOSI, XPT2046_CS);
   touchscreen.begin(touchscreenSPI);
   touchscreen.setRotation(1);  // Landscape-1
+  touchBegin();
 
+  // WLAN anstoßen; Poller: NTP gleich mit (SNTP fragt, sobald die Verbindung steht),
+  // Client: Uhr aus Offer/Frames des Pollers, NTP nur ersatzweise (bootTick)
   WiFi.mode(WIFI_STA);
   WiFi.begin(ssid, password);
-  while(WiFi.status()!=WL_CONNECTED){ delay(300); Serial.print("."); }
-  Serial.println(); Serial.println("[WiFi] " + WiFi.localIP().toString());
-
-  configTzTime(TZ_EU_ZURICH, "pool.ntp.org", "time.google.com", "time.cloudflare.com");
-  delay(300);
-
-  // Init Tages-/Monatsanker
-  int y,m,d; todayYMD(y,m,d);
-  curY=y;curM=m;curD=d;
-  loadMonthFromNVS(y,m, monthAgg);
-  DayAgg td; if (loadDayFromNVS(y,m,d, td)) dayAgg=td;
-
 #ifdef ROLE_POLLER
-  // Modbus
-  mb.client();
-  mb.connect(inverterIP, modbusPort);
-
-  // Stats-Server:
-  statsPollerStart();
-#else
-  // Client: Frames empfangen + Stats-Client
-  beginListenFrames();
-  statsClientStart();
+  configTzTime(TZ_EU_ZURICH, NTP1, NTP2, NTP3);
 #endif
 
-  // Startscreen
-  tft.setTextDatum(MC_DATUM);
-  tft.setTextFont(2); tft.setTextSize(1); tft.setTextColor(TFT_WHITE, TFT_BLACK);
 #ifdef ROLE_POLLER
-  tft.drawString("Poller bereit…", 160, 120);
+  // Modbus: eine Verbindung je Endpunkt, Pipelines in PvPoll.h (verbunden wird in loop())
+  mb.client();
+  poller.begin(&mbTx, PV_DEVICES, PV_DEVICE_COUNT);
+  poller.timeoutMs = TIMEOUT_MS;
+  battBegin();
+  #ifdef PV_ELECT
+  pvElectBegin(elect, (uint32_t)(ESP.getEfuseMac() >> 16), PV_ELECT_PRIO, millis());   // abgefragt wird erst nach der Wahl
+  #endif
 #else
-  tft.drawString("Warte auf PV-Daten…", 160, 120);
+  boot.discover = true;      // Stats-Client: Discover bis zum Offer wiederholen
+  boot.ntpFallback = true;   // Uhr vom Poller
 #endif
 }
 
 void loop(){
+  // Serial-Befehle: 't' Trace-Dump, 's' Empfangsstatistik (Client), 'm' Geräte/Poll-Zeiten (Poller),
+  //                'd' Display-Zeiten, 'g' Touch-Samples mitschreiben an/aus (für tools/pvgesture.cpp),
+  //                'b' Start-Phasen (ms ab Reset), 'u' Uhr nach Poller (Client), 'h' Verlauf-Stufen,
+  //                'k' Verlauf-Karussell (Runden, NACKs, Dauer), 'f' Energie verpasster Frames,
+  //                'a' Batterie-Schätzer, 'p' Spitzen heute/Monat, 'w' Funk-Plan/Backlight,
+  //                'e' Poller-Wahl (PV_ELECT), 'x' Verlauf über TCP
+  if (Serial.available()){
+    char c = Serial.read(); (void)c;
+    if (c=='d') printFlushStats();
+    if (c=='b') printBootLog();
+    if (c=='h') printRollup();
+    if (c=='k') printCarousel();
+    if (c=='f') printFill();
+    if (c=='a') printBatt();
+    if (c=='p') printPeaks();
+    if (c=='w') printSleep();
+    if (c=='x') printHist();
+    if (c=='g'){ touchRec = !touchRec; Serial.printf("[TOUCH] Aufzeichnung %s (verworfen: %u)\n", touchRec ? "an" : "aus", touchRing.dropped); }
+#ifdef PV_TRACE
+    if (c=='t') traceDumpSerial();
+#endif
+#ifndef ROLE_POLLER
+    if (c=='s') printRxStats();
+    if (c=='u') printClock();
+#else
+    if (c=='m') printPollStats();
+  #ifdef PV_ELECT
+    if (c=='e') printElect();
+  #endif
+#endif
+  }
+  bootTick();                     // WLAN/NTP/Sync, Markierung "alt", Boot-Cache
 #ifdef ROLE_POLLER
-  static uint32_t lastConnTry=0, lastPollTick=0, lastPollStart=0;
-  const  uint32_t POLL_INTERVAL_MS=30000;
+  static uint32_t lastConnTry=0, lastPollTick=0;
+#ifdef PV_ELECT
+  electTick();                    // Heartbeats, Bewerbung/Übernahme; folgt: Lücken und Verlauf
+#endif
 
-  if(!mb.isConnected(inverterIP)){
-    if(millis()-lastConnTry>2000){
-      mb.connect(inverterIP, modbusPort);
-      lastConnTry=millis();
-    }
-  }else{
-    if (millis()-lastPollTick >= 300){
-      lastPollTick = millis();
-      if (millis()-lastPollStart>=POLL_INTERVAL_MS) { lastPollStart=millis(); startPoll(); }
+  // Verbindungen je Endpunkt halten; nicht verbundene Geräte fallen in der Runde aus,
+  // die anderen werden trotzdem abgefragt (PV_ELECT: nur der aktive Knoten)
+  bool anyConn = false;
+  if (boot.wifiUp && electActive() && millis()-lastConnTry>2000){
+    for (uint8_t p=0; p<poller.nPipe; ++p){
+      const PvDeviceCfg& d = PV_DEVICES[poller.pipe[p].dev[0]];
+      if (!mb.isConnected(devIP(d))){ mb.connect(devIP(d), d.port); lastConnTry=millis(); }
     }
   }
+  for (uint8_t p=0; p<poller.nPipe; ++p) anyConn |= mb.isConnected(devIP(PV_DEVICES[poller.pipe[p].dev[0]]));
+  if (anyConn && millis()-lastPollTick >= POLL_TICK_MS){
+    lastPollTick = millis();
+    if (millis()-pollStartMs>=POLL_INTERVAL_MS && electMayPoll()) { pollStartMs=millis(); startPoll(); }
+  }
   mb.task();
   maybeFinishPoll();
+  if (electActive()){
+    carTick();                    // Verlauf-Karussell: höchstens ein Block je PV_CAR_GAP_MS
+    fillTick();                   // verpasste Frames: Teile aus dem Ring
+  }
 #else
-  // Client: passiv
-  delay(5);
+  carClientTick();                // Verlauf-Karussell: Anfrage bzw. NACK fällig?
+  fillClientTick();               // Lücke in f->seq: beim Poller nachfragen
 #endif
 
+  // Display: Abschluss des letzten Frames (DMA) abholen, ggf. neuen Frame zeichnen
+  flush.poll();
+  if (drawPending){ drawPending = false; drawIfFrame(); }
+
 #ifdef ROLE_POLLER
-  if (haveFrame && pending==0){
+  // erst mit frischen Daten (nicht dem Frame aus dem Boot-Cache) und gültiger Uhr
+  if (boot.live && boot.timeOk && !poller.active && electActive()){   // folgt: Teile des Aktiven
     integrateTick(lastF.pvW, lastF.gridW, lastF.battW);
+    integrateDevices();
     handleDayMonthRollover();
   }
-  handleTouchSwipe();
 #else
-  if (haveFrame){
-    integrateTick(lastF.pvW, lastF.gridW, lastF.battW);
+  if (boot.live && boot.timeOk){
+    if (!fillOn) integrateTick(lastF.pvW, lastF.gridW, lastF.battW);   // sonst Teile vom Poller
     handleDayMonthRollover();
-    handleTouchSwipe();           // Seitenwechsel per Wisch
-  } else {
-    handleTouchSwipe();           // Touch initialisieren
   }
+#endif
+  histTick();                     // Verlauf über TCP: Export/Import stückweise
+  handleTouch();                  // Gesten aus dem Touch-Ring, Seitenwechsel
+  blTick();                       // Backlight nach Tageszeit/Umgebung, nach Berührung voll
+#ifndef ROLE_POLLER
+  sleepTick();                    // statt delay(5): WLAN nach Plan, Pause bis zum nächsten Wecken
 #endif
 }
@@ -0,0 +1,412 @@
+// ===================== tools/pvbatt.cpp =====================
+// Host-Prüfung des Batterie-Schätzers (SolarDisplay/PvBatt.h): SoC-Verläufe Sample für Sample
+// wie im Poller (pvBattUpdate() je Frame, pvBattEtas() fürs Frame) abspielen und die ETAs mit
+// dem Zeitpunkt vergleichen, an dem die Anzeige das Ziel wirklich erreicht. Zum Vergleich die
+// bisherige ETA (nur unter 20 % beim Laden, Dauer der letzten 1 %-Stufe).
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvbatt tools/pvbatt.cpp
+//
+// Aufrufe:
+//   pvbatt selftest [--seed 1]
+//       Anhang (Rundreise, CRC, zu kurz); konstante Leistung Laden/Entladen mit bekannter und
+//       unbekannter Kapazität (Samples bis ETA auf 10 bzw. 5 %), Wirkungsgrad je Richtung, Wechsel,
+//       Ruhe, unter 20 % gegen die bisherige ETA; simulierte Tage: ETA häufiger verfügbar
+//       und Rate genau
+//   pvbatt bench [--days 3] [--cap-wh 10000] [--known 1] [--seed 1]
+//       simulierte Tage (PV mit Wolken, Lastspitzen, Wirkungsgrad, Ladeende-Drosselung):
+//       Verfügbarkeit und Fehler je Ziel neu gegen bisher, Fehler der Rate, ns je Sample
+//   pvbatt replay <datei> [--cap-wh 0]
+//       aufgezeichnete Verläufe: .csv aus sun2000sim --truth (Minutenwerte) oder .pvrec aus
+//       tools/pvrec.cpp (Frames); --cap-wh: Vorwissen wie PvDeviceCfg::battWh (0 = unbekannt)
+#include "../SolarDisplay/PvBatt.h"
+#include "../SolarDisplay/PvRx.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+
+// ---------- Verlauf ----------
+struct Sample { uint32_t ms; int32_t battW; uint16_t socx10; float rate; };   // rate: wahr (%/h x10), NAN = unbekannt
+typedef std::vector<Sample> Curve;
+
+// ---------- Simulation ----------
+// Frames alle 30 s (+ Rundendauer), Physik in 5-s-Schritten; SoC-Anzeige in 0.1 % abgerundet
+struct Plant {
+  double capWh = 10000, effC = 0.95, effD = 0.95;
+  double maxC = 5000, maxD = 5000, minSoc = 5, taper = 90;   // ab taper % Ladeleistung linear bis 10 %
+  double soc = 30;
+};
+
+static Curve simulateDays(const Plant& p0, int days, unsigned seed){
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> N(0, 1);
+  std::uniform_real_distribution<double> U(0, 1);
+  Plant p = p0;
+  Curve c;
+  double cloud = 1, load = 400;
+  uint32_t loadUntil = 0; double loadExtra = 0;
+  const uint32_t end = (uint32_t)days * 86400u;
+  double nextFrame = 0;
+  double batt = 0;
+  for (uint32_t t = 0; t < end; t += 5){
+    const double hr = fmod(t / 3600.0, 24.0);
+    double pv = 0;
+    if (hr > 6 && hr < 20){
+      const double x = (hr - 6) / 14.0;
+      pv = 7000 * pow(sin(M_PI * x), 1.5);
+      cloud += (1 - cloud) * 0.01 + 0.03 * N(rng);
+      cloud = std::max(0.15, std::min(1.0, cloud));
+      pv *= cloud;
+    }
+    if (t >= loadUntil && U(rng) < 5.0 / 720){   // im Mittel alle 1 h eine Lastspitze
+      loadExtra = 500 + 2500 * U(rng); loadUntil = t + 300 + (uint32_t)(1800 * U(rng));
+    }
+    load = 350 + (t < loadUntil ? loadExtra : 0) + 20 * N(rng);
+    const double surplus = pv - load;
+    if (surplus > 0){
+      double lim = p.maxC;
+      if (p.soc > p.taper) lim *= 1 - 0.9 * (p.soc - p.taper) / (100 - p.taper);
+      batt = p.soc < 100 ? std::min(surplus, lim) : 0;
+    } else batt = p.soc > p.minSoc ? std::max(surplus, -p.maxD) : 0;
+    const double h = 5 / 3600.0;
+    p.soc += (batt > 0 ? batt * p.effC : batt / p.effD) * h / p.capWh * 100;
+    p.soc = std::max(0.0, std::min(100.0, p.soc));
+    if (t >= nextFrame){
+      Sample s;
+      s.ms = t * 1000u;
+      s.battW = (int32_t)lround(batt * (1 + 0.01 * N(rng)));
+      s.socx10 = (uint16_t)floor(p.soc * 10 + 1e-9);
+      s.rate = (float)((batt > 0 ? batt * p.effC : batt / p.effD) / p.capWh * 1000);
+      c.push_back(s);
+      nextFrame = t + 30 + 2 * U(rng);
+    }
+  }
+  return c;
+}
+
+// konstante Leistung (Selbsttest)
+static Curve constant(double capWh, double eff, double socStart, double w, int n){
+  Curve c;
+  double soc = socStart;
+  for (int i = 0; i < n; ++i){
+    c.push_back({ (uint32_t)i * 30000u, (int32_t)lround(w), (uint16_t)floor(soc * 10 + 1e-9), NAN });
+    soc += (w > 0 ? w * eff : w / eff) * 30 / 3600.0 / capWh * 100;
+    soc = std::max(0.0, std::min(100.0, soc));
+  }
+  return c;
+}
+
+// ---------- bisher: calculateETA20() ----------
+struct Legacy {
+  int pct = -1; uint32_t stepMs = 0, lastStep = 0; bool haveStep = false;
+  int32_t eta(const Sample& s){
+    const int p = s.socx10 / 10;
+    if (pct >= 0 && p == pct + 1){ if (lastStep){ stepMs = s.ms - lastStep; haveStep = true; } lastStep = s.ms; }
+    else if (p != pct) { lastStep = 0; haveStep = false; }
+    pct = p;
+    if (p >= 20 || s.battW <= 0 || !haveStep) return -1;
+    return (int32_t)((20 - p) * (stepMs / 1000));
+  }
+};
+
+// ---------- Auswertung ----------
+enum { TG_20 = 0, TG_FULL, TG_EMPTY, TG_COUNT };
+static const char* TG_NAME[TG_COUNT] = { "20 %", "voll", "leer" };
+
+struct Err {
+  std::vector<double> rel;        // |ETA - wahr| / wahr
+  uint64_t want = 0, have = 0;    // Ziel erreicht (wahr bekannt) / davon ETA geliefert
+};
+
+struct Eval {
+  Err e[TG_COUNT], legacy20;
+  std::vector<double> rateRel;    // Rate gegen die Steigung der Anzeige über 10 min
+  std::vector<double> rateTrue;   // ... gegen die wahre Rate (nur Simulation)
+  uint64_t samples = 0;
+  double ns = 0;
+};
+
+static double pct(std::vector<double> v, double p){
+  if (v.empty()) return NAN;
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(p * (v.size() - 1) + 0.5)];
+}
+
+// wahre ETA: erstes spätere Sample, an dem die Anzeige das Ziel erreicht (in Richtung 'up')
+static std::vector<int64_t> truthEta(const Curve& c, uint16_t target, bool up){
+  std::vector<int64_t> r(c.size(), -1);
+  int64_t next = -1;
+  for (size_t i = c.size(); i-- > 0;){
+    const bool at = up ? c[i].socx10 >= target : c[i].socx10 <= target;
+    if (at) next = (int64_t)i;
+    const bool before = up ? c[i].socx10 < target : c[i].socx10 > target;
+    if (before && next >= 0) r[i] = (int64_t)(c[(size_t)next].ms - c[i].ms) / 1000;
+  }
+  return r;
+}
+
+static Eval evaluate(const Curve& c, uint32_t capWh, int64_t horizonS = 3 * 3600){
+  Eval ev; ev.samples = c.size();
+  const std::vector<int64_t> up20 = truthEta(c, PV_BATT_LOW_X10, true), dn20 = truthEta(c, PV_BATT_LOW_X10, false);
+  const std::vector<int64_t> full = truthEta(c, PV_BATT_FULL_X10, true), empty = truthEta(c, PV_BATT_EMPTY_X10, false);
+  PvBattEst b; pvBattInit(b, capWh);
+  Legacy lg;
+  auto score = [&](Err& e, int32_t est, int64_t truth){
+    if (truth <= 0 || truth > horizonS) return;
+    e.want++;
+    if (est < 0) return;
+    e.have++;
+    e.rel.push_back(fabs((double)est - (double)truth) / (double)truth);
+  };
+  for (size_t i = 0; i < c.size(); ++i){
+    const Sample& s = c[i];
+    pvBattUpdate(b, s.ms, s.battW, s.socx10);
+    PvBattEta o; pvBattEtas(b, o);
+    const bool ok = o.conf >= PV_BATT_CONF_MIN;
+    const bool chg = s.battW > PV_BATT_DEAD_W, dis = s.battW < -PV_BATT_DEAD_W;
+    if (chg){
+      score(ev.e[TG_20], ok ? o.eta20s : -1, up20[i]);
+      score(ev.e[TG_FULL], ok ? o.fullS : -1, full[i]);
+    }
+    if (dis){
+      score(ev.e[TG_20], ok ? o.eta20s : -1, dn20[i]);
+      score(ev.e[TG_EMPTY], ok ? o.emptyS : -1, empty[i]);
+    }
+    if ((chg || dis) && ok && !std::isnan(s.rate) && fabsf(s.rate) > 1) ev.rateTrue.push_back(fabs(o.ratex10 - s.rate) / fabs(s.rate));
+    const int32_t l = lg.eta(s);
+    if (chg) score(ev.legacy20, l, up20[i]);
+    if (dis) score(ev.legacy20, -1, dn20[i]);   // bisher nie beim Entladen
+    // Rate gegen die Anzeige: Steigung über die nächsten 10 min (mindestens 1 %), gleiche Richtung durchgehend
+    size_t j = i;
+    while (j + 1 < c.size() && c[j + 1].ms - s.ms <= 600000 && ((c[j + 1].battW > PV_BATT_DEAD_W) == chg) && ((c[j + 1].battW < -PV_BATT_DEAD_W) == dis)) j++;
+    if ((chg || dis) && ok && c[j].ms - s.ms >= 540000 && abs((int)c[j].socx10 - (int)s.socx10) >= 10){
+      const double trueRate = ((double)c[j].socx10 - s.socx10) / ((c[j].ms - s.ms) / 3.6e6);   // 0.1 %/h
+      ev.rateRel.push_back(fabs(o.ratex10 - trueRate) / fabs(trueRate));
+    }
+  }
+  // Kosten je Sample (Update + ETAs), Verlauf mehrfach
+  using namespace std::chrono;
+  PvBattEst bb; pvBattInit(bb, capWh);
+  volatile int32_t sink = 0;
+  const int reps = std::max<int>(1, (int)(2000000 / std::max<size_t>(1, c.size())));
+  const auto t0 = steady_clock::now();
+  for (int r = 0; r < reps; ++r)
+    for (const Sample& s : c){
+      pvBattUpdate(bb, s.ms + (uint32_t)r * 0x10000000u, s.battW, s.socx10);
+      PvBattEta o; pvBattEtas(bb, o); sink = sink + o.eta20s;
+    }
+  ev.ns = duration<double, std::nano>(steady_clock::now() - t0).count() / ((double)reps * c.size());
+  return ev;
+}
+
+static void printEval(const Eval& ev){
+  printf("%-18s %9s %9s %9s %9s\n", "Ziel", "erreicht", "mit ETA", "Fehler p50", "p95");
+  auto row = [](const char* n, const Err& e){
+    printf("%-18s %9llu %8.1f%% %9.1f%% %8.1f%%\n", n, (unsigned long long)e.want,
+           e.want ? 100.0 * e.have / e.want : 0.0, 100 * pct(e.rel, 0.5), 100 * pct(e.rel, 0.95));
+  };
+  for (int t = 0; t < TG_COUNT; ++t){ char b[32]; snprintf(b, sizeof(b), "neu: %s", TG_NAME[t]); row(b, ev.e[t]); }
+  row("bisher: 20 %", ev.legacy20);
+  printf("Rate gegen Anzeige (10 min): p50 %.1f %%, p95 %.1f %% (%zu Samples)\n",
+         100 * pct(ev.rateRel, 0.5), 100 * pct(ev.rateRel, 0.95), ev.rateRel.size());
+  if (!ev.rateTrue.empty())
+    printf("Rate gegen wahr:             p50 %.1f %%, p95 %.1f %%\n", 100 * pct(ev.rateTrue, 0.5), 100 * pct(ev.rateTrue, 0.95));
+  printf("%llu Samples, %.1f ns je Sample (Update + ETAs)\n", (unsigned long long)ev.samples, ev.ns);
+}
+
+// ---------- Aufzeichnungen ----------
+// sun2000sim --truth: sim_time,pv_W,load_W,batt_W,grid_W,soc,...
+static bool readCsv(const char* path, Curve& c){
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[512]; uint32_t t = 0;
+  while (fgets(line, sizeof(line), f)){
+    int Y, M, D, h, m, s; double pv, load, batt, grid, soc;
+    if (sscanf(line, "%d-%d-%d %d:%d:%d,%lf,%lf,%lf,%lf,%lf", &Y, &M, &D, &h, &m, &s, &pv, &load, &batt, &grid, &soc) != 11) continue;
+    c.push_back({ t, (int32_t)lround(batt), (uint16_t)lround(soc * 10), NAN });
+    t += 60000;   // Minutenwerte
+  }
+  fclose(f);
+  return !c.empty();
+}
+
+// tools/pvrec.cpp: RecFileHdr | { RecHdr | Paket }* | Index | Footer; nur Frame-Kanal
+static bool readPvrec(const char* path, Curve& c){
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  uint8_t fh[16];
+  if (fread(fh, 1, sizeof(fh), f) != sizeof(fh) || pvWireU16(fh) != 0x5650 || pvWireU16(fh + 2) != 0x4352){ fclose(f); return false; }
+  // Footer (28 Bytes): Daten enden am Index
+  fseek(f, 0, SEEK_END);
+  long end = ftell(f);
+  uint8_t ft[28];
+  if (end >= (long)(16 + sizeof(ft))){
+    fseek(f, end - (long)sizeof(ft), SEEK_SET);
+    if (fread(ft, 1, sizeof(ft), f) == sizeof(ft) && pvWireU16(ft + 24) == 0x5650 && pvWireU16(ft + 26) == 0x5849){
+      uint64_t off = 0; for (int i = 7; i >= 0; --i) off = (off << 8) | ft[i];
+      end = (long)off;
+    }
+  }
+  fseek(f, 16, SEEK_SET);
+  PvRxState rx;
+  uint64_t tUs = 0;
+  uint8_t h[7], pkt[1500];
+  while (ftell(f) + 7 <= end && fread(h, 1, 7, f) == 7){
+    const uint32_t dt = (uint32_t)h[0] | (uint32_t)h[1] << 8 | (uint32_t)h[2] << 16 | (uint32_t)h[3] << 24;
+    const uint16_t len = pvWireU16(h + 5);
+    if (len > sizeof(pkt) || fread(pkt, 1, len, f) != len) break;
+    tUs += dt;
+    if (h[4] != 0) continue;   // CH_FRAME
+    PvFrameV4 fr;
+    if (!pvRxAccepted(pvRxFrame(rx, pkt, len, 1, (uint32_t)(tUs / 1000), fr))) continue;
+    c.push_back({ (uint32_t)(tUs / 1000), fr.battW, fr.socx10, NAN });
+  }
+  fclose(f);
+  return !c.empty();
+}
+
+// ---------- Selbsttest ----------
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  if (!ok) fails++;
+}
+
+// Samples bis die ETA (Ziel tg) dauerhaft auf 'tol' genau ist (mindestens 1 min: Stufe der
+// Anzeige kurz vor dem Ziel); -1 = nie
+static int settle(const Curve& c, uint32_t capWh, int tg, double tol, bool legacy = false){
+  const bool up = c[0].battW > 0;
+  const uint16_t target = tg == TG_20 ? PV_BATT_LOW_X10 : tg == TG_FULL ? PV_BATT_FULL_X10 : PV_BATT_EMPTY_X10;
+  const std::vector<int64_t> tr = truthEta(c, target, up);
+  PvBattEst b; pvBattInit(b, capWh);
+  Legacy lg;
+  int first = -1;
+  for (size_t i = 0; i < c.size() && tr[i] > 300; ++i){   // bis 5 min vor dem Ziel
+    pvBattUpdate(b, c[i].ms, c[i].battW, c[i].socx10);
+    PvBattEta o; pvBattEtas(b, o);
+    const int32_t est = legacy ? lg.eta(c[i]) : o.conf < PV_BATT_CONF_MIN ? -1 : tg == TG_20 ? o.eta20s : tg == TG_FULL ? o.fullS : o.emptyS;
+    const bool good = est >= 0 && fabs((double)est - tr[i]) <= std::max(tol * tr[i], 60.0);
+    if (!good) first = -1;
+    else if (first < 0) first = (int)i + 1;
+  }
+  return first;
+}
+
+static int cmdSelftest(unsigned seed){
+  // --- Anhang ---
+  {
+    PvBattEta e; e.eta20s = 3600; e.fullS = 7200; e.emptyS = -1; e.ratex10 = 123; e.conf = 87; e.dir = PVB_CHG;
+    uint8_t p[PV_BATT_WIRE + 4] = {};
+    const size_t n = pvBattSeal(p + 4, e);
+    PvBattEta g;
+    bool ok = n == PV_BATT_WIRE && pvBattGet(p, sizeof(p), 4, g);
+    ok &= g.eta20s == 3600 && g.fullS == 7200 && g.emptyS == -1 && g.ratex10 == 123 && g.conf == 87 && g.dir == PVB_CHG;
+    ok &= !pvBattGet(p, sizeof(p) - 1, 4, g) && !pvBattGet(p, sizeof(p), 0, g);
+    p[10] ^= 1;
+    ok &= !pvBattGet(p, sizeof(p), 4, g);
+    check(ok, "Anhang: Rundreise, zu kurz, falscher Offset, CRC");
+  }
+  char b[128];
+  // --- konstante Leistung ---
+  {
+    const Curve c = constant(10000, 0.95, 30, 2000, 600);
+    const int known = settle(c, 10000, TG_FULL, 0.10), unknown = settle(c, 0, TG_FULL, 0.05);
+    snprintf(b, sizeof(b), "Laden 2 kW -> voll: auf 10 %% nach %d (Kapazität bekannt), 5 %% nach %d", known, unknown);
+    check(known >= 1 && known <= 2 && unknown >= 1 && unknown <= 20, b);
+  }
+  {
+    const Curve c = constant(13500, 0.93, 80, -1200, 1200);   // Kapazität falsch angegeben
+    const int e20 = settle(c, 10000, TG_20, 0.05), ee = settle(c, 10000, TG_EMPTY, 0.05);
+    snprintf(b, sizeof(b), "Entladen 1.2 kW, 13.5 kWh (Vorwissen 10): 20 %% nach %d, leer nach %d", e20, ee);
+    check(e20 >= 1 && e20 <= 25 && ee >= 1 && ee <= 25, b);
+  }
+  {
+    const Curve c = constant(10000, 0.95, 12, 1500, 200);
+    const int n = settle(c, 10000, TG_20, 0.10), l = settle(c, 10000, TG_20, 0.10, true);
+    snprintf(b, sizeof(b), "unter 20 %% laden 1.5 kW: auf 10 %% nach %d Samples (bisher: %d)", n, l);
+    check(n >= 1 && n <= 10 && (l < 0 || l > n), b);
+  }
+  // --- Wirkungsgrad je Richtung, Wechsel, Ruhe ---
+  {
+    PvBattEst e; pvBattInit(e, 0);
+    Curve c = constant(10000, 0.90, 40, 2500, 120), d = constant(10000, 0.90, c.back().socx10 / 10.0, -2500, 120);
+    for (auto& s : c) pvBattUpdate(e, s.ms, s.battW, s.socx10);
+    PvBattEta o; pvBattEtas(e, o);
+    bool ok = o.dir == PVB_CHG && o.fullS > 0 && o.emptyS < 0;
+    const uint32_t t0 = c.back().ms + 30000;
+    pvBattUpdate(e, t0, d[0].battW, d[0].socx10);
+    pvBattEtas(e, o);
+    ok &= o.dir == PVB_DIS && o.fullS < 0 && o.emptyS > 0 && o.ratex10 < 0;   // sofort nach dem Wechsel
+    for (auto& s : d) pvBattUpdate(e, t0 + 30000 + s.ms, s.battW, s.socx10);
+    const double kc = e.k[PVB_CHG] / 0.1, kd = e.k[PVB_DIS] / 0.1;   // wahr: 0.90 und 1/0.90
+    ok &= fabs(kc - 0.90) < 0.03 && fabs(kd - 1 / 0.90) < 0.04;
+    pvBattUpdate(e, t0 + 30000 + d.back().ms + 30000, 10, d.back().socx10);
+    pvBattEtas(e, o);
+    ok &= o.dir == PVB_IDLE && o.eta20s < 0 && o.fullS < 0 && o.emptyS < 0 && o.conf == 0;
+    snprintf(b, sizeof(b), "Wirkungsgrad je Richtung (%.3f / %.3f), Wechsel sofort, Ruhe ohne ETA", kc, kd);
+    check(ok, b);
+  }
+  // --- simulierte Tage ---
+  {
+    Plant p; p.capWh = 10000; p.soc = 15;
+    const Eval ev = evaluate(simulateDays(p, 3, seed), 10000);
+    const Err& n20 = ev.e[TG_20];
+    const double avN = n20.want ? (double)n20.have / n20.want : 0, avL = ev.legacy20.want ? (double)ev.legacy20.have / ev.legacy20.want : 0;
+    snprintf(b, sizeof(b), "3 Tage: ETA 20 %% verfügbar %.0f %% (bisher %.0f %%), Rate p50 %.1f %%", 100 * avN, 100 * avL, 100 * pct(ev.rateTrue, 0.5));
+    check(avN > 0.85 && avN > avL && pct(ev.rateTrue, 0.5) < 0.10, b);
+    snprintf(b, sizeof(b), "3 Tage: voll/leer verfügbar %.0f/%.0f %%, %.0f ns je Sample",
+             ev.e[TG_FULL].want ? 100.0 * ev.e[TG_FULL].have / ev.e[TG_FULL].want : 0,
+             ev.e[TG_EMPTY].want ? 100.0 * ev.e[TG_EMPTY].have / ev.e[TG_EMPTY].want : 0, ev.ns);
+    check(ev.e[TG_FULL].have * 100 >= ev.e[TG_FULL].want * 85 && ev.e[TG_EMPTY].have * 100 >= ev.e[TG_EMPTY].want * 85, b);
+  }
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvbatt selftest [--seed N] | bench [--days N] [--cap-wh W] [--known 0|1] [--seed N] | replay <datei.csv|.pvrec> [--cap-wh W]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  int i = 2;
+  std::string file;
+  if (cmd == "replay"){ if (argc < 3) return usage(); file = argv[2]; i = 3; }
+  int days = 3; double capWh = cmd == "replay" ? 0 : 10000; int known = 1; unsigned seed = 1;
+  for (; i < argc; ++i){
+    std::string k = argv[i];
+    if (i + 1 >= argc) return usage();
+    const double v = atof(argv[++i]);
+    if      (k == "--days")   days = (int)v;
+    else if (k == "--cap-wh") capWh = v;
+    else if (k == "--known")  known = (int)v;
+    else if (k == "--seed")   seed = (unsigned)v;
+    else return usage();
+  }
+  if (cmd == "selftest") return cmdSelftest(seed);
+  if (cmd == "bench"){
+    Plant p; p.capWh = capWh; p.soc = 15;
+    const Curve c = simulateDays(p, days, seed);
+    printf("%d Tage simuliert, %.1f kWh, Vorwissen %s, Frames alle 30 s\n\n", days, capWh / 1000, known ? "Kapazität" : "keins");
+    printEval(evaluate(c, known ? (uint32_t)capWh : 0));
+    return 0;
+  }
+  if (cmd == "replay"){
+    Curve c;
+    const bool rec = file.size() > 6 && file.compare(file.size() - 6, 6, ".pvrec") == 0;
+    if (!(rec ? readPvrec(file.c_str(), c) : readCsv(file.c_str(), c))){ fprintf(stderr, "%s: nicht lesbar\n", file.c_str()); return 1; }
+    printf("%s: %zu Samples über %.1f h\n\n", file.c_str(), c.size(), (c.back().ms - c.front().ms) / 3.6e6);
+    printEval(evaluate(c, (uint32_t)capWh));
+    return 0;
+  }
+  return usage();
+}
@@ -0,0 +1,399 @@
+// ===================== tools/pvboot.cpp =====================
+// Host-Simulation des Starts (SolarDisplay/PvBoot.h): Zeit bis zum ersten Bild, bis zu frischen
+// Daten und bis zum fertigen Stats-Sync, alter blockierender Ablauf gegen den Zustandsautomaten.
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvboot tools/pvboot.cpp
+//
+// Aufrufe:
+//   pvboot bench [--runs 500] [--seed 1] [--rec-ms 2.3]
+//       Monte-Carlo je Szenario (Stromausfall, Software-Reset, Erststart, WLAN hängt, Poller später),
+//       p50/p95 bis erstes Bild, gültige Uhr, frische Daten und Sync. Der neue Ablauf läuft mit dem echten pvBootStep() im 5-ms-Takt
+//       von loop(); der alte ist setup() vor PvBoot.h (WLAN-Schleife, delay(300), ein Discover).
+//   pvboot selftest
+//       Boot-Cache (Siegel, Beschädigung, Version), Restore-Plan, Zustandsautomat (WLAN-Backoff,
+//       Discover-Backoff/Timeout, NTP nur ohne Poller-Zeit, frisch/alt)
+//
+// Modell (ms ab setup(), typische bzw. angenommene Werte, s. struct Sim):
+//   TFT-Init ~125, Cache lesen NVS ~6 / RTC 0, ganze Seite ~50, WLAN 1.2 s + exp(1.5 s),
+//   NTP 150 + exp(400) (5 % verloren -> SNTP-Neuversuch nach 15 s), Modbus-Runde 1-2 s,
+//   Poller-Takt 30 s, Sync = (Tage + Monate seit 1970) x rec-ms.
+//   "WLAN hängt": erster Verbindungsversuch kommt nie an; alt hilft nur der Treiber
+//   (Auth-Timeout + Auto-Reconnect, angenommen 30 s), neu PVBA_WIFI_RETRY nach 10 s.
+#include "../SolarDisplay/PvBoot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+static const uint32_t NEVER = 0xFFFFFFFFu;
+static const uint32_t HORIZON_MS = 300000;
+static const uint32_t LOOP_MS = 5;            // delay(5) in loop()
+static const uint32_t POLL_MS = 30000;        // POLL_INTERVAL_MS
+static const uint32_t NET_MS  = 5;            // UDP im LAN
+
+struct Scenario {
+  const char* name;
+  bool     nvsCache;      // Boot-Cache im NVS (Stromausfall)
+  bool     rtc;           // Software-Reset: RTC-Cache + Uhr laufen weiter
+  bool     pollerBoots;   // Poller startet gleichzeitig neu (sonst läuft er schon)
+  float    wifiHang;      // Wahrscheinlichkeit: erster WLAN-Versuch hängt
+  uint32_t pollerLate;    // Poller kommt so viel später (Poller war aus)
+};
+
+static const Scenario SCEN[] = {
+  { "Stromausfall",    true,  false, true,  0.0f, 0     },
+  { "Software-Reset",  true,  true,  false, 0.0f, 0     },
+  { "Erststart",       false, false, true,  0.0f, 0     },
+  { "WLAN hängt",      true,  false, false, 1.0f, 0     },
+  { "Poller später",   true,  false, true,  0.0f, 20000 },
+};
+
+// Ergebnis eines Laufs (ms ab setup() des Clients, NEVER = nicht im Horizont)
+struct Times { uint32_t pixel = NEVER, clock = NEVER, live = NEVER, sync = NEVER; };
+
+struct Sim {
+  std::mt19937 rng;
+  double recMs = 2.3;
+
+  double uni(double a, double b){ return std::uniform_real_distribution<double>(a, b)(rng); }
+  double expo(double mean){ return std::exponential_distribution<double>(1.0 / mean)(rng); }
+  bool   chance(double p){ return uni(0, 1) < p; }
+
+  uint32_t tftInit(){ return (uint32_t)uni(110, 140); }
+  uint32_t drawPage(){ return (uint32_t)uni(40, 60); }
+  uint32_t wifi(){ return (uint32_t)(1200 + expo(1500)); }
+  uint32_t ntp(){ return (uint32_t)(150 + expo(400)) + (chance(0.05) ? 15000 : 0); }
+  uint32_t mbRound(){ return (uint32_t)uni(1000, 2000); }
+  uint32_t syncMs(){
+    const double recs = 20740 + 682;   // Tage + Monate 1970..2026
+    return (uint32_t)(recs * recMs);
+  }
+
+  // Poller aus Sicht des Clients: Server bereit ab, eigene Uhr gestellt ab (NTP),
+  // erster Frame, danach alle POLL_MS
+  struct Poller { uint32_t server, clock, frame0; };
+
+  Poller pollerOld(const Scenario& s, Times& pt){
+    if (!s.pollerBoots){ uint32_t ph = (uint32_t)uni(0, POLL_MS); pt = {0, 0, ph, NEVER}; return { 0, 0, ph }; }
+    uint32_t w = s.pollerLate + tftInit() + 3 + wifi();
+    uint32_t t = w + 300 + 10;                                       // WLAN-Schleife, delay(300), NVS
+    uint32_t srv = t + 2;
+    uint32_t f0 = t + 100 + mbRound();
+    pt = { srv + 5, w + ntp(), f0, NEVER };                          // "Poller bereit…" nach setup()
+    return { srv, pt.clock, f0 };
+  }
+
+  Poller pollerNew(const Scenario& s, Times& pt){
+    if (!s.pollerBoots){ uint32_t ph = (uint32_t)uni(0, POLL_MS); pt = {0, 0, ph, NEVER}; return { 0, 0, ph }; }
+    uint32_t t0 = s.pollerLate;
+    uint32_t pix = t0 + tftInit() + (s.nvsCache ? 6 + drawPage() : 5);
+    uint32_t up = pix + 3 + wifi();
+    uint32_t srv = up + LOOP_MS;                                     // NET_UP im nächsten loop()
+    uint32_t f0 = srv + 100 + mbRound();
+    pt = { pix, up + ntp(), f0, NEVER };
+    return { srv, pt.clock, f0 };
+  }
+
+  static uint32_t nextFrame(const Poller& p, uint32_t t){
+    if (t <= p.frame0) return p.frame0;
+    return p.frame0 + ((t - p.frame0 + POLL_MS - 1) / POLL_MS) * POLL_MS;
+  }
+
+  // alter Client: setup() blockiert bis WLAN, danach ein einziges Discover; Uhr per NTP
+  Times clientOld(const Scenario& s, const Poller& p){
+    Times r;
+    uint32_t t = tftInit() + 3;
+    uint32_t w = s.wifiHang > 0 && chance(s.wifiHang) ? 30000 + wifi() : wifi();
+    r.clock = s.rtc ? 0 : t + w + ntp();
+    t += (w + 299) / 300 * 300;                                      // while(...) delay(300)
+    t += 300 + 10 + 2;                                               // delay(300), NVS, listen
+    r.pixel = t + 5;                                                 // "Warte auf PV-Daten…"
+    r.live = nextFrame(p, t);
+    if (p.server <= t) r.sync = t + 2 * NET_MS + syncMs();           // sonst: Discover verloren
+    return r;
+  }
+
+  // neuer Client: setup() zeichnet sofort, danach treibt pvBootStep() alles aus loop();
+  // Uhr aus Offer/Frames, sobald der Poller seine hat, sonst NTP nach PV_CLK_NTP_MS
+  Times clientNew(const Scenario& s, const Poller& p, PvBoot& b){
+    Times r;
+    b = PvBoot(); b.discover = true; b.ntpFallback = true;
+    uint32_t t = tftInit() + (s.rtc ? 0 : 6) + (s.nvsCache ? drawPage() : 5);
+    b.log.mark(PVB_CACHE, t); b.log.mark(PVB_PIXEL, t);
+    r.pixel = t;
+    t += 3;                                                          // Touch
+
+    bool hang = s.wifiHang > 0 && chance(s.wifiHang);
+    uint32_t wifiAt = hang ? NEVER : t + wifi();
+    uint32_t timeAt = s.rtc ? 0 : NEVER;
+    uint32_t offerMs = 0, doneAt = NEVER, liveMs = 0;
+    bool synced = false, pollerClock = false;
+    b.wifiT0 = t;
+
+    for (uint32_t now = t; now < HORIZON_MS; now += LOOP_MS){
+      bool up = now >= wifiAt;
+      if (b.netStarted && up){
+        uint32_t f = nextFrame(p, b.log.ms[PVB_NET]);
+        while (f + POLL_MS <= now) f += POLL_MS;
+        if (f <= now){
+          liveMs = f;
+          if (f >= p.clock){ pollerClock = true; timeAt = std::min(timeAt, f); }
+        }
+        // Poller wiederholt den letzten Frame, sobald seine Uhr steht (PVBA_TIME_OK)
+        if (p.frame0 <= p.clock && p.clock <= now && b.log.ms[PVB_NET] <= p.clock){
+          pollerClock = true; timeAt = std::min(timeAt, p.clock);
+        }
+      }
+      if (now >= doneAt){ synced = true; doneAt = NEVER; }
+
+      PvBootIn in{ up, now >= timeAt, offerMs, synced, liveMs, pollerClock };
+      uint16_t a = pvBootStep(b, now, in);
+      if (a & PVBA_WIFI_RETRY) wifiAt = now + wifi();
+      if ((a & PVBA_DISCOVER) && p.server <= now && !offerMs){
+        offerMs = now + 2 * NET_MS;
+        doneAt = offerMs + NET_MS + syncMs();
+        if (offerMs >= p.clock){ pollerClock = true; timeAt = std::min(timeAt, offerMs); }
+      }
+      if (a & PVBA_NTP_START) timeAt = std::min(timeAt, now + ntp());
+      if (b.log.reached(PVB_LIVE) && b.log.reached(PVB_SYNC) && b.log.reached(PVB_TIME)) break;
+    }
+    r.clock = s.rtc ? 0 : b.log.reached(PVB_TIME) ? b.log.ms[PVB_TIME] : NEVER;
+    if (b.log.reached(PVB_LIVE)) r.live = b.log.ms[PVB_LIVE];
+    if (b.log.reached(PVB_SYNC)) r.sync = b.log.ms[PVB_SYNC];
+    return r;
+  }
+};
+
+// ---------- bench ----------
+static uint32_t pct(std::vector<uint32_t> v, double p){
+  if (v.empty()) return NEVER;
+  std::sort(v.begin(), v.end());
+  size_t i = (size_t)(p * (v.size() - 1) + 0.5);
+  return v[i];
+}
+
+static std::string fmtS(uint32_t ms){
+  if (ms == NEVER) return "nie";
+  char b[24]; snprintf(b, sizeof(b), "%.2f", ms / 1000.0);
+  return b;
+}
+
+struct Col { std::vector<uint32_t> v; };
+
+enum { C_PIXEL, C_CLOCK, C_LIVE, C_SYNC, C_N };
+
+static void push(Col c[C_N], const Times& t, bool sync){
+  c[C_PIXEL].v.push_back(t.pixel); c[C_CLOCK].v.push_back(t.clock); c[C_LIVE].v.push_back(t.live);
+  if (sync) c[C_SYNC].v.push_back(t.sync);
+}
+
+static void printRow(const char* scen, const char* role, const char* var, const Col c[C_N], unsigned runs){
+  printf("%-16s %-7s %-5s", scen, role, var);
+  for (int k = 0; k < C_N; ++k){
+    if (c[k].v.empty()){ printf(" | %17s", "-"); continue; }
+    std::string a = fmtS(pct(c[k].v, 0.5)), b = fmtS(pct(c[k].v, 0.95));
+    printf(" | %8s %8s", a.c_str(), b.c_str());
+  }
+  size_t never = 0;
+  for (uint32_t x : c[C_SYNC].v) never += x == NEVER;
+  if (!c[C_SYNC].v.empty()) printf(" | %5.1f %%", 100.0 * never / runs);
+  printf("\n");
+}
+
+static int cmdBench(unsigned runs, unsigned seed, double recMs){
+  Sim sim; sim.rng.seed(seed); sim.recMs = recMs;
+  printf("%u Läufe je Szenario, Zeiten in s ab setup() (p50 p95), Sync = %.1f s Stream\n",
+         runs, sim.syncMs() / 1000.0);
+  printf("%-16s %-7s %-5s | %17s | %17s | %17s | %17s | %s\n", "Szenario", "Rolle", "Ablauf",
+         "erstes Bild", "Uhr", "frische Daten", "Stats-Sync", "ohne Sync");
+  for (const Scenario& s : SCEN){
+    Col cOld[C_N], cNew[C_N], pOld[C_N], pNew[C_N];
+    for (unsigned i = 0; i < runs; ++i){
+      Times pt;
+      Sim::Poller po = sim.pollerOld(s, pt);
+      Times to = sim.clientOld(s, po);
+      if (s.pollerBoots) push(pOld, pt, false);
+      Sim::Poller pn = sim.pollerNew(s, pt);
+      PvBoot b;
+      Times tn = sim.clientNew(s, pn, b);
+      if (s.pollerBoots) push(pNew, pt, false);
+      push(cOld, to, true);
+      push(cNew, tn, true);
+    }
+    printRow(s.name, "Client", "alt", cOld, runs);
+    printRow("",     "Client", "neu", cNew, runs);
+    if (s.pollerBoots){
+      printRow("", "Poller", "alt", pOld, runs);
+      printRow("", "Poller", "neu", pNew, runs);
+    }
+  }
+  printf("erstes Bild: alt = Wartetext nach setup(), neu = Cache-Seite (\"alt\" markiert) bzw. Wartetext\n");
+  printf("Uhr: alt = NTP je Gerät, neu Client = Zeit-Anhang in Offer/Frame (PvClock.h), NTP nur ohne Poller\n");
+  return 0;
+}
+
+// ---------- selftest ----------
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-62s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+static uint16_t stepUntil(PvBoot& b, uint32_t& now, uint32_t until, const PvBootIn& in, uint16_t want, uint32_t* at = nullptr){
+  uint16_t all = 0;
+  for (; now <= until; now += LOOP_MS){
+    uint16_t a = pvBootStep(b, now, in);
+    all |= a;
+    if (a & want){ if (at) *at = now; now += LOOP_MS; return all; }
+  }
+  return all;
+}
+
+static int cmdSelftest(){
+  // Cache
+  PvBootCache c{};
+  c.page = 3; c.ymd = 20260510; c.savedTs = 1778400000;
+  c.f.magic = PV_MAGIC; c.f.pvW = 4200;
+  c.day.e[PVE_GEN] = 12345;
+  pvBootCacheSeal(c);
+  check(pvBootCacheValid(c), "Cache: versiegelt -> gültig");
+  PvBootCache x = c; ((uint8_t*)&x)[offsetof(PvBootCache, day) + 1] ^= 0x10;
+  check(!pvBootCacheValid(x), "Cache: ein Bit im Tagesakku gekippt -> ungültig");
+  x = c; x.version = PV_BOOT_VERSION + 1; x.crc = crc16_modbus((const uint8_t*)&x, offsetof(PvBootCache, crc));
+  check(!pvBootCacheValid(x), "Cache: andere Version (CRC stimmt) -> ungültig");
+  x = c; x.f.magic = 0; pvBootCacheSeal(x);
+  check(!pvBootCacheValid(x), "Cache: Frame ohne PV_MAGIC -> ungültig");
+  PvBootCache z; memset(&z, 0xA5, sizeof(z));
+  check(!pvBootCacheValid(z), "Cache: RTC-Speicher nach Einschalten (Muster) -> ungültig");
+
+  // Restore-Plan
+  check(pvBootRestorePlan(20260510, 20260510) == (PVBR_DAY | PVBR_MONTH), "Plan: gleicher Tag -> Tag + Monat übernehmen");
+  check(pvBootRestorePlan(20260509, 20260510) == (PVBR_SAVE_DAY | PVBR_MONTH), "Plan: Vortag -> Tag sichern, Monat übernehmen");
+  check(pvBootRestorePlan(20260430, 20260501) == (PVBR_SAVE_DAY | PVBR_SAVE_MONTH), "Plan: Vormonat -> Tag + Monat sichern");
+  check(pvBootRestorePlan(20251231, 20260101) == (PVBR_SAVE_DAY | PVBR_SAVE_MONTH), "Plan: Jahreswechsel -> Tag + Monat sichern");
+  check(pvBootRestorePlan(20260511, 20260510) == 0, "Plan: Cache aus der Zukunft -> verwerfen");
+  check(pvBootRestorePlan(0, 20260510) == 0, "Plan: Cache ohne Datum -> verwerfen");
+
+  // WLAN-Backoff: 10, 20, 40, 60, 60 s
+  PvBoot b; uint32_t now = 1000; b.wifiT0 = now;
+  PvBootIn in{};
+  uint32_t at[5] = {}, prev = now; bool gapsOk = true;
+  const uint32_t want[5] = { 10000, 20000, 40000, 60000, 60000 };
+  for (int i = 0; i < 5; ++i){
+    stepUntil(b, now, prev + 70000, in, PVBA_WIFI_RETRY, &at[i]);
+    gapsOk &= at[i] - prev == want[i];
+    prev = at[i];
+  }
+  check(gapsOk && b.wifiRetries == 5, "WLAN: Neuversuch nach 10/20/40/60/60 s");
+
+  // verbunden: NET_UP genau einmal, Uhr danach
+  in.wifiUp = true;
+  uint16_t a = pvBootStep(b, now, in); now += LOOP_MS;
+  uint16_t a2 = pvBootStep(b, now, in); now += LOOP_MS;
+  check((a & PVBA_NET_UP) && !(a2 & PVBA_NET_UP) && b.log.reached(PVB_WIFI) && b.log.reached(PVB_NET),
+        "WLAN: verbunden -> NET_UP einmal, Phasen wlan/netz");
+  in.timeOk = true;
+  a = pvBootStep(b, now, in); now += LOOP_MS;
+  a2 = pvBootStep(b, now, in); now += LOOP_MS;
+  check((a & PVBA_TIME_OK) && !(a2 & PVBA_TIME_OK), "Uhr: gültig -> TIME_OK einmal");
+  check(!(a & PVBA_DISCOVER), "Poller-Rolle (discover=false): kein Discover");
+
+  // Discover-Backoff beim Client: sofort, dann 2, 4, 8, 16, 30, 30 s
+  PvBoot cl; cl.discover = true; now = 5000;
+  PvBootIn ci{ true, true, 0, false, 0 };
+  uint32_t dAt[7]; prev = 0; gapsOk = true;
+  const uint32_t dWant[7] = { 0, 2000, 4000, 8000, 16000, 30000, 30000 };
+  for (int i = 0; i < 7; ++i){
+    stepUntil(cl, now, now + 40000, ci, PVBA_DISCOVER, &dAt[i]);
+    if (i) gapsOk &= dAt[i] - prev == dWant[i];
+    prev = dAt[i];
+  }
+  check(gapsOk && dAt[0] == 5000, "Discover: sofort nach NET_UP, dann 2/4/8/16/30/30 s");
+
+  // Offer: Ruhe bis PV_SYNC_TIMEOUT_MS, danach wieder suchen
+  ci.offerMs = now;
+  uint32_t again = 0;
+  uint16_t seen = stepUntil(cl, now, ci.offerMs + PV_SYNC_TIMEOUT_MS + 40000, ci, PVBA_DISCOVER, &again);
+  check((seen & PVBA_DISCOVER) && again - ci.offerMs >= PV_SYNC_TIMEOUT_MS && cl.log.reached(PVB_OFFER),
+        "Offer ohne Abschluss: Discover erst nach Sync-Timeout");
+  ci.offerMs = now + 2;   // Offer aus dem UDP-Task minimal neuer als now
+  seen = stepUntil(cl, now, now + 10000, ci, PVBA_DISCOVER);
+  check(!(seen & PVBA_DISCOVER), "Offer minimal neuer als now: kein Discover (vorzeichenbehaftet)");
+  ci.synced = true;
+  seen = stepUntil(cl, now, now + PV_SYNC_TIMEOUT_MS + 40000, ci, PVBA_DISCOVER);
+  check(!(seen & PVBA_DISCOVER) && cl.log.reached(PVB_SYNC), "Sync fertig: kein Discover mehr");
+
+  // Uhr: NTP nur ohne Poller-Zeit
+  {
+    PvBoot n; n.ntpFallback = true; now = 2000;
+    PvBootIn ni{ true, false, 0, true, 0, false };
+    uint32_t startAt = 0;
+    pvBootStep(n, now, ni); now += LOOP_MS;   // NET_UP bei 2000
+    seen = stepUntil(n, now, 2000 + PV_CLK_NTP_MS + 1000, ni, PVBA_NTP_START, &startAt);
+    check((seen & PVBA_NTP_START) && startAt - 2000 == PV_CLK_NTP_MS && n.ntpOn,
+          "Client ohne Poller-Zeit: NTP nach PV_CLK_NTP_MS");
+    ni.pollerClock = true;
+    a = pvBootStep(n, now, ni); now += LOOP_MS;
+    check((a & PVBA_NTP_STOP) && !n.ntpOn, "Poller-Zeit da: NTP aus");
+    seen = stepUntil(n, now, now + 3 * PV_CLK_NTP_MS, ni, PVBA_NTP_START);
+    check(!(seen & PVBA_NTP_START), "mit Poller-Zeit: kein NTP");
+    ni.pollerClock = false; uint32_t lost = now;
+    seen = stepUntil(n, now, now + PV_CLK_NTP_MS + 1000, ni, PVBA_NTP_START, &startAt);
+    check((seen & PVBA_NTP_START) && startAt - lost >= PV_CLK_NTP_MS - LOOP_MS && n.ntpStarts == 2,
+          "Poller-Zeit weg: NTP wieder nach PV_CLK_NTP_MS");
+    PvBoot pl; pl.ntpFallback = false;
+    seen = stepUntil(pl, now, now + 2 * PV_CLK_NTP_MS, ni, PVBA_NTP_START | PVBA_NTP_STOP);
+    check(!(seen & (PVBA_NTP_START | PVBA_NTP_STOP)), "Poller (ohne ntpFallback): NTP bleibt beim Sketch");
+  }
+
+  // frisch/alt
+  PvBoot s; now = 1000;
+  PvBootIn si{ true, true, 0, true, 0 };
+  a = pvBootStep(s, now, si);
+  check(s.stale && !(a & (PVBA_LIVE | PVBA_REDRAW)), "ohne Frame: bleibt alt, kein Redraw");
+  now = 3000; si.liveMs = now + 1;   // Frame aus dem Empfangs-Task, minimal neuer als now
+  a = pvBootStep(s, now, si);
+  check((a & PVBA_LIVE) && (a & PVBA_REDRAW) && !s.stale, "erster Frame: LIVE + Redraw (frisch)");
+  now = si.liveMs + PV_STALE_MS - 5;
+  a = pvBootStep(s, now, si);
+  check(!(a & PVBA_REDRAW) && !s.stale, "knapp unter PV_STALE_MS: frisch, kein Redraw");
+  now = si.liveMs + PV_STALE_MS;
+  a = pvBootStep(s, now, si);
+  check((a & PVBA_REDRAW) && s.stale && !(a & PVBA_LIVE), "PV_STALE_MS ohne Frame: Redraw (alt), LIVE nur einmal");
+  si.liveMs = now + 100; now += 200;
+  a = pvBootStep(s, now, si);
+  check((a & PVBA_REDRAW) && !s.stale, "neuer Frame: wieder frisch");
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvboot bench [--runs N] [--seed S] [--rec-ms X] | selftest\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  if (cmd == "selftest") return cmdSelftest();
+  if (cmd == "bench"){
+    unsigned runs = 500, seed = 1; double recMs = 2.3;
+    for (int i = 2; i + 1 < argc; i += 2){
+      std::string k = argv[i];
+      if (k == "--runs") runs = (unsigned)atoi(argv[i + 1]);
+      else if (k == "--seed") seed = (unsigned)atoi(argv[i + 1]);
+      else if (k == "--rec-ms") recMs = atof(argv[i + 1]);
+      else return usage();
+    }
+    if (!runs) return usage();
+    return cmdBench(runs, seed, recMs);
+  }
+  return usage();
+}
@@ -0,0 +1,162 @@
+// ===================== tools/pvcal.cpp =====================
+// Host-Prüfung des Kalender-/Tarif-Caches (SolarDisplay/PvCalendar.h)
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvcal tools/pvcal.cpp
+//
+// Aufrufe:
+//   pvcal verify [seed]   2 Jahre (2024-2025) mit Zufallsschritten, 1-s-Schritten um DST-Umstellungen,
+//                         Jahreswechseln und Tarifgrenzen sowie Zeit-Rücksprüngen; Vergleich je Schritt
+//                         mit localtime_r()-Referenz (Datum, Wochentag, Uhrzeit, Tarif, Feiertag, Preis)
+//   pvcal bench [n]       ns je Tick: Cache vs. localtime_r() wie im alten isT1_now()
+//
+// Tarifplan: tools/pvcal_tarif.h (mehrere Perioden, Samstag, Feiertage, Preiswechsel).
+// Zeitzone: TZ_EU_ZURICH wie im Sketch.
+#define PV_TARIFF_CUSTOM "../tools/pvcal_tarif.h"
+#include "../SolarDisplay/PvCalendar.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <random>
+#include <chrono>
+
+static const char* TZ_EU_ZURICH = "CET-1CEST,M3.5.0/2,M10.5.0/3";
+
+// ---------- Referenz: alles direkt aus localtime_r() ----------
+struct Ref { uint32_t ymd; int wday, hh, mm; bool holiday; uint8_t tariff; float t1; };
+
+static Ref reference(time_t t){
+  struct tm lt; localtime_r(&t, &lt);
+  Ref r;
+  r.ymd = (uint32_t)((lt.tm_year + 1900) * 10000 + (lt.tm_mon + 1) * 100 + lt.tm_mday);
+  r.wday = lt.tm_wday; r.hh = lt.tm_hour; r.mm = lt.tm_min;
+  r.holiday = false;
+  for (size_t i = 0; PV_HOLIDAYS[i]; ++i)
+    if (PV_HOLIDAYS[i] == r.ymd || PV_HOLIDAYS[i] == r.ymd % 10000) r.holiday = true;
+  int minute = lt.tm_hour * 60 + lt.tm_min;
+  r.tariff = PV_TARIFF_DEFAULT;
+  for (const PvTariffPeriod& p : PV_TARIFF_PERIODS){
+    bool day = r.holiday ? (p.days & PV_FEIERTAG) : (p.days & (1u << lt.tm_wday));
+    if (day && p.fromMin <= minute && minute < p.toMin){ r.tariff = p.tariff; break; }
+  }
+  r.t1 = PV_PRICES[0].t1;
+  for (const PvPrices& p : PV_PRICES) if (p.fromYmd <= r.ymd) r.t1 = p.t1;
+  return r;
+}
+
+static time_t at(int y, int m, int d, int hh, int mm, int ss){
+  struct tm t = {}; t.tm_year = y - 1900; t.tm_mon = m - 1; t.tm_mday = d;
+  t.tm_hour = hh; t.tm_min = mm; t.tm_sec = ss; t.tm_isdst = -1;
+  return mktime(&t);
+}
+
+struct Checker {
+  PvCalendar c;
+  uint64_t steps = 0, errors = 0, dayEvents = 0, refDays = 0;
+  uint32_t lastYmd = 0;
+  void step(time_t t){
+    uint32_t before = c.ymd;
+    bool re = pvCalTick(c, t);
+    Ref r = reference(t);
+    if (re && c.ymd != before && before) ++dayEvents;
+    if (lastYmd && r.ymd != lastYmd) ++refDays;
+    lastYmd = r.ymd;
+    int hh, mm; pvCalWall(c, t, hh, mm);
+    bool ok = c.ymd == r.ymd && c.wday == r.wday && c.holiday == r.holiday && c.tariff == r.tariff
+              && hh == r.hh && mm == r.mm && c.price.t1 == r.t1 && t >= c.dayStart && t < c.nextDay;
+    if (!ok && errors++ < 10){
+      char b[64]; struct tm lt; localtime_r(&t, &lt); strftime(b, sizeof(b), "%Y-%m-%d %H:%M:%S %Z", &lt);
+      printf("FEHLER %s: ymd %u/%u wday %d/%d hh:mm %02d:%02d/%02d:%02d tarif %u/%u feiertag %d/%d\n", b,
+             c.ymd, r.ymd, c.wday, r.wday, hh, mm, r.hh, r.mm, c.tariff, r.tariff, c.holiday, r.holiday);
+    }
+    ++steps;
+  }
+  void dense(time_t from, time_t to){ for (time_t t = from; t < to; ++t) step(t); }
+};
+
+static int cmdVerify(unsigned seed){
+  std::mt19937 rng(seed);
+  Checker k;
+
+  // 1) Zufallsschritte über zwei Jahre (vorwärts, gelegentlich NTP-artige Rücksprünge)
+  time_t t = at(2023, 12, 31, 12, 0, 0), end = at(2026, 1, 2, 0, 0, 0);
+  uint64_t backJumps = 0;
+  while (t < end){
+    k.step(t);
+    if (rng() % 2000 == 0){ t -= 1 + rng() % 7200; ++backJumps; }
+    else t += 1 + rng() % 600;
+  }
+  printf("Zufallsschritte: %llu Schritte, %llu Rücksprünge, Neuberechnungen %u\n",
+         (unsigned long long)k.steps, (unsigned long long)backJumps, k.c.recalcs);
+
+  // 2) Sekundengenau um die Umstellungen, Jahreswechsel und einen Feiertag
+  struct { int y, m, d; const char* what; } days[] = {
+    {2024, 3, 31, "DST Beginn (23 h)"}, {2024, 10, 27, "DST Ende (25 h)"},
+    {2025, 3, 30, "DST Beginn (23 h)"}, {2025, 10, 26, "DST Ende (25 h)"},
+    {2024, 12, 31, "Jahreswechsel"},    {2024, 2, 29, "Schalttag"},
+    {2025, 8, 1, "Feiertag (MMDD)"},    {2025, 6, 30, "Preiswechsel"},
+  };
+  for (auto& d : days){
+    Checker dk;
+    time_t a = at(d.y, d.m, d.d, 0, 0, 0) - 3600, b = at(d.y, d.m, d.d + 1, 0, 0, 0) + 3600;
+    dk.dense(a, b);
+    pvCalTick(dk.c, at(d.y, d.m, d.d, 12, 0, 0));
+    long len = (long)(dk.c.nextDay - dk.c.dayStart);
+    char dst[32] = "-";
+    if (dk.c.dstChange){ struct tm lt; localtime_r(&dk.c.dstChange, &lt); strftime(dst, sizeof(dst), "%H:%M:%S %Z", &lt); }
+    printf("%04d-%02d-%02d %-18s Tag %2ld h, Umstellung %-13s %llu s geprüft, %u Neuberechnungen, %llu Fehler\n",
+           d.y, d.m, d.d, d.what, len / 3600, dst, (unsigned long long)dk.steps, dk.c.recalcs,
+           (unsigned long long)dk.errors);
+    k.errors += dk.errors;
+  }
+
+  bool ok = k.errors == 0;
+  printf("Tageswechsel: Cache %llu, Referenz %llu (inkl. Rücksprünge)\n",
+         (unsigned long long)k.dayEvents, (unsigned long long)k.refDays);
+  printf("%s (%llu Fehler)\n", ok ? "OK" : "FEHLER", (unsigned long long)k.errors);
+  return ok ? 0 : 1;
+}
+
+// ---------- Benchmark ----------
+static int cmdBench(uint32_t n){
+  time_t t0 = at(2025, 3, 1, 0, 0, 0);
+  volatile uint32_t sink = 0;
+
+  // alter Pfad: time() + localtime_r() pro Tick
+  auto a = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; ++i){
+    time_t t = t0 + i / 10;   // 10 Ticks pro Sekunde
+    struct tm ti; localtime_r(&t, &ti);
+    sink += (ti.tm_wday >= 1 && ti.tm_wday <= 5) && (ti.tm_hour >= 7 && ti.tm_hour < 18);
+  }
+  auto b = std::chrono::steady_clock::now();
+  PvCalendar c;
+  for (uint32_t i = 0; i < n; ++i){
+    time_t t = t0 + i / 10;
+    pvCalTick(c, t);
+    sink += c.tariff == PV_T1;
+  }
+  auto e = std::chrono::steady_clock::now();
+  (void)sink;
+  double nsOld = std::chrono::duration<double, std::nano>(b - a).count() / n;
+  double nsNew = std::chrono::duration<double, std::nano>(e - b).count() / n;
+  printf("localtime_r je Tick : %7.1f ns\n", nsOld);
+  printf("Cache je Tick       : %7.1f ns (%u Neuberechnungen in %.1f Tagen)\n", nsNew, c.recalcs, n / 10.0 / 86400.0);
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvcal verify [seed] | bench [n]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  setenv("TZ", TZ_EU_ZURICH, 1); tzset();
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  if (cmd == "verify") return cmdVerify(argc > 2 ? (unsigned)atoi(argv[2]) : 1);
+  if (cmd == "bench")  return cmdBench(argc > 2 ? (uint32_t)atoi(argv[2]) : 20000000);
+  return usage();
+}
@@ -0,0 +1,27 @@
+// ===================== tools/pvcal_tarif.h =====================
+// Beispiel-Tarifplan für PV_TARIFF_CUSTOM (wird von tools/pvcal.cpp geprüft):
+// mehrere Perioden, eigenes Wochenende, Feiertage, Preiswechsel nach Datum.
+// Im Sketch: Datei neben den Sketch kopieren (SolarDisplay/, die Arduino-IDE baut nur den
+// Sketch-Ordner), dann #define PV_TARIFF_CUSTOM "pvcal_tarif.h" vor #include "PvCommon.h"
+#pragma once
+
+static const PvTariffPeriod PV_TARIFF_PERIODS[] = {
+  { PV_MO_FR,            6*60,      12*60,      PV_T1 },   // Mo-Fr 06-12 Hochtarif
+  { PV_MO_FR,           12*60+30,   21*60+15,   PV_T1 },   // Mo-Fr 12:30-21:15 Hochtarif
+  { PV_SA,               8*60,      13*60,      PV_T1 },   // Sa 08-13 Hochtarif
+  { PV_MO_FR|PV_SA,      2*60+30,    3*60,      PV_T1 },   // liegt in der DST-Lücke (März)
+  { PV_FEIERTAG,        10*60,      11*60,      PV_T1 },   // Feiertag: nur 10-11 Hochtarif
+};
+#define PV_TARIFF_DEFAULT PV_T2
+
+static const uint32_t PV_HOLIDAYS[] = {
+  101, 801, 1225, 1226,       // jedes Jahr: Neujahr, 1. August, Weihnachten
+  20240401, 20250421,         // Ostermontag 2024/2025
+  0
+};
+
+static const PvPrices PV_PRICES[] = {
+  { 0,        0.344f, 0.2597f, 0.138f },
+  { 20250101, 0.312f, 0.2410f, 0.120f },
+  { 20250701, 0.298f, 0.2290f, 0.105f },
+};
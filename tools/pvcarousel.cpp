@@ -0,0 +1,406 @@
+// ===================== tools/pvcarousel.cpp =====================
+// Host-Simulation des Verlauf-Karussells (SolarDisplay/PvCarousel.h): ein Poller, N Clients
+// im selben Multicast-Netz, Verlust je Empfänger und Paket, Laufzeit 1..5 ms, Clients starten
+// verteilt (auch mitten in einer Runde). Poller und Clients laufen wie im Sketch (carTick(),
+// carClientTick(), UDP-Empfang), Nachrichten werden mit PvWire kodiert und dekodiert.
+// Zum Vergleich der bisherige Weg: je Client ein eigener Unicast-Strom (STATS_REQ_RANGE,
+// ein Record je Paket im Abstand von 2 ms, ab 1970, ohne Wiederholung).
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvcarousel tools/pvcarousel.cpp
+//
+// Aufrufe:
+//   pvcarousel selftest [--seed 1]
+//       Anfangssuche über die Stufen, Range/NACK des Senders, NACK-Kodierung; Simulation mit
+//       5 % Verlust (1, 20, 50 Clients), 30 % Verlust und Mitternacht während der Runde:
+//       jeder Client wird fertig und hat dieselben Tagesrecords wie der Poller;
+//       Poller-Bytes bei 50 Clients höchstens dreimal so viele wie bei einem (eine Runde, eine
+//       Wiederholungsrunde für die Vereinigung aller Lücken, Nachzügler ab Rundenbeginn)
+//   pvcarousel bench [--years 3] [--loss 0.05] [--spread 3000] [--seed 1]
+//       je 1/5/10/20/50 Clients: Pakete/KB des Pollers, Pakete der Clients, Zeit bis vollständig
+//       (p50/p95/max), Clients mit vollständigem Verlauf; alt (Unicast) gegen Karussell.
+//       --spread: Start der Clients gleichverteilt über so viele ms
+#include "pvhost.h"
+#include "../SolarDisplay/PvCarousel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <algorithm>
+
+static const int32_t TODAY = pvDayNum(2026, 10, 18);
+static const size_t  UDP_OVERHEAD = 28;   // IP + UDP je Paket (in den KB mitgezählt)
+
+// ---------- Poller-Speicher wie im Sketch (Tage + Stufen im Preferences-Ersatz) ----------
+struct Store {
+  Preferences p;
+  PvRollupPrefs<Preferences> st{p};
+  PvRollup r;
+  Store(){ Preferences::store().clear(); p.begin("pvstats"); }
+  bool load(const char* key, PvEnergy& a){ return st.load(key, a); }
+  void save(const char* key, const PvEnergy& a){ st.save(key, a); }
+  bool day(int32_t n, PvEnergy& a){ char k[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), k, sizeof(k)); return st.load(k, a); }
+  void saveDay(int32_t n, const PvEnergy& a){   // saveDayToNVS()
+    char k[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), k, sizeof(k));
+    PvEnergy old; st.load(k, old);
+    st.save(k, a);
+    pvRollupDay(r, *this, n, old, a);
+  }
+};
+
+static PvEnergy randDay(std::mt19937& rng){
+  std::uniform_int_distribution<int> wh(0, 40000);
+  PvEnergy a;
+  for (uint8_t i = 0; i < PVE_COUNT; ++i) a.e[i] = (int64_t)wh(rng) * PV_E_PER_MWH * 1000 + wh(rng);
+  return a;
+}
+static bool same(const PvEnergy& a, const PvEnergy& b){ return memcmp(a.e, b.e, sizeof(a.e)) == 0; }
+
+// Verlauf years Jahre bis gestern, ~3 % Tage fehlen (Poller aus)
+static void fillHistory(Store& s, int years, std::mt19937& rng){
+  std::uniform_int_distribution<int> pct(0, 99);
+  for (int32_t n = TODAY - years * 365; n < TODAY; ++n) if (pct(rng) >= 3) s.saveDay(n, randDay(rng));
+}
+
+// ---------- Netz ----------
+struct Pkt { int src; uint8_t type; std::vector<uint8_t> pl; };
+
+struct Net {
+  std::mt19937 rng;
+  double loss;
+  int nodes;
+  std::multimap<uint32_t, std::pair<int, Pkt>> q;   // Ankunft -> (Empfänger, Paket)
+  uint64_t pkts[2] = {}, bytes[2] = {};              // [0] Poller, [1] Clients
+  Net(unsigned seed, double l, int n) : rng(seed), loss(l), nodes(n) {}
+  // Multicast: jeder andere Knoten (0 = Poller) für sich verloren oder verzögert
+  void send(uint32_t now, int src, uint8_t type, const uint8_t* pl, size_t len){
+    pkts[src != 0]++; bytes[src != 0] += STATS_HDR_WIRE + len + UDP_OVERHEAD;
+    std::uniform_real_distribution<double> u(0, 1);
+    std::uniform_int_distribution<int> lat(1, 5);
+    for (int d = 0; d < nodes; ++d){
+      if (d == src || u(rng) < loss) continue;
+      q.emplace(now + lat(rng), std::make_pair(d, Pkt{ src, type, std::vector<uint8_t>(pl, pl + len) }));
+    }
+  }
+};
+
+// ---------- Poller (carTick() und UDP-Empfang im Sketch) ----------
+struct Poller {
+  Store& s;
+  PvCarSender car;
+  bool carReq = false;
+  int32_t today = TODAY;
+  PvEnergy dayAgg;
+  explicit Poller(Store& st) : s(st) {}
+
+  void rx(const Pkt& p){
+    if (p.type == STATS_CAR_REQ) carReq = true;
+    if (p.type == STATS_CAR_NACK){
+      PayloadCarNack n;
+      if (!pvWireDecode(p.pl.data(), p.pl.size(), n) || n.n > PV_CAR_SPANS) return;
+      if (p.pl.size() < PvWire<PayloadCarNack>::size + n.n * PvWire<PayloadCarSpan>::size) return;
+      PayloadCarSpan sp[PV_CAR_SPANS];
+      for (uint8_t k = 0; k < n.n; ++k)
+        pvWireDecode(p.pl.data() + PvWire<PayloadCarNack>::size + k * PvWire<PayloadCarSpan>::size, PvWire<PayloadCarSpan>::size, sp[k]);
+      if (car.blocks) pvCarNack(car, n, sp); else carReq = true;
+    }
+  }
+  void tick(Net& net, uint32_t now){
+    if (carReq){
+      carReq = false;
+      const int32_t first = car.idle || !car.blocks ? pvCarFirstDay(s, today, true) : car.first;
+      pvCarRange(car, first, today);
+      pvCarRequest(car);
+    }
+    if (car.blocks) pvCarRange(car, car.first, today);
+    const int32_t idx = pvCarNext(car, now);
+    if (idx == PVCAR_WAIT) return;
+    uint8_t pl[PV_CAR_BLOCK_MAX];
+    if (idx == PVCAR_SEND_IDLE){ net.send(now, 0, STATS_CAR_IDLE, pl, pvCarBuildIdle(car, pl)); return; }
+    size_t n = pvCarBuild(car, (uint16_t)idx, today, [&](int32_t day, PvEnergy& a){
+      if (day == today){ a = dayAgg; return true; }
+      return s.day(day, a);
+    }, pl);
+    net.send(now, 0, STATS_CAR_BLOCK, pl, n);
+  }
+  // Mitternacht: laufender Tag wird Record (handleDayMonthRollover)
+  void midnight(){ s.saveDay(today, dayAgg); today++; }
+};
+
+// ---------- Client (carClientTick() und UDP-Empfang im Sketch) ----------
+struct Client {
+  PvCarReceiver r;
+  std::map<int32_t, PvEnergy> days;   // NVS des Clients
+  uint32_t bootMs = 0, writes = 0, skipped = 0;
+  int32_t  todayAtDone = 0;
+  bool     booted = false;
+
+  void store(int32_t n, const PvEnergy& a){   // carStoreDay()
+    auto it = days.find(n);
+    if (it != days.end() && same(it->second, a)){ skipped++; return; }
+    days[n] = a; writes++;
+  }
+  void rx(const Pkt& p, uint32_t now, uint32_t rnd, int32_t today){
+    if (!booted) return;
+    const bool wasDone = r.done;
+    if (p.type == STATS_CAR_BLOCK){
+      PayloadCarBlock b;
+      if (!pvWireDecode(p.pl.data(), p.pl.size(), b)) return;
+      if (p.pl.size() < PvWire<PayloadCarBlock>::size + __builtin_popcount(b.mask) * PvWire<PayloadCarDay>::size) return;
+      if (!pvCarOnBlock(r, b, now)) return;
+      const uint8_t* q = p.pl.data() + PvWire<PayloadCarBlock>::size;
+      for (uint8_t i = 0; i < PV_CAR_DAYS; ++i){
+        if (!(b.mask & (1u << i))) continue;
+        PayloadCarDay cd; PvWire<PayloadCarDay>::get(cd, q); q += PvWire<PayloadCarDay>::size;
+        store(b.first + (int32_t)b.idx * PV_CAR_DAYS + i, pvCarEnergy(cd));
+      }
+    }
+    if (p.type == STATS_CAR_IDLE){
+      PayloadCarBlock b;
+      if (!pvWireDecode(p.pl.data(), p.pl.size(), b)) return;
+      pvCarOnIdle(r, b, now, rnd);
+    }
+    if (p.type == STATS_CAR_NACK) pvCarOnNack(r, now);
+    if (r.done && !wasDone) todayAtDone = today;
+  }
+  void tick(Net& net, int self, uint32_t now, uint32_t rnd){
+    if (!booted) return;
+    const uint8_t what = pvCarTick(r, now, rnd);
+    uint8_t pl[PV_CAR_NACK_MAX];
+    if (what == PVCAR_REQ)  net.send(now, self, STATS_CAR_REQ, nullptr, 0);
+    if (what == PVCAR_NACK) net.send(now, self, STATS_CAR_NACK, pl, pvCarBuildNack(r, 0, pl));
+  }
+};
+
+// ---------- Ergebnis ----------
+struct Result {
+  int clients = 0, complete = 0, match = 0;
+  uint64_t pollerPkts = 0, pollerBytes = 0, clientPkts = 0, clientBytes = 0;
+  uint32_t p50 = 0, p95 = 0, max = 0, rounds = 0, nacks = 0, held = 0;
+  uint64_t writes = 0, skipped = 0;
+};
+
+static void percentiles(std::vector<uint32_t> t, Result& res){
+  if (t.empty()) return;
+  std::sort(t.begin(), t.end());
+  res.p50 = t[t.size() / 2]; res.p95 = t[(t.size() * 95) / 100 < t.size() ? (t.size() * 95) / 100 : t.size() - 1]; res.max = t.back();
+}
+
+struct Sim { int clients = 1; double loss = 0.05; uint32_t spread = 3000; uint32_t midnightMs = 0; uint32_t limitMs = 300000; bool preload = false; };
+
+// Karussell: Store muss gefüllt sein; Clients mit preload haben schon einen älteren Stand
+static Result runCarousel(Store& s, const Sim& sim, unsigned seed){
+  Net net(seed, sim.loss, sim.clients + 1);
+  std::mt19937 rng(seed * 7 + 1);
+  Poller pol(s);
+  pol.dayAgg = randDay(rng);
+  std::vector<Client> cl(sim.clients);
+  std::uniform_int_distribution<uint32_t> boot(0, sim.spread);
+  for (auto& c : cl){
+    c.bootMs = boot(rng);
+    if (!sim.preload) continue;
+    for (int32_t n = TODAY - 1000; n < TODAY - 30; ++n){ PvEnergy a; if (s.day(n, a)) c.days[n] = a; }
+  }
+  uint32_t now = 0;
+  for (; now < sim.limitMs; ++now){
+    if (sim.midnightMs && now == sim.midnightMs) pol.midnight();
+    while (!net.q.empty() && net.q.begin()->first <= now){
+      auto e = net.q.begin()->second; net.q.erase(net.q.begin());
+      if (e.first == 0) pol.rx(e.second);
+      else cl[e.first - 1].rx(e.second, now, rng(), pol.today);
+    }
+    for (size_t i = 0; i < cl.size(); ++i){
+      Client& c = cl[i];
+      if (!c.booted && now >= c.bootMs){ c.booted = true; pvCarStart(c.r, now); }   // Offer mit STATS_OFFER_CAROUSEL
+      c.tick(net, (int)i + 1, now, rng());
+    }
+    pol.tick(net, now);
+    bool all = true;
+    for (auto& c : cl) all &= c.r.done;
+    if (all && net.q.empty()) break;
+  }
+  Result res; res.clients = sim.clients;
+  std::vector<uint32_t> t;
+  for (auto& c : cl){
+    if (!c.r.done) continue;
+    res.complete++;
+    t.push_back(c.r.doneMs - c.bootMs);
+    // gleicher Stand wie der Poller: alle Tage bis zum Tag, an dem der Client fertig wurde
+    // (laufender Tag = dayAgg, bleibt hier bis Mitternacht unverändert)
+    bool ok = true;
+    for (int32_t n = pvCarFirstDay(s, pol.today, true); n <= c.todayAtDone; ++n){
+      PvEnergy a; bool has = n == pol.today ? (a = pol.dayAgg, true) : s.day(n, a);
+      auto it = c.days.find(n);
+      if (has != (it != c.days.end()) || (has && !same(a, it->second))){ ok = false; break; }
+    }
+    res.match += ok;
+    res.writes += c.writes; res.skipped += c.skipped; res.held += c.r.held;
+  }
+  percentiles(t, res);
+  res.pollerPkts = net.pkts[0]; res.pollerBytes = net.bytes[0];
+  res.clientPkts = net.pkts[1]; res.clientBytes = net.bytes[1];
+  res.rounds = pol.car.rounds; res.nacks = pol.car.nacks;
+  return res;
+}
+
+// Bisher: REQ_RANGE je Client, der Poller streamt im UDP-Task nacheinander (delay(2) je Record)
+// alle Tage ab 1970 und alle Monate, dann STATS_DONE. Verlorene Records bleiben verloren.
+static Result runUnicast(const Sim& sim, unsigned seed){
+  std::mt19937 rng(seed * 7 + 1);
+  std::uniform_real_distribution<double> u(0, 1);
+  std::uniform_int_distribution<uint32_t> boot(0, sim.spread);
+  int ty, tm, td; pvDayCivil(TODAY, ty, tm, td);
+  const uint32_t days = (uint32_t)(TODAY - pvDayNum(1970, 1, 1) + 1), months = (uint32_t)((ty - 1970) * 12 + tm);
+  const uint64_t perClient = (uint64_t)days * (STATS_HDR_WIRE + PvWire<PayloadDay>::size + UDP_OVERHEAD) +
+                             (uint64_t)months * (STATS_HDR_WIRE + PvWire<PayloadMon>::size + UDP_OVERHEAD) + STATS_HDR_WIRE + UDP_OVERHEAD;
+  std::vector<uint32_t> req(sim.clients);
+  for (auto& b : req) b = boot(rng);
+  std::vector<uint32_t> order(req);
+  std::sort(order.begin(), order.end());
+  Result res; res.clients = sim.clients;
+  std::vector<uint32_t> t;
+  uint32_t busyUntil = 0;
+  for (uint32_t b : order){
+    const uint32_t start = std::max(b + 3, busyUntil);   // Anfrage unterwegs, Poller streamt noch für andere
+    const uint32_t end = start + (days + months) * 2;
+    busyUntil = end;
+    res.pollerPkts += days + months + 1; res.pollerBytes += perClient;
+    res.clientPkts++; res.clientBytes += STATS_HDR_WIRE + PvWire<PayloadReqRange>::size + UDP_OVERHEAD;
+    bool lost = false;
+    for (uint32_t i = 0; i <= days + months && !lost; ++i) lost = u(rng) < sim.loss;
+    t.push_back(end + 3 - b);
+    if (!lost){ res.complete++; res.match++; }
+  }
+  percentiles(t, res);
+  return res;
+}
+
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+struct Opt { int years = 3; double loss = 0.05; uint32_t spread = 3000; unsigned seed = 1; };
+
+static int cmdSelftest(const Opt& o){
+  std::mt19937 rng(o.seed);
+  // --- Anfang über die Stufen ---
+  {
+    Store s;
+    const int32_t first = pvDayNum(2024, 3, 17);
+    s.saveDay(first, randDay(rng)); s.saveDay(first + 40, randDay(rng));
+    int y, m, d; pvDayCivil(TODAY, y, m, d);
+    check(pvCarFirstDay(s, TODAY, true) == first, "Anfangssuche: erster Tag mit Record über Jahr/Monat/Tag");
+    check(pvCarFirstDay(s, TODAY, false) == pvDayNum(y - PV_ROLLUP_YEARS, 1, 1), "Anfangssuche ohne Stufen: ganzer Zeitraum");
+  }
+  // --- Sender: Range, Request, NACK, Umlauf ---
+  {
+    PvCarSender c;
+    pvCarRange(c, TODAY - 99, TODAY);
+    bool ok = c.blocks == 13 && c.pending == 0;
+    pvCarRequest(c);
+    ok &= c.pending == 13 && !c.idle;
+    uint32_t now = 1000; int sent = 0, idle = 0;
+    for (int i = 0; i < 40; ++i, now += PV_CAR_GAP_MS){ int32_t x = pvCarNext(c, now); sent += x >= 0; idle += x == PVCAR_SEND_IDLE; }
+    ok &= sent == 13 && idle == 1 && c.rounds == 1;
+    PayloadCarNack h{ c.first, c.blocks, 2, 0, 0 };
+    PayloadCarSpan sp[2] = { { 2, 3 }, { 12, 5 } };   // zweite Lücke über das Ende hinaus
+    pvCarNack(c, h, sp);
+    ok &= c.pending == 4;
+    pvCarRange(c, c.first, TODAY + 8);                // Mitternacht während offener Blöcke: neuer Block fällig
+    ok &= c.blocks == 14 && c.pending == 5;
+    check(ok, "Sender: Bereich, Runde mit STATS_CAR_IDLE, NACK-Spannen, neuer Block");
+  }
+  // --- NACK-Kodierung ---
+  {
+    PvCarReceiver r; pvCarStart(r, 0);
+    pvCarAdopt(r, 100, 60);
+    for (uint16_t i = 0; i < 60; ++i) if (i % 5 && i != 59) pvCarSet(r.got, i);
+    uint8_t pl[PV_CAR_NACK_MAX];
+    size_t n = pvCarBuildNack(r, 0, pl);
+    PayloadCarNack h{}; pvWireDecode(pl, n, h);
+    PayloadCarSpan last{}; pvWireDecode(pl + PvWire<PayloadCarNack>::size + (h.n - 1) * PvWire<PayloadCarSpan>::size, PvWire<PayloadCarSpan>::size, last);
+    check(h.n == 13 && h.first == 100 && h.blocks == 60 && last.idx == 59 && last.count == 1 &&
+          n == PvWire<PayloadCarNack>::size + 13 * PvWire<PayloadCarSpan>::size, "NACK: Lücken als Spannen, Länge");
+  }
+  // --- Simulation ---
+  Store s;
+  fillHistory(s, o.years, rng);
+  Sim sim; sim.spread = o.spread;
+  Result one;
+  for (int n : { 1, 20, 50 }){
+    sim.clients = n; sim.loss = 0.05;
+    Result r = runCarousel(s, sim, o.seed + n);
+    if (n == 1) one = r;
+    char b[96];
+    snprintf(b, sizeof(b), "%d Clients, 5 %% Verlust: alle vollständig und gleich wie Poller", n);
+    check(r.complete == n && r.match == n, b);
+    if (n == 50){
+      snprintf(b, sizeof(b), "Poller-Bytes 50 Clients <= 3 x 1 Client (%.0f / %.0f KB)", r.pollerBytes / 1024.0, one.pollerBytes / 1024.0);
+      check(r.pollerBytes <= 3 * one.pollerBytes, b);
+    }
+  }
+  sim.clients = 20; sim.loss = 0.30;
+  Result r = runCarousel(s, sim, o.seed + 100);
+  check(r.complete == 20 && r.match == 20, "20 Clients, 30 % Verlust: alle vollständig und gleich wie Poller");
+  sim.loss = 0.05; sim.midnightMs = 1500;
+  r = runCarousel(s, sim, o.seed + 200);
+  check(r.complete == 20 && r.match == 20, "Mitternacht während der Runde: alle vollständig und gleich");
+  sim.midnightMs = 0; sim.preload = true;
+  Store s2; fillHistory(s2, o.years, rng);
+  r = runCarousel(s2, sim, o.seed + 300);
+  check(r.complete == 20 && r.match == 20 && r.skipped > 0, "Clients mit älterem Stand: unveränderte Tage nicht neu geschrieben");
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static void row(const char* name, const Result& r){
+  printf("%-10s %4d %8llu %9.1f %8llu %8u %8u %8u %6d/%-4d %6u\n", name, r.clients,
+         (unsigned long long)r.pollerPkts, r.pollerBytes / 1024.0, (unsigned long long)r.clientPkts,
+         r.p50, r.p95, r.max, r.match, r.clients, r.nacks);
+}
+
+static int cmdBench(const Opt& o){
+  std::mt19937 rng(o.seed);
+  Store s;
+  fillHistory(s, o.years, rng);
+  PvCarSender probe; pvCarRange(probe, pvCarFirstDay(s, TODAY, true), TODAY);
+  printf("%d Jahre Verlauf (%u Blöcke zu %u Tagen), Verlust %.0f %%, Start über %u ms verteilt\n\n",
+         o.years, probe.blocks, PV_CAR_DAYS, o.loss * 100, o.spread);
+  printf("%-10s %4s %8s %9s %8s %8s %8s %8s %11s %6s\n", "", "N", "Poll-Pkt", "Poll-KB", "Cli-Pkt", "p50 ms", "p95 ms", "max ms", "vollständig", "NACKs");
+  for (int n : { 1, 5, 10, 20, 50 }){
+    Sim sim; sim.clients = n; sim.loss = o.loss; sim.spread = o.spread;
+    row("Unicast", runUnicast(sim, o.seed + n));
+    row("Karussell", runCarousel(s, sim, o.seed + n));
+  }
+  printf("\nUnicast: je Client alle Tage ab 1970 + Monate, nacheinander, ohne Wiederholung\n");
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvcarousel selftest [--seed N] | bench [--years N] [--loss P] [--spread MS] [--seed N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  Opt o;
+  for (int i = 2; i + 1 < argc; i += 2){
+    std::string k = argv[i];
+    if (k == "--years") o.years = atoi(argv[i + 1]);
+    else if (k == "--loss") o.loss = atof(argv[i + 1]);
+    else if (k == "--spread") o.spread = (uint32_t)atoi(argv[i + 1]);
+    else if (k == "--seed") o.seed = (unsigned)atoi(argv[i + 1]);
+    else return usage();
+  }
+  if (o.years < 1 || o.years > PV_ROLLUP_YEARS || o.loss < 0 || o.loss >= 1) return usage();
+  if (cmd == "selftest") return cmdSelftest(o);
+  if (cmd == "bench") return cmdBench(o);
+  return usage();
+}
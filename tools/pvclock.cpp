@@ -0,0 +1,254 @@
+// ===================== tools/pvclock.cpp =====================
+// Host-Simulation der Uhrverteilung (SolarDisplay/PvClock.h): Poller-Zeitstempel in Frames,
+// Empfang mit Laufzeit-Jitter, Verlust und Quarz-Drift des Clients; Schätzer und Nachführung
+// der Systemuhr wie im Sketch.
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvclock tools/pvclock.cpp
+//
+// Aufrufe:
+//   pvclock sim [--ppm 40] [--dtim-ms 102] [--jitter-ms 3] [--loss 0.05] [--hours 6] [--seed 1]
+//               [--step-at-h 0] [--step-ms 0] [--settle-ms 50] [--trace]
+//       Verlauf: Fehler der Schätzung und der Systemuhr gegen die Poller-Uhr (p50/p95/max nach
+//       dem Einschwingen), Drift-Schätzung, Einschwingzeit, Stempel nach dem Empfang (darf nie
+//       vorkommen: sonst bucht der Client nach Mitternacht noch auf den Vortag)
+//   pvclock selftest
+//       Drift -60..+60 ppm, DTIM 0/102/307 ms, mehrere Seeds: Grenzen für Fehler und Drift,
+//       Sprung der Poller-Uhr, einzelnes stark verspätetes Paket, Zeit-Anhang (CRC, Flags)
+//
+// Modell: Frames alle 30 s (+ Rundendauer 1-2 s), Laufzeit = 1 ms + exp(jitter) + gleichverteilt
+// bis DTIM (Multicast an Stationen im Modem-Sleep erst nach dem DTIM-Beacon), 2 % Ausreisser
+// 0.3-1.5 s (Wiederholungen), Verlust; adjtime() führt mit 1/6 der Zeit nach (ESP-IDF).
+#include "../SolarDisplay/PvClock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+struct Opt {
+  double ppm = 40, dtimMs = 102, jitterMs = 3, loss = 0.05, hours = 6;
+  double stepAtH = 0, stepMs = 0;
+  double settleMs = 50;   // eingeschwungen: Schätzfehler dauerhaft darunter
+  unsigned seed = 1;
+  bool trace = false;
+};
+
+struct Result {
+  std::vector<double> estErr, sysErr;   // ms, nach dem Einschwingen (ab 30 min)
+  double settleS = 0;                   // ab hier |Schätzfehler| < settleMs
+  double driftPpm = 0;                  // Schätzung am Ende
+  uint32_t causal = 0;                  // Frames mit Stempel nach Systemuhr (nach Nachführung)
+  uint32_t frames = 0, samples = 0, steps = 0;
+};
+
+static double pctAbs(std::vector<double> v, double p){
+  if (v.empty()) return 0;
+  for (double& x : v) x = fabs(x);
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(p * (v.size() - 1) + 0.5)];
+}
+
+static Result run(const Opt& o){
+  std::mt19937 rng(o.seed);
+  std::uniform_real_distribution<double> U(0, 1);
+  std::exponential_distribution<double> E(1.0 / (o.jitterMs > 0 ? o.jitterMs : 1e-9));
+
+  // Wahre Zeit T (ms seit Start); Poller-Uhr = T0 + T (+ Sprung), Client-millis = m0 + T*(1+ppm)
+  const double T0 = 1760000000000.0 + U(rng) * 86400000.0;
+  const double m0 = 800 + U(rng) * 4000;
+  const double rate = 1.0 + o.ppm * 1e-6;
+  auto poller = [&](double T){ return T0 + T + (o.stepMs && T >= o.stepAtH * 3600e3 ? o.stepMs : 0); };
+  auto millisAt = [&](double T){ return (uint32_t)(uint64_t)(m0 + T * rate); };
+
+  PvClock c;
+  Result r;
+  // Systemuhr des Clients: millis + sysOff, adjtime-Rest wird mit 1/6 der Zeit abgebaut
+  double sysOff = 0, slew = 0, lastT = 0;
+  bool sysSet = false;
+  auto advance = [&](double T){
+    double dt = T - lastT; lastT = T;
+    if (slew != 0){
+      double s = dt * rate / 6.0;
+      if (fabs(slew) <= s){ sysOff += slew; slew = 0; }
+      else { double d = slew > 0 ? s : -s; sysOff += d; slew -= d; }
+    }
+  };
+  auto sysAt = [&](double T){ return (double)millisAt(T) + sysOff; };
+
+  const double end = o.hours * 3600e3;
+  double next = 5000 + U(rng) * 30000, lastBad = 0, evalAt = 0;
+  while (true){
+    // nächster Frame: Stempel direkt vor dem Senden, Laufzeit, evtl. verloren
+    double sendT = next;
+    next += 30000 + 1000 + U(rng) * 1000;
+    bool lost = U(rng) < o.loss;
+    double d = 1.0 + E(rng) + U(rng) * o.dtimMs;
+    if (U(rng) < 0.02) d += 300 + U(rng) * 1200;
+    double rxT = sendT + d;
+
+    // Auswertung im Sekundentakt bis zum Empfang
+    for (; evalAt < rxT && evalAt < end; evalAt += 1000){
+      advance(evalAt);
+      if (!c.valid) continue;
+      double e = (double)pvClockNowMs(c, millisAt(evalAt)) - poller(evalAt);
+      if (fabs(e) > o.settleMs) lastBad = evalAt;
+      if (evalAt >= 1800e3){ r.estErr.push_back(e); if (sysSet) r.sysErr.push_back(sysAt(evalAt) - poller(evalAt)); }
+    }
+    if (rxT >= end) break;
+    r.frames++;
+    if (lost) continue;
+    uint64_t stamp = (uint64_t)poller(sendT);
+    uint32_t rx = millisAt(rxT);
+    advance(rxT);
+
+    bool stepped = pvClockSample(c, rx, stamp);
+    r.samples++;
+    int32_t delta;
+    uint8_t k = pvClockCorrection((int64_t)pvClockNowMs(c, rx), (int64_t)sysAt(rxT), delta);
+    if (!sysSet){ sysOff += (double)pvClockNowMs(c, rx) - sysAt(rxT); slew = 0; sysSet = true; }
+    else if (k == PVCK_STEP){ sysOff += delta; slew = 0; }
+    else if (k == PVCK_SLEW) slew = delta;
+    if (sysAt(rxT) < (double)stamp) r.causal++;
+    if (o.trace)
+      printf("%8.1f s  d=%6.1f ms  Schätzung %+8.1f ms  System %+8.1f ms  Drift %+6.1f ppm%s\n",
+             rxT / 1000, d, (double)pvClockNowMs(c, rx) - poller(rxT), sysAt(rxT) - poller(rxT),
+             (double)c.drift * 1e6, stepped ? "  neu angesetzt" : "");
+  }
+  r.settleS = lastBad / 1000;
+  r.driftPpm = c.drift * 1e6;
+  r.steps = c.steps;
+  return r;
+}
+
+// Poller schneller als der Client um ppm -> Offset wächst um -ppm (Client-millis laufen schneller)
+static double expectDrift(double ppm){ return (1.0 / (1.0 + ppm * 1e-6) - 1.0) * 1e6; }
+
+static void print(const Opt& o, const Result& r){
+  printf("Drift Client %+.0f ppm, DTIM %.0f ms, Jitter %.0f ms, Verlust %.0f %%, %.1f h\n",
+         o.ppm, o.dtimMs, o.jitterMs, o.loss * 100, o.hours);
+  printf("  Frames %u, Samples %u, neu angesetzt %u\n", r.frames, r.samples, r.steps);
+  printf("  Schätzung - Poller:   p50 %6.1f  p95 %6.1f  max %6.1f ms (ab 30 min)\n",
+         pctAbs(r.estErr, 0.5), pctAbs(r.estErr, 0.95), pctAbs(r.estErr, 1.0));
+  printf("  Systemuhr - Poller:   p50 %6.1f  p95 %6.1f  max %6.1f ms\n",
+         pctAbs(r.sysErr, 0.5), pctAbs(r.sysErr, 0.95), pctAbs(r.sysErr, 1.0));
+  printf("  Drift geschätzt %+.1f ppm (wahr %+.1f), eingeschwungen (<%.0f ms) nach %.0f s\n",
+         r.driftPpm, expectDrift(o.ppm), o.settleMs, r.settleS);
+  printf("  Stempel nach der Systemuhr: %u\n", r.causal);
+}
+
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+static int cmdSelftest(){
+  // Konvergenz über Drift x DTIM x Seeds
+  const double ppms[] = { -60, -15, 0, 25, 60 };
+  const double dtims[] = { 0, 102, 307 };
+  for (double dt : dtims){
+    double worst95 = 0, worstDrift = 0, worstSettle = 0; uint32_t causal = 0;
+    for (double p : ppms) for (unsigned s = 1; s <= 4; ++s){
+      Opt o; o.ppm = p; o.dtimMs = dt; o.seed = s * 7 + (unsigned)dt; o.hours = 4;
+      o.settleMs = 30 + dt * 0.3;
+      Result r = run(o);
+      worst95 = std::max(worst95, pctAbs(r.estErr, 0.95));
+      worstDrift = std::max(worstDrift, fabs(r.driftPpm - expectDrift(p)));
+      worstSettle = std::max(worstSettle, r.settleS);
+      causal += r.causal;
+    }
+    char buf[128];
+    double lim = 10 + dt * 0.35;   // obere Hülle: Fehler ~ kleinste Laufzeit im Fenster
+    snprintf(buf, sizeof(buf), "DTIM %3.0f ms: p95 |Fehler| %.1f ms <= %.0f ms", dt, worst95, lim);
+    check(worst95 <= lim, buf);
+    snprintf(buf, sizeof(buf), "DTIM %3.0f ms: Driftfehler %.1f ppm <= %.0f ppm", dt, worstDrift, 3 + dt / 12);
+    check(worstDrift <= 3 + dt / 12, buf);
+    snprintf(buf, sizeof(buf), "DTIM %3.0f ms: < %.0f ms nach %.0f s <= 1200 s", dt, 30 + dt * 0.3, worstSettle);
+    check(worstSettle <= 1200, buf);
+    snprintf(buf, sizeof(buf), "DTIM %3.0f ms: nie Stempel nach der Systemuhr (%u)", dt, causal);
+    check(causal == 0, buf);
+  }
+
+  // Poller-Uhr springt (NTP-Korrektur) vor und zurück
+  for (double st : { 5000.0, -5000.0 }){
+    Opt o; o.stepAtH = 2; o.stepMs = st; o.hours = 3; o.seed = 3;
+    Result r = run(o);
+    char buf[96];
+    snprintf(buf, sizeof(buf), "Poller-Uhr springt %+.0f s: neu angesetzt, Fehler danach klein", st / 1000);
+    check(r.steps == 2 && pctAbs(r.estErr, 0.95) <= 50, buf);
+  }
+
+  // einzelnes stark verspätetes Paket setzt nicht neu an
+  {
+    PvClock c;
+    uint32_t rx = 1000; uint64_t t = 1760000000000ull;
+    for (int i = 0; i < 20; ++i){ pvClockSample(c, rx, t); rx += 30000; t += 30000; }
+    int64_t before = pvClockOffset(c, rx);
+    pvClockSample(c, rx + 3500, t);              // 3.5 s unterwegs
+    bool keep = c.steps == 1 && pvClockOffset(c, rx) == before;
+    rx += 30000; t += 30000;
+    pvClockSample(c, rx, t);
+    check(keep && c.steps == 1, "einzelnes Paket 3.5 s verspätet: Schätzung bleibt");
+    pvClockSample(c, rx + 30000 + 4000, t + 30000);
+    pvClockSample(c, rx + 60000 + 4000, t + 60000);
+    check(c.steps == 2, "zwei in Folge 4 s darunter: neu angesetzt");
+  }
+
+  // Zeit-Anhang
+  {
+    uint8_t pkt[PV_FRAME_WIRE + PV_TIME_WIRE] = {};
+    pvFrameTimeSeal(pkt + PV_FRAME_WIRE, 1760000123456ull, true);
+    uint64_t ms = 0;
+    check(pvFrameTimeGet(pkt, sizeof(pkt), PV_FRAME_WIRE, ms) && ms == 1760000123456ull, "Anhang: Zeit in ms zurück");
+    check(!pvFrameTimeGet(pkt, PV_FRAME_WIRE, PV_FRAME_WIRE, ms), "Anhang fehlt (alter Poller): keine Zeit");
+    pkt[PV_FRAME_WIRE + 5] ^= 1;
+    check(!pvFrameTimeGet(pkt, sizeof(pkt), PV_FRAME_WIRE, ms), "Anhang beschädigt: keine Zeit");
+    pvFrameTimeSeal(pkt + PV_FRAME_WIRE, 1760000123456ull, false);
+    check(!pvFrameTimeGet(pkt, sizeof(pkt), PV_FRAME_WIRE, ms), "Poller-Uhr nicht gestellt: keine Zeit");
+  }
+
+  // Nachführung: vorwärts stellen, wenig zurück langsam, weit zurück stellen
+  int32_t d;
+  check(pvClockCorrection(1000, 990, d) == PVCK_STEP && d == 10, "Systemuhr hinter Schätzung: vorwärts stellen");
+  check(pvClockCorrection(1000, 1100, d) == PVCK_SLEW && d == -100, "Systemuhr 100 ms voraus: adjtime");
+  check(pvClockCorrection(1000, 3000, d) == PVCK_STEP && d == -2000, "Systemuhr 2 s voraus: stellen");
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvclock sim [Optionen] | selftest (s. Dateikopf)\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  if (cmd == "selftest") return cmdSelftest();
+  if (cmd != "sim") return usage();
+  Opt o;
+  for (int i = 2; i < argc; ++i){
+    std::string k = argv[i];
+    if (k == "--trace"){ o.trace = true; continue; }
+    if (i + 1 >= argc) return usage();
+    double v = atof(argv[++i]);
+    if      (k == "--ppm")       o.ppm = v;
+    else if (k == "--dtim-ms")   o.dtimMs = v;
+    else if (k == "--jitter-ms") o.jitterMs = v;
+    else if (k == "--loss")      o.loss = v;
+    else if (k == "--hours")     o.hours = v;
+    else if (k == "--seed")      o.seed = (unsigned)v;
+    else if (k == "--step-at-h") o.stepAtH = v;
+    else if (k == "--step-ms")   o.stepMs = v;
+    else if (k == "--settle-ms") o.settleMs = v;
+    else return usage();
+  }
+  print(o, run(o));
+  return 0;
+}
@@ -0,0 +1,689 @@
+// ===================== tools/pvelect.cpp =====================
+// Host-Simulation Poller-Wahl (SolarDisplay/PvElect.h): mehrere Knoten mit ROLE_POLLER und
+// PV_ELECT, jeder mit eigener millis() (Versatz, auch kurz vor dem Überlauf). loop() läuft alle
+// 5..15 ms wie electTick() und maybeFinishPoll(), Heartbeats kommen im UDP-Task an (sofort
+// pvElectRx, Aktionen erledigt die nächste loop()). Der Aktive fragt in Runden ab (alle 30 s,
+// sechs Anfragen, Antwort 20..300 ms) und sendet danach den Frame mit allen Anhängen; die
+// anderen Knoten und ein Client nehmen ihn mit dem Client-Kern (PvRx.h, pvRxTakeover) an.
+// Ein nachgebildeter Wechselrichter führt Buch über jede Anfrage: überlappen sich die
+// Anfragen zweier Knoten, ist die Invariante verletzt.
+// Störungen je Muster: Verlust Multicast/Unicast, Laufzeiten, Funklöcher eines Knotens (nichts
+// geht rein oder raus, auch kein Modbus), einseitig kein Multicast-Empfang, hängende loop()
+// (NVS, Zeichnen), Ausfall des Aktiven mit Neustart, Zweiteilung (zwei Gruppen hören einander
+// nicht, beide erreichen den Wechselrichter). Ab drei Knoten bewirbt sich ein Knoten, der
+// niemanden hört, nicht; mit --nodes 2 zeigen Zweiteilung und einseitiger Multicast die
+// dokumentierte Grenze (Überlappung erwartet).
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvelect tools/pvelect.cpp
+//
+// Aufrufe:
+//   pvelect selftest [--seed 1]
+//       Anhang (Rundreise, CRC, Amtszeit 0, hinter Energie-Teilen), Rang, Start (genau einer
+//       aktiv, ranghöchster), Abgeben (auch über einen Folgenden gemeldet), Lease, Standby,
+//       WLAN getrennt, Überlauf von millis(), Client-Übernahme ohne Neustart, Ring aus fremden
+//       Teilen; Simulation mit drei Knoten: keine Überlappung je Muster, Übernahme in Sekunden
+//   pvelect bench [--hours 6] [--nodes 3] [--seed 1]
+//       je Muster: Ausfälle, Übernahme (Ausfall bis erste Anfrage) und Client (bis zum ersten
+//       Frame des Nachfolgers) p50/p95/max, überlappende Anfragen, kleinster Abstand beim
+//       Wechsel, Lease abgelaufen, verzögerte Runden, Nachfolger mit seq zurück
+//   pvelect live [--nodes 3] [--sec 60] [--loss 0.1] [--kill 12] [--seed 1]
+//       echte Prozesse über UDP auf 127.0.0.1 (Multicast als Senden an alle Knoten-Ports, Verlust
+//       beim Sender), der Elternprozess ist der Wechselrichter und beendet alle --kill Sekunden
+//       den Aktiven (Neustart nach 5 s)
+#include "../SolarDisplay/PvElect.h"
+#include "../SolarDisplay/PvRx.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const uint64_t POLL_MS = 30000;      // POLL_INTERVAL_MS
+static const int      ROUND_REQ = 6;        // Anfragen je Runde
+static const uint64_t HOUR_MS = 3600000u;
+
+// Frame mit Zeit-, Batterie-, Plan- und Wahl-Anhang (optional zwei Energie-Teile davor)
+static std::vector<uint8_t> framePkt(uint32_t seq, const PvElect& e, bool parts = false){
+  PvFrameV4 f{}; f.seq = seq; f.ts = 1790000000u + seq * 30;
+  std::vector<uint8_t> b(PV_FRAME_WIRE + PV_TIME_WIRE + PV_FILL_WIRE_MAX + PV_BATT_WIRE + PV_SCHED_WIRE + PV_ELECT_WIRE);
+  size_t n = pvFrameEncode(f, b.data());
+  n += pvFrameTimeSeal(b.data() + n, (uint64_t)f.ts * 1000, true);
+  if (parts){
+    PayloadFillPart p[2] = { { seq, 20000, 1, 2, 3, 4, 5 }, { seq, 20001, 6, 7, 8, 9, 10 } };
+    n += pvFillSeal(b.data() + n, p, 2);
+  }
+  PvBattEta eta{}; eta.eta20s = eta.fullS = eta.emptyS = -1; eta.dir = PVB_IDLE;
+  n += pvBattSeal(b.data() + n, eta);
+  n += pvSchedSeal(b.data() + n, PvSched{ 30000, 1000, 30000 });
+  n += pvElectSeal(b.data() + n, e);
+  b.resize(n);
+  return b;
+}
+
+// Client-Seite wie beginListenFrames(): Übernahme bei höherer Amtszeit, Amtszeit merken
+static uint8_t clientRx(PvRxState& s, const std::vector<uint8_t>& b, uint32_t src, uint32_t now){
+  PvFrameV4 f;
+  uint8_t r = pvRxFrame(s, b.data(), b.size(), src, now, f);
+  PvElectTag tag;
+  const bool tagOk = pvElectFrameGet(b.data(), b.size(), tag);
+  if (r == PVRX_FOREIGN && tagOk && pvRxTakeover(s, src, tag.term)) r = pvRxFrame(s, b.data(), b.size(), src, now, f);
+  if (pvRxAccepted(r)) s.term = tagOk ? tag.term : 0;
+  return r;
+}
+
+// ---------- Muster ----------
+struct Pattern {
+  const char* name;
+  double   mloss = 0.02, uloss = 0.005;   // Verlust je Empfänger
+  uint32_t delayMs = 15;                  // Laufzeit 1..delayMs, 1 % zehnmal so lang
+  double   crashPerH = 6;                 // Ausfall des Aktiven (Neustart nach 5..60 s)
+  double   holePerH = 0;                  // Funkloch je Knoten (0.2..holeMaxS)
+  double   holeMaxS = 0;
+  double   mrxPerH = 0;                   // einseitig: kein Multicast-Empfang 10..120 s
+  double   stallPerH = 0;                 // loop() hängt 100..stallMaxMs
+  uint32_t stallMaxMs = 0;
+  double   splitPerH = 0;                 // Zweiteilung 5..40 s
+};
+static const Pattern PATTERNS[] = {
+  { "ruhig" },
+  { "WLAN schlecht",     0.25, 0.05, 40 },
+  { "Funklöcher",        0.02, 0.005, 15, 6, 20, 2.5 },
+  { "Multicast einseitig", 0.05, 0.01, 15, 6, 0, 0, 10 },
+  { "loop() hängt",      0.02, 0.005, 15, 6, 0, 0, 0, 30, 2500 },
+  { "alles",             0.2, 0.05, 40, 10, 20, 5, 10, 30, 2500 },
+  { "Zweiteilung",       0.02, 0.005, 15, 2, 0, 0, 0, 0, 0, 6 },
+};
+static const int N_PATTERNS = sizeof(PATTERNS) / sizeof(PATTERNS[0]);
+
+typedef std::vector<std::pair<uint64_t, uint64_t>> Spans;
+static bool inSpan(const Spans& s, uint64_t t){
+  for (const auto& x : s) if (t >= x.first && t < x.second) return true;
+  return false;
+}
+
+// ---------- Simulation ----------
+struct Node {
+  uint32_t id, ip, off;                   // off: millis() = Simulationszeit + off
+  uint8_t  prio;
+  PvElect  e;
+  uint8_t  act = 0;
+  bool     up = true;
+  PvRxState rx;
+  uint32_t lastSeq = 0;
+  // Runde
+  bool     round = false, inFlight = false, fenceWait = false;
+  int      req = 0;
+  uint64_t nextRound = 0, roundT0 = 0, reqEnd = 0;
+  Spans    holes, mrx, stalls;
+  uint64_t fencedMs = 0; uint32_t fences = 0, claims = 0, yields = 0, takeovers = 0;   // über Neustarts
+  uint32_t ms(uint64_t t) const { return (uint32_t)(t + off); }
+};
+
+struct Ev {
+  uint64_t t; uint32_t ord;
+  uint8_t  type; int dst, src;
+  bool     mcast;
+  PayloadElect hb; int frame;
+  bool operator<(const Ev& o) const { return t != o.t ? t > o.t : ord > o.ord; }
+};
+enum : uint8_t { EV_LOOP = 0, EV_HB, EV_FRAME, EV_CRASH, EV_RESTART };
+
+struct Res {
+  uint32_t crashes = 0, rounds = 0, delayed = 0, overlaps = 0, frames = 0, switches = 0;
+  uint32_t claims = 0, yields = 0, fences = 0, clientRestarts = 0, clientTakeovers = 0, clientOld = 0;
+  uint64_t fencedMs = 0, minGap = UINT64_MAX;
+  std::vector<double> failover, client;   // s
+};
+
+static double pct(std::vector<double> v, double p){
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, (size_t)(p * v.size()))];
+}
+
+struct Sim {
+  const Pattern& p;
+  std::mt19937 rng;
+  std::uniform_real_distribution<double> U{0, 1};
+  std::vector<Node> n;
+  std::priority_queue<Ev> q;
+  uint32_t ord = 0;
+  std::vector<std::vector<uint8_t>> frames;
+  Spans splits;
+  PvRxState client;
+  // Wechselrichter: laufende Anfrage je Knoten
+  int      lastReqNode = -1;
+  uint64_t lastReqEnd = 0;
+  std::vector<uint64_t> busyUntil;
+  uint64_t crashAt = 0; bool crashOpen = false, clientOpen = false;
+  Res r;
+
+  Sim(const Pattern& pat, int nodes, unsigned seed) : p(pat), rng(seed) {
+    n.resize(nodes); busyUntil.assign(nodes, 0);
+    for (int i = 0; i < nodes; ++i){
+      Node& x = n[i];
+      x.id = 0x1000 + (uint32_t)(rng() & 0xFFF) * 16 + i;
+      x.ip = 0xC0A80110 + i;
+      x.prio = i == 0 ? 120 : 100;                           // einer bevorzugt, die anderen nach ID
+      x.off = i == 1 ? 0xFFFFFFFFu - 20000 : (uint32_t)rng();   // einer läuft gleich über
+      pvElectBegin(x.e, x.id, x.prio, x.ms(0));
+    }
+  }
+
+  void push(uint64_t t, uint8_t type, int dst, int src = -1, const PayloadElect* hb = nullptr, int frame = -1, bool mcast = false){
+    Ev e{}; e.t = t; e.ord = ord++; e.type = type; e.dst = dst; e.src = src; e.frame = frame; e.mcast = mcast;
+    if (hb) e.hb = *hb;
+    q.push(e);
+  }
+
+  Spans spans(double perH, double minS, double maxS, uint64_t end){
+    Spans s;
+    const int k = (int)(perH * end / HOUR_MS + U(rng));
+    for (int i = 0; i < k; ++i){
+      const uint64_t a = (uint64_t)(U(rng) * end);
+      s.push_back({ a, a + (uint64_t)((minS + (maxS - minS) * U(rng)) * 1000) });
+    }
+    return s;
+  }
+
+  bool radio(int i, uint64_t t) const { return n[i].up && !inSpan(n[i].holes, t); }
+  bool sameSide(int a, int b, uint64_t t) const { return (a & 1) == (b & 1) || !inSpan(splits, t); }
+  uint64_t delay(){
+    uint64_t d = 1 + (uint64_t)(U(rng) * p.delayMs);
+    return U(rng) < 0.01 ? d * 10 : d;
+  }
+
+  // Sender-Seite; ob es ankommt, entscheidet die Zustellung (Empfänger zu dem Zeitpunkt)
+  void send(int src, int dst, uint64_t t, bool mcast, uint8_t type, const PayloadElect* hb, int frame){
+    if (!radio(src, t) || U(rng) < (mcast ? p.mloss : p.uloss)) return;
+    push(t + delay(), type, dst, src, hb, frame, mcast);
+  }
+  bool delivered(const Ev& e) const {
+    if (e.dst >= (int)n.size()) return true;   // Client: Verlust schon beim Senden
+    if (!radio(e.dst, e.t) || !sameSide(e.src, e.dst, e.t)) return false;
+    return !(e.mcast && inSpan(n[e.dst].mrx, e.t));
+  }
+
+  void sendHb(int i, uint64_t t){
+    Node& x = n[i];
+    PayloadElect hb = pvElectHb(x.e, x.lastSeq, x.ms(t));
+    const uint32_t now = x.ms(t);
+    for (int j = 0; j < (int)n.size(); ++j){
+      if (j == i) continue;
+      send(i, j, t, true, EV_HB, &hb, -1);
+      for (uint8_t k = 0; k < x.e.n; ++k)
+        if (x.e.peer[k].ip == n[j].ip && now - x.e.peer[k].ms < PV_ELECT_DEAD_MS) send(i, j, t, false, EV_HB, &hb, -1);
+    }
+  }
+
+  void sendFrame(int i, uint64_t t){
+    Node& x = n[i];
+    frames.push_back(framePkt(++x.lastSeq, x.e));
+    const int k = (int)frames.size() - 1;
+    r.frames++;
+    for (int j = 0; j < (int)n.size(); ++j) if (j != i) send(i, j, t, true, EV_FRAME, nullptr, k);
+    if (radio(i, t) && U(rng) >= p.mloss) push(t + delay(), EV_FRAME, (int)n.size(), i, nullptr, k, true);
+  }
+
+  // Anfrage an den Wechselrichter (nur erreichbar mit Funk)
+  void request(int i, uint64_t t, uint64_t end){
+    if (!radio(i, t)) return;
+    for (int j = 0; j < (int)n.size(); ++j) if (j != i && busyUntil[j] > t) r.overlaps++;
+    busyUntil[i] = end;
+    if (lastReqNode >= 0 && lastReqNode != i){
+      r.switches++;
+      if (t >= lastReqEnd) r.minGap = std::min(r.minGap, t - lastReqEnd);
+      else r.minGap = 0;
+    }
+    if (crashOpen && lastReqNode != i){ r.failover.push_back((t - crashAt) / 1000.0); crashOpen = false; }
+    lastReqNode = i; lastReqEnd = end;
+  }
+
+  void loop(int i, uint64_t t){
+    Node& x = n[i];
+    if (!x.up) return;
+    for (const auto& s : x.stalls) if (t >= s.first && t < s.second){ push(s.second, EV_LOOP, i); return; }
+    const uint32_t now = x.ms(t);
+    const uint8_t a = x.act | (radio(i, t) ? pvElectTick(x.e, now) : pvElectLinkDown(x.e, now));   // Funkloch: WLAN getrennt
+    x.act = 0;
+    if (a & PVEA_YIELD){ x.round = false; x.inFlight = false; }   // poller.abort(), Verbindungen zu
+    if (a & PVEA_ACTIVE){
+      if (x.e.activeSeq > x.lastSeq) x.lastSeq = x.e.activeSeq;
+      x.nextRound = t; x.round = false;
+    }
+    if (a & PVEA_HB) sendHb(i, t);
+    if (x.e.state == PVEL_ACTIVE){
+      const bool may = pvElectMayPoll(x.e, now);
+      if (x.inFlight && t >= x.reqEnd){
+        x.inFlight = false;
+        if (++x.req == ROUND_REQ){ x.round = false; r.rounds++; sendFrame(i, t); }
+      }
+      if (!x.round && t >= x.nextRound){
+        if (may){ x.round = true; x.req = 0; x.roundT0 = t; x.nextRound = t + POLL_MS; x.fenceWait = false; }
+        else if (!x.fenceWait){ x.fenceWait = true; r.delayed++; }
+      }
+      if (x.round && !x.inFlight && may){
+        if (x.req && !x.fenceWait && t > x.reqEnd + 400){ r.delayed++; x.fenceWait = true; }   // Runde stand (Lease)
+        x.inFlight = true; x.reqEnd = t + 20 + (uint64_t)(U(rng) * 280);
+        request(i, t, x.reqEnd);
+      }
+    }
+    push(t + 5 + (uint64_t)(U(rng) * 10), EV_LOOP, i);
+  }
+
+  void crash(uint64_t t){
+    int a = -1;
+    for (int i = 0; i < (int)n.size(); ++i) if (n[i].up && n[i].e.state == PVEL_ACTIVE) a = i;
+    if (a < 0) return;                              // gerade Wahl: diesen Ausfall auslassen
+    Node& x = n[a];
+    keep(x, t);
+    x.up = false; x.round = x.inFlight = false; busyUntil[a] = 0;
+    r.crashes++; crashAt = t; crashOpen = clientOpen = true;
+    push(t + 5000 + (uint64_t)(U(rng) * 55000), EV_RESTART, a);
+  }
+  // Zähler eines Laufs sichern (Neustart setzt PvElect zurück)
+  void keep(Node& x, uint64_t t){
+    x.fencedMs += x.e.fencedMs + (x.e.fenced ? x.ms(t) - x.e.fenceAt : 0);
+    x.fences += x.e.fences; x.claims += x.e.claims; x.yields += x.e.yields; x.takeovers += x.e.takeovers;
+  }
+
+  Res run(uint64_t end){
+    for (int i = 0; i < (int)n.size(); ++i){
+      n[i].holes = spans(p.holePerH, 0.2, p.holeMaxS, end);
+      n[i].mrx = spans(p.mrxPerH, 10, 120, end);
+      n[i].stalls = spans(p.stallPerH, 0.1, p.stallMaxMs / 1000.0, end);
+      push((uint64_t)(U(rng) * 500), EV_LOOP, i);
+    }
+    splits = spans(p.splitPerH, 5, 40, end);
+    for (const auto& c : spans(p.crashPerH, 0, 0, end)) if (c.first > 20000) push(c.first, EV_CRASH, -1);
+    while (!q.empty() && q.top().t < end){
+      const Ev e = q.top(); q.pop();
+      switch (e.type){
+        case EV_LOOP: loop(e.dst, e.t); break;
+        case EV_CRASH: crash(e.t); break;
+        case EV_RESTART:{
+          Node& x = n[e.dst];
+          x.up = true; x.rx = PvRxState{}; x.lastSeq = 0; x.act = 0;
+          pvElectBegin(x.e, x.id, x.prio, x.ms(e.t));
+          push(e.t + 1, EV_LOOP, e.dst);
+        }break;
+        case EV_HB:{
+          if (!delivered(e)) break;
+          Node& x = n[e.dst];
+          x.act |= pvElectRx(x.e, e.hb, n[e.src].ip, x.ms(e.t));
+          if (x.e.state != PVEL_ACTIVE) x.round = x.inFlight = false;   // abgegeben: keine Anfragen mehr
+        }break;
+        case EV_FRAME:{
+          if (!delivered(e)) break;
+          const std::vector<uint8_t>& b = frames[e.frame];
+          if (e.dst == (int)n.size()){
+            const uint32_t before = client.takeovers;
+            const uint8_t k = clientRx(client, b, n[e.src].ip, (uint32_t)e.t);
+            r.clientRestarts += k == PVRX_RESTART;
+            r.clientOld += k == PVRX_OLD || k == PVRX_DUP;
+            r.clientTakeovers += client.takeovers - before;
+            if (pvRxAccepted(k) && clientOpen && e.t > crashAt){ r.client.push_back((e.t - crashAt) / 1000.0); clientOpen = false; }
+            break;
+          }
+          Node& x = n[e.dst];
+          if (x.e.state == PVEL_ACTIVE) break;
+          PvFrameV4 f;
+          if (pvRxAccepted(clientRx(x.rx, b, n[e.src].ip, x.ms(e.t))) && pvWireDecode(b.data(), b.size(), f) && f.seq > x.lastSeq) x.lastSeq = f.seq;
+        }break;
+      }
+    }
+    for (Node& x : n){
+      if (x.up) keep(x, end);
+      r.fencedMs += x.fencedMs; r.fences += x.fences; r.claims += x.claims; r.yields += x.yields;
+    }
+    return r;
+  }
+};
+
+// ---------- Prüfung ----------
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+struct Opt {
+  double hours = 6; int nodes = 3; unsigned seed = 1;
+  double sec = 60, loss = 0.1, kill = 12; int port = 47800;
+};
+
+static PayloadElect hbOf(uint32_t id, uint8_t prio, uint8_t state, uint32_t term, uint32_t active){
+  PayloadElect h{}; h.id = id; h.prio = prio; h.state = state; h.term = term; h.active = active;
+  return h;
+}
+
+static const Pattern PERFECT{ "ohne Störung", 0, 0, 2, 6 };
+
+static int cmdSelftest(const Opt& o){
+  // --- Anhang ---
+  {
+    PvElect e; pvElectBegin(e, 0x12345678, 130, 0); e.term = 7;
+    std::vector<uint8_t> b = framePkt(5, e), c = framePkt(5, e, true);
+    PvElectTag t{}, u{};
+    bool ok = pvElectFrameGet(b.data(), b.size(), t) && t.term == 7 && t.id == 0x12345678 && t.prio == 130;
+    ok &= pvElectFrameGet(c.data(), c.size(), u) && u.term == 7 && c.size() > b.size();
+    ok &= !pvElectFrameGet(b.data(), b.size() - 1, t);
+    std::vector<uint8_t> x = b; x[x.size() - 6] ^= 1;
+    ok &= !pvElectFrameGet(x.data(), x.size(), t);
+    e.term = 0; x = framePkt(5, e);
+    ok &= !pvElectFrameGet(x.data(), x.size(), t);            // ohne Amtszeit: kein gewählter Poller
+    PayloadElect h = hbOf(1, 2, PVEL_CLAIM, 3, 4), g{}; h.dig = 0x0102030405060708ull; h.hw = -5;
+    uint8_t w[PvWire<PayloadElect>::size];
+    ok &= pvWireEncode(h, w) == 36 && pvWireDecode(w, sizeof(w), g) && !memcmp(&g, &h, sizeof(g));
+    check(ok, "Anhang: Rundreise, mit Energie-Teilen, kurz, CRC, Amtszeit 0; Heartbeat");
+  }
+  // --- Rang ---
+  check(pvElectAbove(2, 1, 1, 1, 200, 9) && pvElectAbove(1, 120, 1, 1, 100, 9) && pvElectAbove(1, 100, 9, 1, 100, 8)
+        && !pvElectAbove(1, 100, 8, 1, 100, 8) && !pvElectAbove(1, 100, 8, 2, 0, 0), "Rang: Amtszeit, dann Prio, dann Knoten-ID");
+  // --- Abgeben ---
+  {
+    PvElect a, b; pvElectBegin(a, 10, 100, 0); pvElectBegin(b, 20, 100, 0);
+    a.state = b.state = PVEL_ACTIVE; a.term = 1; b.term = 2;
+    const uint8_t ra = pvElectRx(a, pvElectHb(b, 9, 100), 0xB, 100);
+    const uint8_t rb = pvElectRx(b, hbOf(10, 100, PVEL_ACTIVE, 1, 10), 0xA, 100);
+    bool ok = ra == (PVEA_YIELD | PVEA_FOLLOW) && a.state == PVEL_FOLLOW && a.activeId == 20 && a.activeIp == 0xB && a.activeSeq == 9;
+    ok &= rb == 0 && b.state == PVEL_ACTIVE && a.yields == 1;
+    PvElect c; pvElectBegin(c, 30, 100, 0); c.state = PVEL_CLAIM; c.term = 3;   // Bewerber gegen ranghöheren Bewerber
+    ok &= pvElectRx(c, hbOf(40, 100, PVEL_CLAIM, 3, 0), 0xC, 200) == 0 && c.state == PVEL_FOLLOW && c.activeMs == 200;
+    c.state = PVEL_ACTIVE; c.term = 3;   // Folgender kennt schon einen neueren Aktiven
+    ok &= pvElectRx(c, hbOf(50, 1, PVEL_FOLLOW, 3, 40), 0xD, 300) == 0 && c.state == PVEL_ACTIVE;
+    ok &= pvElectRx(c, hbOf(50, 1, PVEL_FOLLOW, 4, 40), 0xD, 300) == PVEA_YIELD && c.state == PVEL_FOLLOW;
+    PvElect d; pvElectBegin(d, 60, 100, 0); d.state = PVEL_CLAIM; d.term = 5;   // Bewerber, die einander nicht hören
+    PayloadElect rel = hbOf(70, 1, PVEL_FOLLOW, 5, 59); rel.aprio = 100;
+    ok &= pvElectRx(d, rel, 0xE, 400) == 0 && d.state == PVEL_CLAIM;          // 59 unter 60
+    PvElect g; pvElectBegin(g, 70, 1, 0);                                     // der Folgende meldet den ranghöchsten
+    pvElectRx(g, hbOf(60, 100, PVEL_CLAIM, 5, 60), 0xF, 400); pvElectRx(g, hbOf(61, 100, PVEL_CLAIM, 5, 61), 0xF, 410);
+    pvElectRx(g, hbOf(60, 100, PVEL_CLAIM, 5, 60), 0xF, 420);
+    rel = pvElectHb(g, 0, 430);
+    ok &= rel.active == 61 && rel.term == 5 && rel.aprio == 100 && pvElectRx(d, rel, 0xE, 430) == 0 && d.state == PVEL_FOLLOW;
+    ok &= pvElectHb(g, 0, 410 + PV_ELECT_DEAD_MS + 20).active == 0;           // nicht mehr gehört
+    check(ok, "Abgeben: ranghöherer Aktiver/Bewerber, auch über einen Folgenden gemeldet");
+  }
+  // --- Lease ---
+  {
+    PvElect a; pvElectBegin(a, 10, 100, 0); a.state = PVEL_ACTIVE; a.term = 1;
+    pvElectRx(a, hbOf(20, 100, PVEL_FOLLOW, 1, 10), 0xB, 1000);
+    bool ok = pvElectMayPoll(a, 1000 + PV_ELECT_LEASE_MS - 1) && !a.fenced;
+    ok &= !pvElectMayPoll(a, 1000 + PV_ELECT_LEASE_MS) && a.fenced && a.fences == 1;
+    pvElectRx(a, hbOf(20, 100, PVEL_FOLLOW, 1, 10), 0xB, 1000 + PV_ELECT_LEASE_MS + 100);
+    ok &= pvElectMayPoll(a, 1000 + PV_ELECT_LEASE_MS + 100) && !a.fenced && a.fencedMs == 100;
+    const uint32_t t = 1000 + PV_ELECT_LEASE_MS + 100;
+    ok &= !pvElectMayPoll(a, t + PV_ELECT_DEAD_MS - 1) && pvElectMayPoll(a, t + PV_ELECT_DEAD_MS);   // vergessen
+    PvElect f; pvElectBegin(f, 30, 100, 0);
+    ok &= !pvElectMayPoll(f, 5);                                // nur aktiv
+    check(ok, "Lease: jeden bekannten Knoten gehört, abgelaufen, wieder, vergessen");
+  }
+  // --- Standby und Überlauf von millis() ---
+  {
+    const uint32_t t0 = 0xFFFFFFFFu - 1500;
+    PvElect f; pvElectBegin(f, 5, 100, t0);
+    pvElectRx(f, hbOf(7, 100, PVEL_FOLLOW, 0, 0), 0xB, t0 + 10);
+    bool ok = !pvElectStandby(f, t0 + 20);                      // 7 rangiert höher
+    ok &= !pvElectStandby(f, t0 + 10 + PV_ELECT_DEAD_MS);        // niemand gehört, 7 nicht vergessen
+    ok &= pvElectStandby(f, t0 + 10 + PV_ELECT_FORGET_MS);
+    uint32_t now = t0, claimAt = 0, activeAt = 0;
+    for (; now != t0 + 3 * PV_ELECT_DEAD_MS + PV_ELECT_CLAIM_MS; now += 10){
+      if ((now - t0) % 1000 == 0) pvElectRx(f, hbOf(3, 50, PVEL_FOLLOW, 0, 0), 0xC, now);   // 3 rangiert tiefer
+      const uint8_t a = pvElectTick(f, now);
+      if ((a & PVEA_CLAIM) && !claimAt) claimAt = now;
+      if ((a & PVEA_ACTIVE) && !activeAt) activeAt = now;
+    }
+    // 7 schweigt ab t0+10: nach PV_ELECT_DEAD_MS vergessen, dann bewirbt sich 5
+    ok &= claimAt - (t0 + 10) >= PV_ELECT_DEAD_MS && claimAt - (t0 + 10) <= PV_ELECT_DEAD_MS + 20;
+    ok &= activeAt - claimAt >= PV_ELECT_CLAIM_MS && activeAt - claimAt <= PV_ELECT_CLAIM_MS + 10 && f.state == PVEL_ACTIVE && f.term == 1;
+    check(ok, "Standby: nur der ranghöchste, nur wer jemanden hört; Zeiten über den millis()-Überlauf");
+  }
+  // --- WLAN getrennt ---
+  {
+    PvElect a; pvElectBegin(a, 10, 100, 0); a.state = PVEL_ACTIVE; a.term = 1;
+    bool ok = pvElectLinkDown(a, 500) == PVEA_YIELD && a.state == PVEL_LISTEN && a.yields == 1;
+    ok &= pvElectLinkDown(a, 600) == 0 && a.yields == 1 && !pvElectMayPoll(a, 700);
+    ok &= !(pvElectTick(a, 600 + PV_ELECT_DEAD_MS - 10) & PVEA_CLAIM);          // erst zuhören
+    check(ok, "WLAN getrennt: abgeben, danach erst zuhören");
+  }
+  // --- Client: Übernahme ohne Neustart ---
+  {
+    PvRxState s;
+    PvElect a, b, c; pvElectBegin(a, 1, 100, 0); pvElectBegin(b, 2, 100, 0); pvElectBegin(c, 3, 100, 0);
+    a.term = 1; b.term = 2; c.term = 1;
+    bool ok = true;
+    for (uint32_t k = 1; k <= 3; ++k) ok &= clientRx(s, framePkt(k, a), 0xA, k * 1000) == PVRX_OK;
+    ok &= clientRx(s, framePkt(4, c), 0xC, 4000) == PVRX_FOREIGN;   // gleiche Amtszeit: nicht übernehmen
+    ok &= clientRx(s, framePkt(4, b), 0xB, 4100) == PVRX_OK && s.src == 0xB && s.term == 2 && s.takeovers == 1;
+    ok &= clientRx(s, framePkt(5, a), 0xA, 5000) == PVRX_FOREIGN;   // alter Aktiver
+    ok &= clientRx(s, framePkt(5, b), 0xB, 5100) == PVRX_OK && s.cnt[PVRX_RESTART] == 0 && s.cnt[PVRX_FOREIGN] == 2;
+    check(ok, "Client: Nachfolger mit höherer Amtszeit sofort, seq läuft weiter");
+  }
+  // --- Ring aus den Teilen des Aktiven ---
+  {
+    PvFillRing r;
+    auto part = [](uint32_t seq, int32_t day){ PayloadFillPart p{}; p.seq = seq; p.day = day; p.gen = seq; return p; };
+    pvFillPut(r, part(5, 1)); pvFillPut(r, part(3, 1)); pvFillPut(r, part(4, 1)); pvFillPut(r, part(4, 1)); pvFillPut(r, part(4, 2));
+    PayloadFillPart out[PV_FILL_PARTS];
+    bool ok = r.n == 4 && pvFillOldest(r) == 3 && pvFillParts(r, 4, out) == 2 && out[0].day == 1 && out[1].day == 2;
+    for (uint32_t s = 6; s < 6 + PV_FILL_RING; ++s) pvFillPut(r, part(s, 1));
+    ok &= r.n == PV_FILL_RING && pvFillOldest(r) == 6 + PV_FILL_RING - PV_FILL_RING;
+    pvFillPut(r, part(2, 1));                                  // älter als alles im vollen Ring
+    ok &= pvFillOldest(r) == 6 && !pvFillParts(r, 2, out);
+    check(ok, "Ring: Teile einsortiert, doppelte verworfen, voll: ältester fällt");
+  }
+  // --- Simulation ---
+  {
+    Sim s(PERFECT, 3, o.seed);
+    const Res r = s.run(HOUR_MS);
+    int act = 0; for (const Node& x : s.n) act += x.e.state == PVEL_ACTIVE;
+    const bool first = s.n[0].e.state == PVEL_ACTIVE || s.n[0].e.activeId == 0;   // prio 120 (außer nach seinem Ausfall)
+    char b[120]; snprintf(b, sizeof(b), "Sim %s: einer aktiv, %u Ausfälle, Übernahme max %.1f s", PERFECT.name, r.crashes, pct(r.failover, 1));
+    check(act == 1 && first && r.overlaps == 0 && r.crashes > 0 && pct(r.failover, 1) < (PV_ELECT_DEAD_MS + PV_ELECT_CLAIM_MS) / 1000.0 + 1, b);
+  }
+  for (int k = 0; k < N_PATTERNS; ++k){
+    const Pattern& p = PATTERNS[k];
+    const bool split = p.splitPerH > 0;
+    Sim s(p, 3, o.seed + k);
+    const Res r = s.run(6 * HOUR_MS);
+    char b[120];
+    snprintf(b, sizeof(b), "Sim %s: %u Ausfälle, überlappend %u%s, Übernahme p50 %.1f s", p.name, r.crashes, r.overlaps,
+             split && r.overlaps ? " (erwartet)" : "", pct(r.failover, 0.5));
+    check((split || r.overlaps == 0) && r.crashes > 10 && pct(r.failover, 0.5) < 8 && pct(r.client, 0.5) < 10, b);
+  }
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int cmdBench(const Opt& o){
+  printf("Poller-Wahl, %d Knoten, %.0f h je Muster | Heartbeat %u ms, Lease %u ms, tot %u ms, Bewerbung %u ms\n\n",
+         o.nodes, o.hours, PV_ELECT_HB_MS, PV_ELECT_LEASE_MS, PV_ELECT_DEAD_MS, PV_ELECT_CLAIM_MS);
+  printf("%-20s %6s %17s %17s %7s %8s %6s %8s %6s %7s %6s\n", "", "Ausf.", "Übernahme s", "Client s", "überl.",
+         "Abstand", "Lease", "gesperrt", "verz.", "Wechsel", "seq");
+  printf("%-20s %6s %17s %17s %7s %8s %6s %8s %6s %7s %6s\n", "", "", "p50/p95/max", "p50/p95/max", "", "min ms", "n", "s", "Runden", "", "zurück");
+  for (int k = 0; k < N_PATTERNS; ++k){
+    const Pattern& p = PATTERNS[k];
+    Sim s(p, o.nodes, o.seed + k);
+    const Res r = s.run((uint64_t)(o.hours * HOUR_MS));
+    printf("%-20s %6u %5.1f/%5.1f/%5.1f %5.1f/%5.1f/%5.1f %7u %8.0f %6u %8.1f %6u %7u %6u\n", p.name, r.crashes,
+           pct(r.failover, 0.5), pct(r.failover, 0.95), pct(r.failover, 1), pct(r.client, 0.5), pct(r.client, 0.95), pct(r.client, 1),
+           r.overlaps, r.minGap == UINT64_MAX ? 0.0 : (double)r.minGap, r.fences, r.fencedMs / 1000.0, r.delayed, r.switches, r.clientRestarts);
+  }
+  printf("\nÜbernahme: Ausfall des Aktiven bis zur ersten Anfrage des Nachfolgers; Client: bis zum ersten\n"
+         "angenommenen Frame (Runde dauert mit); überl.: Anfragen zweier Knoten gleichzeitig beim Wechselrichter;\n"
+         "Abstand: kleinster zwischen letzter Antwort des einen und erster Anfrage des anderen; Lease/gesperrt:\n"
+         "Aktiver ohne Lease (Anzahl, Dauer); verz.: Runden, die auf die Lease warteten; seq zurück: Nachfolger\n"
+         "hatte die letzten Frames verpasst, der Client nimmt ihn als Neustart an (Lücken-Ring neu)\n");
+  return 0;
+}
+
+// ---------- live: Prozesse über UDP ----------
+static const uint32_t LIVE_REQ_MS = 100;   // Anfrage des Aktiven an den Wechselrichter
+
+static uint32_t monoMs(){
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static int udpBind(uint16_t port){
+  int s = socket(AF_INET, SOCK_DGRAM, 0);
+  if (s < 0){ perror("socket"); return -1; }
+  sockaddr_in a{}; a.sin_family = AF_INET; a.sin_port = htons(port); a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(s, (sockaddr*)&a, sizeof(a)) < 0){ perror("bind"); close(s); return -1; }
+  return s;
+}
+
+static void udpSend(int s, uint16_t port, const uint8_t* d, size_t n){
+  sockaddr_in a{}; a.sin_family = AF_INET; a.sin_port = htons(port); a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sendto(s, d, n, 0, (sockaddr*)&a, sizeof(a));
+}
+
+// Heartbeat wie statsSendMsg(): Stats-Kopf + PayloadElect
+static size_t hbPkt(uint8_t* buf, const PayloadElect& h, uint32_t seq){
+  uint8_t pl[PvWire<PayloadElect>::size];
+  const size_t n = pvWireEncode(h, pl);
+  StatsHdr hd{ 0xCAFE, 1, STATS_ELECT, seq, (uint16_t)n, 0 };
+  hd.crc = pvstats_crc(hd, pl);
+  pvWireEncode(hd, buf);
+  memcpy(buf + STATS_HDR_WIRE, pl, n);
+  return STATS_HDR_WIRE + n;
+}
+
+// Ein Knoten (Kindprozess); "IP" eines Knotens ist hier sein Port
+static void nodeMain(int i, const Opt& o){
+  const int s = udpBind((uint16_t)(o.port + 1 + i));
+  if (s < 0) _exit(1);
+  std::mt19937 rng(o.seed * 7919u + (unsigned)getpid());
+  std::uniform_real_distribution<double> U(0, 1);
+  PvElect e; pvElectBegin(e, 0x100 + (uint32_t)i, 100, monoMs());
+  uint8_t act = 0; uint32_t statsSeq = 0, reqs = 0, nextReq = 0;
+  for (;;){
+    pollfd pf{ s, POLLIN, 0 };
+    poll(&pf, 1, 5);
+    uint8_t buf[256]; sockaddr_in from{}; socklen_t fl = sizeof(from);
+    ssize_t len;
+    while ((len = recvfrom(s, buf, sizeof(buf), MSG_DONTWAIT, (sockaddr*)&from, &fl)) > 0){
+      StatsHdr h; PayloadElect hb;
+      if (pvRxStats(buf, (size_t)len, h) != PVRX_OK || h.type != STATS_ELECT) continue;
+      if (!pvWireDecode(buf + STATS_HDR_WIRE, h.len, hb)) continue;
+      act |= pvElectRx(e, hb, ntohs(from.sin_port), monoMs());
+      fl = sizeof(from);
+    }
+    const uint32_t now = monoMs();
+    act |= pvElectTick(e, now);
+    if (act & PVEA_HB){
+      const size_t n = hbPkt(buf, pvElectHb(e, reqs, now), ++statsSeq);
+      for (int j = 0; j < o.nodes; ++j) if (j != i && U(rng) >= o.loss) udpSend(s, (uint16_t)(o.port + 1 + j), buf, n);   // "Multicast"
+      for (uint8_t k = 0; k < e.n; ++k)
+        if (now - e.peer[k].ms < PV_ELECT_DEAD_MS && U(rng) >= o.loss / 4) udpSend(s, (uint16_t)e.peer[k].ip, buf, n);
+    }
+    act = 0;
+    if (pvElectMayPoll(e, now) && (int32_t)(now - nextReq) >= 0){
+      uint8_t r[9] = { 'R' };
+      memcpy(r + 1, &e.id, 4); memcpy(r + 5, &e.term, 4);   // Host-Byteordnung, bleibt auf dem Rechner
+      udpSend(s, (uint16_t)o.port, r, sizeof(r));
+      nextReq = now + LIVE_REQ_MS; reqs++;
+    }
+  }
+}
+
+static pid_t spawn(int i, const Opt& o){
+  fflush(stdout);
+  const pid_t p = fork();
+  if (p == 0){ nodeMain(i, o); _exit(0); }
+  return p;
+}
+
+static int cmdLive(const Opt& o){
+  const int s = udpBind((uint16_t)o.port);
+  if (s < 0) return 1;
+  std::vector<pid_t> kid(o.nodes);
+  std::vector<uint32_t> restartAt(o.nodes, 0);
+  for (int i = 0; i < o.nodes; ++i) kid[i] = spawn(i, o);
+  const uint32_t t0 = monoMs(), end = t0 + (uint32_t)(o.sec * 1000);
+  uint32_t nextKill = t0 + (uint32_t)(o.kill * 1000), lastT = 0, killAt = 0, minGap = UINT32_MAX;
+  uint32_t reqs = 0, kills = 0, switches = 0, overlaps = 0, firstT = 0;
+  int last = -1;
+  bool open = false;
+  std::vector<double> fo;
+  while ((int32_t)(monoMs() - end) < 0){
+    pollfd pf{ s, POLLIN, 0 };
+    poll(&pf, 1, 5);
+    uint8_t buf[64]; ssize_t len;
+    while ((len = recv(s, buf, sizeof(buf), MSG_DONTWAIT)) == 9){
+      const uint32_t t = monoMs();
+      uint32_t id; memcpy(&id, buf + 1, 4);
+      const int i = (int)(id - 0x100);
+      if (i < 0 || i >= o.nodes || buf[0] != 'R') continue;
+      if (!reqs) firstT = t;
+      reqs++;
+      if (last >= 0 && i != last){
+        switches++;
+        minGap = std::min(minGap, t - lastT);
+        if (t - lastT < 2 * LIVE_REQ_MS) overlaps++;
+      }
+      if (open && i != last){ fo.push_back((t - killAt) / 1000.0); open = false; }
+      last = i; lastT = t;
+    }
+    const uint32_t now = monoMs();
+    for (int i = 0; i < o.nodes; ++i)
+      if (restartAt[i] && (int32_t)(now - restartAt[i]) >= 0){ restartAt[i] = 0; kid[i] = spawn(i, o); }
+    if ((int32_t)(now - nextKill) >= 0){
+      nextKill = now + (uint32_t)(o.kill * 1000);
+      if (last >= 0 && !restartAt[last] && now - lastT < 1000){
+        kill(kid[last], SIGKILL); waitpid(kid[last], nullptr, 0);
+        restartAt[last] = now + 5000; killAt = now; open = true; kills++;
+        printf("[%6.1f s] Knoten %d (aktiv) beendet\n", (now - t0) / 1000.0, last);
+      }
+    }
+  }
+  for (int i = 0; i < o.nodes; ++i) if (!restartAt[i]){ kill(kid[i], SIGKILL); waitpid(kid[i], nullptr, 0); }
+  printf("\n%d Knoten, %.0f s, Verlust %.0f %% (Unicast %.1f %%) | erste Anfrage nach %.1f s\n",
+         o.nodes, o.sec, o.loss * 100, o.loss * 25, reqs ? (firstT - t0) / 1000.0 : 0.0);
+  printf("Anfragen %u, Wechsel %u, kleinster Abstand beim Wechsel %u ms, überlappend %u\n",
+         reqs, switches, minGap == UINT32_MAX ? 0 : minGap, overlaps);
+  printf("Ausfälle %u, Übernahme p50 %.1f s, max %.1f s (%zu gemessen)\n", kills, pct(fo, 0.5), pct(fo, 1), fo.size());
+  return overlaps ? 1 : 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvelect selftest [--seed N] | bench [--hours H] [--nodes N] [--seed N]\n"
+                  "        live [--nodes N] [--sec S] [--loss P] [--kill S] [--port P] [--seed N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  Opt o;
+  for (int i = 2; i + 1 < argc; i += 2){
+    std::string k = argv[i];
+    if (k == "--hours") o.hours = atof(argv[i + 1]);
+    else if (k == "--nodes") o.nodes = atoi(argv[i + 1]);
+    else if (k == "--seed") o.seed = (unsigned)atoi(argv[i + 1]);
+    else if (k == "--sec") o.sec = atof(argv[i + 1]);
+    else if (k == "--loss") o.loss = atof(argv[i + 1]);
+    else if (k == "--kill") o.kill = atof(argv[i + 1]);
+    else if (k == "--port") o.port = atoi(argv[i + 1]);
+    else return usage();
+  }
+  if (o.nodes < 2 || o.nodes > PV_ELECT_PEERS + 1 || o.hours <= 0 || o.loss < 0 || o.loss >= 1) return usage();
+  if (cmd == "selftest") return cmdSelftest(o);
+  if (cmd == "bench") return cmdBench(o);
+  if (cmd == "live") return cmdLive(o);
+  return usage();
+}
@@ -0,0 +1,203 @@
+// ===================== tools/pvenergy.cpp =====================
+// Host-Prüfung der Festkomma-Energie-Integration (SolarDisplay/PvEnergy.h)
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvenergy tools/pvenergy.cpp
+//
+// Aufrufe:
+//   pvenergy verify [tage] [seed]   simulierter Monat: PvEnergy.h gegen exakte Referenz (__int128-Bruch)
+//                                   und gegen die alte double/float-Integration; Record v1/v2 Rundreise
+//   pvenergy bench  [ticks]         ns und Zyklen je Tick: int64 (neu) vs. double+float (alt)
+//
+// Exit-Code 0 = int64-Ergebnis stimmt exakt mit der Referenz überein.
+#include "../SolarDisplay/PvEnergy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  static inline uint64_t cycles(){ return __rdtsc(); }
+  #define HAVE_CYCLES 1
+#else
+  static inline uint64_t cycles(){ return 0; }
+  #define HAVE_CYCLES 0
+#endif
+
+static const char* CH_NAME[PVE_COUNT] = {"gen", "load", "impT1", "impT2", "exp"};
+
+// ---------- alte Integration (SolarDisplay.ino bis v4), nachgebaut ----------
+struct OldAgg { float e[PVE_COUNT]; };
+struct OldInteg { uint32_t lastMs = 0; int32_t pv = 0, grid = 0, batt = 0; };
+
+static void oldTick(OldInteg& s, OldAgg& day, OldAgg& mon, int32_t pvW, int32_t gridW, int32_t battW, uint32_t nowMs, bool t1){
+  if (s.lastMs == 0){ s.lastMs = nowMs; s.pv = pvW; s.grid = gridW; s.batt = battW; return; }
+  uint32_t dt = nowMs - s.lastMs; if (!dt){ s.pv = pvW; s.grid = gridW; s.batt = battW; return; }
+  s.lastMs = nowMs;
+  double pv0 = s.pv > 0 ? s.pv : 0, pv1 = pvW > 0 ? pvW : 0;
+  double ePv = ((pv0 + pv1) * 0.5) * (dt / 3600000.0);
+  double g0 = s.grid, g1 = gridW;
+  double exp0 = g0 > 0 ? g0 : 0, exp1 = g1 > 0 ? g1 : 0;
+  double imp0 = g0 < 0 ? -g0 : 0, imp1 = g1 < 0 ? -g1 : 0;
+  double eExp = ((exp0 + exp1) * 0.5) * (dt / 3600000.0);
+  double eImp = ((imp0 + imp1) * 0.5) * (dt / 3600000.0);
+  double l0 = s.pv - s.grid - s.batt; if (l0 < 0) l0 = 0;
+  double l1 = pvW - gridW - battW;    if (l1 < 0) l1 = 0;
+  double eLoad = ((l0 + l1) * 0.5) * (dt / 3600000.0);
+  for (OldAgg* a : {&day, &mon}){
+    a->e[PVE_GEN]  += ePv / 1000.0;
+    a->e[PVE_EXP]  += eExp / 1000.0;
+    a->e[PVE_LOAD] += eLoad / 1000.0;
+    if (eImp > 0) a->e[t1 ? PVE_IMP_T1 : PVE_IMP_T2] += eImp / 1000.0;
+  }
+  s.pv = pvW; s.grid = gridW; s.batt = battW;
+}
+
+// ---------- exakte Referenz ----------
+// Summe (P0+P1)*dt als __int128; kWh = Summe / 7.2e9 (Bruch, ohne Rundung)
+struct RefAgg { __int128 e[PVE_COUNT] = {0}; };
+
+static void refTick(RefAgg& a, int64_t p0[3], int64_t p1[3], uint32_t dt, bool t1){
+  auto pos = [](int64_t v){ return v > 0 ? v : 0; };
+  a.e[PVE_GEN]  += (__int128)(pos(p0[0]) + pos(p1[0])) * dt;
+  a.e[PVE_EXP]  += (__int128)(pos(p0[1]) + pos(p1[1])) * dt;
+  a.e[t1 ? PVE_IMP_T1 : PVE_IMP_T2] += (__int128)(pos(-p0[1]) + pos(-p1[1])) * dt;
+  a.e[PVE_LOAD] += (__int128)(pos(p0[0] - p0[1] - p0[2]) + pos(p1[0] - p1[1] - p1[2])) * dt;
+}
+
+static std::string i128(__int128 v){
+  if (v == 0) return "0";
+  bool neg = v < 0; if (neg) v = -v;
+  std::string s;
+  while (v){ s.insert(s.begin(), char('0' + (int)(v % 10))); v /= 10; }
+  return neg ? "-" + s : s;
+}
+
+// Referenz als kWh mit 9 Nachkommastellen (exakt gerundet)
+static std::string refKWh(__int128 e){
+  __int128 nano = (e * 1000000000 + PV_E_PER_KWH / 2) / PV_E_PER_KWH;
+  std::string s = i128(nano);
+  while (s.size() < 10) s.insert(s.begin(), '0');
+  return s.substr(0, s.size() - 9) + "." + s.substr(s.size() - 9);
+}
+
+// ---------- Simulation ----------
+// Tageskurve PV, Verbrauch mit Spitzen, Batterie gleicht teilweise aus; Tick-Abstand 40..160 ms
+struct Sim {
+  std::mt19937 rng;
+  uint64_t tMs = 0;
+  Sim(unsigned seed) : rng(seed) {}
+  void sample(int32_t& pv, int32_t& grid, int32_t& batt, uint32_t& dt, bool& t1){
+    dt = 40 + rng() % 121;
+    tMs += dt;
+    double hour = fmod(tMs / 3600000.0, 24.0);
+    int wday = (int)((tMs / 86400000ull + 3) % 7);   // Tag 0 = Mittwoch
+    double sun = (hour > 6 && hour < 20) ? sin((hour - 6) / 14.0 * M_PI) : 0;
+    pv = (int32_t)(9500 * sun * sun * (0.6 + 0.4 * (rng() % 1000) / 1000.0));
+    int32_t load = 300 + (int32_t)(rng() % 400) + ((rng() % 5000) == 0 ? 6000 : 0);
+    batt = pv > load ? (int32_t)((pv - load) / 2) : -(int32_t)((load - pv) / 3);
+    if (rng() % 3 == 0) batt = 0;
+    grid = pv - load - batt;                     // Export>0, Import<0
+    t1 = (wday >= 1 && wday <= 5) && hour >= 7 && hour < 18;
+  }
+};
+
+static int cmdVerify(int days, unsigned seed){
+  Sim sim(seed);
+  PvEnergyIntegrator integ;
+  PvEnergy mon{}; pvEnergyClear(mon);
+  OldInteg oi; OldAgg oday{}, omon{};
+  RefAgg ref;
+  int64_t prev[3] = {0, 0, 0}; bool havePrev = false;
+  uint64_t ticks = 0;
+  uint32_t nowMs = 0xFFFFFFFFu - 3600000u;   // millis()-Überlauf (49 Tage) nach 1 h mit abdecken
+
+  while (sim.tMs < (uint64_t)days * 86400000ull){
+    int32_t pv, grid, batt; uint32_t dt; bool t1;
+    sim.sample(pv, grid, batt, dt, t1);
+    nowMs += dt;
+    PvEnergy d;
+    if (pvEnergyStep(integ, pv, grid, batt, nowMs, t1, d)) pvEnergyAdd(mon, d);
+    oldTick(oi, oday, omon, pv, grid, batt, nowMs == 0 ? 1 : nowMs, t1);
+    int64_t cur[3] = {pv, grid, batt};
+    if (havePrev) refTick(ref, prev, cur, dt, t1);
+    prev[0] = pv; prev[1] = grid; prev[2] = batt; havePrev = true;
+    ++ticks;
+  }
+
+  printf("%d Tage, %llu Ticks\n", days, (unsigned long long)ticks);
+  printf("%-6s %22s %18s %18s %14s\n", "Kanal", "Referenz kWh", "int64 kWh", "alt float kWh", "Fehler alt Wh");
+  bool exact = true;
+  for (uint8_t i = 0; i < PVE_COUNT; ++i){
+    bool eq = (__int128)mon.e[i] == ref.e[i];
+    exact &= eq;
+    double refD = (double)ref.e[i] / (double)PV_E_PER_KWH;
+    printf("%-6s %22s %18.6f %18.6f %14.1f %s\n", CH_NAME[i], refKWh(ref.e[i]).c_str(),
+           (double)mon.e[i] / (double)PV_E_PER_KWH, omon.e[i], (omon.e[i] - refD) * 1000.0, eq ? "exakt" : "ABWEICHUNG");
+  }
+
+  // Record: v2 Rundreise exakt, v1 (float-Blob) wird auf 1 mWh genau übernommen
+  PvEnergyRec r; pvEnergyEncode(mon, r);
+  PvEnergy back; bool okRec = pvEnergyDecode((const uint8_t*)&r, sizeof(r), back) && memcmp(&back, &mon, sizeof(mon)) == 0;
+  PvEnergyKWh legacy = pvEnergyToKWh(mon);
+  PvEnergy fromLegacy; bool okLegacy = pvEnergyDecode((const uint8_t*)&legacy, sizeof(legacy), fromLegacy);
+  for (uint8_t i = 0; i < PVE_COUNT && okLegacy; ++i){
+    double diffWh = fabs((double)(fromLegacy.e[i] - mon.e[i]) / PV_E_PER_KWH * 1000.0);
+    double tolWh = fabs(pvKWh(mon.e[i])) * 1e-4 + 0.001;   // float-Auflösung des alten Blobs
+    okLegacy &= diffWh <= tolWh;
+  }
+  printf("Record v2 Rundreise: %s, v1-Blob Übernahme: %s\n", okRec ? "ok" : "FEHLER", okLegacy ? "ok" : "FEHLER");
+
+  bool ok = exact && okRec && okLegacy;
+  printf("%s\n", ok ? "OK" : "FEHLER");
+  return ok ? 0 : 1;
+}
+
+// ---------- Benchmark ----------
+static int cmdBench(uint32_t n){
+  std::vector<int32_t> pv(n), grid(n), batt(n); std::vector<uint32_t> dt(n); std::vector<uint8_t> t1(n);
+  Sim sim(7);
+  for (uint32_t i = 0; i < n; ++i){ bool b; sim.sample(pv[i], grid[i], batt[i], dt[i], b); t1[i] = b; }
+
+  auto run = [&](const char* name, auto&& tick){
+    uint32_t nowMs = 1;
+    auto t0 = std::chrono::steady_clock::now(); uint64_t c0 = cycles();
+    for (uint32_t i = 0; i < n; ++i){ nowMs += dt[i]; tick(i, nowMs); }
+    uint64_t c1 = cycles(); auto t1c = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1c - t0).count() / n;
+    if (HAVE_CYCLES) printf("%-22s %6.2f ns/Tick %7.1f Zyklen/Tick\n", name, ns, (double)(c1 - c0) / n);
+    else             printf("%-22s %6.2f ns/Tick\n", name, ns);
+  };
+
+  PvEnergyIntegrator integ; PvEnergy day{}, mon{};
+  run("int64 (PvEnergy.h)", [&](uint32_t i, uint32_t nowMs){
+    PvEnergy d;
+    if (pvEnergyStep(integ, pv[i], grid[i], batt[i], nowMs, t1[i], d)){ pvEnergyAdd(day, d); pvEnergyAdd(mon, d); }
+  });
+  OldInteg oi; OldAgg oday{}, omon{};
+  run("double+float (alt)", [&](uint32_t i, uint32_t nowMs){
+    oldTick(oi, oday, omon, pv[i], grid[i], batt[i], nowMs, t1[i]);
+  });
+  // Ergebnis benutzen, damit nichts wegoptimiert wird
+  printf("(Kontrolle: %.3f / %.3f kWh)\n", pvKWh(mon.e[PVE_GEN]), omon.e[PVE_GEN]);
+  printf("Hinweis: auf dem ESP32 (Xtensa, FPU nur single) läuft der double-Pfad in Soft-Float;\n"
+         "         die Host-Zahlen zeigen nur das Verhältnis der Ganzzahl-Arbeit.\n");
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvenergy verify [tage] [seed] | bench [ticks]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  if (cmd == "verify") return cmdVerify(argc > 2 ? atoi(argv[2]) : 31, argc > 3 ? (unsigned)atoi(argv[3]) : 1);
+  if (cmd == "bench")  return cmdBench(argc > 2 ? (uint32_t)atoi(argv[2]) : 10000000);
+  return usage();
+}
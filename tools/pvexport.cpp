@@ -0,0 +1,708 @@
+// ===================== tools/pvexport.cpp =====================
+// Host-Werkzeug zum Verlauf über TCP (SolarDisplay/PvExport.h): ganzen Verlauf holen, auf ein
+// Gerät zurückschreiben, nach CSV bzw. in Spaltendateien wandeln; Prüfung und Messung gegen
+// einen nachgebildeten NVS (Schlüssel wie im Sketch, Zähler je Zugriff).
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -pthread -o pvexport tools/pvexport.cpp
+//
+// Aufrufe:
+//   pvexport get <ip> [out.pvx] [--port 43212]    ganzen Verlauf holen (prüft CRC und Summe)
+//   pvexport put <ip> <in.pvx> [--port 43212]     auf ein Gerät schreiben (Rücksicherung, Ersatzgerät)
+//   pvexport csv <in.pvx> [dir]                   je Art eine CSV: day, week, month, year, dev<i>_day, dev<i>_month
+//   pvexport col <in.pvx> [dir]                   dasselbe als Spaltendateien (.pvc, s.u.)
+//   pvexport serve [--port 43212] [--years 10] [--devs 2] [--seed 1]
+//       Gerät nachgebildet (NVS im RAM mit Testverlauf), für get/put ohne Hardware
+//   pvexport selftest [--years 10] [--devs 2] [--seed 1]
+//       CRC32, Null-Läufe, Schlüssel wie im Sketch; Rundreise bitgleich (v1/v2/v3-Records,
+//       Stufen, Geräte, zufällig zerstückelt), gleicher Import schreibt nichts, laufender Tag und
+//       fremde Geräte übersprungen; jedes gekippte Byte und jeder Abbruch erkannt, geschrieben
+//       wird nie etwas anderes als die Quelle; NVS voll; über TCP (serve/get/put); CSV/Spalten
+//   pvexport bench [--years 10] [--devs 2] [--read-us 60] [--write-us 900] [--tcp-kbs 800] [--seed 1]
+//       Export/Import auf dem Host (MB/s), Bytes roh/Strom, NVS-Zugriffe und commit()s,
+//       danach Neuaufbau der Stufen; Vergleich mit Tag für Tag über saveDayToNVS und mit
+//       STATS_REQ_RANGE. --read-us/--write-us/--tcp-kbs: Annahmen für die Schätzung auf dem ESP32
+//
+// Spaltendatei (.pvc, angelehnt an Parquet): "PVC1", dann jede Spalte am Stück (Little Endian),
+// am Ende die Tabelle: je Spalte Name (16 Byte), Typ (1 = i32, 2 = u32, 3 = i64), Offset (u64),
+// Zeilen (u32); dann Spaltenzahl (u16), Länge der Tabelle (u32), "PVC1".
+// Energie in 1/2 mWs wie im Record (PvEnergy.h, 7.2e9 je kWh), Spitzen wie PvPeaks.
+#include "../SolarDisplay/PvExport.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static double nowUs(){
+  using namespace std::chrono;
+  return (double)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- NVS nachgebildet: Preferences-Schnittstelle mit commit(), Zähler ----------
+struct Nvs {
+  std::unordered_map<std::string, std::vector<uint8_t>> m;
+  unsigned long long lens = 0, reads = 0, writes = 0, commits = 0, wbytes = 0;
+  size_t   cap = SIZE_MAX;   // Einträge: voll -> putBytes liefert 0
+  size_t getBytesLength(const char* k){
+    lens++;
+    auto it = m.find(k);
+    return it == m.end() ? 0 : it->second.size();
+  }
+  size_t getBytes(const char* k, void* b, size_t n){
+    reads++;
+    auto it = m.find(k);
+    if (it == m.end() || it->second.size() > n) return 0;
+    memcpy(b, it->second.data(), it->second.size());
+    return it->second.size();
+  }
+  size_t putBytes(const char* k, const void* b, size_t n){
+    if (m.size() >= cap && !m.count(k)) return 0;
+    writes++; wbytes += n;
+    m[k].assign((const uint8_t*)b, (const uint8_t*)b + n);
+    return n;
+  }
+  void commit(){ commits++; }
+  void zero(){ lens = reads = writes = commits = wbytes = 0; }
+};
+
+// ---------- Testverlauf: ältere Jahre v1/v2 wie von alter Firmware, dann v3 mit Spitzen ----------
+static const int32_t TODAY = pvDayNum(2026, 10, 18);
+
+struct Hist {
+  int32_t  first = 0, last = 0;
+  uint32_t days = 0, devDays = 0;
+};
+
+static Hist genHistory(Nvs& s, int years, uint8_t devs, unsigned seed){
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> U(0, 1);
+  Hist h;
+  h.first = pvDayNum(2026 - years, 1, 1); h.last = TODAY;
+  PvRollupPrefs<Nvs> st{s};
+  PvRollup r;
+  char key[16];
+  std::vector<PvEnergy> devMon(devs);
+  uint32_t mon = 0;
+  for (int32_t n = h.first; n <= h.last; ++n){   // heute auch (Boot-Cache gesichert, Karussell)
+    int y, m, d; pvDayCivil(n, y, m, d);
+    const uint32_t id = pvRollupId(PVL_MONTH, n);
+    if (id != mon){
+      for (uint8_t i = 0; i < devs && mon; ++i){ pvExportKey(PVX_DEV_MON, i, mon, key, sizeof(key)); st.save(key, devMon[i]); pvEnergyClear(devMon[i]); }
+      mon = id;
+    }
+    if (U(rng) < 0.02) continue;               // Gerät aus
+    const double season = 0.55 - 0.45 * cos((m - 6.5) / 6.0 * 3.14159);
+    PvAgg a; pvAggClear(a);
+    auto kwh = [&](double v){ return (int64_t)(v * PV_E_PER_KWH) + (int64_t)(U(rng) * PV_E_PER_MWH); };
+    a.e[PVE_GEN] = kwh(38 * season * (0.3 + 0.7 * U(rng)));
+    a.e[PVE_LOAD] = kwh(8 + 6 * U(rng));
+    a.e[PVE_IMP_T1] = kwh(3 * U(rng)); a.e[PVE_IMP_T2] = kwh(4 * U(rng));
+    a.e[PVE_EXP] = kwh(20 * season * U(rng));
+    const uint32_t ts = (uint32_t)n * 86400u;
+    uint8_t b[PV_EREC_MAX]; size_t len;
+    if (y < 2026 - years + 2){                 // v1: 5 x float kWh
+      PvEnergyKWh f = pvEnergyToKWh(a); memcpy(b, &f, sizeof(f)); len = sizeof(f);
+    } else if (y < 2026 - years + 4){          // v2
+      PvEnergyRec rec; pvEnergyEncode(a, rec); memcpy(b, &rec, sizeof(rec)); len = sizeof(rec);
+    } else {
+      PvPeaks& p = a.pk;
+      p.n = 2600 + (uint32_t)(U(rng) * 280);
+      p.impW = (int32_t)(U(rng) * 9000); p.impTs = ts + (uint32_t)(U(rng) * 86400);
+      p.expW = (int32_t)(U(rng) * 8000 * season); p.expTs = ts + 43200 + (uint32_t)(U(rng) * 7200);
+      p.pvW = p.expW + 1500; p.pvTs = p.expTs - 600;
+      p.loadW = (int32_t)(U(rng) * 7000); p.loadTs = ts + (uint32_t)(U(rng) * 86400);
+      p.chgW = 3000; p.chgTs = ts + 36000; p.disW = 2500; p.disTs = ts + 72000;
+      p.socLo = 100 + (int32_t)(U(rng) * 100); p.socLoTs = ts + 21600; p.socHi = 1000; p.socHiTs = ts + 54000;
+      p.demW = p.impW / 2; p.demTs = p.impTs + 900; p.demT1W = p.demW; p.demT1Ts = p.demTs; p.demT2W = p.demW / 2; p.demT2Ts = ts + 3600;
+      len = pvAggEncode(a, b);
+    }
+    pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key));
+    s.putBytes(key, b, len);
+    PvAgg dec, none; pvAggDecode(b, len, dec); pvAggClear(none);
+    pvRollupDay(r, st, n, none, dec);          // Stufen wie im Sketch
+    h.days++;
+    for (uint8_t i = 0; i < devs; ++i){        // Energie je Gerät: nur PV, v2
+      PvEnergy e; pvEnergyClear(e);
+      e.e[PVE_GEN] = a.e[PVE_GEN] / devs + (int64_t)(U(rng) * 1000);
+      pvExportKey(PVX_DEV_DAY, i, pvRollupId(PVL_DAY, n), key, sizeof(key));
+      st.save(key, e);
+      pvEnergyAdd(devMon[i], e);
+      h.devDays++;
+    }
+  }
+  for (uint8_t i = 0; i < devs; ++i){ pvExportKey(PVX_DEV_MON, i, mon, key, sizeof(key)); st.save(key, devMon[i]); }
+  s.zero();
+  return h;
+}
+
+// ---------- Export in einen Puffer, Import aus einem Puffer ----------
+static std::vector<uint8_t> exportAll(Nvs& s, const Hist& h, uint8_t devs, uint16_t step = PV_EXPORT_STEP_KEYS,
+                                      PvExport* out = nullptr, uint32_t* calls = nullptr){
+  static PvExport x;
+  std::vector<uint8_t> v;
+  pvExportBegin(x, h.first, h.last, devs);
+  uint32_t c = 1;
+  while (!pvExportStep(x, s, step, [&](const uint8_t* p, size_t n){ v.insert(v.end(), p, p + n); return true; })) c++;
+  if (out) *out = x;
+  if (calls) *calls = c;
+  return v;
+}
+
+static PvImport importAll(Nvs& s, const std::vector<uint8_t>& v, int32_t today, uint8_t devs, std::mt19937* chop = nullptr){
+  static PvImport m;
+  pvImportBegin(m, today, devs);
+  size_t at = 0;
+  while (at < v.size() && !pvImportDone(m)){
+    size_t n = v.size() - at;
+    if (chop) n = std::min(n, (size_t)std::uniform_int_distribution<int>(1, 3000)(*chop));
+    at += pvImportFeed(m, s, v.data() + at, n);
+  }
+  pvImportClose(m);
+  return m;
+}
+
+// ---------- Datei ----------
+static bool readFile(const char* path, std::vector<uint8_t>& out){
+  FILE* f = fopen(path, "rb");
+  if (!f){ perror(path); return false; }
+  uint8_t b[65536]; size_t n;
+  while ((n = fread(b, 1, sizeof(b), f)) > 0) out.insert(out.end(), b, b + n);
+  fclose(f);
+  return true;
+}
+static bool writeFile(const char* path, const std::vector<uint8_t>& v){
+  FILE* f = fopen(path, "wb");
+  if (!f){ perror(path); return false; }
+  const bool ok = fwrite(v.data(), 1, v.size(), f) == v.size();
+  return fclose(f) == 0 && ok;
+}
+
+// ---------- Strom -> Records (Import in einen Sammler, Art/Gerät/id aus dem Schlüssel) ----------
+struct Rec { uint8_t kind, dev; uint32_t id; std::vector<uint8_t> blob; };
+
+struct Collect {
+  std::vector<Rec> recs;
+  size_t getBytesLength(const char*){ return 0; }
+  size_t getBytes(const char*, void*, size_t){ return 0; }
+  size_t putBytes(const char* k, const void* b, size_t n){
+    Rec r; r.dev = 0;
+    const size_t len = strlen(k);
+    switch (k[0]){
+      case 'D': r.kind = PVX_DAY; break;
+      case 'W': r.kind = PVX_WEEK; break;
+      case 'M': r.kind = PVX_MONTH; break;
+      case 'Y': r.kind = PVX_YEAR; break;
+      default:{
+        r.kind = k[0] == 'g' ? PVX_DEV_DAY : PVX_DEV_MON;
+        const size_t digits = r.kind == PVX_DEV_DAY ? 8 : 6;
+        r.dev = (uint8_t)atoi(std::string(k + 1, len - 1 - digits).c_str());
+        r.id = (uint32_t)strtoul(k + len - digits, nullptr, 10);
+      }
+    }
+    if (r.kind < PVX_DEV_DAY) r.id = (uint32_t)strtoul(k + 1, nullptr, 10);
+    r.blob.assign((const uint8_t*)b, (const uint8_t*)b + n);
+    recs.push_back(std::move(r));
+    return n;
+  }
+  void commit(){}
+};
+
+static bool decodeStream(const std::vector<uint8_t>& v, Collect& c, PvImport& m){
+  pvImportBegin(m, 0, 255);
+  pvImportFeed(m, c, v.data(), v.size());
+  pvImportClose(m);
+  if (m.err) fprintf(stderr, "Strom fehlerhaft: %s nach %u Blöcken\n", pvExportErrName(m.err), m.blocks);
+  return !m.err;
+}
+
+// ---------- CSV und Spaltendateien ----------
+static const char* KIND_NAME[PVX_KINDS] = { "day", "week", "month", "year", "day", "month" };
+static const char* CH_NAME[PVE_COUNT] = { "gen", "load", "imp_t1", "imp_t2", "exp" };
+
+static std::string tableName(uint8_t kind, uint8_t dev){
+  if (kind < PVX_DEV_DAY) return KIND_NAME[kind];
+  char b[32]; snprintf(b, sizeof(b), "dev%u_%s", (unsigned)dev, KIND_NAME[kind]);
+  return b;
+}
+static uint32_t recVersion(const std::vector<uint8_t>& b){ return b.size() == sizeof(PvEnergyKWh) ? 1 : b[2]; }
+static int32_t pkField(const PvPeaks& p, const PvWireField& f){ int32_t v; memcpy(&v, (const uint8_t*)&p + f.mem, 4); return v; }
+
+static std::map<std::string, std::vector<const Rec*>> tables(const Collect& c){
+  std::map<std::string, std::vector<const Rec*>> t;
+  for (const Rec& r : c.recs) t[tableName(r.kind, r.dev)].push_back(&r);
+  return t;
+}
+
+static bool writeCsv(const Collect& c, const std::string& dir, bool quiet = false){
+  const PvWireField* pf = PvWire<PvPeaks>::fields();
+  for (const auto& t : tables(c)){
+    const std::string path = dir + "/" + t.first + ".csv";
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f){ perror(path.c_str()); return false; }
+    fprintf(f, "id,date,ver");
+    for (uint8_t i = 0; i < PVE_COUNT; ++i) fprintf(f, ",%s_kWh", CH_NAME[i]);
+    for (size_t i = 0; i < PvWire<PvPeaks>::count; ++i) fprintf(f, ",%s", pf[i].name);
+    fprintf(f, "\n");
+    for (const Rec* r : t.second){
+      PvAgg a; pvAggDecode(r->blob.data(), r->blob.size(), a);
+      int y, m, d; pvDayCivil(pvRollupStart(pvExportLvl(r->kind), r->id), y, m, d);
+      fprintf(f, "%u,%04d-%02d-%02d,%u", r->id, y, m, d, recVersion(r->blob));
+      for (uint8_t i = 0; i < PVE_COUNT; ++i) fprintf(f, ",%.6f", (double)a.e[i] / PV_E_PER_KWH);
+      for (size_t i = 0; i < PvWire<PvPeaks>::count; ++i)
+        fprintf(f, pf[i].kind == PVW_INT ? ",%d" : ",%u", pf[i].kind == PVW_INT ? pkField(a.pk, pf[i]) : (uint32_t)pkField(a.pk, pf[i]));
+      fprintf(f, "\n");
+    }
+    if (fclose(f)){ perror(path.c_str()); return false; }
+    if (!quiet) printf("%-24s %6zu Zeilen\n", path.c_str(), t.second.size());
+  }
+  return true;
+}
+
+struct Col { std::string name; uint8_t type; std::vector<uint8_t> data; };
+enum : uint8_t { PVC_I32 = 1, PVC_U32, PVC_I64 };
+
+template<class T> static void colPush(Col& c, T v){ uint8_t b[sizeof(T)]; uint8_t* p = b; pvWirePut<T>(p, v); c.data.insert(c.data.end(), b, b + sizeof(T)); }
+
+static std::vector<uint8_t> pvcBuild(const std::vector<const Rec*>& rows){
+  const PvWireField* pf = PvWire<PvPeaks>::fields();
+  std::vector<Col> cols;
+  cols.push_back({ "id", PVC_U32, {} }); cols.push_back({ "day", PVC_I32, {} }); cols.push_back({ "ver", PVC_U32, {} });
+  for (uint8_t i = 0; i < PVE_COUNT; ++i) cols.push_back({ CH_NAME[i], PVC_I64, {} });
+  for (size_t i = 0; i < PvWire<PvPeaks>::count; ++i) cols.push_back({ pf[i].name, (uint8_t)(pf[i].kind == PVW_INT ? PVC_I32 : PVC_U32), {} });
+  for (const Rec* r : rows){
+    PvAgg a; pvAggDecode(r->blob.data(), r->blob.size(), a);
+    size_t k = 0;
+    colPush<uint32_t>(cols[k++], r->id);
+    colPush<int32_t>(cols[k++], pvRollupStart(pvExportLvl(r->kind), r->id));
+    colPush<uint32_t>(cols[k++], recVersion(r->blob));
+    for (uint8_t i = 0; i < PVE_COUNT; ++i) colPush<int64_t>(cols[k++], a.e[i]);
+    for (size_t i = 0; i < PvWire<PvPeaks>::count; ++i) colPush<int32_t>(cols[k++], pkField(a.pk, pf[i]));
+  }
+  std::vector<uint8_t> v = { 'P', 'V', 'C', '1' };
+  std::vector<uint8_t> foot;
+  for (const Col& c : cols){
+    uint8_t b[29] = {};
+    memcpy(b, c.name.c_str(), std::min<size_t>(c.name.size(), 16));
+    uint8_t* p = b + 16;
+    pvWirePut<uint8_t>(p, c.type); pvWirePut<uint64_t>(p, v.size()); pvWirePut<uint32_t>(p, (uint32_t)rows.size());
+    foot.insert(foot.end(), b, b + sizeof(b));
+    v.insert(v.end(), c.data.begin(), c.data.end());
+  }
+  uint8_t t[6]; uint8_t* p = t;
+  pvWirePut<uint16_t>(p, (uint16_t)cols.size()); pvWirePut<uint32_t>(p, (uint32_t)foot.size());
+  v.insert(v.end(), foot.begin(), foot.end());
+  v.insert(v.end(), t, t + sizeof(t));
+  v.insert(v.end(), { 'P', 'V', 'C', '1' });
+  return v;
+}
+
+// eine i64-Spalte aus einer .pvc lesen (Selbsttest, Beispiel für Leser)
+static bool pvcColumnI64(const std::vector<uint8_t>& v, const char* name, std::vector<int64_t>& out){
+  if (v.size() < 18 || memcmp(v.data(), "PVC1", 4) || memcmp(v.data() + v.size() - 4, "PVC1", 4)) return false;
+  const uint8_t* t = v.data() + v.size() - 10;
+  uint16_t cols; uint32_t flen;
+  pvWireGet<uint16_t>(t, cols); pvWireGet<uint32_t>(t, flen);
+  if (flen != cols * 29u || flen + 14 > v.size()) return false;
+  const uint8_t* f = v.data() + v.size() - 10 - flen;
+  for (uint16_t i = 0; i < cols; ++i, f += 29){
+    if (strncmp((const char*)f, name, 16)) continue;
+    const uint8_t* p = f + 16;
+    uint8_t type; uint64_t off; uint32_t rows;
+    pvWireGet<uint8_t>(p, type); pvWireGet<uint64_t>(p, off); pvWireGet<uint32_t>(p, rows);
+    if (type != PVC_I64 || off + 8ull * rows > v.size()) return false;
+    const uint8_t* d = v.data() + off;
+    out.resize(rows);
+    for (uint32_t r = 0; r < rows; ++r) pvWireGet<int64_t>(d, out[r]);
+    return true;
+  }
+  return false;
+}
+
+static bool writeCol(const Collect& c, const std::string& dir, bool quiet = false){
+  for (const auto& t : tables(c)){
+    const std::string path = dir + "/" + t.first + ".pvc";
+    const std::vector<uint8_t> v = pvcBuild(t.second);
+    if (!writeFile(path.c_str(), v)) return false;
+    if (!quiet) printf("%-24s %6zu Zeilen, %7zu Bytes\n", path.c_str(), t.second.size(), v.size());
+  }
+  return true;
+}
+
+// ---------- TCP ----------
+static bool sendAll(int fd, const uint8_t* p, size_t n){
+  while (n){
+    const ssize_t k = send(fd, p, n, MSG_NOSIGNAL);
+    if (k <= 0) return false;
+    p += k; n -= (size_t)k;
+  }
+  return true;
+}
+
+static int tcpConnect(const char* ip, uint16_t port){
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in a{}; a.sin_family = AF_INET; a.sin_port = htons(port);
+  if (fd < 0 || inet_pton(AF_INET, ip, &a.sin_addr) != 1 || connect(fd, (sockaddr*)&a, sizeof(a))){
+    perror(ip);
+    if (fd >= 0) close(fd);
+    return -1;
+  }
+  timeval tv{ PV_EXPORT_IDLE_MS / 1000, 0 };
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  return fd;
+}
+
+static bool tcpGet(const char* ip, uint16_t port, std::vector<uint8_t>& v){
+  const int fd = tcpConnect(ip, port);
+  if (fd < 0) return false;
+  bool ok = sendAll(fd, (const uint8_t*)"PVXE", 4);
+  uint8_t b[16384]; ssize_t n;
+  while (ok && (n = recv(fd, b, sizeof(b), 0)) > 0) v.insert(v.end(), b, b + n);
+  close(fd);
+  return ok;
+}
+
+static bool tcpPut(const char* ip, uint16_t port, const std::vector<uint8_t>& v, PvImportRes& res){
+  const int fd = tcpConnect(ip, port);
+  if (fd < 0) return false;
+  bool ok = sendAll(fd, (const uint8_t*)"PVXI", 4) && sendAll(fd, v.data(), v.size());
+  uint8_t b[PvWire<PvImportRes>::size]; size_t have = 0; ssize_t n;
+  while (ok && have < sizeof(b) && (n = recv(fd, b + have, sizeof(b) - have, 0)) > 0) have += (size_t)n;
+  close(fd);
+  return ok && pvWireDecode(b, have, res) && res.magic == PV_EXPORT_RES_MAGIC;
+}
+
+// Gerät nachgebildet: eine Verbindung nach der anderen, Export/Import wie histTick() im Sketch
+static void serveOne(int fd, Nvs& s, const Hist& h, uint8_t devs){
+  uint8_t cmd[4]; size_t have = 0; ssize_t n;
+  while (have < 4 && (n = recv(fd, cmd + have, 4 - have, 0)) > 0) have += (size_t)n;
+  if (have == 4 && !memcmp(cmd, "PVXE", 4)){
+    static PvExport x;
+    pvExportBegin(x, h.first, h.last, devs);
+    while (!pvExportStep(x, s, PV_EXPORT_STEP_KEYS, [&](const uint8_t* p, size_t k){ return sendAll(fd, p, k); })){}
+  } else if (have == 4 && !memcmp(cmd, "PVXI", 4)){
+    static PvImport m;
+    pvImportBegin(m, h.last, devs);
+    uint8_t b[1460];
+    while (!pvImportDone(m) && (n = recv(fd, b, sizeof(b), 0)) > 0) pvImportFeed(m, s, b, (size_t)n);
+    pvImportClose(m);
+    uint8_t r[PvWire<PvImportRes>::size];
+    sendAll(fd, r, pvWireEncode(pvImportResult(m), r));
+  }
+  close(fd);
+}
+
+static int tcpListen(uint16_t& port){
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1; setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in a{}; a.sin_family = AF_INET; a.sin_port = htons(port); a.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (sockaddr*)&a, sizeof(a)) || listen(fd, 2)){ perror("bind"); close(fd); return -1; }
+  socklen_t al = sizeof(a); getsockname(fd, (sockaddr*)&a, &al); port = ntohs(a.sin_port);
+  return fd;
+}
+
+// ---------- Optionen ----------
+struct Opt {
+  int years = 10, devs = 2; unsigned seed = 1; uint16_t port = PV_EXPORT_PORT;
+  double readUs = 60, writeUs = 900, tcpKBs = 800;
+  std::vector<std::string> args;
+};
+
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+// alle Schlüssel von b stehen genau so in a
+static bool subsetOf(const Nvs& b, const Nvs& a){
+  for (const auto& kv : b.m){ auto it = a.m.find(kv.first); if (it == a.m.end() || it->second != kv.second) return false; }
+  return true;
+}
+
+static int cmdSelftest(const Opt& o){
+  const uint8_t devs = (uint8_t)o.devs;
+  // --- Bausteine ---
+  check(pvCrc32(0, (const uint8_t*)"123456789", 9) == 0xCBF43926u && pvCrc32(pvCrc32(0, (const uint8_t*)"1234", 4), (const uint8_t*)"56789", 5) == 0xCBF43926u,
+        "CRC32 Prüfwert, fortgesetzt");
+  {
+    std::mt19937 rng(o.seed);
+    bool ok = true;
+    std::vector<uint8_t> in, out, back;
+    for (int k = 0; k < 3000 && ok; ++k){
+      const size_t n = k < 300 ? (size_t)k : (size_t)(rng() % 5000);
+      const double zp = (k % 5) / 4.0;
+      in.resize(n);
+      for (auto& b : in) b = (rng() % 1000) / 1000.0 < zp ? 0 : (uint8_t)(1 + rng() % 255);
+      out.resize(n + n / 128 + 1); back.resize(n + 1);
+      const size_t c = pvZrlEncode(in.data(), n, out.data());
+      size_t len = 0;
+      ok &= c <= n + n / 128 + 1 && pvZrlDecode(out.data(), c, back.data(), back.size(), len) && len == n && !memcmp(back.data(), in.data(), n);
+      ok &= !n || !pvZrlDecode(out.data(), c, back.data(), n - 1, len);   // zu klein: abgelehnt
+    }
+    check(ok, "Null-Läufe: Rundreise 0..5000 Bytes, Schranke n + n/128 + 1, Überlauf abgelehnt");
+    char a[16], b[16], c[16];
+    pvExportKey(PVX_DEV_DAY, 0, 20260305, a, sizeof(a)); pvExportKey(PVX_DEV_MON, 1, 202603, b, sizeof(b)); pvExportKey(PVX_WEEK, 0, 202610, c, sizeof(c));
+    check(!strcmp(a, "g020260305") && !strcmp(b, "h1202603") && !strcmp(c, "W202610") && !pvExportIdOk(PVX_MONTH, 202613) && !pvExportIdOk(PVX_DAY, 20260230),
+          "Schlüssel wie im Sketch (g/h je Gerät), ungültige ids");
+  }
+  // --- Rundreise ---
+  Nvs src;
+  const Hist h = genHistory(src, o.years, devs, o.seed);
+  PvExport xs;
+  const std::vector<uint8_t> v = exportAll(src, h, devs, PV_EXPORT_STEP_KEYS, &xs);
+  {
+    std::mt19937 rng(o.seed + 1);
+    const std::vector<uint8_t> v2 = exportAll(src, h, devs, 1 + rng() % 300);   // andere Schrittweite: gleicher Strom
+    Nvs dst;
+    const PvImport m = importAll(dst, v, 0, devs, &rng);
+    char b[120];
+    snprintf(b, sizeof(b), "Rundreise %d Jahre: %u Records bitgleich, %zu kB -> %zu kB", o.years, m.recs, (size_t)xs.rawBytes / 1024, v.size() / 1024);
+    check(v == v2 && !m.err && m.recs == src.m.size() && dst.m == src.m && m.commits == m.blocks && m.blocks == xs.blocks, b);
+    const PvImport again = importAll(dst, v, 0, devs);
+    check(!again.err && again.written == 0 && again.same == again.recs && !again.commits && dst.m == src.m, "gleicher Verlauf noch einmal: nichts geschrieben, kein commit()");
+  }
+  {
+    Nvs dst;
+    const PvImport m = importAll(dst, v, TODAY, 1);
+    char k[16];
+    bool ok = !m.err;
+    pvExportKey(PVX_DAY, 0, pvRollupId(PVL_DAY, TODAY), k, sizeof(k)); ok &= src.m.count(k) && !dst.m.count(k);
+    pvExportKey(PVX_DEV_DAY, 0, pvRollupId(PVL_DAY, TODAY), k, sizeof(k)); ok &= !dst.m.count(k);
+    pvExportKey(PVX_DEV_MON, 0, pvRollupId(PVL_MONTH, TODAY), k, sizeof(k)); ok &= !dst.m.count(k);
+    pvExportKey(PVX_DEV_DAY, 0, pvRollupId(PVL_DAY, TODAY - 1), k, sizeof(k)); ok &= !devs || dst.m.count(k) > 0;
+    size_t foreign = 0; for (const auto& kv : src.m) foreign += kv.first[1] != '0' && (kv.first[0] == 'g' || kv.first[0] == 'h');
+    ok &= m.skipped == (devs ? 3 : 1) + foreign && dst.m.size() == src.m.size() - m.skipped && subsetOf(dst, src);
+    check(ok, "laufender Tag/Gerätemonat und fremde Geräte übersprungen");
+  }
+  // --- Fehler ---
+  {
+    std::mt19937 rng(o.seed + 2);
+    bool ok = true;
+    int caught = 0, tries = 400;
+    for (int k = 0; k < tries; ++k){
+      std::vector<uint8_t> bad = v;
+      const size_t at = k < 64 ? (size_t)k : rng() % bad.size();   // Kopf und erster Block ganz, dann zufällig
+      bad[at] ^= (uint8_t)(1u << (rng() % 8));
+      Nvs dst;
+      const PvImport m = importAll(dst, bad, 0, devs);
+      caught += m.err != PVXE_OK;
+      ok &= subsetOf(dst, src);
+    }
+    char b[100]; snprintf(b, sizeof(b), "gekipptes Bit: %d/%d erkannt, nie etwas anderes geschrieben", caught, tries);
+    check(ok && caught == tries, b);
+    ok = true; caught = 0;
+    for (int k = 0; k < 200; ++k){
+      const std::vector<uint8_t> cut(v.begin(), v.begin() + (k < 20 ? k : rng() % v.size()));
+      Nvs dst;
+      const PvImport m = importAll(dst, cut, 0, devs);
+      caught += m.err != PVXE_OK;
+      ok &= subsetOf(dst, src);
+    }
+    check(ok && caught == 200, "Abbruch an beliebiger Stelle erkannt, geschriebene Blöcke gültig");
+    Nvs full; full.cap = 1000;
+    const PvImport m = importAll(full, v, 0, devs);
+    check(m.err == PVXE_STORE && full.m.size() == 1000 && subsetOf(full, src), "NVS voll: Fehler, bis dahin geschrieben");
+    std::vector<uint8_t> other = v; other[4] = PV_EXPORT_VERSION + 1;
+    Nvs dst;
+    check(importAll(dst, other, 0, devs).err == PVXE_VERSION && dst.m.empty(), "andere Version: nichts geschrieben");
+  }
+  // --- TCP ---
+  {
+    uint16_t port = 0;
+    const int lfd = tcpListen(port);
+    Nvs dev2;
+    std::thread srv([&]{
+      for (int i = 0; i < 2; ++i){
+        const int fd = accept(lfd, nullptr, nullptr);
+        if (fd >= 0) serveOne(fd, i == 0 ? src : dev2, h, devs);
+      }
+    });
+    std::vector<uint8_t> got;
+    PvImportRes res{};
+    const bool okGet = tcpGet("127.0.0.1", port, got);
+    const bool okPut = tcpPut("127.0.0.1", port, got, res);
+    srv.join(); close(lfd);
+    char k[16]; pvExportKey(PVX_DAY, 0, pvRollupId(PVL_DAY, TODAY), k, sizeof(k));
+    check(okGet && got == v && okPut && res.err == PVXE_OK && res.recs == src.m.size() && res.commits == res.blocks &&
+          dev2.m.size() == src.m.size() - res.skipped && subsetOf(dev2, src) && !dev2.m.count(k),
+          "TCP: get, put auf ein leeres Gerät (ohne den laufenden Tag)");
+  }
+  // --- CSV / Spalten ---
+  {
+    Collect c; PvImport m;
+    bool ok = decodeStream(v, c, m) && c.recs.size() == src.m.size();
+    char dir[] = "/tmp/pvexportXXXXXX";
+    ok &= mkdtemp(dir) != nullptr && writeCsv(c, dir, true) && writeCol(c, dir, true);
+    std::vector<uint8_t> f; std::vector<int64_t> gen;
+    ok &= readFile((std::string(dir) + "/day.pvc").c_str(), f) && pvcColumnI64(f, "gen", gen);
+    int64_t sum = 0, ref = 0;
+    for (int64_t g : gen) sum += g;
+    for (const auto& kv : src.m) if (kv.first[0] == 'D'){ PvAgg a; pvAggDecode(kv.second.data(), kv.second.size(), a); ref += a.e[PVE_GEN]; }
+    ok &= gen.size() == h.days && sum == ref;
+    for (const auto& t : tables(c)){ remove((std::string(dir) + "/" + t.first + ".csv").c_str()); remove((std::string(dir) + "/" + t.first + ".pvc").c_str()); }
+    rmdir(dir);
+    check(ok, "CSV und Spalten je Art, Spalte gen = Summe der Tagesrecords");
+  }
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int cmdBench(const Opt& o){
+  const uint8_t devs = (uint8_t)o.devs;
+  Nvs src;
+  const Hist h = genHistory(src, o.years, devs, o.seed);
+  printf("Verlauf %d Jahre, %u Geräte: %u Tage, %zu Records gesamt (Stufen, Geräte) | Block %u Bytes\n\n",
+         o.years, devs, h.days, src.m.size(), PV_EXPORT_BLOCK);
+  // Export
+  PvExport x; uint32_t calls = 0;
+  const int iter = 5;
+  std::vector<uint8_t> v;
+  double t0 = nowUs();
+  for (int i = 0; i < iter; ++i) v = exportAll(src, h, devs, PV_EXPORT_STEP_KEYS, &x, &calls);
+  const double exUs = (nowUs() - t0) / iter;
+  src.zero(); exportAll(src, h, devs);
+  const unsigned long long exLookups = src.lens + src.reads;
+  printf("Export:  %u Schlüssel, %u Records, %u Blöcke, %u Aufrufe aus loop()\n", x.keys, x.recs, x.blocks, calls);
+  printf("         roh %.1f kB -> Strom %.1f kB (%.0f %%), Host %.1f ms (%.0f MB/s Strom)\n",
+         x.rawBytes / 1024.0, v.size() / 1024.0, 100.0 * v.size() / x.rawBytes, exUs / 1000, v.size() / exUs);
+  // Import leer, dann gleich
+  Nvs dst;
+  t0 = nowUs();
+  PvImport m = importAll(dst, v, TODAY, devs);
+  const double imUs = nowUs() - t0;
+  const unsigned long long imLookups = dst.lens + dst.reads, imWrites = dst.writes, imCommits = dst.commits;
+  printf("Import:  leer %u geschrieben, %u übersprungen, %llu commit() statt %u, Host %.1f ms (%.0f MB/s)\n",
+         m.written, m.skipped, imCommits, m.written, imUs / 1000, v.size() / imUs);
+  dst.zero();
+  m = importAll(dst, v, TODAY, devs);
+  printf("         gleicher Verlauf noch einmal: %u geschrieben, %u gleich\n", m.written, m.same);
+  // danach Stufen aus den Tagen (Sketch: Neuaufbau aus loop())
+  dst.zero();
+  PvRollupPrefs<Nvs> st{dst}; PvRollup rb;
+  pvRollupRebuildStart(rb, h.first, h.last);
+  while (!pvRollupRebuildStep(rb, st, PV_ROLLUP_STEP_DAYS)){}
+  const unsigned long long rbOps = dst.lens + dst.reads, rbWrites = dst.writes;
+  printf("         Neuaufbau Stufen danach: %llu Lesen, %llu Schreiben\n", rbOps, rbWrites);
+  // Tag für Tag über saveDayToNVS (Karussell/STATS_DAY): Tag lesen + schreiben, 3 Stufen, Digest
+  Nvs day;
+  {
+    PvRollupPrefs<Nvs> sd{day}; PvRollup r;
+    const uint8_t dig[8] = {};
+    for (const auto& kv : src.m){
+      if (kv.first[0] != 'D') continue;
+      PvAgg a, old; pvAggDecode(kv.second.data(), kv.second.size(), a);
+      sd.load(kv.first.c_str(), old);
+      sd.save(kv.first.c_str(), a);
+      pvRollupDay(r, sd, pvRollupStart(PVL_DAY, (uint32_t)atoi(kv.first.c_str() + 1)), old, a);
+      day.putBytes("dig", dig, sizeof(dig));
+    }
+  }
+  printf("Tag für Tag (saveDayToNVS): %u Tage, %llu Lesen, %llu Schreiben, %llu commit()\n\n",
+         h.days, day.lens + day.reads, day.writes, day.writes);
+  // Schätzung ESP32
+  const double tcpS = v.size() / (o.tcpKBs * 1024.0);
+  const double exS = exLookups * o.readUs / 1e6 + tcpS;
+  const double imS = imLookups * o.readUs / 1e6 + imWrites * o.writeUs / 1e6 + tcpS;
+  const double rbS = rbOps * o.readUs / 1e6 + rbWrites * o.writeUs / 1e6;
+  const double dayS = (day.lens + day.reads) * o.readUs / 1e6 + day.writes * o.writeUs / 1e6;
+  const double udpS = (h.days + 12.0 * o.years) * (2e-3 + 2 * o.readUs / 1e6);   // delay(2) je Paket
+  printf("Schätzung ESP32 (NVS lesen %.0f µs, schreiben %.0f µs, TCP %.0f kB/s):\n", o.readUs, o.writeUs, o.tcpKBs);
+  printf("  Export über TCP                 %6.1f s  (NVS %.1f s, Übertragung %.1f s)\n", exS, exS - tcpS, tcpS);
+  printf("  Import über TCP auf leeres Gerät %5.1f s  + Neuaufbau Stufen im Hintergrund %.1f s\n", imS, rbS);
+  printf("  Tag für Tag über saveDayToNVS   %6.1f s\n", dayS);
+  printf("  STATS_REQ_RANGE (UDP, je Tag/Monat ein Paket, delay(2)) %.1f s, ohne Quittung\n", udpS);
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvexport get <ip> [out.pvx] | put <ip> <in.pvx> | csv <in.pvx> [dir] | col <in.pvx> [dir] [--port N]\n"
+                  "         serve [--port N] [--years N] [--devs N] [--seed N]\n"
+                  "         selftest [--years N] [--devs N] [--seed N]\n"
+                  "         bench [--years N] [--devs N] [--read-us US] [--write-us US] [--tcp-kbs KB] [--seed N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  const std::string cmd = argv[1];
+  Opt o;
+  for (int i = 2; i < argc; ++i){
+    const std::string k = argv[i];
+    if (k.rfind("--", 0) != 0){ o.args.push_back(k); continue; }
+    if (i + 1 >= argc) return usage();
+    const char* v = argv[++i];
+    if (k == "--years") o.years = atoi(v);
+    else if (k == "--devs") o.devs = atoi(v);
+    else if (k == "--seed") o.seed = (unsigned)atoi(v);
+    else if (k == "--port") o.port = (uint16_t)atoi(v);
+    else if (k == "--read-us") o.readUs = atof(v);
+    else if (k == "--write-us") o.writeUs = atof(v);
+    else if (k == "--tcp-kbs") o.tcpKBs = atof(v);
+    else return usage();
+  }
+  if (o.years < 1 || o.years > 60 || o.devs < 0 || o.devs > 9) return usage();
+  if (cmd == "selftest") return cmdSelftest(o);
+  if (cmd == "bench") return cmdBench(o);
+  if (cmd == "serve"){
+    Nvs s;
+    const Hist h = genHistory(s, o.years, (uint8_t)o.devs, o.seed);
+    const int lfd = tcpListen(o.port);
+    if (lfd < 0) return 1;
+    printf("Gerät nachgebildet auf Port %u: %zu Records, %d Jahre, %d Geräte\n", o.port, s.m.size(), o.years, o.devs);
+    fflush(stdout);
+    for (;;){
+      const int fd = accept(lfd, nullptr, nullptr);
+      if (fd < 0) continue;
+      const size_t before = s.m.size();
+      serveOne(fd, s, h, (uint8_t)o.devs);
+      printf("Verbindung fertig: %zu Records (vorher %zu), %llu geschrieben, %llu commit()\n", s.m.size(), before, s.writes, s.commits);
+      fflush(stdout);
+    }
+  }
+  if (cmd == "get" && !o.args.empty()){
+    std::vector<uint8_t> v;
+    const double t0 = nowUs();
+    if (!tcpGet(o.args[0].c_str(), o.port, v)) return 1;
+    const double us = nowUs() - t0;
+    Collect c; PvImport m;
+    if (!decodeStream(v, c, m)) return 1;
+    printf("%zu Records, %u Blöcke, %zu Bytes in %.2f s\n", c.recs.size(), m.blocks, v.size(), us / 1e6);
+    return o.args.size() > 1 && !writeFile(o.args[1].c_str(), v) ? 1 : 0;
+  }
+  if (cmd == "put" && o.args.size() == 2){
+    std::vector<uint8_t> v;
+    if (!readFile(o.args[1].c_str(), v)) return 1;
+    Collect c; PvImport m;
+    if (!decodeStream(v, c, m)) return 1;   // erst prüfen, dann senden
+    PvImportRes r{};
+    if (!tcpPut(o.args[0].c_str(), o.port, v, r)){ fprintf(stderr, "keine Antwort\n"); return 1; }
+    printf("%s: %u Records, %u geschrieben, %u gleich, %u übersprungen, %u commit()\n",
+           pvExportErrName(r.err), r.recs, r.written, r.same, r.skipped, r.commits);
+    return r.err ? 1 : 0;
+  }
+  if ((cmd == "csv" || cmd == "col") && !o.args.empty()){
+    std::vector<uint8_t> v;
+    if (!readFile(o.args[0].c_str(), v)) return 1;
+    Collect c; PvImport m;
+    if (!decodeStream(v, c, m)) return 1;
+    const std::string dir = o.args.size() > 1 ? o.args[1] : ".";
+    mkdir(dir.c_str(), 0755);
+    return (cmd == "csv" ? writeCsv(c, dir) : writeCol(c, dir)) ? 0 : 1;
+  }
+  return usage();
+}
@@ -0,0 +1,482 @@
+// ===================== tools/pvfill.cpp =====================
+// Host-Simulation Energie je Frame (SolarDisplay/PvFill.h): der Poller integriert wie im Sketch
+// (integrateTick() aus loop(), neue Leistungen je Poll-Runde), schließt mit jedem Frame einen
+// Teil ab und hängt ihn an; N Clients empfangen die echten Frame-Bytes (pvRxFrame(), Zeit- und
+// Energie-Anhang) mit Verlustmustern je Client, fragen Lücken mit STATS_FILL_REQ nach und
+// buchen die Teile wie fillApply() (heute in die Akkus, frühere Tage in den Record).
+// Start 22:00 am Monatsletzten: Tages- und Monatswechsel liegen in der Simulation, die Uhr der
+// Clients geht dem Poller um bis zu 30 ms vor (PvClock.h). Verlorene Frames am Tageswechsel:
+// gestern kommt danach aus dem Karussell (hier: Record des Pollers nach 10 s).
+// Zum Vergleich je Client die bisherige eigene Integration (Leistung des letzten Frames).
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvfill tools/pvfill.cpp
+//
+// Aufrufe:
+//   pvfill selftest [--seed 1]
+//       Anhang (Rundreise, kaputt, fehlt), Lückenfenster (nachfragen, erledigen, zu alt,
+//       Neustart), Antwort-Pakete (Teile eines Frames nie getrennt); Simulation je 10 Clients:
+//       Einzelverluste, WLAN-Ausfälle 1..20 min, Ausfall über Mitternacht, verlorene Antworten
+//       -> Tag, Monat und Records bitgleich mit dem Poller; Ausfall länger als der Ring ->
+//       verlorene Frames gezählt, Differenz genau deren Teile, über Mitternacht gestern danach
+//       aus dem Karussell
+//   pvfill bench [--clients 10] [--hours 4] [--seed 1]
+//       je Verlustmuster: Frames verpasst/nachgeholt/verloren, Anfragen und Antwort-Pakete,
+//       Abweichung heute (Wh, max über die Clients) eigene Integration gegen Teile
+#include "pvhost.h"
+#include "../SolarDisplay/PvFill.h"
+#include "../SolarDisplay/PvRx.h"
+#include "../SolarDisplay/PvClock.h"
+#include "../SolarDisplay/PvRollup.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <random>
+#include <algorithm>
+#include <math.h>
+
+static const uint32_t FRAME_MS = 30000;     // POLL_INTERVAL_MS
+static const uint32_t LOOP_MS  = 100;       // Integration aus loop()
+static const uint32_t HOUR_MS  = 3600000u;
+static const int32_t  DAY0 = pvDayNum(2026, 10, 31);
+static const uint64_t T0_MS = ((uint64_t)DAY0 * 86400 + 22 * 3600) * 1000;   // 22:00 (Ortszeit = UTC hier)
+static const size_t   UDP_OVERHEAD = 28;
+
+static bool same(const PvEnergy& a, const PvEnergy& b){ return memcmp(a.e, b.e, sizeof(a.e)) == 0; }
+static double wh(int64_t e){ return (double)e / (PV_E_PER_KWH / 1000); }
+
+// Tag/Monat zu Unix-ms (Ortszeit = UTC)
+static int32_t dayOf(uint64_t ms){ return (int32_t)(ms / 86400000ull); }
+static bool t1At(uint64_t ms){ const uint32_t h = (uint32_t)(ms / HOUR_MS % 24); return h >= 7 && h < 20; }
+
+// ---------- Verlustmuster ----------
+struct Pattern {
+  const char* name;
+  double iid = 0;                       // Einzelverlust je Paket
+  int bursts = 0;                       // WLAN-Ausfälle (beide Richtungen)
+  uint32_t burstMin = 0, burstMax = 0;  // Dauer in ms
+  bool midnight = false;                // ein Ausfall über Mitternacht
+  double replyLoss = 0;                 // zusätzlich für STATS_FILL / STATS_FILL_REQ
+};
+
+// ---------- Netz ----------
+struct Msg { int to; bool frame; uint8_t type; std::vector<uint8_t> b; };   // to: -1 = Poller
+
+// ---------- Client ----------
+struct Client {
+  std::vector<std::pair<uint64_t, uint64_t>> down;   // Ausfälle [von, bis) Poller-Zeit
+  uint32_t skew = 0;                                 // Uhr voraus (ms)
+  PvRxState rx;
+  PvFillClient fill;
+  bool fillOn = false;
+  int32_t curDay = 0, fillFinal = 0;
+  uint32_t lostMark = 0, pastMark = 0;
+  int32_t seenDay = 0, gapDay = 0;                   // eigener Tag beim letzten Frame / vor der Lücke
+  PvEnergy dayAgg, monthAgg;
+  std::map<int32_t, PvEnergy> rec;                   // NVS-Records
+  std::set<std::pair<uint32_t, int32_t>> applied;    // gebuchte Teile (seq, Tag)
+  uint64_t tailAt = 0; int32_t tailDay = 0;          // Karussell-Reparatur fällig
+  // bisher: eigene Integration
+  PvEnergyIntegrator integ;
+  PvEnergy oldDay;
+  int32_t oldPv = 0, oldGrid = 0, oldBatt = 0;
+  bool haveFrame = false;
+  uint64_t reqPkts = 0, reqBytes = 0;
+  Client(){ pvEnergyClear(dayAgg); pvEnergyClear(monthAgg); pvEnergyClear(oldDay); }
+  bool isDown(uint64_t t) const { for (auto& d : down) if (t >= d.first && t < d.second) return true; return false; }
+};
+
+struct Sim {
+  std::mt19937 rng;
+  Pattern pat;
+  uint64_t t = T0_MS;
+  // Poller
+  PvEnergyIntegrator integ;
+  PvEnergy dayAgg, monthAgg;
+  std::map<int32_t, PvEnergy> rec;
+  PvFillRing ring;
+  std::vector<PayloadFillPart> all;       // jeder Teil (Wahrheit)
+  uint32_t seq = 0;
+  int32_t curDay = DAY0;
+  int32_t pvW = 0, gridW = 0, battW = 0;
+  uint64_t fillPkts = 0, fillBytes = 0;
+  uint64_t calm = 0;
+  std::vector<Client> c;
+  std::multimap<uint64_t, Msg> q;
+
+  Sim(unsigned seed, const Pattern& p, int n, uint32_t hours) : rng(seed), pat(p), c(n) {
+    pvEnergyClear(dayAgg); pvEnergyClear(monthAgg);
+    std::uniform_int_distribution<uint32_t> skew(0, 30);
+    const uint64_t end = T0_MS + (uint64_t)hours * HOUR_MS;
+    calm = end - 3 * 60000;
+    for (auto& x : c){
+      x.skew = skew(rng);
+      x.curDay = DAY0; x.fillFinal = DAY0 - 1;   // abgeglichen: Records bis gestern vom Poller
+      x.fill.have = true; x.fill.top = 0;        // ... und heute bis Frame 0
+      x.seenDay = DAY0;
+      std::uniform_int_distribution<uint64_t> at(T0_MS + 5 * 60000, end - 30 * 60000);
+      for (int b = 0; b < p.bursts; ++b){
+        std::uniform_int_distribution<uint32_t> len(p.burstMin, p.burstMax);
+        const uint64_t a = at(rng);
+        x.down.push_back({ a, a + len(rng) });
+      }
+      if (p.midnight){
+        std::uniform_int_distribution<uint32_t> pre(60000, 600000), post(60000, 900000);
+        const uint64_t mid = (uint64_t)(DAY0 + 1) * 86400000ull;
+        if (p.burstMin) x.down.push_back({ mid - p.burstMin / 2, mid + p.burstMin / 2 });   // feste Länge
+        else x.down.push_back({ mid - pre(rng), mid + post(rng) });
+      }
+    }
+  }
+
+  // die letzten Minuten ohne Verlust: jede Lücke hat einen Frame dahinter, der sie zeigt
+  bool drop(const Client& x, uint64_t at, bool fillMsg){
+    std::uniform_real_distribution<double> u(0, 1);
+    if (x.isDown(at)) return true;
+    if (at >= calm) return false;
+    return u(rng) < pat.iid || (fillMsg && u(rng) < pat.replyLoss);
+  }
+  void send(uint64_t at, const Msg& m){
+    std::uniform_int_distribution<int> lat(1, 20);
+    q.emplace(at + lat(rng), m);
+  }
+
+  // ---- Poller (loop(), maybeFinishPoll(), handleDayMonthRollover()) ----
+  void pollerLoop(){
+    const int32_t d = dayOf(t);
+    if (d != curDay){   // erst integrieren, dann Tageswechsel (loop-Reihenfolge)
+      rec[curDay] = dayAgg;
+      if (!pvEnergyZero(ring.acc)){ pvFillClose(ring, seq + 1, curDay); all.push_back(ring.p[(ring.head + ring.n - 1) % PV_FILL_RING]); }
+      int y, m, dd, y2, m2, d2; pvDayCivil(curDay, y, m, dd); pvDayCivil(d, y2, m2, d2);
+      if (m != m2) pvEnergyClear(monthAgg);
+      pvEnergyClear(dayAgg);
+      curDay = d;
+    }
+    PvEnergy e;
+    if (!pvEnergyStep(integ, pvW, gridW, battW, (uint32_t)t, t1At(t), e)) return;
+    pvEnergyAdd(dayAgg, e); pvEnergyAdd(monthAgg, e);
+    pvFillAdd(ring, e);
+  }
+
+  void pollerFrame(){
+    // neue Leistungen (Runde fertig): Abend ohne PV, Last schwankt, Batterie deckt einen Teil
+    std::uniform_int_distribution<int> load(200, 4500), pv(0, 300), bat(-2500, 2500);
+    const int l = load(rng);
+    pvW = dayOf(t) == DAY0 ? pv(rng) : 0;
+    battW = bat(rng);
+    gridW = pvW - battW - l;
+    PvFrameV4 f{};
+    f.seq = ++seq; f.ts = (uint32_t)(t / 1000);
+    f.pvW = pvW; f.gridW = gridW; f.battW = battW; f.loadW = l;
+    pvFillClose(ring, f.seq, curDay);
+    all.push_back(ring.p[(ring.head + ring.n - 1) % PV_FILL_RING]);
+    uint8_t pkt[PV_FRAME_WIRE + PV_TIME_WIRE + PV_FILL_WIRE_MAX];
+    pvFrameEncode(f, pkt);
+    size_t len = PV_FRAME_WIRE + pvFrameTimeSeal(pkt + PV_FRAME_WIRE, t, true);
+    PayloadFillPart parts[PV_FILL_PARTS];
+    const uint8_t n = pvFillParts(ring, f.seq, parts);
+    if (n) len += pvFillSeal(pkt + len, parts, n);
+    for (size_t i = 0; i < c.size(); ++i)
+      if (!drop(c[i], t, false)) send(t, Msg{ (int)i, true, 0, std::vector<uint8_t>(pkt, pkt + len) });
+  }
+
+  void pollerFillReq(int from, const std::vector<uint8_t>& b){
+    PayloadFillReq r;
+    if (!pvWireDecode(b.data(), b.size(), r) || r.to < r.from) return;
+    pvFillServe(ring, r.from, r.to, [&](const uint8_t* pl, size_t len){
+      fillPkts++; fillBytes += STATS_HDR_WIRE + len + UDP_OVERHEAD;
+      if (!drop(c[from], t, true)) send(t, Msg{ from, false, STATS_FILL, std::vector<uint8_t>(pl, pl + len) });
+    });
+  }
+
+  // ---- Client ----
+  void apply(Client& x, const PayloadFillPart& p){   // fillApply()
+    const PvEnergy e = pvFillEnergy(p);
+    const uint8_t tg = pvFillTarget(p.day, x.curDay, x.fillFinal);
+    if (tg != PVFILL_SKIP) x.applied.insert({ p.seq, p.day });
+    if (tg == PVFILL_TODAY){ pvEnergyAdd(x.dayAgg, e); pvEnergyAdd(x.monthAgg, e); return; }
+    if (tg != PVFILL_PAST) return;
+    pvEnergyAdd(x.rec[p.day], e);
+    int y, m, d, cy, cm, cd; pvDayCivil(p.day, y, m, d); pvDayCivil(x.curDay, cy, cm, cd);
+    if (y == cy && m == cm) pvEnergyAdd(x.monthAgg, e);
+  }
+
+  void rollover(Client& x, uint64_t local){   // handleDayMonthRollover() + fillRollover()
+    const int32_t d = dayOf(local);
+    if (d == x.curDay) return;
+    x.rec[x.curDay] = x.dayAgg;
+    const bool lost = x.fill.lost != x.lostMark;
+    x.lostMark = x.fill.lost;
+    if (!x.fillOn || lost){ x.tailAt = t + 10000; x.tailDay = x.curDay; x.fillFinal = x.curDay; }
+    int y, m, dd, y2, m2, d2; pvDayCivil(x.curDay, y, m, dd); pvDayCivil(d, y2, m2, d2);
+    if (m != m2) pvEnergyClear(x.monthAgg);
+    pvEnergyClear(x.dayAgg);
+    pvEnergyClear(x.oldDay);
+    x.curDay = d;
+  }
+
+  void clientFrame(Client& x, const std::vector<uint8_t>& b){
+    PvFrameV4 f;
+    const uint8_t r = pvRxFrame(x.rx, b.data(), b.size(), 1, (uint32_t)t, f);
+    if (!pvRxAccepted(r)) return;
+    x.oldPv = f.pvW; x.oldGrid = f.gridW; x.oldBatt = f.battW; x.haveFrame = true;
+    PvEnergy e;   // bisher: Trapez bis zu diesem Frame mit den alten Werten, dann neue
+    if (pvEnergyStep(x.integ, f.pvW, f.gridW, f.battW, (uint32_t)(t + x.skew), t1At(t + x.skew), e)) pvEnergyAdd(x.oldDay, e);
+    PayloadFillPart parts[PV_FILL_PARTS];
+    const uint8_t np = pvFillGet(b.data(), b.size(), PV_FRAME_WIRE + PV_TIME_WIRE, parts);
+    x.fillOn = np > 0;
+    if (!np) return;
+    rollover(x, t + x.skew);
+    if (r == PVRX_RESTART) pvFillReset(x.fill);
+    const bool open = x.fill.miss != 0;
+    pvFillOnFrame(x.fill, f.seq);
+    if (!open && x.fill.miss) x.gapDay = x.seenDay;
+    x.seenDay = x.curDay;
+    for (uint8_t i = 0; i < np; ++i) if (parts[i].seq == f.seq) apply(x, parts[i]);
+  }
+
+  void clientFill(Client& x, const std::vector<uint8_t>& b){
+    PayloadFill h;
+    if (!pvWireDecode(b.data(), b.size(), h) || h.n > PV_FILL_PER_PKT) return;
+    if (b.size() < PvWire<PayloadFill>::size + h.n * PvWire<PayloadFillPart>::size) return;
+    PayloadFillPart parts[PV_FILL_PER_PKT];
+    bool want[PV_FILL_PER_PKT];
+    for (uint8_t i = 0; i < h.n; ++i){
+      PvWire<PayloadFillPart>::get(parts[i], b.data() + PvWire<PayloadFill>::size + i * PvWire<PayloadFillPart>::size);
+      want[i] = pvFillWanted(x.fill, parts[i].seq);
+    }
+    for (uint8_t i = 0; i < h.n; ++i) pvFillDone(x.fill, parts[i].seq);
+    pvFillOnReply(x.fill, h.oldest);
+    for (uint8_t i = 0; i < h.n; ++i) if (want[i]) apply(x, parts[i]);
+  }
+
+  void clientLoop(int i){
+    Client& x = c[i];
+    const uint64_t local = t + x.skew;
+    if (x.haveFrame){   // bisher: loop() integriert mit dem letzten Frame weiter
+      PvEnergy e;
+      if (pvEnergyStep(x.integ, x.oldPv, x.oldGrid, x.oldBatt, (uint32_t)local, t1At(local), e)) pvEnergyAdd(x.oldDay, e);
+    }
+    rollover(x, local);
+    if (x.fill.lost != x.pastMark){   // fillClientTick(): verloren seit einem Frame von gestern
+      x.pastMark = x.fill.lost;
+      if (x.gapDay && x.gapDay < x.curDay && x.fillFinal < x.curDay - 1){ x.tailAt = t + 10000; x.tailDay = x.curDay - 1; x.fillFinal = x.curDay - 1; }
+    }
+    if (x.tailAt && t >= x.tailAt){ x.rec[x.tailDay] = rec[x.tailDay]; x.tailAt = 0; }
+    PayloadFillReq r;
+    if (pvFillTick(x.fill, (uint32_t)t, r)){
+      uint8_t pl[PvWire<PayloadFillReq>::size];
+      pvWireEncode(r, pl);
+      x.reqPkts++; x.reqBytes += STATS_HDR_WIRE + sizeof(pl) + UDP_OVERHEAD;
+      if (!drop(x, t, true)) send(t, Msg{ -1 - i, false, STATS_FILL_REQ, std::vector<uint8_t>(pl, pl + sizeof(pl)) });
+    }
+  }
+
+  void run(uint32_t hours){
+    const uint64_t end = T0_MS + (uint64_t)hours * HOUR_MS;
+    uint64_t nextFrame = T0_MS + 1000;
+    for (; t < end + 60000; t += 10){
+      while (!q.empty() && q.begin()->first <= t){
+        Msg m = q.begin()->second; q.erase(q.begin());
+        if (m.to < 0) pollerFillReq(-1 - m.to, m.b);
+        else if (m.frame) clientFrame(c[m.to], m.b);
+        else if (c[m.to].isDown(t)) {}
+        else clientFill(c[m.to], m.b);
+      }
+      if (t % LOOP_MS == 0){
+        pollerLoop();
+        if (t < end && t >= nextFrame){ pollerFrame(); nextFrame += FRAME_MS; }
+        for (size_t i = 0; i < c.size(); ++i) clientLoop((int)i);
+      }
+    }
+  }
+};
+
+// ---------- Auswertung ----------
+struct Res {
+  int clients = 0, exact = 0;           // Tag, Monat, Records gleich
+  int lostExact = 0;                    // Differenz = Teile der verlorenen Frames
+  int recExact = 0;                     // Records gleich
+  uint64_t missed = 0, filled = 0, lost = 0, reqs = 0, fillPkts = 0, fillKB = 0;
+  double oldErrWh = 0, newErrWh = 0;
+};
+
+static Res eval(Sim& s){
+  Res r; r.clients = (int)s.c.size();
+  for (auto& x : s.c){
+    // der offene Teil (seit dem letzten Frame) ist beim Client noch nicht angekommen
+    PvEnergy day = x.dayAgg, month = x.monthAgg;
+    pvEnergyAdd(day, s.ring.acc); pvEnergyAdd(month, s.ring.acc);
+    bool ok = same(day, s.dayAgg) && same(month, s.monthAgg);
+    bool rok = true;
+    for (auto& kv : s.rec) rok &= same(x.rec[kv.first], kv.second);
+    r.recExact += rok;
+    r.exact += ok && rok;
+    // Differenz heute = Summe der nicht gebuchten Teile (verloren)
+    PvEnergy miss; pvEnergyClear(miss);
+    for (auto& p : s.all) if (p.day == s.curDay && !x.applied.count({ p.seq, p.day })) pvEnergyAdd(miss, pvFillEnergy(p));
+    PvEnergy sum = day; pvEnergyAdd(sum, miss);
+    r.lostExact += same(sum, s.dayAgg);
+    r.missed += x.fill.missed; r.filled += x.fill.filled; r.lost += x.fill.lost; r.reqs += x.fill.reqs;
+    double eo = 0, en = 0;
+    for (uint8_t k = 0; k < PVE_COUNT; ++k){
+      eo = std::max(eo, fabs(wh(x.oldDay.e[k] - s.dayAgg.e[k])));
+      en = std::max(en, fabs(wh(day.e[k] - s.dayAgg.e[k])));
+    }
+    r.oldErrWh = std::max(r.oldErrWh, eo); r.newErrWh = std::max(r.newErrWh, en);
+  }
+  r.fillPkts = s.fillPkts; r.fillKB = s.fillBytes / 1024;
+  return r;
+}
+
+static Res simulate(const Pattern& p, int clients, uint32_t hours, unsigned seed){
+  Sim s(seed, p, clients, hours);
+  s.run(hours);
+  return eval(s);
+}
+
+static const Pattern PATTERNS[] = {
+  { "ohne Verlust" },
+  { "5 % einzeln",            0.05 },
+  { "20 % einzeln",           0.20 },
+  { "WLAN weg 1..20 min (3x)", 0.02, 3, 60000, 1200000 },
+  { "WLAN weg um 0:00",        0.02, 0, 0, 0, true },
+  { "Anfragen/Antw. 25 % weg", 0.05, 2, 60000, 600000, false, 0.25 },
+  { "WLAN weg 50 min",         0,    1, 3000000, 3000000 },
+  { "WLAN weg 50 min um 0:00", 0,    0, 3000000, 3000000, true },
+};
+static const size_t LOSSY = 2;   // die letzten: länger als der Ring
+
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+struct Opt { int clients = 10; uint32_t hours = 4; unsigned seed = 1; };
+
+static int cmdSelftest(const Opt& o){
+  // --- Anhang ---
+  {
+    PayloadFillPart a[2] = { { 7, DAY0, 1, 2, 3, 4, 5 }, { 7, DAY0 + 1, -1, 1LL << 40, 0, 9, 8 } }, b[2];
+    uint8_t pkt[PV_FRAME_WIRE + PV_TIME_WIRE + PV_FILL_WIRE_MAX] = {};
+    const size_t at = PV_FRAME_WIRE + PV_TIME_WIRE;
+    size_t len = at + pvFillSeal(pkt + at, a, 2);
+    bool ok = len == at + PV_FILL_WIRE_MAX && pvFillGet(pkt, len, at, b) == 2 && !memcmp(&a[1], &b[1], sizeof(b[1]));
+    ok &= pvFillGet(pkt, at, at, b) == 0 && pvFillGet(pkt, len - 1, at, b) == 0;
+    pkt[at + 20] ^= 1;
+    ok &= pvFillGet(pkt, len, at, b) == 0;
+    check(ok, "Anhang: Rundreise, fehlt, zu kurz, CRC");
+  }
+  // --- Lückenfenster ---
+  {
+    PvFillClient c;
+    pvFillOnFrame(c, 10); pvFillOnFrame(c, 11); pvFillOnFrame(c, 15);
+    PayloadFillReq q;
+    bool ok = c.gaps == 1 && c.missed == 3 && pvFillTick(c, 0, q) && q.from == 12 && q.to == 14;
+    ok &= pvFillWanted(c, 13) && !pvFillWanted(c, 11) && !pvFillWanted(c, 15);
+    pvFillDone(c, 13); pvFillDone(c, 13);
+    ok &= !pvFillWanted(c, 13) && c.filled == 1;
+    ok &= !pvFillTick(c, 100, q) && pvFillTick(c, PV_FILL_RETRY_MS, q) && q.from == 12 && q.to == 14;
+    pvFillOnFrame(c, 16);
+    ok &= pvFillWanted(c, 12) && pvFillWanted(c, 14);   // verschoben
+    pvFillOnReply(c, 13);                               // 12 nicht mehr im Ring
+    ok &= !pvFillWanted(c, 12) && c.lost == 1 && pvFillWanted(c, 14);
+    pvFillOnFrame(c, 16 + 70);                          // 69 fehlen, 64 im Fenster, 14 fällt heraus
+    ok &= c.lost == 1 + 1 + 5 && pvFillBits(c.miss) == 64;
+    uint32_t now = 100000, wait = PV_FILL_RETRY_MS;
+    ok &= pvFillTick(c, now, q);                        // neue Lücke: sofort
+    for (int k = 0; k < 10; ++k){                       // ohne Antwort: 3, 6, 12, 24, 24 ... s
+      ok &= !pvFillTick(c, now + wait - 1, q) && pvFillTick(c, now + wait, q);
+      now += wait;
+      if (wait < ((uint32_t)PV_FILL_RETRY_MS << PV_FILL_BACKOFF)) wait *= 2;
+    }
+    pvFillOnFrame(c, 86 + 64);                          // nie aufgegeben, erst das Fenster verliert sie
+    ok &= c.miss == ((1ULL << 63) - 1) && c.lost == 7 + 64;
+    pvFillOnFrame(c, 3);                                // Poller neu
+    ok &= c.top == 3 && !c.miss;
+    check(ok, "Lückenfenster: nachfragen, erledigen, zu alt, Fenster, Abstand, Neustart");
+  }
+  // --- Antwort-Pakete ---
+  {
+    PvFillRing r;
+    for (uint32_t s = 1; s <= 40; ++s){
+      if (s == 20) pvFillClose(r, s, DAY0);       // Mitternacht: zwei Teile für Frame 20
+      pvFillClose(r, s, s < 20 ? DAY0 : DAY0 + 1);
+    }
+    int pkts = 0, parts = 0; bool ok = true;
+    std::set<uint32_t> seen;
+    pvFillServe(r, 15, 30, [&](const uint8_t* pl, size_t len){
+      PayloadFill h; pvWireDecode(pl, len, h);
+      ok &= h.n <= PV_FILL_PER_PKT && h.oldest == 1;
+      std::set<uint32_t> mine;
+      for (uint8_t i = 0; i < h.n; ++i){
+        PayloadFillPart p; PvWire<PayloadFillPart>::get(p, pl + PvWire<PayloadFill>::size + i * PvWire<PayloadFillPart>::size);
+        ok &= p.seq >= 15 && p.seq <= 30 && (!seen.count(p.seq) || mine.count(p.seq));
+        mine.insert(p.seq); seen.insert(p.seq); parts++;
+      }
+      pkts++;
+    });
+    ok &= parts == 17 && pkts == 3 && seen.size() == 16;
+    check(ok, "Antwort: Bereich, Teile eines Frames im selben Paket, <= 6 je Paket");
+  }
+  // --- Simulation ---
+  char b[128];
+  const size_t np = sizeof(PATTERNS) / sizeof(PATTERNS[0]);
+  for (size_t k = 0; k + LOSSY < np; ++k){
+    Res r = simulate(PATTERNS[k], o.clients, o.hours, o.seed + (unsigned)k);
+    snprintf(b, sizeof(b), "%-24s %d/%d bitgleich (%llu nachgeholt)", PATTERNS[k].name, r.exact, r.clients, (unsigned long long)r.filled);
+    check(r.exact == r.clients && r.lost == 0 && r.filled == r.missed, b);
+  }
+  for (size_t k = np - LOSSY; k < np; ++k){   // gestern danach aus dem Karussell
+    Res r = simulate(PATTERNS[k], o.clients, o.hours, o.seed + (unsigned)k);
+    snprintf(b, sizeof(b), "%-24s %llu verloren, Differenz = deren Teile %d/%d", PATTERNS[k].name, (unsigned long long)r.lost, r.lostExact, r.clients);
+    check(r.lost > 0 && r.lostExact == r.clients && r.recExact == r.clients, b);
+  }
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int cmdBench(const Opt& o){
+  printf("%d Clients, %u h ab 22:00 am Monatsletzten, Frames alle %u s, Ring %u Teile, Fenster %u Frames\n\n",
+         o.clients, o.hours, FRAME_MS / 1000, PV_FILL_RING, PV_FILL_WIN);
+  printf("%-24s %7s %7s %7s %6s %7s %6s %9s %11s %10s\n", "", "fehlten", "nachgeh", "verlor", "Anfr.", "Antw.", "KB",
+         "gleich", "eigene Wh", "Teile Wh");
+  for (const Pattern& p : PATTERNS){
+    Res r = simulate(p, o.clients, o.hours, o.seed);
+    printf("%-24s %7llu %7llu %7llu %6llu %7llu %6llu %5d/%-3d %11.3f %10.3f\n", p.name,
+           (unsigned long long)r.missed, (unsigned long long)r.filled, (unsigned long long)r.lost,
+           (unsigned long long)r.reqs, (unsigned long long)r.fillPkts, (unsigned long long)r.fillKB,
+           r.exact, r.clients, r.oldErrWh, r.newErrWh);
+  }
+  printf("\neigene Wh / Teile Wh: größte Abweichung des heutigen Tages vom Poller über alle Clients und Kanäle\n"
+         "(eigene = bisherige Integration mit der Leistung des letzten Frames)\n");
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvfill selftest [--seed N] | bench [--clients N] [--hours H] [--seed N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  Opt o;
+  for (int i = 2; i + 1 < argc; i += 2){
+    std::string k = argv[i];
+    if (k == "--clients") o.clients = atoi(argv[i + 1]);
+    else if (k == "--hours") o.hours = (uint32_t)atoi(argv[i + 1]);
+    else if (k == "--seed") o.seed = (unsigned)atoi(argv[i + 1]);
+    else return usage();
+  }
+  if (o.clients < 1 || o.clients > 200 || o.hours < 3 || o.hours > 48) return usage();
+  if (cmd == "selftest") return cmdSelftest(o);
+  if (cmd == "bench") return cmdBench(o);
+  return usage();
+}
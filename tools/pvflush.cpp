@@ -0,0 +1,174 @@
+// ===================== tools/pvflush.cpp =====================
+// Host-Backend für PvFlush.h: simulierter SPI-Bus mit fester Bandbreite, um Überlappung
+// von Zeichnen und Übertragung sowie die Frame-Zeit je Bandhöhe zu messen.
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvflush tools/pvflush.cpp
+//
+// Aufrufe:
+//   pvflush bench [--mhz 40] [--work 6] [--frames 20] [--overhead-us 15]
+//       Frame-Zeit seriell (zeichnen, dann blockierend senden) vs. PvFlush (zwei Puffer, asynchron)
+//       für verschiedene Bandhöhen; prüft, dass das Bild im simulierten Display stimmt.
+//       "CPU x" = Zeichenzeit aller Bänder eines Frames / ein Durchgang über das Vollbild
+//       (Mehraufwand der Bänder; für die echten Seiten s. pvgfx bench)
+//   --work N  Rechenaufwand je Pixel beim Zeichnen (mehr = langsamere "Seite")
+#include "../SolarDisplay/PvFlush.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+static const int W = 320, H = 240;
+
+static uint32_t monoUs(){
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- simulierter Bus ----------
+// Übertragung dauert overhead + Bytes*8/Takt. Die Pixel landen erst am Ende der Übertragung
+// im Display-Speicher: wird ein Puffer zu früh überschrieben, ist das Bild falsch.
+struct SimBus {
+  double   mhz = 40; uint32_t overheadUs = 15;
+  std::vector<uint16_t> fb = std::vector<uint16_t>(W * H);
+  bool     active = false;
+  uint32_t doneUs = 0;
+  int16_t  px, py, pw, ph; const uint16_t* src = nullptr;
+  uint64_t busUs = 0;      // Summe Übertragungszeit
+
+  uint32_t nowUs(){ return monoUs(); }
+  void begin(){}
+  void end(){}
+  void complete(){
+    if (!active) return;
+    for (int r = 0; r < ph; ++r) memcpy(&fb[(py + r) * W + px], src + r * pw, pw * 2);
+    active = false;
+  }
+  bool busy(){ if (active && (int32_t)(nowUs() - doneUs) >= 0) complete(); return active; }
+  void wait(){
+    if (!active) return;
+    int32_t left = (int32_t)(doneUs - nowUs());
+    if (left > 0) std::this_thread::sleep_for(std::chrono::microseconds(left));
+    while ((int32_t)(nowUs() - doneUs) < 0) {}
+    complete();
+  }
+  void push(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* p){
+    wait();
+    uint32_t xfer = overheadUs + (uint32_t)(w * h * 16 / mhz);
+    px = x; py = y; pw = w; ph = h; src = p; active = true;
+    doneUs = nowUs() + xfer; busUs += xfer;
+  }
+};
+
+// ---------- "Seite" zeichnen ----------
+// Deterministisches Muster mit einstellbarem Rechenaufwand (statt TFT_eSPI auf dem Host)
+static int gWork = 6;
+static inline uint16_t pixel(int x, int y, int frame){
+  float v = 0;
+  for (int k = 0; k < gWork; ++k) v += sinf((x + 3 * k) * 0.031f + frame * 0.1f) * cosf((y - k) * 0.027f);
+  int c = (int)((v / (gWork ? gWork : 1) + 1.0f) * 127.0f);
+  uint16_t rgb = (uint16_t)(((c >> 3) << 11) | (((255 - c) >> 2) << 5) | ((x ^ y) & 31));
+  return (uint16_t)((rgb >> 8) | (rgb << 8));   // wie Sprite: Display-Byteorder
+}
+static void renderRows(uint16_t* dst, int y0, int rows, int frame){
+  for (int y = 0; y < rows; ++y)
+    for (int x = 0; x < W; ++x) dst[y * W + x] = pixel(x, y0 + y, frame);
+}
+
+struct Result { double frameMs, composeMs, waitMs, busMs; bool ok; };
+
+// Referenz: ein Durchgang über das Vollbild ohne Bänder und ohne Bus (nur CPU)
+static double directDrawMs(int frames){
+  std::vector<uint16_t> buf(W * H);
+  uint32_t t0 = monoUs();
+  for (int f = 0; f < frames; ++f) renderRows(buf.data(), 0, H, f);
+  return (monoUs() - t0) / 1000.0 / frames;
+}
+
+static bool checkFb(const SimBus& bus, int frame){
+  for (int y = 0; y < H; ++y)
+    for (int x = 0; x < W; ++x) if (bus.fb[y * W + x] != pixel(x, y, frame)) return false;
+  return true;
+}
+
+// seriell: wie bisher (zeichnen, dann warten bis übertragen), ein Puffer
+static Result runSerial(SimBus& bus, int bandH, int frames){
+  std::vector<uint16_t> buf(W * bandH);
+  uint64_t tFrame = 0, tCompose = 0, tWait = 0; bus.busUs = 0; bool ok = true;
+  for (int f = 0; f < frames; ++f){
+    uint32_t t0 = monoUs();
+    for (int y = 0; y < H; y += bandH){
+      int rows = std::min(bandH, H - y);
+      uint32_t a = monoUs(); renderRows(buf.data(), y, rows, f); uint32_t b = monoUs();
+      bus.push(0, y, W, rows, buf.data()); bus.wait();
+      tCompose += b - a; tWait += monoUs() - b;
+    }
+    tFrame += monoUs() - t0;
+    ok &= checkFb(bus, f);
+  }
+  return { tFrame / 1000.0 / frames, tCompose / 1000.0 / frames, tWait / 1000.0 / frames, bus.busUs / 1000.0 / frames, ok };
+}
+
+// PvFlush: zwei Puffer, Abschluss per poll()/fence()
+static Result runFlush(SimBus& bus, int bandH, int frames){
+  std::vector<uint16_t> b0(W * bandH), b1(W * bandH);
+  PvFlush<SimBus> fl;
+  fl.bus = &bus; fl.buf[0] = b0.data(); fl.buf[1] = b1.data(); fl.w = W; fl.h = H; fl.bandH = (int16_t)bandH;
+  uint64_t tFrame = 0, tCompose = 0, tWait = 0; bus.busUs = 0; bool ok = true;
+  for (int f = 0; f < frames; ++f){
+    fl.frame([&](uint8_t idx, int16_t y0, int16_t rows){ renderRows(fl.buf[idx], y0, rows, f); });
+    fl.fence();
+    tFrame += fl.frameUs; tCompose += fl.composeUs; tWait += fl.waitUs;
+    ok &= checkFb(bus, f);
+  }
+  return { tFrame / 1000.0 / frames, tCompose / 1000.0 / frames, tWait / 1000.0 / frames, bus.busUs / 1000.0 / frames, ok };
+}
+
+static int cmdBench(int argc, char** argv){
+  SimBus bus; int frames = 20;
+  for (int i = 2; i < argc; ++i){
+    std::string a = argv[i];
+    auto next = [&]{ return i + 1 < argc ? argv[++i] : "0"; };
+    if      (a == "--mhz")         bus.mhz = atof(next());
+    else if (a == "--work")        gWork = atoi(next());
+    else if (a == "--frames")      frames = atoi(next());
+    else if (a == "--overhead-us") bus.overheadUs = (uint32_t)atoi(next());
+    else { fprintf(stderr, "unbekannt: %s\n", a.c_str()); return 2; }
+  }
+  printf("Bus %.0f MHz (+%u us je Übertragung), Vollbild %.1f ms, work=%d, %d Frames\n",
+         bus.mhz, bus.overheadUs, W * H * 16 / bus.mhz / 1000.0, gWork, frames);
+  const double direct = directDrawMs(frames);
+  printf("Zeichnen direkt (Vollbild, ein Durchgang): %.2f ms CPU je Frame\n", direct);
+  printf("%6s %8s | %10s %9s | %10s %9s %9s %8s %6s | %s\n", "Band", "Puffer", "seriell ms", "zeichnen",
+         "PvFlush ms", "zeichnen", "warten", "Gewinn", "CPU x", "Bild");
+  bool allOk = true;
+  for (int bandH : {8, 16, 24, 40, 60, 120}){
+    Result s = runSerial(bus, bandH, frames);
+    Result p = runFlush(bus, bandH, frames);
+    allOk &= s.ok && p.ok;
+    printf("%6d %6.1fkB | %10.2f %9.2f | %10.2f %9.2f %9.2f %7.0f%% %5.2fx | %s\n", bandH, 2.0 * W * bandH * 2 / 1024.0,
+           s.frameMs, s.composeMs, p.frameMs, p.composeMs, p.waitMs,
+           (1.0 - p.frameMs / s.frameMs) * 100.0, p.composeMs / direct, (s.ok && p.ok) ? "ok" : "FEHLER");
+  }
+  printf("zeichnen = CPU-Zeit je Frame (Summe der Bänder), warten = DMA-Wartezeit je Frame\n");
+  printf("Untergrenze je Frame: max(zeichnen, Bus) + ein Band; CPU frei ab Start des letzten Bands\n");
+  printf("%s\n", allOk ? "OK" : "FEHLER: Bild im Display stimmt nicht");
+  return allOk ? 0 : 1;
+}
+
+static int usage(){
+  fprintf(stderr, "pvflush bench [--mhz 40] [--work 6] [--frames 20] [--overhead-us 15]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  if (cmd == "bench") return cmdBench(argc, argv);
+  return usage();
+}
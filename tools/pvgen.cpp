@@ -0,0 +1,282 @@
+// ===================== tools/pvgen.cpp =====================
+// Multicast Last- und Fehlergenerator + Client-Messmodus (Linux/macOS)
+//
+// Bauen:
+//   g++ -std=c++17 -O2 -o pvgen tools/pvgen.cpp
+//
+// Aufrufe:
+//   pvgen send    [Optionen]   Frames (und Stats) auf die Multicast-Gruppen senden
+//   pvgen measure [--sec N]    Frames/Stats empfangen, mit dem Client-Kern (PvRx.h) prüfen,
+//                              angenommen/abgelehnt je Grund und Zeit je Paket ausgeben
+//   pvgen selftest [Optionen]  Generator direkt in den Client-Kern (ohne Netz), prüft u.a. Poller-Neustart
+//
+// Optionen (send/selftest):
+//   --rate HZ            Frames pro Sekunde (Standard 50, 0 = so schnell wie möglich)
+//   --count N            Anzahl Frames (Standard 10000)
+//   --burst K            je K Frames direkt hintereinander, dann Pause (gleiche Mittelrate)
+//   --dup P              Wahrscheinlichkeit Duplikat
+//   --reorder P          Wahrscheinlichkeit Vertauschung mit dem nächsten Frame
+//   --badcrc P           Wahrscheinlichkeit falscher CRC
+//   --short P            Wahrscheinlichkeit abgeschnittenes Paket
+//   --badmagic P         Wahrscheinlichkeit falsche Magic/Version
+//   --restart-every N    alle N Frames Poller-Neustart (seq wieder ab 1; selftest: Standard 1000)
+//   --dual               zweiter Poller (andere Quelle, eigener seq-Raum) sendet dazwischen
+//   --stats-rate HZ      zusätzlich Stats-Pakete (Discover, 10% defekt)
+//   --seed N --if IP
+#include "../SolarDisplay/PvFrame.h"
+#include "../SolarDisplay/PvStats.h"
+#include "../SolarDisplay/PvRx.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <functional>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const char* STATS_MCAST_GRP_STR = "239.0.0.58";   // = STATS_MCAST_GRP (PvStats.h)
+
+static uint64_t monoUs(){
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- Generator ----------
+struct GenOpt {
+  double rate = 50; uint32_t count = 10000; uint32_t burst = 1;
+  double pDup = 0, pReorder = 0, pBadCrc = 0, pShort = 0, pBadMagic = 0;
+  uint32_t restartEvery = 0; bool dual = false; double statsRate = 0;
+  unsigned seed = 1; const char* ifIp = nullptr;
+};
+
+struct GenPkt { std::vector<uint8_t> data; uint32_t src; bool stats; };
+
+struct Generator {
+  const GenOpt& o;
+  std::mt19937 rng;
+  std::uniform_real_distribution<double> U{0.0, 1.0};
+  uint32_t seqA = 0, seqB = 50000, ts = 1700000000u, n = 0;
+  uint32_t restarts = 0;        // Neustarts mit mindestens einem gültigen Frame danach (erkennbar)
+  bool     restartOpen = false, anyValid = false;
+  std::vector<GenPkt> held;     // für Umordnung zurückgehaltener Frame
+  Generator(const GenOpt& opt) : o(opt), rng(opt.seed) {}
+
+  static std::vector<uint8_t> frame(uint32_t seq, uint32_t ts){
+    PvFrameV4 f{};
+    f.magic = PV_MAGIC; f.version = PV_VERSION; f.seq = seq; f.ts = ts;
+    f.pvW = (int32_t)(seq * 37 % 9000); f.gridW = (int32_t)(seq * 53 % 6000) - 3000; f.battW = (int32_t)(seq % 4000) - 2000;
+    f.socx10 = (uint16_t)(seq % 1000);
+    std::vector<uint8_t> p(PV_FRAME_WIRE);
+    pvFrameEncode(f, p.data());
+    return p;
+  }
+
+  // Nächste Paketgruppe für einen Frame-Takt erzeugen
+  void step(std::vector<GenPkt>& out){
+    ++n; ++ts;
+    if (o.restartEvery && n % o.restartEvery == 0){ seqA = 0; restartOpen = anyValid; }   // Poller-Neustart
+    GenPkt p{frame(++seqA, ts), 1, false};
+    double u = U(rng);
+    if      ((u -= o.pBadCrc)   < 0) p.data[PV_FRAME_WIRE - 1] ^= 0x5A;
+    else if ((u -= o.pShort)    < 0) p.data.resize(PV_FRAME_WIRE / 2);
+    else if ((u -= o.pBadMagic) < 0) p.data[2] = PV_VERSION + 1;
+    else { if (restartOpen) restarts++; restartOpen = false; anyValid = true; }
+
+    if (!held.empty()){ out.push_back(p); out.insert(out.end(), held.begin(), held.end()); held.clear(); }
+    else if (U(rng) < o.pReorder) held.push_back(p);
+    else out.push_back(p);
+    if (U(rng) < o.pDup) out.push_back(out.empty() ? p : out.back());
+    if (o.dual) out.push_back({frame(++seqB, ts), 2, false});
+  }
+
+  // am Ende: zurückgehaltenen Frame noch senden
+  void finish(std::vector<GenPkt>& out){ out.insert(out.end(), held.begin(), held.end()); held.clear(); }
+
+  GenPkt statsPkt(){
+    StatsHdr h{0xCAFE, 1, STATS_DISCOVER, n, 0, 0};
+    h.crc = pvstats_crc(h, nullptr);
+    if (U(rng) < 0.1) h.crc ^= 1;
+    std::vector<uint8_t> p(STATS_HDR_WIRE);
+    pvWireEncode(h, p.data());
+    return {p, 1, true};
+  }
+};
+
+// ---------- Client-Kern Messung ----------
+struct Meter {
+  PvRxState rx;
+  uint32_t stats[PVRX_COUNT] = {0};
+  uint64_t nsSum = 0, nsMax = 0, pkts = 0;
+
+  void feed(const uint8_t* d, size_t n, uint32_t src, bool isStats, uint32_t nowMs){
+    auto t0 = std::chrono::steady_clock::now();
+    if (isStats){ StatsHdr h; stats[pvRxStats(d, n, h)]++; }
+    else { PvFrameV4 f; pvRxFrame(rx, d, n, src, nowMs, f); }
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    nsSum += ns; if (ns > nsMax) nsMax = ns; ++pkts;
+  }
+  void print(const char* tag) const {
+    printf("%s Frames:", tag);
+    for (uint8_t i = 0; i < PVRX_COUNT; ++i) printf(" %s=%u", pvRxReasonName(i), rx.cnt[i]);
+    printf(" | Stats ok=%u short=%u magic=%u crc=%u", stats[PVRX_OK], stats[PVRX_SHORT], stats[PVRX_MAGIC], stats[PVRX_CRC]);
+    printf(" | %llu Pakete, %.0f ns avg, %llu ns max\n", (unsigned long long)pkts,
+           pkts ? (double)nsSum / pkts : 0.0, (unsigned long long)nsMax);
+  }
+};
+
+// ---------- Netz ----------
+static int mcastListen(const char* grp, uint16_t port, const char* ifIp){
+  int s = socket(AF_INET, SOCK_DGRAM, 0);
+  if (s < 0){ perror("socket"); return -1; }
+  int one = 1;
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#ifdef SO_REUSEPORT
+  setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+#endif
+  int rcv = 4 << 20; setsockopt(s, SOL_SOCKET, SO_RCVBUF, &rcv, sizeof(rcv));
+  sockaddr_in a{}; a.sin_family = AF_INET; a.sin_port = htons(port); a.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(s, (sockaddr*)&a, sizeof(a)) < 0){ perror("bind"); close(s); return -1; }
+  ip_mreq m{};
+  inet_pton(AF_INET, grp, &m.imr_multiaddr);
+  m.imr_interface.s_addr = ifIp ? inet_addr(ifIp) : htonl(INADDR_ANY);
+  if (setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, &m, sizeof(m)) < 0){ perror("IP_ADD_MEMBERSHIP"); close(s); return -1; }
+  return s;
+}
+
+static int mcastSender(const char* ifIp){
+  int s = socket(AF_INET, SOCK_DGRAM, 0);
+  if (s < 0){ perror("socket"); return -1; }
+  unsigned char ttl = 1, loop = 1;
+  setsockopt(s, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+  setsockopt(s, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+  if (ifIp){ in_addr a{}; a.s_addr = inet_addr(ifIp); setsockopt(s, IPPROTO_IP, IP_MULTICAST_IF, &a, sizeof(a)); }
+  return s;
+}
+
+static volatile sig_atomic_t stopFlag = 0;
+static void onSig(int){ stopFlag = 1; }
+
+// Generator mit Takt (rate/burst) laufen lassen, Pakete an sink übergeben
+// liefert die Zahl der erkennbaren Poller-Neustarts
+static uint32_t runGen(const GenOpt& o, const std::function<void(const GenPkt&)>& sink, bool paced){
+  Generator g(o);
+  std::vector<GenPkt> pk;
+  uint64_t t0 = monoUs(), nextStats = t0;
+  for (uint32_t i = 0; i < o.count && !stopFlag; ++i){
+    if (paced && o.rate > 0 && i % o.burst == 0){
+      uint64_t due = t0 + (uint64_t)(i / o.rate * 1e6);
+      uint64_t now = monoUs();
+      if (due > now) std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+    }
+    pk.clear(); g.step(pk);
+    for (const GenPkt& p : pk) sink(p);
+    if (o.statsRate > 0 && monoUs() >= nextStats){ sink(g.statsPkt()); nextStats += (uint64_t)(1e6 / o.statsRate); }
+  }
+  pk.clear(); g.finish(pk);
+  for (const GenPkt& p : pk) sink(p);
+  return g.restarts;
+}
+
+static int cmdSend(const GenOpt& o){
+  int s = mcastSender(o.ifIp);
+  if (s < 0) return 1;
+  sockaddr_in toF{}; toF.sin_family = AF_INET; toF.sin_port = htons(MCAST_PORT); inet_pton(AF_INET, PV_MCAST_GRP_STR, &toF.sin_addr);
+  sockaddr_in toS{}; toS.sin_family = AF_INET; toS.sin_port = htons(STATS_MCAST_PORT); inet_pton(AF_INET, STATS_MCAST_GRP_STR, &toS.sin_addr);
+  uint64_t sent = 0, t0 = monoUs();
+  signal(SIGINT, onSig);
+  runGen(o, [&](const GenPkt& p){
+    sendto(s, p.data.data(), p.data.size(), 0, (const sockaddr*)(p.stats ? &toS : &toF), sizeof(sockaddr_in));
+    ++sent;
+  }, true);
+  double sec = (monoUs() - t0) / 1e6;
+  printf("%llu Pakete in %.2f s (%.0f/s)\n", (unsigned long long)sent, sec, sec > 0 ? sent / sec : 0.0);
+  close(s);
+  return 0;
+}
+
+static int cmdMeasure(double maxSec, const char* ifIp){
+  int sF = mcastListen(PV_MCAST_GRP_STR, MCAST_PORT, ifIp);
+  int sS = mcastListen(STATS_MCAST_GRP_STR, STATS_MCAST_PORT, ifIp);
+  if (sF < 0 || sS < 0) return 1;
+  signal(SIGINT, onSig);
+  Meter m;
+  pollfd pf[2] = {{sF, POLLIN, 0}, {sS, POLLIN, 0}};
+  uint8_t buf[2048];
+  uint64_t t0 = monoUs(), lastPrint = t0;
+  while (!stopFlag){
+    uint64_t now = monoUs();
+    if (maxSec > 0 && now - t0 >= (uint64_t)(maxSec * 1e6)) break;
+    if (now - lastPrint >= 5000000){ lastPrint = now; m.print("[5s]"); }
+    if (poll(pf, 2, 200) <= 0) continue;
+    for (int k = 0; k < 2; ++k){
+      if (!(pf[k].revents & POLLIN)) continue;
+      sockaddr_in from{}; socklen_t fl = sizeof(from);
+      ssize_t n = recvfrom(pf[k].fd, buf, sizeof(buf), 0, (sockaddr*)&from, &fl);
+      if (n <= 0) continue;
+      // Quelle: IP+Port (der Generator simuliert den zweiten Poller über die Quelle im Paketinhalt nicht)
+      uint32_t src = from.sin_addr.s_addr ^ ((uint32_t)from.sin_port << 16);
+      m.feed(buf, (size_t)n, src, k == 1, (uint32_t)((monoUs() - t0) / 1000));
+    }
+  }
+  m.print("[Ende]");
+  close(sF); close(sS);
+  return 0;
+}
+
+// Ohne Netz: Generator -> Client-Kern, mit Plausibilitätsprüfung
+static int cmdSelftest(GenOpt o){
+  Meter m;
+  uint32_t nowMs = 0;
+  const uint32_t expected = runGen(o, [&](const GenPkt& p){
+    nowMs += o.rate > 0 ? (uint32_t)(1000.0 / o.rate) : 1;
+    m.feed(p.data.data(), p.data.size(), p.src, p.stats, nowMs);
+  }, false);
+  m.print("[selftest]");
+  // Jeder Poller-Neustart genau einmal (sonst ignoriert der Client alles bis seq > altes lastSeq,
+  // bzw. ein verspäteter Frame von vorher gilt als zweiter Neustart)
+  const uint32_t got = m.rx.cnt[PVRX_RESTART];
+  const bool ok = (m.rx.cnt[PVRX_OK] + got) > 0 && got == expected;
+  printf("Neustarts erkannt: %u (erwartet %u, alle %u Frames)\n", got, expected, o.restartEvery);
+  printf("%s\n", ok ? "OK" : got < expected ? "FEHLER: Client hängt nach Poller-Neustart" : "FEHLER: Neustart doppelt gezählt");
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2){ fprintf(stderr, "pvgen send|measure|selftest [Optionen] (s. Dateikopf)\n"); return 2; }
+  std::string cmd = argv[1];
+  GenOpt o; double sec = 0; bool restartSet = false;
+  for (int i = 2; i < argc; ++i){
+    std::string a = argv[i];
+    auto num = [&](){ return i + 1 < argc ? atof(argv[++i]) : 0.0; };
+    if      (a == "--rate")          o.rate = num();
+    else if (a == "--count")         o.count = (uint32_t)num();
+    else if (a == "--burst")         o.burst = std::max<uint32_t>(1, (uint32_t)num());
+    else if (a == "--dup")           o.pDup = num();
+    else if (a == "--reorder")       o.pReorder = num();
+    else if (a == "--badcrc")        o.pBadCrc = num();
+    else if (a == "--short")         o.pShort = num();
+    else if (a == "--badmagic")      o.pBadMagic = num();
+    else if (a == "--restart-every"){ o.restartEvery = (uint32_t)num(); restartSet = true; }
+    else if (a == "--dual")          o.dual = true;
+    else if (a == "--stats-rate")    o.statsRate = num();
+    else if (a == "--seed")          o.seed = (unsigned)num();
+    else if (a == "--sec")           sec = num();
+    else if (a == "--if" && i + 1 < argc) o.ifIp = argv[++i];
+    else { fprintf(stderr, "unbekannte Option %s\n", a.c_str()); return 2; }
+  }
+  if (cmd == "send")     return cmdSend(o);
+  if (cmd == "measure")  return cmdMeasure(sec, o.ifIp);
+  if (cmd == "selftest"){ if (!restartSet) o.restartEvery = 1000; return cmdSelftest(o); }
+  fprintf(stderr, "pvgen send|measure|selftest\n");
+  return 2;
+}
@@ -0,0 +1,145 @@
+// ===================== tools/pvgesture.cpp =====================
+// Host-Prüfung der Touch-Gesten (SolarDisplay/PvGesture.h): Filter + Automat wie im Sketch.
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvgesture tools/pvgesture.cpp
+//
+// Aufrufe:
+//   pvgesture replay <datei>   Mitschnitt vom Serial-Monitor (Taste 'g' im Sketch, Zeilen "T tMs x y down";
+//                              andere Zeilen werden übersprungen) abspielen und Gesten ausgeben
+//   pvgesture selftest         synthetische Spuren: Swipe links/rechts/hoch, Tap, Long-Press, Rauschen und
+//                              Ausreisser, zu langsamer Swipe, verlorenes Loslassen, Ringüberlauf
+#include "../SolarDisplay/PvGesture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <random>
+
+// Spur abspielen; nach jedem Sample und am Ende wie loop() pvGestureTick() aufrufen
+static std::vector<uint8_t> play(const std::vector<PvTouchSample>& tr, bool verbose){
+  PvTouchInput in;
+  std::vector<uint8_t> out;
+  auto emit = [&](uint8_t g, uint32_t t){
+    if (!g) return;
+    out.push_back(g);
+    if (verbose) printf("%10u  %s\n", t, pvGestureName(g));
+  };
+  for (const PvTouchSample& s : tr){
+    emit(pvTouchInput(in, s), s.tMs);
+    emit(pvGestureTick(in.g, s.tMs), s.tMs);
+  }
+  uint32_t end = tr.empty() ? 0 : tr.back().tMs + PVG_RELEASE_MS + 1;
+  emit(pvGestureTick(in.g, end), end);
+  return out;
+}
+
+// ---------- Spuren erzeugen (100 Hz wie der Touch-Task) ----------
+struct Trace {
+  std::vector<PvTouchSample> s;
+  uint32_t t = 1000;
+  std::mt19937 rng{7};
+  int noise = 0;           // +- Pixel Rauschen
+  int spikeEvery = 0;      // jeder n-te Wert ein Ausreisser
+
+  void move(int x0, int y0, int x1, int y1, uint32_t ms){
+    uint32_t n = ms / 10;
+    for (uint32_t i = 0; i <= n; ++i){
+      int x = x0 + (int)((x1 - x0) * (int)i / (int)(n ? n : 1));
+      int y = y0 + (int)((y1 - y0) * (int)i / (int)(n ? n : 1));
+      if (noise){ x += (int)(rng() % (2 * noise + 1)) - noise; y += (int)(rng() % (2 * noise + 1)) - noise; }
+      if (spikeEvery && i % spikeEvery == (uint32_t)spikeEvery / 2){ x = (x + 160) % 320; y = (y + 120) % 240; }
+      s.push_back({ t, (int16_t)x, (int16_t)y, 1 });
+      t += 10;
+    }
+  }
+  void up(){ s.push_back({ t, 0, 0, 0 }); t += 300; }
+  void gap(uint32_t ms){ t += ms; }
+};
+
+struct Case { const char* name; std::vector<PvTouchSample> tr; std::vector<uint8_t> want; };
+
+static int cmdSelftest(){
+  std::vector<Case> cases;
+  { Trace a; a.move(250, 120, 60, 125, 300); a.up();
+    cases.push_back({"swipe links", a.s, {PVG_SWIPE_LEFT}}); }
+  { Trace a; a.move(40, 100, 220, 90, 400); a.up();
+    cases.push_back({"swipe rechts", a.s, {PVG_SWIPE_RIGHT}}); }
+  { Trace a; a.move(160, 200, 150, 60, 300); a.up();
+    cases.push_back({"swipe hoch", a.s, {PVG_SWIPE_UP}}); }
+  { Trace a; a.move(100, 100, 104, 98, 120); a.up();
+    cases.push_back({"tap", a.s, {PVG_TAP}}); }
+  { Trace a; a.move(100, 100, 102, 101, 1200); a.up();
+    cases.push_back({"long-press (kein Tap danach)", a.s, {PVG_LONG}}); }
+  { Trace a; a.noise = 4; a.spikeEvery = 7; a.move(260, 120, 80, 120, 350); a.up();
+    cases.push_back({"swipe links mit Rauschen + Ausreissern", a.s, {PVG_SWIPE_LEFT}}); }
+  { Trace a; a.noise = 4; a.spikeEvery = 5; a.move(150, 150, 150, 150, 150); a.up();
+    cases.push_back({"tap mit Rauschen + Ausreissern", a.s, {PVG_TAP}}); }
+  { Trace a; a.move(250, 120, 60, 120, 1500); a.up();
+    cases.push_back({"zu langsamer swipe", a.s, {}}); }
+  { Trace a; a.move(40, 120, 100, 120, 200); a.up();
+    cases.push_back({"zu kurzer swipe", a.s, {}}); }
+  { Trace a; a.move(240, 120, 60, 130, 300);   // kein Release-Sample: Tick schließt ab
+    cases.push_back({"verlorenes Loslassen", a.s, {PVG_SWIPE_LEFT}}); }
+  { Trace a; a.move(240, 120, 60, 130, 300); a.gap(PVG_RELEASE_MS + 50); a.move(50, 100, 250, 100, 300); a.up();
+    cases.push_back({"Loslassen fehlt, zweite Geste", a.s, {PVG_SWIPE_LEFT, PVG_SWIPE_RIGHT}}); }
+  { Trace a; a.move(250, 120, 60, 125, 300); a.up(); a.move(100, 100, 101, 101, 100); a.up();
+    a.move(40, 100, 220, 90, 400); a.up();
+    cases.push_back({"Folge links, tap, rechts", a.s, {PVG_SWIPE_LEFT, PVG_TAP, PVG_SWIPE_RIGHT}}); }
+
+  int fails = 0;
+  for (const Case& c : cases){
+    std::vector<uint8_t> got = play(c.tr, false);
+    bool ok = got == c.want;
+    std::string g;
+    for (uint8_t e : got){ if (!g.empty()) g += ","; g += pvGestureName(e); }
+    printf("%-42s %3zu Samples -> %-28s %s\n", c.name, c.tr.size(), g.empty() ? "-" : g.c_str(), ok ? "ok" : "FEHLER");
+    fails += !ok;
+  }
+
+  // Ring: Überlauf zählt verworfene Samples, Reihenfolge bleibt erhalten
+  PvTouchRing ring;
+  uint32_t pushed = 0;
+  for (uint32_t i = 0; i < PV_TOUCH_RING + 10; ++i) pushed += ring.push({ i, 0, 0, 1 });
+  PvTouchSample s; uint32_t n = 0; bool order = true;
+  while (ring.pop(s)){ order &= s.tMs == n; ++n; }
+  bool ringOk = pushed == PV_TOUCH_RING && ring.dropped == 10 && n == PV_TOUCH_RING && order;
+  printf("%-42s %u/%u übernommen, %u verworfen %24s\n", "Ringüberlauf", pushed, PV_TOUCH_RING + 10, ring.dropped,
+         ringOk ? "ok" : "FEHLER");
+  fails += !ringOk;
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int cmdReplay(const char* path){
+  FILE* f = fopen(path, "r");
+  if (!f){ perror(path); return 1; }
+  std::vector<PvTouchSample> tr;
+  char line[256];
+  while (fgets(line, sizeof(line), f)){
+    const char* p = strstr(line, "T ");   // Serial-Monitor kann Zeitstempel voranstellen
+    unsigned t, d; int x, y;
+    if (p && sscanf(p, "T %u %d %d %u", &t, &x, &y, &d) == 4) tr.push_back({ t, (int16_t)x, (int16_t)y, (uint8_t)(d != 0) });
+  }
+  fclose(f);
+  printf("%zu Samples\n", tr.size());
+  std::vector<uint8_t> g = play(tr, true);
+  printf("%zu Gesten\n", g.size());
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvgesture replay <datei> | selftest\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  if (cmd == "selftest") return cmdSelftest();
+  if (cmd == "replay" && argc > 2) return cmdReplay(argv[2]);
+  return usage();
+}
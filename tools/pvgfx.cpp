@@ -0,0 +1,285 @@
+// ===================== tools/pvgfx.cpp =====================
+// Host-Backend für die Seiten (SolarDisplay/PvCommon.h, PvGfx.h): RGB565-Framebuffer mit der
+// TFT_eSPI-Untermenge der Seiten. Zeichnet jede Seite mit Beispieldaten und misst Zeit und
+// geschriebene Pixel je Seite, direkt und in Bändern wie PvFlush (Sprite mit Datum 0,-y0).
+// Schrift: Platzhalter-Glyphen mit den Zellmassen der TFT_eSPI-Fonts 1/2/4 (Layout und
+// Pixelmenge stimmen ungefähr, die Buchstaben selbst nicht).
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvgfx tools/pvgfx.cpp
+//
+// Aufrufe:
+//   pvgfx bench [--iter 200] [--band 40]   je Seite: us/Frame direkt und in Bändern, Pixel, Überzeichnung;
+//                                          prüft, dass Bänder zusammen dasselbe Bild ergeben
+//   pvgfx ppm <seite> <datei.ppm> [--zoom +-N] [--pan N]
+//                                          Seite als Bild ausgeben (Layout-Kontrolle); Verlauf-Seiten
+//                                          3/4 N Stufen gröber/feiner bzw. N halbe Ausschnitte älter
+#include "pvhost.h"
+#include "../SolarDisplay/PvCalendar.h"
+
+// wie im Sketch (PvCalendar.h, nur unter ARDUINO): gemeinsamer Kalender-Cache der Seiten
+static PvCalendar pvCal;
+static inline PvCalendar pvCalNow(){ time_t n; time(&n); pvCalTick(pvCal, n); return pvCal; }   // Kopie wie im Sketch
+
+#include "../SolarDisplay/PvCommon.h"
+#include "../SolarDisplay/PvFlush.h"   // PV_BAND_H
+
+#include <chrono>
+
+// ---------- Framebuffer ----------
+// Zielfenster: Zeilen [oy, oy+rows) des Bildschirms; alles andere wird geclippt (wie ein
+// Band-Sprite mit Viewport-Datum 0,-oy). rows = H -> ganzer Bildschirm.
+struct PvFb {
+  std::vector<uint16_t> px;
+  int      oy = 0, rows = H;
+  uint64_t pixels = 0;        // geschriebene (nicht geclippte) Pixel
+  uint8_t  datum = TL_DATUM, font = 1, size = 1;
+  uint16_t fg = TFT_WHITE, bg = TFT_BLACK; bool bgSet = false;
+
+  PvFb(int r = H) : px((size_t)W * r), rows(r) {}
+
+  // --- Grundoperation: waagrechte Strecke ---
+  void hline(int x, int y, int w, uint16_t c){
+    y -= oy;
+    if (y < 0 || y >= rows || w <= 0) return;
+    if (x < 0){ w += x; x = 0; }
+    if (x + w > W) w = W - x;
+    if (w <= 0) return;
+    std::fill(px.begin() + (size_t)y * W + x, px.begin() + (size_t)y * W + x + w, c);
+    pixels += w;
+  }
+  void pixel(int x, int y, uint16_t c){ hline(x, y, 1, c); }
+
+  // --- TFT_eSPI-Untermenge ---
+  void fillRect(int x, int y, int w, int h, uint16_t c){
+    if (h < 0){ y += h; h = -h; }
+    int y0 = std::max(y, oy), y1 = std::min(y + h, oy + rows);
+    for (int yy = y0; yy < y1; ++yy) hline(x, yy, w, c);
+  }
+  void drawRect(int x, int y, int w, int h, uint16_t c){
+    if (w <= 0 || h <= 0) return;
+    hline(x, y, w, c); hline(x, y + h - 1, w, c);
+    for (int yy = y + 1; yy < y + h - 1; ++yy){ pixel(x, yy, c); pixel(x + w - 1, yy, c); }
+  }
+  void drawLine(int x0, int y0, int x1, int y1, uint16_t c){
+    int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1, err = dx + dy;
+    for (;;){
+      pixel(x0, y0, c);
+      if (x0 == x1 && y0 == y1) break;
+      int e2 = 2 * err;
+      if (e2 >= dy){ err += dy; x0 += sx; }
+      if (e2 <= dx){ err += dx; y0 += sy; }
+    }
+  }
+  // Scanline wie TFT_eSPI: Ecken nach y sortiert, je Zeile eine Strecke
+  void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t c){
+    if (y0 > y1){ std::swap(y0, y1); std::swap(x0, x1); }
+    if (y1 > y2){ std::swap(y2, y1); std::swap(x2, x1); }
+    if (y0 > y1){ std::swap(y0, y1); std::swap(x0, x1); }
+    if (y0 == y2){
+      int a = std::min(x0, std::min(x1, x2)), b = std::max(x0, std::max(x1, x2));
+      hline(a, y0, b - a + 1, c);
+      return;
+    }
+    int32_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+    int last = (y1 == y2) ? y1 : y1 - 1, y;
+    for (y = y0; y <= last; ++y){
+      int a = x0 + sa / dy01, b = x0 + sb / dy02;
+      sa += dx01; sb += dx02;
+      if (a > b) std::swap(a, b);
+      hline(a, y, b - a + 1, c);
+    }
+    sa = dx12 * (y - y1); sb = dx02 * (y - y0);
+    for (; y <= y2; ++y){
+      int a = x1 + sa / dy12, b = x0 + sb / dy02;
+      sa += dx12; sb += dx02;
+      if (a > b) std::swap(a, b);
+      hline(a, y, b - a + 1, c);
+    }
+  }
+  void fillCircle(int cx, int cy, int r, uint16_t c){
+    for (int dy = -r; dy <= r; ++dy){
+      int dx = (int)sqrtf((float)(r * r - dy * dy));
+      hline(cx - dx, cy + dy, 2 * dx + 1, c);
+    }
+  }
+
+  // --- Text (Platzhalter-Glyphen) ---
+  void setTextDatum(uint8_t d){ datum = d; }
+  void setTextFont(uint8_t f){ font = f; }
+  void setTextSize(uint8_t s){ size = s ? s : 1; }
+  void setTextColor(uint16_t f){ fg = f; bgSet = false; }
+  void setTextColor(uint16_t f, uint16_t b){ fg = f; bg = b; bgSet = true; }
+  int cellW() const { return (font == 4 ? 14 : font == 2 ? 8 : 6) * size; }
+  int fontHeight() const { return (font == 4 ? 26 : font == 2 ? 16 : 8) * size; }
+  static int glyphs(const char* s){ int n = 0; for (; *s; ++s) n += ((uint8_t)*s & 0xC0) != 0x80; return n; }
+  int textWidth(const char* s) const { return glyphs(s) * cellW(); }
+  int textWidth(const String& s) const { return textWidth(s.c_str()); }
+  int drawString(const char* s, int x, int y){
+    int w = textWidth(s), h = fontHeight(), cw = cellW();
+    x -= (datum % 3) * w / 2;
+    y -= (datum / 3) * h / 2;
+    if (bgSet) fillRect(x, y, w, h, bg);
+    for (; *s; ++s){
+      if (((uint8_t)*s & 0xC0) == 0x80) continue;
+      if (*s != ' ') drawRect(x + size, y + size, cw - 2 * size, h - 2 * size, fg);
+      x += cw;
+    }
+    return w;
+  }
+  int drawString(const String& s, int x, int y){ return drawString(s.c_str(), x, y); }
+};
+
+// ---------- Beispieldaten (Frame, Hooks, NVS) ----------
+static PvDevInfo sampleDev[3];
+
+bool pvGetTodaySplits(float& t1, float& t2){ t1 = 3.2f; t2 = 1.4f; return true; }
+bool pvGetTodayExport(float& e){ e = 12.6f; return true; }
+bool pvGetTodayPV(float& pv){ pv = 21.4f; return true; }
+bool pvGetTodayLoad(float& l){ l = 13.1f; return true; }
+bool pvGetDevices(const PvDevInfo*& d, uint8_t& n){ d = sampleDev; n = 3; return true; }
+bool pvGetBattEta(PvBattEta& e){
+  e.dir = PVB_DIS; e.conf = 72; e.eta20s = 4 * 3600; e.emptyS = 5 * 3600 + 1200; e.ratex10 = -111; return true;
+}
+
+static PvFrameV4 sampleFrame(){
+  PvFrameV4 f = {};
+  f.magic = PV_MAGIC; f.version = PV_VERSION; f.ts = (uint32_t)time(nullptr);
+  f.pvW = 5230; f.gridW = 2140; f.battW = -1860; f.loadW = f.pvW - f.gridW - f.battW;
+  f.temp10 = 412; f.socx10 = 643; f.eta20s = 4 * 3600;
+  f.pvTodayKWh = 21.4f; f.gridExpToday = 12.6f; f.gridImpToday = 4.6f; f.loadTodayKWh = 13.1f;
+  f.pv1Voltage_x10_V = 4120; f.pv1Current_x10_A = 812; f.pv2Voltage_x10_V = 3980; f.pv2Current_x10_A = 455;
+  return f;
+}
+
+static void sampleData(){
+  const char* names[3] = { "WR1", "WR2", "WR3" };
+  for (uint8_t i = 0; i < 3; ++i){
+    PvDevInfo& d = sampleDev[i];
+    d = {};
+    d.idx = i; d.count = 3; d.unit = 1 + (i == 2); d.flags = i == 0 ? (PVD_METER | PVD_BATT) : i == 1 ? PVD_BATT : 0;
+    d.state = i == 2 ? PVDEV_OLD : PVDEV_OK;
+    d.pvW = 2600 - 700 * i; d.battW = i < 2 ? -900 : 0; d.temp10 = 380 + 15 * i; d.socx10 = 640;
+    d.genTodayWh = 10400 - 3000 * i; d.genMonthWh = 310000 - 90000 * i; d.cycleMs = 420 + 60 * i; d.ageS = 12;
+    memcpy(d.name, names[i], strlen(names[i]));
+  }
+  // 400 Tage rückwärts ab gestern, wie der Sketch sie ablegt: Tagesrecord + Stufen (PvRollup.h)
+  Preferences p; p.begin("pvstats");
+  PvRollupPrefs<Preferences> st{p};
+  PvRollup ru;
+  time_t now = time(nullptr);
+  struct tm lt; localtime_r(&now, &lt);
+  const int32_t today = pvDayNum(lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday);
+  for (int i = 1; i <= 400; ++i){
+    char key[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, today - i), key, sizeof(key));
+    float s = 0.5f + 0.5f * sinf(i * 0.7f), j = 0.5f + 0.5f * cosf((today - i) * 6.2832f / 365.25f - 3.0f);   // Jahresgang
+    PvEnergy old, a = pvEnergyFromKWh(30 * j * s, 12, 2 + 4 * (1 - j), 1.5f, 20 * j * s);
+    st.load(key, old); st.save(key, a);
+    pvRollupDay(ru, st, today - i, old, a);
+  }
+}
+
+static const char* PAGE_NAMES[PV_MAX_PAGES] = { "Gauges", "Strings", "Anlage", "30 Tage", "12 Monate", "Uhr" };
+
+static double nowUs(){
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() / 1000.0;
+}
+
+// Seite in Bändern wie drawPvPageBand(): Band-Puffer schwarz, Datum verschoben, Bänder zusammensetzen
+static void renderBands(PvFb& band, std::vector<uint16_t>* out, const PvFrameV4& f, int page, int bandH){
+  for (int y0 = 0; y0 < H; y0 += bandH){
+    int rows = std::min(bandH, H - y0);
+    band.oy = y0; band.rows = rows;
+    std::fill(band.px.begin(), band.px.end(), TFT_BLACK);
+    pvBandY0 = y0; pvBandY1 = y0 + rows;
+    drawPvPage(band, f, page);
+    pvBandY0 = 0; pvBandY1 = H;
+    if (out) std::copy(band.px.begin(), band.px.begin() + (size_t)rows * W, out->begin() + (size_t)y0 * W);
+  }
+}
+
+static int cmdBench(int iter, int bandH){
+  sampleData();
+  const PvFrameV4 f = sampleFrame();
+  printf("%d Durchläufe je Seite, Band %d Zeilen (%d Bänder), Framebuffer %dx%d\n\n", iter, bandH, (H + bandH - 1) / bandH, W, H);
+  printf("%-10s %12s %12s %10s %10s %8s  %s\n", "Seite", "direkt us", "Bänder us", "Pixel", "je Band", "Faktor", "Bild");
+  int fails = 0;
+  for (int page = 0; page < PV_MAX_PAGES; ++page){
+    PvFb full, band(bandH);
+    drawPvPage(full, f, page);                       // einmal vorab (NVS-Cache, Kalender)
+    uint64_t pxFull = full.pixels; full.pixels = 0;
+    double t0 = nowUs();
+    for (int i = 0; i < iter; ++i) drawPvPage(full, f, page);
+    double tFull = (nowUs() - t0) / iter;
+
+    std::vector<uint16_t> img((size_t)W * H);
+    renderBands(band, &img, f, page, bandH);
+    uint64_t pxBand = band.pixels; band.pixels = 0;
+    t0 = nowUs();
+    for (int i = 0; i < iter; ++i) renderBands(band, nullptr, f, page, bandH);
+    double tBand = (nowUs() - t0) / iter;
+
+    bool same = img == full.px;
+    fails += !same;
+    printf("%-10s %12.1f %12.1f %10llu %10llu %7.2fx  %s\n", PAGE_NAMES[page], tFull, tBand,
+           (unsigned long long)pxFull, (unsigned long long)pxBand, (double)pxFull / (W * H), same ? "ok" : "FEHLER");
+  }
+  printf("\nPixel = direkt geschrieben, je Band = Summe über alle Bänder, Faktor = Pixel / %d (Überzeichnung)\n", W * H);
+  printf("%s\n", fails ? "FEHLER: Bänder ergeben ein anderes Bild" : "OK");
+  return fails ? 1 : 0;
+}
+
+static int cmdPpm(int page, const char* path, int zoom, int pan){
+  if (page < 0 || page >= PV_MAX_PAGES){ fprintf(stderr, "Seite 0..%d\n", PV_MAX_PAGES - 1); return 2; }
+  sampleData();
+  // Verlauf-Seiten: wie Wischen hoch/runter bzw. Tap links (pvChartZoom/pvChartPan)
+  for (int i = 0; i < abs(zoom); ++i) pvChartZoom(page, zoom);
+  for (int i = 0; i < pan; ++i) pvChartPan(page, -1);
+  PvFb fb;
+  drawPvPage(fb, sampleFrame(), page);
+  FILE* out = fopen(path, "wb");
+  if (!out){ perror(path); return 1; }
+  fprintf(out, "P6\n%d %d\n255\n", W, H);
+  for (uint16_t c : fb.px){
+    uint8_t rgb[3] = { (uint8_t)((c >> 11) << 3), (uint8_t)(((c >> 5) & 0x3F) << 2), (uint8_t)((c & 0x1F) << 3) };
+    fwrite(rgb, 1, 3, out);
+  }
+  fclose(out);
+  printf("%s: Seite %d (%s), %llu Pixel\n", path, page, PAGE_NAMES[page], (unsigned long long)fb.pixels);
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvgfx bench [--iter N] [--band ZEILEN] | ppm <seite> <datei.ppm> [--zoom +-N] [--pan N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  if (cmd == "bench"){
+    int iter = 200, band = PV_BAND_H;
+    for (int i = 2; i + 1 < argc; i += 2){
+      std::string k = argv[i];
+      if (k == "--iter") iter = atoi(argv[i + 1]);
+      else if (k == "--band") band = atoi(argv[i + 1]);
+      else return usage();
+    }
+    if (iter < 1 || band < 1 || band > H) return usage();
+    return cmdBench(iter, band);
+  }
+  if (cmd == "ppm" && argc > 3){
+    int zoom = 0, pan = 0;
+    for (int i = 4; i + 1 < argc; i += 2){
+      std::string k = argv[i];
+      if (k == "--zoom") zoom = atoi(argv[i + 1]);
+      else if (k == "--pan") pan = atoi(argv[i + 1]);
+      else return usage();
+    }
+    return cmdPpm(atoi(argv[2]), argv[3], zoom, pan);
+  }
+  return usage();
+}
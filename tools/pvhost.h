@@ -0,0 +1,81 @@
+// ===================== tools/pvhost.h =====================
+// Arduino-Ersatz für Host-Tools, die Sketch-Header mit Anzeige-Code einbinden (tools/pvgfx.cpp):
+// String (nur was die Seiten nutzen), dtostrf, constrain, Preferences im Speicher.
+// Vor den SolarDisplay-Headern einbinden.
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+using std::min; using std::max; using std::abs;
+
+#define constrain(a, l, h) ((a) < (l) ? (l) : ((a) > (h) ? (h) : (a)))
+
+static inline char* dtostrf(double v, signed char width, unsigned char prec, char* out){
+  sprintf(out, "%*.*f", width, prec, v);
+  return out;
+}
+
+class String {
+public:
+  String() {}
+  String(const char* s) : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v)           { s_ = std::to_string(v); }
+  String(unsigned v)      { s_ = std::to_string(v); }
+  String(long v)          { s_ = std::to_string(v); }
+  String(unsigned long v) { s_ = std::to_string(v); }
+  String(float v, unsigned char dec = 2)  { fmt(v, dec); }
+  String(double v, unsigned char dec = 2) { fmt(v, dec); }
+
+  const char* c_str() const { return s_.c_str(); }
+  unsigned length() const { return (unsigned)s_.size(); }
+  int indexOf(char c) const { size_t p = s_.find(c); return p == std::string::npos ? -1 : (int)p; }
+  bool endsWith(const char* t) const {
+    size_t n = strlen(t);
+    return s_.size() >= n && s_.compare(s_.size() - n, n, t) == 0;
+  }
+  void remove(unsigned idx) { if (idx < s_.size()) s_.erase(idx); }
+
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  String& operator+=(const char* o)   { s_ += o; return *this; }
+  friend String operator+(const String& a, const String& b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String& a, const char* b)   { return String(a.s_ + b); }
+  friend String operator+(const char* a, const String& b)   { return String(a + b.s_); }
+  bool operator==(const String& o) const { return s_ == o.s_; }
+
+private:
+  std::string s_;
+  void fmt(double v, unsigned char dec){ char b[48]; snprintf(b, sizeof(b), "%.*f", dec, v); s_ = b; }
+};
+
+// NVS-Ersatz: ein Speicher für alle Namespaces des Prozesses
+class Preferences {
+public:
+  static std::map<std::string, std::vector<uint8_t>>& store(){ static std::map<std::string, std::vector<uint8_t>> m; return m; }
+  bool begin(const char* ns, bool readOnly = false){ ns_ = ns; (void)readOnly; return true; }
+  void end(){}
+  size_t getBytesLength(const char* key){
+    auto it = store().find(ns_ + "/" + key);
+    return it == store().end() ? 0 : it->second.size();
+  }
+  size_t getBytes(const char* key, void* buf, size_t len){
+    auto it = store().find(ns_ + "/" + key);
+    if (it == store().end() || it->second.size() > len) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+  }
+  size_t putBytes(const char* key, const void* buf, size_t len){
+    store()[ns_ + "/" + key].assign((const uint8_t*)buf, (const uint8_t*)buf + len);
+    return len;
+  }
+private:
+  std::string ns_;
+};
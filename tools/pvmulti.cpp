@@ -0,0 +1,265 @@
+// ===================== tools/pvmulti.cpp =====================
+// Host-Prüfung des Mehrgeräte-Pollers (SolarDisplay/PvPoll.h) mit simulierten Wechselrichtern:
+// Ereignis-Simulation mit Antwortzeit je Endpunkt, Fehlern, Timeouts und Ausfällen.
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvmulti tools/pvmulti.cpp
+//
+// Aufrufe:
+//   pvmulti bench [--lat-ms 60] [--jitter-ms 40] [--rounds 50] [--max 8]
+//       Rundendauer je Geräteanzahl: eine Pipeline je Endpunkt (parallel) vs. alle Geräte
+//       hinter einem Endpunkt (seriell, wie ein einzelner Requester für alles)
+//   pvmulti verify [seed]
+//       Beispiel-Anlage tools/pvmulti_anlage.h: Summen/Meter/SoC im Frame, nie zwei offene
+//       Anfragen je Endpunkt, Geräteausfall, fehlendes Meter, Timeout mit später Antwort,
+//       Integration je Gerät = Anlage
+#define PV_MAX_DEVICES 8
+#define PV_DEVICES_CUSTOM "../tools/pvmulti_anlage.h"
+#include "../SolarDisplay/PvPoll.h"
+#include "../SolarDisplay/PvEnergy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <queue>
+#include <random>
+#include <chrono>
+
+// ---------- simulierte Geräte ----------
+struct SimDev {
+  int32_t  pvW = 0, gridW = 0, battW = 0;
+  int16_t  temp10 = 300;
+  uint16_t socx10 = 500;
+};
+
+static void simRegister(const SimDev& d, uint16_t addr, uint16_t* w){
+  auto put32 = [&](int32_t v){ w[0] = (uint16_t)((uint32_t)v >> 16); w[1] = (uint16_t)v; };
+  switch (addr){
+    case 32064: put32(d.pvW); break;
+    case 37113: put32(d.gridW); break;
+    case 37001: put32(d.battW); break;
+    case 32087: w[0] = (uint16_t)d.temp10; break;
+    case 37004: w[0] = d.socx10; break;
+    default:    w[0] = w[1] = (uint16_t)(addr & 0xFF); break;
+  }
+}
+
+// ---------- Transport: Ereignisse mit Antwortzeit ----------
+struct Ev { uint32_t t; uint8_t pipe; uint16_t tag; uint8_t dev; uint16_t addr; uint16_t* buf; bool ok; };
+struct EvLater { bool operator()(const Ev& a, const Ev& b) const { return a.t > b.t; } };
+
+struct SimTx;
+typedef PvPoller<SimTx> Poller;
+
+struct SimTx {
+  Poller*            pl = nullptr;
+  const PvDeviceCfg* cfg = nullptr;
+  std::vector<SimDev> dev;
+  std::priority_queue<Ev, std::vector<Ev>, EvLater> q;
+  std::mt19937       rng{1};
+  uint32_t           now = 0;
+  uint32_t           latMs = 60, jitterMs = 40;
+  std::vector<uint32_t> epLatMs;        // je Pipeline fest (0 = latMs + Jitter)
+  std::vector<bool>     epDead;         // Endpunkt nicht verbunden
+  double             errRate = 0;       // Anteil Fehlantworten
+  uint32_t           requests = 0, violations = 0;
+  std::vector<int>   open;              // offene Anfragen je Pipeline
+
+  void setup(Poller* p, const PvDeviceCfg* c, uint8_t n){
+    pl = p; cfg = c; dev.assign(n, SimDev{});
+    epLatMs.assign(PV_MAX_DEVICES, 0); epDead.assign(PV_MAX_DEVICES, false); open.assign(PV_MAX_DEVICES, 0);
+  }
+  uint8_t devIndex(const PvDeviceCfg& d){ return (uint8_t)(&d - cfg); }
+
+  void request(uint8_t p, uint16_t tag, const PvDeviceCfg& d, uint16_t addr, uint8_t, uint16_t* buf){
+    requests++;
+    if (++open[p] > 1) violations++;                 // zwei Anfragen an denselben Endpunkt
+    if (epDead[p]){ open[p]--; pl->done(p, tag, false, now); return; }   // wie readHreg()==0
+    uint32_t lat = epLatMs[p] ? epLatMs[p] : latMs + (jitterMs ? rng() % jitterMs : 0);
+    bool ok = errRate <= 0 || (rng() % 10000) >= errRate * 10000;
+    q.push({ now + lat, p, tag, devIndex(d), addr, buf, ok });
+  }
+
+  // Zeit bis t vorrücken, fällige Antworten zustellen (Daten zum Zeitpunkt der Antwort)
+  void advance(uint32_t t){
+    while (!q.empty() && q.top().t <= t){
+      Ev e = q.top(); q.pop();
+      now = e.t;
+      if (e.ok) simRegister(dev[e.dev], e.addr, e.buf);
+      open[e.pipe]--;
+      pl->done(e.pipe, e.tag, e.ok, now);
+      pl->tick(now);                                 // nächste Anfrage im nächsten loop()
+    }
+    now = t;
+  }
+  uint32_t next() const { return q.empty() ? UINT32_MAX : q.top().t; }
+};
+
+// Eine Runde bis zum Ende simulieren; liefert Dauer (ms)
+static uint32_t runRound(Poller& pl, SimTx& tx){
+  pl.start(tx.now);
+  pl.tick(tx.now);
+  while (!pl.finished(tx.now)){
+    uint32_t t = tx.next();
+    uint32_t tOut = pl.roundT0 + pl.timeoutMs;
+    tx.advance(t < tOut ? t : tOut);
+    pl.tick(tx.now);
+  }
+  return pl.roundMs;
+}
+
+// ---------- bench ----------
+static int cmdBench(int argc, char** argv){
+  uint32_t lat = 60, jitter = 40, rounds = 50, maxDev = 8;
+  for (int i = 2; i < argc; ++i){
+    std::string a = argv[i];
+    auto next = [&]{ return i + 1 < argc ? argv[++i] : "0"; };
+    if      (a == "--lat-ms")    lat = (uint32_t)atoi(next());
+    else if (a == "--jitter-ms") jitter = (uint32_t)atoi(next());
+    else if (a == "--rounds")    rounds = (uint32_t)atoi(next());
+    else if (a == "--max")       maxDev = (uint32_t)atoi(next());
+    else { fprintf(stderr, "unbekannt: %s\n", a.c_str()); return 2; }
+  }
+  if (maxDev > PV_MAX_DEVICES) maxDev = PV_MAX_DEVICES;
+  printf("Antwortzeit %u..%u ms je Anfrage, %u Runden, Meter + Batterie an Gerät 1\n", lat, lat + jitter, rounds);
+  printf("%7s %9s | %12s %12s | %8s %10s\n", "Geräte", "Anfragen", "parallel ms", "seriell ms", "Faktor", "CPU/Runde");
+  bool allOk = true;
+  for (uint32_t n = 1; n <= maxDev; ++n){
+    double ms[2] = {0, 0}; uint32_t req = 0; double cpuUs = 0;
+    for (int serial = 0; serial < 2; ++serial){
+      std::vector<PvDeviceCfg> cfg(n);
+      for (uint32_t i = 0; i < n; ++i){
+        cfg[i] = { {192, 168, 0, (uint8_t)(serial ? 10 : 10 + i)}, 502, (uint8_t)(serial ? i + 1 : 1),
+                   (uint8_t)(i == 0 ? (PVD_METER | PVD_BATT) : PVD_BATT), 0, "WR" };
+      }
+      Poller pl; SimTx tx; tx.latMs = lat; tx.jitterMs = jitter;
+      tx.setup(&pl, cfg.data(), (uint8_t)n);
+      pl.begin(&tx, cfg.data(), (uint8_t)n);
+      pl.timeoutMs = 600000;
+      auto a = std::chrono::steady_clock::now();
+      uint64_t sum = 0;
+      for (uint32_t r = 0; r < rounds; ++r){ sum += runRound(pl, tx); tx.advance(tx.now + 30000); }
+      auto b = std::chrono::steady_clock::now();
+      ms[serial] = (double)sum / rounds;
+      if (!serial){ req = tx.requests / rounds; cpuUs = std::chrono::duration<double, std::micro>(b - a).count() / rounds; }
+      allOk &= tx.violations == 0;
+    }
+    printf("%7u %9u | %12.0f %12.0f | %7.1fx %8.1f us\n", n, req, ms[0], ms[1], ms[1] / ms[0], cpuUs);
+  }
+  printf("parallel: Runde ~ langsamster Endpunkt; seriell: Summe aller Geräte\n");
+  printf("%s\n", allOk ? "OK" : "FEHLER: zwei offene Anfragen an einem Endpunkt");
+  return allOk ? 0 : 1;
+}
+
+// ---------- verify ----------
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-62s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+static int cmdVerify(unsigned seed){
+  const uint32_t MAX_AGE = 90000;
+  Poller pl; SimTx tx; tx.rng.seed(seed);
+  tx.setup(&pl, PV_DEVICES, PV_DEVICE_COUNT);
+  pl.begin(&tx, PV_DEVICES, PV_DEVICE_COUNT);
+  printf("Anlage: %u Geräte an %u Endpunkten\n", PV_DEVICE_COUNT, pl.nPipe);
+  check(pl.nPipe == 2 && pl.pipe[1].n == 2, "WR2/WR3 (gleicher SDongle) teilen eine Pipeline");
+
+  tx.dev[0] = { 4000, -1500, 800, 412, 600 };
+  tx.dev[1] = { 3000, 0, -200, 455, 300 };
+  tx.dev[2] = { 1500, 0, 0, 398, 0 };
+  runRound(pl, tx);
+  PvFrameV4 f{};
+  bool ok = pvAggregate(pl, tx.now, MAX_AGE, f);
+  check(ok && f.pvW == 8500, "PV = Summe aller Geräte");
+  check(f.gridW == -1500, "Netz vom Meter-Gerät");
+  check(f.battW == 600, "Batterie = Summe der Geräte mit Batterie");
+  check(f.socx10 == (600 * 10000 + 300 * 5000 + 7500) / 15000, "SoC nach Kapazität gemittelt");
+  check(f.temp10 == 455, "Temperatur = Maximum");
+  uint32_t reqFull = tx.requests;
+  check(reqFull == PVR_COUNT + (PVR_COUNT - 9) + (PVR_COUNT - 11), "nur benötigte Register je Gerät (Meter 9, Batterie 2)");
+
+  // Fehlantworten + Jitter über viele Runden: nie zwei offene Anfragen je Endpunkt
+  tx.errRate = 0.05; tx.jitterMs = 200;
+  uint32_t okRounds = 0;
+  for (int r = 0; r < 200; ++r){
+    for (auto& d : tx.dev) d.pvW = (int32_t)(tx.rng() % 6000);
+    runRound(pl, tx);
+    PvFrameV4 g{};
+    if (pvAggregate(pl, tx.now, MAX_AGE, g)){
+      int32_t sum = 0;
+      for (uint8_t i = 0; i < PV_DEVICE_COUNT; ++i) if (pl.fresh(i, tx.now, MAX_AGE)) sum += pl.dev[i].live.pvW;
+      okRounds += g.pvW == sum;
+    }
+    tx.advance(tx.now + 30000);
+  }
+  check(okRounds > 150, "5% Fehlantworten: Runden mit gültigem Frame");
+  check(tx.violations == 0, "nie zwei offene Anfragen je Endpunkt");
+  tx.errRate = 0; tx.jitterMs = 40;
+
+  // Ausfall WR2-Endpunkt: WR1 weiter, WR2/WR3 erst mit letztem Wert, dann ohne
+  tx.epDead[1] = true;
+  runRound(pl, tx);
+  ok = pvAggregate(pl, tx.now, MAX_AGE, f);
+  check(ok && pl.fresh(1, tx.now, MAX_AGE) && f.pvW == tx.dev[0].pvW + pl.dev[1].live.pvW + pl.dev[2].live.pvW,
+        "Endpunkt weg: letzter Wert innerhalb maxAge");
+  for (int r = 0; r < 4; ++r){ tx.advance(tx.now + 30000); runRound(pl, tx); }
+  ok = pvAggregate(pl, tx.now, MAX_AGE, f);
+  check(ok && !pl.fresh(1, tx.now, MAX_AGE) && f.pvW == tx.dev[0].pvW, "Endpunkt weg > maxAge: Gerät zählt nicht");
+  tx.epDead[1] = false;
+
+  // Meter-Endpunkt weg -> kein Frame
+  tx.epDead[0] = true;
+  for (int r = 0; r < 5; ++r){ tx.advance(tx.now + 30000); runRound(pl, tx); }
+  check(!pvAggregate(pl, tx.now, MAX_AGE, f), "ohne Meter-Gerät kein Frame");
+  tx.epDead[0] = false;
+
+  // Timeout: WR2-Endpunkt antwortet nach 10 s (Runde 8 s); späte Antwort darf nicht in die nächste Runde
+  tx.epLatMs[1] = 10000;
+  tx.advance(tx.now + 30000);
+  runRound(pl, tx);
+  uint32_t to = pl.dev[1].timeouts;
+  check(to > 0 && pl.roundMs == pl.timeoutMs, "Runde nach Timeout abgebrochen");
+  tx.epLatMs[1] = 0;
+  tx.dev[1].pvW = 1234; tx.dev[1].battW = -77;
+  tx.advance(tx.now + 1000);   // nächste Runde startet, während die alte Anfrage noch offen ist
+  runRound(pl, tx);
+  check(tx.violations == 0, "nach Timeout: keine zweite Anfrage vor der späten Antwort");
+  check(pl.dev[1].live.pvW == 1234 && pl.dev[1].live.battW == -77 && pl.dev[1].live.temp10 == tx.dev[1].temp10,
+        "späte Antwort verworfen, Register richtig zugeordnet");
+
+  // Integration je Gerät (wie integrateDevices) = Anlage (integrateTick), exakt
+  PvEnergyIntegrator ip, id[PV_MAX_DEVICES];
+  PvEnergy plant{}, devSum{};
+  for (uint32_t t = 0; t <= 86400u * 1000u; t += 500){
+    int32_t total = 0;
+    for (uint8_t i = 0; i < PV_DEVICE_COUNT; ++i){
+      int32_t w = (int32_t)(3000 + 2500 * sin(t / 3.6e6 + i)) + (int32_t)(tx.rng() % 200);
+      total += w;
+      PvEnergy d; if (pvEnergyStep(id[i], w, 0, 0, t, true, d)) devSum.e[PVE_GEN] += d.e[PVE_GEN];
+    }
+    PvEnergy d; if (pvEnergyStep(ip, total, 0, 0, t, true, d)) plant.e[PVE_GEN] += d.e[PVE_GEN];
+  }
+  printf("  Tag: Anlage %.6f kWh, Summe Geräte %.6f kWh\n", pvKWh(plant.e[PVE_GEN]), pvKWh(devSum.e[PVE_GEN]));
+  check(plant.e[PVE_GEN] == devSum.e[PVE_GEN], "Summe der Geräte-Integration = Anlage (exakt)");
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvmulti bench [--lat-ms 60] [--jitter-ms 40] [--rounds 50] [--max 8] | verify [seed]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  if (cmd == "bench")  return cmdBench(argc, argv);
+  if (cmd == "verify") return cmdVerify(argc > 2 ? (unsigned)atoi(argv[2]) : 1);
+  return usage();
+}
@@ -0,0 +1,12 @@
+// ===================== tools/pvmulti_anlage.h =====================
+// Beispiel-Anlage für PV_DEVICES_CUSTOM (wird von tools/pvmulti.cpp geprüft):
+// zwei Sun2000, der zweite mit einer weiteren Unit hinter seinem SDongle.
+// Im Sketch: #define PV_DEVICES_CUSTOM "pvmulti_anlage.h" (z.B. in Credentials.h)
+#pragma once
+
+static const PvDeviceCfg PV_DEVICES[] = {
+  //  IP               Port Unit  Flags                  Wh     Name
+  { {192,168,0,10},    502, 1,    PVD_METER | PVD_BATT,  10000, "WR1" },   // Meter + Batterie
+  { {192,168,0,11},    502, 1,    PVD_BATT,              5000,  "WR2" },
+  { {192,168,0,11},    502, 2,    0,                     0,     "WR3" },   // gleicher SDongle wie WR2
+};
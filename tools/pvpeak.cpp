@@ -0,0 +1,447 @@
+// ===================== tools/pvpeak.cpp =====================
+// Host-Prüfung der Spitzen und des 15-min-Mittels (SolarDisplay/PvPeak.h): simulierte Tage Frame
+// für Frame wie im Poller (pvPeakStep() + pvPeakAdd() in Tag und Monat, Tageswechsel über
+// PvRollup.h in den Preferences-Ersatz aus tools/pvhost.h) und gegen Nachrechnen über alle
+// Samples vergleichen: jede Spitze mit Zeitpunkt, jedes Mittel aus den rohen Frames.
+// Zeit hier UTC, Tarif T1 06-22 Uhr.
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvpeak tools/pvpeak.cpp
+//
+// Aufrufe:
+//   pvpeak selftest [--seed 1]
+//       Record v3 (Rundreise, v2-Leser, alte Blobs), STATS_PEAKS, konstanter Bezug, 40 Tage mit
+//       Frame-Verlusten/Ausfällen/Monatswechsel und mit zurückgestellter Uhr: Tage, Monate
+//       (RAM und Record), Wochen gegen Nachrechnen; Tag neu geschrieben; Client übernimmt die
+//       Spitzen des Pollers bei Paketverlust
+//   pvpeak bench [--days 30] [--loss 0.02] [--seed 1]
+//       ns je Sample: Ring gegen Nachrechnen des Fensters, Speicher, Bytes je Record/Nachricht,
+//       Spitzen der ersten Tage
+#include "pvhost.h"
+#include "../SolarDisplay/PvEnergy.h"
+#include "../SolarDisplay/PvRollup.h"
+
+#include <time.h>
+#include <map>
+#include <random>
+#include <chrono>
+
+// ---------- Frames ----------
+struct Frm { uint32_t ts; int32_t pvW, gridW, battW; uint16_t socx10; };
+typedef std::vector<Frm> Frames;
+
+static const uint32_t T0 = 1740787200u;   // 2025-03-01 00:00 UTC
+static bool tariffT1(uint32_t ts){ const uint32_t h = ts % 86400 / 3600; return h >= 6 && h < 22; }
+static int32_t dayOf(uint32_t ts){ return (int32_t)(ts / 86400); }   // = pvDayNum (UTC)
+static uint32_t monthOf(uint32_t ts){ return pvRollupId(PVL_MONTH, dayOf(ts)); }
+
+struct SimOpt {
+  int      days = 40;
+  double   loss = 0.02;      // Frame verloren
+  double   outage = 0.3;     // je Tag: WLAN/Poller 10-60 min weg
+  bool     batt = true;
+  uint32_t backAt = 0;       // > 0: Uhr nach so vielen s um 20 min zurück
+  unsigned seed = 1;
+};
+
+// PV mit Wolken, Grundlast + Wasserkocher/Herd + abends manchmal das Auto, Batterie nimmt den
+// Überschuss (5 kW, 10 kWh); Physik in 5-s-Schritten, Frames alle 30 s (+ Rundendauer)
+static Frames simulate(const SimOpt& o){
+  std::mt19937 rng(o.seed);
+  std::normal_distribution<double> N(0, 1);
+  std::uniform_real_distribution<double> U(0, 1);
+  Frames v;
+  double cloud = 1, soc = 40, extra = 0, ev = 0;
+  uint32_t extraUntil = 0, evFrom = 0, evUntil = 0, outFrom = 0, outUntil = 0;
+  double next = 0;
+  uint32_t back = 0;
+  const uint32_t end = (uint32_t)o.days * 86400u;
+  for (uint32_t t = 0; t < end; t += 5){
+    const double hr = fmod(t / 3600.0, 24.0);
+    if (t % 86400 == 0){
+      if (U(rng) < o.outage){ outFrom = t + (uint32_t)(U(rng) * 86000); outUntil = outFrom + 600 + (uint32_t)(U(rng) * 3000); }
+      if (U(rng) < 0.3){ evFrom = t + 17 * 3600 + (uint32_t)(U(rng) * 3 * 3600); evUntil = evFrom + 3600 + (uint32_t)(U(rng) * 7200); }
+    }
+    double pv = 0;
+    if (hr > 6 && hr < 20){
+      cloud += (1 - cloud) * 0.01 + 0.03 * N(rng);
+      cloud = std::max(0.15, std::min(1.0, cloud));
+      pv = 8000 * pow(sin(M_PI * (hr - 6) / 14.0), 1.5) * cloud;
+    }
+    if (t >= extraUntil && U(rng) < 5.0 / 720){ extra = 800 + 2500 * U(rng); extraUntil = t + 120 + (uint32_t)(1800 * U(rng)); }
+    ev = t >= evFrom && t < evUntil ? 11000 : 0;
+    const double load = 300 + (t < extraUntil ? extra : 0) + ev + 20 * N(rng);
+    double batt = 0;
+    if (o.batt){
+      const double sur = pv - load;
+      batt = sur > 0 ? (soc < 100 ? std::min(sur, 5000.0) : 0) : (soc > 5 ? std::max(sur, -5000.0) : 0);
+      soc = std::max(0.0, std::min(100.0, soc + batt * 5 / 3600.0 / 10000 * 100));
+    }
+    if (o.backAt && !back && t >= o.backAt) back = 1200;
+    if (t >= next){
+      next = t + 30 + 2 * U(rng);
+      if ((t >= outFrom && t < outUntil) || U(rng) < o.loss) continue;
+      Frm f;
+      f.ts = T0 + t - back;
+      f.pvW = (int32_t)lround(pv); f.battW = (int32_t)lround(batt);
+      f.gridW = (int32_t)lround(pv - load - batt);   // + Einspeisung, - Bezug
+      f.socx10 = o.batt ? (uint16_t)floor(soc * 10) : 0;
+      v.push_back(f);
+    }
+  }
+  return v;
+}
+
+// ---------- Nachrechnen ----------
+// Je Sample das Fenster aus den rohen Frames: Intervalle (j-1, j], deren Ende in einem der
+// letzten 15 Minuten-Fächer liegt, nicht länger als PV_PEAK_GAP_S, nicht über eine zurückgestellte Uhr
+struct Ref { std::map<int32_t, PvPeaks> day; std::map<uint32_t, PvPeaks> mon; };
+
+static int32_t impOf(const Frm& f){ return f.gridW < 0 ? -f.gridW : 0; }
+
+static int32_t bruteDemand(const Frames& v, size_t k, size_t seg){
+  int64_t e = 0; uint32_t cov = 0;
+  const uint32_t slot = v[k].ts / PV_PEAK_SLOT_S;
+  for (size_t j = k; j > seg; --j){
+    if (v[j].ts / PV_PEAK_SLOT_S + PV_PEAK_WIN_SLOTS <= slot) break;
+    const uint32_t dt = v[j].ts - v[j-1].ts;
+    if (dt > PV_PEAK_GAP_S) continue;
+    e += (int64_t)(impOf(v[j-1]) + impOf(v[j])) * dt; cov += dt;
+  }
+  if ((uint64_t)cov * 100 < (uint64_t)PV_PEAK_WIN_SLOTS * PV_PEAK_SLOT_S * PV_PEAK_COVER_PCT) return -1;
+  return (int32_t)((e + cov) / (2 * (int64_t)cov));
+}
+
+static void refHi(int32_t& v, uint32_t& t, int32_t x, uint32_t ts){ if (!t || x > v || (x == v && ts < t)){ v = x; t = ts; } }
+static void refLo(int32_t& v, uint32_t& t, int32_t x, uint32_t ts){ if (!t || x < v || (x == v && ts < t)){ v = x; t = ts; } }
+
+static void refSample(PvPeaks& p, const Frm& f, int32_t dem){
+  const uint32_t ts = f.ts;
+  p.n++;
+  refHi(p.impW, p.impTs, impOf(f), ts);
+  refHi(p.expW, p.expTs, f.gridW > 0 ? f.gridW : 0, ts);
+  refHi(p.pvW, p.pvTs, f.pvW > 0 ? f.pvW : 0, ts);
+  const int64_t l = (int64_t)f.pvW - f.gridW - f.battW;
+  refHi(p.loadW, p.loadTs, l > 0 ? (int32_t)l : 0, ts);
+  refHi(p.chgW, p.chgTs, f.battW > 0 ? f.battW : 0, ts);
+  refHi(p.disW, p.disTs, f.battW < 0 ? -f.battW : 0, ts);
+  if (f.socx10 || f.battW){ refLo(p.socLo, p.socLoTs, f.socx10, ts); refHi(p.socHi, p.socHiTs, f.socx10, ts); }
+  if (dem >= 0){
+    refHi(p.demW, p.demTs, dem, ts);
+    if (tariffT1(ts)) refHi(p.demT1W, p.demT1Ts, dem, ts);
+    else              refHi(p.demT2W, p.demT2Ts, dem, ts);
+  }
+}
+
+// Tag/Monat wie im Sketch: nach dem Datum des Frames (bei zurückgestellter Uhr der neue Stand)
+static Ref brute(const Frames& v){
+  Ref r;
+  size_t seg = 0;
+  for (size_t k = 0; k < v.size(); ++k){
+    if (k && v[k].ts < v[k-1].ts) seg = k;
+    const int32_t dem = bruteDemand(v, k, seg);
+    PvPeaks z; pvPeakClear(z);
+    refSample(r.day.emplace(dayOf(v[k].ts), z).first->second, v[k], dem);
+    refSample(r.mon.emplace(monthOf(v[k].ts), z).first->second, v[k], dem);
+  }
+  return r;
+}
+
+// ---------- wie der Poller ----------
+struct Store {
+  Preferences p;
+  PvRollupPrefs<Preferences> st{p};
+  Store(){ Preferences::store().clear(); p.begin("pvstats"); }
+};
+
+struct Poller {
+  Store s;
+  PvRollup r;
+  PvPeakWin w;
+  PvEnergyIntegrator integ;
+  PvAgg day, mon;
+  int32_t cur = 0;
+  Poller(){ memset(&w, 0, sizeof(w)); pvAggClear(day); pvAggClear(mon); }
+
+  void saveDay(int32_t n, const PvAgg& a){
+    char key[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key));
+    PvAgg old; s.st.load(key, old);
+    s.st.save(key, a);
+    pvRollupDay(r, s.st, n, old, a);
+  }
+  // handleDayMonthRollover() (Tag nach dem Frame-Zeitstempel statt der eigenen Uhr)
+  void rollover(int32_t d){
+    if (!cur){ cur = d; return; }
+    if (d == cur) return;
+    saveDay(cur, day);
+    if (pvRollupId(PVL_MONTH, d) != pvRollupId(PVL_MONTH, cur)){
+      char key[12]; pvRollupKey(PVL_MONTH, pvRollupId(PVL_MONTH, d), key, sizeof(key));
+      s.st.load(key, mon);
+    }
+    pvAggClear(day);
+    cur = d;
+  }
+  bool frame(const Frm& f, PvPeakSample& smp){
+    rollover(dayOf(f.ts));
+    PvEnergy d;
+    if (pvEnergyStep(integ, f.pvW, f.gridW, f.battW, f.ts * 1000u, tariffT1(f.ts), d)){ pvEnergyAdd(day, d); pvEnergyAdd(mon, d); }
+    if (!pvPeakStep(w, f.ts, f.pvW, f.gridW, f.battW, f.socx10, tariffT1(f.ts), smp)) return false;
+    pvPeakAdd(day.pk, smp);
+    pvPeakAdd(mon.pk, smp);
+    return true;
+  }
+  void finish(){ if (cur) saveDay(cur, day); }
+  PvAgg load(uint8_t lvl, uint32_t id){
+    char key[12]; pvRollupKey(lvl, id, key, sizeof(key));
+    PvAgg a; s.st.load(key, a); return a;
+  }
+};
+
+// ---------- Selbsttest ----------
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  if (!ok) fails++;
+}
+
+static bool same(const PvPeaks& a, const PvPeaks& b){ return !memcmp(&a, &b, sizeof(a)); }
+
+static PvPeaks somePeaks(uint32_t base){
+  PvPeaks p; pvPeakClear(p);
+  uint8_t b[PV_PEAKS_WIRE];
+  for (size_t i = 0; i < sizeof(b); ++i) b[i] = (uint8_t)(base + i * 7);
+  pvWireDecode(b, sizeof(b), p);
+  return p;
+}
+
+// ganzer Lauf gegen Nachrechnen; liefert Anzahl Tage
+static int runCompare(const SimOpt& o, const char* name){
+  const Frames v = simulate(o);
+  const Ref ref = brute(v);
+  Poller P;
+  PvPeakSample s;
+  for (const Frm& f : v) P.frame(f, s);
+  const PvAgg monRam = P.mon; const uint32_t lastMon = P.cur ? pvRollupId(PVL_MONTH, P.cur) : 0;
+  P.finish();
+  int days = 0, dayOk = 0, monOk = 0, mons = 0;
+  for (const auto& d : ref.day){
+    days++;
+    if (same(P.load(PVL_DAY, pvRollupId(PVL_DAY, d.first)).pk, d.second)) dayOk++;
+  }
+  for (const auto& m : ref.mon){
+    mons++;
+    if (same(P.load(PVL_MONTH, m.first).pk, m.second)) monOk++;
+  }
+  // Wochen: Zusammenführen der nachgerechneten Tage
+  std::map<uint32_t, PvPeaks> wk;
+  for (const auto& d : ref.day){
+    PvPeaks z; pvPeakClear(z);
+    pvPeakMerge(wk.emplace(pvRollupId(PVL_WEEK, d.first), z).first->second, d.second);
+  }
+  int wkOk = 0;
+  for (const auto& w : wk) if (same(P.load(PVL_WEEK, w.first).pk, w.second)) wkOk++;
+  char b[128];
+  snprintf(b, sizeof(b), "%s: %d/%d Tage gleich (Spitzen, Zeit, Mittel, n)", name, dayOk, days);
+  check(days > 0 && dayOk == days, b);
+  snprintf(b, sizeof(b), "%s: %d/%d Monate (Record), %d/%zu Wochen gleich", name, monOk, mons, wkOk, wk.size());
+  check(monOk == mons && wkOk == (int)wk.size(), b);
+  snprintf(b, sizeof(b), "%s: laufender Monat im RAM gleich", name);
+  check(lastMon && same(monRam.pk, ref.mon.at(lastMon)), b);
+  return days;
+}
+
+static int selftest(unsigned seed){
+  // Record und Nachricht
+  {
+    PvAgg a; pvAggClear(a);
+    for (uint8_t i = 0; i < PVE_COUNT; ++i) a.e[i] = (int64_t)(i + 1) * 123456789012LL;
+    a.pk = somePeaks(seed);
+    uint8_t b[PV_EREC_MAX];
+    const size_t n = pvAggEncode(a, b);
+    PvAgg back; PvEnergy e;
+    const bool ok = pvAggDecode(b, n, back) && !memcmp(back.e, a.e, sizeof(a.e)) && same(back.pk, a.pk);
+    check(n == PV_EREC_MAX && n == 44 + 92 && ok, "Record v3: Rundreise (136 Byte)");
+    check(pvEnergyDecode(b, n, e) && !memcmp(e.e, a.e, sizeof(a.e)), "Record v3: v2-Leser übernimmt die Kanäle");
+    PvEnergyRec r2; pvEnergyEncode(a, r2);
+    PvEnergyKWh k1 = pvEnergyToKWh(a);
+    PvAgg a2, a1;
+    const bool old = pvAggDecode((const uint8_t*)&r2, sizeof(r2), a2) && !memcmp(a2.e, a.e, sizeof(a.e)) && !a2.pk.n && !a2.pk.impTs &&
+                     pvAggDecode((const uint8_t*)&k1, sizeof(k1), a1) && !a1.pk.n;
+    check(old, "Record v2/v1: Kanäle, Spitzen leer");
+    check(!pvAggDecode(b, 3, back), "Record: zu kurz abgelehnt");
+    uint8_t m[PV_PEAKS_MSG];
+    PayloadPeaks h; PvPeaks pk;
+    const size_t ml = pvPeakMsg(m, 20123, PVL_MONTH, a.pk);
+    check(ml == 100 && pvPeakMsgGet(m, ml, h, pk) && h.day == 20123 && h.lvl == PVL_MONTH && same(pk, a.pk) &&
+          !pvPeakMsgGet(m, ml - 1, h, pk), "STATS_PEAKS: Rundreise, zu kurz abgelehnt");
+  }
+  // konstanter Bezug: Mittel erst ab 80 % Abdeckung, dann genau
+  {
+    PvPeakWin w; memset(&w, 0, sizeof(w));
+    PvPeakSample s;
+    int first = -1; bool exact = true;
+    for (int i = 0; i <= 60; ++i){
+      pvPeakStep(w, T0 + 30 * i, 0, -1000, 0, 0, true, s);
+      if (s.dem >= 0 && first < 0) first = i;
+      if (s.dem >= 0 && s.dem != 1000) exact = false;
+    }
+    check(first == 24 && exact, "1000 W Bezug: Mittel ab 12 min (80 % von 15), dann 1000 W");
+    // 3 kW für 5 min mitten in 1 kW: Mittel über 15 min = 1000 + 2000 * 5/15
+    memset(&w, 0, sizeof(w));
+    int32_t best = 0;
+    for (int i = 0; i <= 120; ++i){
+      const int32_t g = i > 40 && i <= 50 ? -3000 : -1000;
+      pvPeakStep(w, T0 + 30 * i, 0, g, 0, 0, true, s);
+      best = std::max(best, s.dem);
+    }
+    check(best >= 1660 && best <= 1700, "3 kW für 5 min: höchstes 15-min-Mittel ~1667 W");
+    // Lücke länger als PV_PEAK_GAP_S: Fenster leer, Mittel offen
+    pvPeakStep(w, T0 + 30 * 120 + 3600, 0, -1000, 0, 0, true, s);
+    check(s.dem < 0 && w.gaps == 1, "Stunde ohne Frames: Mittel offen, als Lücke gezählt");
+    check(!pvPeakStep(w, 1000, 0, 0, 0, 0, true, s), "Frame ohne gestellte Uhr: nicht gezählt");
+  }
+  // Tage gegen Nachrechnen
+  SimOpt o; o.seed = seed;
+  runCompare(o, "40 Tage, Verluste/Ausfälle");
+  o.loss = 0.2; o.outage = 1; o.days = 10; o.seed = seed + 1;
+  runCompare(o, "10 Tage, 20 % Verlust, täglich Ausfall");
+  o = SimOpt(); o.days = 6; o.backAt = 2 * 86400 + 43200; o.seed = seed + 2;
+  runCompare(o, "Uhr um 20 min zurück");
+  o = SimOpt(); o.days = 5; o.batt = false; o.seed = seed + 3;
+  runCompare(o, "ohne Batterie (SoC leer)");
+  // Tag neu geschrieben (Sync vom Poller): Monat geht nur nach oben, n bleibt richtig
+  {
+    Poller P; PvPeakSample s;
+    SimOpt q; q.days = 3; q.seed = seed;
+    for (const Frm& f : simulate(q)) P.frame(f, s);
+    P.finish();
+    const uint32_t mid = pvRollupId(PVL_MONTH, P.cur);
+    const PvAgg m0 = P.load(PVL_MONTH, mid);
+    PvAgg d = P.load(PVL_DAY, pvRollupId(PVL_DAY, P.cur));
+    P.saveDay(P.cur, d);
+    const PvAgg m1 = P.load(PVL_MONTH, mid);
+    PvAgg lo = d; lo.pk.impW /= 2; lo.pk.n -= 10;
+    P.saveDay(P.cur, lo);
+    const PvAgg m2 = P.load(PVL_MONTH, mid);
+    check(same(m0.pk, m1.pk), "Tag unverändert neu geschrieben: Monat gleich");
+    check(m2.pk.impW == m0.pk.impW && m2.pk.n == m0.pk.n - 10, "Tag mit kleineren Spitzen: Monat bleibt, n folgt dem Tag");
+  }
+  // Client: übernimmt STATS_PEAKS (10 % verloren), zählt selbst nur ohne
+  {
+    SimOpt q; q.days = 20; q.seed = seed + 4;
+    const Frames v = simulate(q);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> U(0, 1);
+    Poller P; PvPeakSample s;
+    PvPeakWin cw; memset(&cw, 0, sizeof(cw));
+    std::map<int32_t, PvPeaks> cday;
+    uint32_t rxTs = 0;   // Frame-Zeit beim letzten STATS_PEAKS (statt millis())
+    auto rx = [&](uint32_t ts, int32_t day, const PvPeaks& pk){
+      if (U(rng) < 0.1) return;
+      uint8_t m[PV_PEAKS_MSG]; PayloadPeaks h; PvPeaks got;
+      if (!pvPeakMsgGet(m, pvPeakMsg(m, day, PVL_DAY, pk), h, got)) return;
+      PvPeaks z; pvPeakClear(z);
+      pvPeakTake(cday.emplace(h.day, z).first->second, got);
+      rxTs = ts;
+    };
+    for (const Frm& f : v){
+      const int32_t d = dayOf(f.ts);
+      if (P.cur && d != P.cur) rx(f.ts, P.cur, P.day.pk);   // Tageswechsel: letzter Stand von gestern
+      P.frame(f, s);
+      PvPeakSample cs;
+      if (U(rng) >= 0.05 && pvPeakStep(cw, f.ts, f.pvW, f.gridW, f.battW, f.socx10, tariffT1(f.ts), cs) &&
+          (!rxTs || f.ts - rxTs >= PV_PEAK_OWN_MS / 1000)){
+        PvPeaks z; pvPeakClear(z);
+        pvPeakAdd(cday.emplace(d, z).first->second, cs);
+      }
+      rx(f.ts, d, P.day.pk);   // nach jeder Runde
+    }
+    P.finish();
+    int eq = 0, n = 0;
+    for (const auto& c : cday){
+      n++;
+      PvPeaks a = c.second, b = P.load(PVL_DAY, pvRollupId(PVL_DAY, c.first)).pk;
+      if (pvPeakSame(a, b)) eq++;
+    }
+    char b[128];
+    snprintf(b, sizeof(b), "Client, 10 %% STATS_PEAKS verloren: %d/%d Tage gleich dem Poller", eq, n);
+    check(n >= 20 && eq >= n - 1, b);
+  }
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+// ---------- Bench ----------
+static void printTs(uint32_t ts){
+  if (!ts){ printf("  -  "); return; }
+  time_t t = ts; struct tm tm; gmtime_r(&t, &tm);
+  printf("%02d:%02d", tm.tm_hour, tm.tm_min);
+}
+
+static int bench(int days, double loss, unsigned seed){
+  SimOpt o; o.days = days; o.loss = loss; o.seed = seed;
+  const Frames v = simulate(o);
+  // Ring (wie im Sketch: Step + Tag + Monat)
+  PvPeakWin w; memset(&w, 0, sizeof(w));
+  PvPeaks d, m; pvPeakClear(d); pvPeakClear(m);
+  PvPeakSample s;
+  const int rep = 20;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < rep; ++r){
+    memset(&w, 0, sizeof(w)); pvPeakClear(d); pvPeakClear(m);
+    for (const Frm& f : v) if (pvPeakStep(w, f.ts, f.pvW, f.gridW, f.battW, f.socx10, tariffT1(f.ts), s)){ pvPeakAdd(d, s); pvPeakAdd(m, s); }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  // Nachrechnen: Fenster je Sample aus den Frames
+  int64_t sink = 0;
+  for (int r = 0; r < rep; ++r) for (size_t k = 0; k < v.size(); ++k) sink += bruteDemand(v, k, 0);
+  auto t2 = std::chrono::steady_clock::now();
+  const double nsRing = std::chrono::duration<double, std::nano>(t1 - t0).count() / (rep * (double)v.size());
+  const double nsBrute = std::chrono::duration<double, std::nano>(t2 - t1).count() / (rep * (double)v.size());
+  printf("%d Tage, %zu Frames (Verlust %.0f %%), Prüfsumme %lld\n", days, v.size(), loss * 100, (long long)(sink & 0xFFFF));
+  printf("%-40s %10.1f ns je Sample\n", "Ring (Step + Tag + Monat)", nsRing);
+  printf("%-40s %10.1f ns je Sample (%.0fx)\n", "Nachrechnen des Fensters aus Frames", nsBrute, nsBrute / nsRing);
+  printf("%-40s %10zu Byte\n", "RAM Fenster (PvPeakWin)", sizeof(PvPeakWin));
+  printf("%-40s %10zu Byte (je Tag/Monat)\n", "RAM Spitzen (PvPeaks)", sizeof(PvPeaks));
+  printf("%-40s %10zu -> %zu Byte\n", "Record v2 -> v3", sizeof(PvEnergyRec), (size_t)PV_EREC_MAX);
+  printf("%-40s %10zu Byte + Kopf %zu\n", "STATS_PEAKS", (size_t)PV_PEAKS_MSG, STATS_HDR_WIRE);
+
+  // Spitzen der ersten Tage
+  const Ref ref = brute(v);
+  printf("\nTag         Bezug         Einsp.        15 min        15 min T1     15 min T2     SoC min\n");
+  int shown = 0;
+  for (const auto& r : ref.day){
+    if (shown++ >= 7) break;
+    int y, mo, dd; pvDayCivil(r.first, y, mo, dd);
+    const PvPeaks& p = r.second;
+    printf("%04d-%02d-%02d ", y, mo, dd);
+    printf("%6d ", p.impW); printTs(p.impTs); printf("  %6d ", p.expW); printTs(p.expTs);
+    printf("  %6d ", p.demW); printTs(p.demTs); printf("  %6d ", p.demT1W); printTs(p.demT1Ts);
+    printf("  %6d ", p.demT2W); printTs(p.demT2Ts); printf("  %4.1f%% ", p.socLo / 10.0); printTs(p.socLoTs);
+    printf("\n");
+  }
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvpeak selftest [--seed N] | bench [--days N] [--loss P] [--seed N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  int days = 30; double loss = 0.02; unsigned seed = 1;
+  for (int i = 2; i < argc; ++i){
+    std::string k = argv[i];
+    if (i + 1 >= argc) return usage();
+    const double v = atof(argv[++i]);
+    if      (k == "--days") days = (int)v;
+    else if (k == "--loss") loss = v;
+    else if (k == "--seed") seed = (unsigned)v;
+    else return usage();
+  }
+  if (cmd == "selftest") return selftest(seed);
+  if (cmd == "bench")    return bench(days, loss, seed);
+  return usage();
+}
@@ -0,0 +1,545 @@
+// ===================== tools/pvpeer.cpp =====================
+// Host-Simulation Verlauf von Peers (SolarDisplay/PvPeer.h + PvCarousel.h): ein Poller und
+// N Clients, jeder mit eigenem NVS (Namensraum im Preferences-Ersatz), Digest und Stufen.
+// Discover/Offer, Anfragen, Karussell und Prüfung laufen wie im Sketch (statsSendOffer(),
+// carTick(), carClientTick(), carVerify(), UDP-Empfang), Nachrichten PvWire-kodiert,
+// Multicast mit Verlust je Empfänger und 1..5 ms Laufzeit.
+// Szenarien: Massenstart neben bereits abgeglichenen Clients, Poller-Loop beschäftigt (Modbus),
+// Poller stumm, Peer mit abweichendem Record, Mitternacht.
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvpeer tools/pvpeer.cpp
+//
+// Aufrufe:
+//   pvpeer selftest [--seed 1]
+//       Digest (nachgeführt = Neuaufbau, auch mit Schreiben mittendrin; leerer Record = keiner;
+//       ohne laufenden Tag), Quellenwahl (Last, Gleichstand, fremder Digest, älterer Poller,
+//       Ausfall); Simulationen: alle Clients abgeglichen und gleich wie der Poller, Poller-Pakete
+//       beim Massenstart mit Peers höchstens ein Viertel, Verlauf trotz beschäftigtem Poller,
+//       falscher Peer wird erkannt und ersetzt, nach Mitternacht wieder gleicher Digest
+//   pvpeer bench [--years 3] [--loss 0.05] [--seed 1]
+//       Massenstart 5/10/20/50 Clients neben 5 Peers, ohne/mit Peers: Pakete/KB des Pollers,
+//       Zeit bis Verlauf da bzw. geprüft (p50/p95/max); Poller beschäftigt bzw. stumm
+#include "pvhost.h"
+#include "../SolarDisplay/PvCarousel.h"
+#include "../SolarDisplay/PvPeer.h"
+#include "../SolarDisplay/PvClock.h"
+#include "../SolarDisplay/PvBoot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <algorithm>
+
+static const int32_t TODAY = pvDayNum(2026, 10, 18);
+static const size_t  UDP_OVERHEAD = 28;
+static const uint32_t DAY_MS = 86400000u;
+
+static PvEnergy randDay(std::mt19937& rng){
+  std::uniform_int_distribution<int> wh(0, 40000);
+  PvEnergy a;
+  for (uint8_t i = 0; i < PVE_COUNT; ++i) a.e[i] = (int64_t)wh(rng) * PV_E_PER_MWH * 1000 + wh(rng);
+  return a;
+}
+static bool same(const PvEnergy& a, const PvEnergy& b){ return memcmp(a.e, b.e, sizeof(a.e)) == 0; }
+
+// ---------- Netz (0 = Poller, Adresse = Index + 1) ----------
+struct Pkt { int src; uint8_t type; std::vector<uint8_t> pl; };
+enum { ALL = -1 };
+
+struct Net {
+  std::mt19937 rng;
+  double loss;
+  int nodes;
+  std::multimap<uint32_t, std::pair<int, Pkt>> q;
+  std::vector<uint64_t> pkts, bytes;   // je Knoten gesendet
+  Net(unsigned seed, double l, int n) : rng(seed), loss(l), nodes(n), pkts(n), bytes(n) {}
+  void send(uint32_t now, int src, int dst, uint8_t type, const uint8_t* pl, size_t len){
+    pkts[src]++; bytes[src] += STATS_HDR_WIRE + len + UDP_OVERHEAD;
+    std::uniform_real_distribution<double> u(0, 1);
+    std::uniform_int_distribution<int> lat(1, 5);
+    for (int d = 0; d < nodes; ++d){
+      if (d == src || (dst != ALL && d != dst) || u(rng) < loss) continue;
+      q.emplace(now + lat(rng), std::make_pair(d, Pkt{ src, type, std::vector<uint8_t>(pl, pl + len) }));
+    }
+  }
+};
+
+// ---------- Knoten ----------
+struct Node {
+  int id = 0;
+  bool isPoller = false;
+  uint32_t ip() const { return (uint32_t)id + 1; }
+  // NVS (Tage, Stufen, Digest)
+  Preferences p;
+  PvRollupPrefs<Preferences> st{p};
+  PvRollup roll;
+  PvDigest dig;
+  PvDigestRebuild digRb;
+  bool load(const char* key, PvEnergy& a){ return st.load(key, a); }
+  void save(const char* key, const PvEnergy& a){ st.save(key, a); }
+  bool day(int32_t n, PvEnergy& a){ char k[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), k, sizeof(k)); return st.load(k, a); }
+  uint32_t nvsWrites = 0;
+  void saveDay(int32_t n, const PvEnergy& a){   // saveDayToNVS()
+    char k[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), k, sizeof(k));
+    PvEnergy old; st.load(k, old);
+    st.save(k, a); nvsWrites++;
+    pvRollupDay(roll, *this, n, old, a);
+    pvDigestOnSave(dig, digRb, n, old, a);
+  }
+  // Sender (Poller, Peer)
+  PvCarSender car;
+  bool carReq = false, carServe = false;
+  uint32_t busyUntil = 0, downUntil = 0;   // Poller: loop() blockiert bzw. gar nicht erreichbar
+  // Client
+  bool up = false;
+  uint32_t bootMs = 0, discAt = 0, discGap = PV_DISCOVER_MS, offerMs = 0;
+  PvCarReceiver rx;
+  PvPeerTable peers;
+  uint32_t askIp = 0, askRx = 0;
+  bool toPoller = false, tailServe = false, synced = false;
+  uint32_t histMs = 0, syncMs = 0, retries = 0;
+  PvEnergy dayAgg;   // Poller: laufender Tag; Client: eigene Integration (weicht etwas ab)
+
+  void begin(int i, bool poller){
+    id = i; isPoller = poller; carServe = poller;
+    char ns[16]; snprintf(ns, sizeof(ns), "n%d", i); p.begin(ns);
+    pvEnergyClear(dayAgg);
+  }
+};
+
+struct World {
+  Net net;
+  std::vector<Node> n;
+  std::mt19937 rng;
+  int32_t today = TODAY;
+  World(unsigned seed, double loss, int nodes) : net(seed, loss, nodes), n(nodes), rng(seed * 13 + 5) {
+    Preferences::store().clear();
+    for (int i = 0; i < nodes; ++i) n[i].begin(i, i == 0);
+  }
+
+  // carAddressed(): ohne Quelle ist der Poller gemeint
+  bool addressed(Node& x, uint32_t src){
+    if (x.isPoller && !src) return true;
+    return x.carServe && src && src == x.ip();
+  }
+  void onReq(Node& x, const Pkt& p){
+    PayloadCarReq q{0}; pvWireDecode(p.pl.data(), p.pl.size(), q);
+    if (addressed(x, q.src)) x.carReq = true;
+  }
+  void onNack(Node& x, const Pkt& p){
+    PayloadCarNack h;
+    if (!pvWireDecode(p.pl.data(), p.pl.size(), h) || h.n > PV_CAR_SPANS || !addressed(x, h.src)) return;
+    if (p.pl.size() < PvWire<PayloadCarNack>::size + h.n * PvWire<PayloadCarSpan>::size) return;
+    PayloadCarSpan sp[PV_CAR_SPANS];
+    for (uint8_t k = 0; k < h.n; ++k)
+      pvWireDecode(p.pl.data() + PvWire<PayloadCarNack>::size + k * PvWire<PayloadCarSpan>::size, PvWire<PayloadCarSpan>::size, sp[k]);
+    if (x.car.blocks) pvCarNack(x.car, h, sp); else x.carReq = true;
+  }
+  bool hist(Node& x, uint16_t load, PayloadOfferHist& h){   // carHist()
+    if (x.digRb.active) return false;
+    PvEnergy t; x.day(today, t);
+    h = pvDigestOffer(x.dig, today, t, load);
+    return true;
+  }
+  void sendOffer(Node& x, int dst, uint32_t now){   // statsSendOffer()
+    uint16_t load = x.car.pending;
+    if (x.isPoller && now < x.busyUntil) load += PV_PEER_POLLER_BIAS;
+    PayloadOfferHist h;
+    const bool hh = hist(x, load, h);
+    uint8_t pkt[PvWire<PayloadOffer>::size + PV_TIME_WIRE + PvWire<PayloadOfferHist>::size];
+    PayloadOffer off{ STATS_SERVER_PORT, (uint16_t)(STATS_OFFER_CAROUSEL | (x.isPoller ? 0 : STATS_OFFER_PEER) | (hh ? STATS_OFFER_HIST : 0)) };
+    uint8_t* p = pkt + pvWireEncode(off, pkt);
+    p += pvFrameTimeSeal(p, x.isPoller ? 1792000000000ull + now : 0, x.isPoller);
+    if (hh) p += pvWireEncode(h, p);
+    net.send(now, x.id, dst, STATS_OFFER, pkt, (size_t)(p - pkt));
+  }
+  void storeDay(Node& x, int32_t d, const PvEnergy* a){   // carStoreDay()
+    if (!a && d >= today) return;
+    PvEnergy old, zero; pvEnergyClear(zero);
+    const bool have = x.day(d, old);
+    if (!a) a = &zero;
+    if ((have || pvEnergyZero(*a)) && same(old, *a)) return;
+    x.saveDay(d, *a);
+  }
+
+  void rx(Node& x, const Pkt& p, uint32_t now){
+    if (x.isPoller){
+      if (now < x.downUntil) return;
+      if (p.type == STATS_DISCOVER) sendOffer(x, p.src, now);
+      if (p.type == STATS_CAR_REQ) onReq(x, p);
+      if (p.type == STATS_CAR_NACK) onNack(x, p);
+      return;
+    }
+    if (!x.up) return;
+    switch (p.type){
+      case STATS_DISCOVER: if (x.carServe) sendOffer(x, p.src, now); break;
+      case STATS_OFFER:{
+        PayloadOffer off;
+        if (!pvWireDecode(p.pl.data(), p.pl.size(), off)) return;
+        const bool peer = off.flags & STATS_OFFER_PEER;
+        PayloadOfferHist h;
+        const size_t at = PvWire<PayloadOffer>::size + PV_TIME_WIRE;
+        const bool hh = (off.flags & STATS_OFFER_HIST) && pvWireDecode(p.pl.data() + at, p.pl.size() > at ? p.pl.size() - at : 0, h);
+        pvPeerOffer(x.peers, (uint32_t)p.src + 1, !peer, hh ? &h : nullptr, now);
+        if (!peer) x.offerMs = now;
+        if ((off.flags & STATS_OFFER_CAROUSEL) && !x.rx.active) pvCarStart(x.rx, now);
+      }break;
+      case STATS_CAR_BLOCK:{
+        PayloadCarBlock b;
+        if (!pvWireDecode(p.pl.data(), p.pl.size(), b)) return;
+        if (p.pl.size() < PvWire<PayloadCarBlock>::size + __builtin_popcount(b.mask) * PvWire<PayloadCarDay>::size) return;
+        if (x.toPoller && p.src != 0) return;
+        if (!pvCarOnBlock(x.rx, b, now)) return;
+        const uint8_t* q = p.pl.data() + PvWire<PayloadCarBlock>::size;
+        for (uint8_t i = 0; i < PV_CAR_DAYS; ++i){
+          const int32_t d = b.first + (int32_t)b.idx * PV_CAR_DAYS + i;
+          if (!(b.mask & (1u << i))){ storeDay(x, d, nullptr); continue; }
+          PayloadCarDay cd; PvWire<PayloadCarDay>::get(cd, q); q += PvWire<PayloadCarDay>::size;
+          const PvEnergy a = pvCarEnergy(cd);
+          storeDay(x, d, &a);
+        }
+      }break;
+      case STATS_CAR_IDLE:{
+        PayloadCarBlock b;
+        if (!pvWireDecode(p.pl.data(), p.pl.size(), b)) return;
+        if (x.toPoller && p.src != 0) return;
+        pvCarOnIdle(x.rx, b, now, rng());
+      }break;
+      case STATS_CAR_REQ: onReq(x, p); break;
+      case STATS_CAR_NACK: onNack(x, p); pvCarOnNack(x.rx, now); break;
+    }
+  }
+
+  void carTick(Node& x, uint32_t now){
+    if (!x.carServe || (x.isPoller && (now < x.busyUntil || now < x.downUntil))) return;
+    if (x.carReq){
+      x.carReq = false;
+      const int32_t first = x.car.idle || !x.car.blocks ? pvCarFirstDay(x, today, true) : x.car.first;
+      pvCarRange(x.car, first, today);
+      pvCarRequest(x.car);
+    }
+    if (x.car.blocks) pvCarRange(x.car, x.car.first, today);
+    const int32_t idx = pvCarNext(x.car, now);
+    if (idx == PVCAR_WAIT) return;
+    uint8_t pl[PV_CAR_BLOCK_MAX];
+    if (idx == PVCAR_SEND_IDLE){ net.send(now, x.id, ALL, STATS_CAR_IDLE, pl, pvCarBuildIdle(x.car, pl)); return; }
+    size_t len = pvCarBuild(x.car, (uint16_t)idx, today, [&](int32_t d, PvEnergy& a){
+      if (d == today){ if (!x.isPoller) return false; a = x.dayAgg; return true; }
+      return x.day(d, a);
+    }, pl);
+    net.send(now, x.id, ALL, STATS_CAR_BLOCK, pl, len);
+  }
+
+  void verify(Node& x, uint32_t now){   // carVerify()
+    if (!x.rx.done || x.synced) return;
+    if (!x.histMs) x.histMs = now;
+    PayloadOfferHist mine;
+    if (!hist(x, 0, mine)) return;
+    const uint8_t v = pvPeerVerify(x.peers, mine);
+    if (v == PVPEER_WAIT) return;
+    if (v == PVPEER_BAD && !x.peers.pollerOnly){ x.peers.pollerOnly = true; pvCarStart(x.rx, now); x.retries++; return; }
+    x.carServe = v == PVPEER_OK;
+    x.synced = true; x.syncMs = now;
+  }
+
+  void clientTick(Node& x, uint32_t now){
+    if (!x.up) return;
+    // Discover wie pvBootStep(): bis ein Poller-Offer da ist bzw. abgeglichen
+    const bool waiting = x.offerMs && now - x.offerMs < PV_SYNC_TIMEOUT_MS;
+    if (!x.synced && !waiting && (int32_t)(now - x.discAt) >= 0){
+      net.send(now, x.id, ALL, STATS_DISCOVER, nullptr, 0);
+      x.discAt = now + x.discGap;
+      x.discGap = std::min<uint32_t>(x.discGap * 2, PV_DISCOVER_MAX);
+    }
+    const uint8_t what = pvCarTick(x.rx, now, rng());
+    if (x.rx.done && x.toPoller){ x.toPoller = false; x.carServe = x.tailServe; }
+    if (what){
+      if (x.askIp && x.rx.rx == x.askRx) pvPeerFail(x.peers, x.askIp);
+      const uint32_t src = x.toPoller ? 0 : pvPeerPick(x.peers, now);
+      x.askIp = src; x.askRx = x.rx.rx;
+      uint8_t pl[PV_CAR_NACK_MAX];
+      if (what == PVCAR_REQ){ PayloadCarReq q{ src }; net.send(now, x.id, ALL, STATS_CAR_REQ, pl, pvWireEncode(q, pl)); }
+      if (what == PVCAR_NACK) net.send(now, x.id, ALL, STATS_CAR_NACK, pl, pvCarBuildNack(x.rx, src, pl));
+    }
+    verify(x, now);
+  }
+
+  void boot(Node& x, uint32_t now){
+    x.up = true; x.bootMs = now; x.discAt = now; x.discGap = PV_DISCOVER_MS;
+  }
+
+  // Mitternacht: Poller sichert den laufenden Tag, Clients ihren eigenen und holen die letzten Blöcke
+  void midnight(uint32_t now){
+    for (auto& x : n){
+      if (!x.isPoller && !x.up) continue;
+      x.saveDay(today, x.dayAgg);
+      pvEnergyClear(x.dayAgg);
+      if (!x.isPoller){
+        pvCarTail(x.rx, now, rng()); x.toPoller = !x.rx.done;
+        if (x.toPoller){ x.tailServe = x.carServe; x.carServe = false; }
+      }
+    }
+    today++;
+  }
+
+  void step(uint32_t now){
+    while (!net.q.empty() && net.q.begin()->first <= now){
+      auto e = net.q.begin()->second; net.q.erase(net.q.begin());
+      rx(n[e.first], e.second, now);
+    }
+    for (auto& x : n){
+      if (!x.isPoller) clientTick(x, now);
+      carTick(x, now);
+    }
+  }
+};
+
+// Stand gleich wie beim Poller: alle Tage vor heute
+static bool matches(World& w, Node& x){
+  PayloadOfferHist a, b;
+  return w.hist(w.n[0], 0, a) && w.hist(x, 0, b) && a.dig == b.dig && a.days == b.days;
+}
+
+static void fillPoller(World& w, int years, std::mt19937& rng){
+  std::uniform_int_distribution<int> pct(0, 99);
+  Node& p = w.n[0];
+  for (int32_t d = w.today - years * 365; d < w.today; ++d) if (pct(rng) >= 3) p.saveDay(d, randDay(rng));
+  p.dayAgg = randDay(rng);
+}
+
+// ---------- Szenarien ----------
+struct Scn {
+  int peers = 5, clients = 20;
+  double loss = 0.05;
+  bool usePeers = true;
+  uint32_t startMs = 20000;     // Massenstart (Peers starten ab 0)
+  uint32_t spread = 1000;
+  uint32_t busyMs = 0;          // Poller-loop() ab startMs so lange blockiert
+  uint32_t downMs = 0;          // Poller ab startMs so lange stumm
+  bool badPeer = false;         // Peer 1 hat einen abweichenden Record
+  bool midnight = false;        // Mitternacht nach dem Massenstart
+  uint32_t limitMs = 240000;
+};
+
+struct Res {
+  int clients = 0, synced = 0, match = 0, retries = 0;
+  uint64_t pollerPkts = 0, pollerBytes = 0, peerPkts = 0;
+  uint32_t hist50 = 0, hist95 = 0, histMax = 0, sync50 = 0, sync95 = 0, syncMax = 0;
+  bool tailOk = true;
+};
+
+static void pct(std::vector<uint32_t> t, uint32_t& p50, uint32_t& p95, uint32_t& mx){
+  if (t.empty()) return;
+  std::sort(t.begin(), t.end());
+  p50 = t[t.size() / 2]; p95 = t[std::min(t.size() - 1, (t.size() * 95) / 100)]; mx = t.back();
+}
+
+static Res run(const Scn& s, int years, unsigned seed){
+  const int nodes = 1 + s.peers + s.clients;
+  World w(seed, s.loss, nodes);
+  std::mt19937 rng(seed);
+  fillPoller(w, years, rng);
+  std::uniform_int_distribution<uint32_t> spread(0, s.spread);
+  std::vector<uint32_t> bootAt(nodes, 0);
+  for (int i = 1; i <= s.peers; ++i) bootAt[i] = spread(rng);
+  for (int i = 1 + s.peers; i < nodes; ++i) bootAt[i] = s.startMs + spread(rng);
+  uint64_t pollerPkts0 = 0, pollerBytes0 = 0;
+  std::vector<uint64_t> peerPkts0(nodes);
+  bool started = false, midDone = false;
+  uint32_t now = 0;
+  for (; now < s.limitMs; ++now){
+    if (now == s.startMs){
+      started = true;
+      Node& P = w.n[0];
+      P.busyUntil = now + s.busyMs; P.downUntil = now + s.downMs;
+      pollerPkts0 = w.net.pkts[0]; pollerBytes0 = w.net.bytes[0];
+      for (int i = 1; i <= s.peers; ++i){
+        peerPkts0[i] = w.net.pkts[i];
+        if (!s.usePeers) w.n[i].carServe = false;
+      }
+      if (s.badPeer && s.peers){ PvEnergy a; w.n[1].day(w.today - 100, a); a.e[PVE_GEN] += 1; w.n[1].saveDay(w.today - 100, a); }
+    }
+    for (int i = 1; i < nodes; ++i) if (!w.n[i].up && now >= bootAt[i]) w.boot(w.n[i], now);
+    if (s.midnight && started && !midDone){
+      bool all = true;
+      for (int i = 1; i < nodes; ++i) all &= w.n[i].synced;
+      if (all){
+        midDone = true;
+        for (int i = 1; i < nodes; ++i){ w.n[i].dayAgg = w.n[0].dayAgg; w.n[i].dayAgg.e[PVE_LOAD] += 7 * i; }   // eigene Integration
+        w.midnight(now);
+      }
+    }
+    w.step(now);
+    if (started && now > s.startMs + s.spread){
+      bool all = true;
+      for (int i = 1; i < nodes; ++i) all &= w.n[i].synced && w.n[i].rx.done;
+      if (all && (!s.midnight || (midDone && w.net.q.empty()))) break;
+    }
+  }
+  Res r; r.clients = s.clients;
+  std::vector<uint32_t> th, ts;
+  for (int i = 1 + s.peers; i < nodes; ++i){
+    Node& x = w.n[i];
+    if (x.histMs) th.push_back(x.histMs - x.bootMs);
+    if (!x.synced) continue;
+    r.synced++;
+    ts.push_back(x.syncMs - x.bootMs);
+    r.match += matches(w, x);
+    r.retries += x.retries;
+  }
+  if (s.midnight) for (int i = 1; i < nodes; ++i) r.tailOk &= matches(w, w.n[i]) && w.n[i].rx.done;
+  pct(th, r.hist50, r.hist95, r.histMax);
+  pct(ts, r.sync50, r.sync95, r.syncMax);
+  r.pollerPkts = w.net.pkts[0] - pollerPkts0; r.pollerBytes = w.net.bytes[0] - pollerBytes0;
+  for (int i = 1; i <= s.peers; ++i) r.peerPkts += w.net.pkts[i] - peerPkts0[i];
+  return r;
+}
+
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+struct Opt { int years = 3; double loss = 0.05; unsigned seed = 1; };
+
+static int cmdSelftest(const Opt& o){
+  std::mt19937 rng(o.seed);
+  // --- Digest ---
+  {
+    World w(o.seed, 0, 2);
+    Node& a = w.n[0]; Node& b = w.n[1];
+    std::uniform_int_distribution<int> day(0, 999);
+    for (int i = 0; i < 3000; ++i) a.saveDay(TODAY - 1000 + day(rng), randDay(rng));
+    PvDigest full;
+    pvDigestRebuildStart(b.digRb, TODAY - 1000, TODAY);
+    for (int32_t d = TODAY - 1000; d <= TODAY; ++d){ PvEnergy e; if (a.day(d, e)) { char k[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, d), k, sizeof(k)); b.st.save(k, e); } }
+    // Neuaufbau mit Schreiben mittendrin: vor und hinter der Leseposition sowie außerhalb
+    bool done = false; int k = 0;
+    while (!done){
+      done = pvDigestRebuildStep(b.digRb, b, 16, full);
+      if (k++ % 5 == 0){
+        const int32_t d = TODAY - 1000 + day(rng);
+        const PvEnergy e = randDay(rng);
+        a.saveDay(d, e); b.saveDay(d, e);
+      }
+    }
+    b.dig = full;
+    check(a.dig.dig == b.dig.dig && a.dig.days == b.dig.days && a.dig.hw == b.dig.hw, "Digest nachgeführt = Neuaufbau (mit Schreiben während des Neuaufbaus)");
+    PvEnergy z; pvEnergyClear(z);
+    const uint64_t before = a.dig.dig;
+    a.saveDay(TODAY - 2000, z);
+    check(a.dig.dig == before && pvDigestDay(5, z) == 0, "leerer Record zählt wie kein Record");
+    PvEnergy t = randDay(rng); a.saveDay(TODAY, t);
+    PayloadOfferHist h = pvDigestOffer(a.dig, TODAY, t, 3);
+    check(h.dig == before && h.hw == TODAY - 1 && h.load == 3, "Angebot ohne laufenden Tag");
+  }
+  // --- Quellenwahl ---
+  {
+    PvPeerTable t;
+    PayloadOfferHist P{ TODAY - 1, 900, 0x1234, 0, 0 }, A = P, B = P, C = P;
+    A.load = 4; B.load = 0; C.dig = 0x9999;
+    pvPeerOffer(t, 10, true, &P, 0);
+    pvPeerOffer(t, 30, false, &A, 0);
+    pvPeerOffer(t, 40, false, &B, 0);
+    pvPeerOffer(t, 20, false, &C, 0);
+    bool ok = pvPeerPick(t, 10) == 40;                        // kleinste Last
+    B.load = 0; pvPeerOffer(t, 35, false, &B, 5);
+    ok &= pvPeerPick(t, 10) == 35;                            // Gleichstand: kleinere Adresse
+    pvPeerFail(t, 35); pvPeerFail(t, 40);
+    ok &= pvPeerPick(t, 10) == 10;                            // Poller (Last 0) vor Peer mit Last 4
+    pvPeerFail(t, 10);
+    ok &= pvPeerPick(t, 10) == 10;                            // Poller nie aufgeben
+    ok &= pvPeerPick(t, PV_PEER_TTL_MS + 10) == 0;            // alles abgelaufen
+    check(ok, "Quellenwahl: Last, Gleichstand, fremder Digest, Ausfall, Ablauf");
+    PvPeerTable u;
+    pvPeerOffer(u, 30, false, &A, 0);
+    ok = pvPeerPick(u, 1) == 30;                              // Poller noch stumm: Peer ungeprüft
+    pvPeerOffer(u, 10, true, nullptr, 2);                     // älterer Poller ohne Digest
+    ok &= pvPeerPick(u, 3) == 10 && pvPeerVerify(u, C) == PVPEER_OK;
+    PvPeerTable v;
+    pvPeerOffer(v, 10, true, &P, 0);
+    ok &= pvPeerVerify(v, P) == PVPEER_OK && pvPeerVerify(v, C) == PVPEER_BAD && pvPeerVerify(PvPeerTable(), P) == PVPEER_WAIT;
+    check(ok, "Quellenwahl ohne Poller/mit älterem Poller, Prüfung");
+  }
+  // --- Simulation ---
+  Scn s;
+  s.clients = 20;
+  Res with = run(s, o.years, o.seed);
+  check(with.synced == s.clients && with.match == s.clients, "Massenstart 20 Clients neben 5 Peers: abgeglichen und gleich");
+  s.usePeers = false;
+  Res without = run(s, o.years, o.seed);
+  char b[96];
+  snprintf(b, sizeof(b), "Poller-Pakete mit Peers <= 1/4 ohne (%llu / %llu)", (unsigned long long)with.pollerPkts, (unsigned long long)without.pollerPkts);
+  check(without.match == s.clients && with.pollerPkts * 4 <= without.pollerPkts, b);
+  s = Scn(); s.busyMs = 30000;
+  Res busy = run(s, o.years, o.seed + 1);
+  snprintf(b, sizeof(b), "Poller 30 s beschäftigt: Verlauf nach p95 %u ms, alle gleich", busy.hist95);
+  check(busy.match == s.clients && busy.hist95 < 10000, b);
+  s = Scn(); s.downMs = 5000; s.badPeer = true;
+  Res bad = run(s, o.years, o.seed + 2);
+  snprintf(b, sizeof(b), "Peer mit falschem Record: erkannt (%d x neu vom Poller), alle gleich", bad.retries);
+  check(bad.match == s.clients && bad.retries > 0, b);
+  s = Scn(); s.midnight = true;
+  Res mid = run(s, o.years, o.seed + 3);
+  check(mid.tailOk, "Mitternacht: gestern vom Poller, Digest wieder gleich");
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static void row(const char* name, int n, const Res& r){
+  printf("%-16s %4d %8llu %8.1f %8llu %7u %7u %7u %7u %7u %7u %5d/%-3d\n", name, n,
+         (unsigned long long)r.pollerPkts, r.pollerBytes / 1024.0, (unsigned long long)r.peerPkts,
+         r.hist50, r.hist95, r.histMax, r.sync50, r.sync95, r.syncMax, r.match, r.clients);
+}
+
+static int cmdBench(const Opt& o){
+  printf("%d Jahre Verlauf, Verlust %.0f %%, 5 Peers abgeglichen, Massenstart über 1 s\n", o.years, o.loss * 100);
+  printf("Zeiten ab Start des Clients: Verlauf da / geprüft (Digest des Pollers)\n\n");
+  printf("%-16s %4s %8s %8s %8s %7s %7s %7s %7s %7s %7s %9s\n", "", "N", "Poll-Pkt", "Poll-KB", "Peer-Pkt",
+         "da p50", "p95", "max", "ok p50", "p95", "max", "gleich");
+  for (int n : { 5, 10, 20, 50 }){
+    Scn s; s.clients = n; s.loss = o.loss;
+    s.usePeers = false; row("ohne Peers", n, run(s, o.years, o.seed + n));
+    s.usePeers = true;  row("mit Peers", n, run(s, o.years, o.seed + n));
+  }
+  printf("\n");
+  for (int peers : { 0, 1 }){
+    Scn s; s.loss = o.loss; s.busyMs = 30000; s.usePeers = peers;
+    row(peers ? "beschäftigt, P" : "beschäftigt", s.clients, run(s, o.years, o.seed));
+  }
+  for (int peers : { 0, 1 }){
+    Scn s; s.loss = o.loss; s.downMs = 20000; s.usePeers = peers;
+    row(peers ? "stumm 20 s, P" : "stumm 20 s", s.clients, run(s, o.years, o.seed));
+  }
+  printf("\nbeschäftigt: loop() des Pollers 30 s blockiert (Offers kommen aus dem UDP-Task);\n"
+         "stumm: Poller 20 s nicht erreichbar, geprüft wird erst mit seinem Offer; P = mit Peers\n");
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvpeer selftest [--seed N] | bench [--years N] [--loss P] [--seed N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  Opt o;
+  for (int i = 2; i + 1 < argc; i += 2){
+    std::string k = argv[i];
+    if (k == "--years") o.years = atoi(argv[i + 1]);
+    else if (k == "--loss") o.loss = atof(argv[i + 1]);
+    else if (k == "--seed") o.seed = (unsigned)atoi(argv[i + 1]);
+    else return usage();
+  }
+  if (o.years < 1 || o.years > PV_ROLLUP_YEARS || o.loss < 0 || o.loss >= 1) return usage();
+  if (cmd == "selftest") return cmdSelftest(o);
+  if (cmd == "bench") return cmdBench(o);
+  return usage();
+}
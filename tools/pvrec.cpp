@@ -0,0 +1,444 @@
+// ===================== tools/pvrec.cpp =====================
+// Frame-Recorder und deterministischer Replayer (Linux/macOS)
+//
+// Bauen:
+//   g++ -std=c++17 -O2 -o pvrec tools/pvrec.cpp
+//
+// Aufrufe:
+//   pvrec record <datei.pvrec> [--if <lokale-ip>] [--sec N]
+//        zeichnet PvFrameV4-Multicast (239.12.12.12:55221) und Stats-Multicast
+//        (239.0.0.58:43210) auf, bis Ctrl-C oder N Sekunden
+//   pvrec info   <datei.pvrec>
+//   pvrec replay <datei.pvrec> [--speed X | --asap] [--from SEK] [--if <lokale-ip>] [--check]
+//        sendet die Aufzeichnung wieder auf die Multicast-Gruppen (reale Clients);
+//        --check: statt Netz prüft die Frames lokal (Client-Kern) und misst den Durchsatz
+//   pvrec bench  [frames]
+//        Round-Trip (schreiben -> lesen -> vergleichen) einer synthetischen
+//        Aufzeichnung und Replay-Durchsatz --asap gegen den Client-Kern
+//
+// Dateiformat (Little Endian):
+//   RecFileHdr | { RecHdr | Paket }* | { RecIndex }* | RecFooter
+//   Alle REC_INDEX_EVERY Pakete ein Indexeintrag (Offset + Zeit) für schnelles --from.
+//   Fehlt der Footer (Abbruch), wird der Index beim Lesen neu aufgebaut.
+#include "../SolarDisplay/PvFrame.h"
+#include "../SolarDisplay/PvStats.h"
+#include "../SolarDisplay/PvRx.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const char* STATS_MCAST_GRP_STR = "239.0.0.58";   // = STATS_MCAST_GRP (PvStats.h)
+
+// ---------- Dateiformat ----------
+#define REC_MAGIC       0x43525650u   // "PVRC"
+#define REC_IDX_MAGIC   0x58495650u   // "PVIX"
+#define REC_INDEX_EVERY 256
+
+enum : uint8_t { CH_FRAME = 0, CH_STATS = 1, CH_COUNT };
+
+struct RecFileHdr {
+  uint32_t magic;      // REC_MAGIC
+  uint16_t version;    // 1
+  uint16_t rsv;
+  uint64_t startUs;    // Wanduhr beim Start (µs seit 1970)
+} __attribute__((packed));
+
+struct RecHdr {
+  uint32_t dtUs;       // Abstand zum vorherigen Paket
+  uint8_t  ch;         // CH_*
+  uint16_t len;        // Paketlänge
+} __attribute__((packed));
+
+struct RecIndex {
+  uint64_t off;        // Dateioffset des RecHdr
+  uint64_t tUs;        // Zeit seit Start
+  uint32_t no;         // Paketnummer
+} __attribute__((packed));
+
+struct RecFooter {
+  uint64_t idxOff;     // Offset des ersten RecIndex
+  uint32_t idxCount;
+  uint32_t pktCount;
+  uint64_t durUs;
+  uint32_t magic;      // REC_IDX_MAGIC
+} __attribute__((packed));
+
+static uint64_t wallUs(){
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+static uint64_t monoUs(){
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------- Schreiben ----------
+struct RecWriter {
+  FILE* f = nullptr;
+  uint64_t lastUs = 0, tUs = 0;
+  uint32_t count = 0;
+  std::vector<RecIndex> idx;
+
+  bool open(const char* path, uint64_t startWallUs){
+    f = fopen(path, "wb");
+    if (!f){ perror(path); return false; }
+    RecFileHdr h{REC_MAGIC, 1, 0, startWallUs};
+    return fwrite(&h, sizeof(h), 1, f) == 1;
+  }
+  // tRelUs: Zeit seit Aufnahmestart (monoton)
+  bool add(uint64_t tRelUs, uint8_t ch, const uint8_t* data, uint16_t len){
+    uint64_t dt = tRelUs - lastUs;
+    if (dt > 0xFFFFFFFFull) dt = 0xFFFFFFFFull;   // > 71 min Pause: gekappt
+    lastUs = tRelUs; tUs += dt;
+    if (count % REC_INDEX_EVERY == 0) idx.push_back({(uint64_t)ftell(f), tUs, count});
+    RecHdr r{(uint32_t)dt, ch, len};
+    if (fwrite(&r, sizeof(r), 1, f) != 1 || fwrite(data, 1, len, f) != len) return false;
+    ++count;
+    return true;
+  }
+  bool close(){
+    if (!f) return false;
+    RecFooter ft{(uint64_t)ftell(f), (uint32_t)idx.size(), count, tUs, REC_IDX_MAGIC};
+    bool ok = idx.empty() || fwrite(idx.data(), sizeof(RecIndex), idx.size(), f) == idx.size();
+    ok = ok && fwrite(&ft, sizeof(ft), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    f = nullptr;
+    return ok;
+  }
+};
+
+// ---------- Lesen ----------
+struct RecPacket { uint64_t tUs; uint8_t ch; std::vector<uint8_t> data; };
+
+struct RecReader {
+  FILE* f = nullptr;
+  RecFileHdr hdr{};
+  RecFooter  ft{};
+  std::vector<RecIndex> idx;
+  uint64_t dataEnd = 0, tUs = 0;
+  uint32_t no = 0;
+
+  bool open(const char* path){
+    f = fopen(path, "rb");
+    if (!f){ perror(path); return false; }
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != REC_MAGIC || hdr.version != 1){
+      fprintf(stderr, "%s: keine pvrec-Datei\n", path); return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    bool haveFooter = false;
+    if (size >= (long)(sizeof(hdr) + sizeof(ft))){
+      fseek(f, size - (long)sizeof(ft), SEEK_SET);
+      if (fread(&ft, sizeof(ft), 1, f) == 1 && ft.magic == REC_IDX_MAGIC){
+        idx.resize(ft.idxCount);
+        fseek(f, (long)ft.idxOff, SEEK_SET);
+        haveFooter = ft.idxCount == 0 || fread(idx.data(), sizeof(RecIndex), idx.size(), f) == idx.size();
+      }
+    }
+    if (haveFooter){ dataEnd = ft.idxOff; }
+    else { dataEnd = (uint64_t)size; rebuildIndex(); }
+    rewind();
+    return true;
+  }
+
+  // Abgebrochene Aufnahme: Index durch Durchlaufen neu aufbauen
+  void rebuildIndex(){
+    idx.clear(); rewind();
+    RecPacket p;
+    uint64_t off = (uint64_t)ftell(f);
+    while (next(p)){
+      if ((no-1) % REC_INDEX_EVERY == 0) idx.push_back({off, p.tUs, no-1});
+      off = (uint64_t)ftell(f);
+    }
+    ft = RecFooter{dataEnd, (uint32_t)idx.size(), no, tUs, REC_IDX_MAGIC};
+    fprintf(stderr, "Hinweis: Footer fehlt, Index neu aufgebaut (%u Pakete)\n", no);
+  }
+
+  void rewind(){ fseek(f, sizeof(hdr), SEEK_SET); tUs = 0; no = 0; }
+
+  // Zum letzten Indexpunkt <= fromUs springen, danach linear bis fromUs
+  void seek(uint64_t fromUs){
+    rewind();
+    for (const RecIndex& e : idx){
+      if (e.tUs > fromUs) break;
+      fseek(f, (long)e.off, SEEK_SET);
+      // tUs des Eintrags = Zeit NACH seinem dt -> Stand davor rekonstruieren beim Lesen
+      tUs = e.tUs; no = e.no;
+      RecHdr r;
+      if (fread(&r, sizeof(r), 1, f) == 1){ tUs -= r.dtUs; fseek(f, (long)e.off, SEEK_SET); }
+    }
+  }
+
+  bool next(RecPacket& p){
+    if ((uint64_t)ftell(f) + sizeof(RecHdr) > dataEnd) return false;
+    RecHdr r;
+    if (fread(&r, sizeof(r), 1, f) != 1) return false;
+    p.data.resize(r.len);
+    if (r.len && fread(p.data.data(), 1, r.len, f) != r.len) return false;
+    tUs += r.dtUs; ++no;
+    p.tUs = tUs; p.ch = r.ch;
+    return true;
+  }
+};
+
+// ---------- Client-Kern (PvRx.h, wie beginListenFrames/statsClientStart) ----------
+struct CheckStats {
+  PvRxState rx;
+  uint64_t stats = 0, statsBad = 0;
+};
+
+static void checkPacket(CheckStats& s, uint8_t ch, const uint8_t* d, size_t n, uint64_t tUs){
+  if (ch == CH_STATS){
+    StatsHdr h;
+    ++s.stats;
+    if (pvRxStats(d, n, h) != PVRX_OK) ++s.statsBad;
+    return;
+  }
+  PvFrameV4 f;
+  auto t0 = std::chrono::steady_clock::now();   // Host: Zeit in ns statt µs verbucht
+  pvRxFrame(s.rx, d, n, 1, (uint32_t)(tUs / 1000), f);
+  pvRxTime(s.rx, (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+}
+
+static void printCheck(const CheckStats& s){
+  printf("Frames:");
+  for (uint8_t i = 0; i < PVRX_COUNT; ++i) printf(" %s=%u", pvRxReasonName(i), s.rx.cnt[i]);
+  printf(" | %.0f ns/Frame | Stats %llu (defekt %llu)\n", s.rx.pkts ? (double)s.rx.usSum / s.rx.pkts : 0.0,
+         (unsigned long long)s.stats, (unsigned long long)s.statsBad);
+}
+
+// ---------- Netz ----------
+static int mcastListen(const char* grp, uint16_t port, const char* ifIp){
+  int s = socket(AF_INET, SOCK_DGRAM, 0);
+  if (s < 0){ perror("socket"); return -1; }
+  int one = 1;
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#ifdef SO_REUSEPORT
+  setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+#endif
+  sockaddr_in a{}; a.sin_family = AF_INET; a.sin_port = htons(port); a.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(s, (sockaddr*)&a, sizeof(a)) < 0){ perror("bind"); close(s); return -1; }
+  ip_mreq m{};
+  inet_pton(AF_INET, grp, &m.imr_multiaddr);
+  m.imr_interface.s_addr = ifIp ? inet_addr(ifIp) : htonl(INADDR_ANY);
+  if (setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, &m, sizeof(m)) < 0){ perror("IP_ADD_MEMBERSHIP"); close(s); return -1; }
+  return s;
+}
+
+static int mcastSender(const char* ifIp){
+  int s = socket(AF_INET, SOCK_DGRAM, 0);
+  if (s < 0){ perror("socket"); return -1; }
+  unsigned char ttl = 1, loop = 1;
+  setsockopt(s, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+  setsockopt(s, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));   // lokale Clients/Tools sehen mit
+  if (ifIp){ in_addr a{}; a.s_addr = inet_addr(ifIp); setsockopt(s, IPPROTO_IP, IP_MULTICAST_IF, &a, sizeof(a)); }
+  return s;
+}
+
+static sockaddr_in mkAddr(const char* ip, uint16_t port){
+  sockaddr_in a{}; a.sin_family = AF_INET; a.sin_port = htons(port);
+  inet_pton(AF_INET, ip, &a.sin_addr);
+  return a;
+}
+
+// ---------- record ----------
+static volatile sig_atomic_t stopFlag = 0;
+static void onSig(int){ stopFlag = 1; }
+
+static int cmdRecord(const char* path, const char* ifIp, double maxSec){
+  int sF = mcastListen(PV_MCAST_GRP_STR, MCAST_PORT, ifIp);
+  int sS = mcastListen(STATS_MCAST_GRP_STR, STATS_MCAST_PORT, ifIp);
+  if (sF < 0 || sS < 0) return 1;
+  RecWriter w;
+  if (!w.open(path, wallUs())) return 1;
+  signal(SIGINT, onSig); signal(SIGTERM, onSig);
+
+  uint64_t t0 = monoUs();
+  pollfd pf[2] = {{sF, POLLIN, 0}, {sS, POLLIN, 0}};
+  uint8_t buf[2048];
+  uint64_t lastPrint = 0;
+  while (!stopFlag){
+    if (maxSec > 0 && (monoUs() - t0) >= (uint64_t)(maxSec * 1e6)) break;
+    if (poll(pf, 2, 200) <= 0) continue;
+    for (int k = 0; k < 2; ++k){
+      if (!(pf[k].revents & POLLIN)) continue;
+      ssize_t n = recv(pf[k].fd, buf, sizeof(buf), 0);
+      if (n <= 0) continue;
+      if (!w.add(monoUs() - t0, k == 0 ? CH_FRAME : CH_STATS, buf, (uint16_t)n)){ perror("write"); stopFlag = 1; }
+    }
+    if (monoUs() - lastPrint > 5000000){ lastPrint = monoUs(); fprintf(stderr, "\r%u Pakete", w.count); }
+  }
+  fprintf(stderr, "\r%u Pakete aufgezeichnet\n", w.count);
+  close(sF); close(sS);
+  return w.close() ? 0 : 1;
+}
+
+// ---------- info ----------
+static int cmdInfo(const char* path){
+  RecReader r;
+  if (!r.open(path)) return 1;
+  uint64_t n[CH_COUNT] = {0, 0}, bytes = 0;
+  uint32_t seqMin = 0, seqMax = 0, gaps = 0, lastSeq = 0;
+  RecPacket p;
+  while (r.next(p)){
+    if (p.ch < CH_COUNT) ++n[p.ch];
+    bytes += p.data.size();
+    PvFrameV4 f;
+    if (p.ch == CH_FRAME && pvWireDecode(p.data.data(), p.data.size(), f)){
+      if (!seqMin) seqMin = f.seq;
+      if (lastSeq && f.seq > lastSeq + 1) gaps += f.seq - lastSeq - 1;
+      lastSeq = f.seq; if (f.seq > seqMax) seqMax = f.seq;
+    }
+  }
+  time_t st = (time_t)(r.hdr.startUs / 1000000);
+  char tb[32]; strftime(tb, sizeof(tb), "%Y-%m-%d %H:%M:%S", localtime(&st));
+  printf("Start     : %s\n", tb);
+  printf("Dauer     : %.1f s\n", r.tUs / 1e6);
+  printf("Pakete    : %u (Frames %llu, Stats %llu), %llu Byte Nutzdaten\n", r.no,
+         (unsigned long long)n[CH_FRAME], (unsigned long long)n[CH_STATS], (unsigned long long)bytes);
+  printf("Frame-seq : %u..%u, %u fehlend\n", seqMin, seqMax, gaps);
+  printf("Index     : %zu Einträge\n", r.idx.size());
+  return 0;
+}
+
+// ---------- replay ----------
+static int cmdReplay(const char* path, double speed, bool asap, double fromSec, const char* ifIp, bool check){
+  RecReader r;
+  if (!r.open(path)) return 1;
+  int s = check ? -1 : mcastSender(ifIp);
+  if (!check && s < 0) return 1;
+  sockaddr_in toF = mkAddr(PV_MCAST_GRP_STR, MCAST_PORT);
+  sockaddr_in toS = mkAddr(STATS_MCAST_GRP_STR, STATS_MCAST_PORT);
+
+  uint64_t fromUs = (uint64_t)(fromSec * 1e6);
+  r.seek(fromUs);
+  CheckStats cs;
+  RecPacket p;
+  uint64_t t0 = monoUs(), firstUs = 0, sent = 0, bytes = 0;
+  bool first = true;
+  signal(SIGINT, onSig);
+  while (!stopFlag && r.next(p)){
+    if (p.tUs < fromUs) continue;
+    if (first){ firstUs = p.tUs; first = false; }
+    if (!asap){
+      uint64_t due = t0 + (uint64_t)((p.tUs - firstUs) / speed);
+      uint64_t now = monoUs();
+      if (due > now) std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+    }
+    if (check) checkPacket(cs, p.ch, p.data.data(), p.data.size(), p.tUs);
+    else sendto(s, p.data.data(), p.data.size(), 0, (const sockaddr*)(p.ch == CH_FRAME ? &toF : &toS), sizeof(sockaddr_in));
+    ++sent; bytes += p.data.size();
+  }
+  double sec = (monoUs() - t0) / 1e6;
+  printf("%llu Pakete in %.3f s (%.0f Pakete/s, %.2f MB/s)\n", (unsigned long long)sent, sec,
+         sec > 0 ? sent / sec : 0.0, sec > 0 ? bytes / sec / 1e6 : 0.0);
+  if (check) printCheck(cs);
+  if (s >= 0) close(s);
+  return 0;
+}
+
+// ---------- bench ----------
+// Synthetischer Tag: Frames alle 30 s mit Sinus-PV, dazwischen Stats-Pakete (kodiert)
+static std::vector<uint8_t> synthFrame(uint32_t seq, uint32_t ts){
+  PvFrameV4 f{};
+  f.seq = seq; f.ts = ts;
+  f.pvW = (int32_t)(seq * 37 % 9000); f.gridW = (int32_t)(seq * 53 % 6000) - 3000; f.battW = (int32_t)(seq % 4000) - 2000;
+  f.socx10 = (uint16_t)(seq % 1000);
+  std::vector<uint8_t> p(PV_FRAME_WIRE);
+  pvFrameEncode(f, p.data());
+  return p;
+}
+
+static int cmdBench(uint32_t frames){
+  const char* path = "/tmp/pvrec_bench.pvrec";
+  uint64_t t0 = monoUs();
+  {
+    RecWriter w;
+    if (!w.open(path, wallUs())) return 1;
+    for (uint32_t i = 1; i <= frames; ++i){
+      std::vector<uint8_t> f = synthFrame(i, 1700000000u + i * 30);
+      w.add((uint64_t)i * 30000000ull, CH_FRAME, f.data(), f.size());
+      if (i % 10 == 0){
+        StatsHdr h{0xCAFE, 1, STATS_DISCOVER, i, 0, 0}; h.crc = pvstats_crc(h, nullptr);
+        uint8_t hb[STATS_HDR_WIRE];
+        w.add((uint64_t)i * 30000000ull + 1000, CH_STATS, hb, pvWireEncode(h, hb));
+      }
+    }
+    if (!w.close()) return 1;
+  }
+  uint64_t tW = monoUs() - t0;
+
+  // Round-Trip prüfen
+  RecReader r;
+  if (!r.open(path)) return 1;
+  RecPacket p;
+  uint32_t i = 0, bad = 0;
+  while (r.next(p)){
+    if (p.ch != CH_FRAME) continue;
+    ++i;
+    std::vector<uint8_t> f = synthFrame(i, 1700000000u + i * 30);
+    if (p.data != f || p.tUs != (uint64_t)i * 30000000ull) ++bad;
+  }
+  bool rtOk = (i == frames && bad == 0 && r.idx.size() == r.ft.idxCount);
+
+  // Seek über Index: höchstens REC_INDEX_EVERY Pakete linear bis zum Ziel
+  const uint64_t target = (uint64_t)(frames / 2) * 30000000ull;
+  r.seek(target);
+  uint32_t skipped = 0;
+  bool seekOk = false;
+  while (r.next(p)){ if (p.tUs >= target){ seekOk = (p.tUs == target && skipped < REC_INDEX_EVERY); break; } ++skipped; }
+  fclose(r.f);
+
+  printf("Schreiben   : %u Frames in %.3f s\n", frames, tW / 1e6);
+  printf("Round-Trip  : %s (%u Frames, %u Abweichungen)\n", rtOk ? "OK" : "FEHLER", i, bad);
+  printf("Index-Seek  : %s\n", seekOk ? "OK" : "FEHLER");
+  printf("Replay asap : ");
+  int rc = cmdReplay(path, 1.0, true, 0.0, nullptr, true);
+  remove(path);
+  return (rtOk && seekOk && rc == 0) ? 0 : 1;
+}
+
+// ---------- main ----------
+static int usage(){
+  fprintf(stderr,
+    "pvrec record <f.pvrec> [--if ip] [--sec N]\n"
+    "pvrec info   <f.pvrec>\n"
+    "pvrec replay <f.pvrec> [--speed X | --asap] [--from SEK] [--if ip] [--check]\n"
+    "pvrec bench  [frames]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  const char* ifIp = nullptr; double sec = 0, speed = 1.0, from = 0; bool asap = false, check = false;
+  for (int i = 3; i < argc; ++i){
+    std::string a = argv[i];
+    if      (a == "--if"    && i+1 < argc) ifIp  = argv[++i];
+    else if (a == "--sec"   && i+1 < argc) sec   = atof(argv[++i]);
+    else if (a == "--speed" && i+1 < argc) speed = atof(argv[++i]);
+    else if (a == "--from"  && i+1 < argc) from  = atof(argv[++i]);
+    else if (a == "--asap")  asap  = true;
+    else if (a == "--check") check = true;
+    else if (cmd != "bench") return usage();
+  }
+  if (speed <= 0) speed = 1.0;
+
+  if (cmd == "record" && argc >= 3) return cmdRecord(argv[2], ifIp, sec);
+  if (cmd == "info"   && argc >= 3) return cmdInfo(argv[2]);
+  if (cmd == "replay" && argc >= 3) return cmdReplay(argv[2], speed, asap, from, ifIp, check);
+  if (cmd == "bench") return cmdBench(argc >= 3 ? (uint32_t)atoi(argv[2]) : 100000);
+  return usage();
+}
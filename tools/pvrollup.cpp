@@ -0,0 +1,324 @@
+// ===================== tools/pvrollup.cpp =====================
+// Host-Prüfung der Verlauf-Stufen (SolarDisplay/PvRollup.h): Tage -> ISO-Woche -> Monat -> Jahr
+// im Preferences-Ersatz aus tools/pvhost.h, geschrieben wie im Sketch (saveDayToNVS).
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvrollup tools/pvrollup.cpp
+//
+// Aufrufe:
+//   pvrollup selftest [--years 10] [--seed 1]
+//       Kalender (Rundreise, ISO-Woche gegen strftime %G%V), Perioden-Schritte, Verlauf mit
+//       Überschreiben (Sync-Stand, dann Tageswechsel) und Neuaufbau mit Schreibzugriffen
+//       mittendrin: jede Woche/jeder Monat/jedes Jahr muss exakt der Summe der Tage entsprechen;
+//       Bereichssummen gegen die Tage
+//   pvrollup bench [--years 10] [--iter 2000] [--nvs-us 300] [--seed 1]
+//       Lesezugriffe und Zeit: Tageswechsel, Seite je Stufe, ganzer Verlauf je Stufe,
+//       Bereichssummen über die Stufen gegen Aufsummieren der Tage, Neuaufbau.
+//       --nvs-us: angenommene Zeit je NVS-Zugriff auf dem ESP32 (Schätzspalte)
+#include "pvhost.h"
+#include "../SolarDisplay/PvEnergy.h"
+#include "../SolarDisplay/PvRollup.h"
+
+#include <time.h>
+#include <random>
+#include <chrono>
+
+// ---------- Speicher mit Zählern ----------
+struct Store {
+  Preferences p;
+  PvRollupPrefs<Preferences> st{p};
+  uint64_t reads = 0, writes = 0;
+  Store(){ Preferences::store().clear(); p.begin("pvstats"); }
+  bool load(const char* key, PvEnergy& a){ reads++; return st.load(key, a); }
+  void save(const char* key, const PvEnergy& a){ writes++; st.save(key, a); }
+  bool has(const char* key){ return p.getBytesLength(key) > 0; }
+};
+
+// wie saveDayToNVS() im Sketch
+static void saveDay(Store& s, PvRollup& r, int32_t n, const PvEnergy& a){
+  char key[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key));
+  PvEnergy old; s.load(key, old);
+  s.save(key, a);
+  pvRollupDay(r, s, n, old, a);
+}
+
+// nur der Tagesrecord (alte Firmware, vor den Stufen)
+static void saveDayRaw(Store& s, int32_t n, const PvEnergy& a){
+  char key[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key));
+  s.save(key, a);
+}
+
+static PvEnergy randDay(std::mt19937& rng){
+  std::uniform_int_distribution<int> wh(0, 40000);
+  PvEnergy a;
+  for (uint8_t i = 0; i < PVE_COUNT; ++i) a.e[i] = (int64_t)wh(rng) * PV_E_PER_MWH * 1000 + wh(rng);   // auch krumme Werte
+  return a;
+}
+
+// Referenz: Summe der gespeicherten Tage der Periode
+static PvEnergy recompute(Store& s, uint8_t lvl, uint32_t id){
+  PvEnergy sum; pvEnergyClear(sum);
+  char key[12];
+  for (int32_t n = pvRollupStart(lvl, id); n < pvRollupStart(lvl, pvRollupStep(lvl, id, 1)); ++n){
+    PvEnergy a; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key));
+    if (s.st.load(key, a)) pvEnergyAdd(sum, a);
+  }
+  return sum;
+}
+
+static bool same(const PvEnergy& a, const PvEnergy& b){ return memcmp(a.e, b.e, sizeof(a.e)) == 0; }
+
+// alle Perioden, die ganz in [from, to] liegen, gegen die Tage prüfen; liefert Abweichungen
+static int verifyLevels(Store& s, int32_t from, int32_t to, int* periods = nullptr){
+  int bad = 0, cnt = 0;
+  char key[12];
+  for (uint8_t lvl = PVL_WEEK; lvl < PVL_COUNT; ++lvl){
+    for (uint32_t id = pvRollupId(lvl, from); pvRollupStart(lvl, id) <= to; id = pvRollupStep(lvl, id, 1)){
+      if (pvRollupStart(lvl, id) < from) continue;
+      PvEnergy a; pvRollupKey(lvl, id, key, sizeof(key));
+      s.st.load(key, a);
+      PvEnergy ref = recompute(s, lvl, id);
+      cnt++;
+      if (!same(a, ref)){
+        if (bad < 5) printf("  %s: %.3f statt %.3f kWh PV\n", key, pvKWh(a.e[PVE_GEN]), pvKWh(ref.e[PVE_GEN]));
+        bad++;
+      }
+    }
+  }
+  if (periods) *periods = cnt;
+  return bad;
+}
+
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+struct Opt { int years = 10; int iter = 2000; double nvsUs = 300; unsigned seed = 1; };
+
+static int cmdSelftest(const Opt& o){
+  // --- Kalender ---
+  {
+    bool civil = true, iso = true;
+    for (int32_t n = pvDayNum(1900, 1, 1); n <= pvDayNum(2200, 12, 31); ++n){
+      int y, m, d; pvDayCivil(n, y, m, d);
+      civil &= pvDayNum(y, m, d) == n;
+      if (n < 0) continue;   // gmtime_r: ab 1970
+      time_t t = (time_t)n * 86400; struct tm tm; gmtime_r(&t, &tm);
+      civil &= tm.tm_year + 1900 == y && tm.tm_mon + 1 == m && tm.tm_mday == d;
+      char b[16]; strftime(b, sizeof(b), "%G%V", &tm);
+      iso &= (uint32_t)atoi(b) == pvRollupId(PVL_WEEK, n);
+    }
+    check(civil, "Tagesnummer <-> Datum 1900-2200 (gegen gmtime ab 1970)");
+    check(iso, "ISO-Woche 1970-2200 gegen strftime %G%V");
+    check(pvRollupId(PVL_WEEK, pvDayNum(2020, 12, 31)) == 202053 && pvRollupId(PVL_WEEK, pvDayNum(2021, 1, 3)) == 202053 &&
+          pvRollupId(PVL_WEEK, pvDayNum(2021, 1, 4)) == 202101 && pvRollupId(PVL_WEEK, pvDayNum(2024, 12, 30)) == 202501,
+          "ISO-Woche an Jahresgrenzen (2020-W53, 2025-W01 ab 30.12.2024)");
+  }
+  // --- Perioden: Start, Schritt vor/zurück ---
+  {
+    bool ok = true;
+    for (uint8_t lvl = PVL_DAY; lvl < PVL_COUNT; ++lvl){
+      uint32_t id = pvRollupId(lvl, pvDayNum(1999, 12, 20));
+      for (int i = 0; i < 2000; ++i){
+        const uint32_t nx = pvRollupStep(lvl, id, 1);
+        ok &= pvRollupId(lvl, pvRollupStart(lvl, id)) == id;
+        ok &= pvRollupId(lvl, pvRollupStart(lvl, nx) - 1) == id;
+        ok &= pvRollupStep(lvl, nx, -1) == id && pvRollupStep(lvl, id, 7) == pvRollupStep(lvl, pvRollupStep(lvl, id, 10), -3);
+        id = nx;
+      }
+    }
+    check(ok, "Periodenstart/-schritt je Stufe (2000 Perioden ab 1999)");
+    char k[4][12];
+    for (uint8_t lvl = 0; lvl < PVL_COUNT; ++lvl) pvRollupKey(lvl, pvRollupId(lvl, pvDayNum(2026, 3, 5)), k[lvl], sizeof(k[lvl]));
+    check(!strcmp(k[0], "D20260305") && !strcmp(k[1], "W202610") && !strcmp(k[2], "M202603") && !strcmp(k[3], "Y2026"),
+          "NVS-Keys (D/M wie bisher, W/Y neu)");
+  }
+
+  std::mt19937 rng(o.seed);
+  const int32_t to = pvDayNum(2026, 10, 18), from = pvDayNum(2026 - o.years, 1, 1);
+
+  // --- Verlauf: Tageswechsel, Sync-Stand vorab, Boot-Cache, späte Korrekturen ---
+  {
+    Store s; PvRollup r;
+    for (int32_t n = from; n <= to; ++n){
+      if (rng() % 5 == 0) saveDay(s, r, n, randDay(rng));   // Sync: Zwischenstand des Pollers
+      saveDay(s, r, n, randDay(rng));                         // Tageswechsel: endgültiger Wert
+    }
+    std::uniform_int_distribution<int32_t> day(from, to);
+    for (int i = 0; i < 500; ++i) saveDay(s, r, day(rng), randDay(rng));   // erneuter Sync, Boot-Cache
+    for (int i = 0; i < 50; ++i){ int32_t n = day(rng); char key[12]; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key));
+      PvEnergy a; s.st.load(key, a); saveDay(s, r, n, a); }                  // gleicher Wert: nichts zu tun
+    int periods = 0, bad = verifyLevels(s, from, to, &periods);
+    char b[96]; snprintf(b, sizeof(b), "Stufen = Summe der Tage (%d Jahre, %d Perioden, mit Überschreiben)", o.years, periods);
+    check(bad == 0, b);
+    check(s.writes <= (uint64_t)r.days * 4, "je geschriebenem Tag höchstens 3 Stufen-Records + Tag");
+  }
+
+  // --- Neuaufbau aus alten D-Keys, mit Schreibzugriffen währenddessen ---
+  {
+    Store s; PvRollup r;
+    for (int32_t n = from; n <= to; ++n) saveDayRaw(s, n, randDay(rng));
+    // alte Monats-Keys (monthAgg beim Monatswechsel) stimmen nicht mit den Tagen: werden ersetzt
+    char key[12];
+    for (uint32_t id = pvRollupId(PVL_MONTH, from); pvRollupStart(PVL_MONTH, id) <= to; id = pvRollupStep(PVL_MONTH, id, 1)){
+      pvRollupKey(PVL_MONTH, id, key, sizeof(key)); s.save(key, randDay(rng));
+    }
+    pvRollupRebuildStart(r, from, to);
+    std::uniform_int_distribution<int32_t> day(from, to);
+    int steps = 0;
+    while (!pvRollupRebuildStep(r, s, PV_ROLLUP_STEP_DAYS)){
+      steps++;
+      int32_t n = (steps % 3 == 0) ? r.cur - 1 - (int32_t)(rng() % 4) : day(rng);   // oft in der laufenden Periode
+      if (n >= from && n <= to) saveDay(s, r, n, randDay(rng));
+    }
+    check(r.rebuilt == (uint32_t)(to - from + 1), "Neuaufbau: jeder Tag genau einmal gelesen");
+    check(verifyLevels(s, from, to) == 0, "Neuaufbau mit Schreibzugriffen mittendrin = Summe der Tage");
+    pvRollupKey(PVL_WEEK, pvRollupId(PVL_WEEK, from), key, sizeof(key));
+    check(pvRollupStart(PVL_WEEK, pvRollupId(PVL_WEEK, from)) == from || !s.has(key),
+          "angeschnittene erste Woche wird nicht geschrieben");
+    // danach wie im Betrieb weiter
+    for (int i = 0; i < 200; ++i) saveDay(s, r, day(rng), randDay(rng));
+    check(verifyLevels(s, from, to) == 0, "nach dem Neuaufbau: Tageswechsel/Sync nachgeführt");
+
+    // --- Abfragen ---
+    bool sumOk = true; uint32_t maxReads = 0;
+    for (int i = 0; i < 300; ++i){
+      int32_t a = day(rng), b = day(rng); if (a > b) std::swap(a, b);
+      PvEnergy sum, ref; pvEnergyClear(ref);
+      uint32_t reads = pvRollupSum(s, a, b, sum);
+      for (int32_t n = a; n <= b; ++n){ PvEnergy x; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key)); if (s.st.load(key, x)) pvEnergyAdd(ref, x); }
+      sumOk &= same(sum, ref);
+      if (reads > maxReads) maxReads = reads;
+    }
+    char b[96]; snprintf(b, sizeof(b), "Bereichssumme über Stufen = Summe der Tage (max. %u Zugriffe)", maxReads);
+    check(sumOk && maxReads <= (uint32_t)(31 + 11 + o.years + 1 + 11 + 31), b);
+    PvEnergy out[12]; uint32_t ids[12];
+    pvRollupRange(s, PVL_MONTH, 202603, 12, out, ids);
+    check(ids[0] == 202504 && ids[8] == 202512 && ids[9] == 202601 && ids[11] == 202603, "Bereich je Stufe: 12 Monate bis 03/2026");
+  }
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static double nowUs(){
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() / 1000.0;
+}
+
+static int cmdBench(const Opt& o){
+  std::mt19937 rng(o.seed);
+  const int32_t to = pvDayNum(2026, 10, 18), from = pvDayNum(2026 - o.years + 1, 1, 1);
+  Store s; PvRollup r;
+  for (int32_t n = from; n <= to; ++n) saveDay(s, r, n, randDay(rng));
+  const uint64_t days = (uint64_t)(to - from + 1);
+  printf("%d Jahre, %llu Tage, %zu NVS-Keys; ESP32-Schätzung mit %.0f us je Zugriff\n\n",
+         o.years, (unsigned long long)days, Preferences::store().size(), o.nvsUs);
+  printf("%-34s %10s %10s %12s\n", "", "Zugriffe", "Host us", "ESP32 ms");
+  auto row = [&](const char* name, double acc, double us){ printf("%-34s %10.1f %10.2f %12.1f\n", name, acc, us, acc * o.nvsUs / 1000.0); };
+
+  // Tageswechsel: Tag + Woche/Monat/Jahr lesen und schreiben
+  {
+    s.reads = s.writes = 0;
+    double t0 = nowUs();
+    for (int i = 0; i < o.iter; ++i) saveDay(s, r, to - (i % 30), randDay(rng));
+    double us = (nowUs() - t0) / o.iter;
+    row("Tageswechsel (Tag + 3 Stufen)", (double)(s.reads + s.writes) / o.iter, us);
+  }
+  // eine Seite je Stufe, nur die Stufe gelesen, gegen Aufsummieren der Tage
+  static const char* nm[PVL_COUNT] = { "Tage", "Wochen", "Monate", "Jahre" };
+  const uint16_t bars[PVL_COUNT] = { 30, 26, 12, 10 };
+  for (uint8_t lvl = PVL_DAY; lvl < PVL_COUNT; ++lvl){
+    PvEnergy out[32]; uint32_t ids[32];
+    s.reads = 0;
+    double t0 = nowUs();
+    for (int i = 0; i < o.iter; ++i) pvRollupRange(s, lvl, pvRollupId(lvl, to - (i % 400)), bars[lvl], out, ids);
+    double us = (nowUs() - t0) / o.iter;
+    char b[64]; snprintf(b, sizeof(b), "Seite %u %s (Stufe)", bars[lvl], nm[lvl]); row(b, (double)s.reads / o.iter, us);
+    if (lvl == PVL_DAY) continue;
+    // dieselbe Seite aus den Tagen (bisher: Monate als eigener Record, Wochen/Jahre gar nicht)
+    s.reads = 0;
+    const int it = o.iter / 20 + 1;
+    char key[12];
+    t0 = nowUs();
+    for (int i = 0; i < it; ++i){
+      const int32_t end = pvRollupStart(lvl, pvRollupStep(lvl, pvRollupId(lvl, to - (i % 400)), 1));
+      for (int32_t n = pvRollupStart(lvl, pvRollupStep(lvl, pvRollupId(lvl, to - (i % 400)), -(int32_t)bars[lvl] + 1)); n < end; ++n){
+        PvEnergy a; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key)); s.load(key, a);
+      }
+    }
+    us = (nowUs() - t0) / it;
+    snprintf(b, sizeof(b), "Seite %u %s (aus Tagen)", bars[lvl], nm[lvl]);
+    row(b, (double)s.reads / it, us);
+  }
+  // ganzer Verlauf je Stufe
+  for (uint8_t lvl = PVL_WEEK; lvl < PVL_COUNT; ++lvl){
+    uint16_t cnt = 1;
+    for (uint32_t id = pvRollupId(lvl, from); id != pvRollupId(lvl, to); id = pvRollupStep(lvl, id, 1)) cnt++;
+    std::vector<PvEnergy> out(cnt);
+    s.reads = 0;
+    const int it = o.iter / 10 + 1;
+    double t0 = nowUs();
+    for (int i = 0; i < it; ++i) pvRollupRange(s, lvl, pvRollupId(lvl, to), cnt, out.data(), nullptr);
+    double us = (nowUs() - t0) / it;
+    char b[64]; snprintf(b, sizeof(b), "ganzer Verlauf: %u %s", cnt, nm[lvl]); row(b, (double)s.reads / it, us);
+  }
+  // Bereichssummen über den ganzen Zeitraum: Stufen gegen Tage
+  {
+    std::uniform_int_distribution<int32_t> day(from, to);
+    std::vector<std::pair<int32_t,int32_t>> q(o.iter);
+    for (auto& x : q){ x.first = day(rng); x.second = day(rng); if (x.first > x.second) std::swap(x.first, x.second); }
+    PvEnergy sum;
+    s.reads = 0;
+    double t0 = nowUs();
+    for (auto& x : q) pvRollupSum(s, x.first, x.second, sum);
+    row("Bereichssumme zufällig (Stufen)", (double)s.reads / o.iter, (nowUs() - t0) / o.iter);
+    s.reads = 0;
+    const int it = o.iter / 20 + 1;
+    char key[12];
+    t0 = nowUs();
+    for (int i = 0; i < it; ++i){
+      pvEnergyClear(sum);
+      for (int32_t n = q[i].first; n <= q[i].second; ++n){ PvEnergy a; pvRollupKey(PVL_DAY, pvRollupId(PVL_DAY, n), key, sizeof(key)); if (s.load(key, a)) pvEnergyAdd(sum, a); }
+    }
+    row("Bereichssumme zufällig (Tage)", (double)s.reads / it, (nowUs() - t0) / it);
+  }
+  // Neuaufbau (alte Firmware -> Stufen)
+  {
+    s.reads = s.writes = 0;
+    PvRollup rb;
+    double t0 = nowUs();
+    pvRollupRebuildStart(rb, from, to);
+    uint32_t calls = 0;
+    while (!pvRollupRebuildStep(rb, s, PV_ROLLUP_STEP_DAYS)) calls++;
+    row("Neuaufbau gesamt", (double)(s.reads + s.writes), nowUs() - t0);
+    printf("%-34s %10u Aufrufe aus loop() zu je %u Tagen\n", "", calls + 1, PV_ROLLUP_STEP_DAYS);
+    printf("\n%s\n", verifyLevels(s, from, to) == 0 ? "Stufen = Summe der Tage: ok" : "Stufen = Summe der Tage: FEHLER");
+  }
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvrollup selftest [--years N] [--seed N] | bench [--years N] [--iter N] [--nvs-us US] [--seed N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  Opt o;
+  for (int i = 2; i + 1 < argc; i += 2){
+    std::string k = argv[i];
+    if (k == "--years") o.years = atoi(argv[i + 1]);
+    else if (k == "--iter") o.iter = atoi(argv[i + 1]);
+    else if (k == "--nvs-us") o.nvsUs = atof(argv[i + 1]);
+    else if (k == "--seed") o.seed = (unsigned)atoi(argv[i + 1]);
+    else return usage();
+  }
+  if (o.years < 1 || o.years > 100 || o.iter < 1) return usage();
+  if (cmd == "selftest") return cmdSelftest(o);
+  if (cmd == "bench") return cmdBench(o);
+  return usage();
+}
@@ -0,0 +1,398 @@
+// ===================== tools/pvsleep.cpp =====================
+// Host-Simulation Strom sparen (SolarDisplay/PvSleep.h) mit eigener Uhr: der Poller startet
+// Runden wie loop() (Abfrage im 300-ms-Raster, Start frühestens 30 s nach dem letzten), die
+// Rundendauer streut (Modbus-Antwortzeiten, ab und zu ein Gerät im Timeout, Runden ohne
+// gültige Daten), er hängt den Plan an die echten Frame-Bytes (hinter Zeit- und
+// Batterie-Anhang). Der Client läuft wie sleepTick(): pvSleepPlan() je loop(), Pause 5 ms mit
+// Funk bzw. bis 20 ms ohne; ein Frame (und die Stats-Nachrichten der Runde direkt danach)
+// kommt nur an, wenn der Funk in dem Moment an ist. Dazu Verluste im Netz, Ausfälle und
+// Neustarts des Pollers, Gangunterschied der Uhren, Nachfragen nach Lücken (Funk an).
+// Vergleich: Funk immer an (bisher), "Takt" (Client schätzt selbst: nächster Frame einen Takt
+// nach diesem, ohne Anhang), Plan des Pollers.
+// Strom: Richtwerte (angenommen, nicht gemessen): wach mit WIFI_PS_NONE und 240 MHz 100 mA,
+// Modem-Sleep mit 80 MHz 28 mA, Backlight des CYD voll 60 mA (linear im PWM-Tastgrad).
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvsleep tools/pvsleep.cpp
+//
+// Aufrufe:
+//   pvsleep selftest [--seed 1]
+//       Anhang (Rundreise, CRC, zu kurz, Lage hinter dem Batterie-Anhang), Plan des Pollers aus
+//       den Rundendauern, Client-Plan (Nachlauf, Fenster, ausgebliebener Frame, Lücke, busy,
+//       ohne Anhang, Überlauf von millis()); Simulation: Funk-Anteil und verschlafene Frames
+//       je Muster, eigene Messung des Clients gegen die Simulation; Backlight (Nacht, Rampen,
+//       Berührung, LDR, Schritte, Tastgrad)
+//   pvsleep bench [--hours 24] [--seed 1]
+//       je Muster und Verfahren: Funk an %, Wecken je h, verschlafene Frames und Stats-
+//       Nachrichten (Promille der zugestellten), Strom nach Richtwerten; Backlight über einen Tag
+#include "../SolarDisplay/PvSleep.h"
+#include "../SolarDisplay/PvBatt.h"
+#include "../SolarDisplay/PvClock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+static const uint32_t FRAME_MS = 30000;     // POLL_INTERVAL_MS
+static const uint32_t TICK_MS  = 300;       // POLL_TICK_MS
+static const uint32_t TIMEOUT_MS = 8000;
+static const uint64_t HOUR_MS  = 3600000u;
+static const size_t   AT_BATT  = PV_FRAME_WIRE + PV_TIME_WIRE;   // ohne Energie-Teile
+static const size_t   AT_SCHED = AT_BATT + PV_BATT_WIRE;
+static const double   MA_ON = 100, MA_SLEEP = 28, MA_BL = 60;
+
+enum { POL_ON = 0, POL_TAKT, POL_PLAN };
+static const char* POL_NAME[] = { "immer an", "Takt", "Plan" };
+
+// ---------- Muster ----------
+struct Pattern {
+  const char* name;
+  double   loss = 0.01;          // Verlust je Paket im Netz
+  double   timeout = 0.02;       // Runde mit einem Gerät im Timeout (Dauer ~8 s)
+  double   invalid = 0.01;       // Runde ohne gültige Daten (kein Frame)
+  int      restarts = 0;         // Neustarts des Pollers je Tag
+  int      outages = 0;          // WLAN des Pollers weg (3..15 min) je Tag
+  double   ppm = 40;             // Gang der Client-Uhr gegen den Poller
+  bool     sched = true;         // Poller hängt den Plan an (false: älterer Poller)
+  bool     busy = false;         // Client die ganze Zeit beschäftigt (Abgleich/Karussell)
+};
+
+static const Pattern PATTERNS[] = {
+  { "ruhig",              0,    0,    0,    0, 0, 40 },
+  { "Verlust 1 %",        0.01, 0.02, 0.01, 0, 0, 40 },
+  { "Verlust 5 %",        0.05, 0.02, 0.01, 0, 0, 40 },
+  { "Timeouts 15 %",      0.01, 0.15, 0.01, 0, 0, 40 },
+  { "Neustarts/Ausfälle", 0.01, 0.02, 0.01, 6, 4, 40 },
+  { "Uhr 500 ppm",        0.01, 0.02, 0.01, 0, 0, 500 },
+  { "älterer Poller",     0.01, 0.02, 0.01, 0, 0, 40, false },
+  { "immer beschäftigt",  0.01, 0.02, 0.01, 0, 0, 40, true, true },
+};
+
+// ---------- Poller ----------
+struct Pkt {
+  uint64_t at;                   // Ankunft beim Client (wahre ms)
+  bool     frame, lost;
+  uint32_t seq;
+  std::vector<uint8_t> b;
+};
+
+static std::vector<uint8_t> framePkt(uint32_t seq, const PvSched* sc){
+  PvFrameV4 f{}; f.seq = seq; f.ts = 1790000000u + seq * 30;
+  std::vector<uint8_t> b(AT_SCHED + PV_SCHED_WIRE, 0);
+  pvFrameEncode(f, b.data());
+  PvBattEta e{}; e.eta20s = e.fullS = e.emptyS = -1; e.dir = PVB_IDLE;
+  pvBattSeal(b.data() + AT_BATT, e);
+  if (sc) pvSchedSeal(b.data() + AT_SCHED, *sc); else b.resize(AT_SCHED);
+  return b;
+}
+
+// Runden wie loop() des Pollers; wahre Zeit = Uhr des Pollers seit Start (Neustart: neu ab 0)
+static std::vector<Pkt> pollerRun(const Pattern& p, uint64_t endMs, std::mt19937& rng){
+  std::uniform_real_distribution<double> U(0, 1);
+  std::vector<Pkt> out;
+  // Neustarts und Ausfälle über die Laufzeit verteilt
+  const double days = (double)endMs / (24 * HOUR_MS);
+  std::vector<uint64_t> restarts;
+  for (int k = 0; k < (int)(p.restarts * days + 0.5); ++k) restarts.push_back((uint64_t)(U(rng) * endMs));
+  std::sort(restarts.begin(), restarts.end());
+  std::vector<std::pair<uint64_t, uint64_t>> outs;
+  for (int k = 0; k < (int)(p.outages * days + 0.5); ++k){
+    const uint64_t a = (uint64_t)(U(rng) * endMs);
+    outs.push_back({ a, a + (uint64_t)((3 + 12 * U(rng)) * 60000) });
+  }
+  auto down = [&](uint64_t t){ for (auto& o : outs) if (t >= o.first && t < o.second) return true; return false; };
+
+  uint64_t boot = 0; size_t nextRestart = 0;
+  uint32_t seq = 0;
+  PvSchedTx tx;
+  uint32_t pollStart = 0;            // wie pollStartMs: 0 nach dem Start
+  uint64_t t = 0;
+  while (t < endMs){
+    if (nextRestart < restarts.size() && t >= restarts[nextRestart]){
+      boot = restarts[nextRestart++] + 15000;   // Start bis WLAN steht
+      t = boot; seq = 0; tx = PvSchedTx(); pollStart = 0;
+      continue;
+    }
+    t += TICK_MS + (uint64_t)(U(rng) * 8);      // loop()-Raster
+    const uint32_t ms = (uint32_t)(t - boot);
+    if (ms - pollStart < FRAME_MS) continue;
+    pollStart = ms;
+    uint32_t dur = 200 + (uint32_t)(U(rng) * 700);
+    if (U(rng) < p.timeout) dur = TIMEOUT_MS + (uint32_t)(U(rng) * 300);
+    pvSchedRound(tx, dur);
+    const uint64_t sent = t + dur;
+    if (U(rng) < p.invalid) continue;
+    const PvSched sc = pvSchedNext(tx, pollStart, FRAME_MS, TICK_MS, TIMEOUT_MS, ms + dur);
+    Pkt f; f.frame = true; f.seq = ++seq; f.b = framePkt(seq, p.sched ? &sc : nullptr);
+    f.at = sent + 2 + (uint64_t)(U(rng) * 15);
+    f.lost = down(sent) || U(rng) < p.loss;
+    out.push_back(f);
+    for (int k = 0; k < 2; ++k){               // STATS_DEVICES, STATS_PEAKS
+      Pkt s; s.frame = false; s.seq = seq; s.at = f.at + 5 + (uint64_t)(U(rng) * 60) + 20 * k;
+      s.lost = down(sent) || U(rng) < p.loss;
+      out.push_back(s);
+    }
+  }
+  std::sort(out.begin(), out.end(), [](const Pkt& a, const Pkt& b){ return a.at < b.at; });
+  return out;
+}
+
+// ---------- Client ----------
+struct Res {
+  uint64_t frames = 0, delivered = 0, rx = 0, slept = 0;   // Frames: gesendet, zugestellt, empfangen, verschlafen
+  uint64_t stats = 0, statsSlept = 0;                      // Stats-Nachrichten zugestellt / verschlafen
+  uint64_t onMs = 0, totalMs = 0;
+  uint32_t wakes = 0, misses = 0, gaps = 0;
+  uint32_t ownDuty = 0;                                    // pvSleepDutyPermille() des Clients
+  double duty() const { return totalMs ? 100.0 * onMs / totalMs : 100; }
+  double ma() const { return totalMs ? (MA_ON * onMs + MA_SLEEP * (totalMs - onMs)) / totalMs : MA_ON; }
+};
+
+static Res simulate(const Pattern& p, int pol, double hours, unsigned seed){
+  std::mt19937 rng(seed);
+  const uint64_t endMs = (uint64_t)(hours * HOUR_MS);
+  const std::vector<Pkt> pk = pollerRun(p, endMs, rng);
+  std::uniform_real_distribution<double> U(0, 1);
+  const double gain = 1 + p.ppm * 1e-6;
+  const uint32_t off = (uint32_t)(U(rng) * 4e9);           // millis() des Clients: beliebiger Stand, läuft über
+  auto cms = [&](uint64_t t){ return (uint32_t)((uint64_t)(t * gain) + off); };
+
+  Res r;
+  PvSleep s;
+  uint32_t lastSeq = 0;
+  uint64_t busyUntil = 60000;                               // Start, Abgleich
+  bool radio = true;
+  size_t i = 0;
+  uint64_t t = 0;
+  while (t < endMs){
+    PvSleepPlan pl{ true, 0 };
+    if (pol != POL_ON) pl = pvSleepPlan(s, cms(t), p.busy || t < busyUntil);
+    radio = pl.radio;
+    const uint32_t idle = pl.idleMs < PV_SLEEP_LOOP_MS ? pl.idleMs : PV_SLEEP_LOOP_MS;
+    const uint64_t tn = t + (radio ? 5 : (idle ? idle : 1));
+    // Pakete bis zum nächsten loop(): ankommen nur mit Funk
+    for (; i < pk.size() && pk[i].at <= tn; ++i){
+      const Pkt& q = pk[i];
+      if (q.frame) r.frames++;
+      if (q.lost) continue;
+      if (!q.frame){ r.stats++; r.statsSlept += !radio; continue; }
+      r.delivered++;
+      if (!radio){ r.slept++; continue; }
+      r.rx++;
+      const bool gap = lastSeq && q.seq > lastSeq + 1;      // kleiner: Poller neu (PVRX_RESTART)
+      lastSeq = q.seq;
+      if (gap) busyUntil = q.at + 500 + (uint64_t)(U(rng) * 1000);   // STATS_FILL_REQ und Antwort
+      PvSched sc;
+      const bool ok = pvSchedGet(q.b.data(), q.b.size(), AT_SCHED, sc);
+      if (pol == POL_TAKT){ sc = PvSched{ FRAME_MS, TICK_MS, FRAME_MS }; }
+      pvSleepFrame(s, cms(q.at), gap, pol == POL_TAKT || ok ? &sc : nullptr);
+    }
+    r.totalMs += tn - t; if (radio) r.onMs += tn - t;
+    t = tn;
+  }
+  r.wakes = s.wakes; r.misses = s.misses; r.gaps = s.gaps;
+  r.ownDuty = pol == POL_ON ? 1000 : pvSleepDutyPermille(s);
+  return r;
+}
+
+static double permille(uint64_t a, uint64_t b){ return b ? 1000.0 * a / b : 0; }
+
+// ---------- Backlight über einen Tag ----------
+struct BlRes { double duty = 0, level = 0; uint32_t changes = 0; };
+
+// Berührungen tagsüber (jede Stunde 8..21 Uhr eine), ohne bzw. mit LDR (Tageslicht + Wolken)
+static BlRes backlightDay(bool ldr, unsigned seed){
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> U(0, 1);
+  BlRes r;
+  uint8_t lvl = PV_BL_DAY, duty = pvBacklightDuty(lvl);
+  PvAmbient a;
+  bool cloud = false;
+  uint64_t touch = 0; bool touched = false;
+  const uint32_t n = 24 * 3600 * 1000 / PV_BL_TICK_MS;
+  for (uint32_t k = 0; k < n; ++k){
+    const uint64_t t = (uint64_t)k * PV_BL_TICK_MS;
+    const int32_t minute = (int32_t)(t / 60000);
+    if (minute % 60 == 17 && minute >= 8 * 60 && minute < 22 * 60 && t % 60000 == 0){ touch = t; touched = true; }
+    if (ldr){
+      const double h = minute / 60.0, sun = h > 6.5 && h < 20 ? sin(M_PI * (h - 6.5) / 13.5) : 0;
+      if (U(rng) < 1.0 / 3000) cloud = !cloud;                  // Wolken für einige Minuten
+      const double light = sun * (cloud ? 0.3 : 1);
+      const double noise = (U(rng) - 0.5) * 0.04 * (PV_LDR_DARK - PV_LDR_BRIGHT);   // ADC ±2 %
+      pvAmbientAdd(a, (int32_t)(PV_LDR_DARK + (PV_LDR_BRIGHT - PV_LDR_DARK) * light + noise));
+    }
+    const uint8_t l = pvBacklightStep(lvl, pvBacklightTarget(minute, pvAmbientLevel(a), touched ? (uint32_t)(t - touch) : 0xFFFFFFFFu));
+    if (pvBacklightDuty(l) != duty) r.changes++;
+    lvl = l; duty = pvBacklightDuty(l);
+    r.duty += duty / 255.0; r.level += lvl / 255.0;
+  }
+  r.duty *= 100.0 / n; r.level *= 100.0 / n;
+  return r;
+}
+
+// ---------- Prüfung ----------
+static int fails = 0;
+static void check(bool ok, const char* what){
+  printf("%-66s %s\n", what, ok ? "ok" : "FEHLER");
+  fails += !ok;
+}
+
+struct Opt { double hours = 24; unsigned seed = 1; };
+
+static int cmdSelftest(const Opt& o){
+  // --- Anhang ---
+  {
+    const PvSched a{ 29123, 1012, 30000 };
+    std::vector<uint8_t> b = framePkt(7, &a);
+    PvSched c{}; PvBattEta e;
+    bool ok = b.size() == AT_SCHED + 14 && pvBattGet(b.data(), b.size(), AT_BATT, e) && pvSchedGet(b.data(), b.size(), AT_SCHED, c);
+    ok &= c.nextMs == a.nextMs && c.spreadMs == a.spreadMs && c.periodMs == a.periodMs;
+    ok &= !pvSchedGet(b.data(), b.size() - 1, AT_SCHED, c) && !pvSchedGet(b.data(), AT_SCHED, AT_SCHED, c);
+    std::vector<uint8_t> x = b; x[AT_SCHED + 3] ^= 1;
+    ok &= !pvSchedGet(x.data(), x.size(), AT_SCHED, c);
+    const PvSched z{ 1, 1, 0 }; x = framePkt(7, &z);
+    ok &= !pvSchedGet(x.data(), x.size(), AT_SCHED, c);      // ohne Takt ungültig
+    x = framePkt(7, nullptr);
+    ok &= !pvSchedGet(x.data(), x.size(), AT_SCHED, c);      // älterer Poller
+    check(ok, "Anhang: Rundreise hinter Batterie, zu kurz, CRC, Takt 0, fehlt");
+  }
+  // --- Plan des Pollers ---
+  {
+    PvSchedTx t;
+    pvSchedRound(t, 400);
+    PvSched s = pvSchedNext(t, 1000, FRAME_MS, TICK_MS, TIMEOUT_MS, 1400);
+    bool ok = s.nextMs == FRAME_MS && s.spreadMs == TIMEOUT_MS - 400 + TICK_MS && s.periodMs == FRAME_MS;
+    for (uint32_t d : { 900u, 250u, 8400u, 600u }) pvSchedRound(t, d);
+    s = pvSchedNext(t, 0xFFFFF000u, FRAME_MS, TICK_MS, TIMEOUT_MS, 0xFFFFF000u + 600);   // millis() läuft über
+    ok &= s.nextMs == FRAME_MS + 250 - 600 && s.spreadMs == 8400 - 250 + TICK_MS;
+    for (int k = 0; k < PV_SCHED_ROUNDS; ++k) pvSchedRound(t, 500);         // alte Runden fallen heraus
+    s = pvSchedNext(t, 0, FRAME_MS, TICK_MS, TIMEOUT_MS, 500);
+    ok &= s.nextMs == FRAME_MS && s.spreadMs == TIMEOUT_MS - 500 + TICK_MS;
+    s = pvSchedNext(t, 0, FRAME_MS, TICK_MS, TIMEOUT_MS, FRAME_MS + 9000);  // schon überfällig
+    ok &= s.nextMs == 0;
+    check(ok, "Poller: frühester Zeitpunkt aus den letzten Runden, spätester bis Timeout");
+  }
+  // --- Client-Plan ---
+  {
+    PvSleep s;
+    const uint32_t t0 = 0xFFFFFFFFu - 10000;                 // Überlauf mittendrin
+    const PvSched sc{ 29500, 700, FRAME_MS };
+    bool ok = pvSleepPlan(s, t0, false).radio;               // ohne Plan an
+    pvSleepFrame(s, t0, false, &sc);
+    ok &= pvSleepPlan(s, t0 + 100, false).radio;             // Nachlauf
+    PvSleepPlan p = pvSleepPlan(s, t0 + PV_SLEEP_TAIL_MS, false);
+    ok &= !p.radio && p.idleMs == 29500 - PV_SLEEP_GUARD_MS - PV_SLEEP_TAIL_MS;
+    ok &= pvSleepPlan(s, t0 + 5000, true).radio;             // busy
+    ok &= !pvSleepPlan(s, t0 + 5005, false).radio;
+    ok &= !pvSleepPlan(s, t0 + 29500 - PV_SLEEP_GUARD_MS - 1, false).radio;
+    ok &= pvSleepPlan(s, t0 + 29500 - PV_SLEEP_GUARD_MS, false).radio;   // Fenster
+    ok &= pvSleepPlan(s, t0 + 29500 + 700 + PV_SLEEP_LATE_MS - 1, false).radio && s.have && !s.misses;
+    const uint32_t end = 29500 + 700 + PV_SLEEP_LATE_MS;
+    p = pvSleepPlan(s, t0 + end, false);                     // ausgeblieben: ein Takt später
+    ok &= !p.radio && s.have && s.misses == 1 && p.idleMs == FRAME_MS + 29500 - PV_SLEEP_GUARD_MS - end;
+    ok &= pvSleepPlan(s, t0 + end + FRAME_MS, false).radio && !s.have && s.misses == 2;
+    ok &= pvSleepPlan(s, t0 + 90000, false).radio;           // zweimal: an bis zum nächsten
+    pvSleepFrame(s, t0 + 91000, true, &sc);                  // mit Lücke: Fenster früher
+    p = pvSleepPlan(s, t0 + 92000, false);
+    ok &= !p.radio && s.extra == PV_SLEEP_GUARD_MS && p.idleMs == 91000 + 29500 - PV_SLEEP_GUARD_MS * 2 - 92000;
+    for (int k = 0; k < 100; ++k) pvSleepFrame(s, t0 + 100000, false, &sc);
+    ok &= s.extra == 0;
+    pvSleepFrame(s, t0 + 101000, false, nullptr);            // älterer Poller
+    ok &= pvSleepPlan(s, t0 + 102000, false).radio;
+    ok &= s.gaps == 1 && s.wakes >= 2;
+    check(ok, "Client: Nachlauf, Schlaf, Fenster, ausgeblieben 1x/2x, Lücke, busy, ohne Anhang");
+  }
+  // --- Simulation ---
+  char b[160];
+  for (const Pattern& p : PATTERNS){
+    const Res on = simulate(p, POL_ON, o.hours, o.seed), r = simulate(p, POL_PLAN, o.hours, o.seed);
+    bool ok = on.slept == 0 && on.duty() == 100 && r.frames == on.frames && r.delivered == on.delivered;
+    ok &= fabs(r.ownDuty / 10.0 - r.duty()) < 1.0;          // eigene Messung des Clients
+    const double sl = permille(r.slept, r.delivered), st = permille(r.statsSlept, r.stats);
+    if (p.busy || !p.sched) ok &= r.duty() == 100 && r.slept == 0;
+    else ok &= r.duty() < 12 && (sl <= 1 || r.slept <= (uint64_t)(p.restarts * o.hours / 24 + 0.5)) && st <= 5;   // je Neustart ein Frame
+    snprintf(b, sizeof(b), "%-20s Funk an %5.1f %%, verschlafen %.1f ‰ (Stats %.1f ‰)", p.name, r.duty(), sl, st);
+    check(ok, b);
+  }
+  {
+    const Pattern& p = PATTERNS[1];
+    const Res t = simulate(p, POL_TAKT, o.hours, o.seed), r = simulate(p, POL_PLAN, o.hours, o.seed);
+    snprintf(b, sizeof(b), "Plan statt Takt: verschlafen %.1f ‰ statt %.1f ‰", permille(r.slept, r.delivered), permille(t.slept, t.delivered));
+    check(r.slept * 10 < t.slept + 10 && t.slept > 0, b);
+  }
+  // --- Backlight ---
+  {
+    bool ok = pvBacklightTarget(12 * 60, -1, 0xFFFFFFFFu) == PV_BL_DAY && pvBacklightTarget(2 * 60, -1, 0xFFFFFFFFu) == PV_BL_NIGHT;
+    ok &= pvBacklightTarget(PV_BL_NIGHT_FROM, -1, 0xFFFFFFFFu) == PV_BL_NIGHT && pvBacklightTarget(PV_BL_NIGHT_TO, -1, 0xFFFFFFFFu) == PV_BL_NIGHT;
+    ok &= pvBacklightTarget(2 * 60, -1, 1000) == PV_BL_DAY && pvBacklightTarget(-1, -1, 0xFFFFFFFFu) == PV_BL_DAY;
+    uint8_t prev = PV_BL_NIGHT;
+    for (int32_t m = PV_BL_NIGHT_TO; m <= PV_BL_NIGHT_TO + PV_BL_RAMP_MIN; ++m){ const uint8_t v = pvBacklightTarget(m, -1, 0xFFFFFFFFu); ok &= v >= prev; prev = v; }
+    ok &= prev == PV_BL_DAY;
+    for (int32_t m = PV_BL_NIGHT_FROM - PV_BL_RAMP_MIN; m <= PV_BL_NIGHT_FROM; ++m){ const uint8_t v = pvBacklightTarget(m, -1, 0xFFFFFFFFu); ok &= v <= prev; prev = v; }
+    check(ok, "Backlight: Tag, Nacht, Rampen monoton, Berührung, ohne Uhr");
+    PvAmbient a;
+    ok = pvAmbientLevel(a) == -1;
+    pvAmbientAdd(a, PV_LDR_DARK); ok &= pvAmbientLevel(a) == 0 && pvBacklightTarget(12 * 60, 0, 0xFFFFFFFFu) == PV_BL_NIGHT;
+    for (int k = 0; k < 200; ++k) pvAmbientAdd(a, PV_LDR_BRIGHT);
+    ok &= pvAmbientLevel(a) == 255 && pvBacklightTarget(2 * 60, 255, 0xFFFFFFFFu) == PV_BL_DAY;
+    const int32_t dim = PV_LDR_DARK + (PV_LDR_BRIGHT - PV_LDR_DARK) * 245 / 255;
+    for (int k = 0; k < 3; ++k) pvAmbientAdd(a, dim);
+    ok &= pvAmbientLevel(a) == 255;                           // Rauschen: Hysterese
+    pvAmbientAdd(a, PV_LDR_DARK); ok &= pvAmbientLevel(a) > 200 && pvAmbientLevel(a) < 255;   // Schatten: geglättet
+    ok &= pvBacklightStep(10, 200) == 200 && pvBacklightStep(200, 10) == 200 - PV_BL_FALL_STEP && pvBacklightStep(12, 10) == 10;
+    ok &= pvBacklightDuty(0) == 0 && pvBacklightDuty(1) == 1 && pvBacklightDuty(255) == 255;
+    for (int l = 1; l < 256; ++l) ok &= pvBacklightDuty((uint8_t)l) >= pvBacklightDuty((uint8_t)(l - 1));
+    check(ok, "Backlight: LDR geglättet mit Hysterese, Schritte nach unten, Tastgrad");
+  }
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+static int cmdBench(const Opt& o){
+  printf("%.0f h, Frames alle %u s, Fenster: %u ms vorher, %u ms Nachlauf, ausgeblieben nach Streuung + %u ms\n"
+         "Strom nach Richtwerten: wach %.0f mA, Modem-Sleep %.0f mA\n\n",
+         o.hours, FRAME_MS / 1000, PV_SLEEP_GUARD_MS, PV_SLEEP_TAIL_MS, PV_SLEEP_LATE_MS, MA_ON, MA_SLEEP);
+  printf("%-20s %-9s %8s %8s %10s %8s %8s %6s\n", "", "", "Funk an", "Wecken/h", "verschlafen", "Stats", "fehlten", "mA");
+  for (const Pattern& p : PATTERNS){
+    for (int pol = POL_ON; pol <= POL_PLAN; ++pol){
+      const Res r = simulate(p, pol, o.hours, o.seed);
+      printf("%-20s %-9s %7.1f%% %8.1f %9.1f‰ %7.1f‰ %8u %6.1f\n", pol == POL_ON ? p.name : "", POL_NAME[pol],
+             r.duty(), r.wakes / o.hours, permille(r.slept, r.delivered), permille(r.statsSlept, r.stats), r.misses, r.ma());
+    }
+  }
+  printf("\nverschlafen: zugestellt, aber Funk aus (Energie holt PvFill.h nach); fehlten: Fenster ohne Frame\n\n");
+  const BlRes a = backlightDay(false, o.seed), l = backlightDay(true, o.seed);
+  printf("Backlight über 24 h (Berührung stündlich 8..21 Uhr), bisher 100 %% PWM = %.0f mA:\n", MA_BL);
+  printf("  Tageszeit        Helligkeit %5.1f %%, PWM %5.1f %% = %5.1f mA, %u Änderungen\n", a.level, a.duty, MA_BL * a.duty / 100, a.changes);
+  printf("  LDR              Helligkeit %5.1f %%, PWM %5.1f %% = %5.1f mA, %u Änderungen\n", l.level, l.duty, MA_BL * l.duty / 100, l.changes);
+  const Res r = simulate(PATTERNS[1], POL_PLAN, o.hours, o.seed);
+  printf("\nClient gesamt (Verlust 1 %%, Tageszeit): %.0f mA -> %.0f mA\n", MA_ON + MA_BL, r.ma() + MA_BL * a.duty / 100);
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvsleep selftest [--seed N] | bench [--hours H] [--seed N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  Opt o;
+  for (int i = 2; i + 1 < argc; i += 2){
+    std::string k = argv[i];
+    if (k == "--hours") o.hours = atof(argv[i + 1]);
+    else if (k == "--seed") o.seed = (unsigned)atoi(argv[i + 1]);
+    else return usage();
+  }
+  if (o.hours < 1 || o.hours > 24 * 30) return usage();
+  if (cmd == "selftest") return cmdSelftest(o);
+  if (cmd == "bench") return cmdBench(o);
+  return usage();
+}
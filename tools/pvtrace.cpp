@@ -0,0 +1,191 @@
+// ===================== tools/pvtrace.cpp =====================
+// Host-Tool zum Event-Trace (SolarDisplay/PvTrace.h, Sketch mit #define PV_TRACE)
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -pthread -o pvtrace tools/pvtrace.cpp
+//
+// Aufrufe:
+//   pvtrace json  <dump.bin> [out.json]   Serial-Mitschnitt ('t' gesendet) -> Chrome/Perfetto JSON
+//   pvtrace fetch [ip] [out.json]         Trace per UDP holen (STATS_TRACE_REQ), ohne ip: Multicast
+//   pvtrace bench [threads]               Overhead von pvTraceRecord() auf dem Host messen
+//
+// Die JSON-Datei lässt sich in chrome://tracing oder ui.perfetto.dev öffnen.
+#define PV_TRACE
+#include "../SolarDisplay/PvTrace.h"
+#include "../SolarDisplay/PvRx.h"     // PvStats.h + pvRxStats
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static const char* STATS_MCAST_GRP_STR = "239.0.0.58";   // = STATS_MCAST_GRP (PvStats.h)
+
+// ---------- Datei lesen ----------
+static bool readFile(const char* path, std::vector<uint8_t>& out){
+  FILE* f = fopen(path, "rb");
+  if (!f){ perror(path); return false; }
+  uint8_t b[4096]; size_t n;
+  while ((n = fread(b, 1, sizeof(b), f)) > 0) out.insert(out.end(), b, b+n);
+  fclose(f);
+  return true;
+}
+
+// ---------- Dump -> JSON ----------
+// Sucht den Dump-Kopf (Serial-Mitschnitt enthält auch Logtext) und schreibt Chrome-Trace JSON.
+static bool dumpToJson(const std::vector<uint8_t>& raw, FILE* out){
+  size_t pos = 0;
+  const PvTraceDumpHdr* h = nullptr;
+  for (; pos + sizeof(PvTraceDumpHdr) <= raw.size(); ++pos){
+    uint32_t m; memcpy(&m, raw.data()+pos, 4);
+    if (m == PV_TRACE_MAGIC){ h = (const PvTraceDumpHdr*)(raw.data()+pos); break; }
+  }
+  if (!h){ fprintf(stderr, "kein Trace-Dump gefunden\n"); return false; }
+  if (h->version != 1 || h->recSize != sizeof(PvTraceRec)){
+    fprintf(stderr, "unbekanntes Dump-Format (v%u, rec %u)\n", h->version, h->recSize); return false;
+  }
+  size_t avail = (raw.size() - pos - sizeof(PvTraceDumpHdr)) / sizeof(PvTraceRec);
+  uint32_t count = h->count;
+  if (avail < count){ fprintf(stderr, "Dump abgeschnitten: %zu von %u Einträgen\n", avail, count); count = (uint32_t)avail; }
+  const PvTraceRec* rec = (const PvTraceRec*)(raw.data() + pos + sizeof(PvTraceDumpHdr));
+
+  fprintf(out, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"lost\":%u},\"traceEvents\":[\n", h->lost);
+  // micros() läuft nach ~71 min über -> auf 64 bit entfalten
+  uint64_t wrap = 0; uint32_t prev = count ? rec[0].tsUs : 0;
+  for (uint32_t i = 0; i < count; ++i){
+    const PvTraceRec& r = rec[i];
+    if (r.tsUs < prev && prev - r.tsUs > 0x80000000u) wrap += 0x100000000ull;
+    prev = r.tsUs;
+    uint64_t ts = wrap + r.tsUs;
+    fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":%u,%s\"args\":{\"arg\":%u}}",
+            i ? ",\n" : "", pvTraceName(r.id), (char)r.ph, (unsigned long long)ts, r.tid,
+            r.ph == PVT_INSTANT ? "\"s\":\"t\"," : "", r.arg);
+  }
+  fprintf(out, "\n]}\n");
+  fprintf(stderr, "%u Ereignisse, %u verloren\n", count, h->lost);
+  return true;
+}
+
+static FILE* openOut(const char* path){
+  if (!path) return stdout;
+  FILE* f = fopen(path, "w");
+  if (!f) perror(path);
+  return f;
+}
+
+// ---------- UDP holen ----------
+static void sendStats(int sock, const sockaddr_in& to, uint8_t type, uint32_t seq){
+  StatsHdr h{0xCAFE, 1, type, seq, 0, 0};
+  h.crc = pvstats_crc(h, nullptr);
+  uint8_t b[STATS_HDR_WIRE];
+  sendto(sock, b, pvWireEncode(h, b), 0, (const sockaddr*)&to, sizeof(to));
+}
+
+static bool fetchTrace(const char* ip, std::vector<uint8_t>& dump){
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0){ perror("socket"); return false; }
+  timeval tv{1, 0};
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  sockaddr_in to{}; to.sin_family = AF_INET; to.sin_port = htons(STATS_MCAST_PORT);
+  inet_pton(AF_INET, ip ? ip : STATS_MCAST_GRP_STR, &to.sin_addr);
+  sendStats(sock, to, STATS_TRACE_REQ, 1);
+
+  std::vector<bool> have;
+  size_t got = 0, total = 0;
+  uint8_t buf[1500];
+  for (;;){
+    ssize_t n = recv(sock, buf, sizeof(buf), 0);
+    if (n < 0) break;   // Timeout: fertig oder Gerät antwortet nicht
+    StatsHdr h; PayloadTraceChunk c;
+    if (pvRxStats(buf, (size_t)n, h) != PVRX_OK || h.type != STATS_TRACE) continue;   // Kopf, Länge, CRC
+    const uint8_t* pl = buf + STATS_HDR_WIRE;
+    if (!pvWireDecode(pl, h.len, c)) continue;
+    const size_t hl = PvWire<PayloadTraceChunk>::size;
+    size_t len = h.len - hl;
+    if (total == 0){ total = c.total; dump.assign(total, 0); have.assign((total + STATS_TRACE_CHUNK-1) / STATS_TRACE_CHUNK, false); }
+    if (c.total != total || c.off + len > total) continue;
+    size_t idx = c.off / STATS_TRACE_CHUNK;
+    if (!have[idx]){ have[idx] = true; got += len; memcpy(dump.data() + c.off, pl + hl, len); }
+    if (got == total) break;
+  }
+  close(sock);
+  if (total == 0){ fprintf(stderr, "keine Antwort (Sketch mit PV_TRACE gebaut?)\n"); return false; }
+  if (got != total) fprintf(stderr, "unvollständig: %zu/%zu Bytes\n", got, total);
+  return true;
+}
+
+// ---------- Benchmark ----------
+static double benchRecord(unsigned threads, uint32_t perThread){
+  auto work = [perThread](){
+    for (uint32_t i = 0; i < perThread; ++i){ PV_TRACE_SCOPE(PVT_MB_CB, i); }
+  };
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> th;
+  for (unsigned k = 0; k < threads; ++k) th.emplace_back(work);
+  for (auto& t : th) t.join();
+  auto t1 = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  return ns / (2.0 * perThread);   // ns je Eintrag (Scope = 2 Einträge) und Thread
+}
+
+static double benchClock(uint32_t n){
+  volatile uint32_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; ++i) sink += pvTraceNowUs();
+  auto t1 = std::chrono::steady_clock::now();
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+static int usage(){
+  fprintf(stderr, "pvtrace json <dump.bin> [out.json] | fetch [ip] [out.json] | bench [threads]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+
+  if (cmd == "json"){
+    if (argc < 3) return usage();
+    std::vector<uint8_t> raw;
+    if (!readFile(argv[2], raw)) return 1;
+    FILE* out = openOut(argc > 3 ? argv[3] : nullptr);
+    if (!out) return 1;
+    bool ok = dumpToJson(raw, out);
+    if (out != stdout) fclose(out);
+    return ok ? 0 : 1;
+  }
+
+  if (cmd == "fetch"){
+    const char* ip  = argc > 2 ? argv[2] : nullptr;
+    std::vector<uint8_t> dump;
+    if (!fetchTrace(ip, dump)) return 1;
+    FILE* out = openOut(argc > 3 ? argv[3] : nullptr);
+    if (!out) return 1;
+    bool ok = dumpToJson(dump, out);
+    if (out != stdout) fclose(out);
+    return ok ? 0 : 1;
+  }
+
+  if (cmd == "bench"){
+    unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : 4;
+    const uint32_t N = 5000000;
+    printf("Uhr (pvTraceNowUs)      : %6.1f ns\n", benchClock(N));
+    for (unsigned t = 1; t <= maxThreads; t *= 2)
+      printf("pvTraceRecord %u Thread(s): %6.1f ns/Eintrag\n", t, benchRecord(t, N));
+    printf("Ringgröße               : %u Einträge = %zu Byte\n", (unsigned)PV_TRACE_CAP, sizeof(pvTraceRing.rec));
+    return 0;
+  }
+
+  return usage();
+}
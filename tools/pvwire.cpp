@@ -0,0 +1,405 @@
+// ===================== tools/pvwire.cpp =====================
+// Host-Prüfung des Drahtformats (SolarDisplay/PvWire.h): Feldlisten gegen die früheren gepackten
+// Strukturen, Fuzzing der Dekoder und Durchsatz gegen das frühere Kopieren/Casten.
+//
+// Bauen (Linux/macOS):
+//   g++ -std=c++17 -O2 -o pvwire tools/pvwire.cpp
+//   (Fuzzing mit Adressprüfung: zusätzlich -fsanitize=address,undefined -g)
+//
+// Aufrufe:
+//   pvwire selftest [--iter 200000] [--seed 1]
+//       Feldtabellen (Drahtoffsets = offsetof der alten gepackten Struktur, lückenlos, Größe),
+//       Rundreise kodieren/dekodieren je Nachricht mit Zufallsbytes, dann Fuzzing: gültige
+//       Frames/Stats-Pakete mit Bitfehlern, abgeschnitten, verlängert, reiner Zufall -> pvRxFrame,
+//       pvRxStats, pvWireDecode und pvFrameTimeGet müssen genau wie die alte Cast-Variante
+//       entscheiden und dieselben Werte liefern. Puffer haben exakt die Paketlänge
+//       (mit -fsanitize=address fällt jeder Lesezugriff dahinter auf).
+//   pvwire bench [--iter 2000000]
+//       ns je Paket und MB/s: Frame nur dekodieren (alt: memcpy in gepackte Struktur + Kopie,
+//       neu: Feld für Feld), Frame-Empfang komplett (pvRxFrame mit CRC), Stats Kopf + Tag.
+//       Pakete liegen wie im UDP-Puffer auf ungeraden Adressen.
+#include "../SolarDisplay/PvRx.h"
+#include "../SolarDisplay/PvClock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+
+// ---------- Referenz: die gepackten Strukturen und Empfangsfunktionen vor PvWire.h ----------
+namespace old {
+typedef struct __attribute__((packed)) {
+  uint16_t magic; uint8_t version; uint32_t seq; uint32_t ts;
+  int32_t pvW, gridW, battW, loadW;
+  int16_t temp10; uint16_t socx10;
+  float pvTodayKWh, gridExpToday, gridImpToday, loadTodayKWh;
+  int32_t eta20s;
+  int16_t pv1Voltage_x10_V, pv1Current_x10_A, pv2Voltage_x10_V, pv2Current_x10_A;
+  int32_t gridVoltageA_x10_V, gridVoltageB_x10_V, gridVoltageC_x10_V;
+  int32_t gridCurrentA_x100_A, gridCurrentB_x100_A, gridCurrentC_x100_A;
+  uint16_t crc;
+} PvFrameV4;
+struct StatsHdr { uint16_t magic; uint8_t version, type; uint32_t seq; uint16_t len, crc; } __attribute__((packed));
+struct PayloadOffer { uint16_t statsPort, flags; } __attribute__((packed));   // flags hieß rsv
+struct PayloadReqRange { uint16_t fromY; uint8_t fromM, fromD; uint16_t fromMonY; uint8_t fromMonM, rsv; } __attribute__((packed));
+struct PayloadAck { uint32_t ackSeq; } __attribute__((packed));
+struct PayloadDay { uint16_t y, m, d; float gen_kWh, load_kWh, impT1_kWh, impT2_kWh, exp_kWh; } __attribute__((packed));
+struct PayloadMon { uint16_t y, m; float gen_kWh, load_kWh, impT1_kWh, impT2_kWh, exp_kWh; } __attribute__((packed));
+struct PayloadTraceChunk { uint32_t off, total; } __attribute__((packed));
+struct PvDevInfo {
+  uint8_t idx, count, flags, unit, state; int32_t pvW, battW; int16_t temp10; uint16_t socx10;
+  uint32_t genTodayWh, genMonthWh; uint16_t cycleMs, ageS; char name[8];
+} __attribute__((packed));
+typedef struct __attribute__((packed)) { uint16_t magic; uint8_t flags, rsv; uint32_t ts; uint16_t ms, crc; } PvFrameTime;
+
+// pvstats_crc() alt: CRC über die Bytes der gepackten Struktur
+static uint16_t statsCrc(const StatsHdr& h, const uint8_t* payload){
+  auto crc16 = [](const uint8_t* data, size_t len, uint16_t c){
+    for (size_t i = 0; i < len; i++){
+      c ^= (uint16_t)data[i] << 8;
+      for (int k = 0; k < 8; k++) c = (c & 0x8000) ? (uint16_t)((c << 1) ^ 0x1021) : (uint16_t)(c << 1);
+    }
+    return c;
+  };
+  StatsHdr hc = h; hc.crc = 0;
+  uint16_t c = crc16((const uint8_t*)&hc, sizeof(hc), 0xFFFF);
+  if (h.len && payload) c = crc16(payload, h.len, c);
+  return c;
+}
+
+// pvRxFrame() alt: ganzes Paket in die gepackte Struktur, dann prüfen und kopieren
+static uint8_t rxFrame(PvRxState& s, const uint8_t* data, size_t len, uint32_t src, uint32_t nowMs, PvFrameV4& out){
+  uint8_t r;
+  PvFrameV4 f;
+  bool stale = !s.have || (uint32_t)(nowMs - s.lastRxMs) > PVRX_STALE_MS;
+  if (len < sizeof(PvFrameV4)) r = PVRX_SHORT;
+  else {
+    memcpy(&f, data, sizeof(f));
+    if (f.magic != PV_MAGIC || f.version != PV_VERSION)               r = PVRX_MAGIC;
+    else if (crc16_modbus(data, sizeof(PvFrameV4)-2) != f.crc)         r = PVRX_CRC;
+    else if (!stale && src != s.src)                                   r = PVRX_FOREIGN;
+    else if (stale || f.seq > s.lastSeq)                               r = (stale && s.have && f.seq <= s.lastSeq) ? PVRX_RESTART : PVRX_OK;
+    else if (f.seq == s.lastSeq)                                       r = PVRX_DUP;
+    else if (s.lastSeq - f.seq > PVRX_REORDER_WINDOW || f.ts > s.lastTs) r = PVRX_RESTART;
+    else                                                               r = PVRX_OLD;
+  }
+  s.cnt[r]++;
+  if (pvRxAccepted(r)){
+    s.lastSeq = f.seq; s.lastTs = f.ts; s.lastRxMs = nowMs; s.src = src; s.have = true;
+    out = f;
+  }
+  return r;
+}
+
+static uint8_t rxStats(const uint8_t* data, size_t len, StatsHdr& h){
+  if (len < sizeof(StatsHdr)) return PVRX_SHORT;
+  memcpy(&h, data, sizeof(h));
+  if (h.magic != 0xCAFE || h.version != 1) return PVRX_MAGIC;
+  if (sizeof(StatsHdr) + h.len > len) return PVRX_SHORT;
+  if (statsCrc(h, data + sizeof(StatsHdr)) != h.crc) return PVRX_CRC;
+  return PVRX_OK;
+}
+
+static bool frameTimeGet(const uint8_t* data, size_t len, size_t at, uint64_t& unixMs){
+  PvFrameTime t;
+  if (len < at + sizeof(t)) return false;
+  memcpy(&t, data + at, sizeof(t));
+  if (t.magic != PV_TIME_MAGIC || t.crc != crc16_modbus((const uint8_t*)&t, offsetof(PvFrameTime, crc))) return false;
+  if (!(t.flags & PVTM_SYNCED) || t.ms >= 1000) return false;
+  unixMs = (uint64_t)t.ts * 1000 + t.ms;
+  return true;
+}
+}  // namespace old
+
+// ---------- Helfer ----------
+static int fails = 0;
+static void check(bool ok, const char* what){ printf("%-66s %s\n", what, ok ? "ok" : "FEHLER"); fails += !ok; }
+
+static double nowUs(){
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Feldweise vergleichen (bitgenau, auch NaN), über dieselbe Feldliste wie der Generator
+#define CMP_F(T, n)    ok = ok && memcmp(&a.n, &b.n, sizeof(T)) == 0;
+#define CMP_A(T, n, N) ok = ok && memcmp(a.n, b.n, N) == 0;
+#define OFF_F(T, n)    ok = ok && wireOf(PvWire<S>::fields(), PvWire<S>::count, #n) == offsetof(O, n);
+#define OFF_A(T, n, N) OFF_F(T, n)
+
+static long wireOf(const PvWireField* f, size_t n, const char* name){
+  for (size_t i = 0; i < n; i++) if (!strcmp(f[i].name, name)) return f[i].wire;
+  return -1;
+}
+
+// je Nachricht: neue Struktur, alte Struktur, Feldliste
+#define PV_MESSAGES(X) \
+  X(PvFrameV4,         old::PvFrameV4,         PV_FRAME_V4_FIELDS) \
+  X(StatsHdr,          old::StatsHdr,          STATS_HDR_FIELDS) \
+  X(PayloadOffer,      old::PayloadOffer,      PAYLOAD_OFFER_FIELDS) \
+  X(PayloadReqRange,   old::PayloadReqRange,   PAYLOAD_REQ_RANGE_FIELDS) \
+  X(PayloadAck,        old::PayloadAck,        PAYLOAD_ACK_FIELDS) \
+  X(PayloadDay,        old::PayloadDay,        PAYLOAD_DAY_FIELDS) \
+  X(PayloadMon,        old::PayloadMon,        PAYLOAD_MON_FIELDS) \
+  X(PayloadTraceChunk, old::PayloadTraceChunk, PAYLOAD_TRACE_CHUNK_FIELDS) \
+  X(PvDevInfo,         old::PvDevInfo,         PV_DEV_INFO_FIELDS) \
+  X(PvFrameTime,       old::PvFrameTime,       PV_FRAME_TIME_FIELDS)
+
+#define SAME_FN(NEW, OLD, FIELDS) \
+  static bool same(const NEW& a, const OLD& b){ bool ok = true; FIELDS(CMP_F, CMP_A) return ok; } \
+  static bool sameOffsets(const NEW*, const OLD*){ typedef NEW S; typedef OLD O; bool ok = true; FIELDS(OFF_F, OFF_A) return ok; }
+PV_MESSAGES(SAME_FN)
+
+static std::vector<uint8_t> randBytes(std::mt19937& rng, size_t n){
+  std::vector<uint8_t> b(n);
+  for (auto& x : b) x = (uint8_t)rng();
+  return b;
+}
+
+// Feldtabelle: lückenlos, in Reihenfolge, Summe = Drahtgröße, Speicheroffsets in der Struktur,
+// Drahtoffsets = alte gepackte Struktur
+template<class T, class O> static bool tableOk(){
+  const PvWireField* f = PvWire<T>::fields();
+  size_t at = 0;
+  bool ok = PvWire<T>::size == sizeof(O);
+  for (size_t i = 0; i < PvWire<T>::count; i++){
+    ok = ok && f[i].wire == at && f[i].mem + f[i].size <= sizeof(T);
+    ok = ok && (f[i].kind == PVW_BYTES || f[i].mem % f[i].size == 0);   // natürlich ausgerichtet
+    at += f[i].size;
+  }
+  return ok && at == PvWire<T>::size && sameOffsets((const T*)nullptr, (const O*)nullptr);
+}
+
+// Zufallsbytes dekodieren = alte Struktur aus denselben Bytes; wieder kodieren = dieselben Bytes
+template<class T, class O> static bool roundTrip(std::mt19937& rng, int iter){
+  bool ok = true;
+  for (int i = 0; i < iter && ok; i++){
+    std::vector<uint8_t> b = randBytes(rng, PvWire<T>::size), b2(PvWire<T>::size);
+    T v; O o;
+    ok = pvWireDecode(b.data(), b.size(), v);
+    memcpy(&o, b.data(), sizeof(o));
+    ok = ok && same(v, o) && pvWireEncode(v, b2.data()) == b.size() && b2 == b;
+    ok = ok && !pvWireDecode(b.data(), b.size() - 1, v);          // eins zu kurz: abgelehnt
+  }
+  return ok;
+}
+
+static int cmdSelftest(int iter, unsigned seed){
+  std::mt19937 rng(seed);
+  char what[96];
+
+  printf("-- Feldtabellen und Rundreise\n");
+#define TEST_MSG(NEW, OLD, FIELDS) \
+  snprintf(what, sizeof(what), "%-17s %2u Felder, %2u Byte: Tabelle = altes Layout", #NEW, \
+           (unsigned)PvWire<NEW>::count, (unsigned)PvWire<NEW>::size); \
+  check(tableOk<NEW, OLD>(), what); \
+  snprintf(what, sizeof(what), "%-17s Rundreise Zufallsbytes", #NEW); \
+  check(roundTrip<NEW, OLD>(rng, iter / 20 + 1), what);
+  PV_MESSAGES(TEST_MSG)
+
+  // Frame bekannt kodieren: CRC, Magic, Little Endian
+  {
+    PvFrameV4 f{}; f.seq = 0x11223344; f.pvW = -2; f.pvTodayKWh = 1.5f; f.crc = 0;
+    uint8_t p[PV_FRAME_WIRE];
+    pvFrameEncode(f, p);
+    check(p[0] == 0xEF && p[1] == 0xBE && p[2] == PV_VERSION && p[3] == 0x44 && p[6] == 0x11, "Frame: Magic/seq Little Endian");
+    check(p[11] == 0xFE && p[14] == 0xFF, "Frame: negative Werte (Zweierkomplement)");
+    check(f.crc == crc16_modbus(p, PV_FRAME_WIRE - 2) && pvWireU16(p + PV_FRAME_WIRE - 2) == f.crc, "Frame: CRC über die kodierten Bytes, auch in der Struktur");
+  }
+
+  printf("-- Fuzzing (%d Pakete je Art)\n", iter);
+  // Frames: gültige Folge mit Fehlern, neue und alte Empfangsfunktion mit eigenem Zustand
+  {
+    PvRxState sn, so;
+    uint32_t seq = 0, ts = 1700000000u, diff = 0, acc = 0, now = 0;
+    uint32_t byReason[PVRX_COUNT] = {};
+    for (int i = 0; i < iter; i++){
+      PvFrameV4 f;
+      std::vector<uint8_t> r = randBytes(rng, PV_FRAME_WIRE);
+      PvWire<PvFrameV4>::get(f, r.data());           // Zufallswerte in allen Feldern
+      f.seq = (rng() % 50 == 0) ? (uint32_t)(rng() % 100) : ++seq;   // Neustarts/Rücksprünge
+      f.ts = ++ts;
+      std::vector<uint8_t> p(PV_FRAME_WIRE + PV_TIME_WIRE);
+      pvFrameEncode(f, p.data());
+      pvFrameTimeSeal(p.data() + PV_FRAME_WIRE, (uint64_t)ts * 1000 + rng() % 1000, rng() % 8 != 0);
+      switch (rng() % 8){
+        case 0: p[rng() % p.size()] ^= (uint8_t)(1u << (rng() % 8)); break;   // Bitfehler
+        case 1: p.resize(rng() % p.size()); break;                           // abgeschnitten
+        case 2: { auto x = randBytes(rng, rng() % 64); p.insert(p.end(), x.begin(), x.end()); } break;
+        case 3: p = randBytes(rng, rng() % 128); break;                      // Fremdpaket
+        case 4: p.resize(PV_FRAME_WIRE); break;                              // ohne Zeit-Anhang
+        default: break;                                                      // gültig
+      }
+      uint32_t src = rng() % 16 == 0 ? 2 : 1;
+      now += 30000 + (rng() % 1000);
+      if (rng() % 200 == 0) now += PVRX_STALE_MS;
+      PvFrameV4 outN{}; old::PvFrameV4 outO{};
+      uint8_t rn = pvRxFrame(sn, p.data(), p.size(), src, now, outN);
+      uint8_t ro = old::rxFrame(so, p.data(), p.size(), src, now, outO);
+      uint64_t mn = 0, mo = 0;
+      bool tn = pvFrameTimeGet(p.data(), p.size(), PV_FRAME_WIRE, mn);
+      bool to = old::frameTimeGet(p.data(), p.size(), PV_FRAME_WIRE, mo);
+      byReason[rn]++;
+      if (pvRxAccepted(rn)) acc++;
+      if (rn != ro || (pvRxAccepted(rn) && !same(outN, outO)) || tn != to || mn != mo) diff++;
+    }
+    snprintf(what, sizeof(what), "pvRxFrame/pvFrameTimeGet = alt (%u angenommen, %u crc, %u short)",
+             acc, byReason[PVRX_CRC], byReason[PVRX_SHORT]);
+    check(diff == 0 && memcmp(sn.cnt, so.cnt, sizeof(sn.cnt)) == 0 && sn.lastSeq == so.lastSeq, what);
+  }
+  // Stats: gültige Pakete (alle Typen) mit Fehlern, Kopf und Payload wie im Sketch
+  {
+    uint32_t diff = 0, ok = 0;
+    for (int i = 0; i < iter; i++){
+      uint8_t type = (uint8_t)(1 + rng() % 10);
+      std::vector<uint8_t> pl = randBytes(rng, rng() % 48);
+      StatsHdr h{0xCAFE, 1, type, (uint32_t)rng(), (uint16_t)pl.size(), 0};
+      h.crc = pvstats_crc(h, pl.data());
+      std::vector<uint8_t> p(STATS_HDR_WIRE);
+      pvWireEncode(h, p.data());
+      p.insert(p.end(), pl.begin(), pl.end());
+      switch (rng() % 6){
+        case 0: p[rng() % p.size()] ^= (uint8_t)(1u << (rng() % 8)); break;
+        case 1: p.resize(rng() % p.size()); break;
+        case 2: p = randBytes(rng, rng() % 64); break;
+        default: break;
+      }
+      StatsHdr hn; old::StatsHdr ho;
+      uint8_t rn = pvRxStats(p.data(), p.size(), hn), ro = old::rxStats(p.data(), p.size(), ho);
+      bool d = rn != ro;
+      if (!d && rn == PVRX_OK){
+        ok++;
+        const uint8_t* q = p.data() + STATS_HDR_WIRE;
+        d = !same(hn, ho);
+        // jede Payload-Art auf die empfangene Länge dekodieren, wie im Sketch
+#define FUZZ_PL(NEW, OLD) { \
+          NEW vn; OLD vo; bool okn = pvWireDecode(q, hn.len, vn); bool oko = hn.len >= sizeof(OLD); \
+          if (oko) memcpy(&vo, q, sizeof(vo)); \
+          d = d || okn != oko || (okn && !same(vn, vo)); }
+        FUZZ_PL(PayloadOffer, old::PayloadOffer)
+        FUZZ_PL(PayloadReqRange, old::PayloadReqRange)
+        FUZZ_PL(PayloadDay, old::PayloadDay)
+        FUZZ_PL(PayloadMon, old::PayloadMon)
+        FUZZ_PL(PayloadTraceChunk, old::PayloadTraceChunk)
+        FUZZ_PL(PvDevInfo, old::PvDevInfo)
+      }
+      diff += d;
+    }
+    snprintf(what, sizeof(what), "pvRxStats + Payloads = alt (%u gültig)", ok);
+    check(diff == 0, what);
+  }
+
+  printf("%s (%d Fehler)\n", fails ? "FEHLER" : "OK", fails);
+  return fails ? 1 : 0;
+}
+
+// ---------- bench ----------
+static volatile uint32_t sink;
+
+static void row(const char* what, double ns, size_t bytes){
+  printf("%-50s %9.1f ns/Paket %9.1f MB/s\n", what, ns, bytes / ns * 1e3);
+}
+
+static int cmdBench(int iter){
+  std::mt19937 rng(1);
+  const int N = 256;   // Pakete im Ring (bleibt im Cache, Adressen ungerade wie im UDP-Puffer)
+  std::vector<uint8_t> ring(N * 128 + 1);
+  for (int i = 0; i < N; i++){
+    PvFrameV4 f;
+    std::vector<uint8_t> r = randBytes(rng, PV_FRAME_WIRE);
+    PvWire<PvFrameV4>::get(f, r.data());
+    f.seq = (uint32_t)i + 1;
+    pvFrameEncode(f, ring.data() + 1 + i * 128);
+  }
+  printf("%d Durchläufe, Frame %u Byte, Stats Kopf+Tag %u Byte\n\n", iter, (unsigned)PV_FRAME_WIRE,
+         (unsigned)(STATS_HDR_WIRE + PvWire<PayloadDay>::size));
+
+  // nur dekodieren
+  {
+    old::PvFrameV4 pk; PvFrameV4 f{};
+    double t0 = nowUs();
+    for (int i = 0; i < iter; i++){
+      memcpy(&pk, ring.data() + 1 + (i % N) * 128, sizeof(pk));
+      memcpy(&f, &pk, sizeof(pk));   // alt: gepackte Struktur = Speicherstruktur
+      sink += f.seq;
+    }
+    row("Frame dekodieren, alt (memcpy gepackt)", (nowUs() - t0) * 1e3 / iter, PV_FRAME_WIRE);
+    t0 = nowUs();
+    for (int i = 0; i < iter; i++){
+      PvWire<PvFrameV4>::get(f, ring.data() + 1 + (i % N) * 128);
+      sink += f.seq;
+    }
+    row("Frame dekodieren, neu (Feld für Feld LE)", (nowUs() - t0) * 1e3 / iter, PV_FRAME_WIRE);
+  }
+  // Empfang komplett mit Prüfungen und CRC (Folge wird je Ring-Runde als Neustart erkannt)
+  {
+    const int it = iter / 10 + 1;
+    PvRxState so, sn; old::PvFrameV4 fo; PvFrameV4 fn;
+    double t0 = nowUs();
+    for (int i = 0; i < it; i++) sink += old::rxFrame(so, ring.data() + 1 + (i % N) * 128, PV_FRAME_WIRE, 1, (uint32_t)i, fo);
+    row("Frame empfangen, alt (pvRxFrame mit CRC)", (nowUs() - t0) * 1e3 / it, PV_FRAME_WIRE);
+    t0 = nowUs();
+    for (int i = 0; i < it; i++) sink += pvRxFrame(sn, ring.data() + 1 + (i % N) * 128, PV_FRAME_WIRE, 1, (uint32_t)i, fn);
+    row("Frame empfangen, neu (pvRxFrame mit CRC)", (nowUs() - t0) * 1e3 / it, PV_FRAME_WIRE);
+    uint32_t junk = 0;
+    t0 = nowUs();
+    for (int i = 0; i < it; i++){ uint8_t* p = ring.data() + 1 + (i % N) * 128; p[0] ^= 1; junk += pvRxFrame(sn, p, PV_FRAME_WIRE, 1, 0, fn); p[0] ^= 1; }
+    row("Fremdpaket verwerfen, neu (Magic vor Dekodieren)", (nowUs() - t0) * 1e3 / it, PV_FRAME_WIRE);
+    sink += junk;
+  }
+  // Stats: Kopf prüfen + Tag dekodieren
+  {
+    const int it = iter / 10 + 1;
+    std::vector<uint8_t> sring(N * 64 + 1);
+    for (int i = 0; i < N; i++){
+      PayloadDay d{2026, 10, (uint16_t)(1 + i % 28), 1.f * i, 2.f, 3.f, 4.f, 5.f};
+      uint8_t pl[PvWire<PayloadDay>::size]; pvWireEncode(d, pl);
+      StatsHdr h{0xCAFE, 1, STATS_DAY, (uint32_t)i, sizeof(pl), 0}; h.crc = pvstats_crc(h, pl);
+      uint8_t* p = sring.data() + 1 + i * 64;
+      memcpy(p + pvWireEncode(h, p), pl, sizeof(pl));
+    }
+    const size_t len = STATS_HDR_WIRE + PvWire<PayloadDay>::size;
+    double t0 = nowUs();
+    for (int i = 0; i < it; i++){
+      const uint8_t* p = sring.data() + 1 + (i % N) * 64;
+      old::StatsHdr h; old::PayloadDay d;
+      if (old::rxStats(p, len, h) != PVRX_OK) continue;
+      memcpy(&d, p + sizeof(h), sizeof(d)); sink += d.d;
+    }
+    row("Stats Tag empfangen, alt", (nowUs() - t0) * 1e3 / it, len);
+    t0 = nowUs();
+    for (int i = 0; i < it; i++){
+      const uint8_t* p = sring.data() + 1 + (i % N) * 64;
+      StatsHdr h; PayloadDay d;
+      if (pvRxStats(p, len, h) != PVRX_OK || !pvWireDecode(p + STATS_HDR_WIRE, h.len, d)) continue;
+      sink += d.d;
+    }
+    row("Stats Tag empfangen, neu", (nowUs() - t0) * 1e3 / it, len);
+  }
+  printf("\nStruktur im Speicher: PvFrameV4 %u Byte (ausgerichtet) statt %u (gepackt)\n",
+         (unsigned)sizeof(PvFrameV4), (unsigned)sizeof(old::PvFrameV4));
+  return 0;
+}
+
+static int usage(){
+  fprintf(stderr, "pvwire selftest [--iter N] [--seed N] | bench [--iter N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv){
+  if (argc < 2) return usage();
+  std::string cmd = argv[1];
+  int iter = cmd == "bench" ? 2000000 : 200000;
+  unsigned seed = 1;
+  for (int i = 2; i + 1 < argc; i += 2){
+    std::string k = argv[i];
+    if (k == "--iter") iter = atoi(argv[i + 1]);
+    else if (k == "--seed") seed = (unsigned)atoi(argv[i + 1]);
+    else return usage();
+  }
+  if (iter < 1) return usage();
+  if (cmd == "selftest") return cmdSelftest(iter, seed);
+  if (cmd == "bench") return cmdBench(iter);
+  return usage();
+}
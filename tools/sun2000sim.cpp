@@ -0,0 +1,441 @@
+// ===================== tools/sun2000sim.cpp =====================
+// Sun2000 Modbus-TCP Simulator als Benchmark-Gegenstelle für den Poller (Linux/macOS)
+//
+// Bauen:
+//   g++ -std=c++17 -O2 -o sun2000sim tools/sun2000sim.cpp
+//
+// Aufruf:
+//   sun2000sim [szenario.txt] [--port 502] [--unit 2] [--speed X] [--seed N] [--truth datei.csv]
+//
+// Poller auf den Simulator zeigen (Credentials.h):
+//   #define INVERTER_IP 192,168,0,50     // IP des Linux-Rechners
+//   #define MODBUS_PORT 1502             // falls nicht als root auf 502
+//
+// Der Simulator bedient genau die Register des Pollers (FC 03):
+//   32016-32019 PV1/PV2 U/I, 32064 PV-Leistung, 32087 Temperatur, 32114 PV heute,
+//   37001 Batterieleistung, 37004 SoC, 37101-37122 Netz (U, I, P, Zähler)
+// Physik: Tageskurve PV (Sonnenauf-/untergang, Wolkenfenster), Last aus Grundlast +
+// Zeitfenstern, Batterie lädt Überschuss / deckt Defizit je nach SoC, Netz = Rest.
+// Die "Wahrheit" (exakt integrierte Energien, T1/T2 wie isT1_now) wird jede
+// Simulationsminute in --truth geschrieben und beim Beenden ausgegeben.
+// Hinweis: Integrationsfehler des Pollers nur mit --speed 1 vergleichbar (Poller integriert in Echtzeit).
+//
+// Szenario-Format: eine Anweisung je Zeile, '#' Kommentar, Zeiten in Simulationszeit (lokal)
+//   start 2026-06-21 05:00       Simulationsbeginn
+//   speed 1                      Faktor Simulationszeit/Echtzeit
+//   pv_peak 8500                 W bei klarem Himmel mittags
+//   sunrise 05:30 / sunset 21:20
+//   clouds 10:00-12:30 0.4       PV-Faktor im Fenster (mehrfach möglich)
+//   load_base 350                Grundlast W
+//   load 18:00-19:00 3000        Zusatzlast im Fenster (mehrfach möglich)
+//   batt_cap 10000               Wh
+//   batt_soc 35                  Start-SoC %
+//   batt_max_charge 5000 / batt_max_discharge 5000 / batt_min_soc 5
+//   latency normal 40 15         Antwortzeit ms (normal Mittel Streuung | uniform min max | fixed ms)
+//   exception 0.01               Wahrscheinlichkeit Exception 0x06 (Slave busy) je Anfrage
+//   disconnect 0.001             Wahrscheinlichkeit Verbindungsabbruch je Anfrage
+//   noreply 0.002                Wahrscheinlichkeit: Anfrage unbeantwortet (Timeout beim Poller)
+//   lockout reject               nur ein Requester: reject = neue Verbindung ablehnen, kick = alte trennen, off
+//   at 13:00 drop 30             ab Simzeit: Verbindungen trennen und 30 s (Sim) keine Antworten
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// ---------- Szenario ----------
+struct Window { int fromMin, toMin; double val; };
+struct DropEvt { int atMin; double durSec; bool done; };
+
+struct Scenario {
+  time_t start = 0;
+  double speed = 1.0;
+  double pvPeak = 8500, sunrise = 6*60, sunset = 20*60;
+  std::vector<Window> clouds, loads;
+  double loadBase = 350;
+  double battCap = 10000, battSoc = 50, battMaxC = 5000, battMaxD = 5000, battMinSoc = 5;
+  enum { LAT_FIXED, LAT_NORMAL, LAT_UNIFORM } latKind = LAT_FIXED;
+  double latA = 20, latB = 0;
+  double pException = 0, pDisconnect = 0, pNoReply = 0;
+  enum { LOCK_OFF, LOCK_REJECT, LOCK_KICK } lockout = LOCK_REJECT;
+  std::vector<DropEvt> drops;
+};
+
+static int parseHHMM(const char* s){ int h=0, m=0; sscanf(s, "%d:%d", &h, &m); return h*60 + m; }
+static bool parseWin(const char* s, int& a, int& b){
+  char x[8], y[8];
+  if (sscanf(s, "%7[0-9:]-%7[0-9:]", x, y) != 2) return false;
+  a = parseHHMM(x); b = parseHHMM(y); return true;
+}
+
+static bool loadScenario(const char* path, Scenario& sc){
+  FILE* f = fopen(path, "r");
+  if (!f){ perror(path); return false; }
+  char line[256]; int ln = 0;
+  while (fgets(line, sizeof(line), f)){
+    ++ln;
+    if (char* c = strchr(line, '#')) *c = 0;
+    char k[32] = {0}, a[32] = {0}, b[32] = {0}, c3[32] = {0};
+    int n = sscanf(line, "%31s %31s %31s %31s", k, a, b, c3);
+    if (n <= 0) continue;
+    std::string key = k;
+    bool ok = true;
+    if      (key == "start" && n >= 3){
+      struct tm t{}; t.tm_isdst = -1;
+      ok = sscanf(a, "%d-%d-%d", &t.tm_year, &t.tm_mon, &t.tm_mday) == 3;
+      int mm = parseHHMM(b); t.tm_hour = mm/60; t.tm_min = mm%60; t.tm_year -= 1900; t.tm_mon -= 1;
+      sc.start = mktime(&t);
+    }
+    else if (key == "speed")              sc.speed = atof(a);
+    else if (key == "pv_peak")            sc.pvPeak = atof(a);
+    else if (key == "sunrise")            sc.sunrise = parseHHMM(a);
+    else if (key == "sunset")             sc.sunset = parseHHMM(a);
+    else if (key == "clouds" && n >= 3){ Window w; ok = parseWin(a, w.fromMin, w.toMin); w.val = atof(b); sc.clouds.push_back(w); }
+    else if (key == "load"   && n >= 3){ Window w; ok = parseWin(a, w.fromMin, w.toMin); w.val = atof(b); sc.loads.push_back(w); }
+    else if (key == "load_base")          sc.loadBase = atof(a);
+    else if (key == "batt_cap")           sc.battCap = atof(a);
+    else if (key == "batt_soc")           sc.battSoc = atof(a);
+    else if (key == "batt_max_charge")    sc.battMaxC = atof(a);
+    else if (key == "batt_max_discharge") sc.battMaxD = atof(a);
+    else if (key == "batt_min_soc")       sc.battMinSoc = atof(a);
+    else if (key == "latency"){
+      std::string kind = a;
+      if      (kind == "fixed")   { sc.latKind = Scenario::LAT_FIXED;   sc.latA = atof(b); }
+      else if (kind == "normal")  { sc.latKind = Scenario::LAT_NORMAL;  sc.latA = atof(b); sc.latB = atof(c3); }
+      else if (kind == "uniform") { sc.latKind = Scenario::LAT_UNIFORM; sc.latA = atof(b); sc.latB = atof(c3); }
+      else ok = false;
+    }
+    else if (key == "exception")  sc.pException  = atof(a);
+    else if (key == "disconnect") sc.pDisconnect = atof(a);
+    else if (key == "noreply")    sc.pNoReply    = atof(a);
+    else if (key == "lockout"){
+      std::string m = a;
+      if      (m == "off")    sc.lockout = Scenario::LOCK_OFF;
+      else if (m == "reject") sc.lockout = Scenario::LOCK_REJECT;
+      else if (m == "kick")   sc.lockout = Scenario::LOCK_KICK;
+      else ok = false;
+    }
+    else if (key == "at" && n >= 4 && std::string(b) == "drop") sc.drops.push_back({parseHHMM(a), atof(c3), false});
+    else ok = false;
+    if (!ok){ fprintf(stderr, "%s:%d: unbekannte Anweisung\n", path, ln); fclose(f); return false; }
+  }
+  fclose(f);
+  return true;
+}
+
+// ---------- Anlagenmodell ----------
+struct Plant {
+  const Scenario& sc;
+  std::mt19937 rng;
+  // Momentanwerte (W)
+  double pv = 0, load = 0, batt = 0, grid = 0, soc = 0, temp = 25;
+  double pv1Frac = 0.55;
+  // Zähler (Wh): Wahrheit
+  double pvWh = 0, loadWh = 0, expWh = 0, impT1Wh = 0, impT2Wh = 0, battCWh = 0, battDWh = 0;
+  double pvTodayWh = 0;
+  // Netzzähler des "Meters" (kWh/100 Auflösung wie 37119/37121)
+  double expTotWh = 1234567.0, impTotWh = 2345678.0;
+  int lastYday = -1;
+
+  Plant(const Scenario& s, unsigned seed) : sc(s), rng(seed), soc(s.battSoc) {}
+
+  static double windowVal(const std::vector<Window>& w, int minute, double dflt, bool multiply){
+    double v = dflt;
+    for (const Window& x : w){
+      if (minute >= x.fromMin && minute < x.toMin) v = multiply ? v * x.val : v + x.val;
+    }
+    return v;
+  }
+  static bool isT1(const struct tm& t){ return (t.tm_wday>=1 && t.tm_wday<=5) && (t.tm_hour>=7 && t.tm_hour<18); }
+
+  // Zustand für Zeitpunkt t bestimmen (PV/Last deterministisch + leichtes Rauschen)
+  void evaluate(time_t t, double frac){
+    struct tm lt; localtime_r(&t, &lt);
+    double minute = lt.tm_hour*60 + lt.tm_min + (lt.tm_sec + frac)/60.0;
+    double p = 0;
+    if (minute > sc.sunrise && minute < sc.sunset){
+      double x = (minute - sc.sunrise) / (sc.sunset - sc.sunrise);   // 0..1
+      p = sc.pvPeak * pow(sin(M_PI * x), 1.5);
+      p = windowVal(sc.clouds, (int)minute, p, true);
+      std::normal_distribution<double> n(1.0, 0.01);
+      p *= n(rng);
+      if (p < 0) p = 0;
+    }
+    pv = p;
+    std::normal_distribution<double> nl(0.0, 20.0);
+    load = std::max(50.0, windowVal(sc.loads, (int)minute, sc.loadBase, false) + nl(rng));
+
+    double surplus = pv - load;   // >0: laden, <0: entladen
+    if (surplus > 0)      batt = (soc < 100.0) ? std::min(surplus, sc.battMaxC) : 0.0;
+    else                  batt = (soc > sc.battMinSoc) ? std::max(surplus, -sc.battMaxD) : 0.0;
+    grid = pv - load - batt;       // +Export / -Import
+    temp = 25.0 + pv / 400.0;
+  }
+
+  // Zeitschritt dt (s) integrieren (Rechteck mit Momentanwerten am Schrittbeginn, fein genug)
+  void integrate(time_t t, double dtSec){
+    struct tm lt; localtime_r(&t, &lt);
+    if (lt.tm_yday != lastYday){ lastYday = lt.tm_yday; pvTodayWh = 0; }
+    double h = dtSec / 3600.0;
+    pvWh += pv * h; pvTodayWh += pv * h; loadWh += load * h;
+    if (grid > 0){ expWh += grid * h; expTotWh += grid * h; }
+    else if (grid < 0){ (isT1(lt) ? impT1Wh : impT2Wh) += -grid * h; impTotWh += -grid * h; }
+    if (batt > 0) battCWh += batt * h; else battDWh += -batt * h;
+    soc += batt * h / sc.battCap * 100.0;
+    soc = std::max(0.0, std::min(100.0, soc));
+  }
+
+  // Registerabbild
+  bool reg(uint16_t addr, uint16_t& v) const {
+    auto hi = [](int32_t x){ return (uint16_t)((uint32_t)x >> 16); };
+    auto lo = [](int32_t x){ return (uint16_t)((uint32_t)x & 0xFFFF); };
+    const double pv1 = pv * pv1Frac, pv2 = pv - pv1;
+    const double u1 = pv > 1 ? 520.0 : 0.0, u2 = pv > 1 ? 480.0 : 0.0;
+    const double u = 230.0;
+    const double iPh = grid / (3.0 * u);   // A je Phase, Vorzeichen wie Netz
+    switch (addr){
+      case 32016: v = (uint16_t)(int16_t)lround(u1 * 10);                         return true;
+      case 32017: v = (uint16_t)(int16_t)lround(u1 > 0 ? pv1 / u1 * 100 : 0);     return true;
+      case 32018: v = (uint16_t)(int16_t)lround(u2 * 10);                         return true;
+      case 32019: v = (uint16_t)(int16_t)lround(u2 > 0 ? pv2 / u2 * 100 : 0);     return true;
+      case 32064: v = hi((int32_t)lround(pv)); return true;
+      case 32065: v = lo((int32_t)lround(pv)); return true;
+      case 32087: v = (uint16_t)(int16_t)lround(temp * 10); return true;
+      case 32114: v = hi((int32_t)lround(pvTodayWh / 10.0)); return true;   // kWh/100
+      case 32115: v = lo((int32_t)lround(pvTodayWh / 10.0)); return true;
+      case 37001: v = hi((int32_t)lround(batt)); return true;
+      case 37002: v = lo((int32_t)lround(batt)); return true;
+      case 37004: v = (uint16_t)lround(soc * 10); return true;
+      default: break;
+    }
+    if (addr >= 37101 && addr <= 37122){
+      int32_t x = 0;
+      int base = addr - ((addr - 37101) % 2);           // 32-bit Paare ab 37101
+      switch (base){
+        case 37101: case 37103: case 37105: x = (int32_t)lround(u * 10);          break;  // Vx10
+        case 37107: case 37109: case 37111: x = (int32_t)lround(iPh * 100);       break;  // Ax100
+        case 37113: x = (int32_t)lround(grid);                                   break;  // W
+        case 37115: x = 0;                                                       break;  // Blindleistung
+        case 37117: {                                                                     // PF (int16) + Frequenz (int16, x100)
+          v = (addr == 37117) ? (uint16_t)1000 : (uint16_t)5000; return true; }
+        case 37119: x = (int32_t)lround(expTotWh / 10.0);                         break;  // kWh/100
+        case 37121: x = (int32_t)lround(impTotWh / 10.0);                         break;
+      }
+      v = (addr == base) ? hi(x) : lo(x);
+      return true;
+    }
+    return false;
+  }
+};
+
+// ---------- Modbus TCP ----------
+struct Pending { uint64_t dueUs; int fd; std::vector<uint8_t> data; bool closeAfter; };
+struct Conn { int fd; std::vector<uint8_t> rx; std::string peer; };
+
+static uint64_t monoUs(){
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static volatile sig_atomic_t stopFlag = 0;
+static void onSig(int){ stopFlag = 1; }
+
+struct Counters { uint64_t req = 0, ok = 0, exc = 0, noreply = 0, disc = 0, rejected = 0, kicked = 0; };
+
+int main(int argc, char** argv){
+  Scenario sc;
+  uint16_t port = 502; uint8_t unit = 2; unsigned seed = 1; const char* truthPath = nullptr;
+  double speedOverride = 0;
+  for (int i = 1; i < argc; ++i){
+    std::string a = argv[i];
+    if      (a == "--port"  && i+1 < argc) port = (uint16_t)atoi(argv[++i]);
+    else if (a == "--unit"  && i+1 < argc) unit = (uint8_t)atoi(argv[++i]);
+    else if (a == "--speed" && i+1 < argc) speedOverride = atof(argv[++i]);
+    else if (a == "--seed"  && i+1 < argc) seed = (unsigned)atoi(argv[++i]);
+    else if (a == "--truth" && i+1 < argc) truthPath = argv[++i];
+    else if (a[0] != '-'){ if (!loadScenario(argv[i], sc)) return 1; }
+    else { fprintf(stderr, "sun2000sim [szenario] [--port P] [--unit U] [--speed X] [--seed N] [--truth f.csv]\n"); return 2; }
+  }
+  if (speedOverride > 0) sc.speed = speedOverride;
+  if (sc.start == 0) sc.start = time(nullptr);
+
+  int srv = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1; setsockopt(srv, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in a{}; a.sin_family = AF_INET; a.sin_port = htons(port); a.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(srv, (sockaddr*)&a, sizeof(a)) < 0 || listen(srv, 4) < 0){ perror("bind/listen"); return 1; }
+  signal(SIGINT, onSig); signal(SIGTERM, onSig); signal(SIGPIPE, SIG_IGN);
+
+  FILE* truth = truthPath ? fopen(truthPath, "w") : nullptr;
+  if (truth) fprintf(truth, "sim_time,pv_W,load_W,batt_W,grid_W,soc,pv_Wh,load_Wh,exp_Wh,impT1_Wh,impT2_Wh\n");
+
+  Plant pl(sc, seed);
+  std::mt19937 rng(seed ^ 0x5A5A);
+  std::uniform_real_distribution<double> U(0.0, 1.0);
+  auto latencyUs = [&]()->uint64_t{
+    double ms = sc.latA;
+    if (sc.latKind == Scenario::LAT_NORMAL)  ms = std::normal_distribution<double>(sc.latA, sc.latB)(rng);
+    if (sc.latKind == Scenario::LAT_UNIFORM) ms = sc.latA + U(rng) * (sc.latB - sc.latA);
+    return (uint64_t)(std::max(0.0, ms) * 1000.0);
+  };
+
+  std::vector<Conn> conns;
+  std::vector<Pending> out;
+  Counters cnt;
+  const double SIM_DT = 0.5;          // s Simulationszeit je Physikschritt
+  double simSec = 0;                  // seit sc.start
+  uint64_t t0 = monoUs();
+  double dropUntil = -1;
+  int lastTruthMin = -1;
+
+  pl.evaluate(sc.start, 0);
+  printf("Sun2000-Simulator: Port %u, Unit %u, Speed %.1f, Start %s", port, unit, sc.speed, ctime(&sc.start));
+
+  auto closeConn = [&](size_t i){
+    close(conns[i].fd);
+    out.erase(std::remove_if(out.begin(), out.end(), [&](const Pending& p){ return p.fd == conns[i].fd; }), out.end());
+    conns.erase(conns.begin() + i);
+  };
+
+  while (!stopFlag){
+    // --- Physik bis zur aktuellen Simulationszeit nachziehen ---
+    double target = (monoUs() - t0) / 1e6 * sc.speed;
+    while (simSec + SIM_DT <= target){
+      time_t t = sc.start + (time_t)simSec;
+      pl.integrate(t, SIM_DT);
+      simSec += SIM_DT;
+      t = sc.start + (time_t)simSec;
+      pl.evaluate(t, simSec - floor(simSec));
+      int curMin = (int)(simSec / 60);
+      if (truth && curMin != lastTruthMin){
+        lastTruthMin = curMin;
+        char tb[24]; struct tm lt; localtime_r(&t, &lt); strftime(tb, sizeof(tb), "%Y-%m-%d %H:%M:%S", &lt);
+        fprintf(truth, "%s,%.0f,%.0f,%.0f,%.0f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f\n", tb, pl.pv, pl.load, pl.batt, pl.grid, pl.soc,
+                pl.pvWh, pl.loadWh, pl.expWh, pl.impT1Wh, pl.impT2Wh);
+        fflush(truth);
+      }
+      // geplante Ausfälle
+      struct tm lt; localtime_r(&t, &lt);
+      int minute = lt.tm_hour*60 + lt.tm_min;
+      for (DropEvt& d : sc.drops){
+        if (!d.done && minute >= d.atMin){
+          d.done = true; dropUntil = simSec + d.durSec;
+          printf("[SIM] Ausfall %.0f s (Sim)\n", d.durSec);
+          while (!conns.empty()){ closeConn(0); ++cnt.disc; }
+        }
+      }
+    }
+    bool dropped = simSec < dropUntil;
+
+    // --- Warten auf Ereignisse ---
+    std::vector<pollfd> pf;
+    pf.push_back({srv, POLLIN, 0});
+    for (const Conn& c : conns) pf.push_back({c.fd, POLLIN, 0});
+    int waitMs = 20;
+    if (!out.empty()){
+      uint64_t now = monoUs(), due = out.front().dueUs;
+      for (const Pending& p : out) due = std::min(due, p.dueUs);
+      waitMs = due > now ? (int)std::min<uint64_t>((due - now) / 1000, 20) : 0;
+    }
+    poll(pf.data(), pf.size(), waitMs);
+
+    // --- Neue Verbindungen (ein Requester wie das echte Gerät) ---
+    if (pf[0].revents & POLLIN){
+      sockaddr_in ca{}; socklen_t cl = sizeof(ca);
+      int fd = accept(srv, (sockaddr*)&ca, &cl);
+      if (fd >= 0){
+        char ip[32]; inet_ntop(AF_INET, &ca.sin_addr, ip, sizeof(ip));
+        if (dropped){ close(fd); ++cnt.rejected; }
+        else if (!conns.empty() && sc.lockout == Scenario::LOCK_REJECT){
+          close(fd); ++cnt.rejected; printf("[SIM] zweiter Requester %s abgelehnt\n", ip);
+        } else {
+          if (!conns.empty() && sc.lockout == Scenario::LOCK_KICK){
+            while (!conns.empty()){ closeConn(0); ++cnt.kicked; }
+            printf("[SIM] alter Requester getrennt\n");
+          }
+          setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+          conns.push_back({fd, {}, ip});
+          printf("[SIM] Verbindung von %s\n", ip);
+        }
+      }
+    }
+
+    // --- Anfragen lesen ---
+    for (size_t i = 0; i < conns.size(); ){
+      Conn& c = conns[i];
+      bool drop = false;
+      if (pf[i+1].revents & (POLLIN | POLLHUP | POLLERR)){
+        uint8_t buf[512];
+        ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+        if (n <= 0) drop = true;
+        else c.rx.insert(c.rx.end(), buf, buf + n);
+      }
+      // vollständige ADUs abarbeiten: MBAP (7) + PDU
+      while (!drop && c.rx.size() >= 7){
+        uint16_t len = (uint16_t)(c.rx[4] << 8 | c.rx[5]);
+        if (c.rx.size() < (size_t)6 + len) break;
+        std::vector<uint8_t> adu(c.rx.begin(), c.rx.begin() + 6 + len);
+        c.rx.erase(c.rx.begin(), c.rx.begin() + 6 + len);
+        ++cnt.req;
+        if (dropped || U(rng) < sc.pNoReply){ ++cnt.noreply; continue; }
+        if (U(rng) < sc.pDisconnect){ ++cnt.disc; drop = true; break; }
+
+        uint8_t uid = adu[6], fc = len >= 2 ? adu[7] : 0;
+        std::vector<uint8_t> r(adu.begin(), adu.begin() + 7);   // Tid, Pid, (Len), Unit
+        auto exception = [&](uint8_t code){ r.push_back(fc | 0x80); r.push_back(code); ++cnt.exc; };
+        if (uid != unit)                     exception(0x0B);     // Gateway target failed
+        else if (fc != 0x03 || len < 6)      exception(0x01);     // Illegal function
+        else if (U(rng) < sc.pException)     exception(0x06);     // Slave device busy
+        else {
+          uint16_t start = (uint16_t)(adu[8] << 8 | adu[9]), qty = (uint16_t)(adu[10] << 8 | adu[11]);
+          std::vector<uint8_t> d;
+          bool ok = qty >= 1 && qty <= 125;
+          for (uint16_t k = 0; ok && k < qty; ++k){
+            uint16_t v;
+            if (!pl.reg((uint16_t)(start + k), v)){ ok = false; break; }
+            d.push_back(v >> 8); d.push_back(v & 0xFF);
+          }
+          if (!ok) exception(0x02);                                // Illegal data address
+          else { r.push_back(fc); r.push_back((uint8_t)d.size()); r.insert(r.end(), d.begin(), d.end()); ++cnt.ok; }
+        }
+        uint16_t rl = (uint16_t)(r.size() - 6);
+        r[4] = rl >> 8; r[5] = rl & 0xFF;
+        out.push_back({monoUs() + latencyUs(), c.fd, r, false});
+      }
+      if (drop){ closeConn(i); printf("[SIM] Verbindung getrennt\n"); }
+      else ++i;
+    }
+
+    // --- fällige Antworten senden (Latenz) ---
+    uint64_t now = monoUs();
+    for (size_t k = 0; k < out.size(); ){
+      if (out[k].dueUs <= now){
+        send(out[k].fd, out[k].data.data(), out[k].data.size(), 0);
+        out.erase(out.begin() + k);
+      } else ++k;
+    }
+  }
+
+  for (const Conn& c : conns) close(c.fd);
+  close(srv);
+  if (truth) fclose(truth);
+  printf("\nAnfragen %llu: ok %llu, Exception %llu, ohne Antwort %llu, getrennt %llu, abgelehnt %llu, verdrängt %llu\n",
+         (unsigned long long)cnt.req, (unsigned long long)cnt.ok, (unsigned long long)cnt.exc, (unsigned long long)cnt.noreply,
+         (unsigned long long)cnt.disc, (unsigned long long)cnt.rejected, (unsigned long long)cnt.kicked);
+  printf("Wahrheit (%.0f s Sim): PV %.3f kWh, Last %.3f kWh, Export %.3f kWh, Import T1 %.3f / T2 %.3f kWh, Batt +%.3f/-%.3f kWh, SoC %.1f%%\n",
+         simSec, pl.pvWh/1000, pl.loadWh/1000, pl.expWh/1000, pl.impT1Wh/1000, pl.impT2Wh/1000, pl.battCWh/1000, pl.battDWh/1000, pl.soc);
+  return 0;
+}